@@ -0,0 +1,312 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Implementation based on a persistent pool of std::thread workers. The
+// thread calling For takes part in the execution, so the pool has one worker
+// less than the number of threads. A For executed within another one (nested
+// For) is run by the same workers, no thread is ever created to execute it.
+
+namespace
+{
+int vtkSMPNumberOfSpecifiedThreads = 0;
+
+typedef vtk::detail::smp::ExecuteFunctorPtrType ExecuteFunctorPtrType;
+
+//--------------------------------------------------------------------------------
+// A For whose chunks of grain indices are split in contiguous ranges, one per
+// thread taking part. Each thread executes the chunks of its own range first,
+// then steals the chunks left in the other ranges.
+class vtkSMPThreadPoolJob
+{
+public:
+  vtkSMPThreadPoolJob(vtkIdType first, vtkIdType last, vtkIdType grain,
+                      vtkIdType numChunks, int numRanges,
+                      ExecuteFunctorPtrType functorExecuter, void *functor)
+    : NumberOfRanges(numRanges), Helpers(0), First(first), Last(last),
+      Grain(grain), Ranges(new Range[numRanges]),
+      FunctorExecuter(functorExecuter), Functor(functor)
+  {
+    for (int i = 0; i < numRanges; ++i)
+    {
+      this->Ranges[i].Next.store(numChunks * i / numRanges,
+                                 std::memory_order_relaxed);
+      this->Ranges[i].End = numChunks * (i + 1) / numRanges;
+    }
+  }
+
+  // Execute chunks, starting with the given range, until none is left.
+  void Run(int range)
+  {
+    for (int i = 0; i < this->NumberOfRanges; ++i)
+    {
+      Range &r = this->Ranges[(range + i) % this->NumberOfRanges];
+      for (;;)
+      {
+        vtkIdType chunk = r.Next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= r.End)
+        {
+          break;
+        }
+        this->FunctorExecuter(this->Functor,
+                              this->First + chunk * this->Grain,
+                              this->Grain, this->Last);
+      }
+    }
+  }
+
+  const int NumberOfRanges;
+
+  // Number of workers running the job, guarded by the pool mutex.
+  int Helpers;
+
+private:
+  struct Range
+  {
+    std::atomic<vtkIdType> Next;
+    vtkIdType End;
+  };
+
+  vtkIdType First;
+  vtkIdType Last;
+  vtkIdType Grain;
+  std::unique_ptr<Range[]> Ranges;
+  ExecuteFunctorPtrType FunctorExecuter;
+  void *Functor;
+
+  vtkSMPThreadPoolJob(const vtkSMPThreadPoolJob&) = delete;
+  void operator=(const vtkSMPThreadPoolJob&) = delete;
+};
+
+//--------------------------------------------------------------------------------
+class vtkSMPThreadPool
+{
+public:
+  static vtkSMPThreadPool& GetInstance()
+  {
+    static vtkSMPThreadPool pool;
+    return pool;
+  }
+
+  ~vtkSMPThreadPool()
+  {
+    this->StopWorkers();
+  }
+
+  void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+           ExecuteFunctorPtrType functorExecuter, void *functor);
+
+private:
+  vtkSMPThreadPool() : NumberOfWorkers(0), NumberOfRunningJobs(0), Stop(false)
+  {
+  }
+
+  void Configure(int numWorkers);
+  void StartWorkers(int numWorkers);
+  void StopWorkers();
+  void Work(int index);
+
+  // Serializes the changes of the number of workers.
+  std::mutex ConfigureMutex;
+  std::atomic<int> NumberOfWorkers;
+
+  std::mutex Mutex;
+  std::condition_variable JobAvailable;
+  std::condition_variable JobDone;
+  // Jobs that may still have chunks to execute, the most recent last.
+  std::vector<vtkSMPThreadPoolJob*> Jobs;
+  // Jobs not completed yet, including the ones whose chunks are all taken.
+  int NumberOfRunningJobs;
+  std::vector<std::thread> Workers;
+  bool Stop;
+};
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::Configure(int numWorkers)
+{
+  std::lock_guard<std::mutex> configureLock(this->ConfigureMutex);
+  {
+    // The number of workers can only be changed while no For is running.
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    if (this->NumberOfRunningJobs ||
+        this->NumberOfWorkers.load() == numWorkers)
+    {
+      return;
+    }
+  }
+  this->StopWorkers();
+  this->StartWorkers(numWorkers);
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::StartWorkers(int numWorkers)
+{
+  this->Workers.reserve(numWorkers);
+  for (int i = 0; i < numWorkers; ++i)
+  {
+    this->Workers.push_back(std::thread(&vtkSMPThreadPool::Work, this, i));
+  }
+  this->NumberOfWorkers.store(numWorkers);
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::StopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Stop = true;
+  }
+  this->JobAvailable.notify_all();
+  for (size_t i = 0; i < this->Workers.size(); ++i)
+  {
+    this->Workers[i].join();
+  }
+  this->Workers.clear();
+  this->NumberOfWorkers.store(0);
+  std::lock_guard<std::mutex> lock(this->Mutex);
+  this->Stop = false;
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::Work(int index)
+{
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  for (;;)
+  {
+    this->JobAvailable.wait(lock,
+      [this]() { return this->Stop || !this->Jobs.empty(); });
+    if (this->Stop)
+    {
+      return;
+    }
+
+    // Help with the most recent job, which is the innermost one when For
+    // calls are nested.
+    vtkSMPThreadPoolJob *job = this->Jobs.back();
+    ++job->Helpers;
+    lock.unlock();
+    job->Run((index + 1) % job->NumberOfRanges);
+    lock.lock();
+
+    // All the chunks have been taken, do not offer the job anymore.
+    std::vector<vtkSMPThreadPoolJob*>::iterator it =
+      std::find(this->Jobs.begin(), this->Jobs.end(), job);
+    if (it != this->Jobs.end())
+    {
+      this->Jobs.erase(it);
+    }
+    if (--job->Helpers == 0)
+    {
+      this->JobDone.notify_all();
+    }
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPThreadPool::For(vtkIdType first, vtkIdType last, vtkIdType grain,
+                           ExecuteFunctorPtrType functorExecuter,
+                           void *functor)
+{
+  int numThreads = vtk::detail::smp::GetNumberOfThreads();
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first) / (numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+  vtkIdType numChunks = (last - first + grain - 1) / grain;
+
+  if (numThreads <= 1 || numChunks <= 1)
+  {
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+    return;
+  }
+
+  if (this->NumberOfWorkers.load() != numThreads - 1)
+  {
+    this->Configure(numThreads - 1);
+  }
+
+  vtkSMPThreadPoolJob job(first, last, grain, numChunks,
+                          static_cast<int>(std::min<vtkIdType>(numThreads,
+                                                               numChunks)),
+                          functorExecuter, functor);
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Jobs.push_back(&job);
+    ++this->NumberOfRunningJobs;
+  }
+  this->JobAvailable.notify_all();
+
+  job.Run(0);
+
+  // Wait for the chunks taken by the workers.
+  std::unique_lock<std::mutex> lock(this->Mutex);
+  std::vector<vtkSMPThreadPoolJob*>::iterator it =
+    std::find(this->Jobs.begin(), this->Jobs.end(), &job);
+  if (it != this->Jobs.end())
+  {
+    this->Jobs.erase(it);
+  }
+  this->JobDone.wait(lock, [&job]() { return job.Helpers == 0; });
+  --this->NumberOfRunningJobs;
+}
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+  if (numThreads > 0)
+  {
+    vtkSMPNumberOfSpecifiedThreads = numThreads;
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  return vtk::detail::smp::GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  if (vtkSMPNumberOfSpecifiedThreads)
+  {
+    return vtkSMPNumberOfSpecifiedThreads;
+  }
+  int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  return numThreads > 0 ? numThreads : 1;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_STDThread(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  vtkSMPThreadPool::GetInstance().For(first, last, grain, functorExecuter,
+                                      functor);
+}
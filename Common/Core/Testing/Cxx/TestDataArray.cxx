@@ -1,6 +1,13 @@
 #include "vtkIntArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkMath.h"
 #include "vtkMathUtilities.h"
+#include "vtkNew.h"
+#include "vtkSOADataArrayTemplate.h"
+
+#include <algorithm>
+#include <cmath>
 
 // Define this to run benchmarking tests on some vtkDataArray methods:
 #undef BENCHMARK
@@ -25,6 +32,96 @@ void benchmark();
 } // End TestDataArrayPrivate namespace
 #endif // BENCHMARK
 
+// Check the component and magnitude ranges of an array large enough to be
+// split between threads against a serial computation.
+static int CheckLargeArrayRanges(vtkDataArray *array)
+{
+  const int numComps = array->GetNumberOfComponents();
+  for (int comp = -1; comp < numComps; ++comp)
+  {
+    for (int finite = 0; finite < 2; ++finite)
+    {
+      double expected[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+      for (vtkIdType i = 0; i < array->GetNumberOfTuples(); ++i)
+      {
+        double value = 0.0;
+        if (comp < 0)
+        {
+          for (int c = 0; c < numComps; ++c)
+          {
+            double t = array->GetComponent(i, c);
+            value += t * t;
+          }
+        }
+        else
+        {
+          value = array->GetComponent(i, comp);
+        }
+        if (vtkMath::IsNan(value) || (finite && vtkMath::IsInf(value)))
+        {
+          continue;
+        }
+        expected[0] = std::min(expected[0], value);
+        expected[1] = std::max(expected[1], value);
+      }
+      if (comp < 0)
+      {
+        expected[0] = std::sqrt(expected[0]);
+        expected[1] = std::sqrt(expected[1]);
+      }
+
+      double range[2];
+      array->Modified();
+      if (finite)
+      {
+        array->GetFiniteRange(range, comp);
+      }
+      else
+      {
+        array->GetRange(range, comp);
+      }
+      if (range[0] != expected[0] || range[1] != expected[1])
+      {
+        cerr << "Getting " << (finite ? "finite " : "") << "range of "
+             << array->GetClassName() << " component " << comp
+             << " failed: " << range[0] << "-" << range[1] << " instead of "
+             << expected[0] << "-" << expected[1] << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int TestLargeArrayRanges()
+{
+  const vtkIdType numTuples = 100003;
+  vtkNew<vtkFloatArray> aos;
+  aos->SetNumberOfComponents(3);
+  aos->SetNumberOfTuples(numTuples);
+  vtkNew<vtkSOADataArrayTemplate<float> > soa;
+  soa->SetNumberOfComponents(3);
+  soa->SetNumberOfTuples(numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      float value = static_cast<float>((i * 7919 + c * 104729) % 20011) / 7.f -
+        1000.f * c;
+      aos->SetTypedComponent(i, c, value);
+      soa->SetTypedComponent(i, c, value);
+    }
+  }
+  const double specials[3] = { vtkMath::Inf(), vtkMath::NegInf(),
+                               vtkMath::Nan() };
+  for (int k = 0; k < 3; ++k)
+  {
+    aos->SetTypedComponent(1000 * k + 17, k, static_cast<float>(specials[k]));
+    soa->SetTypedComponent(1000 * k + 17, k, static_cast<float>(specials[k]));
+  }
+  return CheckLargeArrayRanges(aos) || CheckLargeArrayRanges(soa);
+}
+
 int TestDataArray(int,char *[])
 {
 #ifdef BENCHMARK
@@ -220,7 +317,8 @@ int TestDataArray(int,char *[])
   }
   cout << endl;
   farray->Delete();
-  return 0;
+
+  return TestLargeArrayRanges();
 }
 
 #ifdef BENCHMARK
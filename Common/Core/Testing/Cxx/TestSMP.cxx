@@ -19,6 +19,7 @@
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
 #include <functional>
+#include <numeric>
 #include <vector>
 
 static const int Target = 10000;
@@ -91,9 +92,124 @@ public:
 
 };
 
+// A For within a For
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor(): Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 1000, 10, inner);
+      for (vtkSMPThreadLocal<int>::iterator itr = inner.Counter.begin();
+           itr != inner.Counter.end(); ++itr)
+      {
+        this->Counter.Local() += *itr;
+      }
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
+// Associative but not commutative operation
+int keepLast (int, int b) { return b; }
+
+int TestAlgorithms()
+{
+  // Large enough to be split in several blocks.
+  const int size = 100003;
+  std::vector<int> values(size);
+  for (int i=0; i<size; ++i)
+  {
+    values[i] = (i * 7919) % 1000 - 400;
+  }
+
+  std::vector<int> result(size);
+  vtkSMPTools::Transform(values.begin(), values.end(), result.begin(),
+    [](int v) { return 2 * v; });
+  vtkSMPTools::Transform(result.begin(), result.end(), values.begin(),
+    result.begin(), std::minus<int>());
+  if (result != values)
+  {
+    cerr << "Error: Bad transform!" << endl;
+    return 1;
+  }
+
+  vtkSMPTools::Fill(result.begin(), result.end(), 3);
+  if (std::count(result.begin(), result.end(), 3) != size)
+  {
+    cerr << "Error: Bad fill!" << endl;
+    return 1;
+  }
+
+  if (vtkSMPTools::Reduce(values.begin(), values.end(), 5) !=
+      std::accumulate(values.begin(), values.end(), 5) ||
+      vtkSMPTools::Reduce(values.begin(), values.end(), 0, keepLast) !=
+      values.back())
+  {
+    cerr << "Error: Bad reduction!" << endl;
+    return 1;
+  }
+
+  std::vector<int> sums(size);
+  std::partial_sum(values.begin(), values.end(), sums.begin());
+  vtkSMPTools::InclusiveScan(values.begin(), values.end(), result.begin());
+  if (result != sums)
+  {
+    cerr << "Error: Bad inclusive scan!" << endl;
+    return 1;
+  }
+
+  // In place, with an initial value.
+  result = values;
+  int total = vtkSMPTools::ExclusiveScan(result.begin(), result.end(),
+                                         result.begin(), 5);
+  if (total != sums.back() + 5 || result[0] != 5)
+  {
+    cerr << "Error: Bad exclusive scan total!" << endl;
+    return 1;
+  }
+  for (int i=1; i<size; ++i)
+  {
+    if (result[i] != sums[i-1] + 5)
+    {
+      cerr << "Error: Bad exclusive scan!" << endl;
+      return 1;
+    }
+  }
+
+  vtkSMPTools::ExclusiveScan(values.begin(), values.end(), result.begin(),
+                             -1, keepLast);
+  vtkSMPTools::InclusiveScan(values.begin(), values.end(), sums.begin(),
+                             keepLast);
+  if (result[0] != -1 ||
+      !std::equal(values.begin(), values.end() - 1, result.begin() + 1) ||
+      sums != values)
+  {
+    cerr << "Error: Bad non commutative scan!" << endl;
+    return 1;
+  }
+
+  // Empty ranges
+  if (vtkSMPTools::ExclusiveScan(values.begin(), values.begin(),
+                                 result.begin(), 7) != 7)
+  {
+    cerr << "Error: Bad empty scan!" << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
 int TestSMP(int, char*[])
 {
   //vtkSMPTools::Initialize(8);
@@ -140,6 +256,23 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  NestedFunctor functor3;
+
+  vtkSMPTools::For(0, 100, 1, functor3);
+
+  total = 0;
+  for (vtkSMPThreadLocal<int>::iterator itr3 = functor3.Counter.begin();
+       itr3 != functor3.Counter.end(); ++itr3)
+  {
+    total += *itr3;
+  }
+
+  if (total != 100000)
+  {
+    cerr << "Error: NestedFunctor did not generate 100000" << endl;
+    return 1;
+  }
+
   // Test sorting
   double data0[] = {2,1,0,3,9,6,7,3,8,4,5};
   std::vector<double> myvector (data0, data0+11);
@@ -167,5 +300,5 @@ int TestSMP(int, char*[])
     }
   }
 
-  return 0;
+  return TestAlgorithms();
 }
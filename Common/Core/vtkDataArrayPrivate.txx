@@ -15,11 +15,13 @@
 #ifndef vtkDataArrayPrivate_txx
 #define vtkDataArrayPrivate_txx
 
+#include "vtkAOSDataArrayTemplate.h"
 #include "vtkAssume.h"
 #include "vtkDataArray.h"
 #include "vtkDataArrayAccessor.h"
 #include "vtkSMPThreadLocal.h"
 #include "vtkSMPTools.h"
+#include "vtkSOADataArrayTemplate.h"
 #include "vtkTypeTraits.h"
 #include <algorithm>
 #include <array>
@@ -93,6 +95,186 @@ bool isinf(T x)
 }
 }
 
+struct AllValues {};
+struct FiniteValues {};
+
+//----------------------------------------------------------------------------
+// Whether a value takes part in the range.
+template <typename APIType>
+bool InRange(APIType, AllValues)
+{
+  return true;
+}
+
+template <typename APIType>
+bool InRange(APIType value, FiniteValues)
+{
+  return !detail::isinf(value);
+}
+
+template <typename APIType, typename ValueFilter>
+void UpdateMinAndMax(APIType value, APIType &min, APIType &max,
+                     ValueFilter filter)
+{
+  // Written as selects rather than branches so that the loops vectorize.
+  const bool keep = InRange(value, filter);
+  min = keep ? detail::min(min, value) : min;
+  max = keep ? detail::max(max, value) : max;
+}
+
+//----------------------------------------------------------------------------
+// Update the ranges of the NumComps components with tuples [begin, end).
+// The ranges are accumulated in local variables, which the compiler can keep
+// in registers, and the AOS and SOA arrays are read through plain pointers,
+// so that the inner loops can be vectorized.
+template <int NumComps, typename ArrayT, typename APIType,
+          typename ValueFilter>
+void UpdateScalarRange(ArrayT *array, vtkIdType begin, vtkIdType end,
+                       APIType *ranges, ValueFilter filter)
+{
+  vtkDataArrayAccessor<ArrayT> access(array);
+  APIType range[2 * NumComps];
+  std::copy(ranges, ranges + 2 * NumComps, range);
+  for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+  {
+    for (int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j += 2)
+    {
+      UpdateMinAndMax<APIType>(access.Get(tupleIdx, compIdx), range[j],
+                               range[j + 1], filter);
+    }
+  }
+  std::copy(range, range + 2 * NumComps, ranges);
+}
+
+template <int NumComps, typename ValueType, typename ValueFilter>
+void UpdateScalarRange(vtkAOSDataArrayTemplate<ValueType> *array,
+                       vtkIdType begin, vtkIdType end, ValueType *ranges,
+                       ValueFilter filter)
+{
+  const ValueType *values = array->GetPointer(begin * NumComps);
+  const ValueType *valuesEnd = values + (end - begin) * NumComps;
+  ValueType range[2 * NumComps];
+  std::copy(ranges, ranges + 2 * NumComps, range);
+  for (; values != valuesEnd; values += NumComps)
+  {
+    for (int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j += 2)
+    {
+      UpdateMinAndMax<ValueType>(values[compIdx], range[j], range[j + 1],
+                                 filter);
+    }
+  }
+  std::copy(range, range + 2 * NumComps, ranges);
+}
+
+template <int NumComps, typename ValueType, typename ValueFilter>
+void UpdateScalarRange(vtkSOADataArrayTemplate<ValueType> *array,
+                       vtkIdType begin, vtkIdType end, ValueType *ranges,
+                       ValueFilter filter)
+{
+  for (int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j += 2)
+  {
+    const ValueType *values = array->GetComponentArrayPointer(compIdx);
+    ValueType min = ranges[j];
+    ValueType max = ranges[j + 1];
+    for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+    {
+      UpdateMinAndMax<ValueType>(values[tupleIdx], min, max, filter);
+    }
+    ranges[j] = min;
+    ranges[j + 1] = max;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Update the range of the squared magnitudes of tuples [begin, end). The
+// squares of the components are summed in component order whatever the
+// array layout.
+template <typename ArrayT, typename ValueFilter>
+void UpdateMagnitudeRange(ArrayT *array, vtkIdType begin, vtkIdType end,
+                          double *ranges, ValueFilter filter)
+{
+  const int numComps = array->GetNumberOfComponents();
+  vtkDataArrayAccessor<ArrayT> access(array);
+  double min = ranges[0];
+  double max = ranges[1];
+  for (vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
+  {
+    double squaredSum = 0.0;
+    for (int compIdx = 0; compIdx < numComps; ++compIdx)
+    {
+      const double t = static_cast<double>(access.Get(tupleIdx, compIdx));
+      squaredSum += t * t;
+    }
+    UpdateMinAndMax(squaredSum, min, max, filter);
+  }
+  ranges[0] = min;
+  ranges[1] = max;
+}
+
+template <typename ValueType, typename ValueFilter>
+void UpdateMagnitudeRange(vtkAOSDataArrayTemplate<ValueType> *array,
+                          vtkIdType begin, vtkIdType end, double *ranges,
+                          ValueFilter filter)
+{
+  const int numComps = array->GetNumberOfComponents();
+  const ValueType *values = array->GetPointer(begin * numComps);
+  const ValueType *valuesEnd = values + (end - begin) * numComps;
+  double min = ranges[0];
+  double max = ranges[1];
+  for (; values != valuesEnd; values += numComps)
+  {
+    double squaredSum = 0.0;
+    for (int compIdx = 0; compIdx < numComps; ++compIdx)
+    {
+      const double t = static_cast<double>(values[compIdx]);
+      squaredSum += t * t;
+    }
+    UpdateMinAndMax(squaredSum, min, max, filter);
+  }
+  ranges[0] = min;
+  ranges[1] = max;
+}
+
+template <typename ValueType, typename ValueFilter>
+void UpdateMagnitudeRange(vtkSOADataArrayTemplate<ValueType> *array,
+                          vtkIdType begin, vtkIdType end, double *ranges,
+                          ValueFilter filter)
+{
+  // Sum the squares of blocks of tuples one component at a time, to read
+  // each component array contiguously.
+  const int blockSize = 512;
+  const int numComps = array->GetNumberOfComponents();
+  std::vector<const ValueType*> components(numComps);
+  for (int compIdx = 0; compIdx < numComps; ++compIdx)
+  {
+    components[compIdx] = array->GetComponentArrayPointer(compIdx);
+  }
+  double squaredSums[blockSize];
+  double min = ranges[0];
+  double max = ranges[1];
+  for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+  {
+    const int size = static_cast<int>(
+      std::min<vtkIdType>(blockSize, end - blockBegin));
+    std::fill(squaredSums, squaredSums + size, 0.0);
+    for (int compIdx = 0; compIdx < numComps; ++compIdx)
+    {
+      const ValueType *values = components[compIdx] + blockBegin;
+      for (int i = 0; i < size; ++i)
+      {
+        const double t = static_cast<double>(values[i]);
+        squaredSums[i] += t * t;
+      }
+    }
+    for (int i = 0; i < size; ++i)
+    {
+      UpdateMinAndMax(squaredSums[i], min, max, filter);
+    }
+  }
+  ranges[0] = min;
+  ranges[1] = max;
+}
+
 template<typename APIType, int NumComps>
 class MinAndMax
 {
@@ -100,6 +282,14 @@ protected:
   APIType ReducedRange[2 * NumComps];
   vtkSMPThreadLocal<std::array<APIType, 2 * NumComps>> TLRange;
 public:
+  MinAndMax()
+  {
+    for(int i = 0, j = 0; i < NumComps; ++i, j+=2)
+    {
+      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
+      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
+    }
+  }
   void Initialize()
   {
     auto &range = this->TLRange.Local();
@@ -107,8 +297,6 @@ public:
     {
       range[j] = vtkTypeTraits<APIType>::Max();
       range[j+1] = vtkTypeTraits<APIType>::Min();
-      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
-      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
     }
   }
   void Reduce()
@@ -153,17 +341,9 @@ public:
   void operator()(vtkIdType begin, vtkIdType end)
   {
     VTK_ASSUME(this->Array->GetNumberOfComponents() == NumComps);
-    vtkDataArrayAccessor<ArrayT> access(this->Array);
-    auto &range = MinAndMaxT::TLRange.Local();
-    for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
-    {
-      for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
-      {
-        APIType value = access.Get(tupleIdx, compIdx);
-        range[j]   = detail::min(range[j], value);
-        range[j+1] = detail::max(range[j+1], value);
-      }
-    }
+    UpdateScalarRange<NumComps>(this->Array, begin, end,
+                                MinAndMaxT::TLRange.Local().data(),
+                                AllValues());
   }
 };
 
@@ -187,20 +367,9 @@ public:
   void operator()(vtkIdType begin, vtkIdType end)
   {
     VTK_ASSUME(this->Array->GetNumberOfComponents() == NumComps);
-    vtkDataArrayAccessor<ArrayT> access(this->Array);
-    auto &range = MinAndMaxT::TLRange.Local();
-    for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
-    {
-      for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
-      {
-        APIType value = access.Get(tupleIdx, compIdx);
-        if (!detail::isinf(value))
-        {
-          range[j]   = detail::min(range[j], value);
-          range[j+1] = detail::max(range[j+1], value);
-        }
-      }
-    }
+    UpdateScalarRange<NumComps>(this->Array, begin, end,
+                                MinAndMaxT::TLRange.Local().data(),
+                                FiniteValues());
   }
 };
 
@@ -231,20 +400,8 @@ public:
   }
   void operator()(vtkIdType begin, vtkIdType end)
   {
-    const int NumComps = this->Array->GetNumberOfComponents();
-    vtkDataArrayAccessor<ArrayT> access(this->Array);
-    auto &range = MinAndMaxT::TLRange.Local();
-    for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
-    {
-      APIType squaredSum = 0.0;
-      for (int compIdx = 0; compIdx < NumComps; ++compIdx)
-      {
-        const APIType t = static_cast<APIType>(access.Get(tupleIdx, compIdx));
-        squaredSum += t * t;
-      }
-      range[0] = detail::min(range[0], squaredSum);
-      range[1] = detail::max(range[1], squaredSum);
-    }
+    UpdateMagnitudeRange(this->Array, begin, end,
+                         MinAndMaxT::TLRange.Local().data(), AllValues());
   }
 };
 
@@ -276,29 +433,11 @@ public:
   }
   void operator()(vtkIdType begin, vtkIdType end)
   {
-    const int NumComps = this->Array->GetNumberOfComponents();
-    vtkDataArrayAccessor<ArrayT> access(this->Array);
-    auto &range = MinAndMaxT::TLRange.Local();
-    for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
-    {
-      APIType squaredSum = 0.0;
-      for (int compIdx = 0; compIdx < NumComps; ++compIdx)
-      {
-        const APIType t = static_cast<APIType>(access.Get(tupleIdx, compIdx));
-        squaredSum += t * t;
-      }
-      if (!detail::isinf(squaredSum))
-      {
-        range[0] = detail::min(range[0], squaredSum);
-        range[1] = detail::max(range[1], squaredSum);
-      }
-    }
+    UpdateMagnitudeRange(this->Array, begin, end,
+                         MinAndMaxT::TLRange.Local().data(), FiniteValues());
   }
 };
 
-struct AllValues {};
-struct FiniteValues {};
-
 //----------------------------------------------------------------------------
 template <int NumComps>
 struct ComputeScalarRange
@@ -330,7 +469,14 @@ protected:
   vtkSMPThreadLocal<std::vector<APIType>> TLRange;
   std::vector<APIType> ReducedRange;
 public:
-  GenericMinAndMax(ArrayT * array) : Array(array), NumComps(Array->GetNumberOfComponents()), ReducedRange(2 * NumComps) {}
+  GenericMinAndMax(ArrayT * array) : Array(array), NumComps(Array->GetNumberOfComponents()), ReducedRange(2 * NumComps)
+  {
+    for(int i = 0, j = 0; i < this->NumComps; ++i, j+=2)
+    {
+      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
+      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
+    }
+  }
   void Initialize()
   {
     auto &range = this->TLRange.Local();
@@ -339,8 +485,6 @@ public:
     {
       range[j] = vtkTypeTraits<APIType>::Max();
       range[j+1] = vtkTypeTraits<APIType>::Min();
-      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
-      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
     }
   }
   void Reduce()
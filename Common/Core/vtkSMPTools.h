@@ -32,6 +32,11 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <algorithm> // For std::transform and std::fill
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <vector> // For the partial reductions
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -129,6 +134,208 @@ class vtkSMPTools_Lookup_For<Functor const>
 public:
   typedef vtkSMPTools_FunctorInternal<Functor const, init> type;
 };
+
+// Functors executing the vtkSMPTools algorithms on a range of indices (or of
+// blocks of indices) through the back-end For.
+template <typename InputIt, typename OutputIt, typename Functor>
+struct vtkSMPTools_UnaryTransform
+{
+  InputIt In;
+  OutputIt Out;
+  Functor& Transform;
+  vtkSMPTools_UnaryTransform(InputIt in, OutputIt out, Functor& transform)
+    : In(in), Out(out), Transform(transform) {}
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    std::transform(this->In + first, this->In + last, this->Out + first,
+                   this->Transform);
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+          typename Functor>
+struct vtkSMPTools_BinaryTransform
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  Functor& Transform;
+  vtkSMPTools_BinaryTransform(InputIt1 in1, InputIt2 in2, OutputIt out,
+                              Functor& transform)
+    : In1(in1), In2(in2), Out(out), Transform(transform) {}
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    std::transform(this->In1 + first, this->In1 + last, this->In2 + first,
+                   this->Out + first, this->Transform);
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_Fill
+{
+  Iterator Begin;
+  const T& Value;
+  vtkSMPTools_Fill(Iterator begin, const T& value)
+    : Begin(begin), Value(value) {}
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    std::fill(this->Begin + first, this->Begin + last, this->Value);
+  }
+};
+
+// Reduce each block of consecutive values. The partial results are combined
+// in block order, so non commutative operations are supported.
+template <typename Iterator, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockReduce
+{
+  Iterator Begin;
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  BinaryOp& Op;
+  std::vector<T> Partials;
+  vtkSMPTools_BlockReduce(Iterator begin, vtkIdType size,
+                          vtkIdType blockSize, BinaryOp& op)
+    : Begin(begin), Size(size), BlockSize(blockSize), Op(op),
+      Partials((size + blockSize - 1) / blockSize) {}
+  vtkIdType GetNumberOfBlocks() const
+  {
+    return static_cast<vtkIdType>(this->Partials.size());
+  }
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      Iterator it = this->Begin + block * this->BlockSize;
+      Iterator end = this->Begin +
+        std::min(this->Size, (block + 1) * this->BlockSize);
+      T value = *it;
+      for (++it; it != end; ++it)
+      {
+        value = this->Op(value, *it);
+      }
+      this->Partials[block] = value;
+    }
+  }
+};
+
+// Scan each block of consecutive values starting from the reduction of the
+// previous blocks, or from nothing for the first block of an inclusive scan.
+// Each value is read before its output is written, so the output may be the
+// input.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockScan
+{
+  InputIt In;
+  OutputIt Out;
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  BinaryOp& Op;
+  bool Inclusive;
+  std::vector<T> Carry;
+  T Total;
+  vtkSMPTools_BlockScan(InputIt in, OutputIt out, vtkIdType size,
+                        vtkIdType blockSize, BinaryOp& op, bool inclusive)
+    : In(in), Out(out), Size(size), BlockSize(blockSize), Op(op),
+      Inclusive(inclusive), Carry((size + blockSize - 1) / blockSize),
+      Total() {}
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      vtkIdType i = block * this->BlockSize;
+      vtkIdType end = std::min(this->Size, i + this->BlockSize);
+      T sum;
+      if (this->Inclusive && block == 0)
+      {
+        sum = this->In[i];
+        this->Out[i++] = sum;
+      }
+      else
+      {
+        sum = this->Carry[block];
+      }
+      for (; i < end; ++i)
+      {
+        T value = this->In[i];
+        if (this->Inclusive)
+        {
+          sum = this->Op(sum, value);
+          this->Out[i] = sum;
+        }
+        else
+        {
+          this->Out[i] = sum;
+          sum = this->Op(sum, value);
+        }
+      }
+      if (end == this->Size)
+      {
+        this->Total = sum;
+      }
+    }
+  }
+};
+
+// Size of the blocks of the reductions and the scans: a few blocks per thread,
+// unless the range is too small to be worth splitting.
+inline vtkIdType vtkSMPTools_BlockSize(vtkIdType size, int numThreads)
+{
+  const vtkIdType minBlockSize = 1024;
+  vtkIdType numBlocks = 4 * static_cast<vtkIdType>(numThreads);
+  return std::max((size + numBlocks - 1) / numBlocks, minBlockSize);
+}
+
+template <typename Iterator, typename T, typename BinaryOp>
+T vtkSMPTools_Reduce(Iterator begin, Iterator end, T init, BinaryOp& op,
+                     int numThreads)
+{
+  vtkIdType size = end - begin;
+  if (size <= 0)
+  {
+    return init;
+  }
+  vtkSMPTools_BlockReduce<Iterator, T, BinaryOp> reduce(
+    begin, size, vtkSMPTools_BlockSize(size, numThreads), op);
+  vtkSMPTools_Impl_For(0, reduce.GetNumberOfBlocks(), 1, reduce);
+  for (typename std::vector<T>::const_iterator it = reduce.Partials.begin();
+       it != reduce.Partials.end(); ++it)
+  {
+    init = op(init, *it);
+  }
+  return init;
+}
+
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+T vtkSMPTools_Scan(InputIt begin, InputIt end, OutputIt outBegin,
+                   const T& init, BinaryOp& op, bool inclusive,
+                   int numThreads)
+{
+  vtkIdType size = end - begin;
+  if (size <= 0)
+  {
+    return init;
+  }
+  vtkIdType blockSize = vtkSMPTools_BlockSize(size, numThreads);
+  vtkSMPTools_BlockScan<InputIt, OutputIt, T, BinaryOp> scan(
+    begin, outBegin, size, blockSize, op, inclusive);
+  vtkIdType numBlocks = static_cast<vtkIdType>(scan.Carry.size());
+  scan.Carry[0] = init;
+  if (numBlocks > 1)
+  {
+    // Reduce all the blocks but the last one to get what each block starts
+    // from.
+    vtkSMPTools_BlockReduce<InputIt, T, BinaryOp> reduce(
+      begin, size, blockSize, op);
+    vtkSMPTools_Impl_For(0, numBlocks - 1, 1, reduce);
+    for (vtkIdType block = 1; block < numBlocks; ++block)
+    {
+      scan.Carry[block] = inclusive && block == 1 ? reduce.Partials[0] :
+        op(scan.Carry[block - 1], reduce.Partials[block - 1]);
+    }
+  }
+  vtkSMPTools_Impl_For(0, numBlocks, 1, scan);
+  return scan.Total;
+}
 } // namespace smp
 } // namespace detail
 } // namespace vtk
@@ -210,7 +417,7 @@ public:
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
    * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
+   * supports it (currently STDThread, OpenMP and TBB). Make sure to call
    * it before any other parallel operation.
    * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
    * the number of threads used in the thread pool.
@@ -249,6 +456,114 @@ public:
     vtk::detail::smp::vtkSMPTools_Impl_Sort(begin,end,comp);
   }
 
+  //@{
+  /**
+   * A parallel drop in replacement for std::transform(), applying a unary
+   * operation to each value of [inBegin, inEnd), or a binary operation to
+   * each pair of values of [inBegin1, inEnd1) and of the range starting at
+   * inBegin2, and storing the results from outBegin. The iterators must be
+   * random access iterators and the operation must be thread safe.
+   */
+  template <typename InputIt, typename OutputIt, typename Functor>
+  static void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+                        Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_UnaryTransform<InputIt, OutputIt, Functor>
+      fi(inBegin, outBegin, transform);
+    vtk::detail::smp::vtkSMPTools_Impl_For(0, inEnd - inBegin, 0, fi);
+  }
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+            typename Functor>
+  static void Transform(InputIt1 inBegin1, InputIt1 inEnd1, InputIt2 inBegin2,
+                        OutputIt outBegin, Functor transform)
+  {
+    vtk::detail::smp::vtkSMPTools_BinaryTransform<InputIt1, InputIt2,
+      OutputIt, Functor> fi(inBegin1, inBegin2, outBegin, transform);
+    vtk::detail::smp::vtkSMPTools_Impl_For(0, inEnd1 - inBegin1, 0, fi);
+  }
+  //@}
+
+  /**
+   * A parallel drop in replacement for std::fill(), assigning value to each
+   * element of [begin, end). The iterators must be random access iterators.
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_Fill<Iterator, T> fi(begin, value);
+    vtk::detail::smp::vtkSMPTools_Impl_For(0, end - begin, 0, fi);
+  }
+
+  //@{
+  /**
+   * Reduce the values of [begin, end) with the binary operation op (the sum
+   * by default), starting from init. The values are split in contiguous
+   * blocks reduced in parallel, and the block results are combined in order,
+   * so op must be associative but need not be commutative. With floating
+   * point values the result may depend on the number of threads. The
+   * iterators must be random access iterators.
+   */
+  template <typename Iterator, typename T, typename BinaryOp>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOp op)
+  {
+    return vtk::detail::smp::vtkSMPTools_Reduce(begin, end, init, op,
+      vtkSMPTools::GetEstimatedNumberOfThreads());
+  }
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+  //@}
+
+  //@{
+  /**
+   * Exclusive prefix scan (prefix sum by default) of [begin, end): the
+   * output at outBegin + i is the reduction of init and of the first i
+   * values. Returns the reduction of init and of all the values, which is
+   * typically the size of the data a two-pass algorithm has to allocate.
+   * The output may be the input. As for Reduce(), op must be associative
+   * and the iterators random access iterators.
+   */
+  template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+  static T ExclusiveScan(InputIt begin, InputIt end, OutputIt outBegin,
+                         T init, BinaryOp op)
+  {
+    return vtk::detail::smp::vtkSMPTools_Scan(begin, end, outBegin, init, op,
+      false, vtkSMPTools::GetEstimatedNumberOfThreads());
+  }
+  template <typename InputIt, typename OutputIt, typename T>
+  static T ExclusiveScan(InputIt begin, InputIt end, OutputIt outBegin, T init)
+  {
+    return vtkSMPTools::ExclusiveScan(begin, end, outBegin, init,
+                                      std::plus<T>());
+  }
+  //@}
+
+  //@{
+  /**
+   * Inclusive prefix scan (prefix sum by default) of [begin, end), a
+   * parallel drop in replacement for std::partial_sum(): the output at
+   * outBegin + i is the reduction of the first i + 1 values. The output may
+   * be the input. As for Reduce(), op must be associative and the iterators
+   * random access iterators.
+   */
+  template <typename InputIt, typename OutputIt, typename BinaryOp>
+  static void InclusiveScan(InputIt begin, InputIt end, OutputIt outBegin,
+                            BinaryOp op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    vtk::detail::smp::vtkSMPTools_Scan(begin, end, outBegin, T(), op, true,
+      vtkSMPTools::GetEstimatedNumberOfThreads());
+  }
+  template <typename InputIt, typename OutputIt>
+  static void InclusiveScan(InputIt begin, InputIt end, OutputIt outBegin)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type T;
+    vtkSMPTools::InclusiveScan(begin, end, outBegin, std::plus<T>());
+  }
+  //@}
+
 };
 
 #endif
@@ -0,0 +1,374 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the queries of vtkBVHCellLocator, one at a time and batched,
+// against brute force evaluation over all the cells of a graded tetrahedral
+// mesh and of a soup of triangles of very different sizes.
+
+#include "vtkBVHCellLocator.h"
+#include "vtkBox.h"
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+void RandomPoint(vtkMinimalStandardRandomSequence *random, double min,
+                 double max, double x[3])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    x[i] = random->GetRangeValue(min, max);
+    random->Next();
+  }
+}
+
+// A lattice whose spacing grows quadratically, each hexahedron split into
+// six tetrahedra.
+void MakeTetrahedra(vtkUnstructuredGrid *grid)
+{
+  const int n = 8;
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k <= n; ++k)
+  {
+    for (int j = 0; j <= n; ++j)
+    {
+      for (int i = 0; i <= n; ++i)
+      {
+        double x = static_cast<double>(i) / n;
+        double y = static_cast<double>(j) / n;
+        double z = static_cast<double>(k) / n;
+        points->InsertNextPoint(x * x, y * y * y, z);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->Allocate(6 * n * n * n);
+
+  int axes[6][3] = { { 0, 1, 2 }, { 0, 2, 1 }, { 1, 0, 2 },
+                     { 1, 2, 0 }, { 2, 0, 1 }, { 2, 1, 0 } };
+  for (int k = 0; k < n; ++k)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < n; ++i)
+      {
+        for (int t = 0; t < 6; ++t)
+        {
+          int ijk[3] = { i, j, k };
+          vtkIdType tetra[4];
+          for (int v = 0; v < 4; ++v)
+          {
+            if (v > 0)
+            {
+              ijk[axes[t][v - 1]]++;
+            }
+            tetra[v] = ijk[0] + (n + 1) * (ijk[1] + (n + 1) * ijk[2]);
+          }
+          grid->InsertNextCell(VTK_TETRA, 4, tetra);
+        }
+      }
+    }
+  }
+}
+
+void MakeTriangles(vtkPolyData *polyData, vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> triangles;
+  for (int i = 0; i < 3000; ++i)
+  {
+    double center[3], size = std::pow(10.0, random->GetRangeValue(-3.0, -0.5));
+    random->Next();
+    RandomPoint(random, 0.0, 1.0, center);
+    vtkIdType ids[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      double x[3];
+      RandomPoint(random, -size, size, x);
+      ids[j] = points->InsertNextPoint(
+        center[0] + x[0], center[1] + x[1], center[2] + x[2]);
+    }
+    triangles->InsertNextCell(3, ids);
+  }
+  polyData->SetPoints(points);
+  polyData->SetPolys(triangles);
+}
+
+std::vector<vtkIdType> Sorted(vtkIdList *ids)
+{
+  std::vector<vtkIdType> v(ids->GetPointer(0),
+                           ids->GetPointer(0) + ids->GetNumberOfIds());
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+int TestFindCell(vtkDataSet *ds, vtkBVHCellLocator *locator,
+                 vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkDoubleArray> points;
+  points->SetNumberOfComponents(3);
+  for (int i = 0; i < 500; ++i)
+  {
+    double x[3];
+    RandomPoint(random, -0.1, 1.1, x);
+    points->InsertNextTuple(x);
+  }
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  vtkNew<vtkDoubleArray> pcoords;
+  locator->FindCells(points, cellIds, pcoords);
+  if (cellIds->GetNumberOfTuples() != points->GetNumberOfTuples() ||
+      pcoords->GetNumberOfTuples() != points->GetNumberOfTuples())
+  {
+    cerr << "FindCells: wrong output sizes" << endl;
+    return 1;
+  }
+
+  vtkNew<vtkGenericCell> cell;
+  double x[3], pc[3], weights[4], dist2;
+  int subId, numFound = 0;
+  for (vtkIdType i = 0; i < points->GetNumberOfTuples(); ++i)
+  {
+    points->GetTuple(i, x);
+    vtkIdType cellId = locator->FindCell(x, 0.0, cell, pc, weights);
+    if (cellId != cellIds->GetValue(i) ||
+        (cellId >= 0 &&
+         (pc[0] != pcoords->GetComponent(i, 0) ||
+          pc[1] != pcoords->GetComponent(i, 1) ||
+          pc[2] != pcoords->GetComponent(i, 2))))
+    {
+      cerr << "FindCells: point " << i << " differs from FindCell" << endl;
+      return 1;
+    }
+
+    vtkIdType expected = -1;
+    for (vtkIdType c = 0; c < ds->GetNumberOfCells() && expected < 0; ++c)
+    {
+      ds->GetCell(c, cell);
+      if (cell->EvaluatePosition(x, nullptr, subId, pc, dist2, weights) == 1)
+      {
+        expected = c;
+      }
+    }
+    if ((cellId < 0) != (expected < 0))
+    {
+      cerr << "FindCell: point " << i << " found in cell " << cellId
+           << " instead of " << expected << endl;
+      return 1;
+    }
+    if (cellId >= 0)
+    {
+      ds->GetCell(cellId, cell);
+      if (cell->EvaluatePosition(x, nullptr, subId, pc, dist2, weights) != 1)
+      {
+        cerr << "FindCell: point " << i << " is not in cell " << cellId
+             << endl;
+        return 1;
+      }
+      numFound++;
+    }
+  }
+  if (numFound == 0)
+  {
+    cerr << "FindCell: no point found" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int TestIntersectWithLine(vtkDataSet *ds, vtkBVHCellLocator *locator,
+                          vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkDoubleArray> p1s;
+  vtkNew<vtkDoubleArray> p2s;
+  p1s->SetNumberOfComponents(3);
+  p2s->SetNumberOfComponents(3);
+  for (int i = 0; i < 500; ++i)
+  {
+    double x[3];
+    RandomPoint(random, -0.2, 1.2, x);
+    p1s->InsertNextTuple(x);
+    RandomPoint(random, -0.2, 1.2, x);
+    p2s->InsertNextTuple(x);
+  }
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  vtkNew<vtkDoubleArray> ts;
+  vtkNew<vtkDoubleArray> xs;
+  locator->IntersectWithLines(p1s, p2s, 0.0, cellIds, ts, xs);
+
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> cells;
+  int numHits = 0;
+  for (vtkIdType i = 0; i < p1s->GetNumberOfTuples(); ++i)
+  {
+    double p1[3], p2[3], t, x[3], pc[3];
+    int subId;
+    vtkIdType cellId = -1;
+    p1s->GetTuple(i, p1);
+    p2s->GetTuple(i, p2);
+    if (!locator->IntersectWithLine(p1, p2, 0.0, t, x, pc, subId, cellId, cell))
+    {
+      cellId = -1;
+    }
+    if (cellId != cellIds->GetValue(i) ||
+        (cellId >= 0 &&
+         (t != ts->GetValue(i) || x[0] != xs->GetComponent(i, 0) ||
+          x[1] != xs->GetComponent(i, 1) || x[2] != xs->GetComponent(i, 2))))
+    {
+      cerr << "IntersectWithLines: line " << i
+           << " differs from IntersectWithLine" << endl;
+      return 1;
+    }
+
+    // The closest intersection over all the cells, and the cells whose
+    // bounds the line crosses.
+    double tMin = VTK_DOUBLE_MAX, dir[3], bounds[6], coord[3], tBox;
+    std::vector<vtkIdType> along;
+    for (int j = 0; j < 3; ++j)
+    {
+      dir[j] = p2[j] - p1[j];
+    }
+    for (vtkIdType c = 0; c < ds->GetNumberOfCells(); ++c)
+    {
+      double tc, xc[3];
+      ds->GetCell(c, cell);
+      if (cell->IntersectWithLine(p1, p2, 0.0, tc, xc, pc, subId) &&
+          tc < tMin)
+      {
+        tMin = tc;
+      }
+      ds->GetCellBounds(c, bounds);
+      if (vtkBox::IntersectBox(bounds, p1, dir, coord, tBox))
+      {
+        along.push_back(c);
+      }
+    }
+    if ((cellId >= 0) != (tMin < VTK_DOUBLE_MAX) ||
+        (cellId >= 0 && t != tMin))
+    {
+      cerr << "IntersectWithLine: line " << i << " hit cell " << cellId
+           << " at " << t << " instead of " << tMin << endl;
+      return 1;
+    }
+    numHits += (cellId >= 0 ? 1 : 0);
+
+    locator->FindCellsAlongLine(p1, p2, 0.0, cells);
+    if (Sorted(cells) != along)
+    {
+      cerr << "FindCellsAlongLine: line " << i << " found "
+           << cells->GetNumberOfIds() << " cells instead of " << along.size()
+           << endl;
+      return 1;
+    }
+  }
+  if (numHits == 0)
+  {
+    cerr << "IntersectWithLine: no line hit" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int TestFindCellsWithinBounds(vtkDataSet *ds, vtkBVHCellLocator *locator,
+                              vtkMinimalStandardRandomSequence *random)
+{
+  vtkNew<vtkIdList> cells;
+  for (int i = 0; i < 100; ++i)
+  {
+    double x[3], y[3], bbox[6], bounds[6];
+    RandomPoint(random, -0.1, 1.1, x);
+    RandomPoint(random, -0.1, 1.1, y);
+    for (int j = 0; j < 3; ++j)
+    {
+      bbox[2 * j] = std::min(x[j], y[j]);
+      bbox[2 * j + 1] = std::max(x[j], y[j]);
+    }
+    std::vector<vtkIdType> expected;
+    for (vtkIdType c = 0; c < ds->GetNumberOfCells(); ++c)
+    {
+      ds->GetCellBounds(c, bounds);
+      if (bounds[0] <= bbox[1] && bbox[0] <= bounds[1] &&
+          bounds[2] <= bbox[3] && bbox[2] <= bounds[3] &&
+          bounds[4] <= bbox[5] && bbox[4] <= bounds[5])
+      {
+        expected.push_back(c);
+      }
+    }
+    locator->FindCellsWithinBounds(bbox, cells);
+    if (Sorted(cells) != expected)
+    {
+      cerr << "FindCellsWithinBounds: box " << i << " found "
+           << cells->GetNumberOfIds() << " cells instead of "
+           << expected.size() << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}
+
+int TestBVHCellLocator(int, char *[])
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  vtkNew<vtkUnstructuredGrid> tetrahedra;
+  MakeTetrahedra(tetrahedra);
+  vtkNew<vtkPolyData> triangles;
+  MakeTriangles(triangles, random);
+
+  int rval = 0;
+  int leafSizes[2] = { 1, 8 };
+  for (int leafSize : leafSizes)
+  {
+    vtkNew<vtkBVHCellLocator> locator;
+    locator->SetNumberOfCellsPerNode(leafSize);
+    locator->SetDataSet(tetrahedra);
+    locator->BuildLocator();
+    rval |= TestFindCell(tetrahedra, locator, random);
+    rval |= TestFindCellsWithinBounds(tetrahedra, locator, random);
+
+    locator->SetDataSet(triangles);
+    locator->BuildLocator();
+    rval |= TestIntersectWithLine(triangles, locator, random);
+    rval |= TestFindCellsWithinBounds(triangles, locator, random);
+
+    vtkNew<vtkPolyData> representation;
+    locator->GenerateRepresentation(3, representation);
+    if (representation->GetNumberOfCells() == 0 ||
+        representation->GetNumberOfCells() > 6 * 8)
+    {
+      cerr << "GenerateRepresentation: " << representation->GetNumberOfCells()
+           << " faces" << endl;
+      rval = 1;
+    }
+  }
+  return rval;
+}
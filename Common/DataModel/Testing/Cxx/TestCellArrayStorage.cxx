@@ -0,0 +1,301 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellArrayStorage.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Exercise the offsets/connectivity storage modes of vtkCellArray, the
+// conversions between them and the legacy layout, and the legacy accessors
+// on offsets storage.
+
+#include "vtkCellArray.h"
+#include "vtkCommand.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTypeInt32Array.h"
+
+namespace
+{
+
+// Cells: a triangle, a quad, a vertex and a pentagon.
+const vtkIdType NumberOfCells = 4;
+const vtkIdType CellSizes[NumberOfCells] = { 3, 4, 1, 5 };
+const vtkIdType CellIds[] = { 0, 1, 2,  2, 3, 4, 5,  6,  7, 8, 9, 10, 11 };
+
+int CheckCells(vtkCellArray *ca, const char *label)
+{
+  if (ca->GetNumberOfCells() != NumberOfCells)
+  {
+    cerr << label << ": expected " << NumberOfCells << " cells, got "
+         << ca->GetNumberOfCells() << endl;
+    return 1;
+  }
+
+  vtkNew<vtkIdList> scratch;
+  vtkNew<vtkIdList> ids;
+  const vtkIdType *expected = CellIds;
+  for (vtkIdType cellId = 0; cellId < NumberOfCells; ++cellId)
+  {
+    vtkIdType npts;
+    const vtkIdType *pts;
+    ca->GetCellAtId(cellId, npts, pts, scratch);
+    ca->GetCellAtId(cellId, ids);
+    if (npts != CellSizes[cellId] || ids->GetNumberOfIds() != npts ||
+        ca->GetCellSize(cellId) != npts)
+    {
+      cerr << label << ": wrong size for cell " << cellId << endl;
+      return 1;
+    }
+    for (vtkIdType i = 0; i < npts; ++i, ++expected)
+    {
+      if (pts[i] != *expected || ids->GetId(i) != *expected)
+      {
+        cerr << label << ": wrong point id " << i << " in cell " << cellId
+             << endl;
+        return 1;
+      }
+    }
+  }
+  if (ca->GetNumberOfConnectivityIds() != 13 || ca->GetMaxCellSize() != 5)
+  {
+    cerr << label << ": wrong connectivity size or maximum cell size" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Traverse the cells and access them by location, which must work with any
+// storage and leave it unchanged.
+int CheckLegacyAccess(vtkCellArray *ca, const char *label)
+{
+  const int mode = ca->GetStorageMode();
+  vtkNew<vtkIdList> ids;
+  const vtkIdType *expected = CellIds;
+  vtkIdType npts, *pts, cellId = 0;
+  for (ca->InitTraversal(); ca->GetNextCell(npts, pts); ++cellId)
+  {
+    const vtkIdType loc = ca->GetTraversalLocation(npts);
+    vtkIdType locNpts, *locPts;
+    ca->GetCell(loc, locNpts, locPts);
+    ca->GetCell(loc, ids);
+    if (cellId >= NumberOfCells || npts != CellSizes[cellId] ||
+        locNpts != npts || ids->GetNumberOfIds() != npts)
+    {
+      cerr << label << ": wrong traversal of cell " << cellId << endl;
+      return 1;
+    }
+    for (vtkIdType i = 0; i < npts; ++i, ++expected)
+    {
+      if (locPts[i] != *expected || ids->GetId(i) != *expected)
+      {
+        cerr << label << ": wrong point id " << i << " in cell " << cellId
+             << endl;
+        return 1;
+      }
+    }
+  }
+  if (cellId != NumberOfCells ||
+      ca->GetNumberOfConnectivityEntries() != NumberOfCells + 13 ||
+      ca->GetData()->GetNumberOfValues() != NumberOfCells + 13 ||
+      ca->GetPointer()[NumberOfCells + 12] != 11)
+  {
+    cerr << label << ": wrong legacy layout" << endl;
+    return 1;
+  }
+  if (ca->GetStorageMode() != mode)
+  {
+    cerr << label << ": the storage mode changed" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+void InsertCells(vtkCellArray *ca)
+{
+  const vtkIdType *pts = CellIds;
+  for (vtkIdType cellId = 0; cellId < NumberOfCells; ++cellId)
+  {
+    ca->InsertNextCell(CellSizes[cellId], pts);
+    pts += CellSizes[cellId];
+  }
+}
+
+}
+
+int TestCellArrayStorage(int, char *[])
+{
+  int rval = 0;
+
+  // Legacy insertion followed by the conversion to offsets.
+  vtkNew<vtkCellArray> ca;
+  InsertCells(ca);
+  rval |= CheckLegacyAccess(ca, "legacy");
+  ca->ConvertToDefaultStorage();
+#ifdef VTK_USE_64BIT_IDS
+  if (ca->GetStorageMode() != vtkCellArray::OFFSETS_64BIT_STORAGE)
+#else
+  if (ca->GetStorageMode() != vtkCellArray::OFFSETS_32BIT_STORAGE)
+#endif
+  {
+    cerr << "Cannot convert to the default storage" << endl;
+    rval = 1;
+  }
+  rval |= CheckCells(ca, "default");
+  rval |= CheckLegacyAccess(ca, "default");
+
+  // Conversions in both directions preserve the cells.
+  if (!ca->CanConvertTo32BitStorage() || !ca->ConvertTo32BitStorage())
+  {
+    cerr << "Cannot convert to 32-bit storage" << endl;
+    rval = 1;
+  }
+  rval |= CheckCells(ca, "32-bit");
+  rval |= CheckLegacyAccess(ca, "32-bit");
+  ca->ConvertTo64BitStorage();
+  rval |= CheckCells(ca, "64-bit");
+  rval |= CheckLegacyAccess(ca, "64-bit");
+
+  // Editing by location goes to the offsets storage, and the legacy copy is
+  // rebuilt.
+  ca->ReverseCell(4);
+  if (ca->GetPointer()[4] != 4 || ca->GetPointer()[5] != 5)
+  {
+    cerr << "ReverseCell failed with offsets storage" << endl;
+    rval = 1;
+  }
+  const vtkIdType quad[4] = { 2, 3, 4, 5 };
+  ca->ReplaceCell(4, 4, quad);
+  rval |= CheckCells(ca, "replaced by location");
+
+  // The conversion back to the interleaved layout.
+  ca->ConvertToLegacyStorage();
+  if (ca->GetStorageMode() != vtkCellArray::LEGACY_STORAGE)
+  {
+    cerr << "Conversion to the legacy layout failed" << endl;
+    rval = 1;
+  }
+  rval |= CheckLegacyAccess(ca, "converted back");
+
+  // Native insertion into 32-bit storage, including incremental insertion.
+  vtkNew<vtkCellArray> ca32;
+  ca32->ConvertTo32BitStorage();
+  const vtkIdType *ids = CellIds;
+  for (vtkIdType cellId = 0; cellId < NumberOfCells - 1; ++cellId)
+  {
+    ca32->InsertNextCell(CellSizes[cellId], ids);
+    ids += CellSizes[cellId];
+  }
+  ca32->InsertNextCell(7);
+  for (vtkIdType i = 0; i < CellSizes[NumberOfCells-1]; ++i)
+  {
+    ca32->InsertCellPoint(ids[i]);
+  }
+  ca32->UpdateCellCount(static_cast<int>(CellSizes[NumberOfCells-1]));
+  rval |= CheckCells(ca32, "32-bit insertion");
+  rval |= CheckLegacyAccess(ca32, "32-bit insertion");
+  if (ca32->GetInsertLocation(5) != NumberOfCells + 7)
+  {
+    cerr << "Wrong insert location with offsets storage" << endl;
+    rval = 1;
+  }
+
+#ifdef VTK_USE_64BIT_IDS
+  // Point ids beyond the precision of a double survive incremental insertion.
+  vtkNew<vtkCellArray> ca64;
+  ca64->ConvertTo64BitStorage();
+  const vtkIdType largeId = (static_cast<vtkIdType>(1) << 53) + 1;
+  ca64->InsertNextCell(2);
+  ca64->InsertCellPoint(largeId);
+  ca64->InsertCellPoint(largeId + 2);
+  ca64->UpdateCellCount(2);
+  vtkNew<vtkIdList> scratch;
+  vtkIdType npts;
+  const vtkIdType *pts;
+  ca64->GetCellAtId(0, npts, pts, scratch);
+  if (npts != 2 || pts[0] != largeId || pts[1] != largeId + 2)
+  {
+    cerr << "Large point ids were not preserved" << endl;
+    rval = 1;
+  }
+#endif
+
+  // Deep copies keep the storage.
+  vtkNew<vtkCellArray> copy;
+  copy->DeepCopy(ca32);
+  if (copy->GetStorageMode() != vtkCellArray::OFFSETS_32BIT_STORAGE)
+  {
+    cerr << "DeepCopy did not preserve the storage mode" << endl;
+    rval = 1;
+  }
+  rval |= CheckCells(copy, "deep copy");
+
+  // Zero-copy adoption of application owned buffers.
+  vtkTypeInt32 offsetsBuffer[] = { 0, 3, 7, 8, 13 };
+  vtkTypeInt32 connBuffer[13];
+  std::copy(CellIds, CellIds + 13, connBuffer);
+  vtkNew<vtkTypeInt32Array> offsets;
+  offsets->SetArray(offsetsBuffer, 5, 1);
+  vtkNew<vtkTypeInt32Array> conn;
+  conn->SetArray(connBuffer, 13, 1);
+  vtkNew<vtkCellArray> adopted;
+  if (!adopted->SetData(offsets, conn) ||
+      adopted->GetConnectivityArray() != conn.GetPointer())
+  {
+    cerr << "SetData did not adopt the arrays" << endl;
+    rval = 1;
+  }
+  rval |= CheckCells(adopted, "adopted");
+
+  // Editing by cell id.
+  adopted->ReverseCellAtId(0);
+  if (connBuffer[0] != 2 || connBuffer[2] != 0)
+  {
+    cerr << "ReverseCellAtId failed" << endl;
+    rval = 1;
+  }
+  const vtkIdType triangle[3] = { 0, 1, 2 };
+  adopted->ReplaceCellAtId(0, 3, triangle);
+  rval |= CheckCells(adopted, "replaced");
+
+  // Mismatched arrays and inconsistent offsets are rejected.
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  adopted->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  vtkNew<vtkIdTypeArray> conn64;
+  conn64->SetNumberOfValues(13);
+  if (adopted->SetData(offsets, conn64))
+  {
+    cerr << "SetData accepted mismatched arrays" << endl;
+    rval = 1;
+  }
+  rval |= errorObserver->CheckErrorMessage("must both be 32-bit");
+  vtkTypeInt32 decreasingBuffer[] = { 0, 3, 8, 7, 13 };
+  vtkNew<vtkTypeInt32Array> decreasing;
+  decreasing->SetArray(decreasingBuffer, 5, 1);
+  vtkTypeInt32 overflowBuffer[] = { 0, 3, 7, 8, 14 };
+  vtkNew<vtkTypeInt32Array> overflow;
+  overflow->SetArray(overflowBuffer, 5, 1);
+  if (adopted->SetData(decreasing, conn))
+  {
+    cerr << "SetData accepted decreasing offsets" << endl;
+    rval = 1;
+  }
+  rval |= errorObserver->CheckErrorMessage("Offsets must start with 0");
+  if (adopted->SetData(overflow, conn))
+  {
+    cerr << "SetData accepted offsets past the connectivity" << endl;
+    rval = 1;
+  }
+  rval |= errorObserver->CheckErrorMessage("Offsets must start with 0");
+
+  return rval;
+}
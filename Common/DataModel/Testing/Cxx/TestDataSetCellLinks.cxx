@@ -0,0 +1,274 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetCellLinks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Build the links of an unstructured grid and of a polydata with all the
+// cell types, which are large enough for the static links to be built in
+// parallel, check that they are the same as the editable vtkCellLinks, and
+// that they can still be edited.
+
+#include "vtkCellArray.h"
+#include "vtkCellLinks.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLinks.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+
+namespace
+{
+
+const int Dim = 30;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Dim * (j + Dim * k);
+}
+
+void MakePoints(vtkPointSet *ds)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < Dim; ++k)
+  {
+    for (int j = 0; j < Dim; ++j)
+    {
+      for (int i = 0; i < Dim; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  ds->SetPoints(points);
+}
+
+// Hexahedra, with a tetrahedron every few cells. The last points are not
+// used by any cell.
+void MakeGrid(vtkUnstructuredGrid *ugrid)
+{
+  MakePoints(ugrid);
+  ugrid->Allocate((Dim - 1) * (Dim - 1) * (Dim - 1));
+  for (int k = 0; k < Dim - 2; ++k)
+  {
+    for (int j = 0; j < Dim - 1; ++j)
+    {
+      for (int i = 0; i < Dim - 1; ++i)
+      {
+        if ((i + j + k) % 7 == 0)
+        {
+          vtkIdType tetra[4] = { PointId(i, j, k), PointId(i + 1, j, k),
+                                 PointId(i, j + 1, k), PointId(i, j, k + 1) };
+          ugrid->InsertNextCell(VTK_TETRA, 4, tetra);
+          continue;
+        }
+        vtkIdType hex[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+      }
+    }
+  }
+}
+
+// Quads on each plane of constant k, plus vertices, lines and strips.
+void MakePolyData(vtkPolyData *pdata)
+{
+  MakePoints(pdata);
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int k = 0; k < Dim; ++k)
+  {
+    for (int j = 0; j < Dim - 1; ++j)
+    {
+      for (int i = 0; i < Dim - 1; ++i)
+      {
+        vtkIdType quad[4] = { PointId(i, j, k), PointId(i + 1, j, k),
+                              PointId(i + 1, j + 1, k), PointId(i, j + 1, k) };
+        polys->InsertNextCell(4, quad);
+        if ((i * j + k) % 11 == 0)
+        {
+          vtkIdType vert = PointId(i + 1, j, k);
+          verts->InsertNextCell(1, &vert);
+          vtkIdType line[3] = { PointId(i, j, k), PointId(i, j + 1, k),
+                                PointId(i, j + 1, (k + 1) % Dim) };
+          lines->InsertNextCell(3, line);
+        }
+      }
+      vtkIdType strip[4] = { PointId(0, j, k), PointId(0, j + 1, k),
+                             PointId(1, j, k), PointId(1, j + 1, k) };
+      strips->InsertNextCell(4, strip);
+    }
+  }
+  pdata->SetVerts(verts);
+  pdata->SetLines(lines);
+  pdata->SetPolys(polys);
+  pdata->SetStrips(strips);
+}
+
+// Compare the static links with the editable ones, in which the cells are
+// listed in increasing order.
+int CompareStaticLinks(vtkDataSet *ds, const char *label)
+{
+  vtkNew<vtkCellLinks> reference;
+  reference->Allocate(ds->GetNumberOfPoints());
+  reference->BuildLinks(ds);
+  vtkNew<vtkStaticCellLinks> links;
+  links->BuildLinks(ds);
+
+  for (vtkIdType ptId = 0; ptId < ds->GetNumberOfPoints(); ++ptId)
+  {
+    vtkIdType ncells = links->GetNumberOfCells(ptId);
+    const vtkIdType *cells = links->GetCells(ptId);
+    if (ncells != reference->GetNcells(ptId) ||
+        !std::equal(cells, cells + ncells, reference->GetCells(ptId)))
+    {
+      cerr << label << ": wrong static links at point " << ptId << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Compare the links built by the dataset with the editable ones.
+int CompareDataSetLinks(vtkDataSet *ds, vtkCellLinks *reference,
+                        const char *label)
+{
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType ptId = 0; ptId < ds->GetNumberOfPoints(); ++ptId)
+  {
+    ds->GetPointCells(ptId, cellIds);
+    if (cellIds->GetNumberOfIds() != reference->GetNcells(ptId) ||
+        !std::equal(cellIds->GetPointer(0),
+                    cellIds->GetPointer(0) + cellIds->GetNumberOfIds(),
+                    reference->GetCells(ptId)))
+    {
+      cerr << label << ": wrong links at point " << ptId << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestGrid()
+{
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakeGrid(ugrid);
+  int rval = CompareStaticLinks(ugrid, "unstructured grid");
+
+  vtkNew<vtkCellLinks> reference;
+  reference->Allocate(ugrid->GetNumberOfPoints());
+  reference->BuildLinks(ugrid);
+  ugrid->BuildLinks();
+  rval |= CompareDataSetLinks(ugrid, reference, "unstructured grid");
+  if (ugrid->GetCellLinks() != nullptr)
+  {
+    cerr << "unstructured grid: static links were converted" << endl;
+    rval = 1;
+  }
+
+  // The neighbors across the face of the second cell, a hexahedron.
+  vtkNew<vtkIdList> face;
+  face->InsertNextId(PointId(2, 0, 0));
+  face->InsertNextId(PointId(2, 1, 0));
+  face->InsertNextId(PointId(2, 0, 1));
+  face->InsertNextId(PointId(2, 1, 1));
+  vtkNew<vtkIdList> neighbors;
+  ugrid->GetCellNeighbors(1, face, neighbors);
+  if (neighbors->GetNumberOfIds() != 1 || neighbors->GetId(0) != 2)
+  {
+    cerr << "unstructured grid: wrong cell neighbors" << endl;
+    rval = 1;
+  }
+
+  // Editing the links converts them to editable links.
+  vtkIdType ptId = PointId(1, 1, 1);
+  vtkIdType ncells = reference->GetNcells(ptId);
+  vtkIdType cellId = reference->GetCells(ptId)[ncells - 1];
+  ugrid->RemoveReferenceToCell(ptId, cellId);
+  reference->RemoveCellReference(cellId, ptId);
+  if (ugrid->GetCellLinks() == nullptr)
+  {
+    cerr << "unstructured grid: no editable links" << endl;
+    rval = 1;
+  }
+  rval |= CompareDataSetLinks(ugrid, reference, "edited unstructured grid");
+  return rval;
+}
+
+int TestPolyData()
+{
+  vtkNew<vtkPolyData> pdata;
+  MakePolyData(pdata);
+  pdata->BuildCells();
+  int rval = CompareStaticLinks(pdata, "polydata");
+
+  vtkNew<vtkCellLinks> reference;
+  reference->Allocate(pdata->GetNumberOfPoints());
+  reference->BuildLinks(pdata);
+  pdata->BuildLinks();
+  rval |= CompareDataSetLinks(pdata, reference, "polydata");
+
+  // A shallow copy shares the static links.
+  vtkNew<vtkPolyData> copy;
+  copy->ShallowCopy(pdata);
+  rval |= CompareDataSetLinks(copy, reference, "polydata copy");
+
+  // A point of the first column is used by quads, strips and lines.
+  vtkIdType ptId = PointId(0, 1, 0);
+  if (!pdata->IsEdge(ptId, PointId(1, 1, 0)) ||
+      pdata->IsEdge(ptId, PointId(1, 2, 0)))
+  {
+    cerr << "polydata: wrong edges" << endl;
+    rval = 1;
+  }
+
+  // Editing the links converts them to editable links.
+  double x[3] = { 0.5, 0.5, 0.0 };
+  vtkIdType newPtId = pdata->InsertNextLinkedPoint(x, 1);
+  unsigned short ncells;
+  vtkIdType *cells;
+  pdata->GetPointCells(ptId, ncells, cells);
+  vtkIdType cellId = cells[0];
+  pdata->RemoveReferenceToCell(ptId, cellId);
+  pdata->AddReferenceToCell(newPtId, cellId);
+  pdata->GetPointCells(newPtId, ncells, cells);
+  if (ncells != 1 || cells[0] != cellId)
+  {
+    cerr << "polydata: wrong links of the new point" << endl;
+    rval = 1;
+  }
+  reference->RemoveCellReference(cellId, ptId);
+  pdata->GetPointCells(ptId, ncells, cells);
+  if (ncells != reference->GetNcells(ptId) ||
+      !std::equal(cells, cells + ncells, reference->GetCells(ptId)))
+  {
+    cerr << "polydata: wrong links of the edited point" << endl;
+    rval = 1;
+  }
+  return rval;
+}
+
+}
+
+int TestDataSetCellLinks(int, char *[])
+{
+  int rval = TestGrid();
+  rval |= TestPolyData();
+  return rval;
+}
@@ -0,0 +1,159 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitFunctionArrays.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Evaluate implicit functions at the points of float and double arrays at
+// once, and check the values against the evaluation of each point.
+
+#include "vtkBox.h"
+#include "vtkCylinder.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImplicitBoolean.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPlanes.h"
+#include "vtkQuadric.h"
+#include "vtkSphere.h"
+#include "vtkTransform.h"
+
+#include <cmath>
+
+namespace
+{
+
+int CheckFunction(vtkImplicitFunction *function, vtkDataArray *points,
+                  vtkDataArray *values, const char *name)
+{
+  // Start from a wrong size to check that the values are resized.
+  values->SetNumberOfTuples(3);
+  function->FunctionValue(points, values);
+  if (values->GetNumberOfTuples() != points->GetNumberOfTuples() ||
+      values->GetNumberOfComponents() != 1)
+  {
+    cerr << name << ": wrong number of values" << endl;
+    return 1;
+  }
+
+  // Values in single precision are only checked to that precision.
+  double tolerance = (points->GetDataType() == VTK_FLOAT ||
+                      values->GetDataType() == VTK_FLOAT) ? 1e-5 : 1e-12;
+  for (vtkIdType i = 0; i < points->GetNumberOfTuples(); ++i)
+  {
+    double x[3];
+    points->GetTuple(i, x);
+    double expected = function->FunctionValue(x);
+    double value = values->GetTuple1(i);
+    if (std::abs(value - expected) > tolerance * (1.0 + std::abs(expected)))
+    {
+      cerr << name << ": wrong value at " << i << ", got " << value
+           << " instead of " << expected << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}
+
+int TestImplicitFunctionArrays(int, char *[])
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkDoubleArray> doublePoints;
+  doublePoints->SetNumberOfComponents(3);
+  doublePoints->SetNumberOfTuples(20000);
+  vtkNew<vtkFloatArray> floatPoints;
+  floatPoints->SetNumberOfComponents(3);
+  floatPoints->SetNumberOfTuples(20000);
+  for (vtkIdType i = 0; i < doublePoints->GetNumberOfValues(); ++i)
+  {
+    double v = random->GetRangeValue(-2.0, 2.0);
+    random->Next();
+    floatPoints->SetValue(i, static_cast<float>(v));
+    doublePoints->SetValue(i, floatPoints->GetValue(i));
+  }
+
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.1, 0.2, 0.3);
+  plane->SetNormal(1.0, -1.0, 0.5);
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(0.2, -0.1, 0.3);
+  sphere->SetRadius(1.1);
+  vtkNew<vtkBox> box;
+  box->SetBounds(-1.0, 0.5, -0.5, 1.5, -1.0, 1.0);
+  vtkNew<vtkCylinder> cylinder;
+  cylinder->SetCenter(0.1, 0.0, -0.2);
+  cylinder->SetAxis(1.0, 1.0, 0.0);
+  cylinder->SetRadius(0.6);
+  vtkNew<vtkPlanes> planes;
+  planes->SetBounds(-1.0, 1.0, -0.5, 0.5, -1.5, 0.5);
+  vtkNew<vtkQuadric> quadric;
+  quadric->SetCoefficients(1.0, 2.0, 0.5, 0.1, 0.0, 0.3, -1.0, 0.0, 0.2, -0.5);
+
+  // A transformed sphere, and booleans of all the functions.
+  vtkNew<vtkTransform> transform;
+  transform->RotateZ(30.0);
+  transform->Scale(1.0, 2.0, 0.5);
+  vtkNew<vtkSphere> ellipsoid;
+  ellipsoid->SetRadius(0.8);
+  ellipsoid->SetTransform(transform);
+  vtkImplicitFunction *functions[] = { plane, sphere, box, cylinder, planes,
+                                       quadric, ellipsoid };
+  const char *names[] = { "plane", "sphere", "box", "cylinder", "planes",
+                          "quadric", "ellipsoid" };
+  vtkNew<vtkImplicitBoolean> booleans[4];
+  const char *booleanNames[] = { "union", "intersection", "difference",
+                                 "union of magnitudes" };
+  for (int op = 0; op < 4; ++op)
+  {
+    booleans[op]->SetOperationType(op);
+    for (vtkImplicitFunction *function : functions)
+    {
+      booleans[op]->AddFunction(function);
+    }
+  }
+
+  int rval = 0;
+  vtkNew<vtkDoubleArray> doubleValues;
+  vtkNew<vtkFloatArray> floatValues;
+  vtkDataArray *points[2] = { doublePoints, floatPoints };
+  vtkDataArray *values[2] = { doubleValues, floatValues };
+  for (vtkDataArray *p : points)
+  {
+    for (vtkDataArray *v : values)
+    {
+      for (int i = 0; i < 7; ++i)
+      {
+        rval |= CheckFunction(functions[i], p, v, names[i]);
+      }
+      for (int op = 0; op < 4; ++op)
+      {
+        rval |= CheckFunction(booleans[op], p, v, booleanNames[op]);
+      }
+    }
+  }
+
+  // A nested, transformed boolean, and an empty one.
+  vtkNew<vtkImplicitBoolean> nested;
+  nested->SetOperationTypeToDifference();
+  nested->AddFunction(booleans[0]);
+  nested->AddFunction(booleans[1]);
+  nested->SetTransform(transform);
+  rval |= CheckFunction(nested, doublePoints, doubleValues, "nested");
+  vtkNew<vtkImplicitBoolean> empty;
+  rval |= CheckFunction(empty, doublePoints, doubleValues, "empty");
+
+  return rval;
+}
@@ -0,0 +1,201 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStaticPointLocatorBatchedQueries.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Answer batches of closest N points and points within radius queries with
+// vtkStaticPointLocator, and check them against the single queries.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticPointLocator.h"
+
+namespace
+{
+
+// Compare the results of query i to those of the single query.
+int CheckQuery(const char *name, vtkDataSet *ds, vtkDataArray *queryPoints,
+               vtkIdType i, vtkIdList *expected, vtkIdTypeArray *offsets,
+               vtkIdTypeArray *ids, vtkDoubleArray *dist2)
+{
+  vtkIdType begin = offsets->GetValue(i);
+  vtkIdType numIds = offsets->GetValue(i + 1) - begin;
+  if (numIds != expected->GetNumberOfIds())
+  {
+    cerr << name << ": query " << i << " found " << numIds
+         << " points instead of " << expected->GetNumberOfIds() << endl;
+    return 1;
+  }
+  double x[3], pt[3];
+  queryPoints->GetTuple(i, x);
+  for (vtkIdType j = 0; j < numIds; ++j)
+  {
+    vtkIdType ptId = ids->GetValue(begin + j);
+    if (ptId != expected->GetId(j))
+    {
+      cerr << name << ": query " << i << " found point " << ptId
+           << " instead of " << expected->GetId(j) << endl;
+      return 1;
+    }
+    ds->GetPoint(ptId, pt);
+    if (dist2->GetValue(begin + j) != vtkMath::Distance2BetweenPoints(x, pt))
+    {
+      cerr << name << ": query " << i << " has a wrong distance" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestQueries(vtkDataSet *ds, vtkDataArray *queryPoints)
+{
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(ds);
+  locator->BuildLocator();
+
+  vtkNew<vtkIdTypeArray> offsets;
+  vtkNew<vtkIdTypeArray> ids;
+  vtkNew<vtkDoubleArray> dist2;
+  vtkNew<vtkIdList> expected;
+  vtkIdType numQueries = queryPoints->GetNumberOfTuples();
+  double x[3];
+
+  // More points than in the dataset are asked for last.
+  int counts[4] = { 1, 7, 30, static_cast<int>(ds->GetNumberOfPoints()) + 5 };
+  for (int N : counts)
+  {
+    locator->FindClosestNPoints(N, queryPoints, offsets, ids, dist2);
+    if (offsets->GetNumberOfTuples() != numQueries + 1 ||
+        ids->GetNumberOfTuples() != offsets->GetValue(numQueries) ||
+        dist2->GetNumberOfTuples() != ids->GetNumberOfTuples())
+    {
+      cerr << "Closest " << N << " points: wrong output sizes" << endl;
+      return 1;
+    }
+    for (vtkIdType i = 0; i < numQueries; ++i)
+    {
+      queryPoints->GetTuple(i, x);
+      locator->FindClosestNPoints(N, x, expected);
+      if (CheckQuery("Closest N points", ds, queryPoints, i, expected,
+                     offsets, ids, dist2))
+      {
+        return 1;
+      }
+    }
+  }
+
+  double radii[3] = { 0.0, 0.05, 0.3 };
+  vtkIdType numFound = 0;
+  for (double R : radii)
+  {
+    locator->FindPointsWithinRadius(R, queryPoints, offsets, ids, dist2);
+    if (offsets->GetNumberOfTuples() != numQueries + 1 ||
+        ids->GetNumberOfTuples() != offsets->GetValue(numQueries) ||
+        dist2->GetNumberOfTuples() != ids->GetNumberOfTuples())
+    {
+      cerr << "Points within " << R << ": wrong output sizes" << endl;
+      return 1;
+    }
+    for (vtkIdType i = 0; i < numQueries; ++i)
+    {
+      queryPoints->GetTuple(i, x);
+      locator->FindPointsWithinRadius(R, x, expected);
+      if (CheckQuery("Points within radius", ds, queryPoints, i, expected,
+                     offsets, ids, dist2))
+      {
+        return 1;
+      }
+    }
+    numFound += ids->GetNumberOfTuples();
+  }
+  if (numFound == 0)
+  {
+    cerr << "No points found within the radii" << endl;
+    return 1;
+  }
+
+  // The distances are optional.
+  locator->FindPointsWithinRadius(0.3, queryPoints, offsets, ids);
+  if (ids->GetNumberOfTuples() != offsets->GetValue(numQueries))
+  {
+    cerr << "Points within radius without distances: wrong output" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestStaticPointLocatorBatchedQueries(int, char *[])
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  // Random points, and as many queries as to span a few radius batches,
+  // partly outside of the points' bounds. Some queries are on points.
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < 5000; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetValue();
+      random->Next();
+    }
+    points->InsertNextPoint(x);
+  }
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points);
+
+  vtkNew<vtkFloatArray> floatQueries;
+  vtkNew<vtkDoubleArray> doubleQueries;
+  floatQueries->SetNumberOfComponents(3);
+  doubleQueries->SetNumberOfComponents(3);
+  for (int i = 0; i < 2500; ++i)
+  {
+    double x[3];
+    if (i % 10 == 0)
+    {
+      points->GetPoint(i, x);
+    }
+    else
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        x[j] = random->GetRangeValue(-0.2, 1.2);
+        random->Next();
+      }
+    }
+    floatQueries->InsertNextTuple(x);
+    doubleQueries->InsertNextTuple(x);
+  }
+
+  // A dataset with implicit points.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(20, 15, 10);
+  image->SetSpacing(0.05, 0.07, 0.1);
+
+  int rval = 0;
+  rval |= TestQueries(polyData, floatQueries);
+  rval |= TestQueries(polyData, doubleQueries);
+  rval |= TestQueries(image, doubleQueries);
+
+  return rval;
+}
@@ -0,0 +1,1202 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkBVHCellLocator.h"
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
+
+vtkStandardNewMacro(vtkBVHCellLocator);
+
+//----------------------------------------------------------------------------
+// Helper classes to support efficient computing, and threaded execution.
+//
+// The hierarchy is a binary tree stored in a flat array of nodes, where the
+// two children of an interior node are adjacent. The cells are referenced
+// through a permutation of the cell ids, such that the cells of each leaf
+// form a contiguous run.
+//
+// The tree is built top-down. A node is split by binning the centroids of
+// its cells' bounds along each axis, and choosing the bin boundary that
+// minimizes the surface area heuristic (the sum over both children of the
+// surface area of their bounds times their number of cells); the ids are
+// then partitioned in place. The nodes with many cells are split with
+// threaded binning. Once a node has few enough cells, its subtree becomes an
+// independent task, and the tasks are built in parallel into separate node
+// arrays which are finally appended to the top of the tree.
+
+namespace {
+
+const int VTK_BVH_NUM_BINS = 16; // SAH bins per axis
+const int VTK_BVH_MAX_DEPTH = 64; // leaves are forced beyond this depth
+const vtkIdType VTK_BVH_MIN_TASK_SIZE = 1024; // cells per subtree task
+
+struct BVHNode
+{
+  double Bounds[6];
+  vtkIdType Child; //interior: first of the two children; leaf: first cell
+  vtkIdType NumCells; //number of cells in a leaf, zero for interior nodes
+  int Axis; //split axis of interior nodes
+};
+
+void InitializeBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] = VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+void AddBounds(double bounds[6], const double b[6])
+{
+  for (int i=0; i < 3; ++i)
+  {
+    bounds[2*i] = std::min(bounds[2*i], b[2*i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], b[2*i+1]);
+  }
+}
+
+// Half the surface area of the bounds, which is all the SAH needs
+double HalfArea(const double b[6])
+{
+  double dx = b[1] - b[0];
+  double dy = b[3] - b[2];
+  double dz = b[5] - b[4];
+  return ( dx < 0.0 ? 0.0 : dx*dy + dy*dz + dz*dx );
+}
+
+bool PointInBounds(const double x[3], const double b[6])
+{
+  return ( x[0] >= b[0] && x[0] <= b[1] && x[1] >= b[2] && x[1] <= b[3] &&
+           x[2] >= b[4] && x[2] <= b[5] );
+}
+
+bool BoundsOverlap(const double a[6], const double b[6])
+{
+  return ( a[0] <= b[1] && b[0] <= a[1] && a[2] <= b[3] && b[2] <= a[3] &&
+           a[4] <= b[5] && b[4] <= a[5] );
+}
+
+// The bounds of the cells in a node, and of their centroids
+struct RangeBounds
+{
+  double Bounds[6];
+  double CentroidBounds[6];
+
+  void Initialize()
+  {
+    InitializeBounds(this->Bounds);
+    InitializeBounds(this->CentroidBounds);
+  }
+
+  void Merge(const RangeBounds& rb)
+  {
+    AddBounds(this->Bounds, rb.Bounds);
+    AddBounds(this->CentroidBounds, rb.CentroidBounds);
+  }
+};
+
+// The cell counts and bounds of the SAH bins
+struct SAHBins
+{
+  vtkIdType Counts[3][VTK_BVH_NUM_BINS];
+  double Bounds[3][VTK_BVH_NUM_BINS][6];
+
+  void Initialize()
+  {
+    for (int axis=0; axis < 3; ++axis)
+    {
+      for (int i=0; i < VTK_BVH_NUM_BINS; ++i)
+      {
+        this->Counts[axis][i] = 0;
+        InitializeBounds(this->Bounds[axis][i]);
+      }
+    }
+  }
+
+  void Merge(const SAHBins& bins)
+  {
+    for (int axis=0; axis < 3; ++axis)
+    {
+      for (int i=0; i < VTK_BVH_NUM_BINS; ++i)
+      {
+        this->Counts[axis][i] += bins.Counts[axis][i];
+        AddBounds(this->Bounds[axis][i], bins.Bounds[axis][i]);
+      }
+    }
+  }
+};
+
+// Map a centroid coordinate to its bin. Binning and partitioning must use
+// this same function so that they agree.
+inline int BinIndex(const double *cellBounds, int axis,
+                    const double centroidBounds[6])
+{
+  double c = 0.5 * (cellBounds[2*axis] + cellBounds[2*axis+1]);
+  double scale = VTK_BVH_NUM_BINS /
+    (centroidBounds[2*axis+1] - centroidBounds[2*axis]);
+  int bin = static_cast<int>((c - centroidBounds[2*axis]) * scale);
+  return ( bin < 0 ? 0 : (bin >= VTK_BVH_NUM_BINS ? VTK_BVH_NUM_BINS-1 : bin) );
+}
+
+// A finite line (p1,p2) parameterized over [0,1], with its boxes tests
+// inflated by a tolerance.
+struct BVHSegment
+{
+  double Origin[3];
+  double Direction[3];
+  double InverseDirection[3];
+  double Tol;
+
+  BVHSegment(const double p1[3], const double p2[3], double tol) : Tol(tol)
+  {
+    for (int i=0; i < 3; ++i)
+    {
+      this->Origin[i] = p1[i];
+      this->Direction[i] = p2[i] - p1[i];
+      this->InverseDirection[i] = ( this->Direction[i] != 0.0 ?
+                                    1.0 / this->Direction[i] : 0.0 );
+    }
+  }
+
+  // Clip the segment [0,tMax] against the bounds. Return whether some of it
+  // remains, and where it enters the bounds.
+  bool Intersect(const double b[6], double tMax, double &tNear) const
+  {
+    double t0 = 0.0, t1 = tMax;
+    for (int i=0; i < 3; ++i)
+    {
+      double lo = b[2*i] - this->Tol;
+      double hi = b[2*i+1] + this->Tol;
+      if ( this->Direction[i] == 0.0 )
+      {
+        if ( this->Origin[i] < lo || this->Origin[i] > hi )
+        {
+          return false;
+        }
+      }
+      else
+      {
+        double tA = (lo - this->Origin[i]) * this->InverseDirection[i];
+        double tB = (hi - this->Origin[i]) * this->InverseDirection[i];
+        if ( tA > tB )
+        {
+          std::swap(tA, tB);
+        }
+        t0 = ( tA > t0 ? tA : t0 );
+        t1 = ( tB < t1 ? tB : t1 );
+        if ( t0 > t1 )
+        {
+          return false;
+        }
+      }
+    }
+    tNear = t0;
+    return true;
+  }
+};
+
+// A subtree built by one thread
+struct BVHTask
+{
+  vtkIdType NodeId; //where the root of the subtree goes in the tree
+  vtkIdType Begin;
+  vtkIdType End;
+  int Depth;
+  std::vector<BVHNode> Nodes;
+};
+
+} //anonymous namespace
+
+//----------------------------------------------------------------------------
+// PIMPLd class holding the hierarchy, and implementing the queries.
+struct vtkBVHCellTree
+{
+  vtkDataSet *DataSet;
+  vtkIdType NumCells;
+  int LeafSize;
+  int MaxCellSize;
+  std::vector<double> CellBounds; //six values per cell
+  std::vector<vtkIdType> CellIds; //cell ids in leaf order
+  std::vector<BVHNode> Nodes; //the root comes first
+
+  vtkBVHCellTree(vtkDataSet *ds, int leafSize) :
+    DataSet(ds), NumCells(ds->GetNumberOfCells()), LeafSize(leafSize),
+    MaxCellSize(0)
+  {
+  }
+
+  const double *GetCellBounds(vtkIdType cellId) const
+  {
+    return this->CellBounds.data() + 6*cellId;
+  }
+
+  // Build
+  void Build();
+  void AddToRange(vtkIdType begin, vtkIdType end, RangeBounds &rb) const;
+  void AddToBins(vtkIdType begin, vtkIdType end, const RangeBounds &rb,
+                 SAHBins &bins) const;
+  bool Split(vtkIdType begin, vtkIdType end, const RangeBounds &rb,
+             const SAHBins &bins, int &axis, vtkIdType &mid);
+  void BuildTop(vtkIdType nodeId, vtkIdType begin, vtkIdType end, int depth,
+                vtkIdType taskSize, std::vector<BVHTask> &tasks);
+  void BuildSubtree(std::vector<BVHNode> &nodes, vtkIdType nodeId,
+                    vtkIdType begin, vtkIdType end, int depth);
+
+  // Queries
+  vtkIdType FindCell(const double x[3], vtkGenericCell *cell,
+                     double pcoords[3], double *weights) const;
+  void FindCellsWithinBounds(const double bbox[6], vtkIdList *cells) const;
+  void FindCellsAlongLine(const double p1[3], const double p2[3], double tol,
+                          vtkIdList *cells) const;
+  vtkIdType IntersectWithLine(double p1[3], double p2[3], double tol,
+                              double &t, double x[3], double pcoords[3],
+                              int &subId, vtkGenericCell *cell) const;
+};
+
+namespace {
+
+// Compute the cell bounds and initialize the cell ids
+struct ComputeCellBounds
+{
+  vtkBVHCellTree *Tree;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    double *bounds = this->Tree->CellBounds.data() + 6*cellId;
+    for ( ; cellId < endCellId; ++cellId, bounds+=6 )
+    {
+      this->Tree->DataSet->GetCellBounds(cellId, bounds);
+      this->Tree->CellIds[cellId] = cellId;
+    }
+  }
+};
+
+// Whether a cell goes to the left child of a split
+struct LeftOfSplit
+{
+  const vtkBVHCellTree *Tree;
+  int Axis;
+  const double *CentroidBounds;
+  int Bin;
+
+  bool operator()(vtkIdType cellId) const
+  {
+    return ( BinIndex(this->Tree->GetCellBounds(cellId), this->Axis,
+                      this->CentroidBounds) <= this->Bin );
+  }
+};
+
+// Threaded versions of AddToRange() and AddToBins() for the top levels
+struct ComputeRangeBounds
+{
+  const vtkBVHCellTree *Tree;
+  RangeBounds Result;
+  vtkSMPThreadLocal<RangeBounds> LocalResult;
+
+  ComputeRangeBounds(const vtkBVHCellTree *tree) : Tree(tree)
+  {
+  }
+
+  void Initialize()
+  {
+    this->LocalResult.Local().Initialize();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    this->Tree->AddToRange(begin, end, this->LocalResult.Local());
+  }
+
+  void Reduce()
+  {
+    this->Result.Initialize();
+    for (vtkSMPThreadLocal<RangeBounds>::iterator iter =
+           this->LocalResult.begin(); iter != this->LocalResult.end(); ++iter)
+    {
+      this->Result.Merge(*iter);
+    }
+  }
+};
+
+struct ComputeBins
+{
+  const vtkBVHCellTree *Tree;
+  const RangeBounds *Range;
+  SAHBins Result;
+  vtkSMPThreadLocal<SAHBins> LocalResult;
+
+  ComputeBins(const vtkBVHCellTree *tree, const RangeBounds *range) :
+    Tree(tree), Range(range)
+  {
+  }
+
+  void Initialize()
+  {
+    this->LocalResult.Local().Initialize();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    this->Tree->AddToBins(begin, end, *this->Range, this->LocalResult.Local());
+  }
+
+  void Reduce()
+  {
+    this->Result.Initialize();
+    for (vtkSMPThreadLocal<SAHBins>::iterator iter =
+           this->LocalResult.begin(); iter != this->LocalResult.end(); ++iter)
+    {
+      this->Result.Merge(*iter);
+    }
+  }
+};
+
+// Build the subtrees below the top levels
+struct BuildSubtrees
+{
+  vtkBVHCellTree *Tree;
+  BVHTask *Tasks;
+
+  void operator()(vtkIdType task, vtkIdType endTask)
+  {
+    for ( ; task < endTask; ++task )
+    {
+      BVHTask &t = this->Tasks[task];
+      t.Nodes.resize(1);
+      this->Tree->BuildSubtree(t.Nodes, 0, t.Begin, t.End, t.Depth);
+    }
+  }
+};
+
+// Append the subtrees to the tree. The subtree roots replace their
+// placeholders, and the child indices are offset to their new location.
+struct AppendSubtrees
+{
+  vtkBVHCellTree *Tree;
+  BVHTask *Tasks;
+  const vtkIdType *Offsets;
+
+  static void Append(const BVHNode &node, vtkIdType offset, BVHNode &dest)
+  {
+    dest = node;
+    if ( node.NumCells == 0 )
+    {
+      dest.Child += offset - 1; //local index 1 is stored at offset
+    }
+  }
+
+  void operator()(vtkIdType task, vtkIdType endTask)
+  {
+    for ( ; task < endTask; ++task )
+    {
+      BVHTask &t = this->Tasks[task];
+      vtkIdType offset = this->Offsets[task];
+      Append(t.Nodes[0], offset, this->Tree->Nodes[t.NodeId]);
+      for (size_t i=1; i < t.Nodes.size(); ++i)
+      {
+        Append(t.Nodes[i], offset, this->Tree->Nodes[offset + i - 1]);
+      }
+      std::vector<BVHNode>().swap(t.Nodes);
+    }
+  }
+};
+
+} //anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkBVHCellTree::
+AddToRange(vtkIdType begin, vtkIdType end, RangeBounds &rb) const
+{
+  for (vtkIdType i=begin; i < end; ++i)
+  {
+    const double *b = this->GetCellBounds(this->CellIds[i]);
+    AddBounds(rb.Bounds, b);
+    for (int j=0; j < 3; ++j)
+    {
+      double c = 0.5 * (b[2*j] + b[2*j+1]);
+      rb.CentroidBounds[2*j] = std::min(rb.CentroidBounds[2*j], c);
+      rb.CentroidBounds[2*j+1] = std::max(rb.CentroidBounds[2*j+1], c);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkBVHCellTree::
+AddToBins(vtkIdType begin, vtkIdType end, const RangeBounds &rb,
+          SAHBins &bins) const
+{
+  const double *cb = rb.CentroidBounds;
+  for (vtkIdType i=begin; i < end; ++i)
+  {
+    const double *b = this->GetCellBounds(this->CellIds[i]);
+    for (int axis=0; axis < 3; ++axis)
+    {
+      if ( cb[2*axis+1] > cb[2*axis] )
+      {
+        int bin = BinIndex(b, axis, cb);
+        bins.Counts[axis][bin]++;
+        AddBounds(bins.Bounds[axis][bin], b);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Choose the bin boundary of least SAH cost and partition the cell ids
+// accordingly. Returns false if the centroids cannot be separated.
+bool vtkBVHCellTree::
+Split(vtkIdType begin, vtkIdType end, const RangeBounds &rb,
+      const SAHBins &bins, int &axis, vtkIdType &mid)
+{
+  const double *cb = rb.CentroidBounds;
+  double bestCost = VTK_DOUBLE_MAX;
+  int bestBin = -1;
+  axis = -1;
+
+  for (int a=0; a < 3; ++a)
+  {
+    if ( cb[2*a+1] <= cb[2*a] )
+    {
+      continue;
+    }
+
+    // Sweep from the right to get the cost of the right children
+    double bounds[6], rightCost[VTK_BVH_NUM_BINS];
+    vtkIdType count = 0, rightCount[VTK_BVH_NUM_BINS];
+    InitializeBounds(bounds);
+    for (int i=VTK_BVH_NUM_BINS-1; i > 0; --i)
+    {
+      if ( bins.Counts[a][i] > 0 )
+      {
+        count += bins.Counts[a][i];
+        AddBounds(bounds, bins.Bounds[a][i]);
+      }
+      rightCount[i] = count;
+      rightCost[i] = ( count > 0 ? HalfArea(bounds) * count : 0.0 );
+    }
+
+    // Sweep from the left and evaluate the splits
+    InitializeBounds(bounds);
+    count = 0;
+    for (int i=0; i < VTK_BVH_NUM_BINS-1; ++i)
+    {
+      if ( bins.Counts[a][i] > 0 )
+      {
+        count += bins.Counts[a][i];
+        AddBounds(bounds, bins.Bounds[a][i]);
+      }
+      if ( count > 0 && rightCount[i+1] > 0 )
+      {
+        double cost = HalfArea(bounds) * count + rightCost[i+1];
+        if ( cost < bestCost )
+        {
+          bestCost = cost;
+          bestBin = i;
+          axis = a;
+        }
+      }
+    }
+  }
+
+  if ( axis < 0 )
+  {
+    return false;
+  }
+
+  vtkIdType *ids = this->CellIds.data();
+  LeftOfSplit left = { this, axis, cb, bestBin };
+  mid = std::partition(ids+begin, ids+end, left) - ids;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Split the nodes with many cells using threaded binning, until they are
+// small enough to become subtree tasks.
+void vtkBVHCellTree::
+BuildTop(vtkIdType nodeId, vtkIdType begin, vtkIdType end, int depth,
+         vtkIdType taskSize, std::vector<BVHTask> &tasks)
+{
+  if ( (end - begin) <= taskSize || depth >= VTK_BVH_MAX_DEPTH )
+  {
+    BVHTask task;
+    task.NodeId = nodeId;
+    task.Begin = begin;
+    task.End = end;
+    task.Depth = depth;
+    tasks.push_back(task);
+    return;
+  }
+
+  ComputeRangeBounds range(this);
+  vtkSMPTools::For(begin, end, range);
+  ComputeBins bins(this, &range.Result);
+  vtkSMPTools::For(begin, end, bins);
+
+  int axis;
+  vtkIdType mid;
+  BVHNode &node = this->Nodes[nodeId];
+  std::copy(range.Result.Bounds, range.Result.Bounds+6, node.Bounds);
+  if ( ! this->Split(begin, end, range.Result, bins.Result, axis, mid) )
+  {
+    node.Child = begin;
+    node.NumCells = end - begin;
+    node.Axis = 0;
+    return;
+  }
+
+  vtkIdType child = static_cast<vtkIdType>(this->Nodes.size());
+  node.Child = child;
+  node.NumCells = 0;
+  node.Axis = axis;
+  this->Nodes.resize(child + 2); //invalidates node
+  this->BuildTop(child, begin, mid, depth+1, taskSize, tasks);
+  this->BuildTop(child+1, mid, end, depth+1, taskSize, tasks);
+}
+
+//----------------------------------------------------------------------------
+// Serial recursive build of a subtree.
+void vtkBVHCellTree::
+BuildSubtree(std::vector<BVHNode> &nodes, vtkIdType nodeId, vtkIdType begin,
+             vtkIdType end, int depth)
+{
+  RangeBounds rb;
+  rb.Initialize();
+  this->AddToRange(begin, end, rb);
+  std::copy(rb.Bounds, rb.Bounds+6, nodes[nodeId].Bounds);
+
+  int axis;
+  vtkIdType mid;
+  if ( (end - begin) > this->LeafSize && depth < VTK_BVH_MAX_DEPTH )
+  {
+    SAHBins bins;
+    bins.Initialize();
+    this->AddToBins(begin, end, rb, bins);
+    if ( this->Split(begin, end, rb, bins, axis, mid) )
+    {
+      vtkIdType child = static_cast<vtkIdType>(nodes.size());
+      nodes[nodeId].Child = child;
+      nodes[nodeId].NumCells = 0;
+      nodes[nodeId].Axis = axis;
+      nodes.resize(child + 2);
+      this->BuildSubtree(nodes, child, begin, mid, depth+1);
+      this->BuildSubtree(nodes, child+1, mid, end, depth+1);
+      return;
+    }
+  }
+
+  nodes[nodeId].Child = begin;
+  nodes[nodeId].NumCells = end - begin;
+  nodes[nodeId].Axis = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkBVHCellTree::Build()
+{
+  this->CellBounds.resize(6*this->NumCells);
+  this->CellIds.resize(this->NumCells);
+
+  // This is done to cause non-thread safe initialization to occur due to
+  // side effects from GetCellBounds().
+  this->DataSet->GetCellBounds(0, this->CellBounds.data());
+  this->MaxCellSize = this->DataSet->GetMaxCellSize();
+
+  ComputeCellBounds cellBounds = { this };
+  vtkSMPTools::For(0, this->NumCells, cellBounds);
+
+  // Split the top levels, then build the subtrees in parallel
+  vtkIdType taskSize =
+    std::max<vtkIdType>(VTK_BVH_MIN_TASK_SIZE, this->NumCells / 256);
+  std::vector<BVHTask> tasks;
+  this->Nodes.resize(1);
+  this->BuildTop(0, 0, this->NumCells, 0, taskSize, tasks);
+
+  vtkIdType numTasks = static_cast<vtkIdType>(tasks.size());
+  BuildSubtrees subtrees = { this, tasks.data() };
+  vtkSMPTools::For(0, numTasks, 1, subtrees);
+
+  std::vector<vtkIdType> offsets(numTasks);
+  vtkIdType numNodes = static_cast<vtkIdType>(this->Nodes.size());
+  for (vtkIdType i=0; i < numTasks; ++i)
+  {
+    offsets[i] = numNodes;
+    numNodes += static_cast<vtkIdType>(tasks[i].Nodes.size()) - 1;
+  }
+  this->Nodes.resize(numNodes);
+  AppendSubtrees append = { this, tasks.data(), offsets.data() };
+  vtkSMPTools::For(0, numTasks, append);
+}
+
+//----------------------------------------------------------------------------
+// Return the first cell found containing x. A stack is used for traversal,
+// whose size is bounded by the depth of the tree.
+vtkIdType vtkBVHCellTree::
+FindCell(const double x[3], vtkGenericCell *cell, double pcoords[3],
+         double *weights) const
+{
+  vtkIdType stack[VTK_BVH_MAX_DEPTH+2];
+  int top = 0;
+  double dist2, pos[3] = {x[0], x[1], x[2]};
+  int subId;
+
+  stack[top++] = 0;
+  while ( top > 0 )
+  {
+    const BVHNode &node = this->Nodes[stack[--top]];
+    if ( ! PointInBounds(x, node.Bounds) )
+    {
+      continue;
+    }
+    if ( node.NumCells == 0 )
+    {
+      stack[top++] = node.Child + 1;
+      stack[top++] = node.Child;
+      continue;
+    }
+    for (vtkIdType i=0; i < node.NumCells; ++i)
+    {
+      vtkIdType cellId = this->CellIds[node.Child + i];
+      if ( PointInBounds(x, this->GetCellBounds(cellId)) )
+      {
+        this->DataSet->GetCell(cellId, cell);
+        if ( cell->EvaluatePosition(pos, nullptr, subId, pcoords, dist2,
+                                    weights) == 1 )
+        {
+          return cellId;
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+//----------------------------------------------------------------------------
+void vtkBVHCellTree::
+FindCellsWithinBounds(const double bbox[6], vtkIdList *cells) const
+{
+  vtkIdType stack[VTK_BVH_MAX_DEPTH+2];
+  int top = 0;
+
+  cells->Reset();
+  stack[top++] = 0;
+  while ( top > 0 )
+  {
+    const BVHNode &node = this->Nodes[stack[--top]];
+    if ( ! BoundsOverlap(bbox, node.Bounds) )
+    {
+      continue;
+    }
+    if ( node.NumCells == 0 )
+    {
+      stack[top++] = node.Child + 1;
+      stack[top++] = node.Child;
+      continue;
+    }
+    for (vtkIdType i=0; i < node.NumCells; ++i)
+    {
+      vtkIdType cellId = this->CellIds[node.Child + i];
+      if ( BoundsOverlap(bbox, this->GetCellBounds(cellId)) )
+      {
+        cells->InsertNextId(cellId);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkBVHCellTree::
+FindCellsAlongLine(const double p1[3], const double p2[3], double tol,
+                   vtkIdList *cells) const
+{
+  BVHSegment segment(p1, p2, tol);
+  vtkIdType stack[VTK_BVH_MAX_DEPTH+2];
+  int top = 0;
+  double tNear;
+
+  cells->Reset();
+  stack[top++] = 0;
+  while ( top > 0 )
+  {
+    const BVHNode &node = this->Nodes[stack[--top]];
+    if ( ! segment.Intersect(node.Bounds, 1.0, tNear) )
+    {
+      continue;
+    }
+    if ( node.NumCells == 0 )
+    {
+      stack[top++] = node.Child + 1;
+      stack[top++] = node.Child;
+      continue;
+    }
+    for (vtkIdType i=0; i < node.NumCells; ++i)
+    {
+      vtkIdType cellId = this->CellIds[node.Child + i];
+      if ( segment.Intersect(this->GetCellBounds(cellId), 1.0, tNear) )
+      {
+        cells->InsertNextId(cellId);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Find the intersection closest to p1. The children are visited front to
+// back, and the nodes farther than the closest intersection found so far are
+// skipped. Returns the intersected cell id or -1.
+vtkIdType vtkBVHCellTree::
+IntersectWithLine(double p1[3], double p2[3], double tol, double &t,
+                  double x[3], double pcoords[3], int &subId,
+                  vtkGenericCell *cell) const
+{
+  struct StackEntry
+  {
+    vtkIdType NodeId;
+    double TNear;
+  } stack[VTK_BVH_MAX_DEPTH+2];
+  int top = 0;
+
+  BVHSegment segment(p1, p2, tol);
+  double tNear, tBest = VTK_DOUBLE_MAX;
+  double tCell, xCell[3], pcoordsCell[3];
+  int subIdCell;
+  vtkIdType bestCellId = -1, lastCellId = -1;
+
+  if ( ! segment.Intersect(this->Nodes[0].Bounds, 1.0, tNear) )
+  {
+    return -1;
+  }
+  stack[top].NodeId = 0;
+  stack[top++].TNear = tNear;
+
+  while ( top > 0 )
+  {
+    --top;
+    if ( stack[top].TNear > tBest )
+    {
+      continue;
+    }
+    const BVHNode &node = this->Nodes[stack[top].NodeId];
+    double tMax = std::min(1.0, tBest);
+
+    if ( node.NumCells == 0 )
+    {
+      double tNear0, tNear1;
+      bool hit0 = segment.Intersect(this->Nodes[node.Child].Bounds, tMax,
+                                    tNear0);
+      bool hit1 = segment.Intersect(this->Nodes[node.Child+1].Bounds, tMax,
+                                    tNear1);
+      // Push the farther child first so that the nearer one is popped first
+      if ( hit0 && hit1 && tNear1 < tNear0 )
+      {
+        stack[top].NodeId = node.Child;
+        stack[top++].TNear = tNear0;
+        stack[top].NodeId = node.Child + 1;
+        stack[top++].TNear = tNear1;
+      }
+      else
+      {
+        if ( hit1 )
+        {
+          stack[top].NodeId = node.Child + 1;
+          stack[top++].TNear = tNear1;
+        }
+        if ( hit0 )
+        {
+          stack[top].NodeId = node.Child;
+          stack[top++].TNear = tNear0;
+        }
+      }
+      continue;
+    }
+
+    for (vtkIdType i=0; i < node.NumCells; ++i)
+    {
+      vtkIdType cellId = this->CellIds[node.Child + i];
+      if ( segment.Intersect(this->GetCellBounds(cellId), tMax, tNear) )
+      {
+        this->DataSet->GetCell(cellId, cell);
+        lastCellId = cellId;
+        if ( cell->IntersectWithLine(p1, p2, tol, tCell, xCell, pcoordsCell,
+                                     subIdCell) && tCell < tBest )
+        {
+          tBest = tCell;
+          bestCellId = cellId;
+          t = tCell;
+          x[0] = xCell[0];
+          x[1] = xCell[1];
+          x[2] = xCell[2];
+          pcoords[0] = pcoordsCell[0];
+          pcoords[1] = pcoordsCell[1];
+          pcoords[2] = pcoordsCell[2];
+          subId = subIdCell;
+          tMax = std::min(1.0, tBest);
+        }
+      }
+    }
+  }
+
+  // Leave the intersected cell in the generic cell
+  if ( bestCellId >= 0 && bestCellId != lastCellId )
+  {
+    this->DataSet->GetCell(bestCellId, cell);
+  }
+  return bestCellId;
+}
+
+namespace {
+
+// Threaded batched queries. Each thread has its own generic cell and
+// interpolation weights.
+struct FindCellsFunctor
+{
+  const vtkBVHCellTree *Tree;
+  vtkDataArray *Points;
+  vtkIdType *CellIds;
+  double *PCoords;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocal<std::vector<double>> Weights;
+
+  FindCellsFunctor(const vtkBVHCellTree *tree, vtkDataArray *points,
+                   vtkIdType *cellIds, double *pcoords) :
+    Tree(tree), Points(points), CellIds(cellIds), PCoords(pcoords)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    std::vector<double> &weights = this->Weights.Local();
+    weights.resize(std::max(this->Tree->MaxCellSize, 1));
+    double x[3], pcoords[3];
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      this->Points->GetTuple(ptId, x);
+      this->CellIds[ptId] =
+        this->Tree->FindCell(x, cell, pcoords, weights.data());
+      if ( this->PCoords )
+      {
+        std::copy(pcoords, pcoords+3, this->PCoords + 3*ptId);
+      }
+    }
+  }
+};
+
+struct IntersectWithLinesFunctor
+{
+  const vtkBVHCellTree *Tree;
+  vtkDataArray *P1;
+  vtkDataArray *P2;
+  double Tol;
+  vtkIdType *CellIds;
+  double *T;
+  double *X;
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+  IntersectWithLinesFunctor(const vtkBVHCellTree *tree, vtkDataArray *p1,
+                            vtkDataArray *p2, double tol, vtkIdType *cellIds,
+                            double *t, double *x) :
+    Tree(tree), P1(p1), P2(p2), Tol(tol), CellIds(cellIds), T(t), X(x)
+  {
+  }
+
+  void operator()(vtkIdType lineId, vtkIdType endLineId)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    double p1[3], p2[3], t, x[3], pcoords[3];
+    int subId;
+    for ( ; lineId < endLineId; ++lineId )
+    {
+      this->P1->GetTuple(lineId, p1);
+      this->P2->GetTuple(lineId, p2);
+      this->CellIds[lineId] = this->Tree->IntersectWithLine(
+        p1, p2, this->Tol, t, x, pcoords, subId, cell);
+      if ( this->T )
+      {
+        this->T[lineId] = t;
+      }
+      if ( this->X )
+      {
+        std::copy(x, x+3, this->X + 3*lineId);
+      }
+    }
+  }
+};
+
+} //anonymous namespace
+
+//-----------------------------------------------------------------------------
+// Here is the VTK class proper.
+
+//-----------------------------------------------------------------------------
+vtkBVHCellLocator::vtkBVHCellLocator()
+{
+  this->CacheCellBounds = 1; //always cached
+  this->NumberOfCellsPerNode = 8;
+  this->Tree = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+vtkBVHCellLocator::~vtkBVHCellLocator()
+{
+  this->FreeSearchStructure();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::FreeSearchStructure()
+{
+  delete this->Tree;
+  this->Tree = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkBVHCellLocator::
+FindCell(double pos[3], double, vtkGenericCell *cell,
+         double pcoords[3], double* weights )
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return -1;
+  }
+  return this->Tree->FindCell(pos,cell,pcoords,weights);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+FindCellsWithinBounds(double *bbox, vtkIdList *cells)
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    cells->Reset();
+    return;
+  }
+  this->Tree->FindCellsWithinBounds(bbox, cells);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+FindCellsAlongLine(double p1[3], double p2[3], double tol, vtkIdList *cells)
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    cells->Reset();
+    return;
+  }
+  this->Tree->FindCellsAlongLine(p1, p2, tol, cells);
+}
+
+//-----------------------------------------------------------------------------
+int vtkBVHCellLocator::
+IntersectWithLine(double p1[3], double p2[3], double tol,
+                  double &t, double x[3], double pcoords[3],
+                  int &subId, vtkIdType &cellId, vtkGenericCell *cell)
+{
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return 0;
+  }
+  vtkIdType id = this->Tree->
+    IntersectWithLine(p1,p2,tol,t,x,pcoords,subId,cell);
+  if ( id < 0 )
+  {
+    return 0;
+  }
+  cellId = id;
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+FindCells(vtkDataArray *points, vtkIdTypeArray *cellIds,
+          vtkDoubleArray *pcoords)
+{
+  if ( !points || points->GetNumberOfComponents() != 3 || !cellIds )
+  {
+    vtkErrorMacro("FindCells needs three component points and an output "
+                  "cell ids array");
+    return;
+  }
+
+  vtkIdType numPts = points->GetNumberOfTuples();
+  cellIds->SetNumberOfTuples(numPts);
+  if ( pcoords )
+  {
+    pcoords->SetNumberOfComponents(3);
+    pcoords->SetNumberOfTuples(numPts);
+  }
+
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    cellIds->Fill(-1);
+    return;
+  }
+
+  FindCellsFunctor find(this->Tree, points, cellIds->GetPointer(0),
+                        ( pcoords ? pcoords->GetPointer(0) : nullptr ));
+  vtkSMPTools::For(0, numPts, find);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+IntersectWithLines(vtkDataArray *p1, vtkDataArray *p2, double tol,
+                   vtkIdTypeArray *cellIds, vtkDoubleArray *t,
+                   vtkDoubleArray *x)
+{
+  if ( !p1 || !p2 || p1->GetNumberOfComponents() != 3 ||
+       p2->GetNumberOfComponents() != 3 ||
+       p1->GetNumberOfTuples() != p2->GetNumberOfTuples() || !cellIds )
+  {
+    vtkErrorMacro("IntersectWithLines needs two three component arrays of "
+                  "end points of the same length and an output cell ids "
+                  "array");
+    return;
+  }
+
+  vtkIdType numLines = p1->GetNumberOfTuples();
+  cellIds->SetNumberOfTuples(numLines);
+  if ( t )
+  {
+    t->SetNumberOfTuples(numLines);
+  }
+  if ( x )
+  {
+    x->SetNumberOfComponents(3);
+    x->SetNumberOfTuples(numLines);
+  }
+
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    cellIds->Fill(-1);
+    return;
+  }
+
+  IntersectWithLinesFunctor intersect(this->Tree, p1, p2, tol,
+                                      cellIds->GetPointer(0),
+                                      ( t ? t->GetPointer(0) : nullptr ),
+                                      ( x ? x->GetPointer(0) : nullptr ));
+  vtkSMPTools::For(0, numLines, intersect);
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::
+BuildLocator()
+{
+  vtkDebugMacro( << "Building BVH cell locator" );
+
+  // Do we need to build?
+  if ( (this->Tree != nullptr) && (this->BuildTime > this->MTime)
+       && (this->BuildTime > this->DataSet->GetMTime()) )
+  {
+    return;
+  }
+
+  if ( !this->DataSet || this->DataSet->GetNumberOfCells() < 1 )
+  {
+    vtkErrorMacro( << "No cells to build");
+    return;
+  }
+
+  // Clear out old stuff and build the hierarchy
+  this->FreeSearchStructure();
+  this->Tree = new vtkBVHCellTree(this->DataSet, this->NumberOfCellsPerNode);
+  this->Tree->Build();
+
+  this->BuildTime.Modified();
+}
+
+//-----------------------------------------------------------------------------
+// Produce a polygonal representation of the locator: the boxes of the nodes
+// at the given depth, and of the leaves above it.
+void vtkBVHCellLocator::
+GenerateRepresentation(int level, vtkPolyData *pd)
+{
+  // Make sure locator has been built successfully
+  this->BuildLocator();
+  if ( ! this->Tree )
+  {
+    return;
+  }
+
+  vtkPoints *pts = vtkPoints::New();
+  pts->SetDataTypeToFloat();
+  vtkCellArray *polys = vtkCellArray::New();
+  pd->SetPoints(pts);
+  pd->SetPolys(polys);
+
+  static const vtkIdType faces[6][4] = { {0,2,6,4}, {1,5,7,3}, {0,4,5,1},
+                                         {2,3,7,6}, {0,1,3,2}, {4,6,7,5} };
+  std::vector<std::pair<vtkIdType,int>> stack(1, std::make_pair(0, 0));
+  while ( ! stack.empty() )
+  {
+    vtkIdType nodeId = stack.back().first;
+    int depth = stack.back().second;
+    stack.pop_back();
+    const BVHNode &node = this->Tree->Nodes[nodeId];
+    if ( node.NumCells == 0 && depth < level )
+    {
+      stack.push_back(std::make_pair(node.Child + 1, depth + 1));
+      stack.push_back(std::make_pair(node.Child, depth + 1));
+      continue;
+    }
+
+    // Eight corners in (i-j-k) order, and the six faces of the box
+    const double *b = node.Bounds;
+    vtkIdType ids[8], quad[4];
+    for (int i=0; i < 8; ++i)
+    {
+      ids[i] = pts->InsertNextPoint(b[i & 1], b[2 + ((i >> 1) & 1)],
+                                    b[4 + ((i >> 2) & 1)]);
+    }
+    for (int i=0; i < 6; ++i)
+    {
+      for (int j=0; j < 4; ++j)
+      {
+        quad[j] = ids[faces[i][j]];
+      }
+      polys->InsertNextCell(4, quad);
+    }
+  }
+
+  // Clean up
+  polys->Delete();
+  pts->Delete();
+}
+
+//-----------------------------------------------------------------------------
+void vtkBVHCellLocator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  // Cell bounds are always cached
+  this->CacheCellBounds = 1;
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Number Of Nodes: "
+     << ( this->Tree ? this->Tree->Nodes.size() : 0 ) << "\n";
+}
@@ -0,0 +1,183 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkBVHCellLocator.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkBVHCellLocator
+ * @brief   cell locator based on a bounding volume hierarchy
+ *
+ * vtkBVHCellLocator is a type of vtkAbstractCellLocator that organizes the
+ * cells of a dataset into a binary bounding volume hierarchy (BVH). Each node
+ * of the hierarchy carries the bounds of the cells beneath it, and nodes are
+ * split using the surface area heuristic (SAH) evaluated over a fixed number
+ * of bins. Unlike the uniform binning of vtkStaticCellLocator, the hierarchy
+ * adapts to the distribution of the cells, so it performs well on meshes
+ * whose cell sizes vary greatly.
+ *
+ * The locator is built in parallel (via vtkSMPTools): the cell bounds are
+ * computed in parallel, the top levels of the hierarchy are split with
+ * threaded binning, and the subtrees below them are built concurrently. The
+ * locator supports one-time static construction (i.e., incremental cell
+ * insertion is not supported). The NumberOfCellsPerNode data member is the
+ * maximum number of cells in a leaf of the hierarchy.
+ *
+ * Besides the usual one-at-a-time queries, FindCells() and
+ * IntersectWithLines() answer whole arrays of point location and line
+ * intersection queries in parallel.
+ *
+ * @warning
+ * This class *always* caches cell bounds.
+ *
+ * @warning
+ * The query methods are thread safe once the locator has been built, i.e.,
+ * once BuildLocator() has been called from a single thread.
+ *
+ * @sa
+ * vtkLocator vtkAbstractCellLocator vtkStaticCellLocator vtkCellLocator
+ * vtkCellTreeLocator vtkModifiedBSPTree
+ */
+
+#ifndef vtkBVHCellLocator_h
+#define vtkBVHCellLocator_h
+
+#include "vtkCommonDataModelModule.h" // For export macro
+#include "vtkAbstractCellLocator.h"
+
+class vtkDataArray;
+class vtkDoubleArray;
+class vtkIdTypeArray;
+
+// Forward declaration for PIMPL
+struct vtkBVHCellTree;
+
+class VTKCOMMONDATAMODEL_EXPORT vtkBVHCellLocator : public vtkAbstractCellLocator
+{
+public:
+  //@{
+  /**
+   * Standard methods to instantiate, print and obtain type-related information.
+   */
+  static vtkBVHCellLocator *New();
+  vtkTypeMacro(vtkBVHCellLocator,vtkAbstractCellLocator);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  //@}
+
+  /**
+   * Test a point to find if it is inside a cell. Returns the cellId if inside
+   * or -1 if not.
+   */
+  vtkIdType FindCell(double pos[3], double vtkNotUsed, vtkGenericCell *cell,
+                     double pcoords[3], double* weights ) override;
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  vtkIdType FindCell(double x[3]) override
+    { return this->Superclass::FindCell(x); }
+
+  /**
+   * Return a list of unique cell ids whose bounds intersect the given
+   * bounding box. The user must provide the vtkIdList to populate.
+   */
+  void FindCellsWithinBounds(double *bbox, vtkIdList *cells) override;
+
+  /**
+   * Given a finite line defined by the two points (p1,p2), return the list
+   * of unique cell ids whose bounds are intersected by the line. The user
+   * must provide the vtkIdList cell list to populate.
+   */
+  void FindCellsAlongLine(double p1[3], double p2[3],
+                          double tolerance, vtkIdList *cells) override;
+
+  /**
+   * Return intersection point (if any) AND the cell which was intersected by
+   * the finite line. The intersection closest to p1 is returned. The cell is
+   * returned as a cell id and as a generic cell.
+   */
+  int IntersectWithLine(double p1[3], double p2[3], double tol,
+                        double& t, double x[3], double pcoords[3],
+                        int &subId, vtkIdType &cellId,
+                        vtkGenericCell *cell) override;
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  int IntersectWithLine(double p1[3], double p2[3], double tol,
+                        double& t, double x[3], double pcoords[3], int &subId) override
+  {
+    return this->Superclass::IntersectWithLine(p1, p2, tol, t, x, pcoords, subId);
+  }
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  int IntersectWithLine(double p1[3], double p2[3], double tol,
+                        double &t, double x[3], double pcoords[3],
+                        int &subId, vtkIdType &cellId) override
+  {
+    return this->Superclass::IntersectWithLine(p1, p2, tol, t, x, pcoords, subId, cellId);
+  }
+
+  /**
+   * Reimplemented from vtkAbstractCellLocator to support bad compilers.
+   */
+  int IntersectWithLine(const double p1[3], const double p2[3],
+                        vtkPoints *points, vtkIdList *cellIds) override
+  {
+    return this->Superclass::IntersectWithLine(p1, p2, points, cellIds);
+  }
+
+  /**
+   * Locate the cells containing each of the points of the three component
+   * array points, in parallel. On return cellIds holds, for each point, the
+   * id of a cell containing it or -1. If pcoords is given, it receives the
+   * parametric coordinates of each point in its cell (three components).
+   */
+  void FindCells(vtkDataArray *points, vtkIdTypeArray *cellIds,
+                 vtkDoubleArray *pcoords=nullptr);
+
+  /**
+   * Intersect the finite lines (p1[i],p2[i]) defined by the tuples of the
+   * three component arrays p1 and p2 with the cells, in parallel. On return
+   * cellIds holds, for each line, the id of the cell intersected closest to
+   * p1[i] or -1. If given, t and x receive the parametric coordinate along
+   * the line and the position (three components) of each intersection; they
+   * are undefined for lines that intersect no cell.
+   */
+  void IntersectWithLines(vtkDataArray *p1, vtkDataArray *p2, double tol,
+                          vtkIdTypeArray *cellIds, vtkDoubleArray *t=nullptr,
+                          vtkDoubleArray *x=nullptr);
+
+  //@{
+  /**
+   * Satisfy vtkLocator abstract interface. GenerateRepresentation() produces
+   * the boxes of the nodes at the given depth of the hierarchy, along with
+   * the boxes of the leaves above it.
+   */
+  void GenerateRepresentation(int level, vtkPolyData *pd) override;
+  void FreeSearchStructure() override;
+  void BuildLocator() override;
+  //@}
+
+protected:
+  vtkBVHCellLocator();
+  ~vtkBVHCellLocator() override;
+
+  vtkBVHCellTree *Tree; // The hierarchy, see vtkBVHCellLocator.cxx
+
+private:
+  vtkBVHCellLocator(const vtkBVHCellLocator&) = delete;
+  void operator=(const vtkBVHCellLocator&) = delete;
+};
+
+#endif
@@ -13,10 +13,14 @@
 
 =========================================================================*/
 #include "vtkBox.h"
+#include "vtkArrayDispatch.h"
+#include "vtkAssume.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkBoundingBox.h"
 #include "vtkPlane.h"
+#include "vtkSMPTools.h"
 
 #include <cassert>
 #include <vector> // for IntersectWithPlane
@@ -131,18 +135,18 @@ void vtkBox::AddBounds(const double bounds[6])
 
 
 //----------------------------------------------------------------------------
+namespace {
 // Evaluate box equation. This differs from the similar vtkPlanes
 // (with six planes) because of the "rounded" nature of the corners.
-double vtkBox::EvaluateFunction(double x[3])
+inline double EvaluateBox(const double minP[3], const double maxP[3],
+                          const double length[3], const double x[3])
 {
   double diff, dist, minDistance=(-VTK_DOUBLE_MAX), t, distance=0.0;
   int inside=1;
-  const double *minP = this->BBox->GetMinPoint();
-  const double *maxP = this->BBox->GetMaxPoint();
 
   for (int i=0; i<3; i++)
   {
-    diff = this->BBox->GetLength(i);
+    diff = length[i];
     if ( diff != 0.0 )
     {
       t = (x[i]-minP[i]) / diff;
@@ -197,6 +201,84 @@ double vtkBox::EvaluateFunction(double x[3])
   }
 }
 
+// Evaluate the box equation at the points of an array in parallel.
+template <typename InputArrayType, typename OutputArrayType>
+struct BoxFunctor
+{
+  typedef typename vtkDataArrayAccessor<OutputArrayType>::APIType
+    OutputValueType;
+  vtkDataArrayAccessor<InputArrayType> Input;
+  vtkDataArrayAccessor<OutputArrayType> Output;
+  const double *MinPoint;
+  const double *MaxPoint;
+  const double *Length;
+
+  BoxFunctor(InputArrayType *input, OutputArrayType *output,
+             const double *minP, const double *maxP, const double *length)
+    : Input(input), Output(output), MinPoint(minP), MaxPoint(maxP),
+      Length(length)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      x[0] = static_cast<double>(this->Input.Get(ptId, 0));
+      x[1] = static_cast<double>(this->Input.Get(ptId, 1));
+      x[2] = static_cast<double>(this->Input.Get(ptId, 2));
+      this->Output.Set(ptId, 0, static_cast<OutputValueType>(EvaluateBox(
+        this->MinPoint, this->MaxPoint, this->Length, x)));
+    }
+  }
+};
+
+struct BoxWorker
+{
+  const double *MinPoint;
+  const double *MaxPoint;
+  const double *Length;
+
+  template <typename InputArrayType, typename OutputArrayType>
+  void operator()(InputArrayType *input, OutputArrayType *output)
+  {
+    VTK_ASSUME(input->GetNumberOfComponents() == 3);
+    VTK_ASSUME(output->GetNumberOfComponents() == 1);
+    BoxFunctor<InputArrayType, OutputArrayType> functor(
+      input, output, this->MinPoint, this->MaxPoint, this->Length);
+    vtkSMPTools::For(0, input->GetNumberOfTuples(), functor);
+  }
+};
+} // end anon namespace
+
+double vtkBox::EvaluateFunction(double x[3])
+{
+  double length[3];
+  this->BBox->GetLengths(length);
+  return EvaluateBox(this->BBox->GetMinPoint(), this->BBox->GetMaxPoint(),
+                     length, x);
+}
+
+void vtkBox::EvaluateFunction(vtkDataArray* input, vtkDataArray* output)
+{
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+
+  double length[3];
+  this->BBox->GetLengths(length);
+  BoxWorker worker = { this->BBox->GetMinPoint(), this->BBox->GetMaxPoint(),
+                       length };
+  typedef vtkTypeList_Create_2(float, double) InputTypes;
+  typedef vtkTypeList_Create_2(float, double) OutputTypes;
+  typedef vtkArrayDispatch::Dispatch2ByValueType<InputTypes, OutputTypes>
+    MyDispatch;
+  if (!MyDispatch::Execute(input, output, worker))
+  {
+    worker(input, output); // Use vtkDataArray API if dispatch fails.
+  }
+}
+
 //----------------------------------------------------------------------------
 // Evaluate box gradient.
 void vtkBox::EvaluateGradient(double x[3], double n[3])
@@ -50,6 +50,7 @@ public:
    * Evaluate box defined by the two points (pMin,pMax).
    */
   using vtkImplicitFunction::EvaluateFunction;
+  void EvaluateFunction(vtkDataArray* input, vtkDataArray* output) override;
   double EvaluateFunction(double x[3]) override;
 
   /**
@@ -14,9 +14,177 @@
 =========================================================================*/
 #include "vtkCellArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkTypeInt32Array.h"
+#include "vtkTypeInt64Array.h"
+
+#include <type_traits>
 
 vtkStandardNewMacro(vtkCellArray);
 
+//----------------------------------------------------------------------------
+class vtkCellArray::vtkInternals
+{
+public:
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+};
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Helpers operating on the typed offsets/connectivity arrays.
+template <typename T>
+inline vtkAOSDataArrayTemplate<T>* AsTyped(vtkDataArray *a)
+{
+  return static_cast<vtkAOSDataArrayTemplate<T>*>(a);
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+vtkAOSDataArrayTemplate<T>* NewStorageArray();
+
+template <>
+vtkAOSDataArrayTemplate<vtkTypeInt32>* NewStorageArray<vtkTypeInt32>()
+{
+  return vtkTypeInt32Array::New();
+}
+
+template <>
+vtkAOSDataArrayTemplate<vtkTypeInt64>* NewStorageArray<vtkTypeInt64>()
+{
+  return vtkTypeInt64Array::New();
+}
+
+//----------------------------------------------------------------------------
+// Split the interleaved (npts,id0,id1,...) layout into offsets and
+// connectivity arrays. Returns the number of cells found.
+template <typename T>
+vtkIdType LegacyToOffsets(vtkIdTypeArray *ia, vtkDataArray *offsetsArray,
+                          vtkDataArray *connArray)
+{
+  const vtkIdType size = ia->GetMaxId() + 1;
+  const vtkIdType *legacy = ia->GetPointer(0);
+
+  // First pass counts the cells so that the arrays can be sized exactly.
+  vtkIdType numCells = 0;
+  for (vtkIdType loc = 0; loc < size; loc += legacy[loc] + 1)
+  {
+    ++numCells;
+  }
+
+  vtkAOSDataArrayTemplate<T> *offsets = AsTyped<T>(offsetsArray);
+  vtkAOSDataArrayTemplate<T> *conn = AsTyped<T>(connArray);
+  offsets->SetNumberOfValues(numCells + 1);
+  conn->SetNumberOfValues(size - numCells);
+  T *o = offsets->GetPointer(0);
+  T *c = conn->GetPointer(0);
+
+  T offset = 0;
+  vtkIdType loc = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    const vtkIdType npts = legacy[loc++];
+    o[cellId] = offset;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      *c++ = static_cast<T>(legacy[loc++]);
+    }
+    offset += static_cast<T>(npts);
+  }
+  o[numCells] = offset;
+  return numCells;
+}
+
+//----------------------------------------------------------------------------
+// Merge offsets and connectivity back into the interleaved layout.
+template <typename T>
+void OffsetsToLegacy(vtkDataArray *offsetsArray, vtkDataArray *connArray,
+                     vtkIdTypeArray *ia)
+{
+  const vtkIdType numCells = offsetsArray->GetNumberOfTuples() - 1;
+  const T *o = AsTyped<T>(offsetsArray)->GetPointer(0);
+  const T *c = AsTyped<T>(connArray)->GetPointer(0);
+
+  ia->SetNumberOfValues(numCells + static_cast<vtkIdType>(o[numCells]));
+  vtkIdType *legacy = ia->GetPointer(0);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    const T *beg = c + o[cellId];
+    const T *end = c + o[cellId+1];
+    *legacy++ = static_cast<vtkIdType>(end - beg);
+    for (; beg != end; ++beg)
+    {
+      *legacy++ = static_cast<vtkIdType>(*beg);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Copy offsets storage of one integer width into another one.
+template <typename TIn, typename TOut>
+void CopyStorageArray(vtkDataArray *in, vtkDataArray *out)
+{
+  const vtkIdType num = in->GetNumberOfTuples();
+  const TIn *src = AsTyped<TIn>(in)->GetPointer(0);
+  vtkAOSDataArrayTemplate<TOut> *dst = AsTyped<TOut>(out);
+  dst->SetNumberOfValues(num);
+  std::transform(src, src + num, dst->GetPointer(0),
+                 [](TIn v) { return static_cast<TOut>(v); });
+}
+
+//----------------------------------------------------------------------------
+// The legacy location of a cell is its offset plus the number of cell sizes
+// stored before it. Return the id of the first cell located at or after loc.
+template <typename T>
+vtkIdType CellIdAtLocation(vtkDataArray *offsetsArray, vtkIdType loc)
+{
+  const T *o = AsTyped<T>(offsetsArray)->GetPointer(0);
+  vtkIdType first = 0;
+  vtkIdType last = offsetsArray->GetNumberOfTuples() - 1;
+  while (first < last)
+  {
+    const vtkIdType mid = first + (last - first) / 2;
+    if (static_cast<vtkIdType>(o[mid]) + mid < loc)
+    {
+      first = mid + 1;
+    }
+    else
+    {
+      last = mid;
+    }
+  }
+  return first;
+}
+
+//----------------------------------------------------------------------------
+// Offsets must start with 0, never decrease and end with the size of the
+// connectivity.
+template <typename T>
+bool ValidOffsets(vtkDataArray *offsetsArray, vtkIdType numIds)
+{
+  const vtkIdType num = offsetsArray->GetNumberOfTuples();
+  const T *o = AsTyped<T>(offsetsArray)->GetPointer(0);
+  return o[0] == 0 && static_cast<vtkIdType>(o[num-1]) == numIds &&
+    std::is_sorted(o, o + num);
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+int MaxCellSize(vtkDataArray *offsetsArray)
+{
+  const vtkIdType numCells = offsetsArray->GetNumberOfTuples() - 1;
+  const T *o = AsTyped<T>(offsetsArray)->GetPointer(0);
+  vtkIdType maxSize = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    maxSize = std::max(maxSize, static_cast<vtkIdType>(o[cellId+1] - o[cellId]));
+  }
+  return static_cast<int>(maxSize);
+}
+
+} // anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
@@ -24,6 +192,12 @@ vtkCellArray::vtkCellArray()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->StorageMode = LEGACY_STORAGE;
+  this->Offsets = nullptr;
+  this->Connectivity = nullptr;
+  this->TraversalCellId = 0;
+  this->LegacyDataIsValid = false;
+  this->Internals = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -35,25 +209,518 @@ void vtkCellArray::DeepCopy (vtkCellArray *ca)
     return;
   }
 
+  this->ReleaseOffsetsArrays();
   this->Ia->DeepCopy(ca->Ia);
+  if (ca->StorageMode != LEGACY_STORAGE)
+  {
+    this->Offsets = ca->Offsets->NewInstance();
+    this->Offsets->DeepCopy(ca->Offsets);
+    this->Connectivity = ca->Connectivity->NewInstance();
+    this->Connectivity->DeepCopy(ca->Connectivity);
+    this->StorageMode = ca->StorageMode;
+    this->LegacyDataIsValid = false;
+    if (!this->Internals)
+    {
+      this->Internals = new vtkInternals;
+    }
+  }
   this->NumberOfCells = ca->NumberOfCells;
   this->InsertLocation = ca->InsertLocation;
   this->TraversalLocation = ca->TraversalLocation;
+  this->TraversalCellId = ca->TraversalCellId;
 }
 
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
   this->Ia->Delete();
+  this->ReleaseOffsetsArrays();
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize()
 {
   this->Ia->Initialize();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->LegacyDataIsValid = false;
+    this->Offsets->Initialize();
+    this->Offsets->InsertTuple1(0, 0);
+    this->Connectivity->Initialize();
+  }
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    // The legacy size includes one count per cell; reserve all of it for
+    // the connectivity since the number of cells is unknown.
+    return this->Connectivity->Allocate(sz, ext);
+  }
+  return this->Ia->Allocate(sz,ext);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetSize()
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->Offsets->GetSize() + this->Connectivity->GetSize();
+  }
+  return this->Ia->GetSize();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetNumberOfConnectivityEntries()
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->NumberOfCells + this->Connectivity->GetNumberOfTuples();
+  }
+  return this->Ia->GetMaxId()+1;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetNumberOfConnectivityIds()
+{
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->Connectivity->GetNumberOfTuples();
+  }
+  return this->Ia->GetMaxId() + 1 - this->NumberOfCells;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  this->Ia->Squeeze();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->Offsets->Squeeze();
+    this->Connectivity->Squeeze();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReleaseOffsetsArrays()
+{
+  if (this->Offsets)
+  {
+    this->Offsets->Delete();
+    this->Offsets = nullptr;
+  }
+  if (this->Connectivity)
+  {
+    this->Connectivity->Delete();
+    this->Connectivity = nullptr;
+  }
+  this->StorageMode = LEGACY_STORAGE;
+  this->LegacyDataIsValid = false;
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+void vtkCellArray::ConvertToOffsets(int mode)
+{
+  vtkAOSDataArrayTemplate<T> *offsets = NewStorageArray<T>();
+  vtkAOSDataArrayTemplate<T> *conn = NewStorageArray<T>();
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    this->NumberOfCells = LegacyToOffsets<T>(this->Ia, offsets, conn);
+    this->Ia->Initialize();
+  }
+  else if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    CopyStorageArray<vtkTypeInt64, T>(this->Offsets, offsets);
+    CopyStorageArray<vtkTypeInt64, T>(this->Connectivity, conn);
+  }
+  else
+  {
+    CopyStorageArray<vtkTypeInt32, T>(this->Offsets, offsets);
+    CopyStorageArray<vtkTypeInt32, T>(this->Connectivity, conn);
+  }
+
+  this->ReleaseOffsetsArrays();
+  this->Offsets = offsets;
+  this->Connectivity = conn;
+  this->StorageMode = mode;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  if (!this->Internals)
+  {
+    this->Internals = new vtkInternals;
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::CanConvertTo32BitStorage()
+{
+  const vtkIdType maxValue = VTK_TYPE_INT32_MAX;
+  switch (this->StorageMode)
+  {
+    case OFFSETS_32BIT_STORAGE:
+      return true;
+    case OFFSETS_64BIT_STORAGE:
+    {
+      // The last offset is the largest one.
+      const vtkIdType numIds = this->Connectivity->GetNumberOfTuples();
+      const vtkTypeInt64 *c = AsTyped<vtkTypeInt64>(this->Connectivity)->GetPointer(0);
+      return numIds <= maxValue &&
+        std::all_of(c, c + numIds, [=](vtkTypeInt64 id) { return id <= maxValue; });
+    }
+    default:
+    {
+      const vtkIdType size = this->Ia->GetMaxId() + 1;
+      const vtkIdType *legacy = this->Ia->GetPointer(0);
+      return size <= maxValue &&
+        std::all_of(legacy, legacy + size, [=](vtkIdType id) { return id <= maxValue; });
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::ConvertTo32BitStorage()
+{
+  if (this->StorageMode == OFFSETS_32BIT_STORAGE)
+  {
+    return true;
+  }
+  if (!this->CanConvertTo32BitStorage())
+  {
+    return false;
+  }
+  this->ConvertToOffsets<vtkTypeInt32>(OFFSETS_32BIT_STORAGE);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::ConvertTo64BitStorage()
+{
+  if (this->StorageMode != OFFSETS_64BIT_STORAGE)
+  {
+    this->ConvertToOffsets<vtkTypeInt64>(OFFSETS_64BIT_STORAGE);
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::ConvertToDefaultStorage()
+{
+#ifdef VTK_USE_64BIT_IDS
+  return this->ConvertTo64BitStorage();
+#else
+  return this->ConvertTo32BitStorage();
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertOffsetsToLegacyStorage()
+{
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    OffsetsToLegacy<vtkTypeInt64>(this->Offsets, this->Connectivity, this->Ia);
+  }
+  else
+  {
+    OffsetsToLegacy<vtkTypeInt32>(this->Offsets, this->Connectivity, this->Ia);
+  }
+  this->ReleaseOffsetsArrays();
+  this->InsertLocation = this->Ia->GetMaxId() + 1;
+  this->TraversalLocation = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::UpdateLegacyData()
+{
+  if (this->LegacyDataIsValid &&
+      this->LegacyDataTime.GetMTime() > this->Offsets->GetMTime() &&
+      this->LegacyDataTime.GetMTime() > this->Connectivity->GetMTime())
+  {
+    return;
+  }
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    OffsetsToLegacy<vtkTypeInt64>(this->Offsets, this->Connectivity, this->Ia);
+  }
+  else
+  {
+    OffsetsToLegacy<vtkTypeInt32>(this->Offsets, this->Connectivity, this->Ia);
+  }
+  this->LegacyDataIsValid = true;
+  this->LegacyDataTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellIdAtLocation(vtkIdType loc)
+{
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    return CellIdAtLocation<vtkTypeInt64>(this->Offsets, loc);
+  }
+  return CellIdAtLocation<vtkTypeInt32>(this->Offsets, loc);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellFromOffsets(vtkIdType cellId, vtkIdType &npts,
+                                      vtkIdType* &pts)
+{
+  // Point ids are only copied when the storage type is not vtkIdType.
+  const vtkIdType *cellPts;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    vtkIdList *ptIds = std::is_same<vtkTypeInt64, vtkIdType>::value ?
+      nullptr : this->Internals->PointIds.Local();
+    this->GetCellAtIdImpl<vtkTypeInt64>(cellId, npts, cellPts, ptIds);
+  }
+  else
+  {
+    vtkIdList *ptIds = std::is_same<vtkTypeInt32, vtkIdType>::value ?
+      nullptr : this->Internals->PointIds.Local();
+    this->GetCellAtIdImpl<vtkTypeInt32>(cellId, npts, cellPts, ptIds);
+  }
+  pts = const_cast<vtkIdType*>(cellPts);
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::GetNextCellFromOffsets(vtkIdType &npts, vtkIdType* &pts)
+{
+  if (this->TraversalCellId < this->NumberOfCells)
+  {
+    this->GetCellFromOffsets(this->TraversalCellId++, npts, pts);
+    this->TraversalLocation += npts + 1;
+    return 1;
+  }
+  npts = 0;
+  pts = nullptr;
+  return 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::SetData(vtkDataArray *offsets, vtkDataArray *connectivity)
+{
+  if (!offsets || !connectivity ||
+      offsets->GetNumberOfComponents() != 1 ||
+      connectivity->GetNumberOfComponents() != 1 ||
+      offsets->GetNumberOfTuples() < 1)
+  {
+    vtkErrorMacro("Offsets and connectivity must be single component arrays, "
+                  "and the offsets must hold at least one value.");
+    return false;
+  }
+
+  int mode;
+  bool valid;
+  const vtkIdType numIds = connectivity->GetNumberOfTuples();
+  if (vtkAOSDataArrayTemplate<vtkTypeInt32>::FastDownCast(offsets) &&
+      vtkAOSDataArrayTemplate<vtkTypeInt32>::FastDownCast(connectivity))
+  {
+    mode = OFFSETS_32BIT_STORAGE;
+    valid = ValidOffsets<vtkTypeInt32>(offsets, numIds);
+  }
+  else if (vtkAOSDataArrayTemplate<vtkTypeInt64>::FastDownCast(offsets) &&
+           vtkAOSDataArrayTemplate<vtkTypeInt64>::FastDownCast(connectivity))
+  {
+    mode = OFFSETS_64BIT_STORAGE;
+    valid = ValidOffsets<vtkTypeInt64>(offsets, numIds);
+  }
+  else
+  {
+    vtkErrorMacro("Offsets and connectivity must both be 32-bit or both be "
+                  "64-bit integer arrays with contiguous storage.");
+    return false;
+  }
+  if (!valid)
+  {
+    vtkErrorMacro("Offsets must start with 0, never decrease and end with "
+                  "the size of the connectivity array.");
+    return false;
+  }
+
+  // Register first in case the arrays are already held by this object.
+  offsets->Register(this);
+  connectivity->Register(this);
+  this->ReleaseOffsetsArrays();
+  this->Ia->Initialize();
+
+  this->Offsets = offsets;
+  this->Connectivity = connectivity;
+  this->StorageMode = mode;
+  this->NumberOfCells = offsets->GetNumberOfTuples() - 1;
+  this->InsertLocation = 0;
+  this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
+  if (!this->Internals)
+  {
+    this->Internals = new vtkInternals;
+  }
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellAsOffsets(vtkIdType npts,
+                                                const vtkIdType* pts)
+{
+  const vtkIdType numIds = this->Connectivity->GetNumberOfTuples();
+  this->LegacyDataIsValid = false;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    vtkTypeInt64 *c = AsTyped<vtkTypeInt64>(this->Connectivity)->WritePointer(numIds, npts);
+    std::copy(pts, pts + npts, c);
+    AsTyped<vtkTypeInt64>(this->Offsets)->InsertNextValue(numIds + npts);
+  }
+  else
+  {
+    vtkTypeInt32 *c = AsTyped<vtkTypeInt32>(this->Connectivity)->WritePointer(numIds, npts);
+    std::transform(pts, pts + npts, c,
+                   [](vtkIdType id) { return static_cast<vtkTypeInt32>(id); });
+    AsTyped<vtkTypeInt32>(this->Offsets)->InsertNextValue(
+      static_cast<vtkTypeInt32>(numIds + npts));
+  }
+  return this->NumberOfCells++;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellAsOffsets(int npts)
+{
+  // The offset is provisional until the points have been inserted, see
+  // UpdateCellCountAsOffsets().
+  this->LegacyDataIsValid = false;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    vtkAOSDataArrayTemplate<vtkTypeInt64> *offsets = AsTyped<vtkTypeInt64>(this->Offsets);
+    offsets->InsertNextValue(offsets->GetValue(offsets->GetMaxId()) + npts);
+  }
+  else
+  {
+    vtkAOSDataArrayTemplate<vtkTypeInt32> *offsets = AsTyped<vtkTypeInt32>(this->Offsets);
+    offsets->InsertNextValue(offsets->GetValue(offsets->GetMaxId()) + npts);
+  }
+  return this->NumberOfCells++;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::InsertCellPointAsOffsets(vtkIdType id)
+{
+  this->LegacyDataIsValid = false;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    AsTyped<vtkTypeInt64>(this->Connectivity)->InsertNextValue(
+      static_cast<vtkTypeInt64>(id));
+  }
+  else
+  {
+    AsTyped<vtkTypeInt32>(this->Connectivity)->InsertNextValue(
+      static_cast<vtkTypeInt32>(id));
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::UpdateCellCountAsOffsets(int npts)
+{
+  this->LegacyDataIsValid = false;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    vtkAOSDataArrayTemplate<vtkTypeInt64> *offsets = AsTyped<vtkTypeInt64>(this->Offsets);
+    const vtkIdType last = offsets->GetMaxId();
+    offsets->SetValue(last, offsets->GetValue(last - 1) + npts);
+  }
+  else
+  {
+    vtkAOSDataArrayTemplate<vtkTypeInt32> *offsets = AsTyped<vtkTypeInt32>(this->Offsets);
+    const vtkIdType last = offsets->GetMaxId();
+    offsets->SetValue(last, offsets->GetValue(last - 1) + npts);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
+{
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    vtkErrorMacro("GetCellSize() requires offsets storage.");
+    return 0;
+  }
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    const vtkTypeInt64 *o = AsTyped<vtkTypeInt64>(this->Offsets)->GetPointer(cellId);
+    return static_cast<vtkIdType>(o[1] - o[0]);
+  }
+  const vtkTypeInt32 *o = AsTyped<vtkTypeInt32>(this->Offsets)->GetPointer(cellId);
+  return static_cast<vtkIdType>(o[1] - o[0]);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
+{
+  vtkIdType npts;
+  const vtkIdType *ppts;
+  this->GetCellAtId(cellId, npts, ppts, pts);
+  if (!ppts)
+  {
+    pts->Reset();
+  }
+  else if (ppts != pts->GetPointer(0))
+  {
+    pts->SetNumberOfIds(npts);
+    std::copy(ppts, ppts + npts, pts->GetPointer(0));
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReverseCellAtId(vtkIdType cellId)
+{
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    vtkErrorMacro("ReverseCellAtId() requires offsets storage.");
+    return;
+  }
+  this->LegacyDataIsValid = false;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    const vtkTypeInt64 *o = AsTyped<vtkTypeInt64>(this->Offsets)->GetPointer(cellId);
+    vtkTypeInt64 *c = AsTyped<vtkTypeInt64>(this->Connectivity)->GetPointer(0);
+    std::reverse(c + o[0], c + o[1]);
+  }
+  else
+  {
+    const vtkTypeInt32 *o = AsTyped<vtkTypeInt32>(this->Offsets)->GetPointer(cellId);
+    vtkTypeInt32 *c = AsTyped<vtkTypeInt32>(this->Connectivity)->GetPointer(0);
+    std::reverse(c + o[0], c + o[1]);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceCellAtId(vtkIdType cellId, vtkIdType npts,
+                                   const vtkIdType *pts)
+{
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    vtkErrorMacro("ReplaceCellAtId() requires offsets storage.");
+    return;
+  }
+  this->LegacyDataIsValid = false;
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    const vtkTypeInt64 *o = AsTyped<vtkTypeInt64>(this->Offsets)->GetPointer(cellId);
+    vtkTypeInt64 *c = AsTyped<vtkTypeInt64>(this->Connectivity)->GetPointer(o[0]);
+    std::copy(pts, pts + npts, c);
+  }
+  else
+  {
+    const vtkTypeInt32 *o = AsTyped<vtkTypeInt32>(this->Offsets)->GetPointer(cellId);
+    vtkTypeInt32 *c = AsTyped<vtkTypeInt32>(this->Connectivity)->GetPointer(o[0]);
+    std::transform(pts, pts + npts, c,
+                   [](vtkIdType id) { return static_cast<vtkTypeInt32>(id); });
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -61,6 +728,15 @@ void vtkCellArray::Initialize()
 // defining the cell.
 int vtkCellArray::GetMaxCellSize()
 {
+  if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    return MaxCellSize<vtkTypeInt64>(this->Offsets);
+  }
+  else if (this->StorageMode == OFFSETS_32BIT_STORAGE)
+  {
+    return MaxCellSize<vtkTypeInt32>(this->Offsets);
+  }
+
   int npts=0, maxSize=0;
   vtkIdType i;
 
@@ -81,6 +757,7 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
   if ( cells && cells != this->Ia )
   {
     this->Modified();
+    this->ReleaseOffsetsArrays();
     this->Ia->Delete();
     this->Ia = cells;
     this->Ia->Register(this);
@@ -94,7 +771,13 @@ void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Ia->GetActualMemorySize();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    size += this->Offsets->GetActualMemorySize() +
+      this->Connectivity->GetActualMemorySize();
+  }
+  return size;
 }
 
 //----------------------------------------------------------------------------
@@ -116,6 +799,11 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 //----------------------------------------------------------------------------
 void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->GetCellAtId(this->GetCellIdAtLocation(loc), pts);
+    return;
+  }
   vtkIdType npts = this->Ia->GetValue(loc++);
   vtkIdType *ppts = this->Ia->GetPointer(loc);
   pts->SetNumberOfIds(npts);
@@ -133,4 +821,8 @@ void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
   os << indent << "Insert Location: " << this->InsertLocation << endl;
   os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Storage Mode: "
+     << (this->StorageMode == OFFSETS_64BIT_STORAGE ? "64-bit offsets" :
+         this->StorageMode == OFFSETS_32BIT_STORAGE ? "32-bit offsets" :
+         "legacy") << endl;
 }
@@ -28,6 +28,26 @@
  * using the vtkCellTypes and vtkCellLinks objects to extend the definition of
  * the data structure.
  *
+ * Alternatively, the cells may be stored as two separate arrays: an offsets
+ * array of size (numberOfCells+1) whose entry i is the location of the first
+ * point id of cell i, and a connectivity array holding the point ids of all
+ * cells back to back (the last offset is the size of the connectivity
+ * array). This offsets storage supports random access by cell id
+ * (GetCellAtId()) and may use either 32-bit or 64-bit integers, which saves
+ * memory for large meshes. Arrays provided by an application may be adopted
+ * without copying through SetData().
+ *
+ * A vtkCellArray holds exactly one of the two representations at a time,
+ * and only changes it when asked to: by the ConvertTo...Storage() methods,
+ * SetData(), SetCells() or WritePointer(). The traversal (GetNextCell()) and
+ * the location based methods (GetCell(), ReverseCell(), ReplaceCell()) work
+ * with both representations; with offsets storage, a location is mapped to
+ * its cell id by a binary search. The cell id based methods (GetCellAtId(),
+ * GetCellSize(), Visit() and friends) require offsets storage. Reading the
+ * cells never modifies the cell array, except for GetPointer() and
+ * GetData(), which build a legacy copy of offsets storage: call them before
+ * accessing the cells from several threads.
+ *
  * @sa
  * vtkCellTypes vtkCellLinks
 */
@@ -39,8 +59,11 @@
 #include "vtkObject.h"
 
 #include "vtkIdTypeArray.h" // Needed for inline methods
+#include "vtkIdList.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
 
+#include <algorithm> // Needed for inline methods
+
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
 public:
@@ -55,8 +78,7 @@ public:
   /**
    * Allocate memory and set the size to extend by.
    */
-  int Allocate(vtkIdType sz, vtkIdType ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+  int Allocate(vtkIdType sz, vtkIdType ext=1000);
 
   /**
    * Free any memory and reset to an empty state.
@@ -93,13 +115,15 @@ public:
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  InitTraversal() initializes the traversal of the list of cells.
    */
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal() {this->TraversalLocation=0; this->TraversalCellId=0;};
 
   /**
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  GetNextCell() gets the next cell in the list. If end of list
    * is encountered, 0 is returned. A value of 1 is returned whenever
-   * npts and pts have been updated without error.
+   * npts and pts have been updated without error. When the offsets storage
+   * type differs from vtkIdType, pts points to a copy of the point ids owned
+   * by the calling thread, valid until its next call to this cell array.
    */
   int GetNextCell(vtkIdType& npts, vtkIdType* &pts)
     VTK_SIZEHINT(pts, npts);
@@ -114,20 +138,19 @@ public:
   /**
    * Get the size of the allocated connectivity array.
    */
-  vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+  vtkIdType GetSize();
 
   /**
    * Get the total number of entries (i.e., data values) in the connectivity
    * array. This may be much less than the allocated size (i.e., return value
    * from GetSize().)
    */
-  vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+  vtkIdType GetNumberOfConnectivityEntries();
 
   /**
    * Internal method used to retrieve a cell given an offset into
-   * the internal array.
+   * the internal array. As with GetNextCell(), pts may point to a per
+   * thread copy of the point ids with offsets storage.
    */
   void GetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts)
     VTK_EXPECTS(0 <= loc && loc < GetSize())
@@ -183,7 +206,13 @@ public:
    * Used in conjunction with GetCell(int loc,...).
    */
   vtkIdType GetInsertLocation(int npts)
-    {return (this->InsertLocation - npts - 1);};
+  {
+    if (this->StorageMode != LEGACY_STORAGE)
+    {
+      return (this->GetNumberOfConnectivityEntries() - npts - 1);
+    }
+    return (this->InsertLocation - npts - 1);
+  }
 
   /**
    * Get/Set the current traversal location.
@@ -191,7 +220,13 @@ public:
   vtkIdType GetTraversalLocation()
     {return this->TraversalLocation;}
   void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+  {
+    this->TraversalLocation = loc;
+    if (this->StorageMode != LEGACY_STORAGE)
+    {
+      this->TraversalCellId = this->GetCellIdAtLocation(loc);
+    }
+  }
 
   /**
    * Computes the current traversal location within the internal array. Used
@@ -224,15 +259,17 @@ public:
   int GetMaxCellSize();
 
   /**
-   * Get pointer to array of cell data.
+   * Get pointer to array of cell data. With offsets storage, this is a
+   * legacy copy of the cells (see GetData()).
    */
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+    {return this->GetData()->GetPointer(0);}
 
   /**
    * Get pointer to data array for purpose of direct writes of data. Size is the
    * total storage consumed by the cell array. ncells is the number of cells
-   * represented in the array.
+   * represented in the array. Any offsets storage is replaced by the legacy
+   * layout.
    */
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
@@ -253,10 +290,19 @@ public:
   void DeepCopy(vtkCellArray *ca);
 
   /**
-   * Return the underlying data as a data array.
+   * Return the underlying data as a data array. With offsets storage, the
+   * cells are copied into the legacy layout, which is rebuilt only after the
+   * cells have changed; the copy must not be modified, and building it is
+   * not thread safe.
    */
   vtkIdTypeArray* GetData()
-    {return this->Ia;}
+  {
+    if (this->StorageMode != LEGACY_STORAGE)
+    {
+      this->UpdateLegacyData();
+    }
+    return this->Ia;
+  }
 
   /**
    * Reuse list. Reset to initial condition.
@@ -266,8 +312,122 @@ public:
   /**
    * Reclaim any extra memory.
    */
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
+
+  /**
+   * Storage modes of the cell array. LEGACY_STORAGE is the interleaved
+   * (n,id1,id2,...) layout; the other modes store separate offsets and
+   * connectivity arrays of 32-bit or 64-bit integers.
+   */
+  enum StorageModes
+  {
+    LEGACY_STORAGE = 0,
+    OFFSETS_32BIT_STORAGE = 1,
+    OFFSETS_64BIT_STORAGE = 2
+  };
+
+  /**
+   * Return the current storage mode (one of the StorageModes enum values).
+   */
+  vtkGetMacro(StorageMode, int);
+
+  //@{
+  /**
+   * Convert the cells to the given storage mode, preserving their contents.
+   * ConvertTo32BitStorage() fails (and returns false) if a point id or an
+   * offset does not fit into a 32-bit integer; see
+   * CanConvertTo32BitStorage(). ConvertToDefaultStorage() selects the
+   * offsets storage matching the size of vtkIdType, for which GetCellAtId()
+   * never copies point ids.
+   */
+  bool ConvertTo32BitStorage();
+  bool ConvertTo64BitStorage();
+  bool ConvertToDefaultStorage();
+  void ConvertToLegacyStorage()
+  {
+    if (this->StorageMode != LEGACY_STORAGE)
+    {
+      this->ConvertOffsetsToLegacyStorage();
+    }
+  }
+  bool CanConvertTo32BitStorage();
+  //@}
+
+  /**
+   * Adopt the given offsets and connectivity arrays without copying them.
+   * Both arrays must be single component vtkAOSDataArrayTemplate arrays of
+   * the same 32-bit or 64-bit integer type (e.g. vtkTypeInt32Array,
+   * vtkTypeInt64Array or vtkIdTypeArray); the offsets array holds
+   * (numberOfCells+1) non decreasing values starting with 0 and ending with
+   * the size of the connectivity array. Use vtkDataArray::SetArray() on
+   * these arrays to wrap memory owned by a simulation code. Returns false
+   * and leaves the cell array unchanged if the arrays are not usable.
+   */
+  bool SetData(vtkDataArray *offsets, vtkDataArray *connectivity);
+
+  //@{
+  /**
+   * Return the offsets and connectivity arrays of the offsets storage, or
+   * nullptr if the cell array uses the legacy storage. The arrays may be
+   * safely downcast to vtkAOSDataArrayTemplate<vtkTypeInt32> or
+   * vtkAOSDataArrayTemplate<vtkTypeInt64> according to GetStorageMode().
+   */
+  vtkDataArray* GetOffsetsArray()
+    {return this->Offsets;}
+  vtkDataArray* GetConnectivityArray()
+    {return this->Connectivity;}
+  //@}
+
+  /**
+   * Return the number of point ids held by the connectivity array (that is,
+   * the total number of points of all cells).
+   */
+  vtkIdType GetNumberOfConnectivityIds();
+
+  /**
+   * Return the number of points defining the cell with the given id. As
+   * with all the cell id based methods below, the cell array must use
+   * offsets storage (see ConvertToDefaultStorage()).
+   */
+  vtkIdType GetCellSize(vtkIdType cellId);
+
+  /**
+   * Random access to the point ids of the cell with the given id. When the
+   * storage type matches vtkIdType, pts points directly into the
+   * connectivity array; otherwise the ids are copied into ptIds, which must
+   * then be non-null, and pts points into ptIds. Using a separate ptIds list
+   * per thread makes this method safe for concurrent use.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, const vtkIdType* &pts,
+                   vtkIdList *ptIds)
+    VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Random access to the point ids of the cell with the given id, which are
+   * copied into pts.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdList *pts);
+
+  //@{
+  /**
+   * Reverse the ordering of, or replace the point ids of, the cell with the
+   * given id. The new list of ids must have the same size as the old one.
+   * As with ReplaceCell(), the vtkCellArray is not marked as modified.
+   */
+  void ReverseCellAtId(vtkIdType cellId);
+  void ReplaceCellAtId(vtkIdType cellId, vtkIdType npts, const vtkIdType *pts)
+    VTK_SIZEHINT(pts, npts);
+  //@}
+
+  /**
+   * Call functor(offsets, connectivity) with the raw offsets and
+   * connectivity pointers of the offsets storage, typed as vtkTypeInt32 or
+   * vtkTypeInt64 according to the storage mode. The functor must therefore
+   * provide (templated) overloads for both types. The functor is not
+   * called with legacy storage.
+   */
+  template <typename Functor>
+  void Visit(Functor &functor);
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -288,6 +448,55 @@ protected:
   vtkIdType TraversalLocation;   //keep track of traversal position
   vtkIdTypeArray *Ia;
 
+  // Offsets storage (nullptr when StorageMode is LEGACY_STORAGE). Ia then
+  // holds the legacy copy built by GetData().
+  int StorageMode;
+  vtkDataArray *Offsets;
+  vtkDataArray *Connectivity;
+  vtkIdType TraversalCellId;
+  bool LegacyDataIsValid;
+  vtkTimeStamp LegacyDataTime;
+
+  // Per thread copies of the point ids handed out by the location based
+  // methods with offsets storage.
+  class vtkInternals;
+  vtkInternals *Internals;
+
+  void ReleaseOffsetsArrays();
+  void ConvertOffsetsToLegacyStorage();
+  void UpdateLegacyData();
+  vtkIdType GetCellIdAtLocation(vtkIdType loc);
+  void GetCellFromOffsets(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts);
+  int GetNextCellFromOffsets(vtkIdType &npts, vtkIdType* &pts);
+  template <typename T>
+  void ConvertToOffsets(int mode);
+  vtkIdType InsertNextCellAsOffsets(vtkIdType npts, const vtkIdType* pts);
+  vtkIdType InsertNextCellAsOffsets(int npts);
+  void InsertCellPointAsOffsets(vtkIdType id);
+  void UpdateCellCountAsOffsets(int npts);
+
+  template <typename T>
+  void GetCellAtIdImpl(vtkIdType cellId, vtkIdType &npts,
+                       const vtkIdType* &pts, vtkIdList *ptIds);
+
+  // Hand out point ids: alias them when the storage type is vtkIdType...
+  static void AssignCellPoints(const vtkIdType *ids, vtkIdType npts,
+                               const vtkIdType* &pts, vtkIdList *)
+  {
+    (void)npts;
+    pts = ids;
+  }
+  // ...otherwise copy them into the user provided list.
+  template <typename T>
+  static void AssignCellPoints(const T *ids, vtkIdType npts,
+                               const vtkIdType* &pts, vtkIdList *ptIds)
+  {
+    ptIds->SetNumberOfIds(npts);
+    vtkIdType *out = ptIds->GetPointer(0);
+    std::copy(ids, ids + npts, out);
+    pts = out;
+  }
+
 private:
   vtkCellArray(const vtkCellArray&) = delete;
   void operator=(const vtkCellArray&) = delete;
@@ -298,6 +507,11 @@ private:
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType* pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->InsertNextCellAsOffsets(npts, pts);
+  }
+
   vtkIdType i = this->Ia->GetMaxId() + 1;
   vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
 
@@ -315,6 +529,11 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->InsertNextCellAsOffsets(npts);
+  }
+
   this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
   this->NumberOfCells++;
 
@@ -324,12 +543,24 @@ inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->InsertCellPointAsOffsets(id);
+    return;
+  }
+
   this->Ia->InsertValue(this->InsertLocation++, id);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->UpdateCellCountAsOffsets(npts);
+    return;
+  }
+
   this->Ia->SetValue(this->InsertLocation-npts-1, npts);
 }
 
@@ -352,12 +583,24 @@ inline void vtkCellArray::Reset()
   this->NumberOfCells = 0;
   this->InsertLocation = 0;
   this->TraversalLocation = 0;
+  this->TraversalCellId = 0;
   this->Ia->Reset();
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->LegacyDataIsValid = false;
+    this->Offsets->Reset();
+    this->Offsets->InsertTuple1(0, 0);
+    this->Connectivity->Reset();
+  }
 }
 
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    return this->GetNextCellFromOffsets(npts, pts);
+  }
   if ( this->Ia->GetMaxId() >= 0 &&
        this->TraversalLocation <= this->Ia->GetMaxId() )
   {
@@ -375,6 +618,11 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->GetCellFromOffsets(this->GetCellIdAtLocation(loc), npts, pts);
+    return;
+  }
   npts = this->Ia->GetValue(loc++);
   pts  = this->Ia->GetPointer(loc);
 }
@@ -384,6 +632,11 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 {
   int i;
   vtkIdType tmp;
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->ReverseCellAtId(this->GetCellIdAtLocation(loc));
+    return;
+  }
   vtkIdType npts=this->Ia->GetValue(loc);
   vtkIdType *pts=this->Ia->GetPointer(loc+1);
   for (i=0; i < (npts/2); i++)
@@ -398,6 +651,11 @@ inline void vtkCellArray::ReverseCell(vtkIdType loc)
 inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
                                       const vtkIdType *pts)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->ReplaceCellAtId(this->GetCellIdAtLocation(loc), npts, pts);
+    return;
+  }
   vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
   for (int i=0; i < npts; i++)
   {
@@ -409,10 +667,75 @@ inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
 inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
                                              const vtkIdType size)
 {
+  if (this->StorageMode != LEGACY_STORAGE)
+  {
+    this->ReleaseOffsetsArrays();
+  }
   this->NumberOfCells = ncells;
   this->InsertLocation = size;
   this->TraversalLocation = 0;
   return this->Ia->WritePointer(0,size);
 }
 
+//----------------------------------------------------------------------------
+template <typename T>
+inline void vtkCellArray::GetCellAtIdImpl(vtkIdType cellId, vtkIdType &npts,
+                                          const vtkIdType* &pts,
+                                          vtkIdList *ptIds)
+{
+  const T *offsets = static_cast<vtkAOSDataArrayTemplate<T>*>(
+    this->Offsets)->GetPointer(0);
+  const T *conn = static_cast<vtkAOSDataArrayTemplate<T>*>(
+    this->Connectivity)->GetPointer(0);
+  const vtkIdType beg = static_cast<vtkIdType>(offsets[cellId]);
+  npts = static_cast<vtkIdType>(offsets[cellId+1]) - beg;
+  vtkCellArray::AssignCellPoints(conn + beg, npts, pts, ptIds);
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      const vtkIdType* &pts, vtkIdList *ptIds)
+{
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    vtkErrorMacro("GetCellAtId() requires offsets storage.");
+    npts = 0;
+    pts = nullptr;
+  }
+  else if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    this->GetCellAtIdImpl<vtkTypeInt64>(cellId, npts, pts, ptIds);
+  }
+  else
+  {
+    this->GetCellAtIdImpl<vtkTypeInt32>(cellId, npts, pts, ptIds);
+  }
+}
+
+//----------------------------------------------------------------------------
+template <typename Functor>
+inline void vtkCellArray::Visit(Functor &functor)
+{
+  if (this->StorageMode == LEGACY_STORAGE)
+  {
+    vtkErrorMacro("Visit() requires offsets storage.");
+  }
+  else if (this->StorageMode == OFFSETS_64BIT_STORAGE)
+  {
+    functor(
+      static_cast<vtkAOSDataArrayTemplate<vtkTypeInt64>*>(
+        this->Offsets)->GetPointer(0),
+      static_cast<vtkAOSDataArrayTemplate<vtkTypeInt64>*>(
+        this->Connectivity)->GetPointer(0));
+  }
+  else
+  {
+    functor(
+      static_cast<vtkAOSDataArrayTemplate<vtkTypeInt32>*>(
+        this->Offsets)->GetPointer(0),
+      static_cast<vtkAOSDataArrayTemplate<vtkTypeInt32>*>(
+        this->Connectivity)->GetPointer(0));
+  }
+}
+
 #endif
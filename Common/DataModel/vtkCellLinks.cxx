@@ -19,6 +19,7 @@
 #include "vtkGenericCell.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkStaticCellLinks.h"
 
 vtkStandardNewMacro(vtkCellLinks);
 
@@ -245,6 +246,28 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
   Connectivity->SetTraversalLocation(loc);
 }
 
+//----------------------------------------------------------------------------
+// Copy the static links.
+void vtkCellLinks::BuildLinks(vtkStaticCellLinks *links)
+{
+  vtkIdType numPts = links->GetNumberOfPoints();
+  vtkIdType ptId;
+
+  this->Allocate(numPts);
+  for (ptId=0; ptId < numPts; ptId++)
+  {
+    this->Array[ptId].ncells = links->GetNcells(ptId);
+  }
+  this->AllocateLinks(numPts);
+  this->MaxId = numPts - 1;
+
+  for (ptId=0; ptId < numPts; ptId++)
+  {
+    memcpy(this->Array[ptId].cells, links->GetCells(ptId),
+           this->Array[ptId].ncells * sizeof(vtkIdType));
+  }
+}
+
 //----------------------------------------------------------------------------
 // Insert a new point into the cell-links data structure. The size parameter
 // is the initial size of the list.
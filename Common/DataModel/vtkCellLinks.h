@@ -40,6 +40,7 @@
 
 class vtkDataSet;
 class vtkCellArray;
+class vtkStaticCellLinks;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkCellLinks : public vtkAbstractCellLinks
 {
@@ -71,6 +72,13 @@ public:
    */
   void BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity);
 
+  /**
+   * Build the link list array from static links, for instance to edit the
+   * links built by a dataset. The array is allocated for the points of the
+   * static links.
+   */
+  void BuildLinks(vtkStaticCellLinks *links);
+
   /**
    * Allocate the specified number of links (i.e., number of points) that
    * will be built.
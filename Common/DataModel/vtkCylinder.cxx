@@ -13,8 +13,14 @@
 
 =========================================================================*/
 #include "vtkCylinder.h"
+#include "vtkArrayDispatch.h"
+#include "vtkAssume.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkObjectFactory.h"
 #include "vtkMath.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkCylinder);
 
@@ -48,6 +54,82 @@ double vtkCylinder::EvaluateFunction(double x[3])
   return ( (vtkMath::Dot(x2C,x2C) - proj*proj) - this->Radius*this->Radius );
 }
 
+//----------------------------------------------------------------------------
+// Evaluate the cylinder equation at the points of an array in parallel.
+namespace {
+template <typename InputArrayType, typename OutputArrayType>
+struct CylinderFunctor
+{
+  typedef typename vtkDataArrayAccessor<OutputArrayType>::APIType
+    OutputValueType;
+  vtkDataArrayAccessor<InputArrayType> Input;
+  vtkDataArrayAccessor<OutputArrayType> Output;
+  double Center[3];
+  double Axis[3];
+  double R2;
+
+  CylinderFunctor(InputArrayType *input, OutputArrayType *output,
+                  const double center[3], const double axis[3], double radius)
+    : Input(input), Output(output), R2(radius * radius)
+  {
+    std::copy_n(center, 3, this->Center);
+    std::copy_n(axis, 3, this->Axis);
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    const double c0 = this->Center[0];
+    const double c1 = this->Center[1];
+    const double c2 = this->Center[2];
+    const double a0 = this->Axis[0];
+    const double a1 = this->Axis[1];
+    const double a2 = this->Axis[2];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const double x0 = static_cast<double>(this->Input.Get(ptId, 0)) - c0;
+      const double x1 = static_cast<double>(this->Input.Get(ptId, 1)) - c1;
+      const double x2 = static_cast<double>(this->Input.Get(ptId, 2)) - c2;
+      const double proj = a0 * x0 + a1 * x1 + a2 * x2;
+      this->Output.Set(ptId, 0, static_cast<OutputValueType>(
+        ((x0 * x0 + x1 * x1 + x2 * x2) - proj * proj) - this->R2));
+    }
+  }
+};
+
+struct CylinderWorker
+{
+  const double *Center;
+  const double *Axis;
+  double Radius;
+
+  template <typename InputArrayType, typename OutputArrayType>
+  void operator()(InputArrayType *input, OutputArrayType *output)
+  {
+    VTK_ASSUME(input->GetNumberOfComponents() == 3);
+    VTK_ASSUME(output->GetNumberOfComponents() == 1);
+    CylinderFunctor<InputArrayType, OutputArrayType> functor(
+      input, output, this->Center, this->Axis, this->Radius);
+    vtkSMPTools::For(0, input->GetNumberOfTuples(), functor);
+  }
+};
+} // end anon namespace
+
+void vtkCylinder::EvaluateFunction(vtkDataArray* input, vtkDataArray* output)
+{
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+
+  CylinderWorker worker = { this->Center, this->Axis, this->Radius };
+  typedef vtkTypeList_Create_2(float, double) InputTypes;
+  typedef vtkTypeList_Create_2(float, double) OutputTypes;
+  typedef vtkArrayDispatch::Dispatch2ByValueType<InputTypes, OutputTypes>
+    MyDispatch;
+  if (!MyDispatch::Execute(input, output, worker))
+  {
+    worker(input, output); // Use vtkDataArray API if dispatch fails.
+  }
+}
+
 //----------------------------------------------------------------------------
 // Evaluate cylinder function gradient (along potentially oriented axis). The
 // gradient is always in the radial direction, and thus must be projected
@@ -842,10 +842,10 @@ void vtkDataSetAttributes::RemoveArray(int index)
 void vtkDataSetAttributes::CopyData(vtkDataSetAttributes* fromPd,
                                     vtkIdType fromId, vtkIdType toId)
 {
-  int i;
-  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
-      i=this->RequiredArrays.NextIndex())
+  const int numArrays = this->RequiredArrays.GetListSize();
+  for (int pos = 0; pos < numArrays; ++pos)
   {
+    int i = this->RequiredArrays.GetIndex(pos);
     this->CopyTuple(fromPd->Data[i], this->Data[this->TargetIndices[i]],
                     fromId, toId);
   }
@@ -855,10 +855,10 @@ void vtkDataSetAttributes::CopyData(vtkDataSetAttributes* fromPd,
 void vtkDataSetAttributes::CopyData(vtkDataSetAttributes *fromPd,
                                     vtkIdList *fromIds, vtkIdList *toIds)
 {
-  int i;
-  for(i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
-      i=this->RequiredArrays.NextIndex())
+  const int numArrays = this->RequiredArrays.GetListSize();
+  for (int pos = 0; pos < numArrays; ++pos)
   {
+    int i = this->RequiredArrays.GetIndex(pos);
     this->CopyTuples(fromPd->Data[i], this->Data[this->TargetIndices[i]],
         fromIds, toIds);
   }
@@ -869,9 +869,10 @@ void vtkDataSetAttributes::CopyData(vtkDataSetAttributes *fromPd,
                                     vtkIdType dstStart, vtkIdType n,
                                     vtkIdType srcStart)
 {
-  for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
-       i = this->RequiredArrays.NextIndex())
+  const int numArrays = this->RequiredArrays.GetListSize();
+  for (int pos = 0; pos < numArrays; ++pos)
   {
+    int i = this->RequiredArrays.GetIndex(pos);
     this->CopyTuples(fromPd->Data[i], this->Data[this->TargetIndices[i]],
                      dstStart, n, srcStart);
   }
@@ -900,9 +901,10 @@ void vtkDataSetAttributes::InterpolatePoint(vtkDataSetAttributes *fromPd,
                                             vtkIdType toId, vtkIdList *ptIds,
                                             double *weights)
 {
-  for (int i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
-       i=this->RequiredArrays.NextIndex())
+  const int numArrays = this->RequiredArrays.GetListSize();
+  for (int pos = 0; pos < numArrays; ++pos)
   {
+    int i = this->RequiredArrays.GetIndex(pos);
     vtkAbstractArray* fromArray = fromPd->Data[i];
     vtkAbstractArray* toArray = this->Data[this->TargetIndices[i]];
 
@@ -941,9 +943,10 @@ void vtkDataSetAttributes::InterpolateEdge(vtkDataSetAttributes *fromPd,
                                            vtkIdType toId, vtkIdType p1,
                                            vtkIdType p2, double t)
 {
-  for (int i=this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
-      i=this->RequiredArrays.NextIndex())
+  const int numArrays = this->RequiredArrays.GetListSize();
+  for (int pos = 0; pos < numArrays; ++pos)
   {
+    int i = this->RequiredArrays.GetIndex(pos);
     vtkAbstractArray* fromArray = fromPd->Data[i];
     vtkAbstractArray* toArray = this->Data[this->TargetIndices[i]];
 
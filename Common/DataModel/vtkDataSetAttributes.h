@@ -457,7 +457,9 @@ public:
    * is a COPYTUPLE copy flag for that attribute (on or off), obey the flag
    * for that attribute, ignore (2) and (3), 2) if there is a copy field for
    * that field (on or off), obey the flag, ignore (3) 3) obey
-   * CopyAllOn/Off
+   * CopyAllOn/Off. This method, as well as InterpolatePoint() and
+   * InterpolateEdge(), does not modify this object, so distinct output ids
+   * of arrays presized with SetNumberOfTuples() may be filled concurrently.
    */
   void CopyData(vtkDataSetAttributes *fromPd, vtkIdType fromId, vtkIdType toId);
   void CopyData(vtkDataSetAttributes *fromPd,
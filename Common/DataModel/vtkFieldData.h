@@ -414,6 +414,10 @@ public:
     {
         return this->List[this->Position];
     }
+    int GetIndex(int position) const
+    {
+        return this->List[position];
+    }
     int BeginIndex()
     {
         this->Position = -1;
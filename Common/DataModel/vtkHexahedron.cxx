@@ -463,6 +463,12 @@ int *vtkHexahedron::GetEdgeArray(int edgeId)
   return edges[edgeId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkHexahedron::GetTriangleCases(int caseId)
+{
+  return vtkMarchingCubesTriangleCases::GetCases()[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkHexahedron::GetEdge(int edgeId)
 {
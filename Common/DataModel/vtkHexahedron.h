@@ -114,6 +114,14 @@ public:
   static int *GetFaceArray(int faceId) VTK_SIZEHINT(4);
   //@}
 
+  /**
+   * Return the case table for table-based isocontouring. A linear 3D cell
+   * with N vertices has 2**N cases, the case index having bit i set when
+   * vertex i is above the contour value. The returned list gives three edges
+   * (see GetEdgeArray()) per output triangle and is terminated by -1.
+   */
+  static int *GetTriangleCases(int caseId);
+
   /**
    * Given parametric coordinates compute inverse Jacobian transformation
    * matrix. Returns 9 elements of 3x3 inverse Jacobian plus interpolation
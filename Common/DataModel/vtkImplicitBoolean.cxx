@@ -14,8 +14,14 @@
 =========================================================================*/
 #include "vtkImplicitBoolean.h"
 
+#include "vtkArrayDispatch.h"
+#include "vtkAssume.h"
+#include "vtkDataArrayAccessor.h"
+#include "vtkDoubleArray.h"
 #include "vtkImplicitFunctionCollection.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 
 #include <cmath>
 
@@ -146,6 +152,145 @@ double vtkImplicitBoolean::EvaluateFunction(double x[3])
   return value;
 }
 
+// Combine the values of a function of the boolean, evaluated at the points of
+// an array, into the values of the boolean in parallel.
+namespace {
+template <typename ArrayType>
+struct BooleanFunctor
+{
+  typedef typename vtkDataArrayAccessor<ArrayType>::APIType ValueType;
+  vtkDataArrayAccessor<ArrayType> Output;
+  const double *Values;
+  int OperationType;
+  bool First;
+
+  BooleanFunctor(ArrayType *output, const double *values, int operationType,
+                 bool first)
+    : Output(output), Values(values), OperationType(operationType),
+      First(first)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    switch (this->OperationType)
+    {
+      case vtkImplicitBoolean::VTK_UNION:
+        for ( ; ptId < endPtId; ++ptId)
+        {
+          double v = this->Values[ptId];
+          if (v < this->Output.Get(ptId, 0))
+          {
+            this->Output.Set(ptId, 0, static_cast<ValueType>(v));
+          }
+        }
+        break;
+      case vtkImplicitBoolean::VTK_INTERSECTION:
+        for ( ; ptId < endPtId; ++ptId)
+        {
+          double v = this->Values[ptId];
+          if (v > this->Output.Get(ptId, 0))
+          {
+            this->Output.Set(ptId, 0, static_cast<ValueType>(v));
+          }
+        }
+        break;
+      case vtkImplicitBoolean::VTK_UNION_OF_MAGNITUDES:
+        for ( ; ptId < endPtId; ++ptId)
+        {
+          double v = fabs(this->Values[ptId]);
+          if (v < this->Output.Get(ptId, 0))
+          {
+            this->Output.Set(ptId, 0, static_cast<ValueType>(v));
+          }
+        }
+        break;
+      default: // difference
+        for ( ; ptId < endPtId; ++ptId)
+        {
+          double v = this->Values[ptId];
+          if (this->First)
+          {
+            this->Output.Set(ptId, 0, static_cast<ValueType>(v));
+          }
+          else if (-v > this->Output.Get(ptId, 0))
+          {
+            this->Output.Set(ptId, 0, static_cast<ValueType>(-v));
+          }
+        }
+        break;
+    }
+  }
+};
+
+struct BooleanWorker
+{
+  const double *Values;
+  int OperationType;
+  bool First;
+
+  template <typename ArrayType>
+  void operator()(ArrayType *output)
+  {
+    VTK_ASSUME(output->GetNumberOfComponents() == 1);
+    BooleanFunctor<ArrayType> functor(output, this->Values,
+                                      this->OperationType, this->First);
+    vtkSMPTools::For(0, output->GetNumberOfTuples(), functor);
+  }
+};
+} // end anon namespace
+
+// Evaluate each function at all the points at once, then combine the values.
+void vtkImplicitBoolean::EvaluateFunction(vtkDataArray* input,
+                                          vtkDataArray* output)
+{
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+
+  if (this->FunctionList->GetNumberOfItems() == 0)
+  {
+    output->Fill(0.0);
+    return;
+  }
+  else if ( this->OperationType == VTK_UNION ||
+            this->OperationType == VTK_UNION_OF_MAGNITUDES )
+  {
+    output->Fill(VTK_DOUBLE_MAX);
+  }
+  else if ( this->OperationType == VTK_INTERSECTION )
+  {
+    output->Fill(-VTK_DOUBLE_MAX);
+  }
+
+  vtkNew<vtkDoubleArray> values;
+  vtkImplicitFunction *f, *firstF = nullptr;
+  vtkCollectionSimpleIterator sit;
+  for (this->FunctionList->InitTraversal(sit);
+       (f=this->FunctionList->GetNextImplicitFunction(sit)); )
+  {
+    // As in EvaluateFunction(x), the difference ignores other occurrences
+    // of its first function.
+    bool first = (firstF == nullptr);
+    if ( first )
+    {
+      firstF = f;
+    }
+    else if ( f == firstF && this->OperationType == VTK_DIFFERENCE )
+    {
+      continue;
+    }
+
+    f->FunctionValue(input, values);
+    BooleanWorker worker = { values->GetPointer(0), this->OperationType,
+                             first };
+    if (!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>::
+          Execute(output, worker))
+    {
+      worker(output); // Use vtkDataArray API if dispatch fails.
+    }
+  }
+}
+
 // Evaluate gradient of boolean combination.
 void vtkImplicitBoolean::EvaluateGradient(double x[3], double g[3])
 {
@@ -64,6 +64,7 @@ public:
    * Evaluate boolean combinations of implicit function using current operator.
    */
   using vtkImplicitFunction::EvaluateFunction;
+  void EvaluateFunction(vtkDataArray* input, vtkDataArray* output) override;
   double EvaluateFunction(double x[3]) override;
   //@}
 
@@ -19,6 +19,8 @@
 #include "vtkAssume.h"
 #include "vtkDataArrayAccessor.h"
 #include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
 #include "vtkTransform.h"
 
 vtkCxxSetObjectMacro(vtkImplicitFunction,Transform,vtkAbstractTransform);
@@ -74,21 +76,6 @@ private:
   vtkImplicitFunction* Function;
 };
 
-class TransformFunction {
-public:
-  TransformFunction(vtkImplicitFunction* function,
-                    vtkAbstractTransform* transform)
-      : Function(function), Transform(transform) {}
-  double operator()(double in[3])
-  {
-    Transform->TransformPoint(in, in);
-    return this->Function->EvaluateFunction(in);
-  }
-private:
-  vtkImplicitFunction* Function;
-  vtkAbstractTransform* Transform;
-};
-
 } // end anon namespace
 
 void vtkImplicitFunction::FunctionValue(vtkDataArray* input,
@@ -98,18 +85,14 @@ void vtkImplicitFunction::FunctionValue(vtkDataArray* input,
   {
     this->EvaluateFunction(input, output);
   }
-  else // pass point through transform
+  else // pass the points through the transform, then evaluate them at once
   {
-    FunctionWorker<TransformFunction> worker(
-        TransformFunction(this, this->Transform));
-    typedef vtkTypeList_Create_2(float, double) InputTypes;
-    typedef vtkTypeList_Create_2(float, double) OutputTypes;
-    typedef vtkArrayDispatch::Dispatch2ByValueType<InputTypes, OutputTypes>
-        MyDispatch;
-    if (!MyDispatch::Execute(input, output, worker))
-    {
-      worker(input, output); // Use vtkDataArray API if dispatch fails.
-    }
+    vtkNew<vtkPoints> points;
+    points->SetData(input);
+    vtkNew<vtkPoints> transformed;
+    transformed->SetDataTypeToDouble();
+    this->Transform->TransformPoints(points, transformed);
+    this->EvaluateFunction(transformed->GetData(), output);
   }
 }
 
@@ -72,7 +72,9 @@ public:
   //@{
   /**
    * Evaluate function at position x-y-z and return value. Point x[3] is
-   * transformed through transform (if provided).
+   * transformed through transform (if provided). The vtkDataArray version
+   * evaluates the function at all the 3-component tuples of input, which
+   * are transformed at once, and resizes output to hold the values.
    */
   virtual void FunctionValue(vtkDataArray* input, vtkDataArray* output);
   double FunctionValue(const double x[3]);
@@ -108,7 +110,10 @@ public:
    * Evaluate function at position x-y-z and return value.  You should
    * generally not call this method directly, you should use
    * FunctionValue() instead.  This method must be implemented by
-   * any derived class.
+   * any derived class. The vtkDataArray version calls it for each tuple of
+   * input in turn, since it may not be safe to call from several threads;
+   * the analytic functions (e.g. vtkPlane, vtkSphere, vtkBox) override it to
+   * evaluate the tuples in parallel with vtkSMPTools.
    */
   virtual double EvaluateFunction(double x[3]) = 0;
   virtual void EvaluateFunction(vtkDataArray* input, vtkDataArray* output);
@@ -286,6 +286,9 @@ struct CutFunctionWorker
 //-----------------------------------------------------------------------------
 void vtkPlane::EvaluateFunction(vtkDataArray* input, vtkDataArray* output)
 {
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+
   CutFunctionWorker worker(this->Normal, this->Origin);
   typedef vtkTypeList_Create_2(float, double) InputTypes;
   typedef vtkTypeList_Create_2(float, double) OutputTypes;
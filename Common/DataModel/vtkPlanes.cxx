@@ -14,12 +14,17 @@
 =========================================================================*/
 #include "vtkPlanes.h"
 
+#include "vtkArrayDispatch.h"
+#include "vtkAssume.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDoubleArray.h"
 #include "vtkObjectFactory.h"
 #include "vtkPlane.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkPlanes);
 vtkCxxSetObjectMacro(vtkPlanes,Points,vtkPoints);
@@ -108,6 +113,102 @@ double vtkPlanes::EvaluateFunction(double x[3])
   return maxVal;
 }
 
+// Evaluate the plane equations at the points of an array in parallel.
+namespace {
+template <typename InputArrayType, typename OutputArrayType>
+struct PlanesFunctor
+{
+  typedef typename vtkDataArrayAccessor<OutputArrayType>::APIType
+    OutputValueType;
+  vtkDataArrayAccessor<InputArrayType> Input;
+  vtkDataArrayAccessor<OutputArrayType> Output;
+  const std::vector<double> &Planes;
+
+  PlanesFunctor(InputArrayType *input, OutputArrayType *output,
+                const std::vector<double> &planes)
+    : Input(input), Output(output), Planes(planes)
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    const double *planesBegin = this->Planes.data();
+    const double *planesEnd = planesBegin + this->Planes.size();
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const double x0 = static_cast<double>(this->Input.Get(ptId, 0));
+      const double x1 = static_cast<double>(this->Input.Get(ptId, 1));
+      const double x2 = static_cast<double>(this->Input.Get(ptId, 2));
+      double maxVal = -VTK_DOUBLE_MAX;
+      for (const double *plane = planesBegin; plane != planesEnd; plane += 6)
+      {
+        double val = plane[0] * (x0 - plane[3]) + plane[1] * (x1 - plane[4]) +
+          plane[2] * (x2 - plane[5]);
+        if (val > maxVal)
+        {
+          maxVal = val;
+        }
+      }
+      this->Output.Set(ptId, 0, static_cast<OutputValueType>(maxVal));
+    }
+  }
+};
+
+struct PlanesWorker
+{
+  const std::vector<double> &Planes;
+
+  template <typename InputArrayType, typename OutputArrayType>
+  void operator()(InputArrayType *input, OutputArrayType *output)
+  {
+    VTK_ASSUME(input->GetNumberOfComponents() == 3);
+    VTK_ASSUME(output->GetNumberOfComponents() == 1);
+    PlanesFunctor<InputArrayType, OutputArrayType> functor(
+      input, output, this->Planes);
+    vtkSMPTools::For(0, input->GetNumberOfTuples(), functor);
+  }
+};
+} // end anon namespace
+
+void vtkPlanes::EvaluateFunction(vtkDataArray* input, vtkDataArray* output)
+{
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+
+  if ( !this->Points || ! this->Normals )
+  {
+    vtkErrorMacro(<<"Please define points and/or normals!");
+    output->Fill(VTK_DOUBLE_MAX);
+    return;
+  }
+
+  int numPlanes = this->Points->GetNumberOfPoints();
+  if ( numPlanes != this->Normals->GetNumberOfTuples() )
+  {
+    vtkErrorMacro(<<"Number of normals/points inconsistent!");
+    output->Fill(VTK_DOUBLE_MAX);
+    return;
+  }
+
+  // Gather the normal and the point of each plane.
+  std::vector<double> planes(6 * numPlanes);
+  for (int i = 0; i < numPlanes; i++)
+  {
+    this->Normals->GetTuple(i, planes.data() + 6 * i);
+    this->Points->GetPoint(i, planes.data() + 6 * i + 3);
+  }
+
+  PlanesWorker worker = { planes };
+  typedef vtkTypeList_Create_2(float, double) InputTypes;
+  typedef vtkTypeList_Create_2(float, double) OutputTypes;
+  typedef vtkArrayDispatch::Dispatch2ByValueType<InputTypes, OutputTypes>
+    MyDispatch;
+  if (!MyDispatch::Execute(input, output, worker))
+  {
+    worker(input, output); // Use vtkDataArray API if dispatch fails.
+  }
+}
+
 // Evaluate planes gradient.
 void vtkPlanes::EvaluateGradient(double x[3], double n[3])
 {
@@ -57,6 +57,7 @@ public:
    * Evaluate plane equations. Return smallest absolute value.
    */
   using vtkImplicitFunction::EvaluateFunction;
+  void EvaluateFunction(vtkDataArray* input, vtkDataArray* output) override;
   double EvaluateFunction(double x[3]) override;
   //@}
 
@@ -30,6 +30,7 @@
 #include "vtkPolyVertex.h"
 #include "vtkPolygon.h"
 #include "vtkQuad.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleStrip.h"
 #include "vtkVertex.h"
@@ -60,7 +61,7 @@ vtkPolyData::vtkPolyData () :
   Vertex(nullptr), PolyVertex(nullptr), Line(nullptr), PolyLine(nullptr),
   Triangle(nullptr), Quad(nullptr), Polygon(nullptr), TriangleStrip(nullptr),
   EmptyCell(nullptr), Verts(nullptr), Lines(nullptr), Polys(nullptr),
-  Strips(nullptr), Cells(nullptr), Links(nullptr)
+  Strips(nullptr), Cells(nullptr), Links(nullptr), StaticLinks(nullptr)
 {
   this->Information->Set(vtkDataObject::DATA_EXTENT_TYPE(), VTK_PIECES_EXTENT);
   this->Information->Set(vtkDataObject::DATA_PIECE_NUMBER(), -1);
@@ -202,11 +203,7 @@ void vtkPolyData::CopyStructure(vtkDataSet *ds)
     this->Cells = nullptr;
   }
 
-  if ( this->Links )
-  {
-    this->Links->UnRegister(this);
-    this->Links = nullptr;
-  }
+  this->DeleteLinks();
 }
 
 //----------------------------------------------------------------------------
@@ -805,11 +802,7 @@ void vtkPolyData::Cleanup()
     this->Cells = nullptr;
   }
 
-  if ( this->Links )
-  {
-    this->Links->UnRegister(this);
-    this->Links = nullptr;
-  }
+  this->DeleteLinks();
 }
 
 //----------------------------------------------------------------------------
@@ -905,11 +898,7 @@ vtkIdType vtkPolyData::GetNumberOfStrips()
 void vtkPolyData::DeleteCells()
 {
   // if we have Links, we need to delete them (they are no longer valid)
-  if (this->Links)
-  {
-    this->Links->UnRegister( this );
-    this->Links = nullptr;
-  }
+  this->DeleteLinks();
 
   if (this->Cells)
   {
@@ -1063,38 +1052,85 @@ void vtkPolyData::DeleteLinks()
     this->Links->UnRegister( this );
     this->Links = nullptr;
   }
+  if (this->StaticLinks)
+  {
+    this->StaticLinks->UnRegister( this );
+    this->StaticLinks = nullptr;
+  }
 }
 
 //----------------------------------------------------------------------------
 // Create upward links from points to cells that use each point. Enables
-// topologically complex queries.
+// topologically complex queries. Static links are built in parallel, unless
+// an initial size is given for editable links.
 void vtkPolyData::BuildLinks(int initialSize)
 {
-  if ( this->Links )
-  {
-    this->DeleteLinks();
-  }
+  this->DeleteLinks();
 
   if ( this->Cells == nullptr )
   {
     this->BuildCells();
   }
 
-  this->Links = vtkCellLinks::New();
-  if ( initialSize > 0 )
+  if ( initialSize <= 0 )
   {
-    this->Links->Allocate(initialSize);
-  }
-  else
-  {
-    this->Links->Allocate(this->GetNumberOfPoints());
+    this->StaticLinks = vtkStaticCellLinks::New();
+    this->StaticLinks->Register(this);
+    this->StaticLinks->Delete();
+    this->StaticLinks->BuildLinks(this);
+    return;
   }
+
+  this->Links = vtkCellLinks::New();
+  this->Links->Allocate(initialSize);
   this->Links->Register(this);
   this->Links->Delete();
 
   this->Links->BuildLinks(this);
 }
 
+//----------------------------------------------------------------------------
+// Convert the static links to editable links, before they are modified.
+void vtkPolyData::BuildEditableLinks()
+{
+  vtkIdType numPts = this->StaticLinks->GetNumberOfPoints();
+
+  this->Links = vtkCellLinks::New();
+  this->Links->Allocate(numPts);
+  this->Links->Register(this);
+  this->Links->Delete();
+
+  for (vtkIdType ptId=0; ptId < numPts; ptId++)
+  {
+    vtkIdType ncells = this->StaticLinks->GetNumberOfCells(ptId);
+    const vtkIdType *cells = this->StaticLinks->GetCells(ptId);
+    this->Links->InsertNextPoint(static_cast<int>(ncells));
+    for (vtkIdType i=0; i < ncells; i++)
+    {
+      this->Links->InsertNextCellReference(ptId, cells[i]);
+    }
+  }
+
+  this->StaticLinks->UnRegister(this);
+  this->StaticLinks = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::GetPointCells(vtkIdType ptId, unsigned short& ncells,
+                                vtkIdType* &cells)
+{
+  if ( this->StaticLinks )
+  {
+    ncells = this->StaticLinks->GetNcells(ptId);
+    cells = const_cast<vtkIdType*>(this->StaticLinks->GetCells(ptId));
+  }
+  else
+  {
+    ncells = this->Links->GetNcells(ptId);
+    cells = this->Links->GetCells(ptId);
+  }
+}
+
 //----------------------------------------------------------------------------
 // Copy a cells point ids into list provided. (Less efficient.)
 void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
@@ -1127,17 +1163,16 @@ void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 void vtkPolyData::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
 {
   vtkIdType *cells;
-  vtkIdType numCells;
+  unsigned short numCells;
   vtkIdType i;
 
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
   cellIds->Reset();
 
-  numCells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  this->GetPointCells(ptId, numCells, cells);
 
   for (i=0; i < numCells; i++)
   {
@@ -1467,7 +1502,7 @@ void vtkPolyData::ReverseCell(vtkIdType cellId)
 // use this method, make sure points are available and BuildLinks() has been invoked.)
 vtkIdType vtkPolyData::InsertNextLinkedPoint(int numLinks)
 {
-  return this->Links->InsertNextPoint(numLinks);
+  return this->GetEditableLinks()->InsertNextPoint(numLinks);
 }
 
 //----------------------------------------------------------------------------
@@ -1477,7 +1512,7 @@ vtkIdType vtkPolyData::InsertNextLinkedPoint(int numLinks)
 // and BuildLinks() has been invoked.)
 vtkIdType vtkPolyData::InsertNextLinkedPoint(double x[3], int numLinks)
 {
-  this->Links->InsertNextPoint(numLinks);
+  this->GetEditableLinks()->InsertNextPoint(numLinks);
   return this->Points->InsertNextPoint(x);
 }
 
@@ -1488,13 +1523,14 @@ vtkIdType vtkPolyData::InsertNextLinkedPoint(double x[3], int numLinks)
 vtkIdType vtkPolyData::InsertNextLinkedCell(int type, int npts, vtkIdType *pts)
 {
   vtkIdType i, id;
+  vtkCellLinks *links = this->GetEditableLinks();
 
   id = this->InsertNextCell(type,npts,pts);
 
   for (i=0; i<npts; i++)
   {
-    this->Links->ResizeCellList(pts[i],1);
-    this->Links->AddCellReference(id,pts[i]);
+    links->ResizeCellList(pts[i],1);
+    links->AddCellReference(id,pts[i]);
   }
 
   return id;
@@ -1507,7 +1543,7 @@ vtkIdType vtkPolyData::InsertNextLinkedCell(int type, int npts, vtkIdType *pts)
 // operator ResizeCellList() to do this if necessary.
 void vtkPolyData::RemoveReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
-  this->Links->RemoveCellReference(cellId, ptId);
+  this->GetEditableLinks()->RemoveCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1517,7 +1553,7 @@ void vtkPolyData::RemoveReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 // operator ResizeCellList() to do this if necessary.
 void vtkPolyData::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
-  this->Links->AddCellReference(cellId, ptId);
+  this->GetEditableLinks()->AddCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1594,9 +1630,10 @@ void vtkPolyData::ReplaceLinkedCell(vtkIdType cellId, int npts, vtkIdType *pts)
       npts = 0;
   }
 
+  vtkCellLinks *links = this->GetEditableLinks();
   for (int i=0; i < npts; i++)
   {
-    this->Links->InsertNextCellReference(pts[i],cellId);
+    links->InsertNextCellReference(pts[i],cellId);
   }
 }
 
@@ -1609,14 +1646,13 @@ void vtkPolyData::GetCellEdgeNeighbors(vtkIdType cellId, vtkIdType p1,
 {
   cellIds->Reset();
 
-  const vtkCellLinks::Link &link1(this->Links->GetLink(p1));
-  const vtkCellLinks::Link &link2(this->Links->GetLink(p2));
-
-  const vtkIdType *cells1 = link1.cells;
-  const vtkIdType *cells1End = cells1 + link1.ncells;
+  unsigned short ncells1, ncells2;
+  vtkIdType *cells1, *cells2;
+  this->GetPointCells(p1, ncells1, cells1);
+  this->GetPointCells(p2, ncells2, cells2);
 
-  const vtkIdType *cells2 = link2.cells;
-  const vtkIdType *cells2End = cells2 + link2.ncells;
+  const vtkIdType *cells1End = cells1 + ncells1;
+  const vtkIdType *cells2End = cells2 + ncells2;
 
   while (cells1 != cells1End)
   {
@@ -1644,7 +1680,7 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
   vtkIdType i, j, numPts, cellNum;
   int allFound, oneFound;
 
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
@@ -1653,8 +1689,9 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
   // load list with candidate cells, remove current cell
   vtkIdType ptId = ptIds->GetId(0);
-  int numPrime = this->Links->GetNcells(ptId);
-  vtkIdType *primeCells = this->Links->GetCells(ptId);
+  unsigned short numPrime, numCurrent;
+  vtkIdType *primeCells, *currentCells;
+  this->GetPointCells(ptId, numPrime, primeCells);
   numPts = ptIds->GetNumberOfIds();
 
   // for each potential cell
@@ -1667,8 +1704,7 @@ void vtkPolyData::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
       for (allFound=1, i=1; i < numPts && allFound; i++)
       {
         ptId = ptIds->GetId(i);
-        int numCurrent = this->Links->GetNcells(ptId);
-        vtkIdType *currentCells = this->Links->GetCells(ptId);
+        this->GetPointCells(ptId, numCurrent, currentCells);
         oneFound = 0;
         for (j = 0; j < numCurrent; j++)
         {
@@ -1794,6 +1830,10 @@ unsigned long vtkPolyData::GetActualMemorySize()
   {
     size += this->Links->GetActualMemorySize();
   }
+  if ( this->StaticLinks )
+  {
+    size += this->StaticLinks->GetActualMemorySize();
+  }
   return size;
 }
 
@@ -1831,6 +1871,16 @@ void vtkPolyData::ShallowCopy(vtkDataObject *dataObject)
     {
       this->Links->Register(this);
     }
+
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Delete();
+    }
+    this->StaticLinks = polyData->StaticLinks;
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Register(this);
+    }
   }
 
   // Do superclass
@@ -1880,12 +1930,8 @@ void vtkPolyData::DeepCopy(vtkDataObject *dataObject)
       this->BuildCells();
     }
 
-    if ( this->Links )
-    {
-      this->Links->UnRegister(this);
-      this->Links = nullptr;
-    }
-    if (polyData->Links)
+    this->DeleteLinks();
+    if (polyData->Links || polyData->StaticLinks)
     {
       this->BuildLinks();
     }
@@ -2141,7 +2187,7 @@ int vtkPolyData::GetScalarFieldCriticalIndex (vtkIdType pointId,
     return vtkPolyData::ERR_INCORRECT_FIELD;
 
   /* make sure the connectivity is built */
-  if(!this->Links) this->BuildLinks();
+  if(!this->Links && !this->StaticLinks) this->BuildLinks();
 
   /* build the lower and upper links */
   this->GetPointCells(pointId, starTriangleList);
@@ -74,6 +74,7 @@ class vtkQuad;
 class vtkPolygon;
 class vtkTriangleStrip;
 class vtkEmptyCell;
+class vtkStaticCellLinks;
 struct vtkPolyDataDummyContainter;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkPolyData : public vtkPointSet
@@ -263,9 +264,12 @@ public:
 
   /**
    * Create upward links from points to cells that use each point. Enables
-   * topologically complex queries. Normally the links array is allocated
-   * based on the number of points in the vtkPolyData. The optional
-   * initialSize parameter can be used to allocate a larger size initially.
+   * topologically complex queries. By default, compact static links are
+   * built in parallel; they are converted to editable links the first time
+   * the links are modified (e.g., by InsertNextLinkedPoint(),
+   * RemoveReferenceToCell(), ResizeCellList()...). The optional initialSize
+   * parameter directly builds editable links, allocated for initialSize
+   * points, so that linked points can be inserted without reallocation.
    */
   void BuildLinks(int initialSize=0);
 
@@ -282,7 +286,9 @@ public:
   void DeleteLinks();
 
   /**
-   * Special (efficient) operations on poly data. Use carefully.
+   * Special (efficient) operations on poly data. Use carefully: the list of
+   * cells is not valid anymore once the links are edited, as the static
+   * links are then replaced by editable links.
    */
   void GetPointCells(vtkIdType ptId, unsigned short& ncells,
                      vtkIdType* &cells);
@@ -564,6 +570,18 @@ protected:
   // built only when necessary
   vtkCellTypes *Cells;
   vtkCellLinks *Links;
+  vtkStaticCellLinks *StaticLinks; // built instead of Links by BuildLinks()
+
+  // Return the editable links, converting the static links if needed.
+  vtkCellLinks *GetEditableLinks()
+  {
+    if ( this->StaticLinks )
+    {
+      this->BuildEditableLinks();
+    }
+    return this->Links;
+  }
+  void BuildEditableLinks();
 
 private:
   // Hide these from the user and the compiler.
@@ -581,13 +599,6 @@ private:
   void operator=(const vtkPolyData&) = delete;
 };
 
-inline void vtkPolyData::GetPointCells(vtkIdType ptId, unsigned short& ncells,
-                                       vtkIdType* &cells)
-{
-  ncells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
-}
-
 inline int vtkPolyData::IsTriangle(int v1, int v2, int v3)
 {
   unsigned short int n1;
@@ -636,7 +647,7 @@ inline int vtkPolyData::IsPointUsedByCell(vtkIdType ptId, vtkIdType cellId)
 
 inline void vtkPolyData::DeletePoint(vtkIdType ptId)
 {
-  this->Links->DeletePoint(ptId);
+  this->GetEditableLinks()->DeletePoint(ptId);
 }
 
 inline void vtkPolyData::DeleteCell(vtkIdType cellId)
@@ -647,28 +658,30 @@ inline void vtkPolyData::DeleteCell(vtkIdType cellId)
 inline void vtkPolyData::RemoveCellReference(vtkIdType cellId)
 {
   vtkIdType *pts, npts;
+  vtkCellLinks *links = this->GetEditableLinks();
 
   this->GetCellPoints(cellId, npts, pts);
   for (vtkIdType i=0; i<npts; i++)
   {
-    this->Links->RemoveCellReference(cellId, pts[i]);
+    links->RemoveCellReference(cellId, pts[i]);
   }
 }
 
 inline void vtkPolyData::AddCellReference(vtkIdType cellId)
 {
   vtkIdType *pts, npts;
+  vtkCellLinks *links = this->GetEditableLinks();
 
   this->GetCellPoints(cellId, npts, pts);
   for (vtkIdType i=0; i<npts; i++)
   {
-    this->Links->AddCellReference(cellId, pts[i]);
+    links->AddCellReference(cellId, pts[i]);
   }
 }
 
 inline void vtkPolyData::ResizeCellList(vtkIdType ptId, int size)
 {
-  this->Links->ResizeCellList(ptId,size);
+  this->GetEditableLinks()->ResizeCellList(ptId,size);
 }
 
 inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
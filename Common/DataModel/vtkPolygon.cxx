@@ -1761,7 +1761,7 @@ void vtkPolygon::Derivatives(int vtkNotUsed(subId), double pcoords[3],
     {
       for ( i=0; i < 3; i++ )
       {
-        derivs[j*dim + i] = 0.0;
+        derivs[3*j + i] = 0.0;
       }
     }
     return;
@@ -477,6 +477,12 @@ int *vtkPyramid::GetEdgeArray(int edgeId)
   return edges[edgeId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkPyramid::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkPyramid::GetEdge(int edgeId)
 {
@@ -13,8 +13,14 @@
 
 =========================================================================*/
 #include "vtkSphere.h"
+#include "vtkArrayDispatch.h"
+#include "vtkAssume.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkSphere);
 
@@ -39,6 +45,75 @@ double vtkSphere::EvaluateFunction(double x[3])
            this->Radius*this->Radius );
 }
 
+//----------------------------------------------------------------------------
+// Evaluate the sphere equation at the points of an array in parallel.
+namespace {
+template <typename InputArrayType, typename OutputArrayType>
+struct SphereFunctor
+{
+  typedef typename vtkDataArrayAccessor<OutputArrayType>::APIType
+    OutputValueType;
+  vtkDataArrayAccessor<InputArrayType> Input;
+  vtkDataArrayAccessor<OutputArrayType> Output;
+  double Center[3];
+  double R2;
+
+  SphereFunctor(InputArrayType *input, OutputArrayType *output,
+                const double center[3], double radius)
+    : Input(input), Output(output), R2(radius * radius)
+  {
+    std::copy_n(center, 3, this->Center);
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    const double c0 = this->Center[0];
+    const double c1 = this->Center[1];
+    const double c2 = this->Center[2];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      const double x0 = static_cast<double>(this->Input.Get(ptId, 0)) - c0;
+      const double x1 = static_cast<double>(this->Input.Get(ptId, 1)) - c1;
+      const double x2 = static_cast<double>(this->Input.Get(ptId, 2)) - c2;
+      this->Output.Set(ptId, 0, static_cast<OutputValueType>(
+        (x0 * x0 + x1 * x1 + x2 * x2) - this->R2));
+    }
+  }
+};
+
+struct SphereWorker
+{
+  const double *Center;
+  double Radius;
+
+  template <typename InputArrayType, typename OutputArrayType>
+  void operator()(InputArrayType *input, OutputArrayType *output)
+  {
+    VTK_ASSUME(input->GetNumberOfComponents() == 3);
+    VTK_ASSUME(output->GetNumberOfComponents() == 1);
+    SphereFunctor<InputArrayType, OutputArrayType> functor(
+      input, output, this->Center, this->Radius);
+    vtkSMPTools::For(0, input->GetNumberOfTuples(), functor);
+  }
+};
+} // end anon namespace
+
+void vtkSphere::EvaluateFunction(vtkDataArray* input, vtkDataArray* output)
+{
+  output->SetNumberOfComponents(1);
+  output->SetNumberOfTuples(input->GetNumberOfTuples());
+
+  SphereWorker worker = { this->Center, this->Radius };
+  typedef vtkTypeList_Create_2(float, double) InputTypes;
+  typedef vtkTypeList_Create_2(float, double) OutputTypes;
+  typedef vtkArrayDispatch::Dispatch2ByValueType<InputTypes, OutputTypes>
+    MyDispatch;
+  if (!MyDispatch::Execute(input, output, worker))
+  {
+    worker(input, output); // Use vtkDataArray API if dispatch fails.
+  }
+}
+
 //----------------------------------------------------------------------------
 // Evaluate sphere gradient.
 void vtkSphere::EvaluateGradient(double x[3], double n[3])
@@ -26,7 +26,9 @@
  * topological information. This class is a faster implementation of
  * vtkCellLinks. However, it cannot be incrementally constructed; it is meant
  * to be constructed once (statically) and must be rebuilt if the cells
- * change.
+ * change. The links of polydata and unstructured grids are built in
+ * parallel with vtkSMPTools. In any case, the cells using a point are listed
+ * in increasing order of their ids.
  *
  * This is a templated implementation for vtkStaticCellLinks. The reason for
  * the templating is to gain performance and reduce memory by using smaller
@@ -89,6 +91,14 @@ public:
    */
   void BuildLinks(vtkUnstructuredGrid *ugrid);
 
+  /**
+   * Get the number of points for which links were built.
+   */
+  TIds GetNumberOfPoints()
+  {
+      return this->NumPts;
+  }
+
   /**
    * Get the number of cells using the point specified by ptId.
    */
@@ -105,6 +115,15 @@ public:
       return this->Links + this->Offsets[ptId];
   }
 
+  /**
+   * Return the memory in kibibytes (1024 bytes) consumed by the links.
+   */
+  unsigned long GetActualMemorySize()
+  {
+    return static_cast<unsigned long>(
+      (sizeof(TIds) * (this->LinksSize + this->NumPts + 2) + 1023) / 1024);
+  }
+
 protected:
   // The various templated data members
   TIds LinksSize;
@@ -115,6 +134,14 @@ protected:
   TIds *Links; //contiguous runs of cell ids
   TIds *Offsets; //offsets for each point into the link array
 
+  // Build the links of the cells of the given arrays, in parallel if possible
+  void BuildLinks(vtkIdType numPts, vtkCellArray **cellArrays,
+                  int numCellArrays);
+
+  // Helpers of the serial builds
+  void PrefixSum();
+  void ShiftOffsets();
+
 private:
   vtkStaticCellLinksTemplate(const vtkStaticCellLinksTemplate&) = delete;
   void operator=(const vtkStaticCellLinksTemplate&) = delete;
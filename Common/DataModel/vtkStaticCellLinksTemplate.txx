@@ -19,14 +19,155 @@
 
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
+#include "vtkIdList.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
 //----------------------------------------------------------------------------
-// Note: this class is a faster, serial version of vtkCellLinks. Future work
-// to parallelize this class is possible. This includes:
-// = using a parallel prefix sum operation
-// = using atomics to update counts (i.e., number of cells using a point)
+// Note: the links of polydata and unstructured grids are built in parallel
+// when more than one thread is available. The number of uses of each point
+// is counted with atomics, a parallel prefix sum of the counts gives the
+// offsets, and the cell ids are then inserted with atomic cursors. As the
+// insertion order depends on the threads, each run of cell ids is finally
+// sorted so that the links are the same as the serial ones: the cells using
+// a point are always listed in increasing order, as in vtkCellLinks.
+
+namespace vtkStaticCellLinksDetail
+{
+
+// Contiguous cells of a legacy cell array, the unit of threaded work.
+struct CellBatch
+{
+  const vtkIdType *Cells;
+  vtkIdType FirstCellId;
+  vtkIdType NumberOfCells;
+};
+
+// Split the cells of a cell array, whose first cell has the id cellId, in
+// batches.
+inline void AddCellBatches(vtkCellArray *cellArray, vtkIdType cellId,
+                           std::vector<CellBatch> &batches)
+{
+  const vtkIdType batchSize = 1000;
+  vtkIdType numCells = cellArray->GetNumberOfCells();
+  const vtkIdType *cell = cellArray->GetPointer();
+  for (vtkIdType i = 0; i < numCells; i += batchSize)
+  {
+    CellBatch batch = { cell, cellId + i,
+                        (numCells - i < batchSize ? numCells - i : batchSize) };
+    batches.push_back(batch);
+    for (vtkIdType j = 0; j < batch.NumberOfCells; ++j)
+    {
+      cell += *cell + 1;
+    }
+  }
+}
+
+// Count the number of uses of each point.
+template <typename TIds>
+struct CountUses
+{
+  const std::vector<CellBatch> &Batches;
+  std::atomic<TIds> *Counts;
+
+  CountUses(const std::vector<CellBatch> &batches, std::atomic<TIds> *counts)
+    : Batches(batches), Counts(counts)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      const CellBatch &batch = this->Batches[b];
+      const vtkIdType *cell = batch.Cells;
+      for (vtkIdType c = 0; c < batch.NumberOfCells; ++c)
+      {
+        vtkIdType npts = *cell++;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          this->Counts[*cell++].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  }
+};
+
+// Insert the cell ids in the runs of their points, Cursors being the next
+// free location of each run.
+template <typename TIds>
+struct InsertCells
+{
+  const std::vector<CellBatch> &Batches;
+  std::atomic<TIds> *Cursors;
+  TIds *Links;
+
+  InsertCells(const std::vector<CellBatch> &batches,
+              std::atomic<TIds> *cursors, TIds *links)
+    : Batches(batches), Cursors(cursors), Links(links)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType b = begin; b < end; ++b)
+    {
+      const CellBatch &batch = this->Batches[b];
+      const vtkIdType *cell = batch.Cells;
+      for (vtkIdType c = 0; c < batch.NumberOfCells; ++c)
+      {
+        vtkIdType npts = *cell++;
+        TIds cellId = static_cast<TIds>(batch.FirstCellId + c);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          this->Links[this->Cursors[*cell++].fetch_add(
+            1, std::memory_order_relaxed)] = cellId;
+        }
+      }
+    }
+  }
+};
+
+// Initialize the cursors to the offsets.
+template <typename TIds>
+struct InitializeCursors
+{
+  const TIds *Offsets;
+  std::atomic<TIds> *Cursors;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      this->Cursors[ptId].store(this->Offsets[ptId],
+                                std::memory_order_relaxed);
+    }
+  }
+};
+
+// Sort the run of cell ids of each point.
+template <typename TIds>
+struct SortLinks
+{
+  const TIds *Offsets;
+  TIds *Links;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      std::sort(this->Links + this->Offsets[ptId],
+                this->Links + this->Offsets[ptId + 1]);
+    }
+  }
+};
+
+}
 
 //----------------------------------------------------------------------------
 // Clean up any previously allocated memory
@@ -43,6 +184,9 @@ Initialize()
     delete [] this->Offsets;
     this->Offsets = nullptr;
   }
+  this->LinksSize = 0;
+  this->NumPts = 0;
+  this->NumCells = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -65,6 +209,7 @@ BuildLinks(vtkDataSet *ds)
   // Any other type of dataset. Generally this is not called as datasets have
   // their own, more efficient ways of getting similar information.
   // Make sure that we clear out previous allocation.
+  this->Initialize();
   this->NumCells = ds->GetNumberOfCells();
   this->NumPts = ds->GetNumberOfPoints();
 
@@ -75,7 +220,7 @@ BuildLinks(vtkDataSet *ds)
   // Traverse data to determine number of uses of each point. Also count the
   // number of links to allocate.
   this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
+  std::fill_n(this->Offsets, this->NumPts+1, 0);
 
   for (this->LinksSize=0, cellId=0; cellId < this->NumCells; cellId++)
   {
@@ -91,17 +236,12 @@ BuildLinks(vtkDataSet *ds)
   // Allocate space for links. Perform prefix sum.
   this->Links = new TIds[this->LinksSize+1];
   this->Links[this->LinksSize] = this->NumPts;
-
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  this->PrefixSum();
 
   // Now build the links. The summation from the prefix sum indicates where
   // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
+  // is incremented, so that it points to the beginning of the next run in
+  // the end. The offsets are then shifted back.
   for ( cellId=0; cellId < this->NumCells; ++cellId )
   {
     ds->GetCellPoints(cellId,cellPts);
@@ -109,11 +249,10 @@ BuildLinks(vtkDataSet *ds)
     for (j=0; j<npts; ++j)
     {
       ptId = cellPts->GetId(j);
-      this->Offsets[ptId]--;
-      this->Links[this->Offsets[ptId]] = cellId;
+      this->Links[this->Offsets[ptId]++] = cellId;
     }
   }
-  this->Offsets[this->NumPts] = this->LinksSize;
+  this->ShiftOffsets();
 
   cellPts->Delete();
 }
@@ -123,150 +262,161 @@ BuildLinks(vtkDataSet *ds)
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkUnstructuredGrid *ugrid)
 {
-  // Basic information about the grid
-  this->NumCells = ugrid->GetNumberOfCells();
-  this->NumPts = ugrid->GetNumberOfPoints();
-
-  // We're going to get into the guts of the class
   vtkCellArray *cellArray = ugrid->GetCells();
-  const vtkIdType *cells = cellArray->GetPointer();
-
-  // I love this trick: the size of the Links array is equal to
-  // the size of the cell array, minus the number of cells.
-  this->LinksSize =
-    cellArray->GetNumberOfConnectivityEntries() - this->NumCells;
-
-  // Extra one allocated to simplify later pointer manipulation
-  this->Links = new TIds[this->LinksSize+1];
-  this->Links[this->LinksSize] = this->NumPts;
-  this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
-
-  // Now create the links.
-  vtkIdType npts, cellId, ptId;
-  const vtkIdType *cell=cells;
-  int i;
-
-  // Count number of point uses
-  for ( cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell++]++;
-    }
-  }
-
-  // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
-
-  // Now build the links. The summation from the prefix sum indicates where
-  // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( cell=cells, cellId=0; cellId < this->NumCells; ++cellId )
-  {
-    npts = *cell++;
-    for (i=0; i<npts; ++i)
-    {
-      this->Offsets[*cell]--;
-      this->Links[this->Offsets[*cell++]] = cellId;
-    }
-  }
-  this->Offsets[this->NumPts] = this->LinksSize;
+  this->BuildLinks(ugrid->GetNumberOfPoints(), &cellArray, 1);
 }
 
 //----------------------------------------------------------------------------
 // Build the link list array for poly data. This is more complex because there
-// are potentially fout different cell arrays to contend with.
+// are potentially four different cell arrays to contend with.
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
-  // Basic information about the grid
-  this->NumCells = pd->GetNumberOfCells();
-  this->NumPts = pd->GetNumberOfPoints();
-
-  vtkCellArray *cellArrays[4];
-  vtkIdType numCells[4];
-  vtkIdType sizes[4];
-  int i, j;
+  vtkCellArray *cellArrays[4] = { pd->GetVerts(), pd->GetLines(),
+                                  pd->GetPolys(), pd->GetStrips() };
+  this->BuildLinks(pd->GetNumberOfPoints(), cellArrays, 4);
+}
 
-  cellArrays[0] = pd->GetVerts();
-  cellArrays[1] = pd->GetLines();
-  cellArrays[2] = pd->GetPolys();
-  cellArrays[3] = pd->GetStrips();
+//----------------------------------------------------------------------------
+// Build the link list array from cell arrays, the ids of the cells of each
+// array following the ones of the previous array.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+BuildLinks(vtkIdType numPts, vtkCellArray **cellArrays, int numCellArrays)
+{
+  this->Initialize();
+  this->NumPts = numPts;
 
-  for (i=0; i<4; ++i)
+  // I love this trick: the size of the Links array is equal to
+  // the size of the cell array, minus the number of cells. The legacy layout
+  // of offsets storage is built before any thread reads it.
+  vtkIdType numCells = 0, linksSize = 0;
+  const vtkIdType *cells[4] = { nullptr, nullptr, nullptr, nullptr };
+  vtkIdType cellArraySizes[4] = { 0, 0, 0, 0 };
+  for (int i=0; i < numCellArrays; ++i)
   {
     if ( cellArrays[i] != nullptr )
     {
-      numCells[i] = cellArrays[i]->GetNumberOfCells();
-      sizes[i] = cellArrays[i]->GetNumberOfConnectivityEntries() - numCells[i];
+      cells[i] = cellArrays[i]->GetPointer();
+      cellArraySizes[i] = cellArrays[i]->GetNumberOfCells();
+      numCells += cellArraySizes[i];
+      linksSize +=
+        cellArrays[i]->GetNumberOfConnectivityEntries() - cellArraySizes[i];
     }
-    else
-    {
-      numCells[i] = 0;
-      sizes[i] = 0;
-    }
-  }//for the four polydata arrays
+  }
+  this->NumCells = numCells;
+  this->LinksSize = linksSize;
 
-  // Allocate
-  this->LinksSize = sizes[0] + sizes[1] + sizes[2] + sizes[3];
+  // Extra one allocated to simplify later pointer manipulation
   this->Links = new TIds[this->LinksSize+1];
   this->Links[this->LinksSize] = this->NumPts;
   this->Offsets = new TIds[this->NumPts+1];
-  this->Offsets[this->NumPts] = this->LinksSize;
-  std::fill_n(this->Offsets, this->NumPts, 0);
 
-  // Now create the links.
-  vtkIdType npts, cellId, CellId, ptId;
-  const vtkIdType *cell;
+  if ( this->LinksSize > 10000 )
+  {
+    std::vector<vtkStaticCellLinksDetail::CellBatch> batches;
+    vtkIdType firstCellId = 0;
+    for (int i=0; i < numCellArrays; firstCellId += cellArraySizes[i++])
+    {
+      if ( cells[i] != nullptr )
+      {
+        vtkStaticCellLinksDetail::AddCellBatches(cellArrays[i], firstCellId,
+                                                 batches);
+      }
+    }
+    vtkIdType numBatches = static_cast<vtkIdType>(batches.size());
+
+    // Count the point uses, their prefix sum gives the offsets.
+    std::atomic<TIds> *counts = new std::atomic<TIds>[this->NumPts];
+    vtkSMPTools::Fill(counts, counts + this->NumPts, 0);
+    vtkStaticCellLinksDetail::CountUses<TIds> countUses(batches, counts);
+    vtkSMPTools::For(0, numBatches, countUses);
+    this->Offsets[this->NumPts] = vtkSMPTools::ExclusiveScan(
+      counts, counts + this->NumPts, this->Offsets, static_cast<TIds>(0));
+
+    // Insert the cell ids, then sort the runs.
+    vtkStaticCellLinksDetail::InitializeCursors<TIds> initialize =
+      { this->Offsets, counts };
+    vtkSMPTools::For(0, this->NumPts, initialize);
+    vtkStaticCellLinksDetail::InsertCells<TIds> insert(batches, counts,
+                                                       this->Links);
+    vtkSMPTools::For(0, numBatches, insert);
+    delete [] counts;
+    vtkStaticCellLinksDetail::SortLinks<TIds> sort =
+      { this->Offsets, this->Links };
+    vtkSMPTools::For(0, this->NumPts, sort);
+    return;
+  }
 
-  // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
+  // Serial build. Count number of point uses.
+  vtkIdType npts, cellId, i;
+  const vtkIdType *cell;
+  int j;
+  std::fill_n(this->Offsets, this->NumPts+1, 0);
+  for ( j=0; j < numCellArrays; ++j )
   {
-    // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
+    cell = cells[j];
+    for ( cellId=0; cellId < cellArraySizes[j]; ++cellId )
     {
       npts = *cell++;
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[CellId+(*cell++)]++;
+        this->Offsets[*cell++]++;
       }
     }
-    CellId += numCells[j];
-  } //for each of the four polydata cell arrays
+  }
 
   // Perform prefix sum
-  for ( ptId=0; ptId < this->NumPts; ++ptId )
-  {
-    npts = this->Offsets[ptId+1];
-    this->Offsets[ptId+1] = this->Offsets[ptId] + npts;
-  }
+  this->PrefixSum();
 
   // Now build the links. The summation from the prefix sum indicates where
   // the cells are to be inserted. Each time a cell is inserted, the offset
-  // is decremented. In the end, the offset array is also constructed as it
-  // points to the beginning of each cell run.
-  for ( CellId=0, j=0; j < 4; ++j )
+  // is incremented, so that it points to the beginning of the next run in
+  // the end. The offsets are then shifted back.
+  vtkIdType CellId = 0;
+  for ( j=0; j < numCellArrays; ++j )
   {
-    cell = cellArrays[j]->GetPointer();
-    for ( cellId=0; cellId < numCells[j]; ++cellId )
+    cell = cells[j];
+    for ( cellId=0; cellId < cellArraySizes[j]; ++cellId, ++CellId )
     {
       npts = *cell++;
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
+        this->Links[this->Offsets[*cell++]++] = CellId;
       }
     }
-    CellId += numCells[j];
-  }//for each of the four polydata arrays
+  }
+  this->ShiftOffsets();
+}
+
+//----------------------------------------------------------------------------
+// Replace the counts of point uses by their exclusive prefix sum.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+PrefixSum()
+{
+  TIds sum = 0;
+  for ( vtkIdType ptId=0; ptId < this->NumPts; ++ptId )
+  {
+    TIds count = this->Offsets[ptId];
+    this->Offsets[ptId] = sum;
+    sum += count;
+  }
+  this->Offsets[this->NumPts] = sum;
+}
+
+//----------------------------------------------------------------------------
+// Once the links are inserted, each offset points to the beginning of the
+// run of the next point: shift them back.
+template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
+ShiftOffsets()
+{
+  for ( vtkIdType ptId=this->NumPts-1; ptId > 0; --ptId )
+  {
+    this->Offsets[ptId] = this->Offsets[ptId-1];
+  }
+  if ( this->NumPts > 0 )
+  {
+    this->Offsets[0] = 0;
+  }
   this->Offsets[this->NumPts] = this->LinksSize;
 }
 
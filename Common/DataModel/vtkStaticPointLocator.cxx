@@ -15,7 +15,9 @@
 #include "vtkStaticPointLocator.h"
 
 #include "vtkCellArray.h"
+#include "vtkDoubleArray.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
@@ -24,8 +26,10 @@
 #include "vtkBoundingBox.h"
 #include "vtkBox.h"
 #include "vtkLine.h"
+#include "vtkSMPThreadLocal.h"
 #include "vtkSMPTools.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkStandardNewMacro(vtkStaticPointLocator);
@@ -422,6 +426,32 @@ public:
     {return Bucket < tuple.Bucket;}
 };
 
+namespace {
+//-----------------------------------------------------------------------------
+// Obtaining closest points requires sorting nearby points
+class IdTuple
+{
+public:
+  vtkIdType PtId;
+  double    Dist2;
+
+  bool operator< (const IdTuple& tuple) const
+    {return Dist2 < tuple.Dist2;}
+};
+
+// Replace the farthest of N sorted tuples with a closer point, keeping the
+// tuples sorted.
+void InsertClosest(IdTuple *res, int N, vtkIdType ptId, double dist2)
+{
+  IdTuple t;
+  t.PtId = ptId;
+  t.Dist2 = dist2;
+  IdTuple *pos = std::upper_bound(res, res+N-1, t);
+  std::move_backward(pos, res+N-1, res+N);
+  *pos = t;
+}
+}
+
 
 //-----------------------------------------------------------------------------
 // This templates class manages the creation of the static locator
@@ -484,11 +514,20 @@ public:
                                          double inputDataLength, double& dist2);
   void FindClosestNPoints(int N, const double x[3], vtkIdList *result);
   void FindPointsWithinRadius(double R, const double x[3], vtkIdList *result);
+  void FindClosestNPoints(int N, vtkDataArray *queryPoints,
+                          vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+                          vtkDoubleArray *dist2);
+  void FindPointsWithinRadius(double R, vtkDataArray *queryPoints,
+                              vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+                              vtkDoubleArray *dist2);
   int IntersectWithLine(double a0[3], double a1[3], double tol, double& t,
                         double lineX[3], double ptX[3], vtkIdType &ptId);
   void GenerateRepresentation(int vtkNotUsed(level), vtkPolyData *pd);
 
   // Internal methods
+  int FindClosestNPoints(int N, const double x[3], IdTuple *res);
+  template <typename TVisitor>
+  void VisitPointsWithinRadius(double R, const double x[3], TVisitor &visit);
   void GetOverlappingBuckets(NeighborBuckets* buckets, const double x[3],
                              const int ijk[3], double dist, int level);
   void GetOverlappingBuckets(NeighborBuckets* buckets,const double x[3],
@@ -622,7 +661,7 @@ public:
   {
     // Place each point in a bucket
     //
-    vtkPointSet *ps=static_cast<vtkPointSet *>(this->DataSet);
+    vtkPointSet *ps=vtkPointSet::SafeDownCast(this->DataSet);
     int mapped=0;
     if ( ps )
     {//map points array: explicit points representation
@@ -910,23 +949,12 @@ FindClosestPointWithinRadius(double radius, const double x[3],
   return closest;
 }
 
-namespace {
 //-----------------------------------------------------------------------------
-// Obtaining closest points requires sorting nearby points
-class IdTuple
-{
-public:
-  vtkIdType PtId;
-  double    Dist2;
-
-  bool operator< (const IdTuple& tuple) const
-    {return Dist2 < tuple.Dist2;}
-};
-}
-
-//-----------------------------------------------------------------------------
-template <typename TIds> void BucketList<TIds>::
-FindClosestNPoints(int N, const double x[3], vtkIdList *result)
+// Gather the closest N points into res, which must hold N tuples, sorted
+// from closest to farthest. Returns the number of points found, which is N
+// unless there are fewer points in the locator.
+template <typename TIds> int BucketList<TIds>::
+FindClosestNPoints(int N, const double x[3], IdTuple *res)
 {
   int i, j;
   double dist2;
@@ -937,9 +965,6 @@ FindClosestNPoints(int N, const double x[3], vtkIdList *result)
   NeighborBuckets buckets;
   const LocatorTuple<TIds> *ids;
 
-  // Clear out any previous results
-  result->Reset();
-
   //  Find the bucket the point is in.
   //
   this->GetBucketIndices(x, ijk);
@@ -950,7 +975,6 @@ FindClosestNPoints(int N, const double x[3], vtkIdList *result)
   level = 0;
   double maxDistance = 0.0;
   int currentCount = 0;
-  IdTuple *res = new IdTuple [N];
 
   this->GetBucketNeighbors (&buckets, ijk, this->Divisions, level);
   while (buckets.GetNumberOfNeighbors() && currentCount < N)
@@ -984,9 +1008,7 @@ FindClosestNPoints(int N, const double x[3], vtkIdList *result)
           }
           else if (dist2 < maxDistance)
           {
-            res[N-1].Dist2 = dist2;
-            res[N-1].PtId = ptId;
-            std::sort(res, res+N);
+            InsertClosest(res, N, ptId, dist2);
             maxDistance = res[N-1].Dist2;
           }
         }
@@ -999,6 +1021,12 @@ FindClosestNPoints(int N, const double x[3], vtkIdList *result)
   // do a sort
   std::sort(res, res+currentCount);
 
+  // All points have been gathered if there are fewer than N of them
+  if ( currentCount < N )
+  {
+    return currentCount;
+  }
+
   // Now do the refinement
   this->GetOverlappingBuckets (&buckets, x, ijk, sqrt(maxDistance),level-1);
 
@@ -1017,18 +1045,33 @@ FindClosestNPoints(int N, const double x[3], vtkIdList *result)
         dist2 = vtkMath::Distance2BetweenPoints(x,pt);
         if (dist2 < maxDistance)
         {
-          res[N-1].Dist2 = dist2;
-          res[N-1].PtId = ptId;
-          std::sort(res, res+N);
+          InsertClosest(res, N, ptId, dist2);
           maxDistance = res[N-1].Dist2;
         }
       }
     }
   }
 
+  return currentCount;
+}
+
+//-----------------------------------------------------------------------------
+template <typename TIds> void BucketList<TIds>::
+FindClosestNPoints(int N, const double x[3], vtkIdList *result)
+{
+  // Clear out any previous results
+  result->Reset();
+  if ( N <= 0 )
+  {
+    return;
+  }
+
+  IdTuple *res = new IdTuple [N];
+  int numFound = this->FindClosestNPoints(N, x, res);
+
   // Fill in the IdList
-  result->SetNumberOfIds(currentCount);
-  for (i = 0; i < currentCount; i++)
+  result->SetNumberOfIds(numFound);
+  for (int i = 0; i < numFound; i++)
   {
     result->SetId(i,res[i].PtId);
   }
@@ -1038,9 +1081,10 @@ FindClosestNPoints(int N, const double x[3], vtkIdList *result)
 
 //-----------------------------------------------------------------------------
 // The Radius defines a block of buckets which the sphere of radis R may
-// touch.
-template <typename TIds> void BucketList<TIds>::
-FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
+// touch. The visitor is invoked with the id and squared distance of each
+// point within the sphere.
+template <typename TIds> template <typename TVisitor> void BucketList<TIds>::
+VisitPointsWithinRadius(double R, const double x[3], TVisitor &visit)
 {
   double dist2;
   double pt[3];
@@ -1062,10 +1106,7 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
   this->GetBucketIndices(xMin, ijkMin);
   this->GetBucketIndices(xMax, ijkMax);
 
-  // Clear out previous results
-  result->Reset();
-
-  // Add points within footprint and radius
+  // Visit points within footprint and radius
   for ( k=ijkMin[2]; k <= ijkMax[2]; ++k)
   {
     kOffset = k*this->xyD;
@@ -1086,7 +1127,7 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
             dist2 = vtkMath::Distance2BetweenPoints(x,pt);
             if (dist2 <= R2)
             {
-              result->InsertNextId(ptId);
+              visit(ptId, dist2);
             }
           }//for all points in bucket
         }//if points in bucket
@@ -1095,6 +1136,215 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
   }//k-footprint
 }
 
+namespace {
+// Visitors collecting the points found by VisitPointsWithinRadius().
+struct InsertPointId
+{
+  vtkIdList *Result;
+
+  void operator()(vtkIdType ptId, double)
+  {
+    this->Result->InsertNextId(ptId);
+  }
+};
+
+struct AppendIdTuple
+{
+  std::vector<IdTuple> *Result;
+
+  void operator()(vtkIdType ptId, double dist2)
+  {
+    IdTuple t;
+    t.PtId = ptId;
+    t.Dist2 = dist2;
+    this->Result->push_back(t);
+  }
+};
+}
+
+//-----------------------------------------------------------------------------
+template <typename TIds> void BucketList<TIds>::
+FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
+{
+  // Clear out previous results
+  result->Reset();
+
+  InsertPointId insert = { result };
+  this->VisitPointsWithinRadius(R, x, insert);
+}
+
+namespace {
+// Threaded batched queries. Each thread answers its range of queries into a
+// thread local buffer which is reused, so no memory is allocated per query.
+template <typename TBucketList>
+struct ClosestNPointsQueries
+{
+  TBucketList *BList;
+  vtkDataArray *QueryPoints;
+  int N;
+  int NumFound;
+  vtkIdType *Ids;
+  double *Dist2;
+  vtkSMPThreadLocal<std::vector<IdTuple>> Results;
+
+  ClosestNPointsQueries(TBucketList *blist, vtkDataArray *queryPoints, int n,
+                        int numFound, vtkIdType *ids, double *dist2) :
+    BList(blist), QueryPoints(queryPoints), N(n), NumFound(numFound),
+    Ids(ids), Dist2(dist2)
+  {
+  }
+
+  void operator()(vtkIdType query, vtkIdType endQuery)
+  {
+    std::vector<IdTuple> &res = this->Results.Local();
+    res.resize(this->N);
+    double x[3];
+    for ( ; query < endQuery; ++query )
+    {
+      this->QueryPoints->GetTuple(query, x);
+      this->BList->FindClosestNPoints(this->N, x, res.data());
+      vtkIdType offset = query * this->NumFound;
+      for (int i = 0; i < this->NumFound; ++i)
+      {
+        this->Ids[offset + i] = res[i].PtId;
+        if ( this->Dist2 )
+        {
+          this->Dist2[offset + i] = res[i].Dist2;
+        }
+      }
+    }
+  }
+};
+
+// The number of points found within the radius varies, so the queries are
+// processed in batches, each collecting its points and the number found per
+// query. The offsets then follow from a prefix sum, and the batches are
+// copied into place.
+const vtkIdType RadiusQueriesBatchSize = 1024;
+
+template <typename TBucketList>
+struct PointsWithinRadiusQueries
+{
+  TBucketList *BList;
+  vtkDataArray *QueryPoints;
+  double R;
+  vtkIdType NumQueries;
+  vtkIdType *Offsets;
+  std::vector<IdTuple> *BatchResults;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    double x[3];
+    for ( ; batch < endBatch; ++batch )
+    {
+      std::vector<IdTuple> &res = this->BatchResults[batch];
+      AppendIdTuple append = { &res };
+      vtkIdType query = batch * RadiusQueriesBatchSize;
+      vtkIdType endQuery = std::min(query + RadiusQueriesBatchSize,
+                                    this->NumQueries);
+      for ( ; query < endQuery; ++query )
+      {
+        vtkIdType numFound = static_cast<vtkIdType>(res.size());
+        this->QueryPoints->GetTuple(query, x);
+        this->BList->VisitPointsWithinRadius(this->R, x, append);
+        this->Offsets[query] = static_cast<vtkIdType>(res.size()) - numFound;
+      }
+    }
+  }
+};
+
+struct CopyRadiusQueries
+{
+  const vtkIdType *Offsets;
+  std::vector<IdTuple> *BatchResults;
+  vtkIdType *Ids;
+  double *Dist2;
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    for ( ; batch < endBatch; ++batch )
+    {
+      const std::vector<IdTuple> &res = this->BatchResults[batch];
+      vtkIdType offset = this->Offsets[batch * RadiusQueriesBatchSize];
+      for (size_t i = 0; i < res.size(); ++i)
+      {
+        this->Ids[offset + i] = res[i].PtId;
+        if ( this->Dist2 )
+        {
+          this->Dist2[offset + i] = res[i].Dist2;
+        }
+      }
+      std::vector<IdTuple>().swap(this->BatchResults[batch]);
+    }
+  }
+};
+}
+
+//-----------------------------------------------------------------------------
+template <typename TIds> void BucketList<TIds>::
+FindClosestNPoints(int N, vtkDataArray *queryPoints, vtkIdTypeArray *offsets,
+                   vtkIdTypeArray *ids, vtkDoubleArray *dist2)
+{
+  // Every query finds the same number of points
+  vtkIdType numQueries = queryPoints->GetNumberOfTuples();
+  int numFound = ( N <= 0 ? 0 :
+                   static_cast<int>(std::min<vtkIdType>(N, this->NumPts)) );
+
+  offsets->SetNumberOfTuples(numQueries + 1);
+  vtkIdType *o = offsets->GetPointer(0);
+  for (vtkIdType query = 0; query <= numQueries; ++query)
+  {
+    o[query] = query * numFound;
+  }
+  ids->SetNumberOfTuples(numQueries * numFound);
+  if ( dist2 )
+  {
+    dist2->SetNumberOfTuples(numQueries * numFound);
+  }
+  if ( numFound == 0 )
+  {
+    return;
+  }
+
+  ClosestNPointsQueries<BucketList<TIds>> queries(
+    this, queryPoints, N, numFound, ids->GetPointer(0),
+    ( dist2 ? dist2->GetPointer(0) : nullptr ));
+  vtkSMPTools::For(0, numQueries, queries);
+}
+
+//-----------------------------------------------------------------------------
+template <typename TIds> void BucketList<TIds>::
+FindPointsWithinRadius(double R, vtkDataArray *queryPoints,
+                       vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+                       vtkDoubleArray *dist2)
+{
+  vtkIdType numQueries = queryPoints->GetNumberOfTuples();
+  vtkIdType numBatches =
+    (numQueries + RadiusQueriesBatchSize - 1) / RadiusQueriesBatchSize;
+  std::vector<std::vector<IdTuple>> batchResults(numBatches);
+
+  // Find the points and count them per query
+  offsets->SetNumberOfTuples(numQueries + 1);
+  vtkIdType *o = offsets->GetPointer(0);
+  PointsWithinRadiusQueries<BucketList<TIds>> queries =
+    { this, queryPoints, R, numQueries, o, batchResults.data() };
+  vtkSMPTools::For(0, numBatches, queries);
+
+  // Turn the counts into offsets, then copy the points found
+  vtkIdType numIds = vtkSMPTools::ExclusiveScan(o, o + numQueries, o,
+                                                static_cast<vtkIdType>(0));
+  o[numQueries] = numIds;
+  ids->SetNumberOfTuples(numIds);
+  if ( dist2 )
+  {
+    dist2->SetNumberOfTuples(numIds);
+  }
+
+  CopyRadiusQueries copy = { o, batchResults.data(), ids->GetPointer(0),
+                             ( dist2 ? dist2->GetPointer(0) : nullptr ) };
+  vtkSMPTools::For(0, numBatches, copy);
+}
+
 //-----------------------------------------------------------------------------
 // Find the point within tol of the finite line, and closest to the starting
 // point of the line (i.e., min parametric coordinate t).
@@ -1740,6 +1990,83 @@ FindPointsWithinRadius(double R, const double x[3], vtkIdList *result)
   }
 }
 
+//-----------------------------------------------------------------------------
+void vtkStaticPointLocator::
+FindClosestNPoints(int N, vtkDataArray *queryPoints, vtkIdTypeArray *offsets,
+                   vtkIdTypeArray *ids, vtkDoubleArray *dist2)
+{
+  if ( !queryPoints || queryPoints->GetNumberOfComponents() != 3 ||
+       !offsets || !ids )
+  {
+    vtkErrorMacro("Batched queries need three component query points and "
+                  "output offsets and ids arrays");
+    return;
+  }
+
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  if ( !this->Buckets )
+  {
+    offsets->SetNumberOfTuples(queryPoints->GetNumberOfTuples() + 1);
+    offsets->Fill(0);
+    ids->SetNumberOfTuples(0);
+    if ( dist2 )
+    {
+      dist2->SetNumberOfTuples(0);
+    }
+    return;
+  }
+
+  if ( this->LargeIds )
+  {
+    static_cast<BucketList<vtkIdType>*>(this->Buckets)->
+      FindClosestNPoints(N,queryPoints,offsets,ids,dist2);
+  }
+  else
+  {
+    static_cast<BucketList<int>*>(this->Buckets)->
+      FindClosestNPoints(N,queryPoints,offsets,ids,dist2);
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkStaticPointLocator::
+FindPointsWithinRadius(double R, vtkDataArray *queryPoints,
+                       vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+                       vtkDoubleArray *dist2)
+{
+  if ( !queryPoints || queryPoints->GetNumberOfComponents() != 3 ||
+       !offsets || !ids )
+  {
+    vtkErrorMacro("Batched queries need three component query points and "
+                  "output offsets and ids arrays");
+    return;
+  }
+
+  this->BuildLocator(); // will subdivide if modified; otherwise returns
+  if ( !this->Buckets )
+  {
+    offsets->SetNumberOfTuples(queryPoints->GetNumberOfTuples() + 1);
+    offsets->Fill(0);
+    ids->SetNumberOfTuples(0);
+    if ( dist2 )
+    {
+      dist2->SetNumberOfTuples(0);
+    }
+    return;
+  }
+
+  if ( this->LargeIds )
+  {
+    static_cast<BucketList<vtkIdType>*>(this->Buckets)->
+      FindPointsWithinRadius(R,queryPoints,offsets,ids,dist2);
+  }
+  else
+  {
+    static_cast<BucketList<int>*>(this->Buckets)->
+      FindPointsWithinRadius(R,queryPoints,offsets,ids,dist2);
+  }
+}
+
 //-----------------------------------------------------------------------------
 // This method traverses the locator along the defined ray, finding the
 // closest point to a0 when projected onto the line (a0,a1) (i.e., min
@@ -53,7 +53,10 @@
 #include "vtkCommonDataModelModule.h" // For export macro
 #include "vtkAbstractPointLocator.h"
 
+class vtkDataArray;
+class vtkDoubleArray;
 class vtkIdList;
+class vtkIdTypeArray;
 class vtkBucketList;
 
 
@@ -145,6 +148,26 @@ public:
   void FindPointsWithinRadius(double R, const double x[3],
                               vtkIdList *result) override;
 
+  //@{
+  /**
+   * Batched versions of FindClosestNPoints() and FindPointsWithinRadius():
+   * the query positions are the tuples of the three component array
+   * queryPoints, and the queries are answered in parallel using vtkSMPTools.
+   * The ids found for query i are ids[offsets[i]] through
+   * ids[offsets[i+1]-1] (offsets has one more value than there are queries),
+   * in the same order as the single query methods return them. If dist2 is
+   * given, it receives the squared distance between each point found and its
+   * query position. The locator is built first if needed; these methods
+   * should be called from a single thread.
+   */
+  void FindClosestNPoints(int N, vtkDataArray *queryPoints,
+                          vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+                          vtkDoubleArray *dist2=nullptr);
+  void FindPointsWithinRadius(double R, vtkDataArray *queryPoints,
+                              vtkIdTypeArray *offsets, vtkIdTypeArray *ids,
+                              vtkDoubleArray *dist2=nullptr);
+  //@}
+
   /**
    * Intersect the points contained in the locator with the line defined by
    * (a0,a1). Return the point within the tolerance tol that is closest to a0
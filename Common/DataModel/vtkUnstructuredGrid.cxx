@@ -47,6 +47,7 @@
 #include "vtkQuadraticEdge.h"
 #include "vtkQuadraticHexahedron.h"
 #include "vtkQuadraticWedge.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkQuadraticPolygon.h"
 #include "vtkQuadraticPyramid.h"
 #include "vtkQuadraticQuad.h"
@@ -124,6 +125,7 @@ vtkUnstructuredGrid::vtkUnstructuredGrid ()
 
   this->Connectivity = nullptr;
   this->Links = nullptr;
+  this->StaticLinks = nullptr;
   this->Types = nullptr;
   this->Locations = nullptr;
 
@@ -398,6 +400,19 @@ void vtkUnstructuredGrid::CopyStructure(vtkDataSet *ds)
       }
     }
 
+    if (this->StaticLinks != ug->StaticLinks)
+    {
+      if ( this->StaticLinks )
+      {
+        this->StaticLinks->UnRegister(this);
+      }
+      this->StaticLinks = ug->StaticLinks;
+      if (this->StaticLinks)
+      {
+        this->StaticLinks->Register(this);
+      }
+    }
+
     if (this->Types != ug->Types)
     {
       if ( this->Types )
@@ -469,6 +484,12 @@ void vtkUnstructuredGrid::Cleanup()
     this->Links = nullptr;
   }
 
+  if ( this->StaticLinks )
+  {
+    this->StaticLinks->UnRegister(this);
+    this->StaticLinks = nullptr;
+  }
+
   if ( this->Types )
   {
     this->Types->UnRegister(this);
@@ -1388,12 +1409,41 @@ void vtkUnstructuredGrid::BuildLinks()
   if (this->Links)
   {
     this->Links->UnRegister(this);
+    this->Links = nullptr;
+  }
+  if (this->StaticLinks)
+  {
+    this->StaticLinks->UnRegister(this);
+  }
+
+  this->StaticLinks = vtkStaticCellLinks::New();
+  this->StaticLinks->Register(this);
+  this->StaticLinks->BuildLinks(this);
+  this->StaticLinks->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Create editable links, converting the static links if they are built.
+void vtkUnstructuredGrid::BuildEditableLinks()
+{
+  if (this->Links)
+  {
+    return;
   }
 
   this->Links = vtkCellLinks::New();
-  this->Links->Allocate(this->GetNumberOfPoints());
   this->Links->Register(this);
-  this->Links->BuildLinks(this, this->Connectivity);
+  if (this->StaticLinks)
+  {
+    this->Links->BuildLinks(this->StaticLinks);
+    this->StaticLinks->UnRegister(this);
+    this->StaticLinks = nullptr;
+  }
+  else
+  {
+    this->Links->Allocate(this->GetNumberOfPoints());
+    this->Links->BuildLinks(this, this->Connectivity);
+  }
   this->Links->Delete();
 }
 
@@ -1484,17 +1534,12 @@ void vtkUnstructuredGrid::GetFaceStream(vtkIdType cellId, vtkIdType& nfaces,
 void vtkUnstructuredGrid::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
 {
   vtkIdType *cells;
-  int numCells;
-  int i;
+  vtkIdType numCells;
+  vtkIdType i;
 
-  if ( ! this->Links )
-  {
-    this->BuildLinks();
-  }
   cellIds->Reset();
 
-  numCells = this->Links->GetNcells(ptId);
-  cells = this->Links->GetCells(ptId);
+  this->GetPointCells(ptId, numCells, cells);
 
   cellIds->SetNumberOfIds(numCells);
   for (i=0; i < numCells; i++)
@@ -1503,6 +1548,27 @@ void vtkUnstructuredGrid::GetPointCells(vtkIdType ptId, vtkIdList *cellIds)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::GetPointCells(vtkIdType ptId, vtkIdType& ncells,
+                                        vtkIdType* &cells)
+{
+  if ( ! this->Links && ! this->StaticLinks )
+  {
+    this->BuildLinks();
+  }
+
+  if ( this->StaticLinks )
+  {
+    ncells = this->StaticLinks->GetNumberOfCells(ptId);
+    cells = const_cast<vtkIdType*>(this->StaticLinks->GetCells(ptId));
+  }
+  else
+  {
+    ncells = this->Links->GetNcells(ptId);
+    cells = this->Links->GetCells(ptId);
+  }
+}
+
 //----------------------------------------------------------------------------
 vtkCellIterator *vtkUnstructuredGrid::NewCellIterator()
 {
@@ -1518,6 +1584,11 @@ void vtkUnstructuredGrid::Reset()
   {
     this->Connectivity->Reset();
   }
+  if ( this->StaticLinks )
+  {
+    this->StaticLinks->UnRegister(this);
+    this->StaticLinks = nullptr;
+  }
   if ( this->Links )
   {
     this->Links->Reset();
@@ -1579,7 +1650,7 @@ void vtkUnstructuredGrid::Squeeze()
 void vtkUnstructuredGrid::RemoveReferenceToCell(vtkIdType ptId,
                                                 vtkIdType cellId)
 {
-  this->Links->RemoveCellReference(cellId, ptId);
+  this->GetEditableLinks()->RemoveCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1589,7 +1660,7 @@ void vtkUnstructuredGrid::RemoveReferenceToCell(vtkIdType ptId,
 // operator ResizeCellList() to do this if necessary.
 void vtkUnstructuredGrid::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 {
-  this->Links->AddCellReference(cellId, ptId);
+  this->GetEditableLinks()->AddCellReference(cellId, ptId);
 }
 
 //----------------------------------------------------------------------------
@@ -1597,7 +1668,7 @@ void vtkUnstructuredGrid::AddReferenceToCell(vtkIdType ptId, vtkIdType cellId)
 // that BuildLinks() has been called.)
 void vtkUnstructuredGrid::ResizeCellList(vtkIdType ptId, int size)
 {
-  this->Links->ResizeCellList(ptId,size);
+  this->GetEditableLinks()->ResizeCellList(ptId,size);
 }
 
 //----------------------------------------------------------------------------
@@ -1622,13 +1693,14 @@ vtkIdType vtkUnstructuredGrid::InsertNextLinkedCell(int type, int npts,
                                                     vtkIdType *pts)
 {
   vtkIdType i, id;
+  vtkCellLinks *links = this->GetEditableLinks();
 
   id = this->InsertNextCell(type,npts,pts);
 
   for (i=0; i<npts; i++)
   {
-    this->Links->ResizeCellList(pts[i],1);
-    this->Links->AddCellReference(id,pts[i]);
+    links->ResizeCellList(pts[i],1);
+    links->AddCellReference(id,pts[i]);
   }
 
   return id;
@@ -1648,6 +1720,11 @@ unsigned long vtkUnstructuredGrid::GetActualMemorySize()
     size += this->Links->GetActualMemorySize();
   }
 
+  if ( this->StaticLinks )
+  {
+    size += this->StaticLinks->GetActualMemorySize();
+  }
+
   if ( this->Types )
   {
     size += this->Types->GetActualMemorySize();
@@ -1698,6 +1775,16 @@ void vtkUnstructuredGrid::ShallowCopy(vtkDataObject *dataObject)
       this->Links->Register(this);
     }
 
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Delete();
+    }
+    this->StaticLinks = grid->StaticLinks;
+    if (this->StaticLinks)
+    {
+      this->StaticLinks->Register(this);
+    }
+
     if (this->Types)
     {
       this->Types->UnRegister(this);
@@ -1784,6 +1871,11 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
       this->Links->UnRegister(this);
       this->Links = nullptr;
     }
+    if ( this->StaticLinks )
+    {
+      this->StaticLinks->UnRegister(this);
+      this->StaticLinks = nullptr;
+    }
     if ( this->Types )
     {
       this->Types->UnRegister(this);
@@ -1847,7 +1939,7 @@ void vtkUnstructuredGrid::DeepCopy(vtkDataObject *dataObject)
   }
 
   // Finally Build Links if we need to
-  if (grid && grid->Links)
+  if (grid && (grid->Links || grid->StaticLinks))
   {
     this->BuildLinks();
   }
@@ -1872,7 +1964,7 @@ void vtkUnstructuredGrid::PrintSelf(ostream& os, vtkIndent indent)
 void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
                                            vtkIdList *cellIds)
 {
-  if ( ! this->Links )
+  if ( ! this->Links && ! this->StaticLinks )
   {
     this->BuildLinks();
   }
@@ -1888,14 +1980,15 @@ void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
 
   //Find the point used by the fewest number of cells
   vtkIdType *pts = ptIds->GetPointer(0);
-  int minNumCells = VTK_INT_MAX;
+  vtkIdType minNumCells = VTK_ID_MAX;
   vtkIdType *minCells = nullptr;
   vtkIdType minPtId = 0;
   for (vtkIdType i=0; i<numPts; i++)
   {
     vtkIdType ptId = pts[i];
-    int numCells = this->Links->GetNcells(ptId);
-    vtkIdType *cells = this->Links->GetCells(ptId);
+    vtkIdType numCells;
+    vtkIdType *cells;
+    this->GetPointCells(ptId, numCells, cells);
     if ( numCells < minNumCells )
     {
       minNumCells = numCells;
@@ -1907,7 +2000,7 @@ void vtkUnstructuredGrid::GetCellNeighbors(vtkIdType cellId, vtkIdList *ptIds,
   //Now for each cell, see if it contains all the points
   //in the ptIds list.
   bool match;
-  for (int i=0; i<minNumCells; i++)
+  for (vtkIdType i=0; i<minNumCells; i++)
   {
     if ( minCells[i] != cellId ) //don't include current cell
     {
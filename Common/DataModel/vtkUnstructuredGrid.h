@@ -76,6 +76,7 @@ class vtkBiQuadraticQuadraticHexahedron;
 class vtkBiQuadraticTriangle;
 class vtkCubicLine;
 class vtkPolyhedron;
+class vtkStaticCellLinks;
 class vtkIdTypeArray;
 
 class VTKCOMMONDATAMODEL_EXPORT vtkUnstructuredGrid :
@@ -155,8 +156,34 @@ public:
   void Squeeze() override;
   void Initialize() override;
   int GetMaxCellSize() override;
+
+  /**
+   * Create upward links from points to cells that use each point. Compact
+   * static links are built in parallel; they are converted to editable
+   * links the first time the links are modified (e.g., by
+   * RemoveReferenceToCell(), ResizeCellList()...) or by
+   * BuildEditableLinks().
+   */
   void BuildLinks();
+
+  /**
+   * Create editable links, returned by GetCellLinks(), converting the static
+   * links built by BuildLinks() if needed.
+   */
+  void BuildEditableLinks();
+
+  /**
+   * Return the editable links, or nullptr if they are not built. Use
+   * GetPointCells() to read the links built by BuildLinks().
+   */
   vtkCellLinks *GetCellLinks() {return this->Links;};
+
+  /**
+   * Efficient access to the cells using a point, whose ids must not be
+   * modified. The links are built if needed.
+   */
+  void GetPointCells(vtkIdType ptId, vtkIdType& ncells, vtkIdType* &cells);
+
   virtual void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
                              vtkIdType* &pts);
 
@@ -417,6 +444,7 @@ protected:
   // point data (i.e., scalars, vectors, normals, tcoords) inherited
   vtkCellArray *Connectivity;
   vtkCellLinks *Links;
+  vtkStaticCellLinks *StaticLinks; // built instead of Links by BuildLinks()
   vtkUnsignedCharArray *Types;
   vtkIdTypeArray *Locations;
 
@@ -434,6 +462,16 @@ private:
   void operator=(const vtkUnstructuredGrid&) = delete;
 
   void Cleanup();
+
+  // Return the editable links, converting the static links if needed.
+  vtkCellLinks *GetEditableLinks()
+  {
+    if ( this->StaticLinks )
+    {
+      this->BuildEditableLinks();
+    }
+    return this->Links;
+  }
 };
 
 #endif
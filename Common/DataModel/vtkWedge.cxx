@@ -474,6 +474,12 @@ int *vtkWedge::GetEdgeArray(int edgeId)
   return edges[edgeId];
 }
 
+//----------------------------------------------------------------------------
+int *vtkWedge::GetTriangleCases(int caseId)
+{
+  return triCases[caseId].edges;
+}
+
 //----------------------------------------------------------------------------
 vtkCell *vtkWedge::GetEdge(int edgeId)
 {
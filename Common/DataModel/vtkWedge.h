@@ -122,6 +122,14 @@ public:
   static int *GetFaceArray(int faceId) VTK_SIZEHINT(4);
   //@}
 
+  /**
+   * Return the case table for table-based isocontouring. A linear 3D cell
+   * with N vertices has 2**N cases, the case index having bit i set when
+   * vertex i is above the contour value. The returned list gives three edges
+   * (see GetEdgeArray()) per output triangle and is terminated by -1.
+   */
+  static int *GetTriangleCases(int caseId);
+
 protected:
   vtkWedge();
   ~vtkWedge() override;
@@ -0,0 +1,274 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCachedStreamingDemandDrivenPipeline.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Update temporal sources of polydata and of multiblock datasets for several
+// time steps and pieces with the cache bounded by memory, and check that the
+// requests seen before are served without executing the sources, that the
+// least recently used outputs are released, and that modifying a source
+// releases its outputs.
+
+#include "vtkCachedStreamingDemandDrivenPipeline.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+
+namespace
+{
+
+const int NumberOfPoints = 2000;
+
+// The time steps are 0 to 9, and the sources can produce pieces.
+void SetTimeSteps(vtkInformation *outInfo)
+{
+  double times[10];
+  for (int i = 0; i < 10; ++i)
+  {
+    times[i] = i;
+  }
+  double range[2] = { 0.0, 9.0 };
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times, 10);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+  outInfo->Set(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST(), 1);
+}
+
+// The x coordinate of the points is the sum of the requested time step, the
+// piece and the offset.
+void FillPolyData(vtkInformation *outInfo, double offset, vtkPolyData *pdata)
+{
+  double time =
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+  int piece =
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(NumberOfPoints);
+  for (vtkIdType i = 0; i < NumberOfPoints; ++i)
+  {
+    points->SetPoint(i, time + piece + offset, i, 0.0);
+  }
+  pdata->SetPoints(points);
+}
+
+}
+
+class TestCachedPolyDataSource : public vtkPolyDataAlgorithm
+{
+public:
+  static TestCachedPolyDataSource *New();
+  vtkTypeMacro(TestCachedPolyDataSource, vtkPolyDataAlgorithm);
+
+  vtkSetMacro(Offset, double);
+  vtkGetMacro(Executions, int);
+
+protected:
+  TestCachedPolyDataSource() : Offset(0.0), Executions(0)
+  {
+    this->SetNumberOfInputPorts(0);
+  }
+
+  int RequestInformation(vtkInformation *, vtkInformationVector **,
+                         vtkInformationVector *outputVector) override
+  {
+    SetTimeSteps(outputVector->GetInformationObject(0));
+    return 1;
+  }
+
+  int RequestData(vtkInformation *, vtkInformationVector **,
+                  vtkInformationVector *outputVector) override
+  {
+    ++this->Executions;
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    FillPolyData(outInfo, this->Offset, vtkPolyData::GetData(outInfo));
+    return 1;
+  }
+
+  double Offset;
+  int Executions;
+
+private:
+  TestCachedPolyDataSource(const TestCachedPolyDataSource&) = delete;
+  void operator=(const TestCachedPolyDataSource&) = delete;
+};
+vtkStandardNewMacro(TestCachedPolyDataSource);
+
+class TestCachedMultiBlockSource : public vtkMultiBlockDataSetAlgorithm
+{
+public:
+  static TestCachedMultiBlockSource *New();
+  vtkTypeMacro(TestCachedMultiBlockSource, vtkMultiBlockDataSetAlgorithm);
+
+  vtkGetMacro(Executions, int);
+
+protected:
+  TestCachedMultiBlockSource() : Executions(0)
+  {
+    this->SetNumberOfInputPorts(0);
+  }
+
+  int RequestInformation(vtkInformation *, vtkInformationVector **,
+                         vtkInformationVector *outputVector) override
+  {
+    SetTimeSteps(outputVector->GetInformationObject(0));
+    return 1;
+  }
+
+  int RequestData(vtkInformation *, vtkInformationVector **,
+                  vtkInformationVector *outputVector) override
+  {
+    ++this->Executions;
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkMultiBlockDataSet *output = vtkMultiBlockDataSet::GetData(outInfo);
+    output->SetNumberOfBlocks(2);
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      vtkNew<vtkPolyData> block;
+      FillPolyData(outInfo, i, block);
+      output->SetBlock(i, block);
+    }
+    return 1;
+  }
+
+  int Executions;
+
+private:
+  TestCachedMultiBlockSource(const TestCachedMultiBlockSource&) = delete;
+  void operator=(const TestCachedMultiBlockSource&) = delete;
+};
+vtkStandardNewMacro(TestCachedMultiBlockSource);
+
+namespace
+{
+
+int CheckPolyData(vtkPolyData *pdata, double x, const char *label)
+{
+  if (!pdata || pdata->GetNumberOfPoints() != NumberOfPoints ||
+      pdata->GetPoint(NumberOfPoints - 1)[0] != x)
+  {
+    cerr << label << ": wrong output, expected x = " << x << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int CheckExecutions(int executions, int expected, const char *label)
+{
+  if (executions != expected)
+  {
+    cerr << label << ": expected " << expected << " executions, got "
+         << executions << endl;
+    return 1;
+  }
+  return 0;
+}
+
+int TestPolyDataSource()
+{
+  vtkNew<TestCachedPolyDataSource> source;
+  vtkNew<vtkCachedStreamingDemandDrivenPipeline> executive;
+  executive->SetCacheMemoryLimit(10000);
+  source->SetExecutive(executive);
+
+  int rval = 0;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (int t = 0; t < 4; ++t)
+    {
+      source->UpdateTimeStep(t, 0, 1);
+      rval |= CheckPolyData(source->GetOutput(), t, "time steps");
+    }
+    for (int piece = 0; piece < 2; ++piece)
+    {
+      source->UpdateTimeStep(5, piece, 2);
+      rval |= CheckPolyData(source->GetOutput(), 5 + piece, "pieces");
+    }
+  }
+  rval |= CheckExecutions(source->GetExecutions(), 6, "revisited requests");
+  if (executive->GetCacheHits() != 6 || executive->GetCacheMisses() != 6)
+  {
+    cerr << "Expected 6 hits and 6 misses, got " << executive->GetCacheHits()
+         << " and " << executive->GetCacheMisses() << endl;
+    rval = 1;
+  }
+
+  // Modifying the source releases the cached outputs.
+  unsigned long size = executive->GetCacheMemorySize();
+  source->SetOffset(100.0);
+  source->UpdateTimeStep(0, 0, 1);
+  rval |= CheckPolyData(source->GetOutput(), 100.0, "modified source");
+  rval |= CheckExecutions(source->GetExecutions(), 7, "modified source");
+  if (executive->GetCacheMemorySize() * 6 != size)
+  {
+    cerr << "The outputs of the modified source were not released" << endl;
+    rval = 1;
+  }
+
+  // Only two outputs fit in the limit, the least recently used is released.
+  executive->SetCacheMemoryLimit(size / 6 * 2);
+  source->UpdateTimeStep(1, 0, 1);
+  source->UpdateTimeStep(2, 0, 1);
+  source->UpdateTimeStep(1, 0, 1);
+  rval |= CheckExecutions(source->GetExecutions(), 9, "limited cache");
+  source->UpdateTimeStep(0, 0, 1);
+  rval |= CheckPolyData(source->GetOutput(), 100.0, "limited cache");
+  rval |= CheckExecutions(source->GetExecutions(), 10, "released output");
+  source->UpdateTimeStep(1, 0, 1);
+  rval |= CheckPolyData(source->GetOutput(), 101.0, "limited cache");
+  rval |= CheckExecutions(source->GetExecutions(), 10, "kept output");
+  if (executive->GetCacheMemorySize() > executive->GetCacheMemoryLimit())
+  {
+    cerr << "The cache exceeds its memory limit" << endl;
+    rval = 1;
+  }
+  return rval;
+}
+
+int TestMultiBlockSource()
+{
+  vtkNew<TestCachedMultiBlockSource> source;
+  vtkNew<vtkCachedStreamingDemandDrivenPipeline> executive;
+  executive->SetCacheMemoryLimit(10000);
+  source->SetExecutive(executive);
+
+  int rval = 0;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    for (int t = 0; t < 3; ++t)
+    {
+      source->UpdateTimeStep(t);
+      vtkMultiBlockDataSet *output =
+        vtkMultiBlockDataSet::SafeDownCast(source->GetOutputDataObject(0));
+      for (unsigned int i = 0; i < 2; ++i)
+      {
+        rval |= CheckPolyData(vtkPolyData::SafeDownCast(output->GetBlock(i)),
+                              t + i, "multiblock");
+      }
+    }
+  }
+  rval |= CheckExecutions(source->GetExecutions(), 3, "multiblock");
+  return rval;
+}
+
+}
+
+int TestCachedStreamingDemandDrivenPipeline(int, char *[])
+{
+  int rval = TestPolyDataSource();
+  rval |= TestMultiBlockSource();
+  return rval;
+}
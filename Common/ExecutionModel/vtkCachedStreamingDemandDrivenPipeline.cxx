@@ -24,9 +24,175 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+
+#include <list>
+#include <map>
 
 vtkStandardNewMacro(vtkCachedStreamingDemandDrivenPipeline);
 
+//----------------------------------------------------------------------------
+// The outputs cached by request, the most recently used first.
+class vtkCachedStreamingDemandDrivenPipelineInternals
+{
+public:
+  struct Request
+  {
+    int Port;
+    int Piece;
+    int NumberOfPieces;
+    int GhostLevels;
+    int Extent[6];
+    int HasTime;
+    double Time;
+
+    bool operator<(const Request& other) const
+    {
+      const int values[10] = { this->Port, this->Piece, this->NumberOfPieces,
+        this->GhostLevels, this->Extent[0], this->Extent[1], this->Extent[2],
+        this->Extent[3], this->Extent[4], this->Extent[5] };
+      const int otherValues[10] = { other.Port, other.Piece,
+        other.NumberOfPieces, other.GhostLevels, other.Extent[0],
+        other.Extent[1], other.Extent[2], other.Extent[3], other.Extent[4],
+        other.Extent[5] };
+      for (int i = 0; i < 10; ++i)
+      {
+        if (values[i] != otherValues[i])
+        {
+          return values[i] < otherValues[i];
+        }
+      }
+      if (this->HasTime != other.HasTime)
+      {
+        return this->HasTime < other.HasTime;
+      }
+      return this->HasTime && this->Time < other.Time;
+    }
+  };
+
+  struct Entry
+  {
+    Request Key;
+    vtkSmartPointer<vtkDataObject> Data;
+    vtkMTimeType Time;
+    unsigned long Size;
+  };
+
+  typedef std::list<Entry> EntryList;
+
+  vtkCachedStreamingDemandDrivenPipelineInternals() : Size(0) {}
+
+  static Request MakeRequest(int port, vtkInformation* outInfo)
+  {
+    typedef vtkStreamingDemandDrivenPipeline SDDP;
+    Request request;
+    request.Port = port;
+    request.Piece = outInfo->Has(SDDP::UPDATE_PIECE_NUMBER()) ?
+      outInfo->Get(SDDP::UPDATE_PIECE_NUMBER()) : 0;
+    request.NumberOfPieces = outInfo->Has(SDDP::UPDATE_NUMBER_OF_PIECES()) ?
+      outInfo->Get(SDDP::UPDATE_NUMBER_OF_PIECES()) : 1;
+    request.GhostLevels =
+      outInfo->Has(SDDP::UPDATE_NUMBER_OF_GHOST_LEVELS()) ?
+      outInfo->Get(SDDP::UPDATE_NUMBER_OF_GHOST_LEVELS()) : 0;
+    static const int noExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    const int* extent = outInfo->Has(SDDP::UPDATE_EXTENT()) ?
+      outInfo->Get(SDDP::UPDATE_EXTENT()) : noExtent;
+    for (int i = 0; i < 6; ++i)
+    {
+      request.Extent[i] = extent[i];
+    }
+    request.HasTime = outInfo->Has(SDDP::UPDATE_TIME_STEP());
+    request.Time = request.HasTime ?
+      outInfo->Get(SDDP::UPDATE_TIME_STEP()) : 0.0;
+    return request;
+  }
+
+  // Copy the pipeline information, which a shallow copy does not, so that a
+  // cached output is not taken for another piece.
+  static void CopyPieceInformation(vtkDataObject* from, vtkDataObject* to)
+  {
+    vtkInformation* fromInfo = from->GetInformation();
+    vtkInformation* toInfo = to->GetInformation();
+    toInfo->CopyEntry(fromInfo, vtkDataObject::DATA_PIECE_NUMBER());
+    toInfo->CopyEntry(fromInfo, vtkDataObject::DATA_NUMBER_OF_PIECES());
+    toInfo->CopyEntry(fromInfo, vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS());
+  }
+
+  EntryList::iterator Find(const Request& request)
+  {
+    std::map<Request, EntryList::iterator>::iterator found =
+      this->Index.find(request);
+    return found == this->Index.end() ? this->Entries.end() : found->second;
+  }
+
+  void Erase(EntryList::iterator entry)
+  {
+    this->Size -= entry->Size;
+    this->Index.erase(entry->Key);
+    this->Entries.erase(entry);
+  }
+
+  void Insert(const Request& request, vtkDataObject* data,
+              vtkMTimeType time, unsigned long limit)
+  {
+    EntryList::iterator previous = this->Find(request);
+    if (previous != this->Entries.end())
+    {
+      this->Erase(previous);
+    }
+    unsigned long size = data->GetActualMemorySize();
+    if (size > limit)
+    {
+      return;
+    }
+    this->Shrink(limit - size);
+    Entry entry;
+    entry.Key = request;
+    entry.Data = data;
+    entry.Time = time;
+    entry.Size = size;
+    this->Entries.push_front(entry);
+    this->Index[request] = this->Entries.begin();
+    this->Size += size;
+  }
+
+  // Release the least recently used outputs until they fit in the limit.
+  void Shrink(unsigned long limit)
+  {
+    while (this->Size > limit && !this->Entries.empty())
+    {
+      this->Erase(--this->Entries.end());
+    }
+  }
+
+  // Release the outputs generated before the pipeline was last modified.
+  void Flush(vtkMTimeType pipelineMTime)
+  {
+    EntryList::iterator entry = this->Entries.begin();
+    while (entry != this->Entries.end())
+    {
+      EntryList::iterator next = entry;
+      ++next;
+      if (entry->Time < pipelineMTime)
+      {
+        this->Erase(entry);
+      }
+      entry = next;
+    }
+  }
+
+  void Clear()
+  {
+    this->Entries.clear();
+    this->Index.clear();
+    this->Size = 0;
+  }
+
+  EntryList Entries;
+  std::map<Request, EntryList::iterator> Index;
+  unsigned long Size;
+};
+
 
 //----------------------------------------------------------------------------
 vtkCachedStreamingDemandDrivenPipeline
@@ -35,6 +201,10 @@ vtkCachedStreamingDemandDrivenPipeline
   this->CacheSize = 0;
   this->Data = nullptr;
   this->Times = nullptr;
+  this->CacheMemoryLimit = 0;
+  this->CacheHits = 0;
+  this->CacheMisses = 0;
+  this->Internals = new vtkCachedStreamingDemandDrivenPipelineInternals;
 
   this->SetCacheSize(10);
 }
@@ -44,6 +214,7 @@ vtkCachedStreamingDemandDrivenPipeline
 ::~vtkCachedStreamingDemandDrivenPipeline()
 {
   this->SetCacheSize(0);
+  delete this->Internals;
 }
 
 //----------------------------------------------------------------------------
@@ -88,12 +259,48 @@ void vtkCachedStreamingDemandDrivenPipeline::SetCacheSize(int size)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::SetCacheMemoryLimit(
+  unsigned long limit)
+{
+  if (limit == this->CacheMemoryLimit)
+  {
+    return;
+  }
+  this->Modified();
+  this->CacheMemoryLimit = limit;
+  this->Internals->Shrink(limit);
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkCachedStreamingDemandDrivenPipeline::GetCacheMemorySize()
+{
+  return this->Internals->Size;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::ResetCacheStatistics()
+{
+  this->CacheHits = 0;
+  this->CacheMisses = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline::ClearCache()
+{
+  this->Internals->Clear();
+}
+
 //----------------------------------------------------------------------------
 void vtkCachedStreamingDemandDrivenPipeline
 ::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "CacheSize: " << this->CacheSize << "\n";
+  os << indent << "CacheMemoryLimit: " << this->CacheMemoryLimit << "\n";
+  os << indent << "CacheMemorySize: " << this->Internals->Size << "\n";
+  os << indent << "CacheHits: " << this->CacheHits << "\n";
+  os << indent << "CacheMisses: " << this->CacheMisses << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -124,6 +331,12 @@ int vtkCachedStreamingDemandDrivenPipeline
     return 1;
   }
 
+  if (this->CacheMemoryLimit > 0)
+  {
+    return this->NeedToExecuteCachedRequest(outputPort, inInfoVec,
+                                            outInfoVec);
+  }
+
   // First look through the cached data to see if it is still valid.
   int i;
   vtkMTimeType pmt = this->GetPipelineMTime();
@@ -224,6 +437,47 @@ int vtkCachedStreamingDemandDrivenPipeline
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkCachedStreamingDemandDrivenPipeline
+::NeedToExecuteCachedRequest(int outputPort,
+                             vtkInformationVector** inInfoVec,
+                             vtkInformationVector* outInfoVec)
+{
+  this->Internals->Flush(this->GetPipelineMTime());
+
+  // The current output may already satisfy the request.
+  if (!this->Superclass::NeedToExecuteData(outputPort, inInfoVec,
+                                           outInfoVec))
+  {
+    return 0;
+  }
+
+  vtkInformation* outInfo = outInfoVec->GetInformationObject(outputPort);
+  vtkCachedStreamingDemandDrivenPipelineInternals::EntryList::iterator entry =
+    this->Internals->Find(
+      vtkCachedStreamingDemandDrivenPipelineInternals::MakeRequest(
+        outputPort, outInfo));
+  if (entry == this->Internals->Entries.end())
+  {
+    return 1;
+  }
+
+  // Pass the cached output, which becomes the most recently used one.
+  vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
+  dataObject->ShallowCopy(entry->Data);
+  vtkCachedStreamingDemandDrivenPipelineInternals::CopyPieceInformation(
+    entry->Data, dataObject);
+  dataObject->DataHasBeenGenerated();
+  if (outInfo->Has(UPDATE_TIME_STEP()))
+  {
+    outInfo->Set(PREVIOUS_UPDATE_TIME_STEP(), outInfo->Get(UPDATE_TIME_STEP()));
+  }
+  this->Internals->Entries.splice(this->Internals->Entries.begin(),
+                                  this->Internals->Entries, entry);
+  ++this->CacheHits;
+  return 0;
+}
+
 
 //----------------------------------------------------------------------------
 int vtkCachedStreamingDemandDrivenPipeline
@@ -231,6 +485,17 @@ int vtkCachedStreamingDemandDrivenPipeline
               vtkInformationVector** inInfoVec,
               vtkInformationVector* outInfoVec)
 {
+  if (this->CacheMemoryLimit > 0)
+  {
+    ++this->CacheMisses;
+    int result = this->Superclass::ExecuteData(request, inInfoVec, outInfoVec);
+    if (result)
+    {
+      this->CacheRequests(outInfoVec);
+    }
+    return result;
+  }
+
   // only works for one in one out algorithms
   if (request->Get(FROM_OUTPUT_PORT()) != 0)
   {
@@ -292,3 +557,28 @@ int vtkCachedStreamingDemandDrivenPipeline
 
   return result;
 }
+
+//----------------------------------------------------------------------------
+void vtkCachedStreamingDemandDrivenPipeline
+::CacheRequests(vtkInformationVector* outInfoVec)
+{
+  // Keep a shallow copy of each output generated for its request.
+  this->Internals->Flush(this->GetPipelineMTime());
+  for (int i = 0; i < outInfoVec->GetNumberOfInformationObjects(); ++i)
+  {
+    vtkInformation* outInfo = outInfoVec->GetInformationObject(i);
+    vtkDataObject* dataObject = outInfo->Get(vtkDataObject::DATA_OBJECT());
+    if (!dataObject)
+    {
+      continue;
+    }
+    vtkSmartPointer<vtkDataObject> copy;
+    copy.TakeReference(dataObject->NewInstance());
+    copy->ShallowCopy(dataObject);
+    vtkCachedStreamingDemandDrivenPipelineInternals::CopyPieceInformation(
+      dataObject, copy);
+    this->Internals->Insert(
+      vtkCachedStreamingDemandDrivenPipelineInternals::MakeRequest(i, outInfo),
+      copy, dataObject->GetUpdateTime(), this->CacheMemoryLimit);
+  }
+}
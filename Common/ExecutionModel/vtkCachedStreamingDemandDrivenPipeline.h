@@ -16,6 +16,15 @@
  * @class   vtkCachedStreamingDemandDrivenPipeline
  *
  * vtkCachedStreamingDemandDrivenPipeline
+ *
+ * By default, the images generated for the last CacheSize update extents are
+ * kept, and passed to the output when a later request is contained in one of
+ * them. When a CacheMemoryLimit is set, the outputs of any type, including
+ * composite datasets, are instead kept for each request (output port, piece,
+ * number of pieces, ghost levels, update extent and time step), and the least
+ * recently used ones are released to fit in the limit. A request matching a
+ * cached output is then served without executing the algorithm or its
+ * inputs. The cached outputs are released when the pipeline is modified.
 */
 
 #ifndef vtkCachedStreamingDemandDrivenPipeline_h
@@ -24,6 +33,7 @@
 #include "vtkCommonExecutionModelModule.h" // For export macro
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+class vtkCachedStreamingDemandDrivenPipelineInternals;
 class vtkInformationIntegerKey;
 class vtkInformationIntegerVectorKey;
 
@@ -45,6 +55,38 @@ public:
   vtkGetMacro(CacheSize, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get the memory limit of the cache, in kibibytes. When it is positive,
+   * the outputs are cached by request, whatever their type, and the least
+   * recently used ones are released when their memory exceeds the limit. The
+   * CacheSize is then ignored. It defaults to 0, for the image cache.
+   */
+  void SetCacheMemoryLimit(unsigned long limit);
+  vtkGetMacro(CacheMemoryLimit, unsigned long);
+  //@}
+
+  /**
+   * Return the memory used by the outputs cached by request, in kibibytes.
+   */
+  unsigned long GetCacheMemorySize();
+
+  //@{
+  /**
+   * Return the number of requests served by the cache, and of requests that
+   * needed an execution, since the cache statistics were last reset. Only the
+   * requests cached by a CacheMemoryLimit are counted.
+   */
+  vtkGetMacro(CacheHits, vtkIdType);
+  vtkGetMacro(CacheMisses, vtkIdType);
+  void ResetCacheStatistics();
+  //@}
+
+  /**
+   * Release all the outputs cached by request.
+   */
+  void ClearCache();
+
 protected:
   vtkCachedStreamingDemandDrivenPipeline();
   ~vtkCachedStreamingDemandDrivenPipeline() override;
@@ -61,6 +103,16 @@ protected:
   vtkDataObject **Data;
   vtkMTimeType *Times;
 
+  int NeedToExecuteCachedRequest(int outputPort,
+                                 vtkInformationVector** inInfoVec,
+                                 vtkInformationVector* outInfoVec);
+  void CacheRequests(vtkInformationVector* outInfoVec);
+
+  unsigned long CacheMemoryLimit;
+  vtkIdType CacheHits;
+  vtkIdType CacheMisses;
+  vtkCachedStreamingDemandDrivenPipelineInternals *Internals;
+
 private:
   vtkCachedStreamingDemandDrivenPipeline(const vtkCachedStreamingDemandDrivenPipeline&) = delete;
   void operator=(const vtkCachedStreamingDemandDrivenPipeline&) = delete;
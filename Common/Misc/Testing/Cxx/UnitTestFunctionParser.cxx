@@ -87,6 +87,7 @@ static int TestScalarLogic();
 static int TestVectorLogic();
 static int TestMiscFunctions();
 static int TestErrors();
+static int TestBlockEvaluation();
 
 int UnitTestFunctionParser(int,char *[])
 {
@@ -121,6 +122,7 @@ int UnitTestFunctionParser(int,char *[])
 
   status += TestMiscFunctions();
   status += TestErrors();
+  status += TestBlockEvaluation();
   if (status != 0)
   {
     return EXIT_FAILURE;
@@ -1116,3 +1118,108 @@ int TestErrors()
   }
   return status;
 }
+
+int TestBlockEvaluation()
+{
+  std::cout << "Testing EvaluateBlock" << "...";
+  const char* functions[] = {
+    "s + t * 2 - -s / t", "s ^ t", "abs(s) + exp(t) + ceil(s) + floor(t)",
+    "ln(s) + log10(t) + log(s * t)", "sqrt(s) - sqrt(t)",
+    "sin(s) * cos(t) / tan(s)", "asin(s) + acos(t) + atan(s)",
+    "sinh(t) + cosh(s) - tanh(t)", "min(s, t) * max(t, s) + sign(s)",
+    "cross(v, w)", "-v + w - +v", "v . w", "s * v", "v * t", "v / s",
+    "mag(v) * norm(w)", "s * iHat + t * jHat + kHat",
+    "if(s < t | s = t, 1, 0) + if(s > t & s > 0, 2, 0)",
+    "if(s > t, s, t)", "if(s > 0, v, w)"
+  };
+
+  // A block of tuples, with values out of the domain of some functions.
+  const vtkIdType numTuples = 100;
+  std::vector<double> sValues(numTuples), tValues(numTuples);
+  std::vector<double> vValues(3 * numTuples), wValues(3 * numTuples);
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    sValues[i] = (i % 10 == 0) ? 0.0 : vtkMath::Random(-2.0, 2.0);
+    tValues[i] = (i % 7 == 0) ? sValues[i] : vtkMath::Random(-2.0, 2.0);
+    for (int j = 0; j < 3; ++j)
+    {
+      vValues[3 * i + j] = (i % 11 == 0) ? 0.0 : vtkMath::Random(-2.0, 2.0);
+      wValues[3 * i + j] = vtkMath::Random(-2.0, 2.0);
+    }
+  }
+
+  vtkSmartPointer<vtkTest::ErrorObserver>  errorObserver =
+    vtkSmartPointer<vtkTest::ErrorObserver>::New();
+  int status = 0;
+  for (int replace = 0; replace < 2; ++replace)
+  {
+    for (size_t f = 0; f < sizeof(functions) / sizeof(functions[0]); ++f)
+    {
+      vtkSmartPointer<vtkFunctionParser> parser =
+        vtkSmartPointer<vtkFunctionParser>::New();
+      parser->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+      parser->SetReplaceInvalidValues(replace);
+      parser->SetReplacementValue(-7.0);
+      parser->SetScalarVariableValue("s", 1.0);
+      parser->SetScalarVariableValue("t", 1.0);
+      parser->SetVectorVariableValue("v", 1.0, 1.0, 1.0);
+      parser->SetVectorVariableValue("w", 1.0, 1.0, 1.0);
+      parser->SetFunction(functions[f]);
+      int numComponents = parser->IsVectorResult() ? 3 : 1;
+      if (numComponents == 1 && !parser->IsScalarResult())
+      {
+        std::cout << "\n" << functions[f] << " could not be parsed";
+        ++status;
+        continue;
+      }
+
+      const double* scalarValues[2] = { sValues.data(), tValues.data() };
+      const double* vectorValues[2] = { vValues.data(), wValues.data() };
+      std::vector<double> results(numComponents * numTuples);
+      parser->EvaluateBlock(numTuples, scalarValues, vectorValues,
+                            results.data());
+
+      // Each tuple must give the same result as when evaluated alone.
+      for (vtkIdType i = 0; i < numTuples; ++i)
+      {
+        parser->SetScalarVariableValue("s", sValues[i]);
+        parser->SetScalarVariableValue("t", tValues[i]);
+        parser->SetVectorVariableValue("v", &vValues[3 * i]);
+        parser->SetVectorVariableValue("w", &wValues[3 * i]);
+        double scalar[1];
+        const double* expected = scalar;
+        if (numComponents == 1)
+        {
+          scalar[0] = parser->GetScalarResult();
+        }
+        else
+        {
+          expected = parser->GetVectorResult();
+        }
+        for (int j = 0; j < numComponents; ++j)
+        {
+          double result = results[numComponents * i + j];
+          if (result != expected[j] &&
+              !(vtkMath::IsNan(result) && vtkMath::IsNan(expected[j])))
+          {
+            std::cout << "\n" << functions[f] << " at tuple " << i
+                      << " expected " << expected[j] << " but got "
+                      << result;
+            ++status;
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  if (status == 0)
+  {
+    std::cout << "PASSED\n";
+  }
+  else
+  {
+    std::cout << "FAILED\n";
+  }
+  return status;
+}
@@ -17,12 +17,22 @@
 
 #include <cctype>
 #include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkFunctionParser);
 
 static double vtkParserVectorErrorResult[3] = { VTK_PARSER_ERROR_RESULT,
                                                 VTK_PARSER_ERROR_RESULT,
                                                 VTK_PARSER_ERROR_RESULT };
+
+// Magnitude of the vector whose components are on top of the stack, shared
+// by Evaluate() and EvaluateBlock() so that both give the same results.
+static inline double vtkParserMagnitude(double top, double middle,
+                                        double bottom)
+{
+  return sqrt(pow(top, 2) + pow(middle, 2) + pow(bottom, 2));
+}
+
 //-----------------------------------------------------------------------------
 vtkFunctionParser::vtkFunctionParser()
 {
@@ -739,15 +749,15 @@ bool vtkFunctionParser::Evaluate()
         break;
       case VTK_PARSER_MAGNITUDE:
         this->Stack[stackPosition-2] =
-          sqrt(pow(this->Stack[stackPosition], 2) +
-               pow(this->Stack[stackPosition-1], 2) +
-               pow(this->Stack[stackPosition-2], 2));
+          vtkParserMagnitude(this->Stack[stackPosition],
+                             this->Stack[stackPosition-1],
+                             this->Stack[stackPosition-2]);
         stackPosition -= 2;
         break;
       case VTK_PARSER_NORMALIZE:
-        magnitude = sqrt(pow(this->Stack[stackPosition], 2) +
-                         pow(this->Stack[stackPosition-1], 2) +
-                         pow(this->Stack[stackPosition-2], 2));
+        magnitude = vtkParserMagnitude(this->Stack[stackPosition],
+                                       this->Stack[stackPosition-1],
+                                       this->Stack[stackPosition-2]);
         if (magnitude != 0)
         {
           this->Stack[stackPosition] /= magnitude;
@@ -863,6 +873,599 @@ bool vtkFunctionParser::Evaluate()
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkFunctionParser::EvaluateBlock(vtkIdType numTuples,
+                                      const double* const* scalarValues,
+                                      const double* const* vectorValues,
+                                      double* result)
+{
+  int numBytesProcessed;
+  int numImmediatesProcessed = 0;
+  int stackPosition = -1;
+  const vtkIdType n = numTuples;
+  vtkIdType t;
+
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime())
+  {
+    if (this->Parse() == 0)
+    {
+      return false;
+    }
+  }
+  if (n < 1)
+  {
+    return true;
+  }
+
+  // Each stack position holds the values of all the tuples. Positions are
+  // pointers in the buffer so that they can be exchanged without copies.
+  std::vector<double> buffer(static_cast<size_t>(this->StackSize) * n);
+  std::vector<double*> stack(this->StackSize);
+  for (int i = 0; i < this->StackSize; i++)
+  {
+    stack[i] = buffer.data() + i * n;
+  }
+  // Tuples for which an operation is invalid and no replacement is done.
+  std::vector<unsigned char> failed(n, 0);
+  const bool replace = this->ReplaceInvalidValues != 0;
+  const double replacement = this->ReplacementValue;
+  double *a, *b, *c, *x, *y, *z, *tmp;
+
+  for (numBytesProcessed = 0; numBytesProcessed < this->ByteCodeSize;
+       numBytesProcessed++)
+  {
+    switch (this->ByteCode[numBytesProcessed])
+    {
+      case VTK_PARSER_IMMEDIATE:
+        a = stack[++stackPosition];
+        std::fill(a, a + n, this->Immediates[numImmediatesProcessed++]);
+        break;
+      case VTK_PARSER_UNARY_MINUS:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = -a[t];
+        }
+        break;
+      case VTK_PARSER_UNARY_PLUS:
+        break;
+      case VTK_PARSER_ADD:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] += b[t];
+        }
+        break;
+      case VTK_PARSER_SUBTRACT:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] -= b[t];
+        }
+        break;
+      case VTK_PARSER_MULTIPLY:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] *= b[t];
+        }
+        break;
+      case VTK_PARSER_DIVIDE:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          if (b[t] == 0)
+          {
+            if (replace)
+            {
+              a[t] = replacement;
+            }
+            else
+            {
+              failed[t] = 1;
+            }
+          }
+          else
+          {
+            a[t] /= b[t];
+          }
+        }
+        break;
+      case VTK_PARSER_POWER:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = pow(a[t], b[t]);
+        }
+        break;
+      case VTK_PARSER_ABSOLUTE_VALUE:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = fabs(a[t]);
+        }
+        break;
+      case VTK_PARSER_EXPONENT:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = exp(a[t]);
+        }
+        break;
+      case VTK_PARSER_CEILING:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = ceil(a[t]);
+        }
+        break;
+      case VTK_PARSER_FLOOR:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = floor(a[t]);
+        }
+        break;
+      case VTK_PARSER_LOGARITHM:
+      case VTK_PARSER_LOGARITHME:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          if (a[t] <= 0)
+          {
+            if (replace)
+            {
+              a[t] = replacement;
+            }
+            else
+            {
+              failed[t] = 1;
+            }
+          }
+          else
+          {
+            a[t] = log(a[t]);
+          }
+        }
+        break;
+      case VTK_PARSER_LOGARITHM10:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          if (a[t] <= 0)
+          {
+            if (replace)
+            {
+              a[t] = replacement;
+            }
+            else
+            {
+              failed[t] = 1;
+            }
+          }
+          else
+          {
+            a[t] = log10(a[t]);
+          }
+        }
+        break;
+      case VTK_PARSER_SQUARE_ROOT:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          if (a[t] < 0)
+          {
+            if (replace)
+            {
+              a[t] = replacement;
+            }
+            else
+            {
+              failed[t] = 1;
+            }
+          }
+          else
+          {
+            a[t] = sqrt(a[t]);
+          }
+        }
+        break;
+      case VTK_PARSER_SINE:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = sin(a[t]);
+        }
+        break;
+      case VTK_PARSER_COSINE:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = cos(a[t]);
+        }
+        break;
+      case VTK_PARSER_TANGENT:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = tan(a[t]);
+        }
+        break;
+      case VTK_PARSER_ARCSINE:
+      case VTK_PARSER_ARCCOSINE:
+      {
+        const bool sine =
+          this->ByteCode[numBytesProcessed] == VTK_PARSER_ARCSINE;
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          if (a[t] < -1 || a[t] > 1)
+          {
+            if (replace)
+            {
+              a[t] = replacement;
+            }
+            else
+            {
+              failed[t] = 1;
+            }
+          }
+          else
+          {
+            a[t] = sine ? asin(a[t]) : acos(a[t]);
+          }
+        }
+        break;
+      }
+      case VTK_PARSER_ARCTANGENT:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = atan(a[t]);
+        }
+        break;
+      case VTK_PARSER_HYPERBOLIC_SINE:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = sinh(a[t]);
+        }
+        break;
+      case VTK_PARSER_HYPERBOLIC_COSINE:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = cosh(a[t]);
+        }
+        break;
+      case VTK_PARSER_HYPERBOLIC_TANGENT:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = tanh(a[t]);
+        }
+        break;
+      case VTK_PARSER_MIN:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = b[t] < a[t] ? b[t] : a[t];
+        }
+        break;
+      case VTK_PARSER_MAX:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = b[t] > a[t] ? b[t] : a[t];
+        }
+        break;
+      case VTK_PARSER_CROSS:
+      {
+        // Cross Product
+        double *ux = stack[stackPosition-5];
+        double *uy = stack[stackPosition-4];
+        double *uz = stack[stackPosition-3];
+        double *vx = stack[stackPosition-2];
+        double *vy = stack[stackPosition-1];
+        double *vz = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          double cx = uy[t]*vz[t] - uz[t]*vy[t];
+          double cy = uz[t]*vx[t] - ux[t]*vz[t];
+          double cz = ux[t]*vy[t] - uy[t]*vx[t];
+          ux[t] = cx;
+          uy[t] = cy;
+          uz[t] = cz;
+        }
+        stackPosition -= 3;
+        break;
+      }
+      case VTK_PARSER_SIGN:
+        a = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = a[t] < 0 ? -1 : (a[t] == 0 ? 0 : 1);
+        }
+        break;
+      case VTK_PARSER_VECTOR_UNARY_MINUS:
+        x = stack[stackPosition-2];
+        y = stack[stackPosition-1];
+        z = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          x[t] = -x[t];
+          y[t] = -y[t];
+          z[t] = -z[t];
+        }
+        break;
+      case VTK_PARSER_VECTOR_UNARY_PLUS:
+        break;
+      case VTK_PARSER_DOT_PRODUCT:
+        x = stack[stackPosition-5];
+        y = stack[stackPosition-4];
+        z = stack[stackPosition-3];
+        a = stack[stackPosition-2];
+        b = stack[stackPosition-1];
+        c = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          x[t] = x[t]*a[t] + y[t]*b[t] + z[t]*c[t];
+        }
+        stackPosition -= 5;
+        break;
+      case VTK_PARSER_VECTOR_ADD:
+        x = stack[stackPosition-5];
+        y = stack[stackPosition-4];
+        z = stack[stackPosition-3];
+        a = stack[stackPosition-2];
+        b = stack[stackPosition-1];
+        c = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          x[t] += a[t];
+          y[t] += b[t];
+          z[t] += c[t];
+        }
+        stackPosition -= 3;
+        break;
+      case VTK_PARSER_VECTOR_SUBTRACT:
+        x = stack[stackPosition-5];
+        y = stack[stackPosition-4];
+        z = stack[stackPosition-3];
+        a = stack[stackPosition-2];
+        b = stack[stackPosition-1];
+        c = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          x[t] -= a[t];
+          y[t] -= b[t];
+          z[t] -= c[t];
+        }
+        stackPosition -= 3;
+        break;
+      case VTK_PARSER_SCALAR_TIMES_VECTOR:
+        a = stack[stackPosition-3];
+        x = stack[stackPosition-2];
+        y = stack[stackPosition-1];
+        z = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          x[t] *= a[t];
+          y[t] *= a[t];
+          z[t] *= a[t];
+        }
+        // Move the vector down in place of the scalar.
+        tmp = stack[stackPosition-3];
+        stack[stackPosition-3] = x;
+        stack[stackPosition-2] = y;
+        stack[stackPosition-1] = z;
+        stack[stackPosition--] = tmp;
+        break;
+      case VTK_PARSER_VECTOR_TIMES_SCALAR:
+      case VTK_PARSER_VECTOR_OVER_SCALAR:
+      {
+        const bool times =
+          this->ByteCode[numBytesProcessed] == VTK_PARSER_VECTOR_TIMES_SCALAR;
+        x = stack[stackPosition-3];
+        y = stack[stackPosition-2];
+        z = stack[stackPosition-1];
+        a = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          if (times)
+          {
+            x[t] *= a[t];
+            y[t] *= a[t];
+            z[t] *= a[t];
+          }
+          else
+          {
+            x[t] /= a[t];
+            y[t] /= a[t];
+            z[t] /= a[t];
+          }
+        }
+        break;
+      }
+      case VTK_PARSER_MAGNITUDE:
+        x = stack[stackPosition-2];
+        y = stack[stackPosition-1];
+        z = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          x[t] = vtkParserMagnitude(z[t], y[t], x[t]);
+        }
+        stackPosition -= 2;
+        break;
+      case VTK_PARSER_NORMALIZE:
+        x = stack[stackPosition-2];
+        y = stack[stackPosition-1];
+        z = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          double magnitude = vtkParserMagnitude(z[t], y[t], x[t]);
+          if (magnitude != 0)
+          {
+            z[t] /= magnitude;
+            y[t] /= magnitude;
+            x[t] /= magnitude;
+          }
+        }
+        break;
+      case VTK_PARSER_IHAT:
+      case VTK_PARSER_JHAT:
+      case VTK_PARSER_KHAT:
+        for (int i = 0; i < 3; i++)
+        {
+          a = stack[++stackPosition];
+          std::fill(a, a + n,
+            this->ByteCode[numBytesProcessed] - VTK_PARSER_IHAT == i ? 1 : 0);
+        }
+        break;
+      case VTK_PARSER_LESS_THAN:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = (a[t] < b[t]);
+        }
+        break;
+      case VTK_PARSER_GREATER_THAN:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = (a[t] > b[t]);
+        }
+        break;
+      case VTK_PARSER_EQUAL_TO:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = (a[t] == b[t]);
+        }
+        break;
+      case VTK_PARSER_AND:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = (a[t] && b[t]);
+        }
+        break;
+      case VTK_PARSER_OR:
+        a = stack[stackPosition-1];
+        b = stack[stackPosition--];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = (a[t] || b[t]);
+        }
+        break;
+      case VTK_PARSER_IF:
+        // if(bool,valtrue,valfalse): the result replaces valfalse.
+        a = stack[stackPosition-2];
+        b = stack[stackPosition-1];
+        c = stack[stackPosition];
+        for (t = 0; t < n; t++)
+        {
+          a[t] = c[t] != 0.0 ? b[t] : a[t];
+        }
+        stackPosition -= 2;
+        break;
+      case VTK_PARSER_VECTOR_IF:
+        c = stack[stackPosition];
+        for (int i = 0; i < 3; i++)
+        {
+          a = stack[stackPosition-6+i];
+          b = stack[stackPosition-3+i];
+          for (t = 0; t < n; t++)
+          {
+            a[t] = c[t] != 0.0 ? b[t] : a[t];
+          }
+        }
+        stackPosition -= 4;
+        break;
+      default:
+        if ((this->ByteCode[numBytesProcessed] -
+             VTK_PARSER_BEGIN_VARIABLES) < this->GetNumberOfScalarVariables())
+        {
+          int scalarNum =
+            this->ByteCode[numBytesProcessed] - VTK_PARSER_BEGIN_VARIABLES;
+          a = stack[++stackPosition];
+          if (scalarValues && scalarValues[scalarNum])
+          {
+            std::copy(scalarValues[scalarNum], scalarValues[scalarNum] + n, a);
+          }
+          else
+          {
+            std::fill(a, a + n, this->ScalarVariableValues[scalarNum]);
+          }
+        }
+        else
+        {
+          int vectorNum = this->ByteCode[numBytesProcessed] -
+            VTK_PARSER_BEGIN_VARIABLES - this->GetNumberOfScalarVariables();
+          x = stack[++stackPosition];
+          y = stack[++stackPosition];
+          z = stack[++stackPosition];
+          if (vectorValues && vectorValues[vectorNum])
+          {
+            const double *v = vectorValues[vectorNum];
+            for (t = 0; t < n; t++, v += 3)
+            {
+              x[t] = v[0];
+              y[t] = v[1];
+              z[t] = v[2];
+            }
+          }
+          else
+          {
+            std::fill(x, x + n, this->VectorVariableValues[vectorNum][0]);
+            std::fill(y, y + n, this->VectorVariableValues[vectorNum][1]);
+            std::fill(z, z + n, this->VectorVariableValues[vectorNum][2]);
+          }
+        }
+    }
+  }
+
+  bool success = true;
+  if (stackPosition == 0)
+  {
+    a = stack[0];
+    for (t = 0; t < n; t++)
+    {
+      success &= !failed[t];
+      result[t] = failed[t] ? VTK_PARSER_ERROR_RESULT : a[t];
+    }
+  }
+  else if (stackPosition == 2)
+  {
+    x = stack[0];
+    y = stack[1];
+    z = stack[2];
+    for (t = 0; t < n; t++)
+    {
+      success &= !failed[t];
+      result[3*t] = failed[t] ? VTK_PARSER_ERROR_RESULT : x[t];
+      result[3*t+1] = failed[t] ? VTK_PARSER_ERROR_RESULT : y[t];
+      result[3*t+2] = failed[t] ? VTK_PARSER_ERROR_RESULT : z[t];
+    }
+  }
+  else
+  {
+    success = false;
+  }
+  return success;
+}
+
 //-----------------------------------------------------------------------------
 int vtkFunctionParser::IsScalarResult()
 {
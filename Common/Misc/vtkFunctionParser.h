@@ -177,6 +177,24 @@ public:
     result[0] = r[0]; result[1] = r[1]; result[2] = r[2]; };
   //@}
 
+  /**
+   * Evaluate the function for a block of numTuples tuples, running each
+   * operation of the function over the whole block before the next one.
+   * scalarValues holds numTuples values for each scalar variable, and
+   * vectorValues 3 * numTuples interleaved values for each vector variable,
+   * in the order of the variable indices. A null array, or a null entry,
+   * stands for the value set with Set{Scalar,Vector}VariableValue() for all
+   * the tuples. The numTuples scalar results or 3 * numTuples interleaved
+   * vector results are written to result. When an operation is invalid for
+   * a tuple and ReplaceInvalidValues is off, VTK_PARSER_ERROR_RESULT is
+   * written for that tuple and false is returned, without reporting an
+   * error. Once the function has been parsed, for instance by
+   * IsScalarResult(), this method may be called from several threads at
+   * once.
+   */
+  bool EvaluateBlock(vtkIdType numTuples, const double* const* scalarValues,
+                     const double* const* vectorValues, double* result);
+
   //@{
   /**
    * Set the value of a scalar variable.  If a variable with this name
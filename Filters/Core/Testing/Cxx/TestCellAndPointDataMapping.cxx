@@ -0,0 +1,327 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellAndPointDataMapping.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Map cell data to point data, and point data to cell data, for image data,
+// structured and unstructured grids and polydata, large enough for the
+// arrays to be mapped in parallel, and check the output against the
+// averages computed cell by cell and point by point, for all the options
+// that select the contributing cells.
+
+#include "vtkCell.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStringArray.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const int Dim = 30;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Dim * (j + Dim * k);
+}
+
+// A two component double array, an integer array and a string array.
+void AddArrays(vtkDataSetAttributes *data, vtkIdType size)
+{
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  values->SetNumberOfComponents(2);
+  values->SetNumberOfTuples(size);
+  vtkNew<vtkIntArray> counts;
+  counts->SetName("Counts");
+  counts->SetNumberOfTuples(size);
+  vtkNew<vtkStringArray> labels;
+  labels->SetName("Labels");
+  labels->SetNumberOfTuples(size);
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    values->SetTypedComponent(i, 0, std::sin(0.01 * i));
+    values->SetTypedComponent(i, 1, 0.5 * (i % 17));
+    counts->SetValue(i, static_cast<int>(i % 23) * 4);
+    labels->SetValue(i, (i % 2) ? "odd" : "even");
+  }
+  data->AddArray(values);
+  data->AddArray(counts);
+  data->AddArray(labels);
+}
+
+void MakeImage(vtkImageData *image)
+{
+  image->SetDimensions(Dim, Dim, Dim);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  AddArrays(image->GetPointData(), image->GetNumberOfPoints());
+  AddArrays(image->GetCellData(), image->GetNumberOfCells());
+}
+
+// The points of the image, with a wave.
+void MakeStructuredGrid(vtkImageData *image, vtkStructuredGrid *sgrid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    points->SetPoint(i, x[0], x[1] + 0.02 * std::sin(10.0 * x[0]), x[2]);
+  }
+  sgrid->SetDimensions(Dim, Dim, Dim);
+  sgrid->SetPoints(points);
+  sgrid->GetPointData()->ShallowCopy(image->GetPointData());
+  sgrid->GetCellData()->ShallowCopy(image->GetCellData());
+}
+
+// Hexahedra, quads on the bottom face, lines along the x axis and vertices,
+// so that the cells of the points have different dimensions.
+void MakeUnstructuredGrid(vtkImageData *image, vtkUnstructuredGrid *ugrid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    points->SetPoint(i, image->GetPoint(i));
+  }
+  ugrid->SetPoints(points);
+  ugrid->Allocate(image->GetNumberOfCells());
+  for (int k = 0; k < Dim - 1; ++k)
+  {
+    for (int j = 0; j < Dim - 1; ++j)
+    {
+      for (int i = 0; i < Dim - 1; ++i)
+      {
+        vtkIdType hex[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+        if (k == 0 && (i + j) % 3 == 0)
+        {
+          ugrid->InsertNextCell(VTK_QUAD, 4, hex);
+        }
+        if (j == 0 && k % 4 == 0)
+        {
+          ugrid->InsertNextCell(VTK_LINE, 2, hex);
+          ugrid->InsertNextCell(VTK_VERTEX, 1, hex + 1);
+        }
+      }
+    }
+  }
+  AddArrays(ugrid->GetPointData(), ugrid->GetNumberOfPoints());
+  AddArrays(ugrid->GetCellData(), ugrid->GetNumberOfCells());
+}
+
+// Quads on the planes of constant k, lines on some of them and vertices, on
+// points of which some are unused.
+void MakePolyData(vtkImageData *image, vtkPolyData *pdata)
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    points->SetPoint(i, image->GetPoint(i));
+  }
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  for (int k = 0; k < Dim - 1; ++k)
+  {
+    for (int j = 0; j < Dim - 1; ++j)
+    {
+      for (int i = 0; i < Dim - 1; ++i)
+      {
+        vtkIdType quad[4] = { PointId(i, j, k), PointId(i + 1, j, k),
+                              PointId(i + 1, j + 1, k), PointId(i, j + 1, k) };
+        polys->InsertNextCell(4, quad);
+        if (k % 5 == 0 && i % 2 == 0)
+        {
+          lines->InsertNextCell(3, quad);
+          verts->InsertNextCell(1, quad + 3);
+        }
+      }
+    }
+  }
+  pdata->SetPoints(points);
+  pdata->SetVerts(verts);
+  pdata->SetLines(lines);
+  pdata->SetPolys(polys);
+  AddArrays(pdata->GetPointData(), pdata->GetNumberOfPoints());
+  AddArrays(pdata->GetCellData(), pdata->GetNumberOfCells());
+}
+
+bool Close(double a, double b)
+{
+  return std::fabs(a - b) <= 1e-10 * (1.0 + std::fabs(b));
+}
+
+// The average of the cell data over the contributing cells of each point.
+int CheckPointData(vtkDataSet *input, vtkDataSet *output, int option,
+                   const char *label)
+{
+  vtkDataArray *values = input->GetCellData()->GetArray("Values");
+  vtkDataArray *result = output->GetPointData()->GetArray("Values");
+  vtkAbstractArray *labels =
+    output->GetPointData()->GetAbstractArray("Labels");
+  if (!result || result->GetNumberOfTuples() != input->GetNumberOfPoints() ||
+      !output->GetPointData()->GetArray("Counts") || !labels ||
+      labels->GetNumberOfTuples() != input->GetNumberOfPoints())
+  {
+    cerr << label << ": missing point data arrays" << endl;
+    return 1;
+  }
+
+  int highestDimension = 0;
+  if (option == vtkCellDataToPointData::DataSetMax)
+  {
+    for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+    {
+      highestDimension = std::max(highestDimension,
+                                  input->GetCell(cellId)->GetCellDimension());
+    }
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType ptId = 0; ptId < input->GetNumberOfPoints(); ++ptId)
+  {
+    input->GetPointCells(ptId, cellIds);
+    int minDimension = highestDimension;
+    for (vtkIdType i = 0; i < cellIds->GetNumberOfIds(); ++i)
+    {
+      int dimension = input->GetCell(cellIds->GetId(i))->GetCellDimension();
+      if (option == vtkCellDataToPointData::Patch)
+      {
+        minDimension = std::max(minDimension, dimension);
+      }
+    }
+    for (int c = 0; c < 2; ++c)
+    {
+      double sum = 0.0;
+      int count = 0;
+      for (vtkIdType i = 0; i < cellIds->GetNumberOfIds(); ++i)
+      {
+        vtkIdType cellId = cellIds->GetId(i);
+        if (input->GetCell(cellId)->GetCellDimension() >= minDimension)
+        {
+          sum += values->GetComponent(cellId, c);
+          ++count;
+        }
+      }
+      double expected = count ? sum / count : 0.0;
+      if (!Close(result->GetComponent(ptId, c), expected))
+      {
+        cerr << label << ": wrong point data at point " << ptId
+             << " with option " << option << ", expected " << expected
+             << ", got " << result->GetComponent(ptId, c) << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// The average of the point data over the points of each cell.
+int CheckCellData(vtkDataSet *input, vtkDataSet *output, const char *label)
+{
+  vtkDataArray *values = input->GetPointData()->GetArray("Values");
+  vtkDataArray *counts = input->GetPointData()->GetArray("Counts");
+  vtkDataArray *result = output->GetCellData()->GetArray("Values");
+  vtkDataArray *resultCounts = output->GetCellData()->GetArray("Counts");
+  vtkAbstractArray *labels =
+    output->GetCellData()->GetAbstractArray("Labels");
+  if (!result || !resultCounts || !labels ||
+      result->GetNumberOfTuples() != input->GetNumberOfCells() ||
+      labels->GetNumberOfTuples() != input->GetNumberOfCells())
+  {
+    cerr << label << ": missing cell data arrays" << endl;
+    return 1;
+  }
+
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, ptIds);
+    vtkIdType npts = ptIds->GetNumberOfIds();
+    double sum[2] = { 0.0, 0.0 };
+    double count = 0.0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      sum[0] += values->GetComponent(ptIds->GetId(i), 0);
+      sum[1] += values->GetComponent(ptIds->GetId(i), 1);
+      count += counts->GetComponent(ptIds->GetId(i), 0);
+    }
+    if (!Close(result->GetComponent(cellId, 0), sum[0] / npts) ||
+        !Close(result->GetComponent(cellId, 1), sum[1] / npts) ||
+        resultCounts->GetComponent(cellId, 0) != std::floor(count / npts + 0.5))
+    {
+      cerr << label << ": wrong cell data at cell " << cellId << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestDataSet(vtkDataSet *input, const char *label)
+{
+  int rval = 0;
+  for (int option = 0; option < 3; ++option)
+  {
+    vtkNew<vtkCellDataToPointData> c2p;
+    c2p->SetInputData(input);
+    c2p->SetContributingCellOption(option);
+    c2p->Update();
+    rval |= CheckPointData(input, c2p->GetOutput(), option, label);
+  }
+
+  vtkNew<vtkPointDataToCellData> p2c;
+  p2c->SetInputData(input);
+  p2c->Update();
+  rval |= CheckCellData(input, p2c->GetOutput(), label);
+  return rval;
+}
+
+}
+
+int TestCellAndPointDataMapping(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  MakeImage(image);
+  vtkNew<vtkStructuredGrid> sgrid;
+  MakeStructuredGrid(image, sgrid);
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakeUnstructuredGrid(image, ugrid);
+  vtkNew<vtkPolyData> pdata;
+  MakePolyData(image, pdata);
+
+  int rval = TestDataSet(image, "image");
+  rval |= TestDataSet(sgrid, "structured grid");
+  rval |= TestDataSet(ugrid, "unstructured grid");
+  rval |= TestDataSet(pdata, "polydata");
+  return rval;
+}
@@ -0,0 +1,206 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCleanPolyDataParallelMerging.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Clean a triangle soup, with degenerate cells of all types, with the
+// incremental and the parallel point merging, and check that the outputs
+// are identical with a zero tolerance and that jittered points are merged
+// with a non-zero tolerance.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCleanPolyData.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+
+#include <cmath>
+
+namespace
+{
+
+const int Size = 60;
+
+// Each triangle of a Size x Size grid has its own points, which are moved
+// by up to jitter. Some of the cells are degenerate.
+void MakeSoup(vtkPolyData *soup, double jitter)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> verts;
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  int count = 0;
+  auto point = [&](int i, int j)
+  {
+    double offset = jitter * ((count++ % 7) - 3) / 3.0;
+    return points->InsertNextPoint(i + offset, j - offset,
+                                   std::sin(0.1 * i) * std::cos(0.1 * j));
+  };
+
+  for (int j = 0; j < Size; ++j)
+  {
+    for (int i = 0; i < Size; ++i)
+    {
+      vtkIdType tri0[3] = { point(i, j), point(i + 1, j), point(i + 1, j + 1) };
+      vtkIdType tri1[3] = { point(i, j), point(i + 1, j + 1), point(i, j + 1) };
+      polys->InsertNextCell(3, tri0);
+      polys->InsertNextCell(3, tri1);
+      if ((i + j) % 13 == 0)
+      {
+        vtkIdType quad[4] = { point(i, j), point(i + 1, j),
+                              point(i + 1, j), point(i, j) };
+        polys->InsertNextCell(4, quad);
+      }
+      if ((i * j) % 17 == 1)
+      {
+        vtkIdType line[3] = { point(i, j), point(i, j), point(i + 1, j) };
+        lines->InsertNextCell(3, line);
+        vtkIdType vert[2] = { point(i, j), point(i, j) };
+        verts->InsertNextCell(2, vert);
+      }
+      if ((i + 3 * j) % 19 == 0)
+      {
+        vtkIdType strip[5] = { point(i, j), point(i + 1, j), point(i, j + 1),
+                               point(i + 1, j + 1), point(i + 1, j + 1) };
+        strips->InsertNextCell(5, strip);
+        vtkIdType degenerate[4] = { point(i, j), point(i + 1, j),
+                                    point(i + 1, j), point(i + 1, j) };
+        strips->InsertNextCell(4, degenerate);
+      }
+    }
+  }
+  soup->SetPoints(points);
+  soup->SetVerts(verts);
+  soup->SetLines(lines);
+  soup->SetPolys(polys);
+  soup->SetStrips(strips);
+
+  vtkNew<vtkFloatArray> pointIds;
+  pointIds->SetName("PointIds");
+  pointIds->SetNumberOfTuples(soup->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < soup->GetNumberOfPoints(); ++i)
+  {
+    pointIds->SetValue(i, static_cast<float>(i));
+  }
+  soup->GetPointData()->SetScalars(pointIds);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(soup->GetNumberOfCells());
+  for (vtkIdType i = 0; i < soup->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  soup->GetCellData()->AddArray(cellIds);
+}
+
+bool SameArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  if (a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int CompareOutputs(vtkPolyData *a, vtkPolyData *b, const char *label)
+{
+  vtkCellArray *aCells[4] = { a->GetVerts(), a->GetLines(), a->GetPolys(),
+                              a->GetStrips() };
+  vtkCellArray *bCells[4] = { b->GetVerts(), b->GetLines(), b->GetPolys(),
+                              b->GetStrips() };
+  for (int i = 0; i < 4; ++i)
+  {
+    if (aCells[i]->GetNumberOfCells() != bCells[i]->GetNumberOfCells() ||
+        !SameArrays(aCells[i]->GetData(), bCells[i]->GetData()))
+    {
+      cerr << label << ": cell array " << i << " differs" << endl;
+      return 1;
+    }
+  }
+  if (!SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData()) ||
+      !SameArrays(a->GetPointData()->GetScalars(),
+                  b->GetPointData()->GetScalars()) ||
+      !SameArrays(a->GetCellData()->GetArray("CellIds"),
+                  b->GetCellData()->GetArray("CellIds")))
+  {
+    cerr << label << ": points or attributes differ" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestCleanPolyDataParallelMerging(int, char *[])
+{
+  int rval = 0;
+  const vtkIdType numGridPoints = (Size + 1) * (Size + 1);
+
+  vtkNew<vtkPolyData> soup;
+  MakeSoup(soup, 0.0);
+  for (int convert = 0; convert < 8; ++convert)
+  {
+    vtkNew<vtkCleanPolyData> serial;
+    vtkNew<vtkCleanPolyData> parallel;
+    parallel->ParallelMergingOn();
+    vtkCleanPolyData *cleans[2] = { serial, parallel };
+    for (int i = 0; i < 2; ++i)
+    {
+      cleans[i]->SetInputData(soup);
+      cleans[i]->SetConvertLinesToPoints(convert & 1);
+      cleans[i]->SetConvertPolysToLines(convert & 2);
+      cleans[i]->SetConvertStripsToPolys(convert & 4);
+      cleans[i]->Update();
+    }
+    if (parallel->GetOutput()->GetNumberOfPoints() != numGridPoints)
+    {
+      cerr << "Expected " << numGridPoints << " points, got "
+           << parallel->GetOutput()->GetNumberOfPoints() << endl;
+      rval = 1;
+    }
+    rval |= CompareOutputs(serial->GetOutput(), parallel->GetOutput(),
+                           "zero tolerance");
+  }
+
+  vtkNew<vtkPolyData> jittered;
+  MakeSoup(jittered, 0.01);
+  vtkNew<vtkCleanPolyData> parallel;
+  parallel->SetInputData(jittered);
+  parallel->ParallelMergingOn();
+  parallel->ToleranceIsAbsoluteOn();
+  parallel->SetAbsoluteTolerance(0.05);
+  parallel->Update();
+  if (parallel->GetOutput()->GetNumberOfPoints() != numGridPoints)
+  {
+    cerr << "Expected " << numGridPoints << " points with a tolerance, got "
+         << parallel->GetOutput()->GetNumberOfPoints() << endl;
+    rval = 1;
+  }
+
+  return rval;
+}
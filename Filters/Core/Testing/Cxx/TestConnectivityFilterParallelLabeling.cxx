@@ -0,0 +1,271 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterParallelLabeling.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Label the fragments of a mesh, whose cells are interleaved, with the
+// traversal and with the parallel union-find of vtkConnectivityFilter and
+// vtkPolyDataConnectivityFilter, and check that the region ids and sizes
+// are the same, as well as the extracted largest and specified regions.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConnectivityFilter.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataConnectivityFilter.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+namespace
+{
+
+const int NumberOfFragments = 40;
+
+// Square fragments of quads of varying sizes, whose cells are inserted in
+// turn, plus a lone vertex and an unused point.
+void MakeFragments(vtkPolyData *pdata)
+{
+  vtkNew<vtkPoints> points;
+  std::vector<vtkIdType> firstPoints;
+  for (int f = 0; f < NumberOfFragments; ++f)
+  {
+    int size = 1 + (f * 7) % 11;
+    firstPoints.push_back(points->GetNumberOfPoints());
+    for (int j = 0; j <= size; ++j)
+    {
+      for (int i = 0; i <= size; ++i)
+      {
+        points->InsertNextPoint(20.0 * f + i, j, 0.0);
+      }
+    }
+  }
+  vtkNew<vtkCellArray> verts;
+  vtkIdType lone = points->InsertNextPoint(-10.0, 0.0, 0.0);
+  points->InsertNextPoint(-20.0, 0.0, 0.0);
+
+  vtkNew<vtkCellArray> polys;
+  for (int k = 0; k < 121; ++k)
+  {
+    for (int n = 0; n < NumberOfFragments; ++n)
+    {
+      int f = (k % 2) ? NumberOfFragments - 1 - n : n;
+      int size = 1 + (f * 7) % 11;
+      if (k < size * size)
+      {
+        int i = k % size, j = k / size;
+        vtkIdType p = firstPoints[f] + i + j * (size + 1);
+        vtkIdType quad[4] = { p, p + 1, p + size + 2, p + size + 1 };
+        polys->InsertNextCell(4, quad);
+      }
+    }
+    if (k == 50)
+    {
+      verts->InsertNextCell(1, &lone);
+    }
+  }
+  pdata->SetPoints(points);
+  pdata->SetVerts(verts);
+  pdata->SetPolys(polys);
+}
+
+void MakeGrid(vtkPolyData *pdata, vtkUnstructuredGrid *ugrid)
+{
+  ugrid->SetPoints(pdata->GetPoints());
+  ugrid->Allocate(pdata->GetNumberOfCells());
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < pdata->GetNumberOfCells(); ++cellId)
+  {
+    pdata->GetCellPoints(cellId, ptIds);
+    ugrid->InsertNextCell(pdata->GetCellType(cellId), ptIds);
+  }
+}
+
+bool SameSizes(vtkIdTypeArray *a, vtkIdTypeArray *b, int numRegions)
+{
+  for (int i = 0; i < numRegions; ++i)
+  {
+    if (a->GetValue(i) != b->GetValue(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The points of each output cell are in the region of the cell.
+int CheckPointRegions(vtkPointSet *output, vtkIdTypeArray *cellRegions,
+                      const char *label)
+{
+  vtkIdTypeArray *pointRegions = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetPointData()->GetArray("RegionId"));
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      if (pointRegions->GetValue(ptIds->GetId(i)) !=
+          cellRegions->GetValue(cellId))
+      {
+        cerr << label << ": wrong region of point " << ptIds->GetId(i)
+             << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int TestConnectivityFilter(vtkUnstructuredGrid *ugrid)
+{
+  int rval = 0;
+  int modes[3] = { VTK_EXTRACT_ALL_REGIONS, VTK_EXTRACT_LARGEST_REGION,
+                   VTK_EXTRACT_SPECIFIED_REGIONS };
+  for (int mode : modes)
+  {
+    vtkNew<vtkConnectivityFilter> serial;
+    vtkNew<vtkConnectivityFilter> parallel;
+    parallel->ParallelLabelingOn();
+    vtkConnectivityFilter *filters[2] = { serial, parallel };
+    for (vtkConnectivityFilter *filter : filters)
+    {
+      filter->SetInputData(ugrid);
+      filter->SetExtractionMode(mode);
+      filter->AddSpecifiedRegion(3);
+      filter->AddSpecifiedRegion(17);
+      filter->ColorRegionsOn();
+      filter->Update();
+    }
+
+    vtkUnstructuredGrid *a = serial->GetUnstructuredGridOutput();
+    vtkUnstructuredGrid *b = parallel->GetUnstructuredGridOutput();
+    int numRegions = serial->GetNumberOfExtractedRegions();
+    if (numRegions != NumberOfFragments + 1 ||
+        parallel->GetNumberOfExtractedRegions() != numRegions ||
+        a->GetNumberOfCells() != b->GetNumberOfCells() ||
+        a->GetNumberOfPoints() != b->GetNumberOfPoints())
+    {
+      cerr << "vtkConnectivityFilter: expected " << numRegions
+           << " regions, got " << parallel->GetNumberOfExtractedRegions()
+           << endl;
+      return 1;
+    }
+    vtkIdTypeArray *aRegions = vtkArrayDownCast<vtkIdTypeArray>(
+      a->GetCellData()->GetArray("RegionId"));
+    vtkIdTypeArray *bRegions = vtkArrayDownCast<vtkIdTypeArray>(
+      b->GetCellData()->GetArray("RegionId"));
+    for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+    {
+      if (aRegions->GetValue(i) != bRegions->GetValue(i))
+      {
+        cerr << "vtkConnectivityFilter: wrong region of cell " << i << endl;
+        return 1;
+      }
+    }
+    // Only with all the regions are the cell region ids those of the output
+    // cells.
+    if (mode == VTK_EXTRACT_ALL_REGIONS)
+    {
+      rval |= CheckPointRegions(b, bRegions, "vtkConnectivityFilter");
+    }
+  }
+  return rval;
+}
+
+int TestPolyDataConnectivityFilter(vtkPolyData *pdata)
+{
+  vtkNew<vtkPolyDataConnectivityFilter> serial;
+  vtkNew<vtkPolyDataConnectivityFilter> parallel;
+  parallel->ParallelLabelingOn();
+  vtkPolyDataConnectivityFilter *filters[2] = { serial, parallel };
+  for (vtkPolyDataConnectivityFilter *filter : filters)
+  {
+    filter->SetInputData(pdata);
+    filter->SetExtractionModeToAllRegions();
+    filter->ColorRegionsOn();
+    filter->Update();
+  }
+
+  int numRegions = serial->GetNumberOfExtractedRegions();
+  if (numRegions != NumberOfFragments + 1 ||
+      parallel->GetNumberOfExtractedRegions() != numRegions ||
+      !SameSizes(serial->GetRegionSizes(), parallel->GetRegionSizes(),
+                 numRegions))
+  {
+    cerr << "vtkPolyDataConnectivityFilter: expected " << numRegions
+         << " regions, got " << parallel->GetNumberOfExtractedRegions()
+         << endl;
+    return 1;
+  }
+
+  // The cells keep their order, check their region from their points.
+  vtkPolyData *a = serial->GetOutput();
+  vtkPolyData *b = parallel->GetOutput();
+  vtkIdTypeArray *aRegions = vtkArrayDownCast<vtkIdTypeArray>(
+    a->GetPointData()->GetArray("RegionId"));
+  vtkIdTypeArray *bRegions = vtkArrayDownCast<vtkIdTypeArray>(
+    b->GetPointData()->GetArray("RegionId"));
+  vtkNew<vtkIdList> aIds;
+  vtkNew<vtkIdList> bIds;
+  for (vtkIdType cellId = 0; cellId < a->GetNumberOfCells(); ++cellId)
+  {
+    a->GetCellPoints(cellId, aIds);
+    b->GetCellPoints(cellId, bIds);
+    for (vtkIdType i = 0; i < aIds->GetNumberOfIds(); ++i)
+    {
+      double x[3], y[3];
+      a->GetPoint(aIds->GetId(i), x);
+      b->GetPoint(bIds->GetId(i), y);
+      if (x[0] != y[0] || x[1] != y[1] ||
+          aRegions->GetValue(aIds->GetId(i)) !=
+          bRegions->GetValue(bIds->GetId(i)))
+      {
+        cerr << "vtkPolyDataConnectivityFilter: wrong point of cell "
+             << cellId << endl;
+        return 1;
+      }
+    }
+  }
+
+  serial->SetExtractionModeToLargestRegion();
+  parallel->SetExtractionModeToLargestRegion();
+  serial->Update();
+  parallel->Update();
+  if (serial->GetOutput()->GetNumberOfCells() !=
+      parallel->GetOutput()->GetNumberOfCells() ||
+      parallel->GetOutput()->GetNumberOfCells() != 121)
+  {
+    cerr << "vtkPolyDataConnectivityFilter: wrong largest region" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestConnectivityFilterParallelLabeling(int, char *[])
+{
+  vtkNew<vtkPolyData> pdata;
+  MakeFragments(pdata);
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakeGrid(pdata, ugrid);
+
+  int rval = TestConnectivityFilter(ugrid);
+  rval |= TestPolyDataConnectivityFilter(pdata);
+  return rval;
+}
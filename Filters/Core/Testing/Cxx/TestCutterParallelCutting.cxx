@@ -0,0 +1,300 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCutterParallelCutting.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Cut an unstructured grid of all the linear 3D cell types with the union
+// of a sphere and of a plane through grid points, for several contour
+// values, serially and in parallel, and check that the triangles, their cell
+// data and the interpolated point data are the same.
+
+#include "vtkCellData.h"
+#include "vtkCutter.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImplicitBoolean.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSphere.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+const int Dim = 12;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Dim * (j + Dim * k);
+}
+
+double Temperature(const double x[3])
+{
+  return x[0] + 2.0 * x[1] - x[2];
+}
+
+// Each cube of the grid is a hexahedron, a voxel, five tetrahedra, two
+// wedges or three pyramids.
+void MakeGrid(vtkUnstructuredGrid *ugrid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("Temperature");
+  for (int k = 0; k < Dim; ++k)
+  {
+    for (int j = 0; j < Dim; ++j)
+    {
+      for (int i = 0; i < Dim; ++i)
+      {
+        double x[3] = { static_cast<double>(i), static_cast<double>(j),
+                        static_cast<double>(k) };
+        points->InsertNextPoint(x);
+        temperature->InsertNextValue(Temperature(x));
+      }
+    }
+  }
+  ugrid->SetPoints(points);
+  ugrid->GetPointData()->AddArray(temperature);
+
+  ugrid->Allocate((Dim - 1) * (Dim - 1) * (Dim - 1) * 5);
+  for (int k = 0; k < Dim - 1; ++k)
+  {
+    for (int j = 0; j < Dim - 1; ++j)
+    {
+      for (int i = 0; i < Dim - 1; ++i)
+      {
+        vtkIdType p[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        switch ((i + 2 * j + 3 * k) % 5)
+        {
+          case 0:
+            ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+            break;
+          case 1:
+          {
+            vtkIdType voxel[8] = { p[0], p[1], p[3], p[2],
+                                   p[4], p[5], p[7], p[6] };
+            ugrid->InsertNextCell(VTK_VOXEL, 8, voxel);
+            break;
+          }
+          case 2:
+          {
+            vtkIdType tetras[5][4] = { { p[0], p[1], p[3], p[4] },
+                                       { p[1], p[2], p[3], p[6] },
+                                       { p[1], p[4], p[5], p[6] },
+                                       { p[3], p[4], p[6], p[7] },
+                                       { p[1], p[3], p[4], p[6] } };
+            for (int t = 0; t < 5; ++t)
+            {
+              ugrid->InsertNextCell(VTK_TETRA, 4, tetras[t]);
+            }
+            break;
+          }
+          case 3:
+          {
+            vtkIdType wedges[2][6] = { { p[0], p[1], p[3], p[4], p[5], p[7] },
+                                       { p[1], p[2], p[3], p[5], p[6], p[7] } };
+            ugrid->InsertNextCell(VTK_WEDGE, 6, wedges[0]);
+            ugrid->InsertNextCell(VTK_WEDGE, 6, wedges[1]);
+            break;
+          }
+          default:
+          {
+            vtkIdType pyramids[3][5] = { { p[0], p[1], p[2], p[3], p[6] },
+                                         { p[0], p[4], p[5], p[1], p[6] },
+                                         { p[0], p[3], p[7], p[4], p[6] } };
+            for (int t = 0; t < 3; ++t)
+            {
+              ugrid->InsertNextCell(VTK_PYRAMID, 5, pyramids[t]);
+            }
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfTuples(ugrid->GetNumberOfCells());
+  for (vtkIdType i = 0; i < ugrid->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  ugrid->GetCellData()->AddArray(cellIds);
+}
+
+// The triangles as their sorted, rounded, point coordinates and their input
+// cell.
+typedef std::array<long long, 10> TriangleKey;
+
+std::vector<TriangleKey> GetTriangles(vtkPolyData *output)
+{
+  std::vector<TriangleKey> triangles;
+  vtkIdTypeArray *cellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    output->GetCellData()->GetArray("CellIds"));
+  vtkNew<vtkIdList> pts;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    output->GetCellPoints(cellId, pts);
+    std::array<std::array<long long, 3>, 3> corners;
+    for (int i = 0; i < 3; ++i)
+    {
+      double x[3];
+      output->GetPoint(pts->GetId(i), x);
+      for (int j = 0; j < 3; ++j)
+      {
+        corners[i][j] = std::llround(x[j] * 1e6);
+      }
+    }
+    std::sort(corners.begin(), corners.end());
+    TriangleKey key;
+    for (int i = 0; i < 9; ++i)
+    {
+      key[i] = corners[i / 3][i % 3];
+    }
+    key[9] = cellIds ? cellIds->GetValue(cellId) : -1;
+    triangles.push_back(key);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+int CheckPointData(vtkPolyData *output, const double *values,
+                   const char *label)
+{
+  vtkDataArray *temperature = output->GetPointData()->GetArray("Temperature");
+  vtkDataArray *cutScalars = output->GetPointData()->GetScalars();
+  if (!temperature || !cutScalars)
+  {
+    cerr << label << ": missing point data" << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    output->GetPoint(i, x);
+    double s = cutScalars->GetTuple1(i);
+    if (std::abs(temperature->GetTuple1(i) - Temperature(x)) > 1e-9 ||
+        std::min({ std::abs(s - values[0]), std::abs(s - values[1]),
+                   std::abs(s - values[2]) }) > 1e-9)
+    {
+      cerr << label << ": wrong point data at point " << i << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}
+
+int TestCutterParallelCutting(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakeGrid(ugrid);
+
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(5.2, 5.1, 4.9);
+  sphere->SetRadius(3.3);
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.0, 0.0, 4.0);
+  plane->SetNormal(0.0, 0.0, 1.0);
+  vtkNew<vtkImplicitBoolean> function;
+  function->SetOperationTypeToUnion();
+  function->AddFunction(sphere);
+  function->AddFunction(plane);
+
+  const double values[3] = { 0.0, 0.7, 2.0 };
+  vtkNew<vtkCutter> serial;
+  vtkNew<vtkCutter> parallel;
+  parallel->ParallelCuttingOn();
+  vtkCutter *cutters[2] = { serial, parallel };
+  for (vtkCutter *cutter : cutters)
+  {
+    cutter->SetInputData(ugrid);
+    cutter->SetCutFunction(function);
+    for (int i = 0; i < 3; ++i)
+    {
+      cutter->SetValue(i, values[i]);
+    }
+    cutter->GenerateCutScalarsOn();
+  }
+  serial->Update();
+  vtkPolyData *a = serial->GetOutput();
+  std::vector<TriangleKey> expected = GetTriangles(a);
+
+  // The serial cutter merges the points with a locator, which keeps the
+  // points interpolated along an edge in both directions apart, so only the
+  // triangles are compared.
+  int rval = 0;
+  for (int sortBy = VTK_SORT_BY_VALUE; sortBy <= VTK_SORT_BY_CELL; ++sortBy)
+  {
+    parallel->SetSortBy(sortBy);
+    parallel->Update();
+
+    const char *label = sortBy == VTK_SORT_BY_VALUE ? "sort by value" :
+      "sort by cell";
+    vtkPolyData *b = parallel->GetOutput();
+    if (b->GetNumberOfCells() < 1000 ||
+        b->GetNumberOfPolys() != b->GetNumberOfCells() ||
+        a->GetNumberOfCells() != b->GetNumberOfCells() ||
+        a->GetNumberOfPoints() < b->GetNumberOfPoints())
+    {
+      cerr << label << ": expected " << a->GetNumberOfCells()
+           << " triangles and " << a->GetNumberOfPoints() << " points, got "
+           << b->GetNumberOfCells() << " and " << b->GetNumberOfPoints()
+           << endl;
+      rval = 1;
+      continue;
+    }
+    if (GetTriangles(b) != expected)
+    {
+      cerr << label << ": the triangles differ" << endl;
+      rval = 1;
+    }
+    rval |= CheckPointData(b, values, label);
+
+    // Sorting by cell outputs the triangles of each contour value in turn.
+    if (sortBy == VTK_SORT_BY_CELL)
+    {
+      vtkDataArray *cutScalars = b->GetPointData()->GetScalars();
+      vtkNew<vtkIdList> pts;
+      double previous = values[0];
+      for (vtkIdType cellId = 0; cellId < b->GetNumberOfCells(); ++cellId)
+      {
+        b->GetCellPoints(cellId, pts);
+        double s = cutScalars->GetTuple1(pts->GetId(0));
+        if (s < previous - 1e-9)
+        {
+          cerr << label << ": the contour values are not sorted" << endl;
+          rval = 1;
+          break;
+        }
+        previous = s;
+      }
+    }
+  }
+  return rval;
+}
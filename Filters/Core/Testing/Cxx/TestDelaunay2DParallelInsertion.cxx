@@ -0,0 +1,292 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDelaunay2DParallelInsertion.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Triangulate random points with the ParallelInsertion mode of
+// vtkDelaunay2D, compare the result with the serial insertion for the
+// alpha, bounding triangulation and constraint options, and check the
+// Delaunay criterion on a large point set, which must be triangulated in
+// blocks. (Without these options, edges are swapped around the points
+// connected to the bounding triangulation only, in an order that depends on
+// the insertion.)
+
+#include "vtkCellArray.h"
+#include "vtkDelaunay2D.h"
+#include "vtkIdList.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticPointLocator.h"
+#include "vtkTriangle.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <set>
+#include <utility>
+
+// Tell the number of blocks of the last parallel insertion.
+class vtkBlockCountingDelaunay2D : public vtkDelaunay2D
+{
+public:
+  static vtkBlockCountingDelaunay2D *New();
+  vtkTypeMacro(vtkBlockCountingDelaunay2D, vtkDelaunay2D);
+  vtkIdType GetNumberOfBlocks() { return this->NumberOfBlocks; }
+};
+vtkStandardNewMacro(vtkBlockCountingDelaunay2D);
+
+namespace
+{
+
+typedef std::array<vtkIdType, 3> TriangleType;
+
+void MakePoints(vtkPolyData *polyData, vtkIdType numPts, int seed)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(seed);
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+  {
+    double x = random->GetValue();
+    random->Next();
+    double y = random->GetValue();
+    random->Next();
+    points->SetPoint(ptId, x, y, 0.1 * std::sin(5.0 * x) * std::cos(3.0 * y));
+  }
+  polyData->SetPoints(points);
+}
+
+std::set<TriangleType> GetTriangles(vtkPolyData *polyData)
+{
+  std::set<TriangleType> triangles;
+  vtkCellArray *polys = polyData->GetPolys();
+  vtkIdType npts, *pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    TriangleType tri = { { pts[0], pts[1], pts[2] } };
+    std::sort(tri.begin(), tri.end());
+    triangles.insert(tri);
+  }
+  return triangles;
+}
+
+// Run the serial and the parallel insertion with the same options and
+// compare their output cells.
+int CompareInsertions(const char *name, vtkPolyData *input,
+                      vtkPolyData *source, double alpha,
+                      bool boundingTriangulation)
+{
+  vtkNew<vtkDelaunay2D> serial;
+  serial->SetInputData(input);
+  serial->SetSourceData(source);
+  serial->SetAlpha(alpha);
+  serial->SetBoundingTriangulation(boundingTriangulation);
+  serial->Update();
+
+  vtkNew<vtkDelaunay2D> parallel;
+  parallel->SetInputData(input);
+  parallel->SetSourceData(source);
+  parallel->SetAlpha(alpha);
+  parallel->SetBoundingTriangulation(boundingTriangulation);
+  parallel->ParallelInsertionOn();
+  parallel->Update();
+
+  vtkPolyData *serialOutput = serial->GetOutput();
+  vtkPolyData *parallelOutput = parallel->GetOutput();
+  if (parallelOutput->GetNumberOfPoints() !=
+        serialOutput->GetNumberOfPoints() ||
+      parallelOutput->GetNumberOfVerts() != serialOutput->GetNumberOfVerts() ||
+      parallelOutput->GetNumberOfLines() != serialOutput->GetNumberOfLines() ||
+      GetTriangles(parallelOutput) != GetTriangles(serialOutput))
+  {
+    cerr << name << ": parallel insertion gives "
+         << parallelOutput->GetNumberOfVerts() << " vertices, "
+         << parallelOutput->GetNumberOfLines() << " lines and "
+         << parallelOutput->GetNumberOfPolys() << " triangles instead of "
+         << serialOutput->GetNumberOfVerts() << ", "
+         << serialOutput->GetNumberOfLines() << " and "
+         << serialOutput->GetNumberOfPolys() << endl;
+    return 1;
+  }
+  return 0;
+}
+
+// Check that the output, which includes the bounding triangulation, is a
+// triangulation of all its points whose triangles have empty circumcircles.
+// The points left out must lie within the tolerance of a triangulated point.
+int CheckDelaunay(vtkPolyData *output, double tol)
+{
+  std::map<std::pair<vtkIdType, vtkIdType>, int> edges;
+  std::set<vtkIdType> usedPts;
+  vtkCellArray *polys = output->GetPolys();
+  vtkIdType npts, *pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      usedPts.insert(pts[i]);
+      vtkIdType p1 = std::min(pts[i], pts[(i + 1) % 3]);
+      vtkIdType p2 = std::max(pts[i], pts[(i + 1) % 3]);
+      edges[std::make_pair(p1, p2)]++;
+    }
+  }
+  vtkIdType numBoundaryEdges = 0;
+  for (std::map<std::pair<vtkIdType, vtkIdType>, int>::iterator it =
+         edges.begin(); it != edges.end(); ++it)
+  {
+    if (it->second > 2)
+    {
+      cerr << "Edge (" << it->first.first << "," << it->first.second
+           << ") is used by " << it->second << " triangles" << endl;
+      return 1;
+    }
+    numBoundaryEdges += (it->second == 1);
+  }
+  vtkIdType numUsedPts = static_cast<vtkIdType>(usedPts.size());
+  if (numBoundaryEdges != 8 ||
+      output->GetNumberOfPolys() != 2 * numUsedPts - 10)
+  {
+    cerr << output->GetNumberOfPolys() << " triangles use " << numUsedPts
+         << " points of " << output->GetNumberOfPoints() << " with "
+         << numBoundaryEdges << " boundary edges" << endl;
+    return 1;
+  }
+
+  vtkNew<vtkPoints> points2D;
+  points2D->SetDataTypeToDouble();
+  points2D->DeepCopy(output->GetPoints());
+  for (vtkIdType ptId = 0; ptId < points2D->GetNumberOfPoints(); ptId++)
+  {
+    double x[3];
+    points2D->GetPoint(ptId, x);
+    points2D->SetPoint(ptId, x[0], x[1], 0.0);
+  }
+  vtkNew<vtkPolyData> polyData2D;
+  polyData2D->SetPoints(points2D);
+  vtkNew<vtkStaticPointLocator> locator;
+  locator->SetDataSet(polyData2D);
+  locator->BuildLocator();
+
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType ptId = 0; ptId < points2D->GetNumberOfPoints(); ptId++)
+  {
+    if (usedPts.count(ptId))
+    {
+      continue;
+    }
+    bool duplicate = false;
+    locator->FindPointsWithinRadius(tol, points2D->GetPoint(ptId), ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); i++)
+    {
+      duplicate |= (usedPts.count(ptIds->GetId(i)) != 0);
+    }
+    if (!duplicate)
+    {
+      cerr << "Point " << ptId << " is not triangulated" << endl;
+      return 1;
+    }
+  }
+
+  vtkIdType numBad = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    double x1[3], x2[3], x3[3], center[3];
+    points2D->GetPoint(pts[0], x1);
+    points2D->GetPoint(pts[1], x2);
+    points2D->GetPoint(pts[2], x3);
+    double radius2 = vtkTriangle::Circumcircle(x1, x2, x3, center);
+    center[2] = 0.0;
+    locator->FindPointsWithinRadius(
+      std::sqrt(radius2) * (1.0 - 1.0e-9), center, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); i++)
+    {
+      vtkIdType ptId = ptIds->GetId(i);
+      numBad += (ptId != pts[0] && ptId != pts[1] && ptId != pts[2] &&
+                 usedPts.count(ptId) != 0);
+    }
+  }
+  if (numBad > 0)
+  {
+    cerr << numBad << " points lie in the circumcircle of a triangle" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestDelaunay2DParallelInsertion(int, char *[])
+{
+  int rval = 0;
+
+  // Compare with the serial insertion
+  vtkNew<vtkPolyData> input;
+  MakePoints(input, 5000, 1);
+  rval |= CompareInsertions("Bounding triangulation", input, nullptr, 0.0,
+                            true);
+  rval |= CompareInsertions("Alpha", input, nullptr, 0.015, false);
+
+  // A square with a square hole, as a constraint. The points of the loops
+  // are appended to the random points.
+  vtkNew<vtkPolyData> constrained;
+  MakePoints(constrained, 2000, 2);
+  vtkPoints *points = constrained->GetPoints();
+  vtkNew<vtkCellArray> loops;
+  double corners[2][4][2] = {
+    { { 0.02, 0.02 }, { 0.98, 0.02 }, { 0.98, 0.98 }, { 0.02, 0.98 } },
+    { { 0.3, 0.3 }, { 0.3, 0.7 }, { 0.7, 0.7 }, { 0.7, 0.3 } } };
+  for (int loop = 0; loop < 2; loop++)
+  {
+    const int numPerSide = 20;
+    loops->InsertNextCell(4 * numPerSide);
+    for (int side = 0; side < 4; side++)
+    {
+      double *c1 = corners[loop][side];
+      double *c2 = corners[loop][(side + 1) % 4];
+      for (int i = 0; i < numPerSide; i++)
+      {
+        double t = static_cast<double>(i) / numPerSide;
+        loops->InsertCellPoint(points->InsertNextPoint(
+          c1[0] + t * (c2[0] - c1[0]), c1[1] + t * (c2[1] - c1[1]), 0.0));
+      }
+    }
+  }
+  vtkNew<vtkPolyData> source;
+  source->SetPoints(points);
+  source->SetPolys(loops);
+  rval |= CompareInsertions("Constrained", constrained, source, 0.0, false);
+
+  // A point set large enough to be split in blocks, whose seams must be
+  // stitched without falling back to the serial insertion
+  vtkNew<vtkPolyData> large;
+  MakePoints(large, 150000, 3);
+  vtkNew<vtkBlockCountingDelaunay2D> delaunay;
+  delaunay->SetInputData(large);
+  delaunay->BoundingTriangulationOn();
+  delaunay->ParallelInsertionOn();
+  delaunay->Update();
+  if (delaunay->GetNumberOfBlocks() < 2)
+  {
+    cerr << "The large point set was not triangulated in blocks" << endl;
+    rval = 1;
+  }
+  rval |= CheckDelaunay(delaunay->GetOutput(),
+                        delaunay->GetTolerance() * large->GetLength());
+
+  return rval;
+}
@@ -0,0 +1,336 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DParallelGlyphing.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Glyph points with ghost points, serially and in parallel, with a single
+// source or a table of sources, with the default source, and with the
+// various scaling and coloring modes, and check that the outputs are the
+// same.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTransform.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cmath>
+
+namespace
+{
+
+// Points with scalars, vectors, another point array and ghost points.
+void MakeInput(vtkPolyData *input)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(2);
+  const vtkIdType numPts = 5000;
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(numPts);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("Temperature");
+  temperature->SetNumberOfTuples(numPts);
+  vtkNew<vtkUnsignedCharArray> ghosts;
+  ghosts->SetName(vtkDataSetAttributes::GhostArrayName());
+  ghosts->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3], v[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      x[j] = random->GetRangeValue(-10.0, 10.0);
+      random->Next();
+      v[j] = random->GetRangeValue(-1.0, 1.0);
+      random->Next();
+    }
+    // Some vectors along x, and a zero vector.
+    if (i % 10 == 0)
+    {
+      v[1] = v[2] = 0.0;
+    }
+    if (i == 7)
+    {
+      v[0] = 0.0;
+    }
+    points->SetPoint(i, x);
+    vectors->SetTuple(i, v);
+    scalars->SetValue(i, static_cast<float>(random->GetRangeValue(0.0, 2.0)));
+    random->Next();
+    temperature->SetValue(i, x[0] - x[1]);
+    ghosts->SetValue(i, i % 13 == 0 ? vtkDataSetAttributes::DUPLICATEPOINT : 0);
+  }
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->AddArray(temperature);
+  input->GetPointData()->AddArray(ghosts);
+}
+
+// A pyramid of triangles with normals and texture coordinates, or a square
+// of quads with normals.
+void MakeSource(vtkPolyData *source, bool pyramid)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> polys;
+  if (pyramid)
+  {
+    double x[5][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 0, 1, 0 },
+                       { 0.5, 0.5, 1 } };
+    for (int i = 0; i < 5; ++i)
+    {
+      points->InsertNextPoint(x[i]);
+    }
+    vtkIdType triangles[6][3] = { { 0, 2, 1 }, { 0, 3, 2 }, { 0, 1, 4 },
+                                  { 1, 2, 4 }, { 2, 3, 4 }, { 3, 0, 4 } };
+    for (int i = 0; i < 6; ++i)
+    {
+      polys->InsertNextCell(3, triangles[i]);
+    }
+    vtkNew<vtkFloatArray> tcoords;
+    tcoords->SetNumberOfComponents(2);
+    for (int i = 0; i < 5; ++i)
+    {
+      tcoords->InsertNextTuple2(x[i][0], x[i][1]);
+    }
+    source->GetPointData()->SetTCoords(tcoords);
+  }
+  else
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        points->InsertNextPoint(0.5 * i, 0.5 * j, 0.1 * i * j);
+      }
+    }
+    for (int j = 0; j < 2; ++j)
+    {
+      for (int i = 0; i < 2; ++i)
+      {
+        vtkIdType quad[4] = { 3 * j + i, 3 * j + i + 1, 3 * j + i + 4,
+                              3 * j + i + 3 };
+        polys->InsertNextCell(4, quad);
+      }
+    }
+  }
+  source->SetPoints(points);
+  source->SetPolys(polys);
+
+  vtkNew<vtkFloatArray> normals;
+  normals->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    normals->InsertNextTuple3(x[0] - 0.5, x[1] - 0.5, x[2] + 0.5);
+  }
+  source->GetPointData()->SetNormals(normals);
+}
+
+bool SameArrays(vtkFieldData *a, vtkFieldData *b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray *x = a->GetArray(i);
+    vtkDataArray *y = b->GetArray(x->GetName());
+    if (!y || x->GetNumberOfValues() != y->GetNumberOfValues())
+    {
+      cerr << "array " << x->GetName() << " differs" << endl;
+      return false;
+    }
+    for (vtkIdType j = 0; j < x->GetNumberOfValues(); ++j)
+    {
+      double u = x->GetComponent(j / x->GetNumberOfComponents(),
+                                 j % x->GetNumberOfComponents());
+      double v = y->GetComponent(j / y->GetNumberOfComponents(),
+                                 j % y->GetNumberOfComponents());
+      if (std::abs(u - v) > 1e-5 * (1.0 + std::abs(u)))
+      {
+        cerr << "array " << x->GetName() << " differs at " << j << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameCells(vtkCellArray *a, vtkCellArray *b)
+{
+  vtkIdTypeArray *x = a->GetData();
+  vtkIdTypeArray *y = b->GetData();
+  if (a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      x->GetNumberOfValues() != y->GetNumberOfValues())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < x->GetNumberOfValues(); ++i)
+  {
+    if (x->GetValue(i) != y->GetValue(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Glyph serially and in parallel with the same settings.
+int Compare(vtkGlyph3D *serial, const char *label)
+{
+  vtkNew<vtkGlyph3D> parallel;
+  parallel->SetInputConnection(0, serial->GetInputConnection(0, 0));
+  for (int i = 0; i < serial->GetNumberOfInputConnections(1); ++i)
+  {
+    parallel->AddInputConnection(1, serial->GetInputConnection(1, i));
+  }
+  for (int i = 0; i < 4; ++i)
+  {
+    vtkInformation *info = serial->GetInputArrayInformation(i);
+    parallel->GetInputArrayInformation(i)->Copy(info);
+  }
+  parallel->SetScaling(serial->GetScaling());
+  parallel->SetScaleMode(serial->GetScaleMode());
+  parallel->SetColorMode(serial->GetColorMode());
+  parallel->SetScaleFactor(serial->GetScaleFactor());
+  parallel->SetRange(serial->GetRange());
+  parallel->SetOrient(serial->GetOrient());
+  parallel->SetClamping(serial->GetClamping());
+  parallel->SetVectorMode(serial->GetVectorMode());
+  parallel->SetIndexMode(serial->GetIndexMode());
+  parallel->SetGeneratePointIds(serial->GetGeneratePointIds());
+  parallel->SetFillCellData(serial->GetFillCellData());
+  parallel->SetSourceTransform(serial->GetSourceTransform());
+  parallel->SetOutputPointsPrecision(serial->GetOutputPointsPrecision());
+  parallel->ParallelGlyphingOn();
+  serial->Update();
+  parallel->Update();
+
+  vtkPolyData *a = serial->GetOutput();
+  vtkPolyData *b = parallel->GetOutput();
+  if (a->GetNumberOfPoints() < 1000 ||
+      a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells() ||
+      a->GetPoints()->GetDataType() != b->GetPoints()->GetDataType())
+  {
+    cerr << label << ": expected " << a->GetNumberOfPoints() << " points and "
+         << a->GetNumberOfCells() << " cells, got " << b->GetNumberOfPoints()
+         << " and " << b->GetNumberOfCells() << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    for (int j = 0; j < 3; ++j)
+    {
+      if (std::abs(x[j] - y[j]) > 1e-5 * (1.0 + std::abs(x[j])))
+      {
+        cerr << label << ": the points differ at " << i << endl;
+        return 1;
+      }
+    }
+  }
+  if (!SameCells(a->GetVerts(), b->GetVerts()) ||
+      !SameCells(a->GetLines(), b->GetLines()) ||
+      !SameCells(a->GetPolys(), b->GetPolys()) ||
+      !SameCells(a->GetStrips(), b->GetStrips()))
+  {
+    cerr << label << ": the cells differ" << endl;
+    return 1;
+  }
+  if (!SameArrays(a->GetPointData(), b->GetPointData()) ||
+      !SameArrays(a->GetCellData(), b->GetCellData()))
+  {
+    cerr << label << ": the attributes differ" << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestGlyph3DParallelGlyphing(int, char *[])
+{
+  vtkNew<vtkPolyData> input;
+  MakeInput(input);
+  vtkNew<vtkPolyData> pyramid;
+  MakeSource(pyramid, true);
+  vtkNew<vtkPolyData> square;
+  MakeSource(square, false);
+  int rval = 0;
+
+  // Oriented, scaled by scalar and colored by scale, with point ids, cell
+  // data and a source transform.
+  vtkNew<vtkTransform> transform;
+  transform->RotateX(30.0);
+  transform->Translate(-0.5, -0.5, 0.0);
+  vtkNew<vtkGlyph3D> single;
+  single->SetInputData(input);
+  single->SetSourceData(pyramid);
+  single->SetScaleFactor(0.3);
+  single->GeneratePointIdsOn();
+  single->FillCellDataOn();
+  single->SetSourceTransform(transform);
+  rval |= Compare(single, "single source");
+
+  // In double precision, scaled by vector components with clamping and
+  // colored by another array.
+  single->SetScaleModeToScaleByVectorComponents();
+  single->ClampingOn();
+  single->SetRange(-0.5, 0.5);
+  single->SetColorModeToColorByScalar();
+  single->SetInputArrayToProcess(3, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "Temperature");
+  single->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  rval |= Compare(single, "vector components");
+
+  // A table of sources indexed by vector, scaled by vector and colored by
+  // vector magnitude.
+  vtkNew<vtkGlyph3D> table;
+  table->SetInputData(input);
+  table->SetSourceData(0, pyramid);
+  table->SetSourceData(1, square);
+  table->SetIndexModeToVector();
+  table->SetScaleModeToScaleByVector();
+  table->SetColorModeToColorByVector();
+  table->SetRange(0.0, 1.5);
+  rval |= Compare(table, "table of sources");
+
+  // The default source, a line, without orientation.
+  vtkNew<vtkGlyph3D> line;
+  line->SetInputData(input);
+  line->OrientOff();
+  line->SetScaleModeToDataScalingOff();
+  rval |= Compare(line, "default source");
+
+  return rval;
+}
@@ -0,0 +1,168 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormalsSplitting.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compute the normals of the surface of a cube made of quads, with and
+// without splitting its sharp edges, and check the new points and normals.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+
+#include <array>
+#include <cmath>
+#include <map>
+
+namespace
+{
+
+const int Size = 40;
+
+// The surface of the cube [0, Size]^3, each face being made of Size^2 quads
+// oriented outwards. The points on the edges are shared between the faces.
+void MakeCube(vtkPolyData *cube)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> quads;
+  std::map<std::array<int, 3>, vtkIdType> ids;
+  auto pointId = [&](const std::array<int, 3> &x)
+  {
+    auto it = ids.find(x);
+    if (it != ids.end())
+    {
+      return it->second;
+    }
+    vtkIdType id = points->InsertNextPoint(x[0], x[1], x[2]);
+    ids[x] = id;
+    return id;
+  };
+
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    int u = (axis + 1) % 3;
+    int v = (axis + 2) % 3;
+    for (int side = 0; side < 2; ++side)
+    {
+      for (int j = 0; j < Size; ++j)
+      {
+        for (int i = 0; i < Size; ++i)
+        {
+          std::array<int, 3> corners[4];
+          for (int k = 0; k < 4; ++k)
+          {
+            corners[k][axis] = side * Size;
+            corners[k][u] = i + (k == 1 || k == 2);
+            corners[k][v] = j + (k == 2 || k == 3);
+          }
+          vtkIdType quad[4];
+          for (int k = 0; k < 4; ++k)
+          {
+            quad[side ? k : 3 - k] = pointId(corners[k]);
+          }
+          quads->InsertNextCell(4, quad);
+        }
+      }
+    }
+  }
+  cube->SetPoints(points);
+  cube->SetPolys(quads);
+}
+
+}
+
+int TestPolyDataNormalsSplitting(int, char *[])
+{
+  vtkNew<vtkPolyData> cube;
+  MakeCube(cube);
+  const vtkIdType numFacePoints = (Size + 1) * (Size + 1);
+
+  // With splitting, each face gets its own points, with the face normal.
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputData(cube);
+  normals->ComputeCellNormalsOn();
+  normals->Update();
+  vtkPolyData *output = normals->GetOutput();
+  if (output->GetNumberOfPoints() != 6 * numFacePoints)
+  {
+    cerr << "Expected " << 6 * numFacePoints << " points with splitting, got "
+         << output->GetNumberOfPoints() << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkDataArray *pointNormals = output->GetPointData()->GetNormals();
+  vtkDataArray *cellNormals = output->GetCellData()->GetNormals();
+  vtkNew<vtkIdList> ids;
+  for (vtkIdType cellId = 0; cellId < output->GetNumberOfCells(); ++cellId)
+  {
+    double cellNormal[3];
+    cellNormals->GetTuple(cellId, cellNormal);
+    output->GetCellPoints(cellId, ids);
+    for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+    {
+      double n[3];
+      pointNormals->GetTuple(ids->GetId(i), n);
+      if (n[0] != cellNormal[0] || n[1] != cellNormal[1] ||
+          n[2] != cellNormal[2] ||
+          std::fabs(n[0]) + std::fabs(n[1]) + std::fabs(n[2]) != 1.0)
+      {
+        cerr << "Wrong normal at point " << ids->GetId(i) << " of cell "
+             << cellId << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // Without splitting, the corner normals are along the diagonals.
+  normals->SplittingOff();
+  normals->Update();
+  output = normals->GetOutput();
+  if (output->GetNumberOfPoints() != cube->GetNumberOfPoints())
+  {
+    cerr << "Expected " << cube->GetNumberOfPoints()
+         << " points without splitting, got " << output->GetNumberOfPoints()
+         << endl;
+    return EXIT_FAILURE;
+  }
+  pointNormals = output->GetPointData()->GetNormals();
+  for (vtkIdType ptId = 0; ptId < output->GetNumberOfPoints(); ++ptId)
+  {
+    double x[3], n[3];
+    output->GetPoint(ptId, x);
+    pointNormals->GetTuple(ptId, n);
+    int onFaces = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+      double expected = (x[i] == 0.0) ? -1.0 : (x[i] == Size ? 1.0 : 0.0);
+      onFaces += (expected != 0.0);
+      if (expected * n[i] < 0.0 || (expected == 0.0 && n[i] != 0.0))
+      {
+        cerr << "Wrong normal at point " << ptId << endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (onFaces == 3 &&
+        std::fabs(std::fabs(n[0]) - 1.0 / std::sqrt(3.0)) > 1e-6)
+    {
+      cerr << "Wrong normal at corner " << ptId << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,252 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClusteringOutOfCore.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimate a surface streamed in pieces with vtkQuadricClustering, with
+// dense and sparse bins, serially and in parallel, and compare the results
+// with the decimation of the whole surface.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkFloatArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkQuadricClustering.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <cmath>
+
+namespace
+{
+
+// A torus whose pieces are bands of rows. Each piece has its own copy of the
+// points of its rows, so the points on the seams are duplicated.
+class TestTorusPieceSource : public vtkPolyDataAlgorithm
+{
+public:
+  static TestTorusPieceSource *New();
+  vtkTypeMacro(TestTorusPieceSource, vtkPolyDataAlgorithm);
+
+  vtkGetMacro(Executions, int);
+
+  static const int NU = 120;
+  static const int NV = 60;
+
+protected:
+  TestTorusPieceSource() : Executions(0)
+  {
+    this->SetNumberOfInputPorts(0);
+  }
+
+  int RequestInformation(vtkInformation *, vtkInformationVector **,
+                         vtkInformationVector *outputVector) override
+  {
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(CAN_HANDLE_PIECE_REQUEST(), 1);
+    return 1;
+  }
+
+  int RequestData(vtkInformation *, vtkInformationVector **,
+                  vtkInformationVector *outputVector) override
+  {
+    ++this->Executions;
+    vtkInformation *outInfo = outputVector->GetInformationObject(0);
+    vtkPolyData *output = vtkPolyData::GetData(outInfo);
+    int piece = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    int numPieces = outInfo->Get(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    int row0 = piece * NV / numPieces;
+    int row1 = (piece + 1) * NV / numPieces;
+
+    vtkNew<vtkPoints> points;
+    for (int j = row0; j <= row1; ++j)
+    {
+      for (int i = 0; i < NU; ++i)
+      {
+        double u = 2.0 * vtkMath::Pi() * i / NU;
+        double v = 2.0 * vtkMath::Pi() * (j % NV) / NV;
+        double r = 0.3 + 0.02 * std::sin(5.0 * u) * std::cos(3.0 * v);
+        points->InsertNextPoint((1.0 + r * std::cos(v)) * std::cos(u),
+                                (1.0 + r * std::cos(v)) * std::sin(u),
+                                r * std::sin(v));
+      }
+    }
+    vtkNew<vtkCellArray> triangles;
+    vtkNew<vtkFloatArray> rows;
+    rows->SetName("Rows");
+    for (int j = row0; j < row1; ++j)
+    {
+      for (int i = 0; i < NU; ++i)
+      {
+        vtkIdType p0 = i + NU * (j - row0), p1 = (i + 1) % NU + NU * (j - row0);
+        vtkIdType t0[3] = { p0, p1, p1 + NU }, t1[3] = { p0, p1 + NU, p0 + NU };
+        triangles->InsertNextCell(3, t0);
+        triangles->InsertNextCell(3, t1);
+        rows->InsertNextValue(j);
+        rows->InsertNextValue(j);
+      }
+    }
+    output->SetPoints(points);
+    output->SetPolys(triangles);
+    output->GetCellData()->AddArray(rows);
+    return 1;
+  }
+
+  int Executions;
+
+private:
+  TestTorusPieceSource(const TestTorusPieceSource&) = delete;
+  void operator=(const TestTorusPieceSource&) = delete;
+};
+vtkStandardNewMacro(TestTorusPieceSource);
+
+// Compare the cells, the points and the cell data of two outputs.
+int CompareOutputs(const char *name, vtkPolyData *expected,
+                   vtkPolyData *output, double tolerance)
+{
+  if (output->GetNumberOfPoints() != expected->GetNumberOfPoints() ||
+      output->GetNumberOfPolys() != expected->GetNumberOfPolys())
+  {
+    cerr << name << ": " << output->GetNumberOfPoints() << " points and "
+         << output->GetNumberOfPolys() << " triangles instead of "
+         << expected->GetNumberOfPoints() << " and "
+         << expected->GetNumberOfPolys() << endl;
+    return 1;
+  }
+  vtkIdTypeArray *cells = output->GetPolys()->GetData();
+  vtkIdTypeArray *expectedCells = expected->GetPolys()->GetData();
+  for (vtkIdType i = 0; i < cells->GetNumberOfValues(); ++i)
+  {
+    if (cells->GetValue(i) != expectedCells->GetValue(i))
+    {
+      cerr << name << ": the triangles differ" << endl;
+      return 1;
+    }
+  }
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    output->GetPoint(i, x);
+    expected->GetPoint(i, y);
+    if (std::sqrt(vtkMath::Distance2BetweenPoints(x, y)) > tolerance)
+    {
+      cerr << name << ": point " << i << " differs" << endl;
+      return 1;
+    }
+  }
+  vtkDataArray *rows = output->GetCellData()->GetArray("Rows");
+  vtkDataArray *expectedRows = expected->GetCellData()->GetArray("Rows");
+  for (vtkIdType i = 0; i < output->GetNumberOfPolys(); ++i)
+  {
+    if (!rows || rows->GetTuple1(i) != expectedRows->GetTuple1(i))
+    {
+      cerr << name << ": the cell data differ" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}
+
+int TestQuadricClusteringOutOfCore(int, char *[])
+{
+  // The decimation of the whole surface.
+  vtkNew<TestTorusPieceSource> source;
+  vtkNew<vtkQuadricClustering> whole;
+  whole->SetInputConnection(source->GetOutputPort());
+  whole->SetNumberOfDivisions(40, 40, 10);
+  whole->AutoAdjustNumberOfDivisionsOff();
+  whole->CopyCellDataOn();
+  whole->Update();
+  vtkPolyData *expected = whole->GetOutput();
+  if (expected->GetNumberOfPolys() == 0 ||
+      expected->GetNumberOfPolys() >= 2 * TestTorusPieceSource::NU *
+                                       TestTorusPieceSource::NV)
+  {
+    cerr << "The surface was not decimated" << endl;
+    return 1;
+  }
+
+  int rval = 0;
+  for (int mode = 0; mode < 4; ++mode)
+  {
+    bool sparse = (mode & 1) != 0, parallel = (mode & 2) != 0;
+    const char *names[4] = { "Streamed", "Streamed with sparse bins",
+                             "Streamed in parallel",
+                             "Streamed in parallel with sparse bins" };
+
+    vtkNew<TestTorusPieceSource> pieces;
+    vtkNew<vtkQuadricClustering> streamed;
+    streamed->SetInputConnection(pieces->GetOutputPort());
+    streamed->SetNumberOfDivisions(40, 40, 10);
+    streamed->AutoAdjustNumberOfDivisionsOff();
+    streamed->CopyCellDataOn();
+    streamed->SetNumberOfStreamDivisions(7);
+    streamed->SetUseSparseBins(sparse);
+    streamed->SetParallelClustering(parallel);
+    streamed->Update();
+
+    // Each piece is requested twice, for the bounds and for the bins.
+    if (pieces->GetExecutions() != 14)
+    {
+      cerr << names[mode] << ": " << pieces->GetExecutions()
+           << " executions of the source instead of 14" << endl;
+      rval = 1;
+    }
+    // The pieces follow the order of the cells of the whole surface, so
+    // the output is the same up to the rounding of the parallel sums.
+    rval |= CompareOutputs(names[mode], expected, streamed->GetOutput(),
+                           parallel ? 1e-6 : 0.0);
+
+    // Executing again streams the pieces again.
+    streamed->Modified();
+    streamed->Update();
+    rval |= CompareOutputs(names[mode], expected, streamed->GetOutput(),
+                           parallel ? 1e-6 : 0.0);
+  }
+
+  // Without streaming, sparse bins and parallel clustering give the same
+  // output as the dense bins.
+  vtkNew<vtkQuadricClustering> sparse;
+  sparse->SetInputConnection(source->GetOutputPort());
+  sparse->SetNumberOfDivisions(40, 40, 10);
+  sparse->AutoAdjustNumberOfDivisionsOff();
+  sparse->CopyCellDataOn();
+  sparse->UseSparseBinsOn();
+  sparse->ParallelClusteringOn();
+  sparse->Update();
+  rval |= CompareOutputs("Sparse bins", expected, sparse->GetOutput(), 1e-6);
+
+  // So many bins cannot be allocated densely. Every point is in its own bin
+  // and no triangle is lost.
+  sparse->SetNumberOfDivisions(4000, 4000, 1000);
+  sparse->Update();
+  if (sparse->GetOutput()->GetNumberOfPolys() !=
+      2 * TestTorusPieceSource::NU * TestTorusPieceSource::NV)
+  {
+    cerr << "Fine sparse bins: " << sparse->GetOutput()->GetNumberOfPolys()
+         << " triangles instead of "
+         << 2 * TestTorusPieceSource::NU * TestTorusPieceSource::NV << endl;
+    rval = 1;
+  }
+
+  return rval;
+}
@@ -0,0 +1,227 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationParallelDecimation.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Decimate a closed and an open surface with the parallel mode of
+// vtkQuadricDecimation, and compare the reduction and the distance to the
+// original surface with the serial decimation.
+
+#include "vtkCellArray.h"
+#include "vtkCellLocator.h"
+#include "vtkGenericCell.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricDecimation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace
+{
+
+// A torus with bumps, a closed surface.
+void MakeTorus(vtkPolyData *polyData)
+{
+  const int nu = 120, nv = 60;
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < nv; ++j)
+  {
+    for (int i = 0; i < nu; ++i)
+    {
+      double u = 2.0 * vtkMath::Pi() * i / nu;
+      double v = 2.0 * vtkMath::Pi() * j / nv;
+      double r = 0.3 + 0.02 * std::sin(5.0 * u) * std::cos(3.0 * v);
+      points->InsertNextPoint((1.0 + r * std::cos(v)) * std::cos(u),
+                              (1.0 + r * std::cos(v)) * std::sin(u),
+                              r * std::sin(v));
+    }
+  }
+  vtkNew<vtkCellArray> triangles;
+  for (int j = 0; j < nv; ++j)
+  {
+    for (int i = 0; i < nu; ++i)
+    {
+      vtkIdType p0 = i + nu * j, p1 = (i + 1) % nu + nu * j;
+      vtkIdType p2 = (i + 1) % nu + nu * ((j + 1) % nv);
+      vtkIdType p3 = i + nu * ((j + 1) % nv);
+      vtkIdType t0[3] = { p0, p1, p2 }, t1[3] = { p0, p2, p3 };
+      triangles->InsertNextCell(3, t0);
+      triangles->InsertNextCell(3, t1);
+    }
+  }
+  polyData->SetPoints(points);
+  polyData->SetPolys(triangles);
+}
+
+// A height field over a square, an open surface.
+void MakeHeightField(vtkPolyData *polyData)
+{
+  const int n = 100;
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      double x = static_cast<double>(i) / (n - 1);
+      double y = static_cast<double>(j) / (n - 1);
+      points->InsertNextPoint(x, y, 0.1 * std::sin(6.0 * x) * std::cos(4.0 * y));
+    }
+  }
+  vtkNew<vtkCellArray> triangles;
+  for (int j = 0; j < n - 1; ++j)
+  {
+    for (int i = 0; i < n - 1; ++i)
+    {
+      vtkIdType p0 = i + n * j, p1 = p0 + 1, p2 = p1 + n, p3 = p0 + n;
+      vtkIdType t0[3] = { p0, p1, p2 }, t1[3] = { p0, p2, p3 };
+      triangles->InsertNextCell(3, t0);
+      triangles->InsertNextCell(3, t1);
+    }
+  }
+  polyData->SetPoints(points);
+  polyData->SetPolys(triangles);
+}
+
+// The largest and mean distances from the points of the input to the
+// decimated surface.
+void ComputeDistances(vtkPolyData *input, vtkPolyData *output, double &max,
+                      double &mean)
+{
+  vtkNew<vtkCellLocator> locator;
+  locator->SetDataSet(output);
+  locator->BuildLocator();
+  vtkNew<vtkGenericCell> cell;
+  max = mean = 0.0;
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); ++i)
+  {
+    double x[3], closest[3], dist2;
+    vtkIdType cellId;
+    int subId;
+    input->GetPoint(i, x);
+    locator->FindClosestPoint(x, closest, cell, cellId, subId, dist2);
+    max = std::max(max, std::sqrt(dist2));
+    mean += std::sqrt(dist2);
+  }
+  mean /= input->GetNumberOfPoints();
+}
+
+// Check that the triangles of the output are neither degenerate nor
+// duplicated.
+int CheckTriangles(vtkPolyData *output)
+{
+  std::set<std::set<vtkIdType> > triangles;
+  vtkCellArray *polys = output->GetPolys();
+  vtkIdType npts, *pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts);)
+  {
+    std::set<vtkIdType> triangle(pts, pts + npts);
+    if (npts != 3 || triangle.size() != 3)
+    {
+      cerr << "Degenerate triangle in the output" << endl;
+      return 1;
+    }
+    if (!triangles.insert(triangle).second)
+    {
+      cerr << "Duplicated triangle in the output" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestDecimation(const char *name, vtkPolyData *input, double reduction)
+{
+  vtkNew<vtkQuadricDecimation> serial;
+  serial->SetInputData(input);
+  serial->SetTargetReduction(reduction);
+  serial->Update();
+
+  vtkNew<vtkQuadricDecimation> parallel;
+  parallel->SetInputData(input);
+  parallel->SetTargetReduction(reduction);
+  parallel->ParallelDecimationOn();
+  parallel->Update();
+
+  vtkPolyData *output = parallel->GetOutput();
+  vtkIdType numTris = input->GetNumberOfPolys();
+  double actual = parallel->GetActualReduction();
+  if (actual < reduction || actual > reduction + 0.01 ||
+      output->GetNumberOfPolys() !=
+        numTris - static_cast<vtkIdType>(std::floor(actual * numTris + 0.5)))
+  {
+    cerr << name << ": reduction " << actual << " with "
+         << output->GetNumberOfPolys() << " triangles instead of "
+         << reduction << endl;
+    return 1;
+  }
+  if (CheckTriangles(output))
+  {
+    return 1;
+  }
+
+  // The parallel decimation is about as accurate as the serial one.
+  double serialMax, serialMean, parallelMax, parallelMean;
+  ComputeDistances(input, serial->GetOutput(), serialMax, serialMean);
+  ComputeDistances(input, output, parallelMax, parallelMean);
+  cout << name << ": serial distances " << serialMax << " " << serialMean
+       << ", parallel distances " << parallelMax << " " << parallelMean
+       << endl;
+  if (parallelMax > 2.0 * serialMax || parallelMean > 1.5 * serialMean)
+  {
+    cerr << name << ": the parallel decimation is too far from the surface"
+         << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestQuadricDecimationParallelDecimation(int, char *[])
+{
+  vtkNew<vtkPolyData> torus;
+  MakeTorus(torus);
+  vtkNew<vtkPolyData> heightField;
+  MakeHeightField(heightField);
+
+  int rval = 0;
+  double reductions[3] = { 0.3, 0.8, 0.95 };
+  for (double reduction : reductions)
+  {
+    rval |= TestDecimation("Torus", torus, reduction);
+    rval |= TestDecimation("Height field", heightField, reduction);
+  }
+
+  // The attribute error metric is only supported by the serial decimation.
+  vtkNew<vtkQuadricDecimation> serial;
+  serial->SetInputData(torus);
+  serial->AttributeErrorMetricOn();
+  serial->Update();
+  vtkNew<vtkQuadricDecimation> parallel;
+  parallel->SetInputData(torus);
+  parallel->AttributeErrorMetricOn();
+  parallel->ParallelDecimationOn();
+  parallel->Update();
+  if (parallel->GetOutput()->GetNumberOfPolys() !=
+      serial->GetOutput()->GetNumberOfPolys())
+  {
+    cerr << "The attribute error metric does not use the serial decimation"
+         << endl;
+    rval = 1;
+  }
+
+  return rval;
+}
@@ -0,0 +1,295 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSmoothPolyDataFilterParallelSmoothing.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Smooth a noisy creased mesh with boundaries, triangle strips, non-manifold
+// edges, lines and vertices, serially and in parallel, with
+// vtkWindowedSincPolyDataFilter, whose output must be the same, and with
+// vtkSmoothPolyDataFilter, whose parallel Jacobi iterations must fix the same
+// points and move the others close to the serial ones.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmoothPolyDataFilter.h"
+#include "vtkWindowedSincPolyDataFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const int Dim = 40;
+
+vtkIdType PointId(int i, int j)
+{
+  return i + Dim * j;
+}
+
+void MakeMesh(vtkPolyData *mesh, int dataType)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  vtkNew<vtkPoints> points;
+  points->SetDataType(dataType);
+
+  // A height field creased along i = Dim / 2.
+  for (int j = 0; j < Dim; ++j)
+  {
+    for (int i = 0; i < Dim; ++i)
+    {
+      double z = random->GetRangeValue(-0.3, 0.3);
+      random->Next();
+      if (i > Dim / 2)
+      {
+        z += 1.5 * (i - Dim / 2);
+      }
+      points->InsertNextPoint(i, j, z);
+    }
+  }
+
+  // Quads and triangles, with a triangle strip every ten rows.
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int j = 0; j < Dim - 1; ++j)
+  {
+    if (j % 10 == 5)
+    {
+      strips->InsertNextCell(2 * Dim);
+      for (int i = 0; i < Dim; ++i)
+      {
+        strips->InsertCellPoint(PointId(i, j));
+        strips->InsertCellPoint(PointId(i, j + 1));
+      }
+      continue;
+    }
+    for (int i = 0; i < Dim - 1; ++i)
+    {
+      vtkIdType quad[4] = { PointId(i, j), PointId(i + 1, j),
+                            PointId(i + 1, j + 1), PointId(i, j + 1) };
+      if ((i + j) % 3 == 0)
+      {
+        polys->InsertNextCell(4, quad);
+      }
+      else
+      {
+        vtkIdType triangles[2][3] = { { quad[0], quad[1], quad[2] },
+                                      { quad[0], quad[2], quad[3] } };
+        polys->InsertNextCell(3, triangles[0]);
+        polys->InsertNextCell(3, triangles[1]);
+      }
+    }
+  }
+
+  // Fins on two interior edges, which become non-manifold.
+  for (int fin = 0; fin < 2; ++fin)
+  {
+    int i = 8 + 12 * fin;
+    int j = 12;
+    vtkIdType tip = points->InsertNextPoint(i + 0.5, j, 3.0);
+    vtkIdType triangle[3] = { PointId(i, j), PointId(i + 1, j), tip };
+    polys->InsertNextCell(3, triangle);
+  }
+
+  // An open line, a closed loop, and a line along the mesh.
+  vtkNew<vtkCellArray> lines;
+  lines->InsertNextCell(5);
+  for (int i = 0; i < 5; ++i)
+  {
+    lines->InsertCellPoint(
+      points->InsertNextPoint(i, -3.0 + 0.2 * (i % 2), 0.0));
+  }
+  vtkIdType loop[7];
+  for (int i = 0; i < 6; ++i)
+  {
+    double angle = vtkMath::Pi() * i / 3.0;
+    loop[i] = points->InsertNextPoint(5.0 * std::cos(angle) + 0.3 * (i % 2),
+                                      5.0 * std::sin(angle), -4.0);
+  }
+  loop[6] = loop[0];
+  lines->InsertNextCell(7, loop);
+  lines->InsertNextCell(11);
+  for (int i = 5; i <= 15; ++i)
+  {
+    lines->InsertCellPoint(PointId(i, 30));
+  }
+
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell(2);
+  verts->InsertCellPoint(PointId(20, 20));
+  verts->InsertCellPoint(PointId(21, 25));
+
+  mesh->SetPoints(points);
+  mesh->SetVerts(verts);
+  mesh->SetLines(lines);
+  mesh->SetPolys(polys);
+  mesh->SetStrips(strips);
+}
+
+int TestWindowedSinc(vtkPolyData *mesh)
+{
+  vtkNew<vtkWindowedSincPolyDataFilter> serial;
+  vtkNew<vtkWindowedSincPolyDataFilter> parallel;
+  parallel->ParallelSmoothingOn();
+  vtkWindowedSincPolyDataFilter *filters[2] = { serial, parallel };
+  for (int options = 0; options < 16; ++options)
+  {
+    for (vtkWindowedSincPolyDataFilter *filter : filters)
+    {
+      filter->SetInputData(mesh);
+      filter->SetFeatureEdgeSmoothing(options & 1);
+      filter->SetBoundarySmoothing((options >> 1) & 1);
+      filter->SetNonManifoldSmoothing((options >> 2) & 1);
+      filter->SetNormalizeCoordinates((options >> 3) & 1);
+      filter->GenerateErrorScalarsOn();
+      filter->Update();
+    }
+
+    vtkPolyData *a = serial->GetOutput();
+    vtkPolyData *b = parallel->GetOutput();
+    vtkDataArray *errors = b->GetPointData()->GetScalars();
+    if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+        a->GetNumberOfCells() != b->GetNumberOfCells() || !errors ||
+        errors->GetNumberOfTuples() != b->GetNumberOfPoints())
+    {
+      cerr << "Windowed sinc, options " << options << ": wrong output" << endl;
+      return 1;
+    }
+    double maxError = 0.0;
+    for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+      double x[3], y[3];
+      a->GetPoint(i, x);
+      b->GetPoint(i, y);
+      if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+      {
+        cerr << "Windowed sinc, options " << options << ": point " << i
+             << " is (" << y[0] << ", " << y[1] << ", " << y[2]
+             << ") instead of (" << x[0] << ", " << x[1] << ", " << x[2]
+             << ")" << endl;
+        return 1;
+      }
+      maxError = std::max(maxError, errors->GetTuple1(i));
+    }
+    if (maxError == 0.0)
+    {
+      cerr << "Windowed sinc, options " << options << ": nothing smoothed"
+           << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int TestLaplacian(vtkPolyData *mesh)
+{
+  vtkNew<vtkSmoothPolyDataFilter> serial;
+  vtkNew<vtkSmoothPolyDataFilter> parallel;
+  parallel->ParallelSmoothingOn();
+  vtkSmoothPolyDataFilter *filters[2] = { serial, parallel };
+  for (int options = 0; options < 4; ++options)
+  {
+    for (vtkSmoothPolyDataFilter *filter : filters)
+    {
+      filter->SetInputData(mesh);
+      filter->SetFeatureEdgeSmoothing(options & 1);
+      filter->SetBoundarySmoothing((options >> 1) & 1);
+      filter->Update();
+    }
+
+    // The serial Gauss-Seidel and the parallel Jacobi iterations differ by
+    // the order of the relaxation factor.
+    vtkPolyData *a = serial->GetOutput();
+    vtkPolyData *b = parallel->GetOutput();
+    if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+        a->GetPoints()->GetDataType() != b->GetPoints()->GetDataType() ||
+        a->GetNumberOfCells() != b->GetNumberOfCells())
+    {
+      cerr << "Laplacian, options " << options << ": wrong output" << endl;
+      return 1;
+    }
+    double maxMove = 0.0, maxDifference = 0.0;
+    vtkIdType numMoved = 0;
+    for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+    {
+      double x0[3], x[3], y[3];
+      mesh->GetPoint(i, x0);
+      a->GetPoint(i, x);
+      b->GetPoint(i, y);
+      bool moved = x[0] != x0[0] || x[1] != x0[1] || x[2] != x0[2];
+      if (moved != (y[0] != x0[0] || y[1] != x0[1] || y[2] != x0[2]))
+      {
+        cerr << "Laplacian, options " << options << ": point " << i
+             << (moved ? " did not move" : " moved") << endl;
+        return 1;
+      }
+      numMoved += moved ? 1 : 0;
+      maxMove = std::max(maxMove, vtkMath::Distance2BetweenPoints(x0, x));
+      maxDifference = std::max(maxDifference,
+                               vtkMath::Distance2BetweenPoints(x, y));
+    }
+    if (numMoved < mesh->GetNumberOfPoints() / 2 ||
+        std::sqrt(maxDifference) > 0.01 * std::sqrt(maxMove))
+    {
+      cerr << "Laplacian, options " << options << ": " << numMoved
+           << " points moved by up to " << std::sqrt(maxMove)
+           << ", and the parallel points differ by up to "
+           << std::sqrt(maxDifference) << endl;
+      return 1;
+    }
+  }
+
+  // Smoothing constrained by a source is serial.
+  vtkNew<vtkPolyData> source;
+  source->DeepCopy(mesh);
+  for (vtkSmoothPolyDataFilter *filter : filters)
+  {
+    filter->SetNumberOfIterations(5);
+    filter->SetSourceData(source);
+    filter->Update();
+  }
+  for (vtkIdType i = 0; i < mesh->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    serial->GetOutput()->GetPoint(i, x);
+    parallel->GetOutput()->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      cerr << "Laplacian with a source: point " << i << " differs" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}
+
+int TestSmoothPolyDataFilterParallelSmoothing(int, char *[])
+{
+  int rval = 0;
+  int dataTypes[2] = { VTK_FLOAT, VTK_DOUBLE };
+  for (int dataType : dataTypes)
+  {
+    vtkNew<vtkPolyData> mesh;
+    MakeMesh(mesh, dataType);
+    rval |= TestWindowedSinc(mesh);
+    rval |= TestLaplacian(mesh);
+  }
+  return rval;
+}
@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestThresholdOrdering.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the (threaded) threshold output matches the serial definition:
+// surviving cells in input order, and output points numbered in the order
+// they are first used by those cells.
+
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkRTAnalyticSource.h"
+#include "vtkThreshold.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <vector>
+
+namespace
+{
+
+int CompareWithReference(vtkDataSet *input, vtkUnstructuredGrid *output,
+                         double lower, double upper)
+{
+  vtkDataArray *scalars = input->GetPointData()->GetScalars();
+  vtkDataArray *outScalars = output->GetPointData()->GetScalars();
+  std::vector<vtkIdType> pointMap(input->GetNumberOfPoints(), -1);
+  vtkIdType numNewPts = 0, newCellId = 0;
+  vtkNew<vtkIdList> pts;
+  vtkNew<vtkIdList> newPts;
+
+  for (vtkIdType cellId = 0; cellId < input->GetNumberOfCells(); ++cellId)
+  {
+    input->GetCellPoints(cellId, pts);
+    bool keep = pts->GetNumberOfIds() > 0;
+    for (vtkIdType i = 0; keep && i < pts->GetNumberOfIds(); ++i)
+    {
+      double s = scalars->GetComponent(pts->GetId(i), 0);
+      keep = s >= lower && s <= upper;
+    }
+    if (!keep)
+    {
+      continue;
+    }
+
+    if (newCellId >= output->GetNumberOfCells() ||
+        output->GetCellType(newCellId) != input->GetCellType(cellId))
+    {
+      cerr << "Cell " << cellId << " missing or of wrong type" << endl;
+      return 1;
+    }
+    output->GetCellPoints(newCellId, newPts);
+    if (newPts->GetNumberOfIds() != pts->GetNumberOfIds())
+    {
+      cerr << "Wrong number of points for cell " << cellId << endl;
+      return 1;
+    }
+    for (vtkIdType i = 0; i < pts->GetNumberOfIds(); ++i)
+    {
+      vtkIdType ptId = pts->GetId(i);
+      if (pointMap[ptId] < 0)
+      {
+        pointMap[ptId] = numNewPts++;
+      }
+      if (newPts->GetId(i) != pointMap[ptId])
+      {
+        cerr << "Wrong point numbering in cell " << cellId << endl;
+        return 1;
+      }
+      double x[3], y[3];
+      input->GetPoint(ptId, x);
+      output->GetPoint(pointMap[ptId], y);
+      if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2] ||
+          scalars->GetComponent(ptId, 0) !=
+            outScalars->GetComponent(pointMap[ptId], 0))
+      {
+        cerr << "Wrong point coordinates or data for point " << ptId << endl;
+        return 1;
+      }
+    }
+    ++newCellId;
+  }
+
+  if (newCellId != output->GetNumberOfCells() ||
+      numNewPts != output->GetNumberOfPoints())
+  {
+    cerr << "Expected " << newCellId << " cells and " << numNewPts
+         << " points, got " << output->GetNumberOfCells() << " and "
+         << output->GetNumberOfPoints() << endl;
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+int TestThresholdOrdering(int, char *[])
+{
+  int rval = 0;
+
+  // Image data input; 8000 cells spread over several batches.
+  vtkNew<vtkRTAnalyticSource> source;
+  source->Update();
+  vtkNew<vtkThreshold> threshold;
+  threshold->SetInputConnection(source->GetOutputPort());
+  threshold->ThresholdBetween(100.0, 200.0);
+  threshold->Update();
+  rval |= CompareWithReference(source->GetOutput(), threshold->GetOutput(),
+                               100.0, 200.0);
+
+  // Unstructured grid input, with cell data.
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  ugrid->DeepCopy(threshold->GetOutput());
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfValues(ugrid->GetNumberOfCells());
+  for (vtkIdType cellId = 0; cellId < ugrid->GetNumberOfCells(); ++cellId)
+  {
+    cellIds->SetValue(cellId, cellId);
+  }
+  ugrid->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkThreshold> threshold2;
+  threshold2->SetInputData(ugrid);
+  threshold2->ThresholdBetween(120.0, 180.0);
+  threshold2->Update();
+  vtkUnstructuredGrid *output = threshold2->GetOutput();
+  rval |= CompareWithReference(ugrid, output, 120.0, 180.0);
+
+  // The cell data follows the cells.
+  vtkDataArray *outCellIds = output->GetCellData()->GetArray("CellIds");
+  vtkIdType previous = -1;
+  for (vtkIdType cellId = 0; outCellIds && cellId < output->GetNumberOfCells();
+       ++cellId)
+  {
+    vtkIdType inCellId = static_cast<vtkIdType>(outCellIds->GetComponent(cellId, 0));
+    if (inCellId <= previous ||
+        ugrid->GetCellType(inCellId) != output->GetCellType(cellId))
+    {
+      cerr << "Cell data not copied in order" << endl;
+      rval = 1;
+      break;
+    }
+    previous = inCellId;
+  }
+  if (!outCellIds)
+  {
+    cerr << "Cell data not passed" << endl;
+    rval = 1;
+  }
+
+  return rval;
+}
@@ -26,11 +26,145 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <atomic>
+
 vtkStandardNewMacro(vtkArrayCalculator);
 
+namespace
+{
+
+// Evaluates the function over ranges of tuples, a block of tuples at a time,
+// each variable being gathered from its array into a column of values.
+class vtkArrayCalculatorFunctor
+{
+public:
+  // Number of tuples evaluated at once.
+  static const vtkIdType BlockSize = 512;
+
+  struct Variable
+  {
+    vtkDataArray* Array;
+    // Components of the array, or of the points when Array is null.
+    int Components[3];
+  };
+
+  vtkFunctionParser* Parser;
+  vtkDataSet* DataSet;
+  vtkGraph* Graph;
+  vtkDataArray* Result;
+  int NumberOfResultComponents;
+  // Sources of the parser variables, indexed as in the parser. Variables
+  // without source keep the value they were set to.
+  std::vector<Variable*> ScalarVariables;
+  std::vector<Variable*> VectorVariables;
+  std::atomic<bool> Failed;
+
+  vtkArrayCalculatorFunctor()
+    : Parser(nullptr), DataSet(nullptr), Graph(nullptr), Result(nullptr),
+      NumberOfResultComponents(1), Failed(false)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    size_t numScalars = this->ScalarVariables.size();
+    size_t numVectors = this->VectorVariables.size();
+    bool usePoints = false;
+    for (size_t v = 0; v < numScalars; v++)
+    {
+      usePoints |= this->ScalarVariables[v] && !this->ScalarVariables[v]->Array;
+    }
+    for (size_t v = 0; v < numVectors; v++)
+    {
+      usePoints |= this->VectorVariables[v] && !this->VectorVariables[v]->Array;
+    }
+
+    std::vector<double> scalarValues(numScalars * BlockSize);
+    std::vector<double> vectorValues(numVectors * 3 * BlockSize);
+    std::vector<double> points(usePoints ? 3 * BlockSize : 0);
+    std::vector<const double*> scalarColumns(numScalars, nullptr);
+    std::vector<const double*> vectorColumns(numVectors, nullptr);
+    std::vector<double> results(this->NumberOfResultComponents * BlockSize);
+    for (size_t v = 0; v < numScalars; v++)
+    {
+      if (this->ScalarVariables[v])
+      {
+        scalarColumns[v] = scalarValues.data() + v * BlockSize;
+      }
+    }
+    for (size_t v = 0; v < numVectors; v++)
+    {
+      if (this->VectorVariables[v])
+      {
+        vectorColumns[v] = vectorValues.data() + v * 3 * BlockSize;
+      }
+    }
+
+    for (vtkIdType first = begin; first < end; first += BlockSize)
+    {
+      vtkIdType numTuples =
+        (end - first < BlockSize) ? end - first : BlockSize;
+      for (vtkIdType t = 0; t < numTuples && usePoints; t++)
+      {
+        if (this->DataSet)
+        {
+          this->DataSet->GetPoint(first + t, &points[3 * t]);
+        }
+        else
+        {
+          this->Graph->GetPoint(first + t, &points[3 * t]);
+        }
+      }
+      for (size_t v = 0; v < numScalars; v++)
+      {
+        if (Variable* var = this->ScalarVariables[v])
+        {
+          double* column = scalarValues.data() + v * BlockSize;
+          for (vtkIdType t = 0; t < numTuples; t++)
+          {
+            column[t] = var->Array ?
+              var->Array->GetComponent(first + t, var->Components[0]) :
+              points[3 * t + var->Components[0]];
+          }
+        }
+      }
+      for (size_t v = 0; v < numVectors; v++)
+      {
+        if (Variable* var = this->VectorVariables[v])
+        {
+          double* column = vectorValues.data() + v * 3 * BlockSize;
+          for (vtkIdType t = 0; t < numTuples; t++)
+          {
+            for (int c = 0; c < 3; c++)
+            {
+              column[3 * t + c] = var->Array ?
+                var->Array->GetComponent(first + t, var->Components[c]) :
+                points[3 * t + var->Components[c]];
+            }
+          }
+        }
+      }
+
+      if (!this->Parser->EvaluateBlock(numTuples, scalarColumns.data(),
+                                       vectorColumns.data(), results.data()))
+      {
+        this->Failed = true;
+      }
+      for (vtkIdType t = 0; t < numTuples; t++)
+      {
+        this->Result->SetTuple(first + t,
+          results.data() + t * this->NumberOfResultComponents);
+      }
+    }
+  }
+};
+
+}
+
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -424,22 +558,34 @@ int vtkArrayCalculator::RequestData(
     resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
   }
 
-  // Save array pointers to avoid looking them up for each tuple.
-  std::vector<vtkDataArray*> scalarArrays(this->NumberOfScalarArrays);
-  std::vector<vtkDataArray*> vectorArrays(this->NumberOfVectorArrays);
-  std::vector<int> scalarArrayIndicies(this->NumberOfScalarArrays);
-  std::vector<int> vectorArrayIndicies(this->NumberOfVectorArrays);
+  // Gather the sources of the variables needed by the function, then
+  // evaluate the remaining tuples in parallel.
+  vtkArrayCalculatorFunctor functor;
+  functor.Parser = this->FunctionParser;
+  functor.DataSet = dsInput;
+  functor.Graph = graphInput;
+  functor.Result = resultArray;
+  functor.NumberOfResultComponents = (resultType == SCALAR_RESULT) ? 1 : 3;
+  functor.ScalarVariables.resize(
+    this->FunctionParser->GetNumberOfScalarVariables(), nullptr);
+  functor.VectorVariables.resize(
+    this->FunctionParser->GetNumberOfVectorVariables(), nullptr);
+  std::vector<vtkArrayCalculatorFunctor::Variable> scalarVariables(
+    this->NumberOfScalarArrays + this->NumberOfCoordinateScalarArrays);
+  std::vector<vtkArrayCalculatorFunctor::Variable> vectorVariables(
+    this->NumberOfVectorArrays + this->NumberOfCoordinateVectorArrays);
 
   for (int cc=0; cc < this->NumberOfScalarArrays; cc++)
   {
     int idx = this->FunctionParser->GetScalarVariableIndex(
       this->ScalarVariableNames[cc]);
-    if (idx >= 0)
+    if (idx >= 0 && this->FunctionParser->GetScalarVariableNeeded(idx))
     {
-      if (this->FunctionParser->GetScalarVariableNeeded(idx))
+      scalarVariables[cc].Array = inFD->GetArray(this->ScalarArrayNames[cc]);
+      scalarVariables[cc].Components[0] = this->SelectedScalarComponents[cc];
+      if (scalarVariables[cc].Array)
       {
-        scalarArrays[cc] = inFD->GetArray(this->ScalarArrayNames[cc]);
-        scalarArrayIndicies[cc] = idx;
+        functor.ScalarVariables[idx] = &scalarVariables[cc];
       }
     }
   }
@@ -448,74 +594,55 @@ int vtkArrayCalculator::RequestData(
   {
     int idx = this->FunctionParser->GetVectorVariableIndex(
       this->VectorVariableNames[cc]);
-    if (idx >= 0)
+    if (idx >= 0 && this->FunctionParser->GetVectorVariableNeeded(idx))
     {
-      if (this->FunctionParser->GetVectorVariableNeeded(idx))
+      vectorVariables[cc].Array = inFD->GetArray(this->VectorArrayNames[cc]);
+      for (j = 0; j < 3; j++)
+      {
+        vectorVariables[cc].Components[j] =
+          this->SelectedVectorComponents[cc][j];
+      }
+      if (vectorVariables[cc].Array)
       {
-        vectorArrays[cc] = inFD->GetArray(this->VectorArrayNames[cc]);
-        vectorArrayIndicies[cc] = idx;
+        functor.VectorVariables[idx] = &vectorVariables[cc];
       }
     }
   }
 
-  for (i = 1; i < numTuples; i++)
+  if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
   {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
+    for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
     {
-      if ((currentArray = scalarArrays[j]))
+      int idx = j + this->NumberOfScalarArrays;
+      vtkArrayCalculatorFunctor::Variable& var = scalarVariables[idx];
+      var.Array = nullptr;
+      var.Components[0] = this->SelectedCoordinateScalarComponents[j];
+      if (idx < static_cast<int>(functor.ScalarVariables.size()))
       {
-        this->FunctionParser->
-          SetScalarVariableValue(scalarArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
+        functor.ScalarVariables[idx] = &var;
       }
     }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
+    for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
     {
-      if ((currentArray = vectorArrays[j]))
+      int idx = j + this->NumberOfVectorArrays;
+      vtkArrayCalculatorFunctor::Variable& var = vectorVariables[idx];
+      var.Array = nullptr;
+      for (int k = 0; k < 3; k++)
       {
-        this->FunctionParser->SetVectorVariableValue(vectorArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-            currentArray->GetComponent(
-              i, this->SelectedVectorComponents[j][1]),
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
+        var.Components[k] = this->SelectedCoordinateVectorComponents[j][k];
       }
-    }
-    if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
-    {
-      double* pt = nullptr;
-      if (dsInput)
-      {
-        pt = dsInput->GetPoint(i);
-      }
-      else
-      {
-        pt = graphInput->GetPoint(i);
-      }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
-      {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
-      }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
+      if (idx < static_cast<int>(functor.VectorVariables.size()))
       {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
+        functor.VectorVariables[idx] = &var;
       }
     }
-    if (resultType == SCALAR_RESULT)
-    {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
-    }
-    else
-    {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
-    }
+  }
+
+  vtkSMPTools::For(1, numTuples, functor);
+  if (functor.Failed)
+  {
+    vtkErrorMacro("The function could not be evaluated for some tuples, "
+                  "their result is " << VTK_PARSER_ERROR_RESULT << ".");
   }
 
   output->ShallowCopy(input);
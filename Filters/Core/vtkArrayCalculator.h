@@ -22,7 +22,7 @@
  * used in a given function must be all in point data or all in cell data.
  * The resulting array will be stored as a field data array.  The result
  * array can either be stored in a new array or it can overwrite an existing
- * array.
+ * array. The entries are evaluated by blocks, in parallel with vtkSMPTools.
  *
  * The functions that this array calculator understands is:
  * <pre>
@@ -14,22 +14,31 @@
   =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
-#include "vtkCell.h"
+#include "vtkCellTypes.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
+#include "vtkStructuredData.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUniformGrid.h"
-#include "vtkUnsignedIntArray.h"
 
 #include <algorithm>
-#include <functional>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
@@ -38,89 +47,259 @@ vtkStandardNewMacro(vtkCellDataToPointData);
 namespace
 {
 //----------------------------------------------------------------------------
-// Helper template function that implement the major part of the algorighm
-// which will be expanded by the vtkTemplateMacro. The template function is
-// provided so that coverage test can cover this function.
-  template <typename T>
-  void __spread (vtkDataSet* const src, vtkUnsignedIntArray* const num,
-                 vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-                 vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps,
-                 int highestCellDimension, int contributingCellOption)
+// The cells that contribute to the point data of unstructured grids and
+// polydata. The cells using each point are gathered from static links, in
+// which they are listed in increasing order, so that the points are processed
+// independently and the cell data is summed in the same order as when it was
+// scattered over the points of each cell in turn.
+struct CellDataGather
+{
+  vtkStaticCellLinks *Links;
+  const unsigned char *CellDimensions; // nullptr when all the cells contribute
+  int HighestCellDimension;
+  bool Patch;
+
+  // Return the cells using the point, and the lowest dimension of the cells
+  // that contribute to the point, with the Patch option the highest
+  // dimension of the cells using the point.
+  vtkIdType GetCells(vtkIdType ptId, const vtkIdType *&cells, int &minDim) const
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+    vtkIdType ncells = this->Links->GetNumberOfCells(ptId);
+    cells = this->Links->GetCells(ptId);
+    minDim = this->HighestCellDimension;
+    if (this->Patch)
+    {
+      for (vtkIdType i = 0; i < ncells; ++i)
+      {
+        minDim = std::max(minDim,
+                          static_cast<int>(this->CellDimensions[cells[i]]));
+      }
+    }
+    return ncells;
+  }
+};
 
-    // zero initialization
-    std::fill_n(dstptr, npoints*ncomps, T(0));
+// Average the data of the contributing cells of a range of points. As when
+// scattering, the arithmetic is done in the value type of the arrays.
+template <typename SrcArrayT, typename DstArrayT>
+struct AverageCellData
+{
+  SrcArrayT *Source;
+  DstArrayT *Dest;
+  const CellDataGather &Gather;
+
+  AverageCellData(SrcArrayT *src, DstArrayT *dst, const CellDataGather &gather)
+    : Source(src), Dest(dst), Gather(gather)
+  {
+  }
 
-    // accumulate
-    if (contributingCellOption != vtkCellDataToPointData::Patch)
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkDataArrayAccessor<SrcArrayT> s(this->Source);
+    vtkDataArrayAccessor<DstArrayT> d(this->Dest);
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType ValueType;
+
+    const int ncomps = this->Source->GetNumberOfComponents();
+    const unsigned char *dims = this->Gather.CellDimensions;
+    std::vector<ValueType> sum(ncomps);
+    for (; ptId < endPtId; ++ptId)
     {
-      T const* srcbeg = srcptr;
-      for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
+      const vtkIdType *cells;
+      int minDim;
+      vtkIdType ncells = this->Gather.GetCells(ptId, cells, minDim);
+      std::fill(sum.begin(), sum.end(), ValueType(0));
+      vtkIdType count = 0;
+      for (vtkIdType i = 0; i < ncells; ++i)
       {
-        vtkCell* cell = src->GetCell(cid);
-        if (cell->GetCellDimension() >= highestCellDimension)
+        if (!dims || dims[cells[i]] >= minDim)
         {
-          vtkIdList* pids = cell->GetPointIds();
-          for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+          ++count;
+          for (int c = 0; c < ncomps; ++c)
           {
-            T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
-            // accumulate cell data to point data <==> point_data += cell_data
-            std::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,std::plus<T>());
+            sum[c] += s.Get(cells[i], c);
           }
         }
       }
-      // average
-      T* dstbeg = dstptr;
-      for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
+      for (int c = 0; c < ncomps; ++c)
       {
         // guard against divide by zero
-        if (unsigned int const denom = num->GetValue(pid))
-        {
-          // divide point data by the number of cells using it <==>
-          // point_data /= denum
-          std::transform(dstbeg, dstbeg+ncomps, dstbeg,
-                         std::bind2nd(std::divides<T>(), denom));
-        }
+        d.Set(ptId, c, count ? sum[c] / static_cast<ValueType>(count) : sum[c]);
       }
     }
-    else
-    { // compute over cell patches
-      vtkNew<vtkIdList> cellsOnPoint;
-      std::vector<T> data(4*ncomps);
-      for (vtkIdType pid = 0; pid < npoints; ++pid)
+  }
+};
+
+struct AverageCellDataWorker
+{
+  const CellDataGather &Gather;
+  vtkIdType NumberOfPoints;
+
+  AverageCellDataWorker(const CellDataGather &gather, vtkIdType npoints)
+    : Gather(gather), NumberOfPoints(npoints)
+  {
+  }
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT *src, DstArrayT *dst)
+  {
+    AverageCellData<SrcArrayT, DstArrayT> average(src, dst, this->Gather);
+    vtkSMPTools::For(0, this->NumberOfPoints, average);
+  }
+};
+
+// The dimension of each cell, from the dimensions of its type.
+struct ComputeCellDimensions
+{
+  vtkDataSet *Input;
+  const int *TypeDimensions;
+  unsigned char *CellDimensions;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->CellDimensions[cellId] = static_cast<unsigned char>(
+        this->TypeDimensions[this->Input->GetCellType(cellId)]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Average the data of the cells using each point of image data, rectilinear
+// and structured grids, without blanking. The cells of a point follow from
+// its structured coordinates, they are the same, in the same order, as the
+// ones of vtkDataSet::GetPointCells(), and the interpolation is the one of
+// vtkDataSetAttributes::InterpolatePoint() with equal weights.
+template <typename SrcArrayT, typename DstArrayT>
+struct InterpolateStructuredCellData
+{
+  SrcArrayT *Source;
+  DstArrayT *Dest;
+  int *Dimensions;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  InterpolateStructuredCellData(SrcArrayT *src, DstArrayT *dst, int dims[3])
+    : Source(src), Dest(dst), Dimensions(dims)
+  {
+  }
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(8);
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    vtkDataArrayAccessor<SrcArrayT> s(this->Source);
+    vtkDataArrayAccessor<DstArrayT> d(this->Dest);
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType ValueType;
+
+    const int ncomps = this->Source->GetNumberOfComponents();
+    vtkIdList *cellIds = this->CellIds.Local();
+    for (; ptId < endPtId; ++ptId)
+    {
+      vtkStructuredData::GetPointCells(ptId, cellIds, this->Dimensions);
+      vtkIdType ncells = cellIds->GetNumberOfIds();
+      double weight = ncells ? 1.0 / ncells : 0.0;
+      for (int c = 0; c < ncomps; ++c)
       {
-        std::fill(data.begin(), data.end(), 0);
-        T numPointCells[4] = {0, 0, 0, 0};
-        // Get all cells touching this point.
-        src->GetPointCells(pid, cellsOnPoint);
-        vtkIdType numPatchCells = cellsOnPoint->GetNumberOfIds();
-        for (vtkIdType pc = 0; pc  < numPatchCells; pc++)
+        double val = 0.0;
+        for (vtkIdType i = 0; i < ncells; ++i)
         {
-          vtkIdType cellId = cellsOnPoint->GetId(pc);
-          int cellDimension = src->GetCell(cellId)->GetCellDimension();
-          numPointCells[cellDimension] += 1;
-          for (int comp=0;comp<ncomps;comp++)
-          {
-            data[comp+ncomps*cellDimension] += srcptr[comp+cellId*ncomps];
-          }
-        }
-        for (int dimension=3;dimension>=0;dimension--)
-        {
-          if (numPointCells[dimension])
-          {
-            for (int comp=0;comp<ncomps;comp++)
-            {
-              dstptr[comp+pid*ncomps] = data[comp+dimension*ncomps] / numPointCells[dimension];
-            }
-            break;
-          }
+          val += weight * static_cast<double>(s.Get(cellIds->GetId(i), c));
         }
+        ValueType valT;
+        vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+        d.Set(ptId, c, valT);
       }
     }
   }
 
+  void Reduce()
+  {
+  }
+};
+
+struct InterpolateStructuredCellDataWorker
+{
+  int *Dimensions;
+  vtkIdType NumberOfPoints;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT *src, DstArrayT *dst)
+  {
+    InterpolateStructuredCellData<SrcArrayT, DstArrayT> interpolate(
+      src, dst, this->Dimensions);
+    vtkSMPTools::For(0, this->NumberOfPoints, interpolate);
+  }
+};
+
+// Interpolate, in serial, the arrays of the structured datasets that are not
+// handled by the array dispatch, such as string or bit arrays.
+void InterpolateStructuredArray(vtkAbstractArray *srcarray,
+                                vtkAbstractArray *dstarray,
+                                int dims[3], vtkIdType npoints)
+{
+  vtkNew<vtkIdList> cellIds;
+  cellIds->Allocate(8);
+  double weights[8];
+  for (vtkIdType ptId = 0; ptId < npoints; ++ptId)
+  {
+    vtkStructuredData::GetPointCells(ptId, cellIds, dims);
+    vtkIdType ncells = cellIds->GetNumberOfIds();
+    if (ncells > 0)
+    {
+      std::fill_n(weights, ncells, 1.0 / ncells);
+      dstarray->InterpolateTuple(ptId, cellIds, srcarray, weights);
+    }
+  }
+}
+
+// Fast path for image data, rectilinear and structured grids, which are not
+// blanked: the arrays are interpolated in parallel.
+void InterpolateStructuredPointData(vtkCellDataToPointData* filter,
+                                    vtkDataSet *input, int dims[3],
+                                    vtkDataSet *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  vtkCellData *inCD = input->GetCellData();
+  vtkPointData *outPD = output->GetPointData();
+  vtkDataSetAttributes::FieldList cfl(1);
+  cfl.InitializeFieldList(inCD);
+  outPD->InterpolateAllocate(cfl, numPts, numPts);
+
+  for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
+  {
+    filter->UpdateProgress(static_cast<double>(fid) / nfields);
+    if (filter->GetAbortExecute())
+    {
+      break;
+    }
+
+    int const dstid = cfl.GetFieldIndex(fid);
+    int const srcid = cfl.GetDSAIndex(0, fid);
+    if (srcid < 0 || dstid < 0)
+    {
+      continue;
+    }
+
+    vtkAbstractArray* const srcarray = inCD->GetAbstractArray(srcid);
+    vtkAbstractArray* const dstarray = outPD->GetAbstractArray(dstid);
+    dstarray->SetNumberOfTuples(numPts);
+
+    vtkDataArray *srcDA = vtkDataArray::FastDownCast(srcarray);
+    vtkDataArray *dstDA = vtkDataArray::FastDownCast(dstarray);
+    InterpolateStructuredCellDataWorker worker = { dims, numPts };
+    if (!srcDA || !dstDA ||
+        !vtkArrayDispatch::Dispatch2SameValueType::Execute(srcDA, dstDA,
+                                                           worker))
+    {
+      InterpolateStructuredArray(srcarray, dstarray, dims, numPts);
+    }
+  }
+}
+
   // Special traversal algorithm for vtkUniformGrid and vtkRectilinearGrid to support blanking
   // points will not have more than 8 cells for either of these data sets
   template <typename T>
@@ -238,6 +417,24 @@ int vtkCellDataToPointData::RequestData(
   {
     InterpolatePointDataWithMask(this, uniformGrid, output);
   }
+  else if (input->IsA("vtkImageData") || input->IsA("vtkRectilinearGrid") ||
+           input->IsA("vtkStructuredGrid"))
+  {
+    int dims[3];
+    if (vtkImageData *image = vtkImageData::SafeDownCast(input))
+    {
+      image->GetDimensions(dims);
+    }
+    else if (vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input))
+    {
+      rGrid->GetDimensions(dims);
+    }
+    else
+    {
+      sGrid->GetDimensions(dims);
+    }
+    InterpolateStructuredPointData(this, input, dims, output);
+  }
   else
   {
     this->InterpolatePointData(input, output);
@@ -281,45 +478,44 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     return 1;
   }
 
-  // count the number of cells associated with each point. if we are doing patches
-  // though we will do that later on.
-  vtkSmartPointer<vtkUnsignedIntArray> num;
-  int highestCellDimension = 0;
-  if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
+  // The cells using each point, in increasing order.
+  vtkNew<vtkStaticCellLinks> links;
+  links->BuildLinks(src);
+
+  // Unless all the cells contribute, the dimension of each cell is needed.
+  // It follows from the cell types, which are cheaper to get than the cells.
+  CellDataGather gather;
+  gather.Links = links;
+  gather.CellDimensions = nullptr;
+  gather.HighestCellDimension = 0;
+  gather.Patch =
+    (this->ContributingCellOption == vtkCellDataToPointData::Patch);
+  std::vector<unsigned char> cellDimensions;
+  if (this->ContributingCellOption != vtkCellDataToPointData::All)
   {
-    num = vtkSmartPointer<vtkUnsignedIntArray>::New();
-    num->SetNumberOfComponents(1);
-    num->SetNumberOfTuples(npoints);
-    std::fill_n(num->GetPointer(0), npoints, 0u);
-    if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
+    int typeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    int highestCellDimension = 0;
+    vtkNew<vtkCellTypes> types;
+    src->GetCellTypes(types);
+    vtkNew<vtkGenericCell> cell;
+    for (vtkIdType i = 0; i < types->GetNumberOfTypes(); ++i)
     {
-      int maxDimension = src->IsA("vtkPolyData") == 1 ? 2 : 3;
-      for (vtkIdType i=0;i<src->GetNumberOfCells();i++)
-      {
-        int dim = src->GetCell(i)->GetCellDimension();
-        if (dim > highestCellDimension)
-        {
-          highestCellDimension = dim;
-          if (highestCellDimension == maxDimension)
-          {
-            break;
-          }
-        }
-      }
+      unsigned char type = types->GetCellType(i);
+      cell->SetCellType(type);
+      typeDimensions[type] = cell->GetCellDimension();
+      highestCellDimension =
+        std::max(highestCellDimension, typeDimensions[type]);
     }
-    vtkNew<vtkIdList> pids;
-    for (vtkIdType cid = 0; cid < ncells; ++cid)
+    if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
     {
-      if (src->GetCell(cid)->GetCellDimension() >= highestCellDimension)
-      {
-        src->GetCellPoints(cid, pids);
-        for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-        {
-          vtkIdType const pid = pids->GetId(i);
-          num->SetValue(pid, num->GetValue(pid)+1);
-        }
-      }
+      gather.HighestCellDimension = highestCellDimension;
     }
+
+    cellDimensions.resize(ncells);
+    ComputeCellDimensions computeDimensions = { src, typeDimensions,
+                                                cellDimensions.data() };
+    vtkSMPTools::For(0, ncells, computeDimensions);
+    gather.CellDimensions = cellDimensions.data();
   }
 
   // First, copy the input to the output as a starting point
@@ -381,11 +577,14 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     vtkDataArray* const dstarray = dstpointdata->GetArray(dstid);
     dstarray->SetNumberOfTuples(npoints);
 
-    vtkIdType const ncomps = srcarray->GetNumberOfComponents();
-    switch (srcarray->GetDataType())
+    AverageCellDataWorker worker(gather, npoints);
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(srcarray, dstarray,
+                                                           worker))
     {
-      vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps, highestCellDimension, this->ContributingCellOption));
+      // Use the vtkDataArray API, in serial, when fast-path dispatch fails.
+      AverageCellData<vtkDataArray, vtkDataArray> average(srcarray, dstarray,
+                                                          gather);
+      average(0, npoints);
     }
   }
 
@@ -28,6 +28,12 @@
  * cells attached to a point. DataSetMax uses the highest cell dimension in
  * the entire data set.
  *
+ * The point data is computed in parallel with vtkSMPTools. For unstructured
+ * grids and polydata, the data of the cells using each point is gathered
+ * through static cell links, which are built for the filter and not stored
+ * in the input. For image data, rectilinear and structured grids without
+ * blanking, the cells using each point follow from the dimensions.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -17,14 +17,25 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkMergePoints.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
 vtkStandardNewMacro(vtkCleanPolyData);
 
 //---------------------------------------------------------------------------
@@ -46,6 +57,7 @@ vtkCleanPolyData::vtkCleanPolyData()
   this->Locator = nullptr;
   this->PieceInvariant = 1;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelMerging = 0;
 }
 
 //--------------------------------------------------------------------------
@@ -113,6 +125,641 @@ int vtkCleanPolyData::RequestUpdateExtent(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Threaded cleaning. The cells of the four cell arrays are split into fixed
+// size batches so that the output is independent of the number of threads
+// and of the scheduling. The points used by the cells are ranked in order of
+// first use, which is the order the serial algorithm inserts them into the
+// locator; each point is then merged into the first point of lower rank
+// that is kept and lies within tolerance, and the cells are renumbered,
+// reduced and converted exactly as the serial algorithm does.
+struct vtkCleanPolyData::SMPCleaner
+{
+  // Number of cells processed as a unit.
+  static const vtkIdType BatchSize = 1000;
+
+  // A range of cells of one of the cell arrays (0: verts, 1: lines,
+  // 2: polys, 3: strips).
+  struct Batch
+  {
+    int Type;
+    vtkIdType Location;
+    vtkIdType FirstCellId;
+    vtkIdType NumberOfCells;
+  };
+
+  vtkCleanPolyData *Self;
+  vtkPolyData *Input;
+  vtkPolyData *Output;
+  vtkPoints *NewPoints;
+  double Tolerance;
+
+  vtkIdType NumPts;
+  vtkIdType MaxCellSize;
+  vtkIdType NumBatches;
+  vtkIdType NumInputCells[4];
+  const vtkIdType *InputCells[4];
+  std::vector<Batch> Batches;
+
+  // First batch using each point (NumBatches when unused), and the rank of
+  // each point in order of first use, which later becomes the output id.
+  std::unique_ptr<std::atomic<vtkIdType>[]> PointBatch;
+  std::vector<vtkIdType> PointMap;
+  std::vector<vtkIdType> BatchPoints;
+
+  // Per rank: input point id, (operated on) coordinates, rank of the point
+  // it is merged into, and output id of the kept points.
+  std::vector<vtkIdType> RankPoints;
+  vtkNew<vtkPoints> UsedPoints;
+  std::vector<vtkIdType> MergedRanks;
+  std::vector<vtkIdType> NewIds;
+
+  // With a non-zero tolerance, the lower ranks within tolerance of each rank.
+  vtkStaticPointLocator *Locator;
+  std::vector<vtkIdType> NeighborOffsets;
+  std::vector<vtkIdType> NeighborRanks;
+  vtkSMPThreadLocalObject<vtkIdList> Neighbors;
+
+  // Per output cell array and per batch counts, turned into offsets by
+  // prefix sums.
+  std::vector<vtkIdType> BatchCells[4];
+  std::vector<vtkIdType> BatchConnectivity[4];
+  vtkIdType CellIdOffsets[4];
+  vtkIdType *Connectivity[4];
+
+  vtkSMPThreadLocal<std::vector<vtkIdType> > CellPts;
+
+  SMPCleaner(vtkCleanPolyData *self, vtkPolyData *input, vtkPolyData *output,
+             vtkPoints *newPoints, double tolerance) :
+    Self(self), Input(input), Output(output), NewPoints(newPoints),
+    Tolerance(tolerance), NumBatches(0), Locator(nullptr)
+  {
+    this->NumPts = input->GetNumberOfPoints();
+    this->MaxCellSize = input->GetMaxCellSize();
+  }
+
+  // Exclusive prefix sum, returns the total.
+  static vtkIdType PrefixSum(std::vector<vtkIdType> &counts)
+  {
+    vtkIdType total = 0;
+    for (std::vector<vtkIdType>::iterator it = counts.begin();
+         it != counts.end(); ++it)
+    {
+      vtkIdType count = *it;
+      *it = total;
+      total += count;
+    }
+    return total;
+  }
+
+  // Renumber the points of a cell of the given type with the point map,
+  // dropping repeated consecutive points, and return the cell array the
+  // reduced cell goes to (-1 when it is eliminated).
+  int ReduceCell(int type, vtkIdType npts, const vtkIdType *pts,
+                 vtkIdType *newPts, vtkIdType &numNewPts) const
+  {
+    numNewPts = 0;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      const vtkIdType ptId = this->PointMap[pts[i]];
+      if ( type == 0 || i == 0 || ptId != newPts[numNewPts-1] )
+      {
+        newPts[numNewPts++] = ptId;
+      }
+    }
+    if ( type == 2 && numNewPts > 2 && newPts[0] == newPts[numNewPts-1] )
+    {
+      numNewPts--;
+    }
+
+    // Degenerate cells cascade to the cell arrays of lower dimension.
+    if ( type == 3 )
+    {
+      if ( numNewPts > 3 || !this->Self->ConvertStripsToPolys )
+      {
+        return 3;
+      }
+      type = 2;
+    }
+    if ( type == 2 )
+    {
+      if ( numNewPts > 2 || !this->Self->ConvertPolysToLines )
+      {
+        return 2;
+      }
+      type = 1;
+    }
+    if ( type == 1 )
+    {
+      if ( numNewPts > 1 || !this->Self->ConvertLinesToPoints )
+      {
+        return 1;
+      }
+    }
+    return numNewPts > 0 ? 0 : -1;
+  }
+
+  vtkIdType *GetCellBuffer()
+  {
+    std::vector<vtkIdType> &buffer = this->CellPts.Local();
+    buffer.resize(this->MaxCellSize);
+    return buffer.data();
+  }
+
+  // Reset the per point information.
+  struct InitializePoints
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      const vtkIdType numBatches = this->Cleaner->NumBatches;
+      for (; ptId < endPtId; ++ptId)
+      {
+        this->Cleaner->PointBatch[ptId].store(numBatches,
+                                              std::memory_order_relaxed);
+        this->Cleaner->PointMap[ptId] = -1;
+      }
+    }
+  };
+
+  // Pass 1: record the first batch using each point.
+  struct FindFirstUse
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      for (; batch < endBatch; ++batch)
+      {
+        const Batch &b = cl->Batches[batch];
+        const vtkIdType *cells = cl->InputCells[b.Type] + b.Location;
+        for (vtkIdType c = 0; c < b.NumberOfCells; ++c)
+        {
+          const vtkIdType npts = *cells++;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            std::atomic<vtkIdType> &owner = cl->PointBatch[*cells++];
+            vtkIdType current = owner.load(std::memory_order_relaxed);
+            while ( batch < current &&
+                    !owner.compare_exchange_weak(current, batch,
+                                                 std::memory_order_relaxed) )
+            {
+            }
+          }
+        }
+      }
+    }
+  };
+
+  // Pass 2: rank the points owned by each batch in order of first use.
+  struct RankPointsInBatches
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      for (; batch < endBatch; ++batch)
+      {
+        vtkIdType numPts = 0;
+        const Batch &b = cl->Batches[batch];
+        const vtkIdType *cells = cl->InputCells[b.Type] + b.Location;
+        for (vtkIdType c = 0; c < b.NumberOfCells; ++c)
+        {
+          const vtkIdType npts = *cells++;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            const vtkIdType ptId = *cells++;
+            if ( cl->PointBatch[ptId].load(std::memory_order_relaxed) == batch &&
+                 cl->PointMap[ptId] < 0 )
+            {
+              cl->PointMap[ptId] = numPts++;
+            }
+          }
+        }
+        cl->BatchPoints[batch] = numPts;
+      }
+    }
+  };
+
+  // Pass 3: finalize the ranks and operate on the used points.
+  struct OperateOnPoints
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      vtkPoints *inPts = cl->Input->GetPoints();
+      double x[3], newx[3];
+      for (; ptId < endPtId; ++ptId)
+      {
+        const vtkIdType batch = cl->PointBatch[ptId].load(std::memory_order_relaxed);
+        if ( batch >= cl->NumBatches )
+        {
+          continue;
+        }
+        const vtkIdType rank = cl->PointMap[ptId] + cl->BatchPoints[batch];
+        cl->PointMap[ptId] = rank;
+        cl->RankPoints[rank] = ptId;
+        inPts->GetPoint(ptId, x);
+        cl->Self->OperateOnPoint(x, newx);
+        cl->UsedPoints->SetPoint(rank, newx);
+      }
+    }
+  };
+
+  // Pass 4, zero tolerance: coincident points fall into the same bucket of
+  // the locator. The points of each bucket are sorted by coordinates, then
+  // by rank, and merged into the lowest rank with the same coordinates,
+  // which is always kept.
+  struct MergeCoincidentPoints
+  {
+    struct RankedPoint
+    {
+      double X[3];
+      vtkIdType Rank;
+      bool operator<(const RankedPoint &other) const
+      {
+        return std::lexicographical_compare(this->X, this->X + 3,
+          other.X, other.X + 3) ||
+          (std::equal(this->X, this->X + 3, other.X) &&
+           this->Rank < other.Rank);
+      }
+    };
+
+    SMPCleaner *Cleaner;
+    vtkSMPThreadLocal<std::vector<RankedPoint> > Points;
+
+    void operator()(vtkIdType bucket, vtkIdType endBucket)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      vtkIdList *ids = cl->Neighbors.Local();
+      std::vector<RankedPoint> &points = this->Points.Local();
+      for (; bucket < endBucket; ++bucket)
+      {
+        cl->Locator->GetBucketIds(bucket, ids);
+        const vtkIdType numIds = ids->GetNumberOfIds();
+        points.resize(numIds);
+        for (vtkIdType i = 0; i < numIds; ++i)
+        {
+          points[i].Rank = ids->GetId(i);
+          cl->UsedPoints->GetPoint(points[i].Rank, points[i].X);
+        }
+        std::sort(points.begin(), points.end());
+        vtkIdType merged = -1;
+        for (vtkIdType i = 0; i < numIds; ++i)
+        {
+          if ( i == 0 ||
+               !std::equal(points[i].X, points[i].X + 3, points[i-1].X) )
+          {
+            merged = points[i].Rank;
+          }
+          cl->MergedRanks[points[i].Rank] = merged;
+        }
+      }
+    }
+  };
+
+  // Pass 4, non-zero tolerance: count, then gather in increasing order, the
+  // lower ranks within tolerance of each rank. Which ones are kept is then
+  // decided serially, in rank order.
+  struct FindCloseRanks
+  {
+    SMPCleaner *Cleaner;
+    bool Gather;
+    void operator()(vtkIdType rank, vtkIdType endRank)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      vtkIdList *neighbors = cl->Neighbors.Local();
+      double x[3];
+      for (; rank < endRank; ++rank)
+      {
+        cl->UsedPoints->GetPoint(rank, x);
+        cl->Locator->FindPointsWithinRadius(cl->Tolerance, x, neighbors);
+        vtkIdType numCloseRanks = 0;
+        vtkIdType *closeRanks = this->Gather ?
+          cl->NeighborRanks.data() + cl->NeighborOffsets[rank] : nullptr;
+        for (vtkIdType i = 0; i < neighbors->GetNumberOfIds(); ++i)
+        {
+          const vtkIdType neighbor = neighbors->GetId(i);
+          if ( neighbor < rank )
+          {
+            if ( this->Gather )
+            {
+              closeRanks[numCloseRanks] = neighbor;
+            }
+            numCloseRanks++;
+          }
+        }
+        if ( this->Gather )
+        {
+          std::sort(closeRanks, closeRanks + numCloseRanks);
+        }
+        else
+        {
+          cl->NeighborOffsets[rank] = numCloseRanks;
+        }
+      }
+    }
+  };
+
+  // Pass 5: number the output points, copy the kept points and their point
+  // data, and finalize the point map.
+  struct CopyPoints
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      vtkPointData *inPD = cl->Input->GetPointData();
+      vtkPointData *outPD = cl->Output->GetPointData();
+      double x[3];
+      for (; ptId < endPtId; ++ptId)
+      {
+        const vtkIdType rank = cl->PointMap[ptId];
+        if ( rank < 0 )
+        {
+          continue;
+        }
+        const vtkIdType merged = cl->MergedRanks[rank];
+        const vtkIdType newId = cl->NewIds[merged];
+        if ( merged == rank )
+        {
+          cl->UsedPoints->GetPoint(rank, x);
+          cl->NewPoints->SetPoint(newId, x);
+          outPD->CopyData(inPD, ptId, newId);
+        }
+        cl->PointMap[ptId] = newId;
+      }
+    }
+  };
+
+  // Pass 6: count the cells and connectivity each batch adds to each output
+  // cell array.
+  struct CountCells
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      vtkIdType *newPts = cl->GetCellBuffer();
+      for (; batch < endBatch; ++batch)
+      {
+        vtkIdType numCells[4] = { 0, 0, 0, 0 };
+        vtkIdType connSize[4] = { 0, 0, 0, 0 };
+        const Batch &b = cl->Batches[batch];
+        const vtkIdType *cells = cl->InputCells[b.Type] + b.Location;
+        for (vtkIdType c = 0; c < b.NumberOfCells; ++c)
+        {
+          const vtkIdType npts = *cells;
+          vtkIdType numNewPts;
+          const int type = cl->ReduceCell(b.Type, npts, cells + 1, newPts,
+                                          numNewPts);
+          cells += npts + 1;
+          if ( type >= 0 )
+          {
+            numCells[type]++;
+            connSize[type] += numNewPts + 1;
+          }
+        }
+        for (int type = 0; type < 4; ++type)
+        {
+          cl->BatchCells[type][batch] = numCells[type];
+          cl->BatchConnectivity[type][batch] = connSize[type];
+        }
+      }
+    }
+  };
+
+  // Pass 7: generate the output cells and copy the cell data.
+  struct CopyCells
+  {
+    SMPCleaner *Cleaner;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCleaner *cl = this->Cleaner;
+      vtkIdType *newPts = cl->GetCellBuffer();
+      vtkCellData *inCD = cl->Input->GetCellData();
+      vtkCellData *outCD = cl->Output->GetCellData();
+      for (; batch < endBatch; ++batch)
+      {
+        vtkIdType newCellIds[4], locs[4];
+        for (int type = 0; type < 4; ++type)
+        {
+          newCellIds[type] =
+            cl->CellIdOffsets[type] + cl->BatchCells[type][batch];
+          locs[type] = cl->BatchConnectivity[type][batch];
+        }
+        const Batch &b = cl->Batches[batch];
+        const vtkIdType *cells = cl->InputCells[b.Type] + b.Location;
+        for (vtkIdType c = 0; c < b.NumberOfCells; ++c)
+        {
+          const vtkIdType npts = *cells;
+          vtkIdType numNewPts;
+          const int type = cl->ReduceCell(b.Type, npts, cells + 1, newPts,
+                                          numNewPts);
+          cells += npts + 1;
+          if ( type < 0 )
+          {
+            continue;
+          }
+          vtkIdType *conn = cl->Connectivity[type] + locs[type];
+          *conn++ = numNewPts;
+          std::copy(newPts, newPts + numNewPts, conn);
+          locs[type] += numNewPts + 1;
+          outCD->CopyData(inCD, b.FirstCellId + c, newCellIds[type]++);
+        }
+      }
+    }
+  };
+
+  void Execute()
+  {
+    // Cell arrays are traversed through their legacy layout, which is built
+    // for offsets storage before the threads access it.
+    vtkCellArray *inCells[4] = { this->Input->GetVerts(),
+      this->Input->GetLines(), this->Input->GetPolys(),
+      this->Input->GetStrips() };
+    vtkIdType firstCellId = 0;
+    for (int type = 0; type < 4; ++type)
+    {
+      this->InputCells[type] = inCells[type]->GetPointer();
+      this->NumInputCells[type] = inCells[type]->GetNumberOfCells();
+      vtkIdType loc = 0;
+      for (vtkIdType cellId = 0; cellId < this->NumInputCells[type]; ++cellId)
+      {
+        if ( cellId % BatchSize == 0 )
+        {
+          const vtkIdType numCells = this->NumInputCells[type] - cellId;
+          Batch b = { type, loc, firstCellId + cellId,
+                      numCells < BatchSize ? numCells : BatchSize };
+          this->Batches.push_back(b);
+        }
+        loc += this->InputCells[type][loc] + 1;
+      }
+      firstCellId += this->NumInputCells[type];
+    }
+    this->NumBatches = static_cast<vtkIdType>(this->Batches.size());
+
+    // Rank the used points in order of first use.
+    this->PointBatch.reset(new std::atomic<vtkIdType>[this->NumPts]);
+    this->PointMap.resize(this->NumPts);
+    this->BatchPoints.resize(this->NumBatches);
+    InitializePoints initializePoints = { this };
+    vtkSMPTools::For(0, this->NumPts, initializePoints);
+    FindFirstUse findFirstUse = { this };
+    vtkSMPTools::For(0, this->NumBatches, findFirstUse);
+    RankPointsInBatches rankPoints = { this };
+    vtkSMPTools::For(0, this->NumBatches, rankPoints);
+    const vtkIdType numUsedPts = PrefixSum(this->BatchPoints);
+
+    // The points are compared in the precision of the output, as the
+    // serial algorithm does.
+    this->RankPoints.resize(numUsedPts);
+    this->UsedPoints->SetDataType(this->NewPoints->GetDataType());
+    this->UsedPoints->SetNumberOfPoints(numUsedPts);
+    OperateOnPoints operateOnPoints = { this };
+    vtkSMPTools::For(0, this->NumPts, operateOnPoints);
+    this->Self->UpdateProgress(0.25);
+
+    // Merge the points.
+    this->MergedRanks.resize(numUsedPts);
+    if ( numUsedPts > 0 )
+    {
+      vtkNew<vtkPolyData> usedData;
+      usedData->SetPoints(this->UsedPoints);
+      vtkNew<vtkStaticPointLocator> locator;
+      locator->SetDataSet(usedData);
+      locator->BuildLocator();
+      this->Locator = locator.GetPointer();
+      if ( this->Tolerance == 0.0 )
+      {
+        const int *divs = locator->GetDivisions();
+        MergeCoincidentPoints mergeCoincidentPoints;
+        mergeCoincidentPoints.Cleaner = this;
+        vtkSMPTools::For(0, static_cast<vtkIdType>(divs[0]) * divs[1] * divs[2],
+                         mergeCoincidentPoints);
+      }
+      else
+      {
+        this->NeighborOffsets.resize(numUsedPts + 1);
+        FindCloseRanks countCloseRanks = { this, false };
+        vtkSMPTools::For(0, numUsedPts, countCloseRanks);
+        this->NeighborOffsets[numUsedPts] = vtkSMPTools::ExclusiveScan(
+          this->NeighborOffsets.begin(), this->NeighborOffsets.end() - 1,
+          this->NeighborOffsets.begin(), static_cast<vtkIdType>(0));
+        this->NeighborRanks.resize(this->NeighborOffsets[numUsedPts]);
+        FindCloseRanks gatherCloseRanks = { this, true };
+        vtkSMPTools::For(0, numUsedPts, gatherCloseRanks);
+
+        for (vtkIdType rank = 0; rank < numUsedPts; ++rank)
+        {
+          vtkIdType merged = rank;
+          for (vtkIdType i = this->NeighborOffsets[rank];
+               i < this->NeighborOffsets[rank+1]; ++i)
+          {
+            const vtkIdType neighbor = this->NeighborRanks[i];
+            if ( this->MergedRanks[neighbor] == neighbor )
+            {
+              merged = neighbor;
+              break;
+            }
+          }
+          this->MergedRanks[rank] = merged;
+        }
+      }
+      this->Locator = nullptr;
+    }
+    this->Self->UpdateProgress(0.5);
+
+    // Number the kept points in rank order.
+    this->NewIds.resize(numUsedPts);
+    for (vtkIdType rank = 0; rank < numUsedPts; ++rank)
+    {
+      this->NewIds[rank] = (this->MergedRanks[rank] == rank) ? 1 : 0;
+    }
+    const vtkIdType numNewPts = vtkSMPTools::ExclusiveScan(
+      this->NewIds.begin(), this->NewIds.end(), this->NewIds.begin(),
+      static_cast<vtkIdType>(0));
+    this->NewPoints->SetNumberOfPoints(numNewPts);
+    this->Output->GetPointData()->SetNumberOfTuples(numNewPts);
+    CopyPoints copyPoints = { this };
+    vtkSMPTools::For(0, this->NumPts, copyPoints);
+    this->Self->UpdateProgress(0.75);
+
+    // Renumber the cells.
+    for (int type = 0; type < 4; ++type)
+    {
+      this->BatchCells[type].resize(this->NumBatches);
+      this->BatchConnectivity[type].resize(this->NumBatches);
+    }
+    CountCells countCells = { this };
+    vtkSMPTools::For(0, this->NumBatches, countCells);
+
+    vtkIdType numNewCells = 0;
+    vtkCellArray *newCells[4] = { nullptr, nullptr, nullptr, nullptr };
+    for (int type = 0; type < 4; ++type)
+    {
+      const vtkIdType numCells = PrefixSum(this->BatchCells[type]);
+      const vtkIdType connSize = PrefixSum(this->BatchConnectivity[type]);
+      this->CellIdOffsets[type] = numNewCells;
+      numNewCells += numCells;
+      this->Connectivity[type] = nullptr;
+      if ( numCells > 0 || this->NumInputCells[type] > 0 )
+      {
+        newCells[type] = vtkCellArray::New();
+        this->Connectivity[type] =
+          newCells[type]->WritePointer(numCells, connSize);
+      }
+    }
+    this->Output->GetCellData()->SetNumberOfTuples(numNewCells);
+    CopyCells copyCells = { this };
+    vtkSMPTools::For(0, this->NumBatches, copyCells);
+
+    if ( newCells[0] )
+    {
+      this->Output->SetVerts(newCells[0]);
+      newCells[0]->Delete();
+    }
+    if ( newCells[1] )
+    {
+      this->Output->SetLines(newCells[1]);
+      newCells[1]->Delete();
+    }
+    if ( newCells[2] )
+    {
+      this->Output->SetPolys(newCells[2]);
+      newCells[2]->Delete();
+    }
+    if ( newCells[3] )
+    {
+      this->Output->SetStrips(newCells[3]);
+      newCells[3]->Delete();
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// The threaded cleaning needs attribute arrays that may be filled
+// concurrently once sized, which excludes string and bit arrays.
+bool vtkCleanPolyData::CanCleanInParallel(vtkPolyData *input)
+{
+  vtkDataSetAttributes *attributes[2] =
+    { input->GetPointData(), input->GetCellData() };
+  for (int a = 0; a < 2; ++a)
+  {
+    for (int i = 0; i < attributes[a]->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray *array =
+        vtkArrayDownCast<vtkDataArray>(attributes[a]->GetAbstractArray(i));
+      if ( !array || array->GetDataType() == VTK_BIT )
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 //--------------------------------------------------------------------------
 int vtkCleanPolyData::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -138,8 +785,6 @@ int vtkCleanPolyData::RequestData(
     vtkDebugMacro(<<"No data to Operate On!");
     return 1;
   }
-  vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
-
   vtkIdType numNewPts;
   vtkIdType numUsedPts=0;
   vtkPoints *newPts = inPts->NewInstance();
@@ -158,7 +803,22 @@ int vtkCleanPolyData::RequestData(
     newPts->SetDataType(VTK_DOUBLE);
   }
 
+  if ( this->PointMerging && this->ParallelMerging &&
+       this->CanCleanInParallel(input) )
+  {
+    output->GetPointData()->CopyAllocate(input->GetPointData());
+    output->GetCellData()->CopyAllocate(input->GetCellData());
+    double tol = this->ToleranceIsAbsolute ? this->AbsoluteTolerance :
+      this->Tolerance*input->GetLength();
+    SMPCleaner cleaner(this, input, output, newPts, tol);
+    cleaner.Execute();
+    output->SetPoints(newPts);
+    newPts->Delete();
+    return 1;
+  }
+
   newPts->Allocate(numPts);
+  vtkIdType *updatedPts = new vtkIdType[input->GetMaxCellSize()];
 
   // we'll be needing these
   vtkIdType inCellID, newId;
@@ -675,6 +1335,8 @@ void vtkCleanPolyData::PrintSelf(ostream& os, vtkIndent indent)
      << (this->PieceInvariant ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "ParallelMerging: "
+     << (this->ParallelMerging ? "On\n" : "Off\n");
 }
 
 //--------------------------------------------------------------------------
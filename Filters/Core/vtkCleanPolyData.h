@@ -144,6 +144,25 @@ public:
   vtkBooleanMacro(PointMerging,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether points are merged in
+   * parallel. If on (and PointMerging is on), the points used by the cells
+   * are binned with a vtkStaticPointLocator, the merges are resolved for all
+   * the points concurrently and the cells are renumbered in parallel with
+   * vtkSMPTools; the Locator is not used. OperateOnPoint() is then called
+   * from several threads. With a zero tolerance the output is identical to
+   * the one of the incremental merging. Otherwise each point is merged into
+   * the first kept point (in order of use by the cells) within tolerance,
+   * which may differ from the incremental locator when several kept points
+   * lie within tolerance. Inputs with bit or string attribute arrays are
+   * always cleaned serially. By default, parallel merging is off.
+   */
+  vtkSetMacro(ParallelMerging,vtkTypeBool);
+  vtkGetMacro(ParallelMerging,vtkTypeBool);
+  vtkBooleanMacro(ParallelMerging,vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set/Get a spatial locator for speeding the search process. By
@@ -216,6 +235,11 @@ protected:
 
   vtkTypeBool PieceInvariant;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelMerging;
+
+  // Threaded cleaning, see vtkCleanPolyData.cxx.
+  struct SMPCleaner;
+  bool CanCleanInParallel(vtkPolyData *input);
 private:
   vtkCleanPolyData(const vtkCleanPolyData&) = delete;
   void operator=(const vtkCleanPolyData&) = delete;
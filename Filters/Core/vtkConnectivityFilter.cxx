@@ -16,6 +16,7 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityRegionLabeling.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
 #include "vtkFloatArray.h"
@@ -28,11 +29,33 @@
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkIdTypeArray.h"
 
 vtkStandardNewMacro(vtkConnectivityFilter);
 
+namespace
+{
+
+// The cell points of any dataset, through a list per thread.
+struct DataSetCells
+{
+  vtkDataSet *Input;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+  DataSetCells(vtkDataSet *input) : Input(input) {}
+
+  void GetCellPoints(vtkIdType cellId, vtkIdType &npts, const vtkIdType *&pts)
+  {
+    vtkIdList *&ptIds = this->CellPts.Local();
+    this->Input->GetCellPoints(cellId, ptIds);
+    npts = ptIds->GetNumberOfIds();
+    pts = ptIds->GetPointer(0);
+  }
+};
+
+}
+
 // Construct with default extraction mode to extract largest regions.
 vtkConnectivityFilter::vtkConnectivityFilter()
 {
@@ -41,6 +64,7 @@ vtkConnectivityFilter::vtkConnectivityFilter()
   this->ColorRegions = 0;
 
   this->ScalarConnectivity = 0;
+  this->ParallelLabeling = 0;
   this->ScalarRange[0] = 0.0;
   this->ScalarRange[1] = 1.0;
 
@@ -239,7 +263,23 @@ int vtkConnectivityFilter::RequestData(
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if ( this->ParallelLabeling && !this->InScalars &&
+       this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+       this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
+  { //label all cells with their region number in parallel
+    this->LabelAllRegions(input);
+    for (i=0; i < this->RegionNumber; i++)
+    {
+      if ( this->RegionSizes->GetValue(i) > maxCellsInRegion )
+      {
+        maxCellsInRegion = this->RegionSizes->GetValue(i);
+        largestRegionId = i;
+      }
+    }
+    this->UpdateProgress (0.9);
+  }
+  else if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
@@ -613,6 +653,27 @@ void vtkConnectivityFilter::TraverseAndMark (vtkDataSet *input)
   } //while wave is not empty
 }
 
+// Label all the regions in parallel, setting the same visited cells, region
+// sizes and region scalars as the traversal of all the cells. The output
+// points keep their input order.
+void vtkConnectivityFilter::LabelAllRegions(vtkDataSet *input)
+{
+  DataSetCells cells(input);
+  vtkConnectivityRegionLabeling<DataSetCells> labeling(
+    cells, input->GetNumberOfPoints(), input->GetNumberOfCells());
+  labeling.CellRegions = this->Visited;
+  labeling.CellScalars = this->NewCellScalars->GetPointer(0);
+  labeling.PointMap = this->PointMap;
+  labeling.PointRegions = this->NewScalars->GetPointer(0);
+
+  // Build the cells of the input, if needed, before the threads query them.
+  input->GetCellPoints(0, this->PointIds);
+
+  labeling.Execute(this, this->RegionSizes);
+  this->RegionNumber = labeling.NumberOfRegions;
+  this->PointNumber = labeling.NumberOfPoints;
+}
+
 // Obtain the number of connected regions.
 int vtkConnectivityFilter::GetNumberOfExtractedRegions()
 {
@@ -702,6 +763,8 @@ void vtkConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   double *range = this->GetScalarRange();
   os << indent << "Scalar Range: (" << range[0] << ", " << range[1] << ")\n";
+  os << indent << "Parallel Labeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
 }
@@ -175,6 +175,22 @@ public:
   vtkBooleanMacro(ColorRegions,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the labeling of the regions in parallel. If on, and all the
+   * cells are visited (all regions, largest region or specified regions
+   * extraction) without ScalarConnectivity, the regions are found with a
+   * lock-free union-find of the points of each cell and numbered with
+   * vtkSMPTools, rather than grown from cell to cell. The region ids and
+   * sizes are the same, but the output points keep their input order
+   * instead of the order in which the regions visit them. By default,
+   * parallel labeling is off.
+   */
+  vtkSetMacro(ParallelLabeling,vtkTypeBool);
+  vtkGetMacro(ParallelLabeling,vtkTypeBool);
+  vtkBooleanMacro(ParallelLabeling,vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set/get the desired precision for the output types. See the documentation
@@ -209,8 +225,10 @@ protected:
 
   vtkTypeBool ScalarConnectivity;
   double ScalarRange[2];
+  vtkTypeBool ParallelLabeling;
 
   void TraverseAndMark(vtkDataSet *input);
+  void LabelAllRegions(vtkDataSet *input);
 
 private:
   // used to support algorithm execution
@@ -0,0 +1,429 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityRegionLabeling.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Parallel labeling of all the connected regions, shared by
+// vtkConnectivityFilter and vtkPolyDataConnectivityFilter. This header is
+// private to the module.
+//
+// The regions are found with a lock-free union-find of the points: each cell
+// joins the sets of its points, and each set is rooted at its smallest point
+// id. The regions are then numbered in the order of their first cell, as the
+// serial traversal does, so that the region ids are the same.
+//
+// The template parameter gives the points of the cells, from any thread:
+//
+//   void GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+//                      const vtkIdType* &pts);
+
+#ifndef vtkConnectivityRegionLabeling_h
+#define vtkConnectivityRegionLabeling_h
+
+#include "vtkAlgorithm.h"
+#include "vtkIdTypeArray.h"
+#include "vtkSMPTools.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+template <typename TCells>
+class vtkConnectivityRegionLabeling
+{
+public:
+  vtkConnectivityRegionLabeling(TCells &cells, vtkIdType numPts,
+                                vtkIdType numCells) :
+    CellRegions(nullptr), CellScalars(nullptr), PointMap(nullptr),
+    PointRegions(nullptr), NumberOfRegions(0), NumberOfPoints(0),
+    Cells(cells), NumPts(numPts), NumCells(numCells),
+    Parents(new std::atomic<vtkIdType>[numPts]), CellPoints(numCells),
+    Roots(numPts), FirstCells(new std::atomic<vtkIdType>[numPts]),
+    RootRegions(numPts)
+  {
+  }
+
+  // Outputs, allocated by the caller: the region of each cell, optionally
+  // copied to CellScalars, the output id of each point (-1 for the unused
+  // points) and the region of each output point.
+  vtkIdType *CellRegions;
+  vtkIdType *CellScalars;
+  vtkIdType *PointMap;
+  vtkIdType *PointRegions;
+
+  // The number of regions and of output points.
+  vtkIdType NumberOfRegions;
+  vtkIdType NumberOfPoints;
+
+  // Label all the regions, updating the progress of the filter, and set the
+  // number of cells of each region.
+  void Execute(vtkAlgorithm *filter, vtkIdTypeArray *regionSizes)
+  {
+    InitializeSets initializeSets(*this);
+    vtkSMPTools::For(0, this->NumPts, initializeSets);
+    JoinCellPoints joinCellPoints(*this);
+    vtkSMPTools::For(0, this->NumCells, joinCellPoints);
+    filter->UpdateProgress(0.4);
+    FindRoots findRoots(*this);
+    vtkSMPTools::For(0, this->NumPts, findRoots);
+    FindFirstCells findFirstCells(*this);
+    vtkSMPTools::For(0, this->NumCells, findFirstCells);
+    filter->UpdateProgress(0.6);
+
+    // Number the regions in the order of their first cell.
+    this->NumberOfRegions = NumberSatisfying(IsFirstCell(*this),
+                                             this->NumCells,
+                                             this->CellRegions);
+    SetRootRegions setRootRegions(*this);
+    vtkSMPTools::For(0, this->NumCells, setRootRegions);
+    this->RegionSizes.reset(
+      new std::atomic<vtkIdType>[this->NumberOfRegions]);
+    vtkSMPTools::Fill(this->RegionSizes.get(),
+                      this->RegionSizes.get() + this->NumberOfRegions, 0);
+    SetCellRegions setCellRegions(*this);
+    vtkSMPTools::For(0, this->NumCells, setCellRegions);
+    filter->UpdateProgress(0.8);
+
+    this->NumberOfPoints = NumberSatisfying(IsUsedPoint(*this),
+                                            this->NumPts, this->PointMap);
+    SetPointRegions setPointRegions(*this);
+    vtkSMPTools::For(0, this->NumPts, setPointRegions);
+
+    regionSizes->SetNumberOfTuples(this->NumberOfRegions);
+    for (vtkIdType region = 0; region < this->NumberOfRegions; ++region)
+    {
+      regionSizes->SetValue(region, this->RegionSizes[region]);
+    }
+  }
+
+private:
+  TCells &Cells;
+  vtkIdType NumPts;
+  vtkIdType NumCells;
+
+  std::unique_ptr<std::atomic<vtkIdType>[]> Parents;
+  // First point of each cell, -1 for the cells without points.
+  std::vector<vtkIdType> CellPoints;
+  // Root of each point, and first cell (NumCells if none) and region of each
+  // root.
+  std::vector<vtkIdType> Roots;
+  std::unique_ptr<std::atomic<vtkIdType>[]> FirstCells;
+  std::vector<vtkIdType> RootRegions;
+  std::unique_ptr<std::atomic<vtkIdType>[]> RegionSizes;
+
+  vtkIdType Find(vtkIdType x)
+  {
+    vtkIdType parent = this->Parents[x].load();
+    while (parent != x)
+    {
+      // Path halving, the parents only ever decrease.
+      vtkIdType grandParent = this->Parents[parent].load();
+      if (grandParent != parent)
+      {
+        this->Parents[x].compare_exchange_weak(parent, grandParent);
+      }
+      x = grandParent;
+      parent = this->Parents[x].load();
+    }
+    return x;
+  }
+
+  void Union(vtkIdType a, vtkIdType b)
+  {
+    for (;;)
+    {
+      a = this->Find(a);
+      b = this->Find(b);
+      if (a == b)
+      {
+        return;
+      }
+      if (a < b)
+      {
+        std::swap(a, b);
+      }
+      // Link the larger root under the smaller one, unless another thread
+      // linked it meanwhile.
+      vtkIdType expected = a;
+      if (this->Parents[a].compare_exchange_strong(expected, b))
+      {
+        return;
+      }
+    }
+  }
+
+  struct JoinCellPoints
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    JoinCellPoints(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkIdType npts;
+      const vtkIdType *pts;
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->Labeling.Cells.GetCellPoints(cellId, npts, pts);
+        this->Labeling.CellPoints[cellId] = npts > 0 ? pts[0] : -1;
+        for (vtkIdType i = 1; i < npts; ++i)
+        {
+          this->Labeling.Union(pts[0], pts[i]);
+        }
+      }
+    }
+  };
+
+  struct InitializeSets
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    InitializeSets(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Labeling.Parents[ptId] = ptId;
+      }
+    }
+  };
+
+  struct FindRoots
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    FindRoots(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Labeling.Roots[ptId] = this->Labeling.Find(ptId);
+        this->Labeling.FirstCells[ptId] = this->Labeling.NumCells;
+      }
+    }
+  };
+
+  struct FindFirstCells
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    FindFirstCells(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType ptId = this->Labeling.CellPoints[cellId];
+        if (ptId < 0)
+        {
+          continue;
+        }
+        std::atomic<vtkIdType> &first =
+          this->Labeling.FirstCells[this->Labeling.Roots[ptId]];
+        vtkIdType current = first.load();
+        while (cellId < current &&
+               !first.compare_exchange_weak(current, cellId))
+        {
+        }
+      }
+    }
+  };
+
+  // A cell starts a region when it is the first cell of its root, or when it
+  // has no points.
+  struct IsFirstCell
+  {
+    const vtkConnectivityRegionLabeling &Labeling;
+    IsFirstCell(const vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    bool operator()(vtkIdType cellId) const
+    {
+      vtkIdType ptId = this->Labeling.CellPoints[cellId];
+      return ptId < 0 ||
+        this->Labeling.FirstCells[this->Labeling.Roots[ptId]] == cellId;
+    }
+  };
+
+  struct IsUsedPoint
+  {
+    const vtkConnectivityRegionLabeling &Labeling;
+    IsUsedPoint(const vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    bool operator()(vtkIdType ptId) const
+    {
+      return this->Labeling.FirstCells[this->Labeling.Roots[ptId]] <
+        this->Labeling.NumCells;
+    }
+  };
+
+  // Number the items satisfying a predicate in increasing order, and set the
+  // others to -1. The items are counted by batches in parallel, then numbered
+  // from the prefix sum of the counts.
+  template <typename TPredicate>
+  struct NumberItems
+  {
+    const TPredicate &Predicate;
+    vtkIdType NumItems;
+    vtkIdType *Ids;
+    std::vector<vtkIdType> Offsets;
+
+    static const vtkIdType BatchSize = 1000;
+
+    NumberItems(const TPredicate &predicate, vtkIdType numItems,
+                vtkIdType *ids) :
+      Predicate(predicate), NumItems(numItems), Ids(ids),
+      Offsets((numItems + BatchSize - 1) / BatchSize + 1, 0)
+    {
+    }
+
+    struct Count
+    {
+      NumberItems &Numbering;
+      Count(NumberItems &numbering) : Numbering(numbering) {}
+
+      void operator()(vtkIdType begin, vtkIdType end)
+      {
+        for (vtkIdType batch = begin; batch < end; ++batch)
+        {
+          vtkIdType last = (batch + 1) * BatchSize;
+          last = last < this->Numbering.NumItems ? last :
+            this->Numbering.NumItems;
+          vtkIdType count = 0;
+          for (vtkIdType i = batch * BatchSize; i < last; ++i)
+          {
+            count += this->Numbering.Predicate(i);
+          }
+          this->Numbering.Offsets[batch + 1] = count;
+        }
+      }
+    };
+
+    struct Assign
+    {
+      NumberItems &Numbering;
+      Assign(NumberItems &numbering) : Numbering(numbering) {}
+
+      void operator()(vtkIdType begin, vtkIdType end)
+      {
+        for (vtkIdType batch = begin; batch < end; ++batch)
+        {
+          vtkIdType last = (batch + 1) * BatchSize;
+          last = last < this->Numbering.NumItems ? last :
+            this->Numbering.NumItems;
+          vtkIdType id = this->Numbering.Offsets[batch];
+          for (vtkIdType i = batch * BatchSize; i < last; ++i)
+          {
+            this->Numbering.Ids[i] = this->Numbering.Predicate(i) ? id++ : -1;
+          }
+        }
+      }
+    };
+
+    vtkIdType Execute()
+    {
+      vtkIdType numBatches = static_cast<vtkIdType>(this->Offsets.size()) - 1;
+      Count count(*this);
+      vtkSMPTools::For(0, numBatches, count);
+      for (vtkIdType batch = 0; batch < numBatches; ++batch)
+      {
+        this->Offsets[batch + 1] += this->Offsets[batch];
+      }
+      Assign assign(*this);
+      vtkSMPTools::For(0, numBatches, assign);
+      return this->Offsets[numBatches];
+    }
+  };
+
+  template <typename TPredicate>
+  static vtkIdType NumberSatisfying(const TPredicate &predicate,
+                                    vtkIdType numItems, vtkIdType *ids)
+  {
+    NumberItems<TPredicate> numbering(predicate, numItems, ids);
+    return numbering.Execute();
+  }
+
+  struct SetRootRegions
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    SetRootRegions(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType region = this->Labeling.CellRegions[cellId];
+        vtkIdType ptId = this->Labeling.CellPoints[cellId];
+        if (region >= 0 && ptId >= 0)
+        {
+          this->Labeling.RootRegions[this->Labeling.Roots[ptId]] = region;
+        }
+      }
+    }
+  };
+
+  struct SetCellRegions
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    SetCellRegions(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        vtkIdType &region = this->Labeling.CellRegions[cellId];
+        if (region < 0)
+        {
+          region = this->Labeling.RootRegions[
+            this->Labeling.Roots[this->Labeling.CellPoints[cellId]]];
+        }
+        if (this->Labeling.CellScalars)
+        {
+          this->Labeling.CellScalars[cellId] = region;
+        }
+        ++this->Labeling.RegionSizes[region];
+      }
+    }
+  };
+
+  struct SetPointRegions
+  {
+    vtkConnectivityRegionLabeling &Labeling;
+    SetPointRegions(vtkConnectivityRegionLabeling &labeling) :
+      Labeling(labeling) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        vtkIdType newId = this->Labeling.PointMap[ptId];
+        if (newId >= 0)
+        {
+          this->Labeling.PointRegions[newId] =
+            this->Labeling.RootRegions[this->Labeling.Roots[ptId]];
+        }
+      }
+    }
+  };
+
+  vtkConnectivityRegionLabeling(const vtkConnectivityRegionLabeling&) = delete;
+  void operator=(const vtkConnectivityRegionLabeling&) = delete;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectivityRegionLabeling.h
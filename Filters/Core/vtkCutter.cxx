@@ -19,6 +19,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkCellTypes.h"
 #include "vtkContourValues.h"
 #include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
@@ -26,6 +27,8 @@
 #include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
 #include "vtkGridSynchronizedTemplates3D.h"
+#include "vtkHexahedron.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkInformation.h"
@@ -36,14 +39,19 @@
 #include "vtkPlane.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkTetra.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
+#include "vtkWedge.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkTimerLog.h"
@@ -52,6 +60,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
@@ -69,6 +78,7 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->Locator = nullptr;
   this->GenerateTriangles = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->ParallelCutting = 0;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
@@ -342,6 +352,513 @@ vtkIdType GetFirstVisibleCell(vtkDataSet *DataSetInput)
 }
 }
 
+//----------------------------------------------------------------------------
+// Threaded cutting of unstructured grids of linear 3D cells. The cut
+// function is evaluated at the points in parallel. The cells, processed in
+// fixed-size batches, are then contoured for all the contour values with the
+// case tables of the cells: each output triangle vertex is recorded with the
+// input edge (and contour value) it lies on. Sorting these edges numbers the
+// output points, which are interpolated in parallel, and degenerate
+// triangles are finally discarded while the output cells are written.
+struct vtkCutter::SMPCutter
+{
+  // Number of cells, or of triangles, processed as a unit.
+  static const vtkIdType BatchSize = 1000;
+
+  // The edge (V0, V1), with V0 < V1, of a triangle vertex and the contour
+  // value it lies on. A vertex whose cut scalar is the contour value is
+  // recorded as the edge (V0, V0), so that it is shared by all its edges.
+  struct EdgeTuple
+  {
+    vtkIdType V0;
+    vtkIdType V1;
+    vtkIdType Contour;
+    vtkIdType TriangleVertex;
+
+    bool operator<(const EdgeTuple& other) const
+    {
+      return this->V0 < other.V0 ||
+        (this->V0 == other.V0 && (this->V1 < other.V1 ||
+        (this->V1 == other.V1 && this->Contour < other.Contour)));
+    }
+    bool SameEdge(const EdgeTuple& other) const
+    {
+      return this->V0 == other.V0 && this->V1 == other.V1 &&
+        this->Contour == other.Contour;
+    }
+  };
+
+  vtkCutter *Self;
+  vtkUnstructuredGrid *Input;
+  vtkPolyData *Output;
+
+  vtkIdType NumPts;
+  vtkIdType NumCells;
+  vtkIdType NumBatches;
+  int NumContours;
+  const double *ContourValues;
+  bool SortByCell;
+
+  vtkNew<vtkDoubleArray> CutScalars;
+  const double *Scalars;
+  vtkPointData *InPD;
+
+  // Number of triangles of each batch and contour value, then the first
+  // triangle of each.
+  std::vector<vtkIdType> TriangleOffsets;
+  std::vector<EdgeTuple> Edges;
+  std::vector<vtkIdType> TriangleCells;
+
+  // Per sorted edge, whether it starts a new output point, then the output
+  // point ids. The connectivity of the triangles in output point ids.
+  std::vector<vtkIdType> NewPointIds;
+  std::vector<vtkIdType> PointEdges;
+  std::vector<vtkIdType> Connectivity;
+
+  SMPCutter(vtkCutter *self, vtkUnstructuredGrid *input, vtkPolyData *output)
+    : Self(self), Input(input), Output(output), Scalars(nullptr),
+      InPD(nullptr)
+  {
+    this->NumPts = input->GetNumberOfPoints();
+    this->NumCells = input->GetNumberOfCells();
+    this->NumBatches = (this->NumCells + BatchSize - 1) / BatchSize;
+    this->NumContours = self->ContourValues->GetNumberOfContours();
+    this->ContourValues = self->ContourValues->GetValues();
+    this->SortByCell = (self->SortBy == VTK_SORT_BY_CELL);
+  }
+
+  // The ids of the points of a cell, voxels being reordered as hexahedra,
+  // and the case table of its type.
+  static int GetCellCases(vtkUnstructuredGrid *input, vtkIdType cellId,
+                          vtkIdType cellPts[8], int* &edges,
+                          int* (*&getCases)(int))
+  {
+    static const int voxelToHexahedron[8] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+    vtkIdType npts, *pts;
+    input->GetCellPoints(cellId, npts, pts);
+    int cellType = input->GetCellType(cellId);
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      cellPts[i] = (cellType == VTK_VOXEL ? pts[voxelToHexahedron[i]] : pts[i]);
+    }
+    switch (cellType)
+    {
+      case VTK_TETRA:
+        edges = vtkTetra::GetEdgeArray(0);
+        getCases = &vtkTetra::GetTriangleCases;
+        break;
+      case VTK_WEDGE:
+        edges = vtkWedge::GetEdgeArray(0);
+        getCases = &vtkWedge::GetTriangleCases;
+        break;
+      case VTK_PYRAMID:
+        edges = vtkPyramid::GetEdgeArray(0);
+        getCases = &vtkPyramid::GetTriangleCases;
+        break;
+      default: // VTK_HEXAHEDRON, VTK_VOXEL
+        edges = vtkHexahedron::GetEdgeArray(0);
+        getCases = &vtkHexahedron::GetTriangleCases;
+        break;
+    }
+    return static_cast<int>(npts);
+  }
+
+  // The case table entry of a cell for a contour value.
+  const int *GetCase(const vtkIdType *cellPts, int npts,
+                     int* (*getCases)(int), double value) const
+  {
+    int index = 0;
+    for (int i = 0; i < npts; ++i)
+    {
+      if (this->Scalars[cellPts[i]] >= value)
+      {
+        index |= (1 << i);
+      }
+    }
+    return getCases(index);
+  }
+
+  // Index of the triangle count of a batch and contour value, in the order
+  // of the output triangles.
+  vtkIdType GetCountIndex(vtkIdType batch, int contour) const
+  {
+    return this->SortByCell ? contour * this->NumBatches + batch :
+      batch * this->NumContours + contour;
+  }
+
+  struct CountTriangles
+  {
+    SMPCutter *Cutter;
+
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCutter *cutter = this->Cutter;
+      vtkIdType cellPts[8];
+      int *edges;
+      int* (*getCases)(int);
+      for ( ; batch < endBatch; ++batch)
+      {
+        vtkIdType cellId = batch * BatchSize;
+        vtkIdType endCellId = std::min(cellId + BatchSize, cutter->NumCells);
+        for ( ; cellId < endCellId; ++cellId)
+        {
+          int npts = GetCellCases(cutter->Input, cellId, cellPts, edges,
+                                  getCases);
+          for (int c = 0; c < cutter->NumContours; ++c)
+          {
+            const int *edge = cutter->GetCase(cellPts, npts, getCases,
+                                              cutter->ContourValues[c]);
+            vtkIdType &count =
+              cutter->TriangleOffsets[cutter->GetCountIndex(batch, c)];
+            for ( ; edge[0] > -1; edge += 3)
+            {
+              ++count;
+            }
+          }
+        }
+      }
+    }
+  };
+
+  struct EmitTriangles
+  {
+    SMPCutter *Cutter;
+
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCutter *cutter = this->Cutter;
+      const double *scalars = cutter->Scalars;
+      vtkIdType cellPts[8];
+      int *edges;
+      int* (*getCases)(int);
+      std::vector<vtkIdType> triIds(cutter->NumContours);
+      for ( ; batch < endBatch; ++batch)
+      {
+        for (int c = 0; c < cutter->NumContours; ++c)
+        {
+          triIds[c] = cutter->TriangleOffsets[cutter->GetCountIndex(batch, c)];
+        }
+        vtkIdType cellId = batch * BatchSize;
+        vtkIdType endCellId = std::min(cellId + BatchSize, cutter->NumCells);
+        for ( ; cellId < endCellId; ++cellId)
+        {
+          int npts = GetCellCases(cutter->Input, cellId, cellPts, edges,
+                                  getCases);
+          for (int c = 0; c < cutter->NumContours; ++c)
+          {
+            double value = cutter->ContourValues[c];
+            const int *edge = cutter->GetCase(cellPts, npts, getCases, value);
+            for ( ; edge[0] > -1; edge += 3)
+            {
+              vtkIdType triId = triIds[c]++;
+              cutter->TriangleCells[triId] = cellId;
+              for (int i = 0; i < 3; ++i)
+              {
+                const int *vert = edges + 2 * edge[i];
+                vtkIdType v0 = cellPts[vert[0]], v1 = cellPts[vert[1]];
+                EdgeTuple &tuple = cutter->Edges[3 * triId + i];
+                if (scalars[v0] == value)
+                {
+                  tuple.V0 = tuple.V1 = v0;
+                }
+                else if (scalars[v1] == value)
+                {
+                  tuple.V0 = tuple.V1 = v1;
+                }
+                else
+                {
+                  tuple.V0 = std::min(v0, v1);
+                  tuple.V1 = std::max(v0, v1);
+                }
+                tuple.Contour = c;
+                tuple.TriangleVertex = 3 * triId + i;
+              }
+            }
+          }
+        }
+      }
+    }
+  };
+
+  struct MarkNewPoints
+  {
+    SMPCutter *Cutter;
+
+    void operator()(vtkIdType i, vtkIdType end)
+    {
+      const EdgeTuple *edges = this->Cutter->Edges.data();
+      for ( ; i < end; ++i)
+      {
+        this->Cutter->NewPointIds[i] =
+          (i == 0 || !edges[i].SameEdge(edges[i - 1])) ? 1 : 0;
+      }
+    }
+  };
+
+  // The inclusive scan of the marks gives one plus the output point id.
+  struct AssignPoints
+  {
+    SMPCutter *Cutter;
+
+    void operator()(vtkIdType i, vtkIdType end)
+    {
+      SMPCutter *cutter = this->Cutter;
+      for ( ; i < end; ++i)
+      {
+        vtkIdType ptId = cutter->NewPointIds[i] - 1;
+        const EdgeTuple &tuple = cutter->Edges[i];
+        cutter->Connectivity[tuple.TriangleVertex] = ptId;
+        if (i == 0 || !tuple.SameEdge(cutter->Edges[i - 1]))
+        {
+          cutter->PointEdges[ptId] = i;
+        }
+      }
+    }
+  };
+
+  struct InterpolatePoints
+  {
+    SMPCutter *Cutter;
+    vtkDataArray *NewPoints;
+
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      SMPCutter *cutter = this->Cutter;
+      vtkPoints *inPts = cutter->Input->GetPoints();
+      vtkPointData *outPD = cutter->Output->GetPointData();
+      double x0[3], x1[3], x[3];
+      for ( ; ptId < endPtId; ++ptId)
+      {
+        const EdgeTuple &tuple = cutter->Edges[cutter->PointEdges[ptId]];
+        inPts->GetPoint(tuple.V0, x0);
+        double t = 0.0;
+        if (tuple.V0 != tuple.V1)
+        {
+          inPts->GetPoint(tuple.V1, x1);
+          double s0 = cutter->Scalars[tuple.V0];
+          double s1 = cutter->Scalars[tuple.V1];
+          t = (cutter->ContourValues[tuple.Contour] - s0) / (s1 - s0);
+        }
+        else
+        {
+          std::copy(x0, x0 + 3, x1);
+        }
+        for (int j = 0; j < 3; ++j)
+        {
+          x[j] = x0[j] + t * (x1[j] - x0[j]);
+        }
+        this->NewPoints->SetTuple(ptId, x);
+        outPD->InterpolateEdge(cutter->InPD, ptId, tuple.V0, tuple.V1, t);
+      }
+    }
+  };
+
+  // A triangle is kept unless two of its points were merged.
+  bool IsKept(vtkIdType triId) const
+  {
+    const vtkIdType *pts = this->Connectivity.data() + 3 * triId;
+    return pts[0] != pts[1] && pts[0] != pts[2] && pts[1] != pts[2];
+  }
+
+  struct CountKeptTriangles
+  {
+    SMPCutter *Cutter;
+    vtkIdType NumTriangles;
+    vtkIdType *Counts;
+
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      for ( ; batch < endBatch; ++batch)
+      {
+        vtkIdType triId = batch * BatchSize;
+        vtkIdType endTriId = std::min(triId + BatchSize, this->NumTriangles);
+        vtkIdType count = 0;
+        for ( ; triId < endTriId; ++triId)
+        {
+          count += this->Cutter->IsKept(triId) ? 1 : 0;
+        }
+        this->Counts[batch] = count;
+      }
+    }
+  };
+
+  struct WriteTriangles
+  {
+    SMPCutter *Cutter;
+    vtkIdType NumTriangles;
+    const vtkIdType *Offsets;
+    vtkIdType *Polys;
+
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPCutter *cutter = this->Cutter;
+      vtkCellData *inCD = cutter->Input->GetCellData();
+      vtkCellData *outCD = cutter->Output->GetCellData();
+      for ( ; batch < endBatch; ++batch)
+      {
+        vtkIdType newCellId = this->Offsets[batch];
+        vtkIdType triId = batch * BatchSize;
+        vtkIdType endTriId = std::min(triId + BatchSize, this->NumTriangles);
+        for ( ; triId < endTriId; ++triId)
+        {
+          if (!cutter->IsKept(triId))
+          {
+            continue;
+          }
+          vtkIdType *cell = this->Polys + 4 * newCellId;
+          cell[0] = 3;
+          std::copy(cutter->Connectivity.data() + 3 * triId,
+                    cutter->Connectivity.data() + 3 * triId + 3, cell + 1);
+          outCD->CopyData(inCD, cutter->TriangleCells[triId], newCellId);
+          ++newCellId;
+        }
+      }
+    }
+  };
+
+  void Execute()
+  {
+    // The batch evaluation is threaded by the functions that support it.
+    this->Self->CutFunction->FunctionValue(
+      this->Input->GetPoints()->GetData(), this->CutScalars);
+    this->Scalars = this->CutScalars->GetPointer(0);
+    this->Self->UpdateProgress(0.2);
+
+    // Count the triangles of each batch and contour value, and generate
+    // them in the order of the sorting.
+    this->TriangleOffsets.assign(this->NumBatches * this->NumContours, 0);
+    CountTriangles count = { this };
+    vtkSMPTools::For(0, this->NumBatches, count);
+    vtkIdType numTris = 0;
+    for (vtkIdType &offset : this->TriangleOffsets)
+    {
+      vtkIdType n = offset;
+      offset = numTris;
+      numTris += n;
+    }
+    this->Edges.resize(3 * numTris);
+    this->TriangleCells.resize(numTris);
+    EmitTriangles generate = { this };
+    vtkSMPTools::For(0, this->NumBatches, generate);
+    this->Self->UpdateProgress(0.5);
+
+    // Merge the triangle vertices on the same edges into output points.
+    vtkSMPTools::Sort(this->Edges.begin(), this->Edges.end());
+    vtkIdType numEdges = static_cast<vtkIdType>(this->Edges.size());
+    this->NewPointIds.resize(numEdges);
+    MarkNewPoints mark = { this };
+    vtkSMPTools::For(0, numEdges, mark);
+    vtkSMPTools::InclusiveScan(this->NewPointIds.begin(),
+                               this->NewPointIds.end(),
+                               this->NewPointIds.begin());
+    vtkIdType numNewPts = numEdges > 0 ? this->NewPointIds.back() : 0;
+    this->PointEdges.resize(numNewPts);
+    this->Connectivity.resize(numEdges);
+    AssignPoints assign = { this };
+    vtkSMPTools::For(0, numEdges, assign);
+    this->Self->UpdateProgress(0.7);
+
+    // Interpolate the points and their attributes along the edges. With cut
+    // scalars, these are the interpolated values of the cut function.
+    vtkSmartPointer<vtkPointData> inPD = this->Input->GetPointData();
+    if (this->Self->GenerateCutScalars)
+    {
+      inPD = vtkSmartPointer<vtkPointData>::New();
+      inPD->ShallowCopy(this->Input->GetPointData());
+      inPD->SetScalars(this->CutScalars);
+    }
+    this->InPD = inPD;
+    vtkNew<vtkPoints> newPoints;
+    int precision = this->Self->OutputPointsPrecision;
+    if (precision == vtkAlgorithm::DEFAULT_PRECISION)
+    {
+      newPoints->SetDataType(this->Input->GetPoints()->GetDataType());
+    }
+    else
+    {
+      newPoints->SetDataType(precision == vtkAlgorithm::SINGLE_PRECISION ?
+                             VTK_FLOAT : VTK_DOUBLE);
+    }
+    newPoints->SetNumberOfPoints(numNewPts);
+    vtkPointData *outPD = this->Output->GetPointData();
+    outPD->InterpolateAllocate(inPD, numNewPts);
+    outPD->SetNumberOfTuples(numNewPts);
+    InterpolatePoints interpolate = { this, newPoints->GetData() };
+    vtkSMPTools::For(0, numNewPts, interpolate);
+    this->Output->SetPoints(newPoints);
+    this->Self->UpdateProgress(0.9);
+
+    // Write the triangles that are not degenerate, with their cell data.
+    vtkIdType numTriBatches = (numTris + BatchSize - 1) / BatchSize;
+    std::vector<vtkIdType> offsets(numTriBatches);
+    CountKeptTriangles countKept = { this, numTris, offsets.data() };
+    vtkSMPTools::For(0, numTriBatches, countKept);
+    vtkIdType numNewCells = vtkSMPTools::ExclusiveScan(
+      offsets.begin(), offsets.end(), offsets.begin(),
+      static_cast<vtkIdType>(0));
+    vtkNew<vtkIdTypeArray> polyIds;
+    polyIds->SetNumberOfValues(4 * numNewCells);
+    vtkCellData *outCD = this->Output->GetCellData();
+    outCD->CopyAllocate(this->Input->GetCellData(), numNewCells);
+    outCD->SetNumberOfTuples(numNewCells);
+    WriteTriangles write =
+      { this, numTris, offsets.data(), polyIds->GetPointer(0) };
+    vtkSMPTools::For(0, numTriBatches, write);
+    if (numNewCells > 0)
+    {
+      vtkNew<vtkCellArray> polys;
+      polys->SetCells(numNewCells, polyIds);
+      this->Output->SetPolys(polys);
+    }
+    this->Self->UpdateProgress(1.0);
+  }
+};
+
+//----------------------------------------------------------------------------
+// The threaded cutting handles the linear 3D cells of unstructured grids,
+// generating triangles, and needs attribute arrays that may be filled
+// concurrently once sized, which excludes string and bit arrays.
+bool vtkCutter::CanCutInParallel(vtkDataSet *input)
+{
+  vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (!ugrid || !ugrid->GetCells() || !this->GenerateTriangles ||
+      ugrid->GetNumberOfCells() < 1)
+  {
+    return false;
+  }
+  vtkNew<vtkCellTypes> types;
+  ugrid->GetCellTypes(types);
+  for (vtkIdType i = 0; i < types->GetNumberOfTypes(); ++i)
+  {
+    switch (types->GetCellType(i))
+    {
+      case VTK_TETRA:
+      case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
+      case VTK_WEDGE:
+      case VTK_PYRAMID:
+        break;
+      default:
+        return false;
+    }
+  }
+  vtkDataSetAttributes *attributes[2] =
+    { input->GetPointData(), input->GetCellData() };
+  for (int a = 0; a < 2; ++a)
+  {
+    for (int i = 0; i < attributes[a]->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray *array =
+        vtkArrayDownCast<vtkDataArray>(attributes[a]->GetAbstractArray(i));
+      if ( !array || array->GetDataType() == VTK_BIT )
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Cut through data generating surface.
 //
@@ -404,7 +921,16 @@ int vtkCutter::RequestData(
            input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
   {
     vtkDebugMacro(<< "Executing Unstructured Grid Cutter");
-    this->UnstructuredGridCutter(input, output);
+    if (this->ParallelCutting && this->CanCutInParallel(input))
+    {
+      SMPCutter cutter(this, static_cast<vtkUnstructuredGrid *>(input),
+                       output);
+      cutter.Execute();
+    }
+    else
+    {
+      this->UnstructuredGridCutter(input, output);
+    }
   }
   else
   {
@@ -1072,4 +1598,7 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Parallel Cutting: "
+     << (this->ParallelCutting ? "On\n" : "Off\n");
 }
@@ -223,6 +223,24 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether unstructured grids made
+   * of linear 3D cells (tetrahedra, hexahedra, voxels, wedges and pyramids)
+   * are cut in parallel. If on, the cut function is evaluated at all the
+   * points at once (see vtkImplicitFunction::FunctionValue()) and the cells
+   * are contoured with vtkSMPTools for all the contour values in one
+   * pass. The output points are merged by the input edge they lie on
+   * instead of by the Locator. The output points are numbered in order of
+   * their edge and do not depend on the number of threads. Other inputs,
+   * inputs with bit or string attribute arrays, and GenerateTriangles off
+   * use the serial cutting. By default, parallel cutting is off.
+   */
+  vtkSetMacro(ParallelCutting,vtkTypeBool);
+  vtkGetMacro(ParallelCutting,vtkTypeBool);
+  vtkBooleanMacro(ParallelCutting,vtkTypeBool);
+  //@}
+
 protected:
   vtkCutter(vtkImplicitFunction *cf=nullptr);
   ~vtkCutter() override;
@@ -250,6 +268,11 @@ protected:
   vtkContourValues *ContourValues;
   vtkTypeBool GenerateCutScalars;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelCutting;
+
+  // Threaded cutting of unstructured grids, see vtkCutter.cxx.
+  struct SMPCutter;
+  bool CanCutInParallel(vtkDataSet *input);
 private:
   vtkCutter(const vtkCutter&) = delete;
   void operator=(const vtkCutter&) = delete;
@@ -25,16 +25,910 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangle.h"
 #include "vtkTransform.h"
 
+#include <algorithm>
 #include <set>
+#include <utility>
 #include <vector>
 
 vtkStandardNewMacro(vtkDelaunay2D);
 vtkCxxSetObjectMacro(vtkDelaunay2D,Transform,vtkAbstractTransform);
 
+namespace
+{
+
+// The inputs of ParallelInsertion are split in blocks of about this many
+// points, up to a maximum number of blocks, when they are large enough.
+const vtkIdType vtkDelaunay2DPointsPerBlock = 16384;
+const vtkIdType vtkDelaunay2DMaximumNumberOfBlocks = 64;
+
+//----------------------------------------------------------------------------
+// Return twice the signed area of the triangle (a,b,c) in the x-y plane,
+// positive if the triangle is counterclockwise.
+inline double vtkDelaunay2DOrientation(const double *a, const double *b,
+                                       const double *c)
+{
+  return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+//----------------------------------------------------------------------------
+// Return true if d lies inside the circumcircle of the counterclockwise
+// triangle (a,b,c). As in InCircle(), points that are nearly on the circle
+// are considered outside of it, so that nearly co-circular points do not
+// cause needless edge swaps.
+bool vtkDelaunay2DInCircle(const double *a, const double *b, const double *c,
+                           const double *d)
+{
+  double adx = a[0] - d[0], ady = a[1] - d[1];
+  double bdx = b[0] - d[0], bdy = b[1] - d[1];
+  double cdx = c[0] - d[0], cdy = c[1] - d[1];
+  double alift = adx * adx + ady * ady;
+  double blift = bdx * bdx + bdy * bdy;
+  double clift = cdx * cdx + cdy * cdy;
+
+  double det = alift * (bdx * cdy - cdx * bdy) +
+               blift * (cdx * ady - adx * cdy) +
+               clift * (adx * bdy - bdx * ady);
+  double permanent = alift * (fabs(bdx * cdy) + fabs(cdx * bdy)) +
+                     blift * (fabs(cdx * ady) + fabs(adx * cdy)) +
+                     clift * (fabs(adx * bdy) + fabs(bdx * ady));
+  return det > 1.0e-12 * permanent;
+}
+
+//----------------------------------------------------------------------------
+// Compute the center of the circumcircle of the triangle (a,b,c) in the x-y
+// plane and return its squared radius, or VTK_DOUBLE_MAX if the triangle is
+// degenerate.
+double vtkDelaunay2DCircumcircle(const double *a, const double *b,
+                                 const double *c, double center[2])
+{
+  double bx = b[0] - a[0], by = b[1] - a[1];
+  double cx = c[0] - a[0], cy = c[1] - a[1];
+  double d = 2.0 * (bx * cy - by * cx);
+  if (d == 0.0)
+  {
+    center[0] = a[0];
+    center[1] = a[1];
+    return VTK_DOUBLE_MAX;
+  }
+  double b2 = bx * bx + by * by, c2 = cx * cx + cy * cy;
+  double ux = (cy * b2 - by * c2) / d;
+  double uy = (bx * c2 - cx * b2) / d;
+  center[0] = a[0] + ux;
+  center[1] = a[1] + uy;
+  return ux * ux + uy * uy;
+}
+
+//----------------------------------------------------------------------------
+// Compute the insertion order key of a point: points are inserted in rounds
+// of increasing size (biased randomized insertion order), and in the order
+// of a Hilbert curve within each round so that consecutive points are close
+// to each other. The round of a point is drawn from a hash of its id, so
+// the order does not depend on the number of threads.
+struct vtkDelaunay2DComputeKeys
+{
+  const double *Points;
+  const double *Bounds;
+  int NumberOfRounds;
+  vtkTypeUInt64 *Keys;
+
+  static vtkTypeUInt64 HilbertIndex(unsigned int x, unsigned int y)
+  {
+    vtkTypeUInt64 d = 0;
+    for (unsigned int s = 1u << 15; s > 0; s >>= 1)
+    {
+      unsigned int rx = (x & s) ? 1 : 0;
+      unsigned int ry = (y & s) ? 1 : 0;
+      d += static_cast<vtkTypeUInt64>(s) * s * ((3 * rx) ^ ry);
+      if (ry == 0)
+      {
+        if (rx == 1)
+        {
+          x = 0xffff - x;
+          y = 0xffff - y;
+        }
+        std::swap(x, y);
+      }
+    }
+    return d;
+  }
+
+  static int Round(vtkIdType ptId, int numRounds)
+  {
+    vtkTypeUInt64 z = static_cast<vtkTypeUInt64>(ptId) +
+      0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= (z >> 31);
+    int round = 0;
+    while (round < numRounds && !(z & 1))
+    {
+      z >>= 1;
+      round++;
+    }
+    return numRounds - round;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double sx = this->Bounds[1] > this->Bounds[0] ?
+      65535.0 / (this->Bounds[1] - this->Bounds[0]) : 0.0;
+    double sy = this->Bounds[3] > this->Bounds[2] ?
+      65535.0 / (this->Bounds[3] - this->Bounds[2]) : 0.0;
+    for (vtkIdType ptId = begin; ptId < end; ptId++)
+    {
+      const double *x = this->Points + 3 * ptId;
+      unsigned int ix = static_cast<unsigned int>(
+        std::min(65535.0, std::max(0.0, (x[0] - this->Bounds[0]) * sx)));
+      unsigned int iy = static_cast<unsigned int>(
+        std::min(65535.0, std::max(0.0, (x[1] - this->Bounds[2]) * sy)));
+      this->Keys[ptId] =
+        (static_cast<vtkTypeUInt64>(Round(ptId, this->NumberOfRounds)) << 32) |
+        HilbertIndex(ix, iy);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Sort point ids by insertion key.
+void vtkDelaunay2DSortByKey(const vtkTypeUInt64 *keys,
+                            std::vector<vtkIdType> &ids, bool parallel)
+{
+  typedef std::pair<vtkTypeUInt64, vtkIdType> vtkDelaunay2DKeyId;
+  std::vector<vtkDelaunay2DKeyId> keyIds(ids.size());
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    keyIds[i] = vtkDelaunay2DKeyId(keys[ids[i]], ids[i]);
+  }
+  if (parallel)
+  {
+    vtkSMPTools::Sort(keyIds.begin(), keyIds.end());
+  }
+  else
+  {
+    std::sort(keyIds.begin(), keyIds.end());
+  }
+  for (size_t i = 0; i < ids.size(); i++)
+  {
+    ids[i] = keyIds[i].second;
+  }
+}
+
+//----------------------------------------------------------------------------
+// Order point ids by x or y coordinate.
+struct vtkDelaunay2DCoordinateLess
+{
+  const double *Points;
+  int Axis;
+  bool operator()(vtkIdType p1, vtkIdType p2) const
+  {
+    double x1 = this->Points[3 * p1 + this->Axis];
+    double x2 = this->Points[3 * p2 + this->Axis];
+    return x1 < x2 || (x1 == x2 && p1 < p2);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Compact triangulation used by the ParallelInsertion mode. The triangles
+// are stored as triplets of counterclockwise point ids, together with their
+// edge neighbors: Neighbors[3*t+i] is the triangle on the other side of the
+// edge (Triangles[3*t+i],Triangles[3*t+(i+1)%3]), or -1 on the boundary.
+// The mesh starts with the six triangles of the bounding octagon whose
+// points follow the numPts input points. Points are inserted with Lawson's
+// algorithm: the triangle containing the point is found by walking from the
+// last triangle created, it is split in three (or the two triangles sharing
+// the edge the point lies on are split in four), and the edges opposite the
+// point are swapped until they satisfy the Delaunay criterion.
+class vtkDelaunay2DTriangulation
+{
+public:
+  vtkDelaunay2DTriangulation(const double *points, vtkIdType numPts,
+                             double tol, double eps) :
+    NumberOfDuplicatePoints(0), NumberOfDegeneracies(0), Points(points),
+    NumberOfPoints(numPts), Tolerance(tol), Epsilon(eps), LastTriangle(0)
+  {
+  }
+
+  std::vector<vtkIdType> Triangles;
+  std::vector<vtkIdType> Neighbors;
+  vtkIdType NumberOfDuplicatePoints;
+  vtkIdType NumberOfDegeneracies;
+
+  vtkIdType GetNumberOfTriangles() const
+  {
+    return static_cast<vtkIdType>(this->Triangles.size() / 3);
+  }
+
+  // Create the bounding triangles, the same as in RequestData().
+  void Initialize(vtkIdType numPtsToInsert)
+  {
+    static const int octagon[6][3] =
+      { {0,1,2}, {2,3,4}, {4,5,6}, {6,7,0}, {0,2,6}, {2,4,6} };
+    static const vtkIdType neighbors[6][3] =
+      { {-1,-1,4}, {-1,-1,5}, {-1,-1,5}, {-1,-1,4}, {0,5,3}, {1,2,4} };
+
+    this->Triangles.clear();
+    this->Neighbors.clear();
+    this->Triangles.reserve(3 * (2 * numPtsToInsert + 6));
+    this->Neighbors.reserve(3 * (2 * numPtsToInsert + 6));
+    for (int i = 0; i < 6; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        this->Triangles.push_back(this->NumberOfPoints + octagon[i][j]);
+        this->Neighbors.push_back(neighbors[i][j]);
+      }
+    }
+    this->LastTriangle = 0;
+  }
+
+  // Find the triangle containing x by walking from triangle tri. Returns -1
+  // if the walk fails. On return, edge is the edge of the triangle that x
+  // lies on, -1 if x is inside the triangle, or -2 if x is on two edges
+  // (i.e. at a vertex).
+  vtkIdType FindTriangle(const double *x, vtkIdType tri, int &edge) const
+  {
+    vtkIdType numTris = this->GetNumberOfTriangles();
+    for (vtkIdType step = 0; step <= numTris; step++)
+    {
+      // Start with a varying edge to avoid walking in circles
+      int exitEdge = this->ClassifyPoint(x, tri, static_cast<int>(step % 3),
+                                         edge);
+      if (exitEdge < 0)
+      {
+        return tri;
+      }
+      if ((tri = this->Neighbors[3 * tri + exitEdge]) < 0)
+      {
+        return -1;
+      }
+    }
+    return -1;
+  }
+
+  // Insert point ptId. Returns false if it is a duplicate point or if it
+  // could not be located.
+  bool InsertPoint(vtkIdType ptId)
+  {
+    const double *x = this->Points + 3 * ptId;
+    int edge;
+    vtkIdType tri = this->FindTriangle(x, this->LastTriangle, edge);
+    if (tri < 0)
+    { // Numerical trouble; search all triangles
+      vtkIdType numTris = this->GetNumberOfTriangles();
+      for (tri = 0; tri < numTris; tri++)
+      {
+        if (this->ClassifyPoint(x, tri, 0, edge) < 0)
+        {
+          break;
+        }
+      }
+      if (tri >= numTris)
+      {
+        this->NumberOfDegeneracies++;
+        return false;
+      }
+    }
+
+    const vtkIdType *pts = &this->Triangles[3 * tri];
+    for (int i = 0; i < 3; i++)
+    {
+      const double *v = this->Points + 3 * pts[i];
+      if (sqrt((x[0] - v[0]) * (x[0] - v[0]) + (x[1] - v[1]) * (x[1] - v[1]))
+          <= this->Tolerance)
+      {
+        this->NumberOfDuplicatePoints++;
+        return false;
+      }
+    }
+    if (edge == -2)
+    {
+      this->NumberOfDuplicatePoints++;
+      return false;
+    }
+
+    if (edge >= 0 && this->Neighbors[3 * tri + edge] >= 0)
+    {
+      this->SplitEdge(ptId, tri, edge);
+    }
+    else
+    {
+      this->SplitTriangle(ptId, tri);
+    }
+    this->LegalizeEdges();
+    this->LastTriangle = tri;
+    return true;
+  }
+
+private:
+  const double *Points;
+  vtkIdType NumberOfPoints;
+  double Tolerance;
+  double Epsilon;
+  vtkIdType LastTriangle;
+  std::vector<vtkIdType> Stack;
+
+  // Return an edge of triangle tri that x lies outside of, starting the
+  // search from edge start, or -1 if x is inside or on the boundary of the
+  // triangle. See FindTriangle() for onEdge.
+  int ClassifyPoint(const double *x, vtkIdType tri, int start,
+                    int &onEdge) const
+  {
+    const vtkIdType *pts = &this->Triangles[3 * tri];
+    int numOnEdges = 0;
+    onEdge = -1;
+    for (int ic = 0; ic < 3; ic++)
+    {
+      int i = (start + ic) % 3;
+      const double *p1 = this->Points + 3 * pts[i];
+      const double *p2 = this->Points + 3 * pts[(i + 1) % 3];
+      double len = sqrt((p2[0] - p1[0]) * (p2[0] - p1[0]) +
+                        (p2[1] - p1[1]) * (p2[1] - p1[1]));
+      double dist = vtkDelaunay2DOrientation(p1, p2, x);
+      if (dist < -this->Epsilon * len)
+      {
+        return i;
+      }
+      else if (dist <= this->Epsilon * len)
+      {
+        onEdge = i;
+        numOnEdges++;
+      }
+    }
+    if (numOnEdges > 1)
+    {
+      onEdge = -2;
+    }
+    return -1;
+  }
+
+  void SetTriangle(vtkIdType tri, vtkIdType p0, vtkIdType p1, vtkIdType p2,
+                   vtkIdType n0, vtkIdType n1, vtkIdType n2)
+  {
+    vtkIdType *pts = &this->Triangles[3 * tri];
+    vtkIdType *nei = &this->Neighbors[3 * tri];
+    pts[0] = p0; pts[1] = p1; pts[2] = p2;
+    nei[0] = n0; nei[1] = n1; nei[2] = n2;
+  }
+
+  vtkIdType NewTriangle()
+  {
+    vtkIdType tri = this->GetNumberOfTriangles();
+    this->Triangles.resize(3 * (tri + 1));
+    this->Neighbors.resize(3 * (tri + 1));
+    return tri;
+  }
+
+  void ReplaceNeighbor(vtkIdType tri, vtkIdType oldNei, vtkIdType newNei)
+  {
+    if (tri >= 0)
+    {
+      vtkIdType *nei = &this->Neighbors[3 * tri];
+      for (int i = 0; i < 3; i++)
+      {
+        if (nei[i] == oldNei)
+        {
+          nei[i] = newNei;
+          return;
+        }
+      }
+    }
+  }
+
+  // Split triangle (a,b,c) into (a,b,p), (b,c,p) and (c,a,p). The new point
+  // is always the third point of the new triangles, so that the edge to
+  // check is the first one.
+  void SplitTriangle(vtkIdType p, vtkIdType tri)
+  {
+    vtkIdType a = this->Triangles[3 * tri];
+    vtkIdType b = this->Triangles[3 * tri + 1];
+    vtkIdType c = this->Triangles[3 * tri + 2];
+    vtkIdType na = this->Neighbors[3 * tri];
+    vtkIdType nb = this->Neighbors[3 * tri + 1];
+    vtkIdType nc = this->Neighbors[3 * tri + 2];
+    vtkIdType tri1 = this->NewTriangle();
+    vtkIdType tri2 = this->NewTriangle();
+
+    this->SetTriangle(tri, a, b, p, na, tri1, tri2);
+    this->SetTriangle(tri1, b, c, p, nb, tri2, tri);
+    this->SetTriangle(tri2, c, a, p, nc, tri, tri1);
+    this->ReplaceNeighbor(nb, tri, tri1);
+    this->ReplaceNeighbor(nc, tri, tri2);
+
+    this->Stack.push_back(tri);
+    this->Stack.push_back(tri1);
+    this->Stack.push_back(tri2);
+  }
+
+  // Split the edge (a,b) shared by triangles (a,b,c) and (b,a,d) into the
+  // four triangles (b,c,p), (c,a,p), (a,d,p) and (d,b,p).
+  void SplitEdge(vtkIdType p, vtkIdType tri, int edge)
+  {
+    vtkIdType a = this->Triangles[3 * tri + edge];
+    vtkIdType b = this->Triangles[3 * tri + (edge + 1) % 3];
+    vtkIdType c = this->Triangles[3 * tri + (edge + 2) % 3];
+    vtkIdType nbc = this->Neighbors[3 * tri + (edge + 1) % 3];
+    vtkIdType nca = this->Neighbors[3 * tri + (edge + 2) % 3];
+    vtkIdType nei = this->Neighbors[3 * tri + edge];
+    int j = 0;
+    while (this->Neighbors[3 * nei + j] != tri)
+    {
+      j++;
+    }
+    vtkIdType d = this->Triangles[3 * nei + (j + 2) % 3];
+    vtkIdType nad = this->Neighbors[3 * nei + (j + 1) % 3];
+    vtkIdType ndb = this->Neighbors[3 * nei + (j + 2) % 3];
+    vtkIdType tri1 = this->NewTriangle();
+    vtkIdType nei1 = this->NewTriangle();
+
+    this->SetTriangle(tri, b, c, p, nbc, tri1, nei1);
+    this->SetTriangle(tri1, c, a, p, nca, nei, tri);
+    this->SetTriangle(nei, a, d, p, nad, nei1, tri1);
+    this->SetTriangle(nei1, d, b, p, ndb, tri, nei);
+    this->ReplaceNeighbor(nca, tri, tri1);
+    this->ReplaceNeighbor(ndb, nei, nei1);
+
+    this->Stack.push_back(tri);
+    this->Stack.push_back(tri1);
+    this->Stack.push_back(nei);
+    this->Stack.push_back(nei1);
+  }
+
+  // Check the first edge (a,b) of the triangles (a,b,p) on the stack and
+  // swap it with (p,d) if d, the opposite point of the neighbor (b,a,d),
+  // lies in the circumcircle of (a,b,p).
+  void LegalizeEdges()
+  {
+    while (!this->Stack.empty())
+    {
+      vtkIdType tri = this->Stack.back();
+      this->Stack.pop_back();
+      vtkIdType nei = this->Neighbors[3 * tri];
+      if (nei < 0)
+      {
+        continue;
+      }
+      vtkIdType a = this->Triangles[3 * tri];
+      vtkIdType b = this->Triangles[3 * tri + 1];
+      vtkIdType p = this->Triangles[3 * tri + 2];
+      int j = 0;
+      while (this->Neighbors[3 * nei + j] != tri)
+      {
+        j++;
+      }
+      vtkIdType d = this->Triangles[3 * nei + (j + 2) % 3];
+      const double *xa = this->Points + 3 * a;
+      const double *xb = this->Points + 3 * b;
+      const double *xp = this->Points + 3 * p;
+      const double *xd = this->Points + 3 * d;
+      if (!vtkDelaunay2DInCircle(xa, xb, xp, xd) ||
+          vtkDelaunay2DOrientation(xa, xd, xp) <= 0.0 ||
+          vtkDelaunay2DOrientation(xd, xb, xp) <= 0.0)
+      {
+        continue;
+      }
+
+      vtkIdType nad = this->Neighbors[3 * nei + (j + 1) % 3];
+      vtkIdType ndb = this->Neighbors[3 * nei + (j + 2) % 3];
+      vtkIdType nbp = this->Neighbors[3 * tri + 1];
+      vtkIdType npa = this->Neighbors[3 * tri + 2];
+      this->SetTriangle(tri, a, d, p, nad, nei, npa);
+      this->SetTriangle(nei, d, b, p, ndb, nbp, tri);
+      this->ReplaceNeighbor(nad, nei, tri);
+      this->ReplaceNeighbor(nbp, tri, nei);
+
+      this->Stack.push_back(tri);
+      this->Stack.push_back(nei);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Triangulate the blocks of points concurrently. A triangle of a block is
+// final if its circumcircle lies strictly inside the bounding box of the
+// block: no point of another block can then lie in it, so the triangle
+// belongs to the triangulation of all the points. The points of the other
+// triangles are marked as seam points, which are triangulated afterwards.
+struct vtkDelaunay2DTriangulateBlocks
+{
+  const double *Points;
+  vtkIdType NumberOfPoints;
+  double Tolerance;
+  double Epsilon;
+  const vtkIdType *Ids;
+  const vtkIdType *BlockOffsets;
+  const vtkTypeUInt64 *Keys;
+  std::vector<vtkDelaunay2DTriangulation*> *Blocks;
+  std::vector<std::vector<char> > *Final;
+  std::vector<std::vector<double> > *BlockBounds;
+  char *SeamPoints;
+  vtkIdType *PointTriangles;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; block++)
+    {
+      vtkIdType first = this->BlockOffsets[block];
+      vtkIdType last = this->BlockOffsets[block + 1];
+      std::vector<vtkIdType> ids(this->Ids + first, this->Ids + last);
+      vtkDelaunay2DSortByKey(this->Keys, ids, false);
+
+      vtkDelaunay2DTriangulation *mesh = new vtkDelaunay2DTriangulation(
+        this->Points, this->NumberOfPoints, this->Tolerance, this->Epsilon);
+      (*this->Blocks)[block] = mesh;
+      mesh->Initialize(last - first);
+
+      std::vector<double> &bds = (*this->BlockBounds)[block];
+      bds.assign(4, 0.0);
+      bds[0] = bds[2] = VTK_DOUBLE_MAX;
+      bds[1] = bds[3] = -VTK_DOUBLE_MAX;
+      for (std::vector<vtkIdType>::iterator it = ids.begin();
+           it != ids.end(); ++it)
+      {
+        mesh->InsertPoint(*it);
+        const double *x = this->Points + 3 * (*it);
+        bds[0] = std::min(bds[0], x[0]);
+        bds[1] = std::max(bds[1], x[0]);
+        bds[2] = std::min(bds[2], x[1]);
+        bds[3] = std::max(bds[3], x[1]);
+      }
+
+      // Keep a margin of one tolerance, so that no point of another block
+      // is a duplicate of a point used by final triangles only.
+      double margin = this->Tolerance + this->Epsilon;
+      vtkIdType numTris = mesh->GetNumberOfTriangles();
+      std::vector<char> &finalTris = (*this->Final)[block];
+      finalTris.assign(numTris, 0);
+      for (vtkIdType tri = 0; tri < numTris; tri++)
+      {
+        const vtkIdType *pts = &mesh->Triangles[3 * tri];
+        if (pts[0] < this->NumberOfPoints && pts[1] < this->NumberOfPoints &&
+            pts[2] < this->NumberOfPoints)
+        {
+          double center[2];
+          double radius = sqrt(vtkDelaunay2DCircumcircle(
+            this->Points + 3 * pts[0], this->Points + 3 * pts[1],
+            this->Points + 3 * pts[2], center));
+          finalTris[tri] = (center[0] - radius > bds[0] + margin &&
+                        center[0] + radius < bds[1] - margin &&
+                        center[1] - radius > bds[2] + margin &&
+                        center[1] + radius < bds[3] - margin);
+        }
+        for (int i = 0; i < 3; i++)
+        {
+          if (pts[i] < this->NumberOfPoints)
+          {
+            this->PointTriangles[pts[i]] = tri;
+            if (!finalTris[tri])
+            {
+              this->SeamPoints[pts[i]] = 1;
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Select the triangles of the seam triangulation that are not covered by the
+// final triangles of the blocks. The triangulation of the seam points
+// contains all the triangles of the whole triangulation that are not final;
+// its other triangles lie inside the final triangles of a single block.
+struct vtkDelaunay2DSelectSeamTriangles
+{
+  const double *Points;
+  vtkIdType NumberOfPoints;
+  const vtkDelaunay2DTriangulation *Seam;
+  const std::vector<vtkDelaunay2DTriangulation*> *Blocks;
+  const std::vector<std::vector<char> > *Final;
+  const std::vector<std::vector<double> > *BlockBounds;
+  const vtkIdType *PointBlocks;
+  const vtkIdType *PointTriangles;
+  char *Keep;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType tri = begin; tri < end; tri++)
+    {
+      const vtkIdType *pts = &this->Seam->Triangles[3 * tri];
+      this->Keep[tri] = 1;
+      if (pts[0] >= this->NumberOfPoints || pts[1] >= this->NumberOfPoints ||
+          pts[2] >= this->NumberOfPoints)
+      {
+        continue;
+      }
+      vtkIdType block = this->PointBlocks[pts[0]];
+      if (this->PointBlocks[pts[1]] != block ||
+          this->PointBlocks[pts[2]] != block)
+      {
+        continue;
+      }
+
+      double c[3] = { 0.0, 0.0, 0.0 };
+      for (int i = 0; i < 3; i++)
+      {
+        c[0] += this->Points[3 * pts[i]] / 3.0;
+        c[1] += this->Points[3 * pts[i] + 1] / 3.0;
+      }
+      const std::vector<double> &bds = (*this->BlockBounds)[block];
+      if (c[0] <= bds[0] || c[0] >= bds[1] || c[1] <= bds[2] ||
+          c[1] >= bds[3])
+      {
+        continue;
+      }
+      int edge;
+      vtkIdType blockTri = (*this->Blocks)[block]->FindTriangle(
+        c, this->PointTriangles[pts[0]], edge);
+      if (blockTri >= 0 && (*this->Final)[block][blockTri])
+      {
+        this->Keep[tri] = 0;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the final triangles of the blocks into the output connectivity.
+struct vtkDelaunay2DCopyFinalTriangles
+{
+  const std::vector<vtkDelaunay2DTriangulation*> *Blocks;
+  const std::vector<std::vector<char> > *Final;
+  const vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  char *UsedPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; block++)
+    {
+      const vtkDelaunay2DTriangulation *mesh = (*this->Blocks)[block];
+      const std::vector<char> &finalTris = (*this->Final)[block];
+      vtkIdType *conn = this->Connectivity + 4 * this->Offsets[block];
+      vtkIdType numTris = mesh->GetNumberOfTriangles();
+      for (vtkIdType tri = 0; tri < numTris; tri++)
+      {
+        if (finalTris[tri])
+        {
+          const vtkIdType *pts = &mesh->Triangles[3 * tri];
+          *conn++ = 3;
+          for (int i = 0; i < 3; i++)
+          {
+            *conn++ = pts[i];
+            this->UsedPoints[pts[i]] = 1;
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the seam edges matching the boundary edges of the final triangles of
+// each block. A block is invalid if one of its boundary edges is missing.
+typedef std::pair<vtkIdType, vtkIdType> vtkDelaunay2DEdge;
+struct vtkDelaunay2DMatchSeamEdges
+{
+  const std::vector<vtkDelaunay2DTriangulation*> *Blocks;
+  const std::vector<std::vector<char> > *Final;
+  const std::vector<vtkDelaunay2DEdge> *SeamEdges;
+  std::vector<std::vector<vtkIdType> > *Matches;
+  char *Valid;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType block = begin; block < end; block++)
+    {
+      const vtkDelaunay2DTriangulation *mesh = (*this->Blocks)[block];
+      const std::vector<char> &finalTris = (*this->Final)[block];
+      vtkIdType numTris = mesh->GetNumberOfTriangles();
+      for (vtkIdType tri = 0; tri < numTris; tri++)
+      {
+        for (int i = 0; finalTris[tri] && i < 3; i++)
+        {
+          vtkIdType nei = mesh->Neighbors[3 * tri + i];
+          if (nei >= 0 && finalTris[nei])
+          {
+            continue;
+          }
+          vtkDelaunay2DEdge edge(mesh->Triangles[3 * tri + (i + 1) % 3],
+                                 mesh->Triangles[3 * tri + i]);
+          std::vector<vtkDelaunay2DEdge>::const_iterator it = std::lower_bound(
+            this->SeamEdges->begin(), this->SeamEdges->end(), edge);
+          if (it == this->SeamEdges->end() || *it != edge)
+          {
+            this->Valid[block] = 0;
+            return;
+          }
+          (*this->Matches)[block].push_back(it - this->SeamEdges->begin());
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Triangulate the points in about numBlocks blocks, split along x and then
+// along y, and set numBlocks to their actual number. The blocks are stitched
+// together by triangulating the seam points. The result is checked: the seam
+// triangles must match the boundary edges of the final triangles and the
+// number of triangles must be that of a triangulation of the points used.
+// Returns false if the check fails.
+bool vtkDelaunay2DTriangulateInBlocks(const double *x, vtkIdType numPts,
+                                      double tol, double eps,
+                                      const vtkTypeUInt64 *keys,
+                                      vtkIdType &numBlocks,
+                                      vtkCellArray *triangles,
+                                      vtkIdType &numDuplicates,
+                                      vtkIdType &numDegeneracies)
+{
+  vtkIdType numStrips = std::max(static_cast<vtkIdType>(1),
+    static_cast<vtkIdType>(sqrt(static_cast<double>(numBlocks))));
+  vtkIdType blocksPerStrip = numBlocks / numStrips;
+  numBlocks = numStrips * blocksPerStrip;
+
+  std::vector<vtkIdType> ids(numPts);
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+  {
+    ids[ptId] = ptId;
+  }
+  vtkDelaunay2DCoordinateLess xLess = { x, 0 };
+  vtkDelaunay2DCoordinateLess yLess = { x, 1 };
+  vtkSMPTools::Sort(ids.begin(), ids.end(), xLess);
+  std::vector<vtkIdType> offsets(numBlocks + 1);
+  std::vector<vtkIdType> pointBlocks(numPts);
+  for (vtkIdType strip = 0; strip < numStrips; strip++)
+  {
+    vtkIdType first = numPts * strip / numStrips;
+    vtkIdType last = numPts * (strip + 1) / numStrips;
+    vtkSMPTools::Sort(ids.begin() + first, ids.begin() + last, yLess);
+    for (vtkIdType i = 0; i < blocksPerStrip; i++)
+    {
+      offsets[strip * blocksPerStrip + i] =
+        first + (last - first) * i / blocksPerStrip;
+    }
+  }
+  offsets[numBlocks] = numPts;
+  for (vtkIdType block = 0; block < numBlocks; block++)
+  {
+    for (vtkIdType i = offsets[block]; i < offsets[block + 1]; i++)
+    {
+      pointBlocks[ids[i]] = block;
+    }
+  }
+
+  // Triangulate the blocks
+  std::vector<vtkDelaunay2DTriangulation*> blocks(numBlocks, nullptr);
+  std::vector<std::vector<char> > finalTris(numBlocks);
+  std::vector<std::vector<double> > blockBounds(numBlocks);
+  std::vector<char> seamPoints(numPts, 0);
+  std::vector<vtkIdType> pointTriangles(numPts, -1);
+  vtkDelaunay2DTriangulateBlocks triangulate = { x, numPts, tol, eps,
+    ids.data(), offsets.data(), keys, &blocks, &finalTris, &blockBounds,
+    seamPoints.data(), pointTriangles.data() };
+  vtkSMPTools::For(0, numBlocks, 1, triangulate);
+
+  // Triangulate the seam points and select the triangles not covered by
+  // final triangles
+  ids.clear();
+  for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+  {
+    if (seamPoints[ptId])
+    {
+      ids.push_back(ptId);
+    }
+  }
+  vtkDelaunay2DSortByKey(keys, ids, true);
+  vtkDelaunay2DTriangulation seam(x, numPts, tol, eps);
+  seam.Initialize(static_cast<vtkIdType>(ids.size()));
+  for (std::vector<vtkIdType>::iterator it = ids.begin(); it != ids.end();
+       ++it)
+  {
+    seam.InsertPoint(*it);
+  }
+  vtkIdType numSeamTris = seam.GetNumberOfTriangles();
+  std::vector<char> keep(numSeamTris);
+  vtkDelaunay2DSelectSeamTriangles select = { x, numPts, &seam, &blocks,
+    &finalTris, &blockBounds, pointBlocks.data(), pointTriangles.data(),
+    keep.data() };
+  vtkSMPTools::For(0, numSeamTris, select);
+
+  // Copy the final and the seam triangles
+  std::vector<vtkIdType> triOffsets(numBlocks + 1, 0);
+  for (vtkIdType block = 0; block < numBlocks; block++)
+  {
+    triOffsets[block + 1] = triOffsets[block] + static_cast<vtkIdType>(
+      std::count(finalTris[block].begin(), finalTris[block].end(), 1));
+  }
+  vtkIdType numFinalTris = triOffsets[numBlocks];
+  vtkIdType numTris = numFinalTris +
+    static_cast<vtkIdType>(std::count(keep.begin(), keep.end(), 1));
+  std::vector<char> usedPoints(numPts, 0);
+  vtkIdType *conn = triangles->WritePointer(numTris, 4 * numTris);
+  vtkDelaunay2DCopyFinalTriangles copy = { &blocks, &finalTris,
+    triOffsets.data(), conn, usedPoints.data() };
+  vtkSMPTools::For(0, numBlocks, 1, copy);
+
+  std::vector<vtkDelaunay2DEdge> seamEdges;
+  conn += 4 * numFinalTris;
+  for (vtkIdType tri = 0; tri < numSeamTris; tri++)
+  {
+    if (keep[tri])
+    {
+      const vtkIdType *pts = &seam.Triangles[3 * tri];
+      *conn++ = 3;
+      for (int i = 0; i < 3; i++)
+      {
+        *conn++ = pts[i];
+        if (pts[i] < numPts)
+        {
+          usedPoints[pts[i]] = 1;
+        }
+        seamEdges.push_back(vtkDelaunay2DEdge(pts[i], pts[(i + 1) % 3]));
+      }
+    }
+  }
+
+  // Check the seams: each boundary edge of the final triangles must be
+  // shared by a seam triangle, and each edge of the seam triangles by a
+  // final or a seam triangle, except on the bounding octagon.
+  vtkIdType numUsedPts = 8 +
+    static_cast<vtkIdType>(std::count(usedPoints.begin(), usedPoints.end(), 1));
+  bool valid = (numTris == 2 * numUsedPts - 10);
+  std::sort(seamEdges.begin(), seamEdges.end());
+  valid = valid &&
+    std::adjacent_find(seamEdges.begin(), seamEdges.end()) == seamEdges.end();
+  std::vector<char> matched(seamEdges.size(), 0);
+  if (valid)
+  {
+    std::vector<std::vector<vtkIdType> > blockMatches(numBlocks);
+    std::vector<char> blockValid(numBlocks, 1);
+    vtkDelaunay2DMatchSeamEdges match = { &blocks, &finalTris, &seamEdges,
+      &blockMatches, blockValid.data() };
+    vtkSMPTools::For(0, numBlocks, 1, match);
+    for (vtkIdType block = 0; block < numBlocks; block++)
+    {
+      valid = valid && blockValid[block];
+      for (size_t i = 0; i < blockMatches[block].size(); i++)
+      {
+        matched[blockMatches[block][i]] = 1;
+      }
+    }
+  }
+  for (size_t i = 0; valid && i < seamEdges.size(); i++)
+  {
+    vtkDelaunay2DEdge reverse(seamEdges[i].second, seamEdges[i].first);
+    bool octagonEdge = seamEdges[i].first >= numPts &&
+      seamEdges[i].second >= numPts &&
+      (seamEdges[i].first - numPts + 1) % 8 == seamEdges[i].second - numPts;
+    valid = matched[i] || octagonEdge ||
+      std::binary_search(seamEdges.begin(), seamEdges.end(), reverse);
+  }
+
+  if (valid)
+  {
+    numDuplicates += seam.NumberOfDuplicatePoints;
+    numDegeneracies += seam.NumberOfDegeneracies;
+  }
+  for (vtkIdType block = 0; block < numBlocks; block++)
+  {
+    if (valid)
+    {
+      numDuplicates += blocks[block]->NumberOfDuplicatePoints;
+      numDegeneracies += blocks[block]->NumberOfDegeneracies;
+    }
+    delete blocks[block];
+  }
+
+  return valid;
+}
+
+}// namespace
+
 // Construct object with Alpha = 0.0; Tolerance = 0.00001; Offset = 1.25;
 // BoundingTriangulation turned off.
 vtkDelaunay2D::vtkDelaunay2D()
@@ -45,6 +939,8 @@ vtkDelaunay2D::vtkDelaunay2D()
   this->Offset = 1.0;
   this->Transform = nullptr;
   this->ProjectionPlaneMode = VTK_DELAUNAY_XY_PLANE;
+  this->ParallelInsertion = 0;
+  this->NumberOfBlocks = 0;
 
   // optional 2nd input
   this->SetNumberOfInputPorts(2);
@@ -271,6 +1167,97 @@ void vtkDelaunay2D::CheckEdge(vtkIdType ptId, double x[3], vtkIdType p1,
   neighbors->Delete();
 }
 
+//----------------------------------------------------------------------------
+// Triangulate the points with the compact triangulation when
+// ParallelInsertion is on. The points are inserted in rounds sorted along a
+// Hilbert curve. Large inputs are split in blocks which are triangulated
+// concurrently and then stitched together; if the stitching fails, the
+// points are triangulated serially.
+void vtkDelaunay2D::InsertPointsInParallel(vtkIdType numPoints, double tol,
+                                           vtkCellArray *triangles)
+{
+  const double *x = this->Points;
+  double bounds[4] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+                       VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  vtkIdType ptId, i;
+  for (ptId=0; ptId < numPoints; ptId++)
+  {
+    bounds[0] = std::min(bounds[0], x[3*ptId]);
+    bounds[1] = std::max(bounds[1], x[3*ptId]);
+    bounds[2] = std::min(bounds[2], x[3*ptId+1]);
+    bounds[3] = std::max(bounds[3], x[3*ptId+1]);
+  }
+  double eps = 1.0e-12 * sqrt((bounds[1]-bounds[0])*(bounds[1]-bounds[0]) +
+                              (bounds[3]-bounds[2])*(bounds[3]-bounds[2]));
+
+  // The first round holds a few tens of points, each following round about
+  // as many points as all the previous ones.
+  int numRounds = 0;
+  while ( numRounds < 30 && (numPoints >> (numRounds+1)) >= 16 )
+  {
+    numRounds++;
+  }
+  std::vector<vtkTypeUInt64> keys(numPoints);
+  vtkDelaunay2DComputeKeys computeKeys = { x, bounds, numRounds, keys.data() };
+  vtkSMPTools::For(0, numPoints, computeKeys);
+  this->UpdateProgress(0.1);
+
+  vtkIdType numDuplicates = 0;
+  vtkIdType numDegeneracies = 0;
+  vtkIdType numBlocks = std::min(vtkDelaunay2DMaximumNumberOfBlocks,
+                                 numPoints / vtkDelaunay2DPointsPerBlock);
+  this->NumberOfBlocks = 0;
+  if ( numBlocks > 1 )
+  {
+    if ( vtkDelaunay2DTriangulateInBlocks(x, numPoints, tol, eps, keys.data(),
+                                          numBlocks, triangles, numDuplicates,
+                                          numDegeneracies) )
+    {
+      this->NumberOfDuplicatePoints += static_cast<int>(numDuplicates);
+      this->NumberOfDegeneracies += static_cast<int>(numDegeneracies);
+      this->NumberOfBlocks = numBlocks;
+      return;
+    }
+    vtkDebugMacro(<<"Seams between blocks not recovered, "
+                  "triangulating the points serially");
+  }
+
+  std::vector<vtkIdType> ids(numPoints);
+  for (ptId=0; ptId < numPoints; ptId++)
+  {
+    ids[ptId] = ptId;
+  }
+  vtkDelaunay2DSortByKey(keys.data(), ids, true);
+
+  vtkDelaunay2DTriangulation mesh(x, numPoints, tol, eps);
+  mesh.Initialize(numPoints);
+  for (i=0; i < numPoints; i++)
+  {
+    mesh.InsertPoint(ids[i]);
+    if ( ! (i % 1000) )
+    {
+      vtkDebugMacro(<<"point #" << i);
+      this->UpdateProgress (0.1 + 0.9*static_cast<double>(i)/numPoints);
+      if (this->GetAbortExecute())
+      {
+        break;
+      }
+    }
+  }
+  this->NumberOfDuplicatePoints += static_cast<int>(mesh.NumberOfDuplicatePoints);
+  this->NumberOfDegeneracies += static_cast<int>(mesh.NumberOfDegeneracies);
+
+  vtkIdType numTris = mesh.GetNumberOfTriangles();
+  vtkIdType *conn = triangles->WritePointer(numTris, 4*numTris);
+  for (i=0; i < numTris; i++)
+  {
+    *conn++ = 3;
+    *conn++ = mesh.Triangles[3*i];
+    *conn++ = mesh.Triangles[3*i+1];
+    *conn++ = mesh.Triangles[3*i+2];
+  }
+}
+
 // 2D Delaunay triangulation. Steps are as follows:
 //   1. For each point
 //   2. Find triangle point is in
@@ -442,6 +1429,16 @@ int vtkDelaunay2D::RequestData(
   triangles->InsertNextCell(3,pts);
   tri[0] = 0;
 
+  // The parallel insertion triangulates all the points at once, from its own
+  // bounding triangles, so that none is left for the loop below.
+  vtkIdType firstPtId = 0;
+  if ( this->ParallelInsertion )
+  {
+    triangles->Reset();
+    this->InsertPointsInParallel(numPoints, tol, triangles);
+    firstPtId = numPoints;
+  }
+
   this->Mesh->SetPoints(points);
   this->Mesh->SetPolys(triangles);
   this->Mesh->BuildLinks(); //build cell structure
@@ -451,7 +1448,7 @@ int vtkDelaunay2D::RequestData(
   // satisfy criterion have their edges swapped. This continues recursively
   // until all triangles have been shown to be Delaunay.
   //
-  for (ptId=0; ptId < numPoints; ptId++)
+  for (ptId=firstPtId; ptId < numPoints; ptId++)
   {
     this->GetPoint(ptId,x);
     nei[0] = (-1); //where we are coming from...nowhere initially
@@ -1566,4 +2563,6 @@ void vtkDelaunay2D::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Offset: " << this->Offset << "\n";
   os << indent << "Bounding Triangulation: "
      << (this->BoundingTriangulation ? "On\n" : "Off\n");
+  os << indent << "Parallel Insertion: "
+     << (this->ParallelInsertion ? "On\n" : "Off\n");
 }
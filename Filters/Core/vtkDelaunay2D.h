@@ -96,6 +96,13 @@
  * or non-rigid), care must be taken in constructing constraints when
  * an input transform is used.
  *
+ * Large point sets should be triangulated with ParallelInsertion on. The
+ * points are then inserted in a spatially coherent order into a compact
+ * triangle structure, and inputs of more than a few tens of thousands of
+ * points are split in blocks that are triangulated concurrently with
+ * vtkSMPTools before being stitched together. The Alpha, Tolerance,
+ * BoundingTriangulation and constraint options apply as usual.
+ *
  * @warning
  * Points arranged on a regular lattice (termed degenerate cases) can be
  * triangulated in more than one way (at least according to the Delaunay
@@ -241,6 +248,25 @@ public:
   vtkGetMacro(ProjectionPlaneMode,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls how the points are inserted. If
+   * on, the points are inserted in rounds of increasing size, in the order
+   * of a Hilbert curve within each round, into a compact structure of
+   * triangles and edge neighbors rather than into a vtkPolyData with cell
+   * links. Inputs larger than a few tens of thousands of points are split
+   * in blocks that are triangulated in parallel; the triangles whose
+   * circumcircle lies within a block are kept, and the triangles along the
+   * seams between blocks are computed from the remaining points. As the
+   * insertion order differs, degenerate inputs (e.g. co-circular points)
+   * may be triangulated differently than with serial insertion. By
+   * default, parallel insertion is off.
+   */
+  vtkSetMacro(ParallelInsertion,vtkTypeBool);
+  vtkGetMacro(ParallelInsertion,vtkTypeBool);
+  vtkBooleanMacro(ParallelInsertion,vtkTypeBool);
+  //@}
+
 protected:
   vtkDelaunay2D();
   ~vtkDelaunay2D() override;
@@ -258,6 +284,12 @@ protected:
 
   int ProjectionPlaneMode; //selects the plane in 3D where the Delaunay triangulation will be computed.
 
+  vtkTypeBool ParallelInsertion;
+
+  // The number of blocks triangulated by the last parallel insertion, 0 if
+  // the points were inserted serially.
+  vtkIdType NumberOfBlocks;
+
 private:
   vtkPolyData *Mesh; //the created mesh
   double *Points;    //the raw points in double precision
@@ -281,6 +313,8 @@ private:
   int *RecoverBoundary(vtkPolyData *source);
   int RecoverEdge(vtkPolyData* source, vtkIdType p1, vtkIdType p2);
   void FillPolygons(vtkCellArray *polys, int *triUse);
+  void InsertPointsInParallel(vtkIdType numPoints, double tol,
+                              vtkCellArray *triangles);
 
   int InCircle (double x[3], double x1[3], double x2[3], double x3[3]);
   vtkIdType FindTriangle(double x[3], vtkIdType ptIds[3], vtkIdType tri,
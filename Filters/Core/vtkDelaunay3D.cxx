@@ -851,7 +851,7 @@ vtkUnstructuredGrid *vtkDelaunay3D::InitPointInsertion(double center[3],
 
   Mesh->SetPoints(points);
   points->Delete();
-  Mesh->BuildLinks();
+  Mesh->BuildEditableLinks();
 
   // Keep track of change in references to points
   this->References = new int [numPtsToInsert+6];
@@ -14,18 +14,23 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +38,8 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -60,6 +67,7 @@ vtkGlyph3D::vtkGlyph3D()
   this->FillCellData = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelGlyphing = 0;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
@@ -108,6 +116,557 @@ int vtkGlyph3D::RequestData(
   return this->Execute(input, inputVector[1], output)? 1 : 0;
 }
 
+//----------------------------------------------------------------------------
+namespace {
+// The kind of the cells of a glyph source: 0 for vertices, 1 for lines, 2
+// for polygons and 3 for triangle strips, -1 if it has no cells and -2 if
+// they are of several kinds.
+int GetSourceCellKind(vtkPolyData *source)
+{
+  vtkIdType counts[4] = { source->GetNumberOfVerts(),
+                          source->GetNumberOfLines(),
+                          source->GetNumberOfPolys(),
+                          source->GetNumberOfStrips() };
+  int kind = -1;
+  for (int i = 0; i < 4; ++i)
+  {
+    if (counts[i] > 0)
+    {
+      kind = (kind == -1 ? i : -2);
+    }
+  }
+  return kind;
+}
+}
+
+//----------------------------------------------------------------------------
+// Threaded glyphing. A first pass selects the source of the glyph of each
+// input point, if it is glyphed, and counts the points, cells and
+// connectivity entries of the glyph. Their prefix sums give the place of
+// each glyph in the output, so that a second pass transforms the glyphs and
+// copies their cells and attributes in parallel, in the order of the serial
+// execution.
+struct vtkGlyph3D::SMPGlypher
+{
+  // The points (through the SourceTransform), normals and cells, in the
+  // legacy layout, of a source.
+  struct GlyphSource
+  {
+    vtkPolyData *Source;
+    vtkIdType NumPts;
+    vtkIdType NumCells;
+    std::vector<double> Points;
+    std::vector<double> Normals;
+    vtkIdTypeArray *Cells;
+  };
+
+  // The parameters of the glyph of an input point, the source being -1 if
+  // the point is not glyphed.
+  struct Glyph
+  {
+    int Source;
+    double Scale[3];
+    double Vector[3];
+    double VectorMagnitude;
+  };
+
+  vtkGlyph3D *Self;
+  vtkDataSet *Input;
+  vtkPolyData *Output;
+  vtkIdType NumPts;
+  vtkUniformGrid *InputUG;
+
+  // The input arrays and the output arrays, set up by Execute(). The output
+  // arrays are handed over to the output once the glyphs are generated.
+  vtkDataArray *InSScalars;
+  vtkDataArray *Array3D;
+  vtkDataArray *InCScalars;
+  vtkDataArray *SourceTCoords;
+  vtkPointData *InPD;
+  unsigned char *InGhostLevels;
+  bool HaveVectors;
+  bool HaveNormals;
+  double Den;
+  vtkPoints *NewPts;
+  vtkDataArray *NewScalars;
+  vtkDataArray *NewVectors;
+  vtkDataArray *NewNormals;
+  vtkDataArray *NewTCoords;
+  vtkIdTypeArray *PointIds;
+
+  std::vector<GlyphSource> Sources;
+  int CellKind;
+
+  // The source of the glyph of each input point, then the first output
+  // point, cell and connectivity entry of the glyph.
+  std::vector<int> GlyphSources;
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> CellOffsets;
+  std::vector<vtkIdType> ConnectivityOffsets;
+  vtkNew<vtkIdTypeArray> Connectivity;
+
+  vtkSMPThreadLocalObject<vtkTransform> Transform;
+
+  SMPGlypher(vtkGlyph3D *self, vtkDataSet *input, vtkPolyData *output)
+    : Self(self), Input(input), Output(output), InSScalars(nullptr),
+      Array3D(nullptr), InCScalars(nullptr), SourceTCoords(nullptr),
+      InPD(nullptr), InGhostLevels(nullptr), HaveVectors(false),
+      HaveNormals(false), Den(1.0), NewPts(nullptr), NewScalars(nullptr),
+      NewVectors(nullptr), NewNormals(nullptr), NewTCoords(nullptr),
+      PointIds(nullptr), CellKind(2)
+  {
+    this->NumPts = input->GetNumberOfPoints();
+    this->InputUG = vtkUniformGrid::SafeDownCast(input);
+  }
+
+  // Gather the geometry of a source, in the order of the glyph table.
+  void AddSource(vtkPolyData *source)
+  {
+    GlyphSource glyphSource;
+    glyphSource.Source = source;
+    vtkPoints *sourcePts = source->GetPoints();
+    glyphSource.NumPts = (sourcePts ? sourcePts->GetNumberOfPoints() : 0);
+    glyphSource.NumCells = source->GetNumberOfCells();
+
+    vtkSmartPointer<vtkPoints> points = sourcePts;
+    if (sourcePts && this->Self->SourceTransform)
+    {
+      points = vtkSmartPointer<vtkPoints>::New();
+      points->SetDataTypeToDouble();
+      this->Self->SourceTransform->TransformPoints(sourcePts, points);
+    }
+    glyphSource.Points.resize(3 * glyphSource.NumPts);
+    for (vtkIdType i = 0; i < glyphSource.NumPts; ++i)
+    {
+      points->GetPoint(i, glyphSource.Points.data() + 3 * i);
+    }
+
+    vtkDataArray *sourceNormals = source->GetPointData()->GetNormals();
+    if (this->HaveNormals && sourceNormals)
+    {
+      glyphSource.Normals.resize(3 * glyphSource.NumPts);
+      for (vtkIdType i = 0; i < glyphSource.NumPts; ++i)
+      {
+        sourceNormals->GetTuple(i, glyphSource.Normals.data() + 3 * i);
+      }
+    }
+
+    // The cells are copied from their legacy layout, which GetData() builds
+    // once here rather than from several threads.
+    int kind = GetSourceCellKind(source);
+    if (kind >= 0)
+    {
+      this->CellKind = kind;
+    }
+    vtkCellArray *cells[4] = { source->GetVerts(), source->GetLines(),
+                               source->GetPolys(), source->GetStrips() };
+    glyphSource.Cells = (kind >= 0 ? cells[kind]->GetData() : nullptr);
+    this->Sources.push_back(glyphSource);
+  }
+
+  // Same as the serial execution: the source and the scale of the glyph of
+  // an input point, and its vector.
+  void ComputeGlyph(vtkIdType ptId, Glyph &glyph) const
+  {
+    vtkGlyph3D *self = this->Self;
+    double s = 0.0;
+    double *scale = glyph.Scale;
+    double *v = glyph.Vector;
+    double &vMag = glyph.VectorMagnitude;
+    scale[0] = scale[1] = scale[2] = 1.0;
+    v[0] = v[1] = v[2] = 0.0;
+    vMag = 0.0;
+
+    if ( this->InSScalars )
+    {
+      s = this->InSScalars->GetComponent(ptId, 0);
+      if ( self->ScaleMode == VTK_SCALE_BY_SCALAR ||
+           self->ScaleMode == VTK_DATA_SCALING_OFF )
+      {
+        scale[0] = scale[1] = scale[2] = s;
+      }
+    }
+
+    if ( this->HaveVectors )
+    {
+      this->Array3D->GetTuple(ptId, v);
+      vMag = vtkMath::Norm(v);
+      if ( self->ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
+      {
+        scale[0] = v[0];
+        scale[1] = v[1];
+        scale[2] = v[2];
+      }
+      else if ( self->ScaleMode == VTK_SCALE_BY_VECTOR )
+      {
+        scale[0] = scale[1] = scale[2] = vMag;
+      }
+    }
+
+    if ( self->Clamping )
+    {
+      for (int i = 0; i < 3; ++i)
+      {
+        scale[i] = (scale[i] < self->Range[0] ? self->Range[0] :
+                    (scale[i] > self->Range[1] ? self->Range[1] : scale[i]));
+        scale[i] = (scale[i] - self->Range[0]) / this->Den;
+      }
+    }
+
+    glyph.Source = 0;
+    if ( self->IndexMode != VTK_INDEXING_OFF )
+    {
+      double value = (self->IndexMode == VTK_INDEXING_BY_SCALAR ? s : vMag);
+      int numberOfSources = static_cast<int>(this->Sources.size());
+      int index = static_cast<int>(
+        (value - self->Range[0])*numberOfSources / this->Den);
+      glyph.Source = (index < 0 ? 0 :
+        (index >= numberOfSources ? (numberOfSources-1) : index));
+    }
+
+    if ( (this->InGhostLevels &&
+          this->InGhostLevels[ptId] & vtkDataSetAttributes::DUPLICATEPOINT) ||
+         (this->InputUG && !this->InputUG->IsPointVisible(ptId)) ||
+         !self->IsPointVisible(this->Input, ptId) )
+    {
+      glyph.Source = -1;
+    }
+  }
+
+  struct SelectGlyphs
+  {
+    SMPGlypher *Glypher;
+
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      SMPGlypher *glypher = this->Glypher;
+      Glyph glyph;
+      for ( ; ptId < endPtId; ++ptId)
+      {
+        glypher->ComputeGlyph(ptId, glyph);
+        glypher->GlyphSources[ptId] = glyph.Source;
+        if (glyph.Source < 0)
+        {
+          glypher->PointOffsets[ptId] = 0;
+          glypher->CellOffsets[ptId] = 0;
+          glypher->ConnectivityOffsets[ptId] = 0;
+        }
+        else
+        {
+          const GlyphSource &source = glypher->Sources[glyph.Source];
+          glypher->PointOffsets[ptId] = source.NumPts;
+          glypher->CellOffsets[ptId] = source.NumCells;
+          glypher->ConnectivityOffsets[ptId] =
+            (source.Cells ? source.Cells->GetNumberOfValues() : 0);
+        }
+      }
+    }
+  };
+
+  template <typename T>
+  static void TransformPoints(double matrix[4][4], const double *in, T *out,
+                              vtkIdType n)
+  {
+    for (vtkIdType i = 0; i < n; ++i, in += 3, out += 3)
+    {
+      out[0] = static_cast<T>(matrix[0][0]*in[0] + matrix[0][1]*in[1] +
+                              matrix[0][2]*in[2] + matrix[0][3]);
+      out[1] = static_cast<T>(matrix[1][0]*in[0] + matrix[1][1]*in[1] +
+                              matrix[1][2]*in[2] + matrix[1][3]);
+      out[2] = static_cast<T>(matrix[2][0]*in[0] + matrix[2][1]*in[1] +
+                              matrix[2][2]*in[2] + matrix[2][3]);
+    }
+  }
+
+  struct GenerateGlyphs
+  {
+    SMPGlypher *Glypher;
+
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      SMPGlypher *glypher = this->Glypher;
+      vtkGlyph3D *self = glypher->Self;
+      vtkPointData *outputPD = glypher->Output->GetPointData();
+      vtkCellData *outputCD = glypher->Output->GetCellData();
+      vtkIdType *connectivity = glypher->Connectivity->GetPointer(0);
+      vtkTransform *trans = glypher->Transform.Local();
+      Glyph glyph;
+      double x[3], vNew[3], matrix[4][4];
+      for ( ; ptId < endPtId; ++ptId)
+      {
+        if (glypher->GlyphSources[ptId] < 0)
+        {
+          continue;
+        }
+        glypher->ComputeGlyph(ptId, glyph);
+        const GlyphSource &source = glypher->Sources[glyph.Source];
+        vtkIdType ptIncr = glypher->PointOffsets[ptId];
+        vtkIdType cellIncr = glypher->CellOffsets[ptId];
+        vtkIdType numSourcePts = source.NumPts;
+        double *v = glyph.Vector;
+        double vMag = glyph.VectorMagnitude;
+        double scalex = glyph.Scale[0];
+        double scaley = glyph.Scale[1];
+        double scalez = glyph.Scale[2];
+
+        // Copy the topology, shifted to the points of the glyph.
+        if (source.Cells)
+        {
+          const vtkIdType *cells = source.Cells->GetPointer(0);
+          const vtkIdType *cellsEnd = cells + source.Cells->GetNumberOfValues();
+          vtkIdType *outCells =
+            connectivity + glypher->ConnectivityOffsets[ptId];
+          while (cells < cellsEnd)
+          {
+            vtkIdType npts = *cells++;
+            *outCells++ = npts;
+            for (vtkIdType i = 0; i < npts; ++i)
+            {
+              *outCells++ = *cells++ + ptIncr;
+            }
+          }
+        }
+
+        trans->Identity();
+        glypher->Input->GetPoint(ptId, x);
+        trans->Translate(x[0], x[1], x[2]);
+
+        if ( glypher->HaveVectors )
+        {
+          for (vtkIdType i = 0; i < numSourcePts; i++)
+          {
+            glypher->NewVectors->SetTuple(i+ptIncr, v);
+          }
+          if (self->Orient && (vMag > 0.0))
+          {
+            // if there is no y or z component
+            if ( v[1] == 0.0 && v[2] == 0.0 )
+            {
+              if (v[0] < 0) //just flip x if we need to
+              {
+                trans->RotateWXYZ(180.0,0,1,0);
+              }
+            }
+            else
+            {
+              vNew[0] = (v[0]+vMag) / 2.0;
+              vNew[1] = v[1] / 2.0;
+              vNew[2] = v[2] / 2.0;
+              trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+            }
+          }
+        }
+
+        if (glypher->NewTCoords)
+        {
+          for (vtkIdType i = 0; i < numSourcePts; i++)
+          {
+            glypher->NewTCoords->SetTuple(i+ptIncr, i, glypher->SourceTCoords);
+          }
+        }
+
+        if (glypher->InSScalars && (self->ColorMode == VTK_COLOR_BY_SCALE))
+        {
+          for (vtkIdType i = 0; i < numSourcePts; i++)
+          {
+            glypher->NewScalars->SetTuple(i+ptIncr, &scalex);
+          }
+        }
+        else if (glypher->InCScalars &&
+                 (self->ColorMode == VTK_COLOR_BY_SCALAR))
+        {
+          for (vtkIdType i = 0; i < numSourcePts; i++)
+          {
+            glypher->NewScalars->SetTuple(i+ptIncr, ptId, glypher->InCScalars);
+          }
+        }
+        if (glypher->HaveVectors && self->ColorMode == VTK_COLOR_BY_VECTOR)
+        {
+          for (vtkIdType i = 0; i < numSourcePts; i++)
+          {
+            glypher->NewScalars->SetTuple(i+ptIncr, &vMag);
+          }
+        }
+
+        if ( self->Scaling )
+        {
+          if ( self->ScaleMode == VTK_DATA_SCALING_OFF )
+          {
+            scalex = scaley = scalez = self->ScaleFactor;
+          }
+          else
+          {
+            scalex *= self->ScaleFactor;
+            scaley *= self->ScaleFactor;
+            scalez *= self->ScaleFactor;
+          }
+
+          if ( scalex == 0.0 )
+          {
+            scalex = 1.0e-10;
+          }
+          if ( scaley == 0.0 )
+          {
+            scaley = 1.0e-10;
+          }
+          if ( scalez == 0.0 )
+          {
+            scalez = 1.0e-10;
+          }
+          trans->Scale(scalex,scaley,scalez);
+        }
+
+        // Transform the points, and the normals by the transposed inverse
+        // matrix.
+        vtkMatrix4x4::DeepCopy(*matrix, trans->GetMatrix());
+        vtkDataArray *newPts = glypher->NewPts->GetData();
+        if (newPts->GetDataType() == VTK_DOUBLE)
+        {
+          TransformPoints(matrix, source.Points.data(),
+            static_cast<vtkDoubleArray*>(newPts)->GetPointer(3 * ptIncr),
+            numSourcePts);
+        }
+        else
+        {
+          TransformPoints(matrix, source.Points.data(),
+            static_cast<vtkFloatArray*>(newPts)->GetPointer(3 * ptIncr),
+            numSourcePts);
+        }
+        if ( glypher->HaveNormals )
+        {
+          vtkMatrix4x4::Invert(*matrix, *matrix);
+          vtkMatrix4x4::Transpose(*matrix, *matrix);
+          const double *in = source.Normals.data();
+          float *out = static_cast<vtkFloatArray*>(glypher->NewNormals)->
+            GetPointer(3 * ptIncr);
+          for (vtkIdType i = 0; i < numSourcePts; ++i, in += 3, out += 3)
+          {
+            out[0] = static_cast<float>(
+              matrix[0][0]*in[0] + matrix[0][1]*in[1] + matrix[0][2]*in[2]);
+            out[1] = static_cast<float>(
+              matrix[1][0]*in[0] + matrix[1][1]*in[1] + matrix[1][2]*in[2]);
+            out[2] = static_cast<float>(
+              matrix[2][0]*in[0] + matrix[2][1]*in[1] + matrix[2][2]*in[2]);
+            vtkMath::Normalize(out);
+          }
+        }
+
+        if ( glypher->InPD )
+        {
+          for (vtkIdType i = 0; i < numSourcePts; ++i)
+          {
+            outputPD->CopyData(glypher->InPD, ptId, ptIncr + i);
+          }
+          if (self->FillCellData)
+          {
+            for (vtkIdType i = 0; i < source.NumCells; ++i)
+            {
+              outputCD->CopyData(glypher->InPD, ptId, cellIncr + i);
+            }
+          }
+        }
+
+        if ( glypher->PointIds )
+        {
+          for (vtkIdType i = 0; i < numSourcePts; i++)
+          {
+            glypher->PointIds->SetValue(ptIncr + i, ptId);
+          }
+        }
+      }
+    }
+  };
+
+  void Execute()
+  {
+    this->GlyphSources.resize(this->NumPts);
+    this->PointOffsets.resize(this->NumPts);
+    this->CellOffsets.resize(this->NumPts);
+    this->ConnectivityOffsets.resize(this->NumPts);
+    SelectGlyphs select = { this };
+    vtkSMPTools::For(0, this->NumPts, select);
+
+    vtkIdType numOutPts = vtkSMPTools::ExclusiveScan(
+      this->PointOffsets.begin(), this->PointOffsets.end(),
+      this->PointOffsets.begin(), static_cast<vtkIdType>(0));
+    vtkIdType numOutCells = vtkSMPTools::ExclusiveScan(
+      this->CellOffsets.begin(), this->CellOffsets.end(),
+      this->CellOffsets.begin(), static_cast<vtkIdType>(0));
+    vtkIdType connectivitySize = vtkSMPTools::ExclusiveScan(
+      this->ConnectivityOffsets.begin(), this->ConnectivityOffsets.end(),
+      this->ConnectivityOffsets.begin(), static_cast<vtkIdType>(0));
+    this->Self->UpdateProgress(0.3);
+
+    // Size the output, whose tuples are then set concurrently.
+    this->NewPts->SetNumberOfPoints(numOutPts);
+    this->Output->GetPointData()->SetNumberOfTuples(numOutPts);
+    if (this->InPD && this->Self->FillCellData)
+    {
+      this->Output->GetCellData()->SetNumberOfTuples(numOutCells);
+    }
+    vtkDataArray *newArrays[4] = { this->NewScalars, this->NewVectors,
+                                   this->NewNormals, this->NewTCoords };
+    for (vtkDataArray *array : newArrays)
+    {
+      if (array)
+      {
+        array->SetNumberOfTuples(numOutPts);
+      }
+    }
+    this->Connectivity->SetNumberOfValues(connectivitySize);
+
+    GenerateGlyphs generate = { this };
+    vtkSMPTools::For(0, this->NumPts, generate);
+    this->Self->UpdateProgress(0.9);
+
+    vtkNew<vtkCellArray> cells;
+    cells->SetCells(numOutCells, this->Connectivity);
+    switch (this->CellKind)
+    {
+      case 0:
+        this->Output->SetVerts(cells);
+        break;
+      case 1:
+        this->Output->SetLines(cells);
+        break;
+      case 3:
+        this->Output->SetStrips(cells);
+        break;
+      default:
+        this->Output->SetPolys(cells);
+        break;
+    }
+
+    // Same as the serial execution: hand the new points and arrays over to
+    // the output.
+    vtkPointData *outputPD = this->Output->GetPointData();
+    this->Output->SetPoints(this->NewPts);
+    this->NewPts->Delete();
+    if (this->NewScalars)
+    {
+      int idx = outputPD->AddArray(this->NewScalars);
+      outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+      this->NewScalars->Delete();
+    }
+    if (this->NewVectors)
+    {
+      outputPD->SetVectors(this->NewVectors);
+      this->NewVectors->Delete();
+    }
+    if (this->NewNormals)
+    {
+      outputPD->SetNormals(this->NewNormals);
+      this->NewNormals->Delete();
+    }
+    if (this->NewTCoords)
+    {
+      outputPD->SetTCoords(this->NewTCoords);
+      this->NewTCoords->Delete();
+    }
+    this->Output->Squeeze();
+  }
+};
+
 //----------------------------------------------------------------------------
 bool vtkGlyph3D::Execute(
   vtkDataSet* input,
@@ -414,6 +973,48 @@ bool vtkGlyph3D::Execute(
   transformedSourcePts->SetDataTypeToDouble();
   transformedSourcePts->Allocate(numSourcePts);
 
+  vtkDataArray *array3D = nullptr;
+  if ( haveVectors )
+  {
+    array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
+  }
+  if ( this->ParallelGlyphing &&
+       this->CanGlyphInParallel(input, sourceVector, source, array3D,
+                                inCScalars) )
+  {
+    SMPGlypher glypher(this, input, output);
+    glypher.InSScalars = inSScalars;
+    glypher.Array3D = array3D;
+    glypher.InCScalars = inCScalars;
+    glypher.SourceTCoords = sourceTCoords;
+    glypher.InPD = pd;
+    glypher.InGhostLevels = inGhostLevels;
+    glypher.HaveVectors = (haveVectors != 0);
+    glypher.HaveNormals = (haveNormals != 0);
+    glypher.Den = den;
+    glypher.NewPts = newPts;
+    glypher.NewScalars = newScalars;
+    glypher.NewVectors = newVectors;
+    glypher.NewNormals = newNormals;
+    glypher.NewTCoords = newTCoords;
+    glypher.PointIds = pointIds;
+    if ( this->IndexMode != VTK_INDEXING_OFF )
+    {
+      for (i=0; i < numberOfSources; i++)
+      {
+        glypher.AddSource(this->GetSource(i, sourceVector));
+      }
+    }
+    else
+    {
+      glypher.AddSource(source);
+    }
+    glypher.Execute();
+    trans->Delete();
+    pts->Delete();
+    return true;
+  }
+
   // Traverse all Input points, transforming Source points and copying
   // point attributes.
   //
@@ -741,6 +1342,64 @@ bool vtkGlyph3D::Execute(
   return true;
 }
 
+//----------------------------------------------------------------------------
+// The glyphs are generated in parallel if the cells of the sources are of a
+// single kind, so that the output cells are in the order of the serial
+// execution, and if the input point data can be copied concurrently, which
+// excludes string and bit arrays.
+bool vtkGlyph3D::CanGlyphInParallel(vtkDataSet *input,
+                                    vtkInformationVector *sourceVector,
+                                    vtkPolyData *source,
+                                    vtkDataArray *array3D,
+                                    vtkDataArray *inCScalars)
+{
+  if ( (array3D && array3D->GetNumberOfComponents() > 3) ||
+       (inCScalars && inCScalars->GetDataType() == VTK_BIT) )
+  {
+    return false;
+  }
+
+  int numberOfSources = 1;
+  if ( this->IndexMode != VTK_INDEXING_OFF )
+  {
+    numberOfSources = this->GetNumberOfInputConnections(1);
+  }
+  int cellKind = -1;
+  for (int i = 0; i < numberOfSources; ++i)
+  {
+    vtkPolyData *glyphSource = source;
+    if ( this->IndexMode != VTK_INDEXING_OFF )
+    {
+      glyphSource = this->GetSource(i, sourceVector);
+    }
+    if ( !glyphSource )
+    {
+      return false;
+    }
+    int kind = GetSourceCellKind(glyphSource);
+    if ( kind == -2 || (kind >= 0 && cellKind >= 0 && kind != cellKind) )
+    {
+      return false;
+    }
+    cellKind = (kind >= 0 ? kind : cellKind);
+  }
+
+  if ( this->IndexMode == VTK_INDEXING_OFF )
+  {
+    vtkPointData *pd = input->GetPointData();
+    for (int i = 0; i < pd->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray *array =
+        vtkArrayDownCast<vtkDataArray>(pd->GetAbstractArray(i));
+      if ( !array || array->GetDataType() == VTK_BIT )
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
@@ -891,6 +1550,8 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Parallel Glyphing: "
+     << (this->ParallelGlyphing ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
@@ -318,6 +318,24 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the glyphs are generated
+   * in parallel with vtkSMPTools. If on, the source and the sizes of the
+   * glyph of each input point are computed first, the output is allocated
+   * from their prefix sums, and the glyphs are then transformed and their
+   * cells and attributes copied in parallel. The output is the same as the
+   * serial output. IsPointVisible() is then called from several threads.
+   * Sources whose cells are not all vertices, all lines, all polygons or all
+   * triangle strips (the same for all the sources), indexing with a missing
+   * source, and bit or string input point data use the serial execution. By
+   * default, parallel glyphing is off.
+   */
+  vtkSetMacro(ParallelGlyphing,vtkTypeBool);
+  vtkGetMacro(ParallelGlyphing,vtkTypeBool);
+  vtkBooleanMacro(ParallelGlyphing,vtkTypeBool);
+  //@}
+
 protected:
   vtkGlyph3D();
   ~vtkGlyph3D() override;
@@ -359,6 +377,13 @@ protected:
   char *PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelGlyphing;
+
+  // Threaded glyphing, see vtkGlyph3D.cxx.
+  struct SMPGlypher;
+  bool CanGlyphInParallel(vtkDataSet *input, vtkInformationVector *sourceVector,
+                          vtkPolyData *source, vtkDataArray *array3D,
+                          vtkDataArray *inCScalars);
 
 private:
   vtkGlyph3D(const vtkGlyph3D&) = delete;
@@ -19,14 +19,26 @@
 #include <limits>
 #include <vector>
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStructuredData.h"
+#include "vtkStructuredGrid.h"
 
 #define VTK_EPSILON 1.e-6
 
@@ -148,6 +160,323 @@ vtkIdType Histogram::IndexOfLargestBin()
   return std::max_element(this->Bins.begin(), it2, BinCountCmp)->Index;
 }
 
+//----------------------------------------------------------------------------
+// The points of the cells, which can be gathered concurrently for
+// unstructured grids, polydata whose cells are built, and structured
+// datasets. The points of the cells of structured datasets follow from the
+// dimensions, in the order of vtkDataSet::GetCellPoints().
+struct CellPoints
+{
+  vtkDataSet *Input;
+  bool Structured;
+  bool Hexahedra;
+  int Dimensions[3];
+  int DataDescription;
+
+  CellPoints(vtkDataSet *input)
+    : Input(input), Structured(false), Hexahedra(false), DataDescription(0)
+  {
+    vtkImageData *image = vtkImageData::SafeDownCast(input);
+    vtkRectilinearGrid *rGrid = vtkRectilinearGrid::SafeDownCast(input);
+    vtkStructuredGrid *sGrid = vtkStructuredGrid::SafeDownCast(input);
+    if (image)
+    {
+      image->GetDimensions(this->Dimensions);
+    }
+    else if (rGrid)
+    {
+      rGrid->GetDimensions(this->Dimensions);
+    }
+    else if (sGrid)
+    {
+      sGrid->GetDimensions(this->Dimensions);
+    }
+    this->Structured = (image || rGrid || sGrid);
+    this->Hexahedra = (sGrid != nullptr);
+    if (this->Structured)
+    {
+      this->DataDescription =
+        vtkStructuredData::GetDataDescription(this->Dimensions);
+    }
+  }
+
+  static bool IsThreadSafe(vtkDataSet *input)
+  {
+    return input->IsA("vtkUnstructuredGrid") || input->IsA("vtkPolyData") ||
+      input->IsA("vtkImageData") || input->IsA("vtkRectilinearGrid") ||
+      input->IsA("vtkStructuredGrid");
+  }
+
+  void Get(vtkIdType cellId, vtkIdList *ptIds)
+  {
+    if (!this->Structured)
+    {
+      this->Input->GetCellPoints(cellId, ptIds);
+      return;
+    }
+    vtkStructuredData::GetCellPoints(cellId, ptIds, this->DataDescription,
+                                     this->Dimensions);
+    // The quads and hexahedra of structured grids go around their faces,
+    // where the pixels and voxels are ordered along the axes.
+    vtkIdType npts = ptIds->GetNumberOfIds();
+    if (this->Hexahedra && npts >= 4)
+    {
+      vtkIdType *ids = ptIds->GetPointer(0);
+      std::swap(ids[2], ids[3]);
+      if (npts == 8)
+      {
+        std::swap(ids[6], ids[7]);
+      }
+    }
+  }
+};
+
+// Average the point data of each cell, as vtkDataSetAttributes::
+// InterpolatePoint() does with equal weights.
+template <typename SrcArrayT, typename DstArrayT>
+struct AveragePointData
+{
+  SrcArrayT *Source;
+  DstArrayT *Dest;
+  CellPoints Points;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  AveragePointData(SrcArrayT *src, DstArrayT *dst, const CellPoints &points)
+    : Source(src), Dest(dst), Points(points)
+  {
+  }
+
+  void Initialize()
+  {
+    this->PointIds.Local()->Allocate(8);
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkDataArrayAccessor<SrcArrayT> s(this->Source);
+    vtkDataArrayAccessor<DstArrayT> d(this->Dest);
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType ValueType;
+
+    const int ncomps = this->Source->GetNumberOfComponents();
+    vtkIdList *ptIds = this->PointIds.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->Points.Get(cellId, ptIds);
+      vtkIdType npts = ptIds->GetNumberOfIds();
+      double weight = npts ? 1.0 / npts : 0.0;
+      for (int c = 0; c < ncomps; ++c)
+      {
+        double val = 0.0;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          val += weight * static_cast<double>(s.Get(ptIds->GetId(i), c));
+        }
+        ValueType valT;
+        vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+        d.Set(cellId, c, valT);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+struct AveragePointDataWorker
+{
+  const CellPoints &Points;
+  vtkIdType NumberOfCells;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT *src, DstArrayT *dst)
+  {
+    AveragePointData<SrcArrayT, DstArrayT> average(src, dst, this->Points);
+    vtkSMPTools::For(0, this->NumberOfCells, average);
+  }
+};
+
+// With categorical data, select the point of each cell with the majority
+// value, -1 for the cells without points.
+struct SelectMajorityPoints
+{
+  vtkDataArray *Scalars;
+  CellPoints Points;
+  vtkIdType *Majority;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocal<Histogram> Histograms;
+
+  SelectMajorityPoints(vtkDataArray *scalars, const CellPoints &points,
+                       int maxCellSize, vtkIdType *majority)
+    : Scalars(scalars), Points(points), Majority(majority),
+      Histograms(Histogram(maxCellSize))
+  {
+  }
+
+  void Initialize()
+  {
+    this->PointIds.Local()->Allocate(8);
+  }
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    Histogram &hist = this->Histograms.Local();
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->Points.Get(cellId, ptIds);
+      vtkIdType npts = ptIds->GetNumberOfIds();
+      if (npts == 0)
+      {
+        this->Majority[cellId] = -1;
+        continue;
+      }
+      hist.Reset(npts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType pointId = ptIds->GetId(i);
+        hist.Fill(pointId, this->Scalars->GetComponent(pointId, 0));
+      }
+      this->Majority[cellId] = hist.IndexOfLargestBin();
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Copy the point data of the selected point of each cell.
+template <typename SrcArrayT, typename DstArrayT>
+struct CopyMajorityData
+{
+  SrcArrayT *Source;
+  DstArrayT *Dest;
+  const vtkIdType *Majority;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkDataArrayAccessor<SrcArrayT> s(this->Source);
+    vtkDataArrayAccessor<DstArrayT> d(this->Dest);
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType ValueType;
+
+    const int ncomps = this->Source->GetNumberOfComponents();
+    for (; cellId < endCellId; ++cellId)
+    {
+      vtkIdType pointId = this->Majority[cellId];
+      for (int c = 0; c < ncomps; ++c)
+      {
+        d.Set(cellId, c, pointId < 0 ? ValueType(0) : s.Get(pointId, c));
+      }
+    }
+  }
+};
+
+struct CopyMajorityDataWorker
+{
+  const vtkIdType *Majority;
+  vtkIdType NumberOfCells;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT *src, DstArrayT *dst)
+  {
+    CopyMajorityData<SrcArrayT, DstArrayT> copy = { src, dst, this->Majority };
+    vtkSMPTools::For(0, this->NumberOfCells, copy);
+  }
+};
+
+// Map the point data to the cell data of datasets whose cells can be
+// visited concurrently, the arrays that can be dispatched are processed in
+// parallel and the other ones, such as string arrays, in serial.
+void MapPointDataInParallel(vtkPointDataToCellData *filter, vtkDataSet *input,
+                            vtkDataSet *output, bool categorical)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkPointData *inPD = input->GetPointData();
+  vtkCellData *outCD = output->GetCellData();
+
+  vtkPolyData *pdata = vtkPolyData::SafeDownCast(input);
+  if (pdata && pdata->NeedToBuildCells())
+  {
+    pdata->BuildCells();
+  }
+  CellPoints points(input);
+
+  std::vector<vtkIdType> majority;
+  if (categorical)
+  {
+    majority.resize(numCells);
+    SelectMajorityPoints select(inPD->GetScalars(), points,
+                                input->GetMaxCellSize(), majority.data());
+    vtkSMPTools::For(0, numCells, select);
+  }
+
+  vtkDataSetAttributes::FieldList pfl(1);
+  pfl.InitializeFieldList(inPD);
+  outCD->InterpolateAllocate(pfl, numCells, numCells);
+
+  vtkNew<vtkIdList> cellPts;
+  std::vector<double> weights(input->GetMaxCellSize());
+  for (int fid = 0, nfields = pfl.GetNumberOfFields(); fid < nfields; ++fid)
+  {
+    filter->UpdateProgress(static_cast<double>(fid) / nfields);
+    if (filter->GetAbortExecute())
+    {
+      break;
+    }
+
+    int const dstid = pfl.GetFieldIndex(fid);
+    int const srcid = pfl.GetDSAIndex(0, fid);
+    if (srcid < 0 || dstid < 0)
+    {
+      continue;
+    }
+
+    vtkAbstractArray* const srcarray = inPD->GetAbstractArray(srcid);
+    vtkAbstractArray* const dstarray = outCD->GetAbstractArray(dstid);
+    dstarray->SetNumberOfTuples(numCells);
+
+    vtkDataArray *srcDA = vtkDataArray::FastDownCast(srcarray);
+    vtkDataArray *dstDA = vtkDataArray::FastDownCast(dstarray);
+    bool dispatched = false;
+    if (srcDA && dstDA && categorical)
+    {
+      CopyMajorityDataWorker worker = { majority.data(), numCells };
+      dispatched = vtkArrayDispatch::Dispatch2SameValueType::Execute(
+        srcDA, dstDA, worker);
+    }
+    else if (srcDA && dstDA)
+    {
+      AveragePointDataWorker worker = { points, numCells };
+      dispatched = vtkArrayDispatch::Dispatch2SameValueType::Execute(
+        srcDA, dstDA, worker);
+    }
+    if (dispatched)
+    {
+      continue;
+    }
+
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      if (categorical)
+      {
+        if (majority[cellId] >= 0)
+        {
+          dstarray->SetTuple(cellId, majority[cellId], srcarray);
+        }
+        continue;
+      }
+      points.Get(cellId, cellPts);
+      vtkIdType npts = cellPts->GetNumberOfIds();
+      if (npts > 0)
+      {
+        std::fill_n(weights.begin(), npts, 1.0 / npts);
+        dstarray->InterpolateTuple(cellId, cellPts, srcarray, weights.data());
+      }
+    }
+  }
+}
+
 }
 
 
@@ -232,53 +561,60 @@ int vtkPointDataToCellData::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->GetCellData()->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
 
-  // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
-  // It's weird, but it works.
-  outCD->InterpolateAllocate(inPD,numCells);
-
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  if (CellPoints::IsThreadSafe(input))
   {
-    if ( !(cellId % progressInterval) )
+    MapPointDataInParallel(this, input, output, this->CategoricalData == 1);
+  }
+  else
+  {
+    // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
+    // It's weird, but it works.
+    outCD->InterpolateAllocate(inPD,numCells);
+
+    int abort=0;
+    vtkIdType progressInterval=numCells/20 + 1;
+    for (cellId=0; cellId < numCells && !abort; cellId++)
     {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-    }
+      if ( !(cellId % progressInterval) )
+      {
+        this->UpdateProgress((double)cellId/numCells);
+        abort = GetAbortExecute();
+      }
 
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
+      input->GetCellPoints(cellId, cellPts);
+      numPts = cellPts->GetNumberOfIds();
 
-    if (numPts == 0)
-    {
-      continue;
-    }
+      if (numPts == 0)
+      {
+        continue;
+      }
 
-    // If we aren't dealing with categorical data...
-    if (!(this->CategoricalData))
-    {
-      // ...then we simply provide each point with an equal weight value and
-      // interpolate.
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
+      // If we aren't dealing with categorical data...
+      if (!(this->CategoricalData))
       {
-        weights[ptId] = weight;
+        // ...then we simply provide each point with an equal weight value and
+        // interpolate.
+        weight = 1.0 / numPts;
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          weights[ptId] = weight;
+        }
+        outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
       }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
-    }
-    else
-    {
-      // ...otherwise, we populate a histogram from the scalar values at each
-      // point, and then select the bin with the most elements.
-      hist.Reset(numPts);
-      for (ptId=0; ptId < numPts; ptId++)
+      else
       {
-        pointId = cellPts->GetId(ptId);
-        hist.Fill(pointId,
-                  input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        // ...otherwise, we populate a histogram from the scalar values at each
+        // point, and then select the bin with the most elements.
+        hist.Reset(numPts);
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          pointId = cellPts->GetId(ptId);
+          hist.Fill(pointId,
+                    input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        }
+
+        outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
       }
-
-      outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
     }
   }
 
@@ -22,6 +22,10 @@
  * values of all points defining a particular cell. Optionally, the input point
  * data can be passed through to the output as well.
  *
+ * The cell data of unstructured grids, polydata, image data, rectilinear
+ * and structured grids is computed in parallel with vtkSMPTools, one array
+ * at a time; the other datasets are processed in serial.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
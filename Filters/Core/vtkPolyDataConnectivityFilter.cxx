@@ -17,6 +17,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkConnectivityRegionLabeling.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -31,6 +32,25 @@
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
+namespace
+{
+
+// The cell points of the polydata, straight from its cell arrays.
+struct PolyDataCells
+{
+  vtkPolyData *Mesh;
+  PolyDataCells(vtkPolyData *mesh) : Mesh(mesh) {}
+
+  void GetCellPoints(vtkIdType cellId, vtkIdType &npts, const vtkIdType *&pts)
+  {
+    vtkIdType *cellPts;
+    this->Mesh->GetCellPoints(cellId, npts, cellPts);
+    pts = cellPts;
+  }
+};
+
+}
+
 // Construct with default extraction mode to extract largest regions.
 vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
 {
@@ -57,6 +77,8 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->MarkVisitedPointIds = 0;
   this->VisitedPointIds = vtkIdList::New();
 
+  this->ParallelLabeling = 0;
+
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 }
 
@@ -133,9 +155,20 @@ int vtkPolyDataConnectivityFilter::RequestData(
 
   // Build cell structure
   //
+  const bool labelInParallel = this->ParallelLabeling && !this->InScalars &&
+    this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+    this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
+    this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION;
   this->Mesh = vtkPolyData::New();
   this->Mesh->CopyStructure(input);
-  this->Mesh->BuildLinks();
+  if (labelInParallel)
+  {
+    this->Mesh->BuildCells();
+  }
+  else
+  {
+    this->Mesh->BuildLinks();
+  }
   this->UpdateProgress(0.10);
 
   // Remove all visited point ids
@@ -186,7 +219,20 @@ int vtkPolyDataConnectivityFilter::RequestData(
   this->PointIds = vtkIdList::New();
   this->PointIds->Allocate(8, VTK_CELL_SIZE);
 
-  if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
+  if ( labelInParallel )
+  { //label all cells with their region number in parallel
+    this->LabelAllRegions();
+    for (i=0; i < this->RegionNumber; i++)
+    {
+      if ( this->RegionSizes->GetValue(i) > maxCellsInRegion )
+      {
+        maxCellsInRegion = this->RegionSizes->GetValue(i);
+        largestRegionId = i;
+      }
+    }
+    this->UpdateProgress (0.9);
+  }
+  else if ( this->ExtractionMode != VTK_EXTRACT_POINT_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
@@ -561,6 +607,25 @@ int vtkPolyDataConnectivityFilter::IsScalarConnected( vtkIdType cellId )
   return 0;
 }
 
+// --------------------------------------------------------------------------
+// Label all the regions in parallel, setting the same visited cells, region
+// sizes and region scalars as the traversal of all the cells. The output
+// points keep their input order.
+void vtkPolyDataConnectivityFilter::LabelAllRegions()
+{
+  PolyDataCells cells(this->Mesh);
+  vtkConnectivityRegionLabeling<PolyDataCells> labeling(
+    cells, this->Mesh->GetNumberOfPoints(), this->Mesh->GetNumberOfCells());
+  labeling.CellRegions = this->Visited;
+  labeling.PointMap = this->PointMap;
+  labeling.PointRegions =
+    vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars)->GetPointer(0);
+
+  labeling.Execute(this, this->RegionSizes);
+  this->RegionNumber = labeling.NumberOfRegions;
+  this->PointNumber = labeling.NumberOfPoints;
+}
+
 // --------------------------------------------------------------------------
 // Obtain the number of connected regions.
 int vtkPolyDataConnectivityFilter::GetNumberOfExtractedRegions()
@@ -658,5 +723,7 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
        << id << ": " << this->RegionSizes->GetValue(id) << std::endl;
   }
 
+  os << indent << "Parallel Labeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
 }
@@ -211,6 +211,22 @@ public:
   vtkGetObjectMacro( VisitedPointIds, vtkIdList );
   //@}
 
+  //@{
+  /**
+   * Turn on/off the labeling of the regions in parallel. If on, and all the
+   * cells are visited (all regions, largest region or specified regions
+   * extraction) without ScalarConnectivity, the regions are found with a
+   * lock-free union-find of the points of each cell and numbered with
+   * vtkSMPTools, rather than grown from cell to cell through the point
+   * links, which are then not built. The region ids and sizes are the same,
+   * but the output points keep their input order instead of the order in
+   * which the regions visit them. By default, parallel labeling is off.
+   */
+  vtkSetMacro(ParallelLabeling,vtkTypeBool);
+  vtkGetMacro(ParallelLabeling,vtkTypeBool);
+  vtkBooleanMacro(ParallelLabeling,vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Set/get the desired precision for the output types. See the documentation
@@ -245,6 +261,7 @@ protected:
   double ScalarRange[2];
 
   void TraverseAndMark();
+  void LabelAllRegions();
 
   // used to support algorithm execution
   vtkDataArray *CellScalars;
@@ -265,6 +282,7 @@ protected:
 
   vtkTypeBool MarkVisitedPointIds;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelLabeling;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&) = delete;
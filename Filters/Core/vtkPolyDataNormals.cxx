@@ -26,11 +26,334 @@
 #include "vtkPolygon.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include "vtkNew.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Compute the normal of each polygon of the mesh.
+struct vtkPolyDataNormalsComputePolyNormals
+{
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  float *PolyNormals;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, *pts;
+    double n[3];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Mesh->GetCellPoints(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *polyNormal = this->PolyNormals + 3 * cellId;
+      polyNormal[0] = static_cast<float>(n[0]);
+      polyNormal[1] = static_cast<float>(n[1]);
+      polyNormal[2] = static_cast<float>(n[2]);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Mark the cells around each point with the region they belong to, regions
+// being separated by feature edges. Region numbers are stored for each entry
+// of the point links, and each region but the first one requires a new
+// (split) point.
+struct vtkPolyDataNormalsMarkRegions
+{
+  vtkPolyData *Mesh;
+  const float *PolyNormals;
+  double CosAngle;
+  const vtkIdType *LinkOffsets;
+  int *Regions;
+  vtkIdType *NumberOfSplitPoints;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      this->NumberOfSplitPoints[ptId] =
+        this->MarkRegions(ptId, this->Regions + this->LinkOffsets[ptId],
+                          cellIds) - 1;
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  // Start moving around the "cycle" of points using the point. Label each
+  // subregion of cells connected to this point that are connected (and not
+  // separated by a feature edge) with a given region number. Return the
+  // number of regions.
+  int MarkRegions(vtkIdType ptId, int *regions, vtkIdList *cellIds)
+  {
+    unsigned short ncells;
+    vtkIdType *cells;
+    this->Mesh->GetPointCells(ptId, ncells, cells);
+    std::fill_n(regions, ncells, 0);
+    if ( ncells <= 1 )
+    {
+      return 1; //point does not need to be further disconnected
+    }
+
+    // The links are sorted, so that the region of a cell is found by a
+    // binary search. A cell using the point twice is only marked once.
+    vtkIdType *cellsEnd = cells + ncells;
+    auto region = [&](vtkIdType cellId) -> int&
+    {
+      return regions[std::lower_bound(cells, cellsEnd, cellId) - cells];
+    };
+    int i, j;
+    for (i=0; i<ncells; i++)
+    {
+      regions[i] = -1;
+    }
+
+    // Loop over all cells and mark the region that each is in.
+    //
+    vtkIdType numPts;
+    vtkIdType *pts;
+    int numRegions = 0;
+    vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
+    for (j=0; j<ncells; j++) //for all cells connected to point
+    {
+      if ( region(cells[j]) < 0 ) //for all unvisited cells
+      {
+        region(cells[j]) = numRegions;
+        //okay, mark all the cells connected to this seed cell and using ptId
+        this->Mesh->GetCellPoints(cells[j],numPts,pts);
+
+        //find the two edges
+        for (spot=0; spot < numPts; spot++)
+        {
+          if ( pts[spot] == ptId )
+          {
+            break;
+          }
+        }
+
+        if ( spot == 0 )
+        {
+          neiPt[0] = pts[spot+1];
+          neiPt[1] = pts[numPts-1];
+        }
+        else if ( spot == (numPts-1) )
+        {
+          neiPt[0] = pts[spot-1];
+          neiPt[1] = pts[0];
+        }
+        else
+        {
+          neiPt[0] = pts[spot+1];
+          neiPt[1] = pts[spot-1];
+        }
+
+        for (i=0; i<2; i++) //for each of the two edges of the seed cell
+        {
+          cellId = cells[j];
+          nei = neiPt[i];
+          while ( cellId >= 0 ) //while we can grow this region
+          {
+            this->Mesh->GetCellEdgeNeighbors(cellId,ptId,nei,cellIds);
+            if ( cellIds->GetNumberOfIds() == 1 &&
+                 region((neiCellId=cellIds->GetId(0))) < 0 )
+            {
+              const float *thisNormal = this->PolyNormals + 3 * cellId;
+              const float *neiNormal = this->PolyNormals + 3 * neiCellId;
+              double dot =
+                static_cast<double>(thisNormal[0]) * neiNormal[0] +
+                static_cast<double>(thisNormal[1]) * neiNormal[1] +
+                static_cast<double>(thisNormal[2]) * neiNormal[2];
+
+              if ( dot > this->CosAngle )
+              {
+                //visit and arrange to visit next edge neighbor
+                region(neiCellId) = numRegions;
+                cellId = neiCellId;
+                this->Mesh->GetCellPoints(cellId,numPts,pts);
+
+                for (spot=0; spot < numPts; spot++)
+                {
+                  if ( pts[spot] == ptId )
+                  {
+                    break;
+                  }
+                }
+
+                if (spot == 0)
+                {
+                  nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
+                }
+                else if (spot == (numPts-1))
+                {
+                  nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
+                }
+                else
+                {
+                  nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
+                }
+
+              }//if not separated by edge angle
+              else
+              {
+                cellId = -1; //separated by edge angle
+              }
+            }//if can move to edge neighbor
+            else
+            {
+              cellId = -1;//separated by previous visit, boundary, or non-manifold
+            }
+          }//while visit wave is propagating
+        }//for each of the two edges of the starting cell
+        numRegions++;
+      }//if cell is unvisited
+    }//for all cells connected to point ptId
+
+    // Copy the region of the cells using the point twice to their
+    // second entry.
+    for (j=1; j<ncells; j++)
+    {
+      if (cells[j] == cells[j-1])
+      {
+        regions[j] = regions[j-1];
+      }
+    }
+    return numRegions;
+  }
+};
+
+//----------------------------------------------------------------------------
+// For all cells not in the first region of one of their points, replace the
+// point with a new point, which is a duplicate of the point but disconnected
+// topologically. Each cell is rewritten by a single thread.
+struct vtkPolyDataNormalsSplitCells
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *LinkOffsets;
+  const int *Regions;
+  const vtkIdType *FirstSplitPoints;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfNewPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdType npts, *pts;
+    unsigned short ncells;
+    vtkIdType *cells;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->NewMesh->GetCellPoints(cellId, npts, pts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType ptId = pts[i];
+        vtkIdType nextSplitPoint = (ptId + 1 < this->NumberOfPoints) ?
+          this->FirstSplitPoints[ptId + 1] : this->NumberOfNewPoints;
+        if (nextSplitPoint == this->FirstSplitPoints[ptId])
+        {
+          continue; // the point is not split
+        }
+        this->OldMesh->GetPointCells(ptId, ncells, cells);
+        int region = this->Regions[this->LinkOffsets[ptId] +
+          (std::lower_bound(cells, cells + ncells, cellId) - cells)];
+        if (region > 0)
+        {
+          pts[i] = this->FirstSplitPoints[ptId] + region - 1;
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Accumulate the polygon normals at the points. The normal of a point is the
+// sum of the normals of the cells using it, added in the order of the cells,
+// so the cells using each input point are traversed in order and their normal
+// added to the (possibly split) points standing for it.
+struct vtkPolyDataNormalsAccumulate
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  // Input point of each output point, null when points were not split.
+  const vtkIdType *Map;
+  const float *PolyNormals;
+  float *Normals;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      for (unsigned short j = 0; j < ncells; ++j)
+      {
+        if (j > 0 && cells[j] == cells[j-1])
+        {
+          continue; // the cell uses the point twice, already accumulated
+        }
+        const float *polyNormal = this->PolyNormals + 3 * cells[j];
+        this->NewMesh->GetCellPoints(cells[j], npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          if ((this->Map ? this->Map[pts[i]] : pts[i]) == ptId)
+          {
+            float *normal = this->Normals + 3 * pts[i];
+            normal[0] += polyNormal[0];
+            normal[1] += polyNormal[1];
+            normal[2] += polyNormal[2];
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Normalize the point normals.
+struct vtkPolyDataNormalsNormalize
+{
+  float *Normals;
+  double FlipDirection;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    float *fNormals = this->Normals;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
+                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
+                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
+                                 ) * this->FlipDirection;
+      if (length != 0.0)
+      {
+        fNormals[3 * i] /= length;
+        fNormals[3 * i + 1] /= length;
+        fNormals[3 * i + 2] /= length;
+      }
+    }
+  }
+};
+
+}
+
 // Construct with feature angle=30, splitting and consistency turned on,
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -346,20 +669,13 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
-  {
-    if ((cellId % 1000) == 0)
-    {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
-    }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
-  }
+  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
+  vtkPolyDataNormalsComputePolyNormals polyNormals;
+  polyNormals.Mesh = this->NewMesh;
+  polyNormals.Points = inPts;
+  polyNormals.PolyNormals = fPolyNormals;
+  vtkSMPTools::For(0, numPolys, polyNormals);
+  this->UpdateProgress(0.666);
 
   // Split mesh if sharp features
   if ( this->Splitting )
@@ -372,17 +688,52 @@ int vtkPolyDataNormals::RequestData(
     //  Splitting will create new points.  We have to create index array
     // to map new points into old points.
     //
-    this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i=0; i < numPts; i++)
+    // The regions around the points are marked in parallel, then the new
+    // points are numbered in the order of the points they split.
+    std::vector<vtkIdType> linkOffsets(numPts);
+    vtkIdType numLinks = 0;
+    for (ptId=0; ptId < numPts; ptId++)
     {
-      this->Map->SetId(i,i);
+      unsigned short ncells;
+      vtkIdType *cells;
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      linkOffsets[ptId] = numLinks;
+      numLinks += ncells;
     }
+    std::vector<int> regions(numLinks);
+    std::vector<vtkIdType> firstSplitPoints(numPts);
+
+    vtkPolyDataNormalsMarkRegions markRegions;
+    markRegions.Mesh = this->OldMesh;
+    markRegions.PolyNormals = fPolyNormals;
+    markRegions.CosAngle = this->CosAngle;
+    markRegions.LinkOffsets = linkOffsets.data();
+    markRegions.Regions = regions.data();
+    markRegions.NumberOfSplitPoints = firstSplitPoints.data();
+    vtkSMPTools::For(0, numPts, markRegions);
+    numNewPts = vtkSMPTools::ExclusiveScan(firstSplitPoints.begin(),
+      firstSplitPoints.end(), firstSplitPoints.begin(), numPts);
+
+    vtkPolyDataNormalsSplitCells splitCells;
+    splitCells.OldMesh = this->OldMesh;
+    splitCells.NewMesh = this->NewMesh;
+    splitCells.LinkOffsets = linkOffsets.data();
+    splitCells.Regions = regions.data();
+    splitCells.FirstSplitPoints = firstSplitPoints.data();
+    splitCells.NumberOfPoints = numPts;
+    splitCells.NumberOfNewPoints = numNewPts;
+    vtkSMPTools::For(0, numPolys, splitCells);
 
+    this->Map = vtkIdList::New();
+    this->Map->SetNumberOfIds(numNewPts);
+    vtkIdType *map = this->Map->GetPointer(0);
     for (ptId=0; ptId < numPts; ptId++)
     {
-      this->MarkAndSplit(ptId);
-    }//for all input points
+      map[ptId] = ptId;
+      vtkIdType nextPtId = (ptId + 1 < numPts) ?
+        firstSplitPoints[ptId + 1] : numNewPts;
+      std::fill(map + firstSplitPoints[ptId], map + nextPtId, ptId);
+    }
 
     numNewPts = this->Map->GetNumberOfIds();
 
@@ -424,7 +775,6 @@ int vtkPolyDataNormals::RequestData(
       newPts->SetPoint(ptId,inPts->GetPoint(oldId));
       outPD->CopyData(pd,oldId,ptId);
     }
-    this->Map->Delete();
   } //splitting
 
   else //no splitting, so no new points
@@ -457,34 +807,25 @@ int vtkPolyDataNormals::RequestData(
   float *fNormals = newNormals->WritePointer(0, 3 * numNewPts);
   std::fill_n(fNormals, 3 * numNewPts, 0);
 
-  float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
-
   if (this->ComputePointNormals)
   {
-    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
-         ++cellId)
-    {
-      for (vtkIdType i = 0; i < npts; ++i)
-      {
-        fNormals[3 * pts[i]] += fPolyNormals[3 * cellId];
-        fNormals[3 * pts[i] + 1] += fPolyNormals[3 * cellId + 1];
-        fNormals[3 * pts[i] + 2] += fPolyNormals[3 * cellId + 2];
-      }
-    }
+    vtkPolyDataNormalsAccumulate accumulate;
+    accumulate.OldMesh = this->OldMesh;
+    accumulate.NewMesh = this->NewMesh;
+    accumulate.Map = this->Splitting ? this->Map->GetPointer(0) : nullptr;
+    accumulate.PolyNormals = fPolyNormals;
+    accumulate.Normals = fNormals;
+    vtkSMPTools::For(0, numPts, accumulate);
+
+    vtkPolyDataNormalsNormalize normalize;
+    normalize.Normals = fNormals;
+    normalize.FlipDirection = flipDirection;
+    vtkSMPTools::For(0, numNewPts, normalize);
+  }
 
-    for (vtkIdType i = 0; i < numNewPts; ++i)
-    {
-      const double length = sqrt(fNormals[3 * i] * fNormals[3 * i] +
-                                 fNormals[3 * i + 1] * fNormals[3 * i + 1] +
-                                 fNormals[3 * i + 2] * fNormals[3 * i + 2]
-                                 ) * flipDirection;
-      if (length != 0.0)
-      {
-        fNormals[3 * i] /= length;
-        fNormals[3 * i + 1] /= length;
-        fNormals[3 * i + 2] /= length;
-      }
-    }
+  if ( this->Splitting )
+  {
+    this->Map->Delete();
   }
 
   //  Update ourselves.  If no new nodes have been created (i.e., no
@@ -595,165 +936,6 @@ void vtkPolyDataNormals::TraverseAndOrder (void)
   } //while wave still propagating
 }
 
-//
-//  Mark polygons around vertex.  Create new vertex (if necessary) and
-//  replace (i.e., split mesh).
-//
-void vtkPolyDataNormals::MarkAndSplit (vtkIdType ptId)
-{
-  int i,j;
-
-  // Get the cells using this point and make sure that we have to do something
-  unsigned short ncells;
-  vtkIdType *cells;
-  this->OldMesh->GetPointCells(ptId,ncells,cells);
-  if ( ncells <= 1 )
-  {
-    return; //point does not need to be further disconnected
-  }
-
-  // Start moving around the "cycle" of points using the point. Label
-  // each point as requiring a visit. Then label each subregion of cells
-  // connected to this point that are connected (and not separated by
-  // a feature edge) with a given region number. For each N regions
-  // created, N-1 duplicate (split) points are created. The split point
-  // replaces the current point ptId in the polygons connectivity array.
-  //
-  // Start by initializing the cells as unvisited
-  for (i=0; i<ncells; i++)
-  {
-    this->Visited[cells[i]] = -1;
-  }
-
-  // Loop over all cells and mark the region that each is in.
-  //
-  vtkIdType numPts;
-  vtkIdType *pts;
-  int numRegions = 0;
-  vtkIdType spot, neiPt[2], nei, cellId, neiCellId;
-  double thisNormal[3], neiNormal[3];
-  for (j=0; j<ncells; j++) //for all cells connected to point
-  {
-    if ( this->Visited[cells[j]] < 0 ) //for all unvisited cells
-    {
-      this->Visited[cells[j]] = numRegions;
-      //okay, mark all the cells connected to this seed cell and using ptId
-      this->OldMesh->GetCellPoints(cells[j],numPts,pts);
-
-      //find the two edges
-      for (spot=0; spot < numPts; spot++)
-      {
-        if ( pts[spot] == ptId )
-        {
-          break;
-        }
-      }
-
-      if ( spot == 0 )
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[numPts-1];
-      }
-      else if ( spot == (numPts-1) )
-      {
-        neiPt[0] = pts[spot-1];
-        neiPt[1] = pts[0];
-      }
-      else
-      {
-        neiPt[0] = pts[spot+1];
-        neiPt[1] = pts[spot-1];
-      }
-
-      for (i=0; i<2; i++) //for each of the two edges of the seed cell
-      {
-        cellId = cells[j];
-        nei = neiPt[i];
-        while ( cellId >= 0 ) //while we can grow this region
-        {
-          this->OldMesh->GetCellEdgeNeighbors(cellId,ptId,nei,this->CellIds);
-          if ( this->CellIds->GetNumberOfIds() == 1 &&
-               this->Visited[(neiCellId=this->CellIds->GetId(0))] < 0 )
-          {
-            this->PolyNormals->GetTuple(cellId, thisNormal);
-            this->PolyNormals->GetTuple(neiCellId, neiNormal);
-
-            if ( vtkMath::Dot(thisNormal,neiNormal) > CosAngle )
-            {
-              //visit and arrange to visit next edge neighbor
-              this->Visited[neiCellId] = numRegions;
-              cellId = neiCellId;
-              this->OldMesh->GetCellPoints(cellId,numPts,pts);
-
-              for (spot=0; spot < numPts; spot++)
-              {
-                if ( pts[spot] == ptId )
-                {
-                  break;
-                }
-              }
-
-              if (spot == 0)
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[numPts-1]);
-              }
-              else if (spot == (numPts-1))
-              {
-                nei = (pts[spot-1] != nei ? pts[spot-1] : pts[0]);
-              }
-              else
-              {
-                nei = (pts[spot+1] != nei ? pts[spot+1] : pts[spot-1]);
-              }
-
-            }//if not separated by edge angle
-            else
-            {
-              cellId = -1; //separated by edge angle
-            }
-          }//if can move to edge neighbor
-          else
-          {
-            cellId = -1;//separated by previous visit, boundary, or non-manifold
-          }
-        }//while visit wave is propagating
-      }//for each of the two edges of the starting cell
-      numRegions++;
-    }//if cell is unvisited
-  }//for all cells connected to point ptId
-
-  if ( numRegions <=1 )
-  {
-    return; //a single region, no splitting ever required
-  }
-
-  // Okay, for all cells not in the first region, the ptId is
-  // replaced with a new ptId, which is a duplicate of the first
-  // point, but disconnected topologically.
-  //
-  vtkIdType lastId = this->Map->GetNumberOfIds();
-  vtkIdType replacementPoint;
-  for (j=0; j<ncells; j++)
-  {
-    if (this->Visited[cells[j]] > 0 ) //replace point if splitting needed
-    {
-      replacementPoint = lastId + this->Visited[cells[j]] - 1;
-
-      this->Map->InsertId(replacementPoint, ptId);
-
-      this->NewMesh->GetCellPoints(cells[j],numPts,pts);
-      for (i=0; i < numPts; i++)
-      {
-        if ( pts[i] == ptId )
-        {
-          pts[i] = replacementPoint; // this is very nasty! direct write!
-          break;
-        }
-      }//replace ptId with split point
-    }//if not in first regions and requiring splitting
-  }//for all cells connected to ptId
-}
-
 void vtkPolyDataNormals::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
@@ -37,7 +37,10 @@
  * The algorithm works by determining normals for each polygon and then
  * averaging them at shared points. When sharp edges are present, the edges
  * are split and new points generated to prevent blurry edges (due to
- * Gouraud shading).
+ * Gouraud shading). Only the consistent reordering of the polygons is
+ * serial: the polygon normals, the splitting of the sharp edges and the
+ * point normals are computed in parallel with vtkSMPTools, and match the
+ * serial results exactly.
  *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
@@ -206,11 +209,6 @@ private:
   // checked and properly ordered polygons.
   void TraverseAndOrder(void);
 
-  // Check the point id give to see whether it lies on a feature
-  // edge. If so, split the point (i.e., duplicate it) to topologically
-  // separate the mesh.
-  void MarkAndSplit(vtkIdType ptId);
-
 private:
   vtkPolyDataNormals(const vtkPolyDataNormals&) = delete;
   void operator=(const vtkPolyDataNormals&) = delete;
@@ -24,20 +24,48 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <unordered_map> // sparse bins
 #include <unordered_set> // keep track of inserted triangles
+#include <vector>
 
 vtkStandardNewMacro(vtkQuadricClustering);
 
 //----------------------------------------------------------------------------
-// PIMPLd STL set for keeping track of inserted cells
+// PIMPLd STL set for keeping track of inserted cells. A cell is identified by
+// its sorted bin ids.
+struct vtkQuadricClusteringTriangle {
+  vtkIdType BinIds[3];
+  bool operator==(const vtkQuadricClusteringTriangle &t) const
+  {
+    return this->BinIds[0] == t.BinIds[0] && this->BinIds[1] == t.BinIds[1] &&
+      this->BinIds[2] == t.BinIds[2];
+  }
+};
+struct vtkQuadricClusteringTriangleHash {
+  size_t operator()(const vtkQuadricClusteringTriangle &t) const
+  {
+    size_t h = static_cast<size_t>(t.BinIds[0]);
+    h = h * 31 + static_cast<size_t>(t.BinIds[1]);
+    return h * 31 + static_cast<size_t>(t.BinIds[2]);
+  }
+};
+class vtkQuadricClusteringCellSet : public std::unordered_set<vtkQuadricClusteringTriangle, vtkQuadricClusteringTriangleHash> {};
+typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
+
+//----------------------------------------------------------------------------
+// PIMPLd STL map of the occupied bins, used when UseSparseBins is on
 struct vtkQuadricClusteringIdTypeHash {
   size_t operator()(vtkIdType val) const { return static_cast<size_t>(val); }
 };
-class vtkQuadricClusteringCellSet : public std::unordered_set<vtkIdType, vtkQuadricClusteringIdTypeHash> {};
-typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
+class vtkQuadricClusteringBinMap : public std::unordered_map<vtkIdType,
+  vtkQuadricClustering::PointQuadric, vtkQuadricClusteringIdTypeHash> {};
 
 
 //----------------------------------------------------------------------------
@@ -89,6 +117,19 @@ vtkQuadricClustering::vtkQuadricClustering()
 
   this->InCellCount = this->OutCellCount = 0;
   this->CopyCellData = 0;
+
+  this->UseSparseBins = 0;
+  this->BinMap = nullptr;
+
+  this->NumberOfStreamDivisions = 1;
+  this->StreamPass = 0;
+  this->StreamNumberOfPoints = 0;
+  for (int i = 0; i < 6; ++i)
+  {
+    this->StreamBounds[i] = 0.0;
+  }
+
+  this->ParallelClustering = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -102,6 +143,8 @@ vtkQuadricClustering::~vtkQuadricClustering()
   this->CellSet = nullptr;
   delete [] this->QuadricArray;
   this->QuadricArray = nullptr;
+  delete this->BinMap;
+  this->BinMap = nullptr;
   if (this->OutputTriangleArray)
   {
     this->OutputTriangleArray->Delete();
@@ -116,7 +159,7 @@ vtkQuadricClustering::~vtkQuadricClustering()
 
 //----------------------------------------------------------------------------
 int vtkQuadricClustering::RequestData(
-  vtkInformation *vtkNotUsed(request),
+  vtkInformation *request,
   vtkInformationVector **inputVector,
   vtkInformationVector *outputVector)
 {
@@ -136,6 +179,12 @@ int vtkQuadricClustering::RequestData(
 
   vtkTimerLog *tlog=nullptr;
 
+  if (input && this->NumberOfStreamDivisions > 1)
+  {
+    // The input is one of the pieces streamed by the filter.
+    return this->StreamPiece(request, input);
+  }
+
   if (!input || (input->GetNumberOfPoints() == 0))
   {
     // The user may be calling StartAppend, Append, and EndAppend explicitly.
@@ -154,34 +203,7 @@ int vtkQuadricClustering::RequestData(
     tlog->StartTimer();
   }
 
-  // Lets limit the number of divisions based on
-  // the number of points in the input.
-  // (To minimize chance of overflow, force math in vtkIdType type,
-  // which is sometimes bigger than int, and never smaller.)
-  vtkIdType target = input->GetNumberOfPoints();
-  vtkIdType numDiv = static_cast<vtkIdType>(this->NumberOfXDivisions)
-                        * this->NumberOfYDivisions
-                        * this->NumberOfZDivisions
-                        / 2;
-  if (this->AutoAdjustNumberOfDivisions && numDiv > target)
-  {
-    double factor = pow(((double)numDiv/(double)target),0.33333);
-    this->NumberOfDivisions[0] =
-      (int)(0.5+(double)(this->NumberOfXDivisions)/factor);
-    this->NumberOfDivisions[0] = (this->NumberOfDivisions[0] > 0 ? this->NumberOfDivisions[0] : 1);
-    this->NumberOfDivisions[1] =
-      (int)(0.5+(double)(this->NumberOfYDivisions)/factor);
-    this->NumberOfDivisions[1] = (this->NumberOfDivisions[1] > 0 ? this->NumberOfDivisions[1] : 1);
-    this->NumberOfDivisions[2] =
-      (int)(0.5+(double)(this->NumberOfZDivisions)/factor);
-    this->NumberOfDivisions[2] = (this->NumberOfDivisions[2] > 0 ? this->NumberOfDivisions[2] : 1);
-  }
-  else
-  {
-    this->NumberOfDivisions[0] = this->NumberOfXDivisions;
-    this->NumberOfDivisions[1] = this->NumberOfYDivisions;
-    this->NumberOfDivisions[2] = this->NumberOfZDivisions;
-  }
+  this->InitializeNumberOfDivisions(input->GetNumberOfPoints());
 
   this->UpdateProgress(.01);
 
@@ -207,6 +229,8 @@ int vtkQuadricClustering::RequestData(
   // Free up some memory.
   delete [] this->QuadricArray;
   this->QuadricArray = nullptr;
+  delete this->BinMap;
+  this->BinMap = nullptr;
 
   if ( this->Debug )
   {
@@ -218,6 +242,144 @@ int vtkQuadricClustering::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkQuadricClustering::RequestUpdateExtent(
+  vtkInformation *vtkNotUsed(request),
+  vtkInformationVector **inputVector,
+  vtkInformationVector *outputVector)
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  if (!inInfo || this->NumberOfStreamDivisions <= 1)
+  {
+    return 1;
+  }
+
+  // Request the piece of the current pass, see StreamPiece().
+  int outPiece = outInfo->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+  int outNumPieces = outInfo->Get(
+    vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+  int numDivisions = this->NumberOfStreamDivisions;
+
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+              outPiece * numDivisions + this->StreamPass % numDivisions);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+              outNumPieces * numDivisions);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// The filter executes twice per piece: the passes of the first round gather
+// the bounds and the number of points of the input, which set up the bins,
+// and the passes of the second round append the pieces to the bins.
+int vtkQuadricClustering::StreamPiece(vtkInformation *request,
+                                      vtkPolyData *piece)
+{
+  int numDivisions = this->NumberOfStreamDivisions;
+
+  if (this->StreamPass == 0)
+  {
+    this->StreamBounds[0] = this->StreamBounds[2] = this->StreamBounds[4] =
+      VTK_DOUBLE_MAX;
+    this->StreamBounds[1] = this->StreamBounds[3] = this->StreamBounds[5] =
+      -VTK_DOUBLE_MAX;
+    this->StreamNumberOfPoints = 0;
+  }
+
+  if (this->StreamPass < numDivisions)
+  {
+    if (piece->GetNumberOfPoints() > 0)
+    {
+      double bounds[6];
+      piece->GetBounds(bounds);
+      for (int i = 0; i < 3; ++i)
+      {
+        this->StreamBounds[2*i] = std::min(this->StreamBounds[2*i],
+                                           bounds[2*i]);
+        this->StreamBounds[2*i+1] = std::max(this->StreamBounds[2*i+1],
+                                             bounds[2*i+1]);
+      }
+      this->StreamNumberOfPoints += piece->GetNumberOfPoints();
+    }
+
+    if (this->StreamPass == numDivisions - 1)
+    {
+      if (this->StreamNumberOfPoints == 0)
+      {
+        // Nothing to decimate.
+        request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+        this->StreamPass = 0;
+        return 1;
+      }
+      this->InitializeNumberOfDivisions(this->StreamNumberOfPoints);
+      this->StartAppend(this->StreamBounds);
+      this->SliceSize = this->NumberOfDivisions[0]*this->NumberOfDivisions[1];
+    }
+  }
+  else if (piece->GetNumberOfPoints() > 0 && !piece->CheckAttributes())
+  {
+    // The cell data are copied from each piece in turn.
+    this->InCellCount = 0;
+    this->Append(piece);
+  }
+
+  this->StreamPass++;
+  if (this->StreamPass < 2 * numDivisions && !this->GetAbortExecute())
+  {
+    // There is still more to do.
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+    this->UpdateProgress(0.8 * this->StreamPass / (2.0 * numDivisions));
+    return 1;
+  }
+
+  // We are done.  Finish up.
+  request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+  this->StreamPass = 0;
+  this->EndAppend();
+
+  delete [] this->QuadricArray;
+  this->QuadricArray = nullptr;
+  delete this->BinMap;
+  this->BinMap = nullptr;
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricClustering::InitializeNumberOfDivisions(vtkIdType numPts)
+{
+  // Lets limit the number of divisions based on
+  // the number of points in the input.
+  // (To minimize chance of overflow, force math in vtkIdType type,
+  // which is sometimes bigger than int, and never smaller.)
+  vtkIdType target = numPts;
+  vtkIdType numDiv = static_cast<vtkIdType>(this->NumberOfXDivisions)
+                        * this->NumberOfYDivisions
+                        * this->NumberOfZDivisions
+                        / 2;
+  if (this->AutoAdjustNumberOfDivisions && numDiv > target)
+  {
+    double factor = pow(((double)numDiv/(double)target),0.33333);
+    this->NumberOfDivisions[0] =
+      (int)(0.5+(double)(this->NumberOfXDivisions)/factor);
+    this->NumberOfDivisions[0] = (this->NumberOfDivisions[0] > 0 ? this->NumberOfDivisions[0] : 1);
+    this->NumberOfDivisions[1] =
+      (int)(0.5+(double)(this->NumberOfYDivisions)/factor);
+    this->NumberOfDivisions[1] = (this->NumberOfDivisions[1] > 0 ? this->NumberOfDivisions[1] : 1);
+    this->NumberOfDivisions[2] =
+      (int)(0.5+(double)(this->NumberOfZDivisions)/factor);
+    this->NumberOfDivisions[2] = (this->NumberOfDivisions[2] > 0 ? this->NumberOfDivisions[2] : 1);
+  }
+  else
+  {
+    this->NumberOfDivisions[0] = this->NumberOfXDivisions;
+    this->NumberOfDivisions[1] = this->NumberOfYDivisions;
+    this->NumberOfDivisions[2] = this->NumberOfZDivisions;
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::StartAppend(double *bounds)
 {
@@ -293,14 +455,24 @@ void vtkQuadricClustering::StartAppend(double *bounds)
 
   this->NumberOfBinsUsed = 0;
   delete [] this->QuadricArray;
-  this->QuadricArray =
-    new vtkQuadricClustering::PointQuadric[this->NumberOfDivisions[0] *
-                                          this->NumberOfDivisions[1] *
-                                          this->NumberOfDivisions[2]];
-  if (this->QuadricArray == nullptr)
+  this->QuadricArray = nullptr;
+  delete this->BinMap;
+  this->BinMap = nullptr;
+  if (this->UseSparseBins)
   {
-    vtkErrorMacro("Could not allocate quadric grid.");
-    return;
+    this->BinMap = new vtkQuadricClusteringBinMap;
+  }
+  else
+  {
+    this->QuadricArray =
+      new vtkQuadricClustering::PointQuadric[this->NumberOfDivisions[0] *
+                                            this->NumberOfDivisions[1] *
+                                            this->NumberOfDivisions[2]];
+    if (this->QuadricArray == nullptr)
+    {
+      vtkErrorMacro("Could not allocate quadric grid.");
+      return;
+    }
   }
 
   vtkInformation *inInfo = this->GetExecutive()->GetInputInformation(0, 0);
@@ -369,11 +541,247 @@ void vtkQuadricClustering::Append(vtkPolyData *pd)
   }
 }
 
+//----------------------------------------------------------------------------
+// Clustering with vtkSMPTools. The polygons are located and split into
+// triangles serially, then the triangles are hashed into the bins and their
+// quadrics summed into per-thread maps of bins in parallel. The per-thread
+// sums are added to the bins, and the triangles are added to the output in
+// the order of the polygons, so the output cells are the same as the serial
+// ones. The representative points of the bins are also computed in parallel.
+struct vtkQuadricClustering::SMPClusterer
+{
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+  const vtkIdType *Connectivity;
+  std::vector<vtkIdType> CellLocations;
+  std::vector<vtkIdType> TriangleOffsets;
+  std::vector<vtkIdType> TriangleBins;
+  vtkSMPThreadLocal<vtkQuadricClusteringBinMap> LocalBins;
+
+  SMPClusterer(vtkQuadricClustering *self, vtkCellArray *polys,
+               vtkPoints *points) :
+    Self(self), Points(points), Connectivity(polys->GetPointer())
+  {
+    vtkIdType numCells = polys->GetNumberOfCells();
+    this->CellLocations.resize(numCells);
+    this->TriangleOffsets.resize(numCells + 1);
+    this->TriangleOffsets[0] = 0;
+    vtkIdType loc = 0;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      vtkIdType npts = this->Connectivity[loc];
+      this->CellLocations[cellId] = loc;
+      this->TriangleOffsets[cellId + 1] =
+        this->TriangleOffsets[cellId] + (npts > 2 ? npts - 2 : 0);
+      loc += npts + 1;
+    }
+    this->TriangleBins.resize(3 * this->TriangleOffsets[numCells]);
+  }
+
+  // Whether the triangle is left out with UseInternalTriangles off.
+  bool IsSkipped(const vtkIdType *binIds) const
+  {
+    return !this->Self->UseInternalTriangles &&
+      (binIds[0] == binIds[1] || binIds[0] == binIds[2] ||
+       binIds[1] == binIds[2]);
+  }
+
+  // Hash the triangles of the polygons into the bins and sum their quadrics
+  // per thread, see AddTriangle().
+  struct HashTriangles
+  {
+    SMPClusterer *Clusterer;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPClusterer *clu = this->Clusterer;
+      vtkQuadricClustering *self = clu->Self;
+      vtkQuadricClusteringBinMap &bins = clu->LocalBins.Local();
+      double pts[3][3], quadric4x4[4][4];
+
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType *ptIds =
+          clu->Connectivity + clu->CellLocations[cellId] + 1;
+        vtkIdType numTris =
+          clu->TriangleOffsets[cellId + 1] - clu->TriangleOffsets[cellId];
+        vtkIdType *binIds =
+          clu->TriangleBins.data() + 3 * clu->TriangleOffsets[cellId];
+        if (numTris == 0)
+        {
+          continue;
+        }
+        clu->Points->GetPoint(ptIds[0], pts[0]);
+        vtkIdType binId = self->HashPoint(pts[0]);
+        for (vtkIdType j = 0; j < numTris; ++j, binIds += 3)
+        {
+          clu->Points->GetPoint(ptIds[j+1], pts[1]);
+          clu->Points->GetPoint(ptIds[j+2], pts[2]);
+          binIds[0] = binId;
+          binIds[1] = self->HashPoint(pts[1]);
+          binIds[2] = self->HashPoint(pts[2]);
+          if (clu->IsSkipped(binIds))
+          {
+            continue;
+          }
+
+          vtkTriangle::ComputeQuadric(pts[0], pts[1], pts[2], quadric4x4);
+          for (int i = 0; i < 3; ++i)
+          {
+            PointQuadric &bin = bins[binIds[i]];
+            if (bin.Dimension > 2)
+            {
+              bin.Dimension = 2;
+              self->InitializeQuadric(bin.Quadric);
+            }
+            bin.Quadric[0] += quadric4x4[0][0];
+            bin.Quadric[1] += quadric4x4[0][1];
+            bin.Quadric[2] += quadric4x4[0][2];
+            bin.Quadric[3] += quadric4x4[0][3];
+            bin.Quadric[4] += quadric4x4[1][1];
+            bin.Quadric[5] += quadric4x4[1][2];
+            bin.Quadric[6] += quadric4x4[1][3];
+            bin.Quadric[7] += quadric4x4[2][2];
+            bin.Quadric[8] += quadric4x4[2][3];
+          }
+        }
+      }
+    }
+  };
+
+  void AddPolygons(int geometryFlag, vtkPolyData *input, vtkPolyData *output)
+  {
+    vtkQuadricClustering *self = this->Self;
+    vtkIdType numCells = static_cast<vtkIdType>(this->CellLocations.size());
+    HashTriangles hash = { this };
+    vtkSMPTools::For(0, numCells, hash);
+
+    // Add the per-thread quadrics to the bins. Points and segments
+    // supersede triangles.
+    vtkSMPThreadLocal<vtkQuadricClusteringBinMap>::iterator bins;
+    for (bins = this->LocalBins.begin(); bins != this->LocalBins.end(); ++bins)
+    {
+      vtkQuadricClusteringBinMap::iterator it;
+      for (it = bins->begin(); it != bins->end(); ++it)
+      {
+        PointQuadric *bin = self->GetBin(it->first);
+        if (bin->Dimension > 2)
+        {
+          bin->Dimension = 2;
+          self->InitializeQuadric(bin->Quadric);
+        }
+        if (bin->Dimension == 2)
+        {
+          self->AddQuadric(it->first, it->second.Quadric);
+        }
+      }
+      vtkQuadricClusteringBinMap().swap(*bins);
+    }
+
+    // Add the triangles to the output in order.
+    double step = numCells / 10.0;
+    if (step < 1000.0)
+    {
+      step = 1000.0;
+    }
+    double cstep = step;
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      if (geometryFlag)
+      {
+        vtkIdType *binIds =
+          this->TriangleBins.data() + 3 * this->TriangleOffsets[cellId];
+        vtkIdType *binIdsEnd =
+          this->TriangleBins.data() + 3 * this->TriangleOffsets[cellId + 1];
+        for (; binIds != binIdsEnd; binIds += 3)
+        {
+          if (!this->IsSkipped(binIds))
+          {
+            self->AddTriangleGeometry(binIds, input, output);
+          }
+        }
+      }
+      ++self->InCellCount;
+      if (cellId > cstep)
+      {
+        self->UpdateProgress(.6 + .2 * cellId / numCells);
+        cstep += step;
+      }
+    }
+  }
+
+  // Compute the representative points of the used bins, see EndAppend().
+  struct ComputePoints
+  {
+    vtkQuadricClustering *Self;
+    const std::vector<vtkIdType> *BinIds;
+    const std::vector<PointQuadric *> *Bins;
+    vtkPoints *OutputPoints;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      double x[3];
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        PointQuadric *bin = (*this->Bins)[i];
+        this->Self->ComputeRepresentativePoint(bin->Quadric,
+                                               (*this->BinIds)[i], x);
+        this->OutputPoints->SetPoint(bin->VertexId, x);
+      }
+    }
+  };
+
+  static void ComputeRepresentativePoints(vtkQuadricClustering *self,
+                                          vtkPoints *outputPoints)
+  {
+    std::vector<vtkIdType> binIds;
+    std::vector<PointQuadric *> bins;
+    binIds.reserve(self->NumberOfBinsUsed);
+    bins.reserve(self->NumberOfBinsUsed);
+    if (self->BinMap)
+    {
+      vtkQuadricClusteringBinMap::iterator it;
+      for (it = self->BinMap->begin(); it != self->BinMap->end(); ++it)
+      {
+        if (it->second.VertexId != -1)
+        {
+          binIds.push_back(it->first);
+          bins.push_back(&it->second);
+        }
+      }
+    }
+    else
+    {
+      vtkIdType numBins = static_cast<vtkIdType>(self->NumberOfDivisions[0]) *
+        self->NumberOfDivisions[1] * self->NumberOfDivisions[2];
+      for (vtkIdType binId = 0; binId < numBins; ++binId)
+      {
+        if (self->QuadricArray[binId].VertexId != -1)
+        {
+          binIds.push_back(binId);
+          bins.push_back(self->QuadricArray + binId);
+        }
+      }
+    }
+
+    outputPoints->SetNumberOfPoints(self->NumberOfBinsUsed);
+    ComputePoints compute = { self, &binIds, &bins, outputPoints };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(binIds.size()), compute);
+  }
+};
+
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::AddPolygons(vtkCellArray *polys, vtkPoints *points,
                                        int geometryFlag,
                                        vtkPolyData *input, vtkPolyData *output)
 {
+  if (this->ParallelClustering)
+  {
+    SMPClusterer clusterer(this, polys, points);
+    clusterer.AddPolygons(geometryFlag, input, output);
+    return;
+  }
+
   vtkIdType *ptIds = nullptr;
   vtkIdType numPts = 0;
   double pts0[3], pts1[3], pts2[3];
@@ -497,14 +905,15 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
   // Add the quadric to each of the three corner bins.
   for (int i = 0; i < 3; ++i)
   {
+    PointQuadric *bin = this->GetBin(binIds[i]);
     // If the current quadric is not initialized, then clear it out.
-    if (this->QuadricArray[binIds[i]].Dimension > 2)
+    if (bin->Dimension > 2)
     {
-      this->QuadricArray[binIds[i]].Dimension = 2;
+      bin->Dimension = 2;
       // Initialize the coeff
-      this->InitializeQuadric(this->QuadricArray[binIds[i]].Quadric);
+      this->InitializeQuadric(bin->Quadric);
     }
-    if (this->QuadricArray[binIds[i]].Dimension == 2)
+    if (bin->Dimension == 2)
     { // Points and segments supersede triangles.
       this->AddQuadric(binIds[i], quadric);
     }
@@ -512,82 +921,42 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
 
   if (geometryFlag)
   {
-    vtkIdType triPtIds[3];
-    // Now add the triangle to the geometry.
-    for (int i = 0; i < 3; i++)
+    this->AddTriangleGeometry(binIds, input, output);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Add the triangle whose corners are in the bins binIds to the output,
+// unless two of its corners are in the same bin.
+void vtkQuadricClustering::AddTriangleGeometry(vtkIdType *binIds,
+                                               vtkPolyData *input,
+                                               vtkPolyData *output)
+{
+  vtkIdType triPtIds[3];
+  // Now add the triangle to the geometry.
+  for (int i = 0; i < 3; i++)
+  {
+    // Get the vertex from each bin.
+    PointQuadric *bin = this->GetBin(binIds[i]);
+    if (bin->VertexId == -1)
     {
-      // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
-      {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
-        this->NumberOfBinsUsed++;
-      }
-      triPtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      bin->VertexId = this->NumberOfBinsUsed;
+      this->NumberOfBinsUsed++;
     }
-    // This comparison could just as well be on triPtIds.
-    if (binIds[0] != binIds[1] && binIds[0] != binIds[2] &&
-        binIds[1] != binIds[2])
+    triPtIds[i] = bin->VertexId;
+  }
+  // This comparison could just as well be on triPtIds.
+  if (binIds[0] != binIds[1] && binIds[0] != binIds[2] &&
+      binIds[1] != binIds[2])
+  {
+    if ( this->PreventDuplicateCells )
     {
-      if ( this->PreventDuplicateCells )
-      {
-        vtkIdType minIdx = ( binIds[0]<binIds[1] ? (binIds[0]<binIds[2] ? 0 : 2) :
-                             (binIds[1]<binIds[2] ? 1 : 2) );
-        vtkIdType midIdx = 0;
-        vtkIdType maxIdx = 0;
-        switch ( minIdx )
-        {
-          case 0:
-            if ( binIds[1] > binIds[2] )
-            {
-              maxIdx = 1;
-              midIdx = 2;
-            }
-            else
-            {
-              maxIdx = 2;
-              midIdx = 1;
-            }
-            break;
-          case 1:
-            if ( binIds[0] > binIds[2] )
-            {
-              maxIdx = 0;
-              midIdx = 2;
-            }
-            else
-            {
-              maxIdx = 2;
-              midIdx = 0;
-            }
-            break;
-          case 2:
-            if ( binIds[0] > binIds[1] )
-            {
-              maxIdx = 0;
-              midIdx = 1;
-            }
-            else
-            {
-              maxIdx = 1;
-              midIdx = 0;
-            }
-            break;
-        }
-        // TODO: this arithmetic overflows with the TestQuadricLODActor test.
-        vtkIdType idx = binIds[minIdx] + this->NumberOfBins*binIds[midIdx] +
-                        this->NumberOfBins*this->NumberOfBins*binIds[maxIdx];
-        if ( this->CellSet->find(idx) == this->CellSet->end() )
-        {
-          this->CellSet->insert(idx);
-          this->OutputTriangleArray->InsertNextCell(3, triPtIds);
-          if (this->CopyCellData && input)
-          {
-            output->GetCellData()->
-              CopyData(input->GetCellData(), this->InCellCount,this->OutCellCount++);
-          }//if cell data
-        }//if not a duplicate
-      }
-      else //don't check for duplicates
+      vtkQuadricClusteringTriangle triangle;
+      triangle.BinIds[0] = binIds[0];
+      triangle.BinIds[1] = binIds[1];
+      triangle.BinIds[2] = binIds[2];
+      std::sort(triangle.BinIds, triangle.BinIds + 3);
+      if ( this->CellSet->insert(triangle).second )
       {
         this->OutputTriangleArray->InsertNextCell(3, triPtIds);
         if (this->CopyCellData && input)
@@ -595,9 +964,18 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
           output->GetCellData()->
             CopyData(input->GetCellData(), this->InCellCount,this->OutCellCount++);
         }//if cell data
-      }//don't check for duplicates
-    }//if not duplicate vertices
-  }//if this should be inserted
+      }//if not a duplicate
+    }
+    else //don't check for duplicates
+    {
+      this->OutputTriangleArray->InsertNextCell(3, triPtIds);
+      if (this->CopyCellData && input)
+      {
+        output->GetCellData()->
+          CopyData(input->GetCellData(), this->InCellCount,this->OutCellCount++);
+      }//if cell data
+    }//don't check for duplicates
+  }//if not duplicate vertices
 }
 
 //----------------------------------------------------------------------------
@@ -704,14 +1082,15 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
 
   for (int i = 0; i < 2; ++i)
   {
+    PointQuadric *bin = this->GetBin(binIds[i]);
     // If the current quadric is from triangles (or not initialized), then clear it out.
-    if (this->QuadricArray[binIds[i]].Dimension > 1)
+    if (bin->Dimension > 1)
     {
-      this->QuadricArray[binIds[i]].Dimension = 1;
+      bin->Dimension = 1;
       // Initialize the coeff
-      this->InitializeQuadric(this->QuadricArray[binIds[i]].Quadric);
+      this->InitializeQuadric(bin->Quadric);
     }
-    if (this->QuadricArray[binIds[i]].Dimension == 1)
+    if (bin->Dimension == 1)
     { // Points supersede segments.
       this->AddQuadric(binIds[i], q);
     }
@@ -723,12 +1102,13 @@ void vtkQuadricClustering::AddEdge(vtkIdType *binIds, double *pt0, double *pt1,
     for (int i = 0; i < 2; i++)
     {
       // Get the vertex from each bin.
-      if (this->QuadricArray[binIds[i]].VertexId == -1)
+      PointQuadric *bin = this->GetBin(binIds[i]);
+      if (bin->VertexId == -1)
       {
-        this->QuadricArray[binIds[i]].VertexId = this->NumberOfBinsUsed;
+        bin->VertexId = this->NumberOfBinsUsed;
         this->NumberOfBinsUsed++;
       }
-      edgePtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+      edgePtIds[i] = bin->VertexId;
     }
     // This comparison could just as well be on edgePtIds.
     if (binIds[0] != binIds[1])
@@ -822,13 +1202,14 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
 
   // If the current quadric is from triangles, edges (or not initialized),
   // then clear it out.
-  if (this->QuadricArray[binId].Dimension > 0)
+  PointQuadric *bin = this->GetBin(binId);
+  if (bin->Dimension > 0)
   {
-    this->QuadricArray[binId].Dimension = 0;
+    bin->Dimension = 0;
     // Initialize the coeff
-    this->InitializeQuadric(this->QuadricArray[binId].Quadric);
+    this->InitializeQuadric(bin->Quadric);
   }
-  if (this->QuadricArray[binId].Dimension == 0)
+  if (bin->Dimension == 0)
   { // Points supersede all other types of quadrics.
     this->AddQuadric(binId, q);
   }
@@ -837,9 +1218,9 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
   {
     // Now add the vert to the geometry.
     // Get the vertex from the bin.
-    if (this->QuadricArray[binId].VertexId == -1)
+    if (bin->VertexId == -1)
     {
-      this->QuadricArray[binId].VertexId = this->NumberOfBinsUsed;
+      bin->VertexId = this->NumberOfBinsUsed;
       this->NumberOfBinsUsed++;
 
       if (this->CopyCellData && input)
@@ -855,7 +1236,7 @@ void vtkQuadricClustering::AddVertex(vtkIdType binId, double *pt,
 //----------------------------------------------------------------------------
 void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
 {
-  double *q = this->QuadricArray[binId].Quadric;
+  double *q = this->GetBin(binId)->Quadric;
 
   for (int i=0; i<9; i++)
   {
@@ -863,6 +1244,29 @@ void vtkQuadricClustering::AddQuadric(vtkIdType binId, double quadric[9])
   }
 }
 
+//----------------------------------------------------------------------------
+vtkQuadricClustering::PointQuadric *vtkQuadricClustering::GetBin(
+  vtkIdType binId)
+{
+  if (this->BinMap)
+  {
+    return &(*this->BinMap)[binId];
+  }
+  return this->QuadricArray + binId;
+}
+
+//----------------------------------------------------------------------------
+vtkQuadricClustering::PointQuadric *vtkQuadricClustering::FindBin(
+  vtkIdType binId)
+{
+  if (this->BinMap)
+  {
+    vtkQuadricClusteringBinMap::iterator it = this->BinMap->find(binId);
+    return it == this->BinMap->end() ? nullptr : &it->second;
+  }
+  return this->QuadricArray + binId;
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkQuadricClustering::HashPoint(double point[3])
 {
@@ -949,21 +1353,52 @@ void vtkQuadricClustering::EndAppend()
 
   // Compute the representative points for each bin
   outputPoints = vtkPoints::New();
-  for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++ )
+  if (this->ParallelClustering)
+  {
+    SMPClusterer::ComputeRepresentativePoints(this, outputPoints);
+  }
+  else if (this->BinMap)
   {
-    if (cstep > step)
+    vtkIdType i = 0;
+    vtkQuadricClusteringBinMap::iterator it;
+    numBuckets = static_cast<vtkIdType>(this->BinMap->size());
+    for (it = this->BinMap->begin();
+         !abortExecute && it != this->BinMap->end(); ++it, ++i)
     {
-      cstep = 0;
-      vtkDebugMacro(<<"Finding point in bin #" << i);
-      this->UpdateProgress (0.8+0.2*i/numBuckets);
-      abortExecute = this->GetAbortExecute();
-    }
-    ++cstep;
+      if (cstep > step)
+      {
+        cstep = 0;
+        vtkDebugMacro(<<"Finding point in bin #" << it->first);
+        this->UpdateProgress (0.8+0.2*i/numBuckets);
+        abortExecute = this->GetAbortExecute();
+      }
+      ++cstep;
 
-    if (this->QuadricArray[i].VertexId != -1)
+      if (it->second.VertexId != -1)
+      {
+        this->ComputeRepresentativePoint(it->second.Quadric, it->first, newPt);
+        outputPoints->InsertPoint(it->second.VertexId, newPt);
+      }
+    }
+  }
+  else
+  {
+    for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++ )
     {
-      this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
-      outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
+      if (cstep > step)
+      {
+        cstep = 0;
+        vtkDebugMacro(<<"Finding point in bin #" << i);
+        this->UpdateProgress (0.8+0.2*i/numBuckets);
+        abortExecute = this->GetAbortExecute();
+      }
+      ++cstep;
+
+      if (this->QuadricArray[i].VertexId != -1)
+      {
+        this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
+        outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
+      }
     }
   }
 
@@ -985,7 +1420,11 @@ void vtkQuadricClustering::EndAppend()
   this->OutputLines->Delete();
   this->OutputLines = nullptr;
 
-  this->EndAppendVertexGeometry(input, output);
+  // The vertex cells of the streamed pieces are not kept.
+  if (input && this->NumberOfStreamDivisions <= 1)
+  {
+    this->EndAppendVertexGeometry(input, output);
+  }
 
   // Tell the data it is up to date
   // (in case the user calls this method directly).
@@ -994,6 +1433,8 @@ void vtkQuadricClustering::EndAppend()
   // Free the quadric array.
   delete [] this->QuadricArray;
   this->QuadricArray = nullptr;
+  delete this->BinMap;
+  this->BinMap = nullptr;
 }
 
 
@@ -1270,9 +1711,9 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
   output->GetPointData()->
     CopyAllocate(input->GetPointData(), this->NumberOfBinsUsed);
 
-  // Allocate and initialize an array to hold errors for each bin.
-  numBins = this->NumberOfDivisions[0] * this->NumberOfDivisions[1]
-                  * this->NumberOfDivisions[2];
+  // Allocate and initialize an array to hold errors for each used bin
+  // (indexed by the output point of the bin).
+  numBins = this->NumberOfBinsUsed;
   minError = new double[numBins];
   for (vtkIdType i = 0; i < numBins; ++i)
   {
@@ -1285,7 +1726,8 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
   {
     inputPoints->GetPoint(i, pt);
     binId = this->HashPoint(pt);
-    outPtId = this->QuadricArray[binId].VertexId;
+    PointQuadric *bin = this->FindBin(binId);
+    outPtId = bin ? bin->VertexId : -1;
     // Sanity check.
     if (outPtId == -1)
     {
@@ -1298,13 +1740,13 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
     // Compute the error for this point.  Note: the constant term is ignored.
     // It will be the same for every point in this bin, and it
     // is not stored in the quadric array anyway.
-    q = this->QuadricArray[binId].Quadric;
+    q = bin->Quadric;
     e = q[0]*pt[0]*pt[0] + 2.0*q[1]*pt[0]*pt[1] + 2.0*q[2]*pt[0]*pt[2] + 2.0*q[3]*pt[0]
           + q[4]*pt[1]*pt[1] + 2.0*q[5]*pt[1]*pt[2] + 2.0*q[6]*pt[1]
           + q[7]*pt[2]*pt[2] + 2.0*q[8]*pt[2];
-    if (e < minError[binId])
+    if (e < minError[outPtId])
     {
-      minError[binId] = e;
+      minError[outPtId] = e;
       outputPoints->InsertPoint(outPtId, pt);
 
       // Since this is the same point as the input point, copy point data here too.
@@ -1329,6 +1771,8 @@ void vtkQuadricClustering::EndAppendUsingPoints(vtkPolyData *input,
 
   delete [] this->QuadricArray;
   this->QuadricArray = nullptr;
+  delete this->BinMap;
+  this->BinMap = nullptr;
 
   delete [] minError;
 }
@@ -1365,11 +1809,12 @@ void vtkQuadricClustering::EndAppendVertexGeometry(vtkPolyData *input,
     {
       input->GetPoint(ptIds[j], pt);
       binId = this->HashPoint(pt);
-      outPtId = this->QuadricArray[binId].VertexId;
+      PointQuadric *bin = this->FindBin(binId);
+      outPtId = bin ? bin->VertexId : -1;
       if (outPtId >= 0)
       {
         // Do not use this point.  Destroy infomration in Quadric array.
-        this->QuadricArray[binId].VertexId = -1;
+        bin->VertexId = -1;
         tmp[tmpIdx] = outPtId;
         ++tmpIdx;
       }
@@ -1581,5 +2026,11 @@ void vtkQuadricClustering::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Prevent Duplicate Cells : "
      << (this->PreventDuplicateCells ? "On\n" : "Off\n");
+  os << indent << "Number Of Stream Divisions: "
+     << this->NumberOfStreamDivisions << endl;
+  os << indent << "Use Sparse Bins: "
+     << (this->UseSparseBins ? "On\n" : "Off\n");
+  os << indent << "Parallel Clustering: "
+     << (this->ParallelClustering ? "On\n" : "Off\n");
 }
 
@@ -59,6 +59,15 @@
  * manual control, it has the advantage that extremely large data can be
  * processed in pieces and appended to the filter piece-by-piece.
  *
+ * The filter can also drive the streaming itself: when
+ * NumberOfStreamDivisions is larger than one, it requests the pieces of its
+ * input one at a time from the upstream pipeline and appends them, so that
+ * only one piece of the input is in memory at once. Combined with
+ * UseSparseBins, which keeps the quadrics of the occupied bins only, and
+ * ParallelClustering, which accumulates the quadrics with vtkSMPTools, this
+ * allows surfaces much larger than the available memory to be decimated
+ * with fine binnings.
+ *
  * @warning
  * This filter can drastically affect topology, i.e., topology is not
  * preserved.
@@ -91,6 +100,7 @@
 class vtkCellArray;
 class vtkFeatureEdges;
 class vtkPoints;
+class vtkQuadricClusteringBinMap;
 class vtkQuadricClusteringCellSet;
 
 
@@ -255,13 +265,70 @@ public:
   vtkBooleanMacro(PreventDuplicateCells,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get the number of pieces the input is streamed in. When larger than
+   * one, each execution of the filter requests the pieces of its input one
+   * at a time through the streaming demand driven pipeline: a first round of
+   * requests finds the bounds and the number of points of the whole input,
+   * and a second round appends the pieces to the bins. The upstream pipeline
+   * thus executes twice for each piece, but only one piece is in memory at a
+   * time. UseInputPoints and UseFeatureEdges are ignored when streaming, and
+   * the vertex cells of the input are not passed to the output. The default
+   * is 1 (no streaming).
+   */
+  vtkSetClampMacro(NumberOfStreamDivisions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfStreamDivisions, int);
+  //@}
+
+  //@{
+  /**
+   * When this flag is on, the quadrics are kept in a hash of the bins that
+   * the input goes through instead of an array of all the bins, so that the
+   * memory used grows with the number of occupied bins rather than with the
+   * number of divisions. Use it with large numbers of divisions, where most
+   * bins are empty. The default is off.
+   */
+  vtkSetMacro(UseSparseBins, vtkTypeBool);
+  vtkGetMacro(UseSparseBins, vtkTypeBool);
+  vtkBooleanMacro(UseSparseBins, vtkTypeBool);
+  //@}
+
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the bins are accumulated
+   * in parallel with vtkSMPTools. If on, the polygons are split into
+   * triangles, hashed into the bins and their quadrics summed per thread in
+   * parallel, the per-thread quadrics are then added to the bins, and the
+   * representative points of the bins are computed in parallel. The output
+   * cells are the same as the serial ones, and the points only differ by
+   * the rounding of the quadric sums. Triangle strips, lines and vertices
+   * are accumulated serially. By default, parallel clustering is off.
+   */
+  vtkSetMacro(ParallelClustering, vtkTypeBool);
+  vtkGetMacro(ParallelClustering, vtkTypeBool);
+  vtkBooleanMacro(ParallelClustering, vtkTypeBool);
+  //@}
+
 protected:
   vtkQuadricClustering();
   ~vtkQuadricClustering() override;
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
+  int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int FillInputPortInformation(int, vtkInformation *) override;
 
+  /**
+   * Limit the number of divisions to the number of input points when
+   * AutoAdjustNumberOfDivisions is on.
+   */
+  void InitializeNumberOfDivisions(vtkIdType numPts);
+
+  /**
+   * Process one piece of the streamed input, see NumberOfStreamDivisions.
+   */
+  int StreamPiece(vtkInformation *request, vtkPolyData *piece);
+
   /**
    * Given a point, determine what bin it falls into.
    */
@@ -284,6 +351,8 @@ protected:
                  vtkPolyData *input, vtkPolyData *output);
   void AddTriangle(vtkIdType *binIds, double *pt0, double *pt1, double *pt2,
                    int geometeryFlag, vtkPolyData *input, vtkPolyData *output);
+  void AddTriangleGeometry(vtkIdType *binIds, vtkPolyData *input,
+                           vtkPolyData *output);
   //@}
 
   //@{
@@ -394,6 +463,31 @@ protected:
   PointQuadric* QuadricArray;
   vtkIdType NumberOfBinsUsed;
 
+  // The bins when UseSparseBins is on.
+  vtkTypeBool UseSparseBins;
+  vtkQuadricClusteringBinMap *BinMap; //PIMPLd stl map of the occupied bins
+  friend class vtkQuadricClusteringBinMap;
+
+  //@{
+  /**
+   * Return the bin binId, creating it if needed. FindBin() returns nullptr
+   * instead when the bin has not been created.
+   */
+  PointQuadric *GetBin(vtkIdType binId);
+  PointQuadric *FindBin(vtkIdType binId);
+  //@}
+
+  // Streaming state, see NumberOfStreamDivisions.
+  int NumberOfStreamDivisions;
+  int StreamPass;
+  double StreamBounds[6];
+  vtkIdType StreamNumberOfPoints;
+
+  vtkTypeBool ParallelClustering;
+
+  // Threaded clustering, see vtkQuadricClustering.cxx.
+  struct SMPClusterer;
+
   // Have to make these instance variables if we are going to allow
   // the algorithm to be driven by the Append methods.
   vtkCellArray *OutputTriangleArray;
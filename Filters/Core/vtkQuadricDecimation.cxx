@@ -53,10 +53,165 @@
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Compute the cost of collapsing the edge (pt1Id,pt2Id) whose summed quadric
+// is quad, and the point x giving this cost, from the geometric part of the
+// quadric. See ComputeCost().
+double vtkQD_ComputeCost(const double *quad, vtkPoints *points,
+                         vtkIdType pt1Id, vtkIdType pt2Id, double *x)
+{
+  static const double errorNumber = 1e-10;
+  double temp[3], A[3][3], b[3];
+  double cost = 0.0;
+  const double *index;
+  int i, j;
+  double newPoint [4];
+  double v[3],  c, norm, normTemp,  temp2[3];
+  double pt1[3], pt2[3];
+
+  A[0][0] = quad[0];
+  A[0][1] = A[1][0] = quad[1];
+  A[0][2] = A[2][0] = quad[2];
+  A[1][1] = quad[4];
+  A[1][2] = A[2][1] = quad[5];
+  A[2][2] = quad[7];
+
+  b[0] = -quad[3];
+  b[1] = -quad[6];
+  b[2] = -quad[8];
+
+  norm = vtkMath::Norm(A[0]);
+  normTemp = vtkMath::Norm(A[1]);
+  norm = norm > normTemp ? norm : normTemp;
+  normTemp = vtkMath::Norm(A[2]);
+  norm = norm > normTemp ? norm : normTemp;
+
+  if (fabs(vtkMath::Determinant3x3(A))/(norm*norm*norm) >  errorNumber)
+  {
+    // it would be better to use the normal of the matrix to test singularity??
+    vtkMath::LinearSolve3x3(A, b, x);
+    vtkMath::Multiply3x3(A,x,temp);
+    // error too high, backup plans
+  }
+  else
+  {
+    // cheapest point along the edge
+    points->GetPoint(pt1Id, pt1);
+    points->GetPoint(pt2Id, pt2);
+    v[0] = pt2[0] - pt1[0];
+    v[1] = pt2[1] - pt1[1];
+    v[2] = pt2[2] - pt1[2];
+
+    // equation for the edge pt1 + c * v
+    // attempt least squares fit for c for A*(pt1 + c * v) = b
+    vtkMath::Multiply3x3(A,v,temp2);
+    if (vtkMath::Dot(temp2, temp2) > errorNumber)
+    {
+      vtkMath::Multiply3x3(A,pt1,temp);
+      for (i = 0; i < 3; i++)
+        temp[i] = b[i] - temp[i];
+      c = vtkMath::Dot(temp2, temp) / vtkMath::Dot(temp2, temp2);
+      for (i = 0; i < 3; i++)
+        x[i] = pt1[i]+c*v[i];
+    }
+    else
+    {
+      // use mid point
+      // might want to change to best of mid and end points??
+      for (i = 0; i < 3; i++)
+      {
+        x[i] = 0.5*(pt1[i]+pt2[i]);
+      }
+    }
+  }
+
+  newPoint[0] = x[0];
+  newPoint[1] = x[1];
+  newPoint[2] = x[2];
+  newPoint[3] = 1;
+
+  // Compute the cost
+  // x'*quad*x
+  index = quad;
+  for (i = 0; i < 4; i++)
+  {
+    cost += (*index++)*newPoint[i]*newPoint[i];
+    for (j = i +1; j < 4; j++)
+    {
+      cost += 2.0*(*index++)*newPoint[i]*newPoint[j];
+    }
+  }
+
+  return cost;
+}
+
+//----------------------------------------------------------------------------
+// Collapse the edge (pt0Id,pt1Id) of the mesh onto pt0Id, using cellIds as
+// work space; return the number of triangles deleted. See CollapseEdge().
+int vtkQD_CollapseEdge(vtkPolyData *mesh, vtkIdList *cellIds,
+                       vtkIdType pt0Id, vtkIdType pt1Id)
+{
+  int j, numDeleted=0;
+  vtkIdType i, npts, *pts, cellId;
+
+  mesh->GetPointCells(pt0Id, cellIds);
+  for (i = 0; i < cellIds->GetNumberOfIds(); i++)
+  {
+    cellId = cellIds->GetId(i);
+    mesh->GetCellPoints(cellId, npts, pts);
+    for (j = 0; j < 3; j++)
+    {
+      if (pts[j] == pt1Id)
+      {
+        mesh->RemoveCellReference(cellId);
+        mesh->DeleteCell(cellId);
+        numDeleted++;
+      }
+    }
+  }
+
+  mesh->GetPointCells(pt1Id, cellIds);
+  mesh->ResizeCellList(pt0Id, cellIds->GetNumberOfIds());
+  for (i=0; i < cellIds->GetNumberOfIds(); i++)
+  {
+    cellId = cellIds->GetId(i);
+    mesh->GetCellPoints(cellId, npts, pts);
+    // making sure we don't already have the triangle we're about to
+    // change this one to
+    if ((pts[0] == pt1Id && mesh->IsTriangle(pt0Id, pts[1], pts[2])) ||
+        (pts[1] == pt1Id && mesh->IsTriangle(pts[0], pt0Id, pts[2])) ||
+        (pts[2] == pt1Id && mesh->IsTriangle(pts[0], pts[1], pt0Id)))
+    {
+      mesh->RemoveCellReference(cellId);
+      mesh->DeleteCell(cellId);
+      numDeleted++;
+    }
+    else
+    {
+      mesh->AddReferenceToCell(pt0Id, cellId);
+      mesh->ReplaceCellPoint(cellId, pt1Id, pt0Id);
+    }
+  }
+  mesh->DeletePoint(pt1Id);
+
+  return numDeleted;
+}
+
+}// namespace
+
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
@@ -75,6 +230,7 @@ vtkQuadricDecimation::vtkQuadricDecimation()
 
   this->AttributeErrorMetric = 0;
   this->VolumePreservation = 0;
+  this->ParallelDecimation = 0;
   this->ScalarsAttribute = 1;
   this->VectorsAttribute = 1;
   this->NormalsAttribute = 1;
@@ -171,6 +327,764 @@ void vtkQuadricDecimation::GetPointAttributeArray(vtkIdType ptId, double *x)
   }
 }
 
+//----------------------------------------------------------------------------
+// Decimate the mesh with vtkSMPTools, using the geometric error only. The
+// quadrics of the points are computed in parallel, then each point finds the
+// cheapest of its edges whose collapse passes the placement check. The edges
+// are collapsed in rounds: a round selects the edges that are the cheapest
+// edge of both their end points, cheaper than the edges of all the points
+// within two edges of their end points, and not costlier than a threshold
+// sampled from the costs so that the remaining reduction is approached from
+// the cheapest edges. Selected edges thus have disjoint neighborhoods (their
+// end points and the points around them) and are collapsed concurrently with
+// the operations of CollapseEdge(). Only the points within two edges of a
+// collapse then look for their cheapest edge again.
+struct vtkQuadricDecimation::SMPDecimator
+{
+  // An edge collapse, ordered by cost then by end points. The first end
+  // point, the smaller id, is kept.
+  struct Collapse
+  {
+    double Cost;
+    vtkIdType PtIds[2];
+    vtkIdType NumTris; // the number of triangles using the edge
+
+    bool operator<(const Collapse &other) const
+    {
+      return SMPDecimator::IsCheaper(this->Cost, this->PtIds[0], this->PtIds[1],
+                                     other.Cost, other.PtIds[0], other.PtIds[1]);
+    }
+  };
+
+  // A candidate collapse of the edge from a point to one of its neighbors.
+  struct Candidate
+  {
+    double Cost;
+    vtkIdType PtIds[2]; // sorted
+    double X[3];
+
+    bool operator<(const Candidate &other) const
+    {
+      return SMPDecimator::IsCheaper(this->Cost, this->PtIds[0], this->PtIds[1],
+                                     other.Cost, other.PtIds[0], other.PtIds[1]);
+    }
+  };
+
+  vtkQuadricDecimation *Self;
+  vtkPolyData *Mesh;
+  vtkPoints *Points;
+  vtkIdType NumPts;
+  vtkIdType NumTris;
+
+  // The geometric part (10 coefficients) of the quadric of each point.
+  std::vector<double> Quadrics;
+
+  // The cheapest edge of each point: its cost, its other end point (-1 if
+  // the point has no edge that can be collapsed) and the collapse point.
+  std::vector<double> Costs;
+  std::vector<vtkIdType> Partners;
+  std::vector<double> Targets;
+
+  // The points whose cheapest edge is (re)computed, the collapses of the
+  // current round and the number of triangles each deleted.
+  std::vector<vtkIdType> Dirty;
+  std::vector<Collapse> Collapses;
+  std::vector<vtkIdType> NumDeleted;
+  double Threshold;
+
+  // The candidate edges of the current round, by their smaller end point,
+  // whether they are still available, and the round in which each point was
+  // last taken by the neighborhood of a selected edge.
+  std::vector<vtkIdType> Candidates;
+  std::vector<char> Available;
+  std::vector<int> Taken;
+  int Round;
+
+  // The round in which each point was last kept by a collapse.
+  std::vector<int> Kept;
+
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> LocalIds;
+  vtkSMPThreadLocal<std::vector<vtkIdType>> LocalDirty;
+  vtkSMPThreadLocal<std::vector<Candidate>> LocalCandidates;
+  vtkSMPThreadLocal<std::vector<Collapse>> LocalCollapses;
+
+  SMPDecimator(vtkQuadricDecimation *self, vtkIdType numTris) :
+    Self(self), Mesh(self->Mesh), Points(self->Mesh->GetPoints()),
+    NumPts(self->Mesh->GetNumberOfPoints()), NumTris(numTris),
+    Threshold(VTK_DOUBLE_MAX), Round(0)
+  {
+  }
+
+  static bool IsCheaper(double cost0, vtkIdType pt00, vtkIdType pt01,
+                        double cost1, vtkIdType pt10, vtkIdType pt11)
+  {
+    return cost0 < cost1 ||
+      (cost0 == cost1 && (pt00 < pt10 || (pt00 == pt10 && pt01 < pt11)));
+  }
+
+  // Whether the cheapest edge of point ptId is the cheapest edge of its other
+  // end point too, and not costlier than the threshold.
+  bool IsCandidate(vtkIdType ptId) const
+  {
+    vtkIdType partner = this->Partners[ptId];
+    return partner >= 0 && this->Partners[partner] == ptId &&
+      this->Costs[ptId] <= this->Threshold;
+  }
+
+  // Whether the cheapest edge of point ptId is an available candidate
+  // cheaper than the edge (pt0Id,pt1Id), pt0Id < pt1Id, of the given cost.
+  bool IsCheaperCandidate(vtkIdType ptId, double cost, vtkIdType pt0Id,
+                          vtkIdType pt1Id) const
+  {
+    if (!this->IsCandidate(ptId))
+    {
+      return false;
+    }
+    vtkIdType partner = this->Partners[ptId];
+    if (!this->Available[std::min(ptId, partner)])
+    {
+      return false;
+    }
+    return SMPDecimator::IsCheaper(this->Costs[ptId], std::min(ptId, partner),
+                                   std::max(ptId, partner), cost, pt0Id, pt1Id);
+  }
+
+  // Add the plane (n,d), weighted by w, to the quadric q as
+  // InitializeQuadrics() and AddBoundaryConstraints() do.
+  static void AddPlane(const double n[3], double d, double w, double *q)
+  {
+    q[0] += n[0] * n[0] * w;
+    q[1] += n[0] * n[1] * w;
+    q[2] += n[0] * n[2] * w;
+    q[3] += d * n[0] * w;
+
+    q[4] += n[1] * n[1] * w;
+    q[5] += n[1] * n[2] * w;
+    q[6] += d * n[1] * w;
+
+    q[7] += n[2] * n[2] * w;
+    q[8] += d * n[2] * w;
+
+    q[9] += d * d * w;
+  }
+
+  // Gather the quadric of each point from the planes of its triangles, then
+  // from the planes of its boundary edges. The cells are visited in the
+  // order of the serial traversals.
+  struct ComputeQuadrics
+  {
+    SMPDecimator *Decimator;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkPolyData *mesh = this->Decimator->Mesh;
+      vtkIdList *neighbors = this->Decimator->CellIds.Local();
+      unsigned short ncells, c;
+      vtkIdType *cells, npts, *pts;
+      double t0[3], t1[3], t2[3], e0[3], e1[3], n[3], d, w, c0;
+      int i, j;
+
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        double *q = this->Decimator->Quadrics.data() + 10 * ptId;
+        std::fill(q, q + 10, 0.0);
+        mesh->GetPointCells(ptId, ncells, cells);
+
+        for (c = 0; c < ncells; ++c)
+        {
+          mesh->GetCellPoints(cells[c], npts, pts);
+          mesh->GetPoint(pts[0], t0);
+          mesh->GetPoint(pts[1], t1);
+          mesh->GetPoint(pts[2], t2);
+          for (j = 0; j < 3; j++)
+          {
+            e0[j] = t1[j] - t0[j];
+            e1[j] = t2[j] - t0[j];
+          }
+          vtkMath::Cross(e0, e1, n);
+          w = vtkMath::Normalize(n) * 0.5;
+          d = -vtkMath::Dot(n, t0);
+          SMPDecimator::AddPlane(n, d, w, q);
+        }
+
+        for (c = 0; c < ncells; ++c)
+        {
+          mesh->GetCellPoints(cells[c], npts, pts);
+          for (i = 0; i < 3; i++)
+          {
+            if (pts[i] != ptId && pts[(i+1)%3] != ptId)
+            {
+              continue;
+            }
+            mesh->GetCellEdgeNeighbors(cells[c], pts[i], pts[(i+1)%3],
+                                       neighbors);
+            if (neighbors->GetNumberOfIds() == 0)
+            {
+              // the plane orthogonal to the boundary edge, see
+              // AddBoundaryConstraints()
+              mesh->GetPoint(pts[(i+2)%3], t0);
+              mesh->GetPoint(pts[i], t1);
+              mesh->GetPoint(pts[(i+1)%3], t2);
+              for (j = 0; j < 3; j++)
+              {
+                e0[j] = t2[j] - t1[j];
+                e1[j] = t0[j] - t1[j];
+              }
+              c0 = vtkMath::Dot(e0,e1)/(e0[0]*e0[0]+e0[1]*e0[1]+e0[2]*e0[2]);
+              for (j = 0; j < 3; j++)
+              {
+                n[j] = e1[j] - c0*e0[j];
+              }
+              vtkMath::Normalize(n);
+              d = -vtkMath::Dot(n, t1);
+              w = vtkMath::Norm(e0);
+              SMPDecimator::AddPlane(n, d, w, q);
+            }
+          }
+        }
+      }
+    }
+  };
+
+  // Compute the cost and the collapse point of the edge (ptId,neighbor).
+  void ComputeCandidate(vtkIdType ptId, vtkIdType neighbor,
+                        Candidate &candidate) const
+  {
+    double quad[10];
+    candidate.PtIds[0] = std::min(ptId, neighbor);
+    candidate.PtIds[1] = std::max(ptId, neighbor);
+    const double *q0 = this->Quadrics.data() + 10 * candidate.PtIds[0];
+    const double *q1 = this->Quadrics.data() + 10 * candidate.PtIds[1];
+    for (int k = 0; k < 10; ++k)
+    {
+      quad[k] = q0[k] + q1[k];
+    }
+    candidate.Cost = vtkQD_ComputeCost(quad, this->Points,
+      candidate.PtIds[0], candidate.PtIds[1], candidate.X);
+  }
+
+  void SetCheapestEdge(vtkIdType ptId, const Candidate &candidate)
+  {
+    this->Costs[ptId] = candidate.Cost;
+    this->Partners[ptId] = (candidate.PtIds[0] == ptId ?
+                            candidate.PtIds[1] : candidate.PtIds[0]);
+    std::copy(candidate.X, candidate.X + 3, this->Targets.data() + 3 * ptId);
+  }
+
+  // Update the cheapest edge of point ptId after a round of collapses,
+  // return false if it must be looked for again among all the edges. The
+  // cost of an edge only changes when one of its end points is kept by a
+  // collapse. So, if the cheapest edge is unchanged and its placement still
+  // passes the check, only the edges ending at kept points may be cheaper.
+  bool UpdateCheapestEdge(vtkIdType ptId, std::vector<vtkIdType> &neighbors,
+                          Candidate &candidate)
+  {
+    vtkIdType partner = this->Partners[ptId];
+    if (partner < 0 || this->Partners[partner] < 0 ||
+        this->Kept[ptId] == this->Round || this->Kept[partner] == this->Round)
+    {
+      return false;
+    }
+    if (!this->Self->IsGoodPlacement(std::min(ptId, partner),
+          std::max(ptId, partner), this->Targets.data() + 3 * ptId))
+    {
+      return false;
+    }
+
+    this->GetNeighbors(ptId, neighbors);
+    for (vtkIdType neighbor : neighbors)
+    {
+      if (this->Kept[neighbor] != this->Round)
+      {
+        continue;
+      }
+      this->ComputeCandidate(ptId, neighbor, candidate);
+      if (SMPDecimator::IsCheaper(candidate.Cost, candidate.PtIds[0],
+            candidate.PtIds[1], this->Costs[ptId], std::min(ptId, partner),
+            std::max(ptId, partner)) &&
+          this->Self->IsGoodPlacement(candidate.PtIds[0], candidate.PtIds[1],
+                                      candidate.X))
+      {
+        this->SetCheapestEdge(ptId, candidate);
+        partner = neighbor;
+      }
+    }
+    return true;
+  }
+
+  // Find the cheapest edge, whose collapse passes the placement check, of
+  // each dirty point. Between the rounds, the cheapest edges are updated
+  // when possible.
+  struct FindCheapestEdges
+  {
+    SMPDecimator *Decimator;
+    bool Update;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      std::vector<vtkIdType> &neighbors = dec->LocalIds.Local();
+      std::vector<Candidate> &candidates = dec->LocalCandidates.Local();
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType ptId = dec->Dirty[i];
+        candidates.resize(1);
+        if (this->Update &&
+            dec->UpdateCheapestEdge(ptId, neighbors, candidates[0]))
+        {
+          continue;
+        }
+
+        dec->Partners[ptId] = -1;
+        dec->Costs[ptId] = VTK_DOUBLE_MAX;
+        dec->GetNeighbors(ptId, neighbors);
+        candidates.resize(neighbors.size());
+        for (size_t j = 0; j < neighbors.size(); ++j)
+        {
+          dec->ComputeCandidate(ptId, neighbors[j], candidates[j]);
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (const Candidate &candidate : candidates)
+        {
+          if (dec->Self->IsGoodPlacement(candidate.PtIds[0],
+                                         candidate.PtIds[1], candidate.X))
+          {
+            dec->SetCheapestEdge(ptId, candidate);
+            break;
+          }
+        }
+      }
+    }
+  };
+
+  // Gather the candidate edges of this round, from their smaller end point.
+  struct GatherCandidates
+  {
+    SMPDecimator *Decimator;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      std::vector<vtkIdType> &candidates = dec->LocalDirty.Local();
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        if (dec->Partners[ptId] > ptId && dec->IsCandidate(ptId))
+        {
+          candidates.push_back(ptId);
+        }
+      }
+    }
+  };
+
+  // Whether the neighborhood of a candidate edge is free of the neighborhoods
+  // of the edges already selected in this round.
+  struct MarkAvailable
+  {
+    SMPDecimator *Decimator;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      unsigned short ncells, c;
+      vtkIdType *cells, npts, *pts;
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType ptId = dec->Candidates[i];
+        char available = 1;
+        for (int e = 0; e < 2 && available; ++e)
+        {
+          dec->Mesh->GetPointCells(e == 0 ? ptId : dec->Partners[ptId],
+                                   ncells, cells);
+          for (c = 0; c < ncells && available; ++c)
+          {
+            dec->Mesh->GetCellPoints(cells[c], npts, pts);
+            for (vtkIdType k = 0; k < npts; ++k)
+            {
+              if (dec->Taken[pts[k]] == dec->Round)
+              {
+                available = 0;
+                break;
+              }
+            }
+          }
+        }
+        dec->Available[ptId] = available;
+      }
+    }
+  };
+
+  // Select the available candidate edges which are cheaper than the
+  // available candidate edges whose neighborhoods overlap theirs.
+  struct SelectCollapses
+  {
+    SMPDecimator *Decimator;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      std::vector<vtkIdType> &neighbors = dec->LocalIds.Local();
+      std::vector<Collapse> &collapses = dec->LocalCollapses.Local();
+      unsigned short ncells, c;
+      vtkIdType *cells, npts, *pts;
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType ptId = dec->Candidates[i];
+        vtkIdType partner = dec->Partners[ptId];
+        double cost = dec->Costs[ptId];
+        if (!dec->Available[ptId])
+        {
+          continue;
+        }
+
+        // the neighborhoods of two edges overlap if an end point of one is
+        // within two edges of an end point of the other
+        bool isCheapest = true;
+        for (int e = 0; e < 2 && isCheapest; ++e)
+        {
+          dec->GetNeighbors(e == 0 ? ptId : partner, neighbors);
+          for (size_t j = 0; j < neighbors.size() && isCheapest; ++j)
+          {
+            dec->Mesh->GetPointCells(neighbors[j], ncells, cells);
+            for (c = 0; c < ncells && isCheapest; ++c)
+            {
+              dec->Mesh->GetCellPoints(cells[c], npts, pts);
+              for (vtkIdType k = 0; k < npts; ++k)
+              {
+                if (dec->IsCheaperCandidate(pts[k], cost, ptId, partner))
+                {
+                  isCheapest = false;
+                  break;
+                }
+              }
+            }
+          }
+        }
+        if (!isCheapest)
+        {
+          continue;
+        }
+
+        Collapse collapse;
+        collapse.Cost = cost;
+        collapse.PtIds[0] = ptId;
+        collapse.PtIds[1] = partner;
+        collapse.NumTris = 0;
+        dec->Mesh->GetPointCells(ptId, ncells, cells);
+        for (c = 0; c < ncells; ++c)
+        {
+          collapse.NumTris += dec->Mesh->IsPointUsedByCell(partner, cells[c]);
+        }
+        collapses.push_back(collapse);
+      }
+    }
+  };
+
+  // Take the neighborhoods of the edges just selected.
+  struct TakeNeighborhoods
+  {
+    SMPDecimator *Decimator;
+    vtkIdType Offset;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      unsigned short ncells, c;
+      vtkIdType *cells, npts, *pts;
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const Collapse &collapse = dec->Collapses[this->Offset + i];
+        dec->Available[collapse.PtIds[0]] = 0;
+        for (int e = 0; e < 2; ++e)
+        {
+          dec->Mesh->GetPointCells(collapse.PtIds[e], ncells, cells);
+          for (c = 0; c < ncells; ++c)
+          {
+            dec->Mesh->GetCellPoints(cells[c], npts, pts);
+            for (vtkIdType k = 0; k < npts; ++k)
+            {
+              dec->Taken[pts[k]] = dec->Round;
+            }
+          }
+        }
+      }
+    }
+  };
+
+  // Whether a candidate edge is no longer available.
+  struct IsUnavailable
+  {
+    const SMPDecimator *Decimator;
+
+    bool operator()(vtkIdType ptId) const
+    {
+      return !this->Decimator->Available[ptId];
+    }
+  };
+
+  // Collapse the selected edges, see the collapse loop of RequestData().
+  struct CollapseEdges
+  {
+    SMPDecimator *Decimator;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      vtkIdList *cellIds = dec->CellIds.Local();
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType pt0Id = dec->Collapses[i].PtIds[0];
+        vtkIdType pt1Id = dec->Collapses[i].PtIds[1];
+
+        dec->Points->SetPoint(pt0Id, dec->Targets.data() + 3 * pt0Id);
+        double *q0 = dec->Quadrics.data() + 10 * pt0Id;
+        const double *q1 = dec->Quadrics.data() + 10 * pt1Id;
+        for (int k = 0; k < 10; ++k)
+        {
+          q0[k] += q1[k];
+        }
+
+        dec->NumDeleted[i] = vtkQD_CollapseEdge(dec->Mesh, cellIds,
+                                                pt0Id, pt1Id);
+        dec->Kept[pt0Id] = dec->Round;
+        dec->Partners[pt1Id] = -1;
+        dec->Costs[pt1Id] = VTK_DOUBLE_MAX;
+      }
+    }
+  };
+
+  // Gather the points whose cheapest edge may have changed with the
+  // collapses: the points of the neighborhoods of the selected edges, which
+  // include the kept points and the points around them, and the points whose
+  // cheapest edge ends in one of these neighborhoods. The costs and the
+  // placements of the other edges are unchanged; as in the serial decimation,
+  // an edge whose placement was rejected is not reconsidered until the
+  // cheapest edge of one of its end points is looked for again.
+  struct GatherDirtyPoints
+  {
+    SMPDecimator *Decimator;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      SMPDecimator *dec = this->Decimator;
+      std::vector<vtkIdType> &dirty = dec->LocalDirty.Local();
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        vtkIdType partner = dec->Partners[ptId];
+        if (dec->Taken[ptId] == dec->Round ||
+            (partner >= 0 && dec->Taken[partner] == dec->Round))
+        {
+          dirty.push_back(ptId);
+        }
+      }
+    }
+  };
+
+  // Move the contents of thread local vectors to the end of a vector.
+  template <typename T>
+  static void Append(vtkSMPThreadLocal<std::vector<T>> &local,
+                     std::vector<T> &v)
+  {
+    for (typename vtkSMPThreadLocal<std::vector<T>>::iterator iter =
+           local.begin(); iter != local.end(); ++iter)
+    {
+      v.insert(v.end(), iter->begin(), iter->end());
+      iter->clear();
+    }
+  }
+
+  // The points sharing a triangle with point ptId.
+  void GetNeighbors(vtkIdType ptId, std::vector<vtkIdType> &neighbors)
+  {
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+
+    neighbors.clear();
+    this->Mesh->GetPointCells(ptId, ncells, cells);
+    for (unsigned short c = 0; c < ncells; ++c)
+    {
+      this->Mesh->GetCellPoints(cells[c], npts, pts);
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        if (pts[j] != ptId)
+        {
+          neighbors.push_back(pts[j]);
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                    neighbors.end());
+  }
+
+  // Choose the cost below which edges are collapsed in this round, from a
+  // sample of the cheapest edges of the points: about as many points as the
+  // remaining collapses need have a cheaper edge.
+  void ComputeThreshold(double numTrisToDelete)
+  {
+    std::vector<double> costs;
+    vtkIdType stride = std::max(this->NumPts / 4096, static_cast<vtkIdType>(1));
+    for (vtkIdType ptId = 0; ptId < this->NumPts; ptId += stride)
+    {
+      if (this->Partners[ptId] >= 0)
+      {
+        costs.push_back(this->Costs[ptId]);
+      }
+    }
+    if (costs.empty())
+    {
+      this->Threshold = VTK_DOUBLE_MAX;
+      return;
+    }
+
+    // a collapse deletes about two triangles and removes one of the two
+    // points whose cheapest edge it is
+    double numPts = static_cast<double>(costs.size()) * stride;
+    double fraction = std::min(numTrisToDelete / numPts, 1.0);
+    size_t k = static_cast<size_t>(fraction * (costs.size() - 1));
+    std::nth_element(costs.begin(), costs.begin() + k, costs.end());
+    this->Threshold = costs[k];
+  }
+
+  void FindAllCheapestEdges(FindCheapestEdges &findCheapest)
+  {
+    this->Dirty.resize(this->NumPts);
+    for (vtkIdType ptId = 0; ptId < this->NumPts; ++ptId)
+    {
+      this->Dirty[ptId] = ptId;
+    }
+    vtkSMPTools::For(0, this->NumPts, findCheapest);
+  }
+
+  void Execute()
+  {
+    vtkQuadricDecimation *self = this->Self;
+    vtkIdType numPts = this->NumPts;
+
+    self->NumberOfEdgeCollapses = 0;
+    self->ActualReduction = 0.0;
+    if (numPts == 0 || this->NumTris == 0)
+    {
+      return;
+    }
+
+    vtkDebugWithObjectMacro(self, <<"Computing Quadrics");
+    this->Quadrics.resize(10 * numPts);
+    ComputeQuadrics quadrics = { this };
+    vtkSMPTools::For(0, numPts, quadrics);
+    self->UpdateProgress(0.15);
+
+    vtkDebugWithObjectMacro(self, <<"Computing Costs");
+    this->Costs.resize(numPts);
+    this->Partners.resize(numPts);
+    this->Targets.resize(3 * numPts);
+    FindCheapestEdges findCheapest = { this, false };
+    this->FindAllCheapestEdges(findCheapest);
+    self->UpdateProgress(0.20);
+    this->Available.resize(numPts);
+    this->Taken.assign(numPts, this->Round);
+    this->Kept.assign(numPts, this->Round);
+
+    // Okay collapse edges in rounds until desired reduction is reached
+    vtkIdType numDeletedTris = 0;
+    int abort = 0;
+    while (!abort && self->ActualReduction < self->TargetReduction)
+    {
+      double numTrisToDelete =
+        self->TargetReduction * this->NumTris - numDeletedTris;
+      this->ComputeThreshold(numTrisToDelete);
+
+      // select a maximal set of candidate edges with disjoint neighborhoods,
+      // in sweeps over the candidates still available
+      this->Round++;
+      this->Candidates.clear();
+      GatherCandidates gatherCandidates = { this };
+      vtkSMPTools::For(0, numPts, gatherCandidates);
+      SMPDecimator::Append(this->LocalDirty, this->Candidates);
+      this->Collapses.clear();
+      while (!this->Candidates.empty())
+      {
+        vtkIdType numCandidates =
+          static_cast<vtkIdType>(this->Candidates.size());
+        MarkAvailable mark = { this };
+        vtkSMPTools::For(0, numCandidates, mark);
+        SelectCollapses select = { this };
+        vtkSMPTools::For(0, numCandidates, select);
+        size_t numCollapses = this->Collapses.size();
+        SMPDecimator::Append(this->LocalCollapses, this->Collapses);
+        if (this->Collapses.size() == numCollapses)
+        {
+          break;
+        }
+        TakeNeighborhoods take = { this, static_cast<vtkIdType>(numCollapses) };
+        vtkSMPTools::For(0, static_cast<vtkIdType>(this->Collapses.size() -
+                                                   numCollapses), take);
+        IsUnavailable isUnavailable = { this };
+        this->Candidates.erase(std::remove_if(this->Candidates.begin(),
+          this->Candidates.end(), isUnavailable), this->Candidates.end());
+      }
+      if (this->Collapses.empty())
+      {
+        // the updates may have missed edges whose placement now passes the
+        // check, look for the cheapest edges of all the points once more
+        if (!findCheapest.Update)
+        {
+          break;
+        }
+        findCheapest.Update = false;
+        this->FindAllCheapestEdges(findCheapest);
+        continue;
+      }
+      findCheapest.Update = true;
+
+      // do not collapse more edges than needed, the cheapest first
+      vtkSMPTools::Sort(this->Collapses.begin(), this->Collapses.end());
+      vtkIdType numTris = 0;
+      size_t numCollapses = 0;
+      while (numCollapses < this->Collapses.size() &&
+             numTris < numTrisToDelete)
+      {
+        numTris += this->Collapses[numCollapses++].NumTris;
+      }
+      this->Collapses.resize(std::max(numCollapses, static_cast<size_t>(1)));
+
+      vtkIdType numSelected = static_cast<vtkIdType>(this->Collapses.size());
+      this->NumDeleted.resize(numSelected);
+      CollapseEdges collapse = { this };
+      vtkSMPTools::For(0, numSelected, collapse);
+      for (vtkIdType numDeleted : this->NumDeleted)
+      {
+        numDeletedTris += numDeleted;
+      }
+      self->NumberOfEdgeCollapses += numSelected;
+      self->ActualReduction = static_cast<double>(numDeletedTris) / this->NumTris;
+      vtkDebugWithObjectMacro(self, <<"Collapsed " << numSelected
+                              << " edges below cost " << this->Threshold);
+
+      // update the cheapest edges near the collapses
+      GatherDirtyPoints gather = { this };
+      vtkSMPTools::For(0, numPts, gather);
+      this->Dirty.clear();
+      SMPDecimator::Append(this->LocalDirty, this->Dirty);
+      vtkSMPTools::For(0, static_cast<vtkIdType>(this->Dirty.size()),
+                       findCheapest);
+
+      self->UpdateProgress(0.20 + 0.80 * self->ActualReduction /
+                           self->TargetReduction);
+      abort = self->GetAbortExecute();
+    }
+
+    vtkDebugWithObjectMacro(self, <<"Number Of Edge Collapses: "
+                            << self->NumberOfEdgeCollapses);
+  }
+};
+
 //----------------------------------------------------------------------------
 int vtkQuadricDecimation::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -236,155 +1150,167 @@ int vtkQuadricDecimation::RequestData(
   pointData->Delete();
   this->Mesh->GetFieldData()->PassData(input->GetFieldData());
   this->Mesh->BuildCells();
-  this->Mesh->BuildLinks();
 
-  this->ErrorQuadrics =
-    new vtkQuadricDecimation::ErrorQuadric[numPts];
-  if (this->VolumePreservation)
+  if (this->ParallelDecimation && !this->AttributeErrorMetric &&
+      !this->VolumePreservation)
   {
-    this->VolumeConstraints =
-      new double[numPts * 4];
-
-    for (i = 0; i < numPts * 4; i++)
-    {
-      this->VolumeConstraints[i] = 0.0;
-    }
+    // the collapses edit the links concurrently, they must be editable
+    this->Mesh->BuildLinks(numPts);
+    SMPDecimator decimator(this, numTris);
+    decimator.Execute();
   }
-
-  vtkDebugMacro(<<"Computing Edges");
-  this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
-  this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
-  for (i = 0; i <  this->Mesh->GetNumberOfCells(); i++)
+  else
   {
-    this->Mesh->GetCellPoints(i, npts, pts);
+    this->Mesh->BuildLinks();
 
-    for (j = 0; j < 3; j++)
+    this->ErrorQuadrics =
+      new vtkQuadricDecimation::ErrorQuadric[numPts];
+    if (this->VolumePreservation)
     {
-      if (this->Edges->IsEdge(pts[j], pts[(j+1)%3]) == -1)
+      this->VolumeConstraints =
+        new double[numPts * 4];
+
+      for (i = 0; i < numPts * 4; i++)
       {
-        // If this edge has not been processed, get an id for it, add it to
-        // the edge list (Edges), and add its endpoints to the EndPoint1List
-        // and EndPoint2List (the 2 endpoints to different lists).
-        edgeId = this->Edges->GetNumberOfEdges();
-        this->Edges->InsertEdge(pts[j], pts[(j+1)%3], edgeId);
-        this->EndPoint1List->InsertId(edgeId, pts[j]);
-        this->EndPoint2List->InsertId(edgeId, pts[(j+1)%3]);
+        this->VolumeConstraints[i] = 0.0;
       }
     }
-  }
-
-  this->UpdateProgress(0.1);
 
-  this->NumberOfComponents = 0;
-  if (this->AttributeErrorMetric)
-  {
-    this->ComputeNumberOfComponents();
-  }
-  x = new double [3+this->NumberOfComponents+this->VolumePreservation];
-  this->CollapseCellIds = vtkIdList::New();
-  this->TempX = new double [3+this->NumberOfComponents+this->VolumePreservation];
-  this->TempQuad = new double[11 + 4 * this->NumberOfComponents+this->VolumePreservation];
+    vtkDebugMacro(<<"Computing Edges");
+    this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
+    this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
+    for (i = 0; i <  this->Mesh->GetNumberOfCells(); i++)
+    {
+      this->Mesh->GetCellPoints(i, npts, pts);
 
-  this->TempB = new double [3 +  this->NumberOfComponents+this->VolumePreservation];
-  this->TempA = new double*[3 +  this->NumberOfComponents+this->VolumePreservation];
-  this->TempData = new double [(3 +  this->NumberOfComponents+this->VolumePreservation)*(3 +  this->NumberOfComponents+VolumePreservation)];
-  for (i = 0; i < 3 +  this->NumberOfComponents+this->VolumePreservation; i++)
-  {
-    this->TempA[i] = this->TempData+i*(3 +  this->NumberOfComponents+this->VolumePreservation);
-  }
-  this->TargetPoints->SetNumberOfComponents(3+this->NumberOfComponents+this->VolumePreservation);
+      for (j = 0; j < 3; j++)
+      {
+        if (this->Edges->IsEdge(pts[j], pts[(j+1)%3]) == -1)
+        {
+          // If this edge has not been processed, get an id for it, add it to
+          // the edge list (Edges), and add its endpoints to the EndPoint1List
+          // and EndPoint2List (the 2 endpoints to different lists).
+          edgeId = this->Edges->GetNumberOfEdges();
+          this->Edges->InsertEdge(pts[j], pts[(j+1)%3], edgeId);
+          this->EndPoint1List->InsertId(edgeId, pts[j]);
+          this->EndPoint2List->InsertId(edgeId, pts[(j+1)%3]);
+        }
+      }
+    }
 
-  vtkDebugMacro(<<"Computing Quadrics");
-  this->InitializeQuadrics(numPts);
-  this->AddBoundaryConstraints();
-  this->UpdateProgress(0.15);
+    this->UpdateProgress(0.1);
 
-  vtkDebugMacro(<<"Computing Costs");
-  // Compute the cost of and target point for collapsing each edge.
-  for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
-  {
+    this->NumberOfComponents = 0;
     if (this->AttributeErrorMetric)
     {
-      cost = this->ComputeCost2(i, x);
+      this->ComputeNumberOfComponents();
     }
-    else
+    x = new double [3+this->NumberOfComponents+this->VolumePreservation];
+    this->CollapseCellIds = vtkIdList::New();
+    this->TempX = new double [3+this->NumberOfComponents+this->VolumePreservation];
+    this->TempQuad = new double[11 + 4 * this->NumberOfComponents+this->VolumePreservation];
+
+    this->TempB = new double [3 +  this->NumberOfComponents+this->VolumePreservation];
+    this->TempA = new double*[3 +  this->NumberOfComponents+this->VolumePreservation];
+    this->TempData = new double [(3 +  this->NumberOfComponents+this->VolumePreservation)*(3 +  this->NumberOfComponents+VolumePreservation)];
+    for (i = 0; i < 3 +  this->NumberOfComponents+this->VolumePreservation; i++)
     {
-      cost = this->ComputeCost(i, x);
+      this->TempA[i] = this->TempData+i*(3 +  this->NumberOfComponents+this->VolumePreservation);
     }
-    this->EdgeCosts->Insert(cost, i);
-    this->TargetPoints->InsertTuple(i, x);
-  }
-  this->UpdateProgress(0.20);
+    this->TargetPoints->SetNumberOfComponents(3+this->NumberOfComponents+this->VolumePreservation);
 
-  // Okay collapse edges until desired reduction is reached
-  this->ActualReduction = 0.0;
-  this->NumberOfEdgeCollapses = 0;
-  edgeId = this->EdgeCosts->Pop(0,cost);
+    vtkDebugMacro(<<"Computing Quadrics");
+    this->InitializeQuadrics(numPts);
+    this->AddBoundaryConstraints();
+    this->UpdateProgress(0.15);
 
-  int abort = 0;
-  while ( !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
-         this->ActualReduction < this->TargetReduction )
-  {
-    if ( ! (this->NumberOfEdgeCollapses % 10000) )
+    vtkDebugMacro(<<"Computing Costs");
+    // Compute the cost of and target point for collapsing each edge.
+    for (i = 0; i < this->Edges->GetNumberOfEdges(); i++)
     {
-      vtkDebugMacro(<<"Collapsing edge#" << this->NumberOfEdgeCollapses);
-      this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
-      abort = this->GetAbortExecute();
+      if (this->AttributeErrorMetric)
+      {
+        cost = this->ComputeCost2(i, x);
+      }
+      else
+      {
+        cost = this->ComputeCost(i, x);
+      }
+      this->EdgeCosts->Insert(cost, i);
+      this->TargetPoints->InsertTuple(i, x);
     }
+    this->UpdateProgress(0.20);
 
-    endPtIds[0] = this->EndPoint1List->GetId(edgeId);
-    endPtIds[1] = this->EndPoint2List->GetId(edgeId);
-    this->TargetPoints->GetTuple(edgeId, x);
+    // Okay collapse edges until desired reduction is reached
+    this->ActualReduction = 0.0;
+    this->NumberOfEdgeCollapses = 0;
+    edgeId = this->EdgeCosts->Pop(0,cost);
 
-    // check for a poorly placed point
-    if ( !this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
+    int abort = 0;
+    while ( !abort && edgeId >= 0 && cost < VTK_DOUBLE_MAX &&
+           this->ActualReduction < this->TargetReduction )
     {
-      vtkDebugMacro(<<"Poor placement detected " << edgeId << " " <<  cost);
-      // return the point to the queue but with the max cost so that
-      // when it is recomputed it will be reconsidered
-      this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
+      if ( ! (this->NumberOfEdgeCollapses % 10000) )
+      {
+        vtkDebugMacro(<<"Collapsing edge#" << this->NumberOfEdgeCollapses);
+        this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
+        abort = this->GetAbortExecute();
+      }
 
-      edgeId = this->EdgeCosts->Pop(0, cost);
-      continue;
-    }
+      endPtIds[0] = this->EndPoint1List->GetId(edgeId);
+      endPtIds[1] = this->EndPoint2List->GetId(edgeId);
+      this->TargetPoints->GetTuple(edgeId, x);
 
-    this->NumberOfEdgeCollapses++;
+      // check for a poorly placed point
+      if ( !this->IsGoodPlacement(endPtIds[0], endPtIds[1], x))
+      {
+        vtkDebugMacro(<<"Poor placement detected " << edgeId << " " <<  cost);
+        // return the point to the queue but with the max cost so that
+        // when it is recomputed it will be reconsidered
+        this->EdgeCosts->Insert(VTK_DOUBLE_MAX, edgeId);
 
-    // Set the new coordinates of point0.
-    this->SetPointAttributeArray(endPtIds[0], x);
-    vtkDebugMacro(<<"Cost: " << cost << " Edge: "
-                  << endPtIds[0] << " " << endPtIds[1]);
+        edgeId = this->EdgeCosts->Pop(0, cost);
+        continue;
+      }
 
-    // Merge the quadrics of the two points.
-    this->AddQuadric(endPtIds[1], endPtIds[0]);
+      this->NumberOfEdgeCollapses++;
 
-    this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
+      // Set the new coordinates of point0.
+      this->SetPointAttributeArray(endPtIds[0], x);
+      vtkDebugMacro(<<"Cost: " << cost << " Edge: "
+                    << endPtIds[0] << " " << endPtIds[1]);
 
-    // Update the output triangles.
-    numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
-    this->ActualReduction = (double) numDeletedTris / numTris;
-    edgeId = this->EdgeCosts->Pop(0, cost);
-  }
+      // Merge the quadrics of the two points.
+      this->AddQuadric(endPtIds[1], endPtIds[0]);
 
-  vtkDebugMacro(<<"Number Of Edge Collapses: "
-                << this->NumberOfEdgeCollapses << " Cost: " << cost);
+      this->UpdateEdgeData(endPtIds[0], endPtIds[1]);
 
-  // clean up working data
-  for (i = 0; i < numPts; i++)
-  {
-    delete [] this->ErrorQuadrics[i].Quadric;
-  }
-  delete [] this->ErrorQuadrics;
+      // Update the output triangles.
+      numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
+      this->ActualReduction = (double) numDeletedTris / numTris;
+      edgeId = this->EdgeCosts->Pop(0, cost);
+    }
 
-  if (this->VolumePreservation)
-    delete[] this->VolumeConstraints;
-  delete [] x;
-  this->CollapseCellIds->Delete();
-  delete [] this->TempX;
-  delete [] this->TempQuad;
-  delete [] this->TempB;
-  delete [] this->TempA;
-  delete [] this->TempData;
+    vtkDebugMacro(<<"Number Of Edge Collapses: "
+                  << this->NumberOfEdgeCollapses << " Cost: " << cost);
+
+    // clean up working data
+    for (i = 0; i < numPts; i++)
+    {
+      delete [] this->ErrorQuadrics[i].Quadric;
+    }
+    delete [] this->ErrorQuadrics;
+
+    if (this->VolumePreservation)
+      delete[] this->VolumeConstraints;
+    delete [] x;
+    this->CollapseCellIds->Delete();
+    delete [] this->TempX;
+    delete [] this->TempQuad;
+    delete [] this->TempB;
+    delete [] this->TempA;
+    delete [] this->TempData;
+  }
 
   // copy the simplified mesh from the working mesh to the output mesh
   for (i = 0; i < this->Mesh->GetNumberOfCells(); i++)
@@ -824,15 +1750,8 @@ void vtkQuadricDecimation::UpdateEdgeData(vtkIdType pt0Id, vtkIdType pt1Id)
 //----------------------------------------------------------------------------
 double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
 {
-  static const double errorNumber = 1e-10;
-  double temp[3], A[3][3], b[3];
   vtkIdType pointIds[2];
-  double cost = 0.0;
-  double *index;
-  int i, j;
-  double newPoint [4];
-  double v[3],  c, norm, normTemp,  temp2[3];
-  double pt1[3], pt2[3];
+  int i;
 
   pointIds[0] = this->EndPoint1List->GetId(edgeId);
   pointIds[1] = this->EndPoint2List->GetId(edgeId);
@@ -843,80 +1762,8 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
       this->ErrorQuadrics[pointIds[1]].Quadric[i];
   }
 
-  A[0][0] = this->TempQuad[0];
-  A[0][1] = A[1][0] = this->TempQuad[1];
-  A[0][2] = A[2][0] = this->TempQuad[2];
-  A[1][1] = this->TempQuad[4];
-  A[1][2] = A[2][1] = this->TempQuad[5];
-  A[2][2] = this->TempQuad[7];
-
-  b[0] = -this->TempQuad[3];
-  b[1] = -this->TempQuad[6];
-  b[2] = -this->TempQuad[8];
-
-  norm = vtkMath::Norm(A[0]);
-  normTemp = vtkMath::Norm(A[1]);
-  norm = norm > normTemp ? norm : normTemp;
-  normTemp = vtkMath::Norm(A[2]);
-  norm = norm > normTemp ? norm : normTemp;
-
-  if (fabs(vtkMath::Determinant3x3(A))/(norm*norm*norm) >  errorNumber)
-  {
-    // it would be better to use the normal of the matrix to test singularity??
-    vtkMath::LinearSolve3x3(A, b, x);
-    vtkMath::Multiply3x3(A,x,temp);
-    // error too high, backup plans
-  }
-  else
-  {
-    // cheapest point along the edge
-    this->Mesh->GetPoints()->GetPoint(pointIds[0], pt1);
-    this->Mesh->GetPoints()->GetPoint(pointIds[1], pt2);
-    v[0] = pt2[0] - pt1[0];
-    v[1] = pt2[1] - pt1[1];
-    v[2] = pt2[2] - pt1[2];
-
-    // equation for the edge pt1 + c * v
-    // attempt least squares fit for c for A*(pt1 + c * v) = b
-    vtkMath::Multiply3x3(A,v,temp2);
-    if (vtkMath::Dot(temp2, temp2) > errorNumber)
-    {
-      vtkMath::Multiply3x3(A,pt1,temp);
-      for (i = 0; i < 3; i++)
-        temp[i] = b[i] - temp[i];
-      c = vtkMath::Dot(temp2, temp) / vtkMath::Dot(temp2, temp2);
-      for (i = 0; i < 3; i++)
-        x[i] = pt1[i]+c*v[i];
-    }
-    else
-    {
-      // use mid point
-      // might want to change to best of mid and end points??
-      for (i = 0; i < 3; i++)
-      {
-        x[i] = 0.5*(pt1[i]+pt2[i]);
-      }
-    }
-  }
-
-  newPoint[0] = x[0];
-  newPoint[1] = x[1];
-  newPoint[2] = x[2];
-  newPoint[3] = 1;
-
-  // Compute the cost
-  // x'*quad*x
-  index = this->TempQuad;
-  for (i = 0; i < 4; i++)
-  {
-    cost += (*index++)*newPoint[i]*newPoint[i];
-    for (j = i +1; j < 4; j++)
-    {
-      cost += 2.0*(*index++)*newPoint[i]*newPoint[j];
-    }
-  }
-
-  return cost;
+  return vtkQD_ComputeCost(this->TempQuad, this->Mesh->GetPoints(),
+                           pointIds[0], pointIds[1], x);
 }
 
 
@@ -1165,50 +2012,7 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
 
 int vtkQuadricDecimation::CollapseEdge(vtkIdType pt0Id, vtkIdType pt1Id)
 {
-  int j, numDeleted=0;
-  vtkIdType i, npts, *pts, cellId;
-
-  this->Mesh->GetPointCells(pt0Id, this->CollapseCellIds);
-  for (i = 0; i < this->CollapseCellIds->GetNumberOfIds(); i++)
-  {
-    cellId = this->CollapseCellIds->GetId(i);
-    this->Mesh->GetCellPoints(cellId, npts, pts);
-    for (j = 0; j < 3; j++)
-    {
-      if (pts[j] == pt1Id)
-      {
-        this->Mesh->RemoveCellReference(cellId);
-        this->Mesh->DeleteCell(cellId);
-        numDeleted++;
-      }
-    }
-  }
-
-  this->Mesh->GetPointCells(pt1Id, this->CollapseCellIds);
-  this->Mesh->ResizeCellList(pt0Id, this->CollapseCellIds->GetNumberOfIds());
-  for (i=0; i < this->CollapseCellIds->GetNumberOfIds(); i++)
-  {
-    cellId = this->CollapseCellIds->GetId(i);
-    this->Mesh->GetCellPoints(cellId, npts, pts);
-    // making sure we don't already have the triangle we're about to
-    // change this one to
-    if ((pts[0] == pt1Id && this->Mesh->IsTriangle(pt0Id, pts[1], pts[2])) ||
-        (pts[1] == pt1Id && this->Mesh->IsTriangle(pts[0], pt0Id, pts[2])) ||
-        (pts[2] == pt1Id && this->Mesh->IsTriangle(pts[0], pts[1], pt0Id)))
-    {
-      this->Mesh->RemoveCellReference(cellId);
-      this->Mesh->DeleteCell(cellId);
-      numDeleted++;
-    }
-    else
-    {
-      this->Mesh->AddReferenceToCell(pt0Id, cellId);
-      this->Mesh->ReplaceCellPoint(cellId, pt1Id, pt0Id);
-    }
-  }
-  this->Mesh->DeletePoint(pt1Id);
-
-  return numDeleted;
+  return vtkQD_CollapseEdge(this->Mesh, this->CollapseCellIds, pt0Id, pt1Id);
 }
 
 
@@ -1438,6 +2242,8 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
      << (this->AttributeErrorMetric ? "On\n" : "Off\n");
   os << indent << "Volume Preservation: "
     << (this->VolumePreservation ? "On\n" : "Off\n");
+  os << indent << "Parallel Decimation: "
+     << (this->ParallelDecimation ? "On\n" : "Off\n");
   os << indent << "Scalars Attribute: "
      << (this->ScalarsAttribute ? "On\n" : "Off\n");
   os << indent << "Vectors Attribute: "
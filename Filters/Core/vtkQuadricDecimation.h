@@ -156,6 +156,23 @@ public:
   vtkGetMacro(ActualReduction, double);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the mesh is decimated in
+   * parallel with vtkSMPTools. If on, the quadrics are computed in parallel,
+   * and the edges are collapsed in rounds instead of one at a time: each
+   * round collapses concurrently the edges that are cheaper than all the
+   * edges near them and than a cost threshold, then updates the costs of the
+   * nearby edges. The result is close to, but not the same as, the serial
+   * result. The attribute error metric and volume preservation are only
+   * supported by the serial decimation, which is used when either is on. By
+   * default, parallel decimation is off.
+   */
+  vtkSetMacro(ParallelDecimation, vtkTypeBool);
+  vtkGetMacro(ParallelDecimation, vtkTypeBool);
+  vtkBooleanMacro(ParallelDecimation, vtkTypeBool);
+  //@}
+
 protected:
   vtkQuadricDecimation();
   ~vtkQuadricDecimation() override;
@@ -234,6 +251,7 @@ protected:
   double ActualReduction;
   vtkTypeBool   AttributeErrorMetric;
   vtkTypeBool   VolumePreservation;
+  vtkTypeBool   ParallelDecimation;
 
   vtkTypeBool ScalarsAttribute;
   vtkTypeBool VectorsAttribute;
@@ -278,6 +296,9 @@ protected:
   double **TempA;
   double *TempData;
 
+  // Threaded decimation, see vtkQuadricDecimation.cxx.
+  struct SMPDecimator;
+
 private:
   vtkQuadricDecimation(const vtkQuadricDecimation&) = delete;
   void operator=(const vtkQuadricDecimation&) = delete;
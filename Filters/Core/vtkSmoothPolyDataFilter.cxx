@@ -25,10 +25,15 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmoothingTopology.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
@@ -132,6 +137,8 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
 
   this->SmoothPoints = nullptr;
 
+  this->ParallelSmoothing = 0;
+
   // optional second input
   this->SetNumberOfInputPorts(2);
 }
@@ -281,6 +288,143 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
 
 }// namespace
 
+//----------------------------------------------------------------------------
+// Smooth the mesh with vtkSMPTools. The types and the connected vertices of
+// the vertices are found by vtkSmoothingTopology as in RequestData(). The
+// iterations read the points of the previous iteration from one buffer and
+// write the moved points to another.
+struct vtkSmoothPolyDataFilter::SMPSmoother : public vtkSmoothingTopology
+{
+  vtkSmoothPolyDataFilter *Self;
+
+  SMPSmoother(vtkSmoothPolyDataFilter *self, vtkPoints *inPts,
+              double cosFeatureAngle, double cosEdgeAngle) :
+    vtkSmoothingTopology(self, inPts, cosFeatureAngle, cosEdgeAngle,
+                         self->FeatureEdgeSmoothing != 0,
+                         self->BoundarySmoothing != 0,
+                         false, false),
+    Self(self)
+  {
+  }
+
+  // Move each point toward the mean position of its connected vertices,
+  // from the positions of the previous iteration.
+  template <typename T>
+  struct MovePoints
+  {
+    SMPSmoother *Smoother;
+    const T *Points;
+    T *NewPoints;
+    T Factor;
+    vtkSMPThreadLocal<T> LocalMaxDist;
+    T MaxDist;
+
+    MovePoints(SMPSmoother *smoother, const T *points, T *newPoints,
+               T factor) :
+      Smoother(smoother), Points(points), NewPoints(newPoints),
+      Factor(factor), MaxDist(0.0)
+    {
+    }
+
+    void Initialize()
+    {
+      this->LocalMaxDist.Local() = 0.0;
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const vtkIdType *offsets = this->Smoother->Offsets.data();
+      const vtkIdType *neighbors = this->Smoother->Neighbors.data();
+      const char *types = this->Smoother->Types.data();
+      T &maxDist = this->LocalMaxDist.Local();
+      T dist, deltaX[3];
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const T *x = this->Points + 3 * i;
+        T *xNew = this->NewPoints + 3 * i;
+        vtkIdType npts = offsets[i + 1] - offsets[i];
+        if (types[i] != VTK_FIXED_VERTEX && npts > 0)
+        {
+          deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+          for (vtkIdType j = offsets[i]; j < offsets[i + 1]; ++j)
+          {
+            const T *y = this->Points + 3 * neighbors[j];
+            for (int k = 0; k < 3; ++k)
+            {
+              deltaX[k] += y[k];
+            }
+          }
+          for (int k = 0; k < 3; ++k)
+          {
+            xNew[k] = x[k] + this->Factor * (deltaX[k] / npts - x[k]);
+          }
+          if ((dist = vtkMath::Norm(deltaX)) > maxDist)
+          {
+            maxDist = dist;
+          }
+        }
+        else
+        {
+          xNew[0] = x[0];
+          xNew[1] = x[1];
+          xNew[2] = x[2];
+        }
+      }
+    }
+
+    void Reduce()
+    {
+      this->MaxDist = 0.0;
+      for (typename vtkSMPThreadLocal<T>::iterator iter =
+             this->LocalMaxDist.begin();
+           iter != this->LocalMaxDist.end(); ++iter)
+      {
+        this->MaxDist = std::max(this->MaxDist, *iter);
+      }
+    }
+  };
+
+  // Smooth the points, initialized to the input points.
+  template <typename T>
+  void Smooth(vtkPoints *newPts, int numberOfIterations, T factor, T conv)
+  {
+    T *points = static_cast<T*>(newPts->GetVoidPointer(0));
+    std::vector<T> buffer(3 * this->NumPts);
+    T *newPoints = buffer.data();
+
+    int iterationNumber = 0;
+    for (T maxDist = std::numeric_limits<T>::max();
+         maxDist > conv && iterationNumber < numberOfIterations;
+         ++iterationNumber)
+    {
+      if (iterationNumber && !(iterationNumber % 5))
+      {
+        this->Self->UpdateProgress(
+          0.5 + 0.5 * iterationNumber / numberOfIterations);
+        if (this->Self->GetAbortExecute())
+        {
+          break;
+        }
+      }
+
+      MovePoints<T> move(this, points, newPoints, factor);
+      vtkSMPTools::For(0, this->NumPts, move);
+      maxDist = move.MaxDist;
+      std::swap(points, newPoints);
+    }
+
+    if (points == buffer.data())
+    {
+      std::copy(buffer.begin(), buffer.end(),
+                static_cast<T*>(newPts->GetVoidPointer(0)));
+    }
+
+    vtkDebugWithObjectMacro(this->Self, << "Performed " << iterationNumber
+                            << " smoothing passes");
+  }
+};
+
 int vtkSmoothPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -362,272 +506,284 @@ int vtkSmoothPolyDataFilter::RequestData(
   // using a subset of the attached vertices.
   //
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-
   inPts = input->GetPoints();
   conv = this->Convergence * input->GetLength();
 
-  // check vertices first. Vertices are never smoothed_--------------
-  for (inVerts=input->GetVerts(), inVerts->InitTraversal();
-  inVerts->GetNextCell(npts,pts); )
+  // The cell locator constraining the points to the source is not thread
+  // safe, so constrained smoothing is serial.
+  bool parallel = this->ParallelSmoothing && !source;
+  SMPSmoother smoother(this, inPts, CosFeatureAngle, CosEdgeAngle);
+  if (parallel)
   {
-    for (j=0; j<npts; j++)
-    {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
-    }
+    smoother.AnalyzeTopology(input);
+    Verts = nullptr;
   }
-  this->UpdateProgress(0.10);
-
-  // now check lines. Only manifold lines can be smoothed------------
-  for (inLines=input->GetLines(), inLines->InitTraversal();
-  inLines->GetNextCell(npts,pts); )
+  else
   {
-    for (j=0; j<npts; j++)
+    Verts = new vtkMeshVertex[numPts];
+
+    // check vertices first. Vertices are never smoothed_--------------
+    for (inVerts=input->GetVerts(), inVerts->InitTraversal();
+    inVerts->GetNextCell(npts,pts); )
     {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
+      for (j=0; j<npts; j++)
       {
-        if ( j == (npts-1) ) //end-of-line marked FIXED
-        {
-          Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        }
-        else if ( j == 0 ) //beginning-of-line marked FIXED
-        {
-          Verts[pts[0]].type = VTK_FIXED_VERTEX;
-          inPts->GetPoint(pts[0],x2);
-          inPts->GetPoint(pts[1],x3);
-        }
-        else //is edge vertex (unless already edge vertex!)
-        {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[j+1]);
-        }
-      } //if simple vertex
-
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
-      { //multiply connected, becomes fixed!
         Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = nullptr;
       }
-
-    } //for all points in this line
-  } //for all lines
-  this->UpdateProgress(0.25);
-
-  // now polygons and triangle strips-------------------------------
-  inPolys=input->GetPolys();
-  numPolys = inPolys->GetNumberOfCells();
-  inStrips=input->GetStrips();
-  numStrips = inStrips->GetNumberOfCells();
-
-  if ( numPolys > 0 || numStrips > 0 )
-  { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
-    inMesh = vtkPolyData::New();
-    inMesh->SetPoints(inPts);
-    inMesh->SetPolys(inPolys);
-    Mesh = inMesh;
-
-    if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
-    { // convert data to triangles
-      inMesh->SetStrips(inStrips);
-      toTris = vtkTriangleFilter::New();
-      toTris->SetInputData(inMesh);
-      toTris->Update();
-      Mesh = toTris->GetOutput();
     }
+    this->UpdateProgress(0.10);
 
-    Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
-    this->UpdateProgress(0.375);
-
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-    cellId++)
+    // now check lines. Only manifold lines can be smoothed------------
+    for (inLines=input->GetLines(), inLines->InitTraversal();
+    inLines->GetNextCell(npts,pts); )
     {
-      for (i=0; i < npts; i++)
+      for (j=0; j<npts; j++)
       {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == nullptr )
+        if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
         {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-        }
-        if ( Verts[p2].edges == nullptr )
-        {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
+          if ( j == (npts-1) ) //end-of-line marked FIXED
+          {
+            Verts[pts[j]].type = VTK_FIXED_VERTEX;
+          }
+          else if ( j == 0 ) //beginning-of-line marked FIXED
+          {
+            Verts[pts[0]].type = VTK_FIXED_VERTEX;
+            inPts->GetPoint(pts[0],x2);
+            inPts->GetPoint(pts[1],x3);
+          }
+          else //is edge vertex (unless already edge vertex!)
+          {
+            Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
+            Verts[pts[j]].edges = vtkIdList::New();
+            Verts[pts[j]].edges->SetNumberOfIds(2);
+            Verts[pts[j]].edges->SetId(0,pts[j-1]);
+            Verts[pts[j]].edges->SetId(1,pts[j+1]);
+          }
+        } //if simple vertex
+
+        else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX )
+        { //multiply connected, becomes fixed!
+          Verts[pts[j]].type = VTK_FIXED_VERTEX;
+          Verts[pts[j]].edges->Delete();
+          Verts[pts[j]].edges = nullptr;
         }
 
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
+      } //for all points in this line
+    } //for all lines
+    this->UpdateProgress(0.25);
+
+    // now polygons and triangle strips-------------------------------
+    inPolys=input->GetPolys();
+    numPolys = inPolys->GetNumberOfCells();
+    inStrips=input->GetStrips();
+    numStrips = inStrips->GetNumberOfCells();
+
+    if ( numPolys > 0 || numStrips > 0 )
+    { //build cell structure
+      vtkCellArray *polys;
+      vtkIdType cellId;
+      int numNei, nei, edge;
+      vtkIdType numNeiPts;
+      vtkIdType *neiPts;
+      double normal[3], neiNormal[3];
+      vtkIdList *neighbors;
+
+      neighbors = vtkIdList::New();
+      neighbors->Allocate(VTK_CELL_SIZE);
+
+      inMesh = vtkPolyData::New();
+      inMesh->SetPoints(inPts);
+      inMesh->SetPolys(inPolys);
+      Mesh = inMesh;
+
+      if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
+      { // convert data to triangles
+        inMesh->SetStrips(inStrips);
+        toTris = vtkTriangleFilter::New();
+        toTris->SetInputData(inMesh);
+        toTris->Update();
+        Mesh = toTris->GetOutput();
+      }
 
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-        {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-        }
+      Mesh->BuildLinks(); //to do neighborhood searching
+      polys = Mesh->GetPolys();
+      this->UpdateProgress(0.375);
 
-        else if ( numNei >= 2 )
+      for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
+      cellId++)
+      {
+        for (i=0; i < npts; i++)
         {
-          // check to make sure that this edge hasn't been marked already
-          for (j=0; j < numNei; j++)
+          p1 = pts[i];
+          p2 = pts[(i+1)%npts];
+
+          if ( Verts[p1].edges == nullptr )
           {
-            if ( neighbors->GetId(j) < cellId )
-            {
-              break;
-            }
+            Verts[p1].edges = vtkIdList::New();
+            Verts[p1].edges->Allocate(16,6);
           }
-          if ( j >= numNei )
+          if ( Verts[p2].edges == nullptr )
           {
-            edge = VTK_FEATURE_EDGE_VERTEX;
+            Verts[p2].edges = vtkIdList::New();
+            Verts[p2].edges->Allocate(16,6);
           }
-        }
 
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-        {
-          if (this->FeatureEdgeSmoothing)
+          Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
+          numNei = neighbors->GetNumberOfIds();
+
+          edge = VTK_SIMPLE_VERTEX;
+          if ( numNei == 0 )
           {
-            vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-            Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-            vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
+            edge = VTK_BOUNDARY_EDGE_VERTEX;
+          }
 
-            if (vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle)
+          else if ( numNei >= 2 )
+          {
+            // check to make sure that this edge hasn't been marked already
+            for (j=0; j < numNei; j++)
+            {
+              if ( neighbors->GetId(j) < cellId )
+              {
+                break;
+              }
+            }
+            if ( j >= numNei )
             {
               edge = VTK_FEATURE_EDGE_VERTEX;
             }
           }
-        }
-        else // a visited edge; skip rest of analysis
-        {
-          continue;
-        }
 
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-        }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+          else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
+          {
+            if (this->FeatureEdgeSmoothing)
+            {
+              vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
+              Mesh->GetCellPoints(nei,numNeiPts,neiPts);
+              vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
+
+              if (vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle)
+              {
+                edge = VTK_FEATURE_EDGE_VERTEX;
+              }
+            }
+          }
+          else // a visited edge; skip rest of analysis
           {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
+            continue;
           }
-        }
 
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-        }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+          if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
+          {
+            Verts[p1].edges->Reset();
+            Verts[p1].edges->InsertNextId(p2);
+            Verts[p1].type = edge;
+          }
+          else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
+          (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
+          (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
+          {
+            Verts[p1].edges->InsertNextId(p2);
+            if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+            {
+              Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
+            }
+          }
+
+          if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
           {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
+            Verts[p2].edges->Reset();
+            Verts[p2].edges->InsertNextId(p1);
+            Verts[p2].type = edge;
+          }
+          else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
+          (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
+          (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
+          {
+            Verts[p2].edges->InsertNextId(p1);
+            if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+            {
+              Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
+            }
           }
         }
       }
-    }
 
-    inMesh->Delete();
-    if (toTris) {toTris->Delete();}
+      inMesh->Delete();
+      if (toTris) {toTris->Delete();}
 
-    neighbors->Delete();
-  }//if strips or polys
+      neighbors->Delete();
+    }//if strips or polys
 
-  this->UpdateProgress(0.50);
+    this->UpdateProgress(0.50);
 
-  //post-process edge vertices to make sure we can smooth them
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
-    {
-      numSimple++;
-    }
-
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
+    //post-process edge vertices to make sure we can smooth them
+    for (i=0; i<numPts; i++)
     {
-      numFixed++;
-    }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-    Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-    { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
+      if ( Verts[i].type == VTK_SIMPLE_VERTEX )
       {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
+        numSimple++;
       }
 
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
+      else if ( Verts[i].type == VTK_FIXED_VERTEX )
       {
-        Verts[i].type = VTK_FIXED_VERTEX;
         numFixed++;
       }
 
-      else //check angle between edges
-      {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
+      else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
+      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
+      { //see how many edges; if two, what the angle is
 
-        for (k=0; k<3; k++)
+        if ( !this->BoundarySmoothing &&
+        Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
         {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
+          Verts[i].type = VTK_FIXED_VERTEX;
+          numBEdges++;
         }
-        if ( vtkMath::Normalize(l1) >= 0.0 &&
-             vtkMath::Normalize(l2) >= 0.0 &&
-             vtkMath::Dot(l1,l2) < CosEdgeAngle)
+
+        else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
         {
-          numFixed++;
           Verts[i].type = VTK_FIXED_VERTEX;
+          numFixed++;
         }
-        else
+
+        else //check angle between edges
         {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
+          inPts->GetPoint(Verts[i].edges->GetId(0),x1);
+          inPts->GetPoint(i,x2);
+          inPts->GetPoint(Verts[i].edges->GetId(1),x3);
+
+          for (k=0; k<3; k++)
+          {
+            l1[k] = x2[k] - x1[k];
+            l2[k] = x3[k] - x2[k];
+          }
+          if ( vtkMath::Normalize(l1) >= 0.0 &&
+               vtkMath::Normalize(l2) >= 0.0 &&
+               vtkMath::Dot(l1,l2) < CosEdgeAngle)
           {
-            numFEdges++;
+            numFixed++;
+            Verts[i].type = VTK_FIXED_VERTEX;
           }
           else
           {
-            numBEdges++;
+            if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
+            {
+              numFEdges++;
+            }
+            else
+            {
+              numBEdges++;
+            }
           }
-        }
-      }//if along edge
-    }//if edge vertex
-  }//for all points
+        }//if along edge
+      }//if edge vertex
+    }//for all points
 
-  vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
-                << numFEdges << " feature edge vertices\n\t"
-                << numBEdges << " boundary edge vertices\n\t"
-                << numFixed << " fixed vertices\n\t");
+    vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
+                  << numFEdges << " feature edge vertices\n\t"
+                  << numBEdges << " boundary edge vertices\n\t"
+                  << numFixed << " fixed vertices\n\t");
+  }
 
   vtkDebugMacro(<<"Beginning smoothing iterations...");
 
@@ -679,7 +835,21 @@ int vtkSmoothPolyDataFilter::RequestData(
     }
   }
 
-  if (newPts->GetDataType() == VTK_DOUBLE)
+  if (parallel)
+  {
+    if (newPts->GetDataType() == VTK_DOUBLE)
+    {
+      smoother.Smooth<double>(newPts, this->NumberOfIterations,
+                              this->RelaxationFactor, conv);
+    }
+    else
+    {
+      smoother.Smooth<float>(newPts, this->NumberOfIterations,
+                             static_cast<float>(this->RelaxationFactor),
+                             static_cast<float>(conv));
+    }
+  }
+  else if (newPts->GetDataType() == VTK_DOUBLE)
   {
     vtkSPDF_InternalParams<double> params = { this, this->NumberOfIterations, newPts,
                                               this->RelaxationFactor, conv, numPts,
@@ -754,7 +924,7 @@ int vtkSmoothPolyDataFilter::RequestData(
   output->SetStrips(input->GetStrips());
 
   //free up connectivity storage
-  for (i=0; i<numPts; i++)
+  for (i=0; Verts && i<numPts; i++)
   {
     if ( Verts[i].edges != nullptr )
     {
@@ -805,4 +975,5 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Smoothing: " << (this->ParallelSmoothing ? "On\n" : "Off\n");
 }
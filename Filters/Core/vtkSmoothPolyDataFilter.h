@@ -215,6 +215,23 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the mesh is smoothed in
+   * parallel with vtkSMPTools. If on, the edges of the polygons are
+   * classified and the vertices connected to each vertex are gathered into
+   * compressed rows in parallel, and each iteration then moves all the
+   * points from their positions at the previous iteration (Jacobi
+   * iterations) instead of from the points already moved during the
+   * iteration (Gauss-Seidel iterations), so the result differs slightly from
+   * the serial one. Smoothing constrained by a Source is always serial. By
+   * default, parallel smoothing is off.
+   */
+  vtkSetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkGetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkBooleanMacro(ParallelSmoothing,vtkTypeBool);
+  //@}
+
 protected:
   vtkSmoothPolyDataFilter();
   ~vtkSmoothPolyDataFilter() override {}
@@ -232,8 +249,12 @@ protected:
   vtkTypeBool GenerateErrorScalars;
   vtkTypeBool GenerateErrorVectors;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelSmoothing;
 
   vtkSmoothPoints *SmoothPoints;
+
+  // Threaded smoothing, see vtkSmoothPolyDataFilter.cxx.
+  struct SMPSmoother;
 private:
   vtkSmoothPolyDataFilter(const vtkSmoothPolyDataFilter&) = delete;
   void operator=(const vtkSmoothPolyDataFilter&) = delete;
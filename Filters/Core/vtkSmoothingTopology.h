@@ -0,0 +1,442 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSmoothingTopology.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Parallel analysis of the mesh topology shared by the threaded paths of
+// vtkSmoothPolyDataFilter and vtkWindowedSincPolyDataFilter. This header is
+// private to the module.
+//
+// The vertices and lines are analyzed serially, and the edges of the
+// polygons are classified in parallel. Each vertex then replays the edges of
+// its polygons, through the links, in the order of the serial traversal to
+// find its type and its connected vertices, which are counted then gathered
+// into compressed rows.
+
+#ifndef vtkSmoothingTopology_h
+#define vtkSmoothingTopology_h
+
+#include "vtkAlgorithm.h"
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolygon.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkTriangleFilter.h"
+
+#include <vector>
+
+#define VTK_SIMPLE_VERTEX 0
+#define VTK_FIXED_VERTEX 1
+#define VTK_FEATURE_EDGE_VERTEX 2
+#define VTK_BOUNDARY_EDGE_VERTEX 3
+
+struct vtkSmoothingTopology
+{
+  vtkAlgorithm *Filter;
+  vtkPoints *InPts;
+  vtkIdType NumPts;
+  double CosFeatureAngle;
+  double CosEdgeAngle;
+
+  // The options of the filter: whether feature edges and boundaries are
+  // smoothed, whether all the polygons of a non-manifold edge mark it, and
+  // whether the closed lines keep their first point movable.
+  bool FeatureEdgeSmoothing;
+  bool BoundarySmoothing;
+  bool NonManifoldSmoothing;
+  bool ClosedLoops;
+
+  // The type of each vertex, and the two connected vertices of the vertices
+  // inside a line.
+  std::vector<char> Types;
+  std::vector<vtkIdType> LineEdges;
+
+  // The polygons (the triangles of the strips included), and the type of
+  // each of their edges in the layout of their connectivity: the type given
+  // to its vertices, or -1 if the edge is skipped.
+  vtkSmartPointer<vtkPolyData> Mesh;
+  vtkIdType *Connectivity;
+  std::vector<signed char> EdgeTypes;
+  vtkSMPThreadLocalObject<vtkIdList> CellNeighbors;
+
+  // The vertices connected to vertex i are
+  // Neighbors[Offsets[i]] ... Neighbors[Offsets[i + 1] - 1].
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Neighbors;
+
+  vtkSmoothingTopology(vtkAlgorithm *filter, vtkPoints *inPts,
+                       double cosFeatureAngle, double cosEdgeAngle,
+                       bool featureEdgeSmoothing, bool boundarySmoothing,
+                       bool nonManifoldSmoothing, bool closedLoops) :
+    Filter(filter), InPts(inPts), NumPts(inPts->GetNumberOfPoints()),
+    CosFeatureAngle(cosFeatureAngle), CosEdgeAngle(cosEdgeAngle),
+    FeatureEdgeSmoothing(featureEdgeSmoothing),
+    BoundarySmoothing(boundarySmoothing),
+    NonManifoldSmoothing(nonManifoldSmoothing), ClosedLoops(closedLoops),
+    Connectivity(nullptr)
+  {
+  }
+
+  struct ClassifyEdges
+  {
+    vtkSmoothingTopology *Topology;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkPolyData *mesh = this->Topology->Mesh;
+      vtkIdList *neighbors = this->Topology->CellNeighbors.Local();
+      vtkIdType npts, *pts, numNeiPts, *neiPts;
+      double normal[3], neiNormal[3];
+
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        mesh->GetCellPoints(cellId, npts, pts);
+        signed char *edgeTypes = this->Topology->EdgeTypes.data() +
+          (pts - this->Topology->Connectivity);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          mesh->GetCellEdgeNeighbors(cellId, pts[i], pts[(i + 1) % npts],
+                                     neighbors);
+          vtkIdType numNei = neighbors->GetNumberOfIds();
+
+          signed char edge = VTK_SIMPLE_VERTEX;
+          if (numNei == 0)
+          {
+            edge = VTK_BOUNDARY_EDGE_VERTEX;
+          }
+          else if (numNei >= 2)
+          {
+            // non-manifold case, only the first polygon marks the edge
+            // unless non-manifold smoothing is on
+            vtkIdType j;
+            for (j = 0; j < numNei && neighbors->GetId(j) > cellId; ++j)
+            {
+            }
+            if (!this->Topology->NonManifoldSmoothing && j >= numNei)
+            {
+              edge = VTK_FEATURE_EDGE_VERTEX;
+            }
+          }
+          else if (numNei == 1 && neighbors->GetId(0) > cellId)
+          {
+            if (this->Topology->FeatureEdgeSmoothing)
+            {
+              vtkPolygon::ComputeNormal(this->Topology->InPts, npts, pts,
+                                        normal);
+              mesh->GetCellPoints(neighbors->GetId(0), numNeiPts, neiPts);
+              vtkPolygon::ComputeNormal(this->Topology->InPts, numNeiPts,
+                                        neiPts, neiNormal);
+              if (vtkMath::Dot(normal, neiNormal) <=
+                  this->Topology->CosFeatureAngle)
+              {
+                edge = VTK_FEATURE_EDGE_VERTEX;
+              }
+            }
+          }
+          else // a visited edge
+          {
+            edge = -1;
+          }
+          edgeTypes[i] = edge;
+        }
+      }
+    }
+  };
+
+  // Update the type and the connected vertices of a vertex with one of the
+  // edges using it, as the serial analysis does.
+  static void AddEdge(signed char edge, vtkIdType ptId, char &type,
+                      vtkIdType &numNei, vtkIdType *neighbors)
+  {
+    if (edge && type == VTK_SIMPLE_VERTEX)
+    {
+      numNei = 0;
+      type = edge;
+    }
+    else if ((edge && type == VTK_BOUNDARY_EDGE_VERTEX) ||
+             (edge && type == VTK_FEATURE_EDGE_VERTEX) ||
+             (!edge && type == VTK_SIMPLE_VERTEX))
+    {
+      if (type && edge == VTK_BOUNDARY_EDGE_VERTEX)
+      {
+        type = VTK_BOUNDARY_EDGE_VERTEX;
+      }
+    }
+    else
+    {
+      return;
+    }
+    if (neighbors)
+    {
+      neighbors[numNei] = ptId;
+    }
+    ++numNei;
+  }
+
+  // Compute the type of a vertex before the post-processing of the edge
+  // vertices, and its number of connected vertices, written to neighbors
+  // unless it is null.
+  vtkIdType GatherNeighbors(vtkIdType ptId, char &type, vtkIdType *neighbors)
+  {
+    type = this->Types[ptId];
+    if (type == VTK_FIXED_VERTEX)
+    {
+      return 0;
+    }
+
+    vtkIdType numNei = 0;
+    if (type == VTK_FEATURE_EDGE_VERTEX) // inside a line
+    {
+      if (neighbors)
+      {
+        neighbors[0] = this->LineEdges[2 * ptId];
+        neighbors[1] = this->LineEdges[2 * ptId + 1];
+      }
+      numNei = 2;
+    }
+    if (!this->Mesh)
+    {
+      return numNei;
+    }
+
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    this->Mesh->GetPointCells(ptId, ncells, cells);
+    for (unsigned short i = 0; i < ncells; ++i)
+    {
+      // a polygon using the vertex several times is linked as many times
+      if (i > 0 && cells[i] == cells[i - 1])
+      {
+        continue;
+      }
+      this->Mesh->GetCellPoints(cells[i], npts, pts);
+      const signed char *edgeTypes = this->EdgeTypes.data() +
+        (pts - this->Connectivity);
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        if (edgeTypes[j] < 0)
+        {
+          continue;
+        }
+        vtkIdType p1 = pts[j];
+        vtkIdType p2 = pts[(j + 1) % npts];
+        if (p1 == ptId)
+        {
+          AddEdge(edgeTypes[j], p2, type, numNei, neighbors);
+        }
+        if (p2 == ptId)
+        {
+          AddEdge(edgeTypes[j], p1, type, numNei, neighbors);
+        }
+      }
+    }
+    return numNei;
+  }
+
+  struct CountNeighbors
+  {
+    vtkSmoothingTopology *Topology;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      char type;
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        this->Topology->Offsets[ptId] =
+          this->Topology->GatherNeighbors(ptId, type, nullptr);
+      }
+    }
+  };
+
+  // Gather the connected vertices, then fix the edge vertices that cannot be
+  // smoothed.
+  struct ClassifyVertices
+  {
+    vtkSmoothingTopology *Topology;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkPoints *inPts = this->Topology->InPts;
+      double x1[3], x2[3], x3[3], l1[3], l2[3];
+      char type;
+
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        vtkIdType *neighbors = this->Topology->Neighbors.data() +
+          this->Topology->Offsets[ptId];
+        vtkIdType numNei =
+          this->Topology->GatherNeighbors(ptId, type, neighbors);
+
+        if (type == VTK_FEATURE_EDGE_VERTEX ||
+            type == VTK_BOUNDARY_EDGE_VERTEX)
+        {
+          if (!this->Topology->BoundarySmoothing &&
+              type == VTK_BOUNDARY_EDGE_VERTEX)
+          {
+            type = VTK_FIXED_VERTEX;
+          }
+          else if (numNei != 2)
+          {
+            type = VTK_FIXED_VERTEX;
+          }
+          else //check angle between edges
+          {
+            inPts->GetPoint(neighbors[0], x1);
+            inPts->GetPoint(ptId, x2);
+            inPts->GetPoint(neighbors[1], x3);
+            for (int k = 0; k < 3; ++k)
+            {
+              l1[k] = x2[k] - x1[k];
+              l2[k] = x3[k] - x2[k];
+            }
+            if (vtkMath::Normalize(l1) >= 0.0 &&
+                vtkMath::Normalize(l2) >= 0.0 &&
+                vtkMath::Dot(l1, l2) < this->Topology->CosEdgeAngle)
+            {
+              type = VTK_FIXED_VERTEX;
+            }
+          }
+        }
+        this->Topology->Types[ptId] = type;
+      }
+    }
+  };
+
+  // Classify the vertices and gather their connected vertices.
+  void AnalyzeTopology(vtkPolyData *input)
+  {
+    vtkIdType npts = 0;
+    vtkIdType *pts = nullptr;
+    this->Types.assign(this->NumPts, VTK_SIMPLE_VERTEX);
+
+    // check vertices first. Vertices are never smoothed
+    vtkCellArray *inVerts = input->GetVerts();
+    for (inVerts->InitTraversal(); inVerts->GetNextCell(npts, pts);)
+    {
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        this->Types[pts[j]] = VTK_FIXED_VERTEX;
+      }
+    }
+    this->Filter->UpdateProgress(0.10);
+
+    // now check lines. Only manifold lines can be smoothed
+    vtkCellArray *inLines = input->GetLines();
+    if (inLines->GetNumberOfCells() > 0)
+    {
+      this->LineEdges.resize(2 * this->NumPts);
+    }
+    for (inLines->InitTraversal(); inLines->GetNextCell(npts, pts);)
+    {
+      // Check for closed loop which are treated specially. Basically the
+      // last point is ignored (set to fixed).
+      bool closedLoop = (this->ClosedLoops && pts[0] == pts[npts - 1] &&
+                         npts > 3);
+
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        char &type = this->Types[pts[j]];
+        if (type == VTK_SIMPLE_VERTEX)
+        {
+          // First point
+          if (j == 0)
+          {
+            if (!closedLoop)
+            {
+              type = VTK_FIXED_VERTEX;
+            }
+            else
+            {
+              type = VTK_FEATURE_EDGE_VERTEX;
+              this->LineEdges[2 * pts[0]] = pts[npts - 2];
+              this->LineEdges[2 * pts[0] + 1] = pts[1];
+            }
+          }
+          // Last point
+          else if (j == (npts - 1) && !closedLoop)
+          {
+            type = VTK_FIXED_VERTEX;
+          }
+          // Inbetween point
+          else
+          {
+            type = VTK_FEATURE_EDGE_VERTEX;
+            this->LineEdges[2 * pts[j]] = pts[j - 1];
+            this->LineEdges[2 * pts[j] + 1] =
+              pts[(closedLoop && j == (npts - 2) ? 0 : (j + 1))];
+          }
+        }
+        // Vertex has been visited before, need to fix it. Special case
+        // when working on closed loop.
+        else if (type == VTK_FEATURE_EDGE_VERTEX &&
+                 !(closedLoop && j == (npts - 1)))
+        {
+          type = VTK_FIXED_VERTEX;
+        }
+      }
+    }
+    this->Filter->UpdateProgress(0.25);
+
+    // now polygons and triangle strips
+    vtkCellArray *inPolys = input->GetPolys();
+    vtkCellArray *inStrips = input->GetStrips();
+    if (inPolys->GetNumberOfCells() > 0 || inStrips->GetNumberOfCells() > 0)
+    {
+      vtkNew<vtkPolyData> inMesh;
+      inMesh->SetPoints(this->InPts);
+      inMesh->SetPolys(inPolys);
+      this->Mesh = inMesh;
+      if (inStrips->GetNumberOfCells() > 0)
+      { // convert data to triangles
+        inMesh->SetStrips(inStrips);
+        vtkNew<vtkTriangleFilter> toTris;
+        toTris->SetInputData(inMesh);
+        toTris->Update();
+        this->Mesh = toTris->GetOutput();
+      }
+
+      // The links sort the polygons of each vertex in the serial order.
+      this->Mesh->BuildLinks();
+      vtkCellArray *polys = this->Mesh->GetPolys();
+      this->Connectivity = polys->GetPointer();
+      this->EdgeTypes.resize(polys->GetNumberOfConnectivityEntries());
+      this->Filter->UpdateProgress(0.375);
+
+      ClassifyEdges classify = { this };
+      vtkSMPTools::For(0, polys->GetNumberOfCells(), classify);
+    }
+    this->Filter->UpdateProgress(0.50);
+
+    this->Offsets.resize(this->NumPts + 1);
+    CountNeighbors count = { this };
+    vtkSMPTools::For(0, this->NumPts, count);
+    this->Offsets[this->NumPts] = vtkSMPTools::ExclusiveScan(
+      this->Offsets.begin(), this->Offsets.begin() + this->NumPts,
+      this->Offsets.begin(), static_cast<vtkIdType>(0));
+    this->Neighbors.resize(this->Offsets[this->NumPts]);
+    ClassifyVertices classifyVertices = { this };
+    vtkSMPTools::For(0, this->NumPts, classifyVertices);
+
+    this->Mesh = nullptr;
+    this->EdgeTypes.clear();
+    this->EdgeTypes.shrink_to_fit();
+  }
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSmoothingTopology.h
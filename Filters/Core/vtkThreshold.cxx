@@ -15,17 +15,30 @@
 #include "vtkThreshold.h"
 
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
@@ -90,6 +103,365 @@ void vtkThreshold::ThresholdBetween(double lower, double upper)
   }
 }
 
+//----------------------------------------------------------------------------
+// Threaded extraction. The cells are split into fixed size batches so that
+// the output is independent of the number of threads and of the scheduling:
+// output cells keep the input order and output points are numbered in the
+// order they are first used by the surviving cells, exactly as the serial
+// algorithm does.
+struct vtkThreshold::SMPExtractor
+{
+  // Number of cells processed as a unit.
+  static const vtkIdType BatchSize = 1000;
+
+  vtkThreshold *Self;
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  bool UsePointScalars;
+  vtkPoints *NewPoints;
+  vtkUnstructuredGrid *Output;
+
+  vtkIdType NumPts;
+  vtkIdType NumCells;
+  vtkIdType NumBatches;
+
+  // Per cell flag, set when the cell survives.
+  std::vector<unsigned char> KeepCells;
+  // Per batch counts, turned into offsets by prefix sums.
+  std::vector<vtkIdType> BatchCells;
+  std::vector<vtkIdType> BatchConnectivity;
+  std::vector<vtkIdType> BatchPoints;
+  // First batch using each point (NumBatches when unused), and the map from
+  // input to output point ids.
+  std::unique_ptr<std::atomic<vtkIdType>[]> PointBatch;
+  std::vector<vtkIdType> PointMap;
+
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  // Output arrays
+  vtkIdType *Connectivity;
+  vtkIdType *Locations;
+  unsigned char *Types;
+
+  SMPExtractor(vtkThreshold *self, vtkDataSet *input, vtkDataArray *scalars,
+               bool usePointScalars, vtkPoints *newPoints,
+               vtkUnstructuredGrid *output) :
+    Self(self), Input(input), Scalars(scalars),
+    UsePointScalars(usePointScalars), NewPoints(newPoints), Output(output),
+    Connectivity(nullptr), Locations(nullptr), Types(nullptr)
+  {
+    this->NumPts = input->GetNumberOfPoints();
+    this->NumCells = input->GetNumberOfCells();
+    this->NumBatches = (this->NumCells + BatchSize - 1) / BatchSize;
+  }
+
+  // Exclusive prefix sum, returns the total.
+  static vtkIdType PrefixSum(std::vector<vtkIdType> &counts)
+  {
+    vtkIdType total = 0;
+    for (std::vector<vtkIdType>::iterator it = counts.begin();
+         it != counts.end(); ++it)
+    {
+      vtkIdType count = *it;
+      *it = total;
+      total += count;
+    }
+    return total;
+  }
+
+  // Reset the per point information.
+  struct InitializePoints
+  {
+    SMPExtractor *Extractor;
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      const vtkIdType numBatches = this->Extractor->NumBatches;
+      for (; ptId < endPtId; ++ptId)
+      {
+        this->Extractor->PointBatch[ptId].store(numBatches,
+                                                std::memory_order_relaxed);
+        this->Extractor->PointMap[ptId] = -1;
+      }
+    }
+  };
+
+  // Pass 1: evaluate the cells, count the surviving cells and connectivity
+  // of each batch, and record the first batch using each point.
+  struct CountCells
+  {
+    SMPExtractor *Extractor;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPExtractor *ex = this->Extractor;
+      vtkIdList *cellPts = ex->CellPts.Local();
+      for (; batch < endBatch; ++batch)
+      {
+        vtkIdType numCells = 0, connSize = 0;
+        vtkIdType cellId = batch * BatchSize;
+        const vtkIdType endCellId = std::min(cellId + BatchSize, ex->NumCells);
+        for (; cellId < endCellId; ++cellId)
+        {
+          ex->Input->GetCellPoints(cellId, cellPts);
+          const vtkIdType npts = cellPts->GetNumberOfIds();
+          // Blanked cells of structured grids report their points but are
+          // empty cells.
+          if ( npts <= 0 ||
+               ex->Input->GetCellType(cellId) == VTK_EMPTY_CELL ||
+               !ex->Self->KeepCell(ex->Scalars, cellId, cellPts,
+                                   ex->UsePointScalars) )
+          {
+            ex->KeepCells[cellId] = 0;
+            continue;
+          }
+          ex->KeepCells[cellId] = 1;
+          ++numCells;
+          connSize += npts + 1;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            std::atomic<vtkIdType> &owner = ex->PointBatch[cellPts->GetId(i)];
+            vtkIdType current = owner.load(std::memory_order_relaxed);
+            while ( batch < current &&
+                    !owner.compare_exchange_weak(current, batch,
+                                                 std::memory_order_relaxed) )
+            {
+            }
+          }
+        }
+        ex->BatchCells[batch] = numCells;
+        ex->BatchConnectivity[batch] = connSize;
+      }
+    }
+  };
+
+  // Pass 2: number the points owned by each batch in order of first use.
+  struct CountPoints
+  {
+    SMPExtractor *Extractor;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPExtractor *ex = this->Extractor;
+      vtkIdList *cellPts = ex->CellPts.Local();
+      for (; batch < endBatch; ++batch)
+      {
+        vtkIdType numPts = 0;
+        vtkIdType cellId = batch * BatchSize;
+        const vtkIdType endCellId = std::min(cellId + BatchSize, ex->NumCells);
+        for (; cellId < endCellId; ++cellId)
+        {
+          if ( !ex->KeepCells[cellId] )
+          {
+            continue;
+          }
+          ex->Input->GetCellPoints(cellId, cellPts);
+          const vtkIdType npts = cellPts->GetNumberOfIds();
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            const vtkIdType ptId = cellPts->GetId(i);
+            if ( ex->PointBatch[ptId].load(std::memory_order_relaxed) == batch &&
+                 ex->PointMap[ptId] < 0 )
+            {
+              ex->PointMap[ptId] = numPts++;
+            }
+          }
+        }
+        ex->BatchPoints[batch] = numPts;
+      }
+    }
+  };
+
+  // Pass 3: finalize the point map, copy the points and the point data.
+  struct CopyPoints
+  {
+    SMPExtractor *Extractor;
+    void operator()(vtkIdType ptId, vtkIdType endPtId)
+    {
+      SMPExtractor *ex = this->Extractor;
+      vtkPointData *inPD = ex->Input->GetPointData();
+      vtkPointData *outPD = ex->Output->GetPointData();
+      double x[3];
+      for (; ptId < endPtId; ++ptId)
+      {
+        const vtkIdType batch = ex->PointBatch[ptId].load(std::memory_order_relaxed);
+        if ( batch >= ex->NumBatches )
+        {
+          continue;
+        }
+        const vtkIdType newId = ex->PointMap[ptId] + ex->BatchPoints[batch];
+        ex->PointMap[ptId] = newId;
+        ex->Input->GetPoint(ptId, x);
+        ex->NewPoints->SetPoint(newId, x);
+        outPD->CopyData(inPD, ptId, newId);
+      }
+    }
+  };
+
+  // Pass 4: generate the output cells and copy the cell data.
+  struct CopyCells
+  {
+    SMPExtractor *Extractor;
+    void operator()(vtkIdType batch, vtkIdType endBatch)
+    {
+      SMPExtractor *ex = this->Extractor;
+      vtkIdList *cellPts = ex->CellPts.Local();
+      vtkCellData *inCD = ex->Input->GetCellData();
+      vtkCellData *outCD = ex->Output->GetCellData();
+      for (; batch < endBatch; ++batch)
+      {
+        vtkIdType newCellId = ex->BatchCells[batch];
+        vtkIdType loc = ex->BatchConnectivity[batch];
+        vtkIdType cellId = batch * BatchSize;
+        const vtkIdType endCellId = std::min(cellId + BatchSize, ex->NumCells);
+        for (; cellId < endCellId; ++cellId)
+        {
+          if ( !ex->KeepCells[cellId] )
+          {
+            continue;
+          }
+          ex->Input->GetCellPoints(cellId, cellPts);
+          const vtkIdType npts = cellPts->GetNumberOfIds();
+          ex->Types[newCellId] =
+            static_cast<unsigned char>(ex->Input->GetCellType(cellId));
+          ex->Locations[newCellId] = loc;
+          ex->Connectivity[loc++] = npts;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            ex->Connectivity[loc++] = ex->PointMap[cellPts->GetId(i)];
+          }
+          outCD->CopyData(inCD, cellId, newCellId++);
+        }
+      }
+    }
+  };
+
+  void Execute()
+  {
+    // Make sure the input is ready for concurrent access.
+    vtkPolyData *polyData = vtkPolyData::SafeDownCast(this->Input);
+    if ( polyData && polyData->NeedToBuildCells() )
+    {
+      polyData->BuildCells();
+    }
+
+    this->KeepCells.resize(this->NumCells);
+    this->BatchCells.resize(this->NumBatches);
+    this->BatchConnectivity.resize(this->NumBatches);
+    this->BatchPoints.resize(this->NumBatches);
+    this->PointBatch.reset(new std::atomic<vtkIdType>[this->NumPts]);
+    this->PointMap.resize(this->NumPts);
+
+    InitializePoints initializePoints = { this };
+    vtkSMPTools::For(0, this->NumPts, initializePoints);
+    CountCells countCells = { this };
+    vtkSMPTools::For(0, this->NumBatches, countCells);
+    const vtkIdType numNewCells = PrefixSum(this->BatchCells);
+    const vtkIdType connSize = PrefixSum(this->BatchConnectivity);
+
+    CountPoints countPoints = { this };
+    vtkSMPTools::For(0, this->NumBatches, countPoints);
+    const vtkIdType numNewPts = PrefixSum(this->BatchPoints);
+
+    // Size the output; attribute data is then filled in place.
+    this->NewPoints->SetNumberOfPoints(numNewPts);
+    this->Output->GetPointData()->SetNumberOfTuples(numNewPts);
+    CopyPoints copyPoints = { this };
+    vtkSMPTools::For(0, this->NumPts, copyPoints);
+
+    vtkNew<vtkCellArray> cells;
+    this->Connectivity = cells->WritePointer(numNewCells, connSize);
+    vtkNew<vtkUnsignedCharArray> types;
+    types->SetNumberOfValues(numNewCells);
+    this->Types = types->GetPointer(0);
+    vtkNew<vtkIdTypeArray> locations;
+    locations->SetNumberOfValues(numNewCells);
+    this->Locations = locations->GetPointer(0);
+    this->Output->GetCellData()->SetNumberOfTuples(numNewCells);
+    CopyCells copyCells = { this };
+    vtkSMPTools::For(0, this->NumBatches, copyCells);
+
+    this->Output->SetCells(types, locations, cells, nullptr, nullptr);
+  }
+};
+
+//----------------------------------------------------------------------------
+// The threaded extraction needs thread safe cell queries (which excludes the
+// face streams of polyhedra) and attribute arrays that may be filled
+// concurrently once sized (which excludes string and bit arrays).
+bool vtkThreshold::CanExtractInParallel(vtkDataSet *input)
+{
+  vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if ( ugrid )
+  {
+    if ( ugrid->GetFaces() )
+    {
+      return false;
+    }
+  }
+  else if ( !vtkPolyData::SafeDownCast(input) &&
+            !vtkImageData::SafeDownCast(input) &&
+            !vtkRectilinearGrid::SafeDownCast(input) &&
+            !vtkStructuredGrid::SafeDownCast(input) )
+  {
+    return false;
+  }
+
+  vtkDataSetAttributes *attributes[2] =
+    { input->GetPointData(), input->GetCellData() };
+  for (int a = 0; a < 2; ++a)
+  {
+    for (int i = 0; i < attributes[a]->GetNumberOfArrays(); ++i)
+    {
+      vtkDataArray *array =
+        vtkArrayDownCast<vtkDataArray>(attributes[a]->GetAbstractArray(i));
+      if ( !array || array->GetDataType() == VTK_BIT )
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkThreshold::KeepCell(vtkDataArray *scalars, vtkIdType cellId,
+                           vtkIdList *cellPts, bool usePointScalars)
+{
+  int keepCell, i;
+  int numCellPts = static_cast<int>(cellPts->GetNumberOfIds());
+
+  if ( usePointScalars )
+  {
+    if (this->AllScalars)
+    {
+      keepCell = 1;
+      for ( i=0; keepCell && (i < numCellPts); i++)
+      {
+        keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+      }
+    }
+    else
+    {
+      if(!this->UseContinuousCellRange)
+      {
+        keepCell = 0;
+        for ( i=0; (!keepCell) && (i < numCellPts); i++)
+        {
+          keepCell = this->EvaluateComponents( scalars, cellPts->GetId(i) );
+        }
+      }
+      else
+      {
+        keepCell = this->EvaluateCell(scalars, cellPts, numCellPts);
+      }
+    }
+  }
+  else //use cell scalars
+  {
+    keepCell = this->EvaluateComponents( scalars, cellId );
+  }
+  return keepCell;
+}
+
+//----------------------------------------------------------------------------
 int vtkThreshold::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -139,7 +511,6 @@ int vtkThreshold::RequestData(
   outCD->CopyAllocate(cd);
 
   numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
 
   newPoints = vtkPoints::New();
 
@@ -165,6 +536,28 @@ int vtkThreshold::RequestData(
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
+  // are we using pointScalars?
+  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
+  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+
+  if ( this->CanExtractInParallel(input) )
+  {
+    SMPExtractor extractor(this, input, inScalars, usePointScalars,
+                           newPoints, output);
+    extractor.Execute();
+
+    vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
+                  << " number of cells.");
+
+    output->SetPoints(newPoints);
+    newPoints->Delete();
+
+    output->Squeeze();
+
+    return 1;
+  }
+
+  output->Allocate(input->GetNumberOfCells());
   newPoints->Allocate(numPts);
 
   pointMap = vtkIdList::New(); //maps old point ids into new
@@ -176,49 +569,13 @@ int vtkThreshold::RequestData(
 
   newCellPts = vtkIdList::New();
 
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
-
   // Check that the scalars of each cell satisfy the threshold criterion
   for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
   {
     cell = input->GetCell(cellId);
     cellPts = cell->GetPointIds();
     numCellPts = cell->GetNumberOfPoints();
-
-    if ( usePointScalars )
-    {
-      if (this->AllScalars)
-      {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
-      }
-      else
-      {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
-      }
-    }
-    else //use cell scalars
-    {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
-    }
+    keepCell = this->KeepCell(inScalars, cellId, cellPts, usePointScalars);
 
     if (  numCellPts > 0 && keepCell )
     {
@@ -30,6 +30,14 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * The extraction is threaded with vtkSMPTools for unstructured grids (without
+ * polyhedra), polygonal data and structured datasets whose attributes are
+ * all vtkDataArrays. Cells are processed in batches: a first pass counts the
+ * surviving cells and points of each batch, prefix sums over the batches give
+ * the output locations, and later passes fill the output arrays and copy the
+ * attributes. The output is identical to the serial extraction, which is
+ * used for all other inputs.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
 */
@@ -212,6 +220,14 @@ protected:
   int EvaluateComponents( vtkDataArray *scalars, vtkIdType id );
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
+
+  // Apply the threshold criterion to a cell given its point ids.
+  int KeepCell( vtkDataArray *scalars, vtkIdType cellId, vtkIdList* cellPts,
+                bool usePointScalars );
+
+  // Threaded extraction, see vtkThreshold.cxx.
+  struct SMPExtractor;
+  bool CanExtractInParallel( vtkDataSet *input );
 private:
   vtkThreshold(const vtkThreshold&) = delete;
   void operator=(const vtkThreshold&) = delete;
@@ -24,6 +24,8 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
+#include "vtkSmoothingTopology.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 
@@ -50,6 +52,8 @@ vtkWindowedSincPolyDataFilter::vtkWindowedSincPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->NormalizeCoordinates = 0;
+
+  this->ParallelSmoothing = 0;
 }
 
 #define VTK_SIMPLE_VERTEX 0
@@ -64,6 +68,204 @@ typedef struct _vtkMeshVertex
   vtkIdList *edges; // connected edges (list of connected point ids)
 } vtkMeshVertex, *vtkMeshVertexPtr;
 
+//-----------------------------------------------------------------------------
+// Smooth the mesh with vtkSMPTools. As in vtkSmoothPolyDataFilter, the types
+// and the connected vertices of the vertices are found by
+// vtkSmoothingTopology, with the non-manifold and closed loop handling of
+// this filter. Each iteration of the Chebyshev filter only
+// reads the points of the previous iterations, so the points are updated in
+// parallel with the same results as the serial iterations.
+struct vtkWindowedSincPolyDataFilter::SMPSmoother : public vtkSmoothingTopology
+{
+  vtkWindowedSincPolyDataFilter *Self;
+
+  SMPSmoother(vtkWindowedSincPolyDataFilter *self, vtkPoints *inPts,
+              double cosFeatureAngle, double cosEdgeAngle) :
+    vtkSmoothingTopology(self, inPts, cosFeatureAngle, cosEdgeAngle,
+                         self->FeatureEdgeSmoothing != 0,
+                         self->BoundarySmoothing != 0,
+                         self->NonManifoldSmoothing != 0, true),
+    Self(self)
+  {
+  }
+
+  // The first iteration: newPts[one] = newPts[zero] - 0.5 laplacian and
+  // newPts[three] = c0 newPts[zero] + c1 newPts[one].
+  struct FirstPass
+  {
+    SMPSmoother *Smoother;
+    const float *X0;
+    float *X1;
+    float *X3;
+    const double *C;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const vtkIdType *offsets = this->Smoother->Offsets.data();
+      const vtkIdType *neighbors = this->Smoother->Neighbors.data();
+      const char *types = this->Smoother->Types.data();
+      double x[3], deltaX[3];
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType npts = offsets[i + 1] - offsets[i];
+        if (npts > 0)
+        {
+          // point is allowed to move
+          for (int k = 0; k < 3; ++k)
+          {
+            x[k] = this->X0[3 * i + k];
+          }
+          deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+          // calculate the negative of the laplacian
+          for (vtkIdType j = offsets[i]; j < offsets[i + 1]; ++j)
+          {
+            const float *y = this->X0 + 3 * neighbors[j];
+            for (int k = 0; k < 3; ++k)
+            {
+              deltaX[k] += (x[k] - y[k]) / npts;
+            }
+          }
+          for (int k = 0; k < 3; ++k)
+          {
+            deltaX[k] = x[k] - 0.5 * deltaX[k];
+            this->X1[3 * i + k] = static_cast<float>(deltaX[k]);
+            deltaX[k] = this->C[0] * x[k] + this->C[1] * deltaX[k];
+          }
+          for (int k = 0; k < 3; ++k)
+          {
+            this->X3[3 * i + k] = types[i] == VTK_FIXED_VERTEX ?
+              this->X0[3 * i + k] : static_cast<float>(deltaX[k]);
+          }
+        }
+        else
+        {
+          // point is not allowed to move, just use the old point...
+          // (zero out the Laplacian)
+          for (int k = 0; k < 3; ++k)
+          {
+            this->X1[3 * i + k] = 0.0f;
+            this->X3[3 * i + k] = this->X0[3 * i + k];
+          }
+        }
+      }
+    }
+  };
+
+  // The next iterations: newPts[two] = (x1 - x0) + (x1 - laplacian of x1)
+  // and newPts[three] += cj newPts[two].
+  struct NextPass
+  {
+    SMPSmoother *Smoother;
+    const float *X0;
+    const float *X1;
+    float *X2;
+    float *X3;
+    double C;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const vtkIdType *offsets = this->Smoother->Offsets.data();
+      const vtkIdType *neighbors = this->Smoother->Neighbors.data();
+      const char *types = this->Smoother->Types.data();
+      double p_x0[3], p_x1[3], deltaX[3];
+
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        vtkIdType npts = offsets[i + 1] - offsets[i];
+        if (npts > 0)
+        {
+          for (int k = 0; k < 3; ++k)
+          {
+            p_x0[k] = this->X0[3 * i + k];
+            p_x1[k] = this->X1[3 * i + k];
+          }
+          deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+          // calculate the negative laplacian of x1
+          for (vtkIdType j = offsets[i]; j < offsets[i + 1]; ++j)
+          {
+            const float *y = this->X1 + 3 * neighbors[j];
+            for (int k = 0; k < 3; ++k)
+            {
+              deltaX[k] += (p_x1[k] - y[k]) / npts;
+            }
+          }
+
+          // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+          for (int k = 0; k < 3; ++k)
+          {
+            deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+            this->X2[3 * i + k] = static_cast<float>(deltaX[k]);
+          }
+
+          // smooth the vertex (x3 = x3 + cj x2)
+          if (types[i] != VTK_FIXED_VERTEX)
+          {
+            for (int k = 0; k < 3; ++k)
+            {
+              this->X3[3 * i + k] = static_cast<float>(
+                this->X3[3 * i + k] + this->C * deltaX[k]);
+            }
+          }
+        }
+        else
+        {
+          // The laplacian of the point in newPts[one] was zeroed by the
+          // previous iteration, and is read by the other threads.
+          for (int k = 0; k < 3; ++k)
+          {
+            this->X2[3 * i + k] = 0.0f;
+          }
+        }
+      }
+    }
+  };
+
+  // Run the iterations on the four vectors of points, newPts[0] holding the
+  // initial points, with the Chebyshev coefficients c. Returns the number of
+  // the last iteration plus one, as the serial loop leaves it.
+  int Smooth(vtkPoints *newPts[4], const double *c)
+  {
+    float *x[4];
+    for (int i = 0; i < 4; ++i)
+    {
+      x[i] = static_cast<float*>(newPts[i]->GetVoidPointer(0));
+    }
+    int zero = 0, one = 1, two = 2, three = 3;
+    int numberOfIterations = this->Self->NumberOfIterations;
+
+    FirstPass first = { this, x[zero], x[one], x[three], c };
+    vtkSMPTools::For(0, this->NumPts, first);
+
+    int iterationNumber;
+    for (iterationNumber = 2; iterationNumber <= numberOfIterations;
+         iterationNumber++)
+    {
+      if (iterationNumber && !(iterationNumber % 5))
+      {
+        this->Self->UpdateProgress(
+          0.5 + 0.5 * iterationNumber / numberOfIterations);
+        if (this->Self->GetAbortExecute())
+        {
+          break;
+        }
+      }
+
+      NextPass next = { this, x[zero], x[one], x[two], x[three],
+                        c[iterationNumber] };
+      vtkSMPTools::For(0, this->NumPts, next);
+
+      // three is always three. all other pointers shift by one and wrap.
+      zero = (1 + zero) % 3;
+      one = (1 + one) % 3;
+      two = (1 + two) % 3;
+    }
+    return iterationNumber;
+  }
+};
+
 //-----------------------------------------------------------------------------
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -148,302 +350,310 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   // vertices. FIXED vertices are never smoothed. Edge vertices are smoothed
   // using a subset of the attached vertices.
   vtkDebugMacro(<<"Analyzing topology...");
-  Verts = new vtkMeshVertex[numPts];
-  for (i=0; i<numPts; i++)
+  inPts = input->GetPoints();
+  SMPSmoother smoother(this, inPts, CosFeatureAngle, CosEdgeAngle);
+  if (this->ParallelSmoothing)
   {
-    Verts[i].type = VTK_SIMPLE_VERTEX; //can smooth
-    Verts[i].edges = nullptr;
+    smoother.AnalyzeTopology(input);
+    Verts = nullptr;
   }
-
-  inPts = input->GetPoints();
-
-  // check vertices first. Vertices are never smoothed_--------------
-  for (inVerts=input->GetVerts(), inVerts->InitTraversal();
-  inVerts->GetNextCell(npts,pts); )
+  else
   {
-    for (j=0; j<npts; j++)
+    Verts = new vtkMeshVertex[numPts];
+    for (i=0; i<numPts; i++)
     {
-      Verts[pts[j]].type = VTK_FIXED_VERTEX;
+      Verts[i].type = VTK_SIMPLE_VERTEX; //can smooth
+      Verts[i].edges = nullptr;
     }
-  }
 
-  this->UpdateProgress(0.10);
+    // check vertices first. Vertices are never smoothed_--------------
+    for (inVerts=input->GetVerts(), inVerts->InitTraversal();
+    inVerts->GetNextCell(npts,pts); )
+    {
+      for (j=0; j<npts; j++)
+      {
+        Verts[pts[j]].type = VTK_FIXED_VERTEX;
+      }
+    }
 
-  // now check lines. Only manifold lines can be smoothed------------
-  for (inLines=input->GetLines(), inLines->InitTraversal();
-  inLines->GetNextCell(npts,pts); )
-  {
-    // Check for closed loop which are treated specially. Basically the
-    // last point is ignored (set to fixed).
-    bool closedLoop = ( pts[0] == pts[npts-1] && npts > 3 );
+    this->UpdateProgress(0.10);
 
-    for (j=0; j<npts; j++)
+    // now check lines. Only manifold lines can be smoothed------------
+    for (inLines=input->GetLines(), inLines->InitTraversal();
+    inLines->GetNextCell(npts,pts); )
     {
-      if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
+      // Check for closed loop which are treated specially. Basically the
+      // last point is ignored (set to fixed).
+      bool closedLoop = ( pts[0] == pts[npts-1] && npts > 3 );
+
+      for (j=0; j<npts; j++)
       {
-        // First point
-        if ( j == 0 )
+        if ( Verts[pts[j]].type == VTK_SIMPLE_VERTEX )
         {
-          if ( !closedLoop )
+          // First point
+          if ( j == 0 )
           {
-            Verts[pts[0]].type = VTK_FIXED_VERTEX;
+            if ( !closedLoop )
+            {
+              Verts[pts[0]].type = VTK_FIXED_VERTEX;
+            }
+            else
+            {
+              Verts[pts[0]].type = VTK_FEATURE_EDGE_VERTEX;
+              Verts[pts[0]].edges = vtkIdList::New();
+              Verts[pts[0]].edges->SetNumberOfIds(2);
+              Verts[pts[0]].edges->SetId(0,pts[npts-2]);
+              Verts[pts[0]].edges->SetId(1,pts[1]);
+            }
           }
-          else
+          // Last point
+          else if ( j == (npts-1) && !closedLoop )
           {
-            Verts[pts[0]].type = VTK_FEATURE_EDGE_VERTEX;
-            Verts[pts[0]].edges = vtkIdList::New();
-            Verts[pts[0]].edges->SetNumberOfIds(2);
-            Verts[pts[0]].edges->SetId(0,pts[npts-2]);
-            Verts[pts[0]].edges->SetId(1,pts[1]);
+            Verts[pts[j]].type = VTK_FIXED_VERTEX;
           }
-        }
-        // Last point
-        else if ( j == (npts-1) && !closedLoop )
+          // Inbetween point
+          else //is edge vertex (unless already edge vertex!)
+          {
+            Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
+            Verts[pts[j]].edges = vtkIdList::New();
+            Verts[pts[j]].edges->SetNumberOfIds(2);
+            Verts[pts[j]].edges->SetId(0,pts[j-1]);
+            Verts[pts[j]].edges->SetId(1,pts[(closedLoop && j==(npts-2) ? 0 : (j+1))]);
+          }
+        } //if simple vertex
+
+        // Vertex has been visited before, need to fix it. Special case
+        // when working on closed loop.
+        else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX &&
+                  ! (closedLoop && j == (npts-1)) )
         {
           Verts[pts[j]].type = VTK_FIXED_VERTEX;
+          Verts[pts[j]].edges->Delete();
+          Verts[pts[j]].edges = nullptr;
         }
-        // Inbetween point
-        else //is edge vertex (unless already edge vertex!)
-        {
-          Verts[pts[j]].type = VTK_FEATURE_EDGE_VERTEX;
-          Verts[pts[j]].edges = vtkIdList::New();
-          Verts[pts[j]].edges->SetNumberOfIds(2);
-          Verts[pts[j]].edges->SetId(0,pts[j-1]);
-          Verts[pts[j]].edges->SetId(1,pts[(closedLoop && j==(npts-2) ? 0 : (j+1))]);
-        }
-      } //if simple vertex
-
-      // Vertex has been visited before, need to fix it. Special case
-      // when working on closed loop.
-      else if ( Verts[pts[j]].type == VTK_FEATURE_EDGE_VERTEX &&
-                ! (closedLoop && j == (npts-1)) )
-      {
-        Verts[pts[j]].type = VTK_FIXED_VERTEX;
-        Verts[pts[j]].edges->Delete();
-        Verts[pts[j]].edges = nullptr;
+      } //for all points in this line
+    } //for all lines
+
+    this->UpdateProgress(0.25);
+
+    // now polygons and triangle strips-------------------------------
+    inPolys=input->GetPolys();
+    numPolys = inPolys->GetNumberOfCells();
+    inStrips=input->GetStrips();
+    numStrips = inStrips->GetNumberOfCells();
+
+    if ( numPolys > 0 || numStrips > 0 )
+    { //build cell structure
+      vtkCellArray *polys;
+      vtkIdType cellId;
+      int numNei, nei, edge;
+      vtkIdType numNeiPts;
+      vtkIdType *neiPts;
+      double normal[3], neiNormal[3];
+      vtkIdList *neighbors;
+
+      inMesh = vtkPolyData::New();
+      inMesh->SetPoints(inPts);
+      inMesh->SetPolys(inPolys);
+      Mesh = inMesh;
+      neighbors = vtkIdList::New();
+      neighbors->Allocate(VTK_CELL_SIZE);
+
+      if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
+      { // convert data to triangles
+        inMesh->SetStrips(inStrips);
+        toTris = vtkTriangleFilter::New();
+        toTris->SetInputData(inMesh);
+        toTris->Update();
+        Mesh = toTris->GetOutput();
       }
-    } //for all points in this line
-  } //for all lines
-
-  this->UpdateProgress(0.25);
-
-  // now polygons and triangle strips-------------------------------
-  inPolys=input->GetPolys();
-  numPolys = inPolys->GetNumberOfCells();
-  inStrips=input->GetStrips();
-  numStrips = inStrips->GetNumberOfCells();
-
-  if ( numPolys > 0 || numStrips > 0 )
-  { //build cell structure
-    vtkCellArray *polys;
-    vtkIdType cellId;
-    int numNei, nei, edge;
-    vtkIdType numNeiPts;
-    vtkIdType *neiPts;
-    double normal[3], neiNormal[3];
-    vtkIdList *neighbors;
-
-    inMesh = vtkPolyData::New();
-    inMesh->SetPoints(inPts);
-    inMesh->SetPolys(inPolys);
-    Mesh = inMesh;
-    neighbors = vtkIdList::New();
-    neighbors->Allocate(VTK_CELL_SIZE);
-
-    if ( (numStrips = inStrips->GetNumberOfCells()) > 0 )
-    { // convert data to triangles
-      inMesh->SetStrips(inStrips);
-      toTris = vtkTriangleFilter::New();
-      toTris->SetInputData(inMesh);
-      toTris->Update();
-      Mesh = toTris->GetOutput();
-    }
 
-    Mesh->BuildLinks(); //to do neighborhood searching
-    polys = Mesh->GetPolys();
+      Mesh->BuildLinks(); //to do neighborhood searching
+      polys = Mesh->GetPolys();
 
-    for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
-         cellId++)
-    {
-      for (i=0; i < npts; i++)
+      for (cellId=0, polys->InitTraversal(); polys->GetNextCell(npts,pts);
+           cellId++)
       {
-        p1 = pts[i];
-        p2 = pts[(i+1)%npts];
-
-        if ( Verts[p1].edges == nullptr )
+        for (i=0; i < npts; i++)
         {
-          Verts[p1].edges = vtkIdList::New();
-          Verts[p1].edges->Allocate(16,6);
-          // Verts[p1].edges = new vtkIdList(6,6);
-        }
-        if ( Verts[p2].edges == nullptr )
-        {
-          Verts[p2].edges = vtkIdList::New();
-          Verts[p2].edges->Allocate(16,6);
-          // Verts[p2].edges = new vtkIdList(6,6);
-        }
+          p1 = pts[i];
+          p2 = pts[(i+1)%npts];
 
-        Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
-        numNei = neighbors->GetNumberOfIds();
+          if ( Verts[p1].edges == nullptr )
+          {
+            Verts[p1].edges = vtkIdList::New();
+            Verts[p1].edges->Allocate(16,6);
+            // Verts[p1].edges = new vtkIdList(6,6);
+          }
+          if ( Verts[p2].edges == nullptr )
+          {
+            Verts[p2].edges = vtkIdList::New();
+            Verts[p2].edges->Allocate(16,6);
+            // Verts[p2].edges = new vtkIdList(6,6);
+          }
 
-        edge = VTK_SIMPLE_VERTEX;
-        if ( numNei == 0 )
-        {
-          edge = VTK_BOUNDARY_EDGE_VERTEX;
-        }
+          Mesh->GetCellEdgeNeighbors(cellId,p1,p2,neighbors);
+          numNei = neighbors->GetNumberOfIds();
 
-        else if ( numNei >= 2 )
-        {
-          // non-manifold case, check nonmanifold smoothing state
-          if (!this->NonManifoldSmoothing)
+          edge = VTK_SIMPLE_VERTEX;
+          if ( numNei == 0 )
           {
-            // check to make sure that this edge hasn't been marked already
-            for (j=0; j < numNei; j++)
+            edge = VTK_BOUNDARY_EDGE_VERTEX;
+          }
+
+          else if ( numNei >= 2 )
+          {
+            // non-manifold case, check nonmanifold smoothing state
+            if (!this->NonManifoldSmoothing)
             {
-              if ( neighbors->GetId(j) < cellId )
+              // check to make sure that this edge hasn't been marked already
+              for (j=0; j < numNei; j++)
+              {
+                if ( neighbors->GetId(j) < cellId )
+                {
+                  break;
+                }
+              }
+              if ( j >= numNei )
               {
-                break;
+                edge = VTK_FEATURE_EDGE_VERTEX;
               }
             }
-            if ( j >= numNei )
+          }
+
+          else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
+          {
+            if (this->FeatureEdgeSmoothing)
             {
-              edge = VTK_FEATURE_EDGE_VERTEX;
+              vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
+              Mesh->GetCellPoints(nei,numNeiPts,neiPts);
+              vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
+
+              if ( vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle )
+              {
+                edge = VTK_FEATURE_EDGE_VERTEX;
+              }
             }
           }
-        }
-
-        else if ( numNei == 1 && (nei=neighbors->GetId(0)) > cellId )
-        {
-          if (this->FeatureEdgeSmoothing)
+          else // a visited edge; skip rest of analysis
           {
-            vtkPolygon::ComputeNormal(inPts,npts,pts,normal);
-            Mesh->GetCellPoints(nei,numNeiPts,neiPts);
-            vtkPolygon::ComputeNormal(inPts,numNeiPts,neiPts,neiNormal);
+            continue;
+          }
 
-            if ( vtkMath::Dot(normal,neiNormal) <= CosFeatureAngle )
+          if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
+          {
+            Verts[p1].edges->Reset();
+            Verts[p1].edges->InsertNextId(p2);
+            Verts[p1].type = edge;
+          }
+          else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
+          (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
+          (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
+          {
+            Verts[p1].edges->InsertNextId(p2);
+            if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
             {
-              edge = VTK_FEATURE_EDGE_VERTEX;
+              Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
             }
           }
-        }
-        else // a visited edge; skip rest of analysis
-        {
-          continue;
-        }
 
-        if ( edge && Verts[p1].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p1].edges->Reset();
-          Verts[p1].edges->InsertNextId(p2);
-          Verts[p1].type = edge;
-        }
-        else if ( (edge && Verts[p1].type == VTK_BOUNDARY_EDGE_VERTEX) ||
-        (edge && Verts[p1].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p1].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p1].edges->InsertNextId(p2);
-          if ( Verts[p1].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+          if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
           {
-            Verts[p1].type = VTK_BOUNDARY_EDGE_VERTEX;
+            Verts[p2].edges->Reset();
+            Verts[p2].edges->InsertNextId(p1);
+            Verts[p2].type = edge;
           }
-        }
-
-        if ( edge && Verts[p2].type == VTK_SIMPLE_VERTEX )
-        {
-          Verts[p2].edges->Reset();
-          Verts[p2].edges->InsertNextId(p1);
-          Verts[p2].type = edge;
-        }
-        else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
-        (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
-        (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
-        {
-          Verts[p2].edges->InsertNextId(p1);
-          if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+          else if ( (edge && Verts[p2].type == VTK_BOUNDARY_EDGE_VERTEX ) ||
+          (edge && Verts[p2].type == VTK_FEATURE_EDGE_VERTEX) ||
+          (!edge && Verts[p2].type == VTK_SIMPLE_VERTEX ) )
           {
-            Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
+            Verts[p2].edges->InsertNextId(p1);
+            if ( Verts[p2].type && edge == VTK_BOUNDARY_EDGE_VERTEX )
+            {
+              Verts[p2].type = VTK_BOUNDARY_EDGE_VERTEX;
+            }
           }
         }
       }
-    }
 
-    //    delete inMesh; // delete this later, windowed sinc smoothing needs it
-    if (toTris)
-    {
-      toTris->Delete();
-    }
-    neighbors->Delete();
-  }//if strips or polys
-
-  this->UpdateProgress(0.50);
+      //    delete inMesh; // delete this later, windowed sinc smoothing needs it
+      if (toTris)
+      {
+        toTris->Delete();
+      }
+      neighbors->Delete();
+    }//if strips or polys
 
-  //post-process edge vertices to make sure we can smooth them
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].type == VTK_SIMPLE_VERTEX )
-    {
-      numSimple++;
-    }
+    this->UpdateProgress(0.50);
 
-    else if ( Verts[i].type == VTK_FIXED_VERTEX )
+    //post-process edge vertices to make sure we can smooth them
+    for (i=0; i<numPts; i++)
     {
-      numFixed++;
-    }
-
-    else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
-              Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
-    { //see how many edges; if two, what the angle is
-
-      if ( !this->BoundarySmoothing &&
-      Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
+      if ( Verts[i].type == VTK_SIMPLE_VERTEX )
       {
-        Verts[i].type = VTK_FIXED_VERTEX;
-        numBEdges++;
+        numSimple++;
       }
 
-      else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
+      else if ( Verts[i].type == VTK_FIXED_VERTEX )
       {
-        // can only smooth edges on 2-manifold surfaces
-        Verts[i].type = VTK_FIXED_VERTEX;
         numFixed++;
       }
 
-      else //check angle between edges
-      {
-        inPts->GetPoint(Verts[i].edges->GetId(0),x1);
-        inPts->GetPoint(i,x2);
-        inPts->GetPoint(Verts[i].edges->GetId(1),x3);
+      else if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX ||
+                Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
+      { //see how many edges; if two, what the angle is
 
-        for (k=0; k<3; k++)
+        if ( !this->BoundarySmoothing &&
+        Verts[i].type == VTK_BOUNDARY_EDGE_VERTEX )
         {
-          l1[k] = x2[k] - x1[k];
-          l2[k] = x3[k] - x2[k];
+          Verts[i].type = VTK_FIXED_VERTEX;
+          numBEdges++;
         }
-        if ((vtkMath::Normalize(l1) >= 0.0) && (vtkMath::Normalize(l2) >= 0.0)
-            && (vtkMath::Dot(l1,l2) < CosEdgeAngle))
+
+        else if ( (npts = Verts[i].edges->GetNumberOfIds()) != 2 )
         {
-          numFixed++;
+          // can only smooth edges on 2-manifold surfaces
           Verts[i].type = VTK_FIXED_VERTEX;
+          numFixed++;
         }
-        else
+
+        else //check angle between edges
         {
-          if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
+          inPts->GetPoint(Verts[i].edges->GetId(0),x1);
+          inPts->GetPoint(i,x2);
+          inPts->GetPoint(Verts[i].edges->GetId(1),x3);
+
+          for (k=0; k<3; k++)
+          {
+            l1[k] = x2[k] - x1[k];
+            l2[k] = x3[k] - x2[k];
+          }
+          if ((vtkMath::Normalize(l1) >= 0.0) && (vtkMath::Normalize(l2) >= 0.0)
+              && (vtkMath::Dot(l1,l2) < CosEdgeAngle))
           {
-            numFEdges++;
+            numFixed++;
+            Verts[i].type = VTK_FIXED_VERTEX;
           }
           else
           {
-            numBEdges++;
+            if ( Verts[i].type == VTK_FEATURE_EDGE_VERTEX )
+            {
+              numFEdges++;
+            }
+            else
+            {
+              numBEdges++;
+            }
           }
-        }
-      }//if along edge
-    }//if edge vertex
-  }//for all points
+        }//if along edge
+      }//if edge vertex
+    }//for all points
 
-  vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
-                << numFEdges << " feature edge vertices\n\t"
-                << numBEdges << " boundary edge vertices\n\t"
-                << numFixed << " fixed vertices\n\t");
+    vtkDebugMacro(<<"Found\n\t" << numSimple << " simple vertices\n\t"
+                  << numFEdges << " feature edge vertices\n\t"
+                  << numBEdges << " boundary edge vertices\n\t"
+                  << numFixed << " fixed vertices\n\t");
+  }
 
   // Perform Windowed Sinc function interpolation
   //
@@ -593,106 +803,50 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     vtkErrorMacro(<< "An optimal offset for the smoothing filter could not be found.  Unpredictable smoothing/shrinkage may result.");
   }
 
-  // first iteration
-  for (i=0; i<numPts; i++)
+  if (this->ParallelSmoothing)
   {
-    if ( Verts[i].edges != nullptr &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-    {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-      {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] += (x[k] - y[k]) / npts;
-        }
-      }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-      {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-      }
-      newPts[one]->SetPoint(i, deltaX);
-
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-      {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-      }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-      {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-      else
-      {
-        newPts[three]->SetPoint(i, deltaX);
-      }
-    }//if can move point
-    else
-    {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-    }
-  }//for all points
-
-  // for the rest of the iterations
-  for ( iterationNumber=2;
-        iterationNumber <= this->NumberOfIterations;
-        iterationNumber++ )
+    iterationNumber = smoother.Smooth(newPts, c);
+  }
+  else
   {
-    if ( iterationNumber && !(iterationNumber % 5) )
-    {
-      this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
-      if (this->GetAbortExecute())
-      {
-        break;
-      }
-    }
-
+    // first iteration
     for (i=0; i<numPts; i++)
     {
       if ( Verts[i].edges != nullptr &&
            (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
       {
         // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
+        newPts[zero]->GetPoint(i, x); //use current points
         deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
 
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
+        // calculate the negative of the laplacian
+        for (j=0; j<npts; j++) //for all connected points
         {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
+          newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
           for (k=0; k<3; k++)
           {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
+            deltaX[k] += (x[k] - y[k]) / npts;
           }
-        }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+        }
+        // newPts[one] = newPts[zero] - 0.5 newPts[one]
         for (k=0; k<3; k++)
         {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          deltaX[k] = x[k] - 0.5*deltaX[k];
         }
-        newPts[two]->SetPoint(i, deltaX);
+        newPts[one]->SetPoint(i, deltaX);
 
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
+        // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
+        for (k=0; k < 3; k++)
+        {
+          deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
+        }
+        if (Verts[i].type == VTK_FIXED_VERTEX)
         {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
+          newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
         }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
+        else
         {
-          newPts[three]->SetPoint(i,xNew);
+          newPts[three]->SetPoint(i, deltaX);
         }
       }//if can move point
       else
@@ -700,17 +854,80 @@ int vtkWindowedSincPolyDataFilter::RequestData(
         // point is not allowed to move, just use the old point...
         // (zero out the Laplacian)
         newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
+        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
       }
     }//for all points
 
-    // update the pointers. three is always three. all other pointers
-    // shift by one and wrap.
-    zero = (1+zero)%3;
-    one = (1+one)%3;
-    two = (1+two)%3;
+    // for the rest of the iterations
+    for ( iterationNumber=2;
+          iterationNumber <= this->NumberOfIterations;
+          iterationNumber++ )
+    {
+      if ( iterationNumber && !(iterationNumber % 5) )
+      {
+        this->UpdateProgress (0.5 + 0.5*iterationNumber/this->NumberOfIterations);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
+      }
+
+      for (i=0; i<numPts; i++)
+      {
+        if ( Verts[i].edges != nullptr &&
+             (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
+        {
+          // point is allowed to move
+          newPts[zero]->GetPoint(i, p_x0); //use current points
+          newPts[one]->GetPoint(i, p_x1);
+
+          deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+          // calculate the negative laplacian of x1
+          for (j=0; j<npts; j++)
+          {
+            newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
+            for (k=0; k<3; k++)
+            {
+              deltaX[k] += (p_x1[k] - y[k]) / npts;
+            }
+          }//for all connected points
+
+          // Taubin:  x2 = (x1 - x0) + (x1 - x2)
+          for (k=0; k<3; k++)
+          {
+            deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          }
+          newPts[two]->SetPoint(i, deltaX);
 
-  }//for all iterations or until converge
+          // smooth the vertex (x3 = x3 + cj x2)
+          newPts[three]->GetPoint(i, p_x3);
+          for (k=0;k<3;k++)
+          {
+            xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
+          }
+          if (Verts[i].type != VTK_FIXED_VERTEX)
+          {
+            newPts[three]->SetPoint(i,xNew);
+          }
+        }//if can move point
+        else
+        {
+          // point is not allowed to move, just use the old point...
+          // (zero out the Laplacian)
+          newPts[one]->SetPoint(i, zerovector);
+          newPts[two]->SetPoint(i, zerovector);
+        }
+      }//for all points
+
+      // update the pointers. three is always three. all other pointers
+      // shift by one and wrap.
+      zero = (1+zero)%3;
+      one = (1+one)%3;
+      two = (1+two)%3;
+
+    }//for all iterations or until converge
+  }
 
   // move the iteration count back down so that it matches the
   // actual number of iterations executed
@@ -800,7 +1017,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   }
 
   //free up connectivity storage
-  for (i=0; i<numPts; i++)
+  for (i=0; Verts && i<numPts; i++)
   {
     if ( Verts[i].edges != nullptr )
     {
@@ -827,4 +1044,5 @@ void vtkWindowedSincPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Nonmanifold Smoothing: " << (this->NonManifoldSmoothing ? "On\n" : "Off\n");
   os << indent << "Generate Error Scalars: " << (this->GenerateErrorScalars ? "On\n" : "Off\n");
   os << indent << "Generate Error Vectors: " << (this->GenerateErrorVectors ? "On\n" : "Off\n");
+  os << indent << "Parallel Smoothing: " << (this->ParallelSmoothing ? "On\n" : "Off\n");
 }
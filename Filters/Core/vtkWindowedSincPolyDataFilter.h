@@ -251,6 +251,21 @@ public:
   vtkBooleanMacro(GenerateErrorVectors,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Set/Get a boolean value that controls whether the mesh is smoothed in
+   * parallel with vtkSMPTools. If on, the edges of the polygons are
+   * classified and the vertices connected to each vertex are gathered into
+   * compressed rows in parallel, then each iteration updates all the points
+   * in parallel. The iterations only read the points of the previous
+   * iterations, so the output is the same as the serial output. By default,
+   * parallel smoothing is off.
+   */
+  vtkSetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkGetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkBooleanMacro(ParallelSmoothing,vtkTypeBool);
+  //@}
+
  protected:
   vtkWindowedSincPolyDataFilter();
   ~vtkWindowedSincPolyDataFilter() override {}
@@ -267,6 +282,10 @@ public:
   vtkTypeBool GenerateErrorScalars;
   vtkTypeBool GenerateErrorVectors;
   vtkTypeBool NormalizeCoordinates;
+  vtkTypeBool ParallelSmoothing;
+
+  // Threaded smoothing, see vtkWindowedSincPolyDataFilter.cxx.
+  struct SMPSmoother;
 private:
   vtkWindowedSincPolyDataFilter(const vtkWindowedSincPolyDataFilter&) = delete;
   void operator=(const vtkWindowedSincPolyDataFilter&) = delete;
@@ -0,0 +1,200 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerSeeds.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Trace the streamlines of many seeds, whose integration is threaded, and
+// check that the output is the same as the one of the serial integration,
+// which is used when there is a custom termination callback.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRungeKutta45.h"
+#include "vtkStreamTracer.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+const int Dim = 21;
+
+// A swirling flow around the z axis of the image center, moving up.
+void MakeImage(vtkImageData *image)
+{
+  image->SetDimensions(Dim, Dim, Dim);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("Velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> temperature;
+  temperature->SetName("Temperature");
+  temperature->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    velocity->SetTuple3(i, -x[1] + 0.1 * x[0], x[0], 0.2 + 0.1 * x[2]);
+    temperature->SetValue(i, x[0] * x[0] + x[1] - x[2]);
+  }
+  image->GetPointData()->SetVectors(velocity);
+  image->GetPointData()->AddArray(temperature);
+}
+
+// The same hexahedra and point data as an unstructured grid.
+void MakeGrid(vtkImageData *image, vtkUnstructuredGrid *ugrid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    points->SetPoint(i, image->GetPoint(i));
+  }
+  ugrid->SetPoints(points);
+  ugrid->Allocate(image->GetNumberOfCells());
+  vtkNew<vtkIdList> voxel;
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    image->GetCellPoints(i, voxel);
+    vtkIdType hex[8] = { voxel->GetId(0), voxel->GetId(1), voxel->GetId(3),
+                         voxel->GetId(2), voxel->GetId(4), voxel->GetId(5),
+                         voxel->GetId(7), voxel->GetId(6) };
+    ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+  }
+  ugrid->GetPointData()->ShallowCopy(image->GetPointData());
+}
+
+// Some of the seeds are outside of the domain.
+void MakeSeeds(vtkPolyData *seeds)
+{
+  vtkNew<vtkPoints> points;
+  for (int j = 0; j < 12; ++j)
+  {
+    for (int i = 0; i < 12; ++i)
+    {
+      points->InsertNextPoint(-1.1 + 0.19 * i, -1.05 + 0.18 * j,
+                              -0.9 + 0.01 * (i + j));
+    }
+  }
+  seeds->SetPoints(points);
+}
+
+bool DoNotTerminate(void *, vtkPoints *, vtkDataArray *, int)
+{
+  return false;
+}
+
+bool SameArrays(vtkDataArray *a, vtkDataArray *b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfTuples(); ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(i, c) != b->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int CompareStreamlines(vtkDataSet *input, vtkPolyData *seeds,
+                       const char *label)
+{
+  vtkNew<vtkStreamTracer> serial;
+  vtkNew<vtkStreamTracer> parallel;
+  serial->AddCustomTerminationCallback(&DoNotTerminate, nullptr, 0);
+  vtkStreamTracer *tracers[2] = { serial, parallel };
+  for (int i = 0; i < 2; ++i)
+  {
+    vtkNew<vtkRungeKutta45> integrator;
+    tracers[i]->SetInputData(input);
+    tracers[i]->SetSourceData(seeds);
+    tracers[i]->SetIntegrator(integrator);
+    tracers[i]->SetIntegrationDirectionToBoth();
+    tracers[i]->SetMaximumPropagation(8.0);
+    tracers[i]->SetMaximumNumberOfSteps(500);
+    tracers[i]->Update();
+  }
+
+  vtkPolyData *a = serial->GetOutput();
+  vtkPolyData *b = parallel->GetOutput();
+  if (b->GetNumberOfLines() < 100 ||
+      a->GetNumberOfLines() != b->GetNumberOfLines())
+  {
+    cerr << label << ": expected " << a->GetNumberOfLines()
+         << " streamlines, got " << b->GetNumberOfLines() << endl;
+    return 1;
+  }
+  if (!SameArrays(a->GetPoints()->GetData(), b->GetPoints()->GetData()) ||
+      !SameArrays(a->GetLines()->GetData(), b->GetLines()->GetData()))
+  {
+    cerr << label << ": the streamline points differ" << endl;
+    return 1;
+  }
+  const char *pointArrays[] = { "Velocity", "Temperature", "IntegrationTime",
+                                "Vorticity", "Rotation", "AngularVelocity",
+                                "Normals" };
+  for (const char *name : pointArrays)
+  {
+    if (!SameArrays(a->GetPointData()->GetArray(name),
+                    b->GetPointData()->GetArray(name)))
+    {
+      cerr << label << ": the " << name << " arrays differ" << endl;
+      return 1;
+    }
+  }
+  const char *cellArrays[] = { "ReasonForTermination", "SeedIds" };
+  for (const char *name : cellArrays)
+  {
+    if (!SameArrays(a->GetCellData()->GetArray(name),
+                    b->GetCellData()->GetArray(name)))
+    {
+      cerr << label << ": the " << name << " arrays differ" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}
+
+int TestStreamTracerSeeds(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  MakeImage(image);
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakeGrid(image, ugrid);
+  vtkNew<vtkPolyData> seeds;
+  MakeSeeds(seeds);
+
+  int rval = 0;
+  rval |= CompareStreamlines(image, seeds, "image");
+  rval |= CompareStreamlines(ugrid, seeds, "unstructured");
+  return rval;
+}
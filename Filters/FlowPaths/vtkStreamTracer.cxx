@@ -45,8 +45,11 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 
+#include <atomic>
 #include <vector>
 
 vtkObjectFactoryNewMacro(vtkStreamTracer)
@@ -652,6 +655,634 @@ int vtkStreamTracer::CheckInputs(vtkAbstractInterpolatedVelocityField*& func,
   return VTK_OK;
 }
 
+// The integration of the streamline of one seed. The streamline points and
+// their attributes are appended to the given points and arrays, which are the
+// ones of the output for the serial integration and ones local to a thread
+// for the threaded integration.
+struct vtkStreamTracer::StreamlineIntegrator
+{
+  vtkStreamTracer* Self;
+  vtkAbstractInterpolatedVelocityField* Func;
+  vtkInterpolatedVelocityField* SurfaceFunc;
+  vtkInitialValueProblemSolver* Integrator;
+  vtkGenericCell* Cell;
+  vtkDoubleArray* CellVectors;
+  double* Weights;
+  int VecType;
+  const char* VecName;
+  bool ReportProgress;
+
+  vtkPoints* Points;
+  vtkDataSetAttributes* PointData;
+  vtkDoubleArray* Time;
+  vtkDoubleArray* VelocityVectors;
+  vtkDoubleArray* Vorticity;
+  vtkDoubleArray* Rotation;
+  vtkDoubleArray* AngularVel;
+
+  // Set by Integrate() when lastPoint or the step size were set.
+  bool HasLastPoint;
+  bool HasLastUsedStepSize;
+  double LastUsedStepSize;
+
+  StreamlineIntegrator()
+    : Self(nullptr), Func(nullptr), SurfaceFunc(nullptr), Integrator(nullptr),
+      Cell(nullptr), CellVectors(nullptr), Weights(nullptr), VecType(0),
+      VecName(nullptr), ReportProgress(false), Points(nullptr),
+      PointData(nullptr), Time(nullptr), VelocityVectors(nullptr),
+      Vorticity(nullptr), Rotation(nullptr), AngularVel(nullptr),
+      HasLastPoint(false), HasLastUsedStepSize(false), LastUsedStepSize(0.0)
+  {
+  }
+
+  // Integrate the streamline starting at seed and return the number of
+  // points appended, 0 if the seed is outside of the domain or if the
+  // propagation or the number of steps is already over its maximum.
+  vtkIdType Integrate(const double seed[3], int direction, int currentLine,
+                      vtkIdType numLines, double& propagation,
+                      vtkIdType& numSteps, double& integrationTime,
+                      double lastPoint[3], int& retVal, int& shouldAbort);
+};
+
+vtkIdType vtkStreamTracer::StreamlineIntegrator::Integrate(
+  const double seed[3], int direction, int currentLine, vtkIdType numLines,
+  double& propagation, vtkIdType& numSteps, double& integrationTime,
+  double lastPoint[3], int& retVal, int& shouldAbort)
+{
+  vtkStreamTracer* self = this->Self;
+  vtkAbstractInterpolatedVelocityField* func = this->Func;
+  vtkGenericCell* cell = this->Cell;
+  vtkPoints* outputPoints = this->Points;
+  vtkDoubleArray* time = this->Time;
+  vtkDoubleArray* vorticity = this->Vorticity;
+  vtkDoubleArray* rotation = this->Rotation;
+  vtkDoubleArray* angularVel = this->AngularVel;
+  int vecType = this->VecType;
+  const char* vecName = this->VecName;
+
+  this->HasLastPoint = false;
+  this->HasLastUsedStepSize = false;
+
+  // temporary variables used in the integration
+  double point1[3], point2[3], pcoords[3], vort[3], omega, velocity[3];
+  vtkIdType index, numPts=0;
+
+  // Clear the last cell to avoid starting a search from
+  // the last point in the streamline
+  func->ClearLastCellId();
+
+  // Initial point
+  memcpy(point1, seed, 3*sizeof(double));
+  memcpy(point2, point1, 3*sizeof(double));
+  if (!func->FunctionValues(point1, velocity))
+  {
+    return 0;
+  }
+
+  if ( propagation >= self->MaximumPropagation ||
+       numSteps    >  self->MaximumNumberOfSteps)
+  {
+    return 0;
+  }
+
+  numPts++;
+  vtkIdType nextPoint = outputPoints->InsertNextPoint(point1);
+  double lastInsertedPoint[3];
+  outputPoints->GetPoint(nextPoint, lastInsertedPoint);
+  time->InsertNextValue(integrationTime);
+
+  // We will always pass an arc-length step size to the integrator.
+  // If the user specifies a step size in cell length unit, we will
+  // have to convert it to arc length.
+  IntervalInformation stepSize;  // either positive or negative
+  stepSize.Unit  = LENGTH_UNIT;
+  stepSize.Interval = 0;
+  IntervalInformation aStep; // always positive
+  aStep.Unit = LENGTH_UNIT;
+  double step, minStep=0, maxStep=0;
+  double stepTaken;
+  double speed;
+  double cellLength;
+  int tmp;
+
+  // Make sure we use the dataset found by the vtkAbstractInterpolatedVelocityField
+  vtkDataSet* input = func->GetLastDataSet();
+  vtkPointData* inputPD = input->GetPointData();
+  vtkDataArray* inVectors =
+    input->GetAttributesAsFieldData(vecType)->GetArray(vecName);
+  // Convert intervals to arc-length unit
+  input->GetCell(func->GetLastCellId(), cell);
+  cellLength = sqrt(static_cast<double>(cell->GetLength2()));
+  speed = vtkMath::Norm(velocity);
+  // Never call conversion methods if speed == 0
+  if ( speed != 0.0 )
+  {
+    self->ConvertIntervals( stepSize.Interval, minStep, maxStep,
+                            direction, cellLength );
+  }
+
+  // Interpolate all point attributes on first point
+  func->GetLastWeights(this->Weights);
+  InterpolatePoint(this->PointData, inputPD, nextPoint, cell->PointIds,
+                   this->Weights, self->HasMatchingPointAttributes);
+  // handle both point and cell velocity attributes.
+  vtkDataArray* outputVelocityVectors = this->PointData->GetArray(vecName);
+  if(vecType != vtkDataObject::POINT)
+  {
+    this->VelocityVectors->InsertNextTuple(velocity);
+    outputVelocityVectors = this->VelocityVectors;
+  }
+
+  // Compute vorticity if required
+  // This can be used later for streamribbon generation.
+  if (self->ComputeVorticity)
+  {
+    if(vecType == vtkDataObject::POINT)
+    {
+      inVectors->GetTuples(cell->PointIds, this->CellVectors);
+      func->GetLastLocalCoordinates(pcoords);
+      self->CalculateVorticity(cell, pcoords, this->CellVectors, vort);
+    }
+    else
+    {
+      vort[0] = 0;
+      vort[1] = 0;
+      vort[2] = 0;
+    }
+    vorticity->InsertNextTuple(vort);
+    // rotation
+    // local rotation = vorticity . unit tangent ( i.e. velocity/speed )
+    if (speed != 0.0)
+    {
+      omega = vtkMath::Dot(vort, velocity);
+      omega /= speed;
+      omega *= self->RotationScale;
+    }
+    else
+    {
+      omega = 0.0;
+    }
+    angularVel->InsertNextValue(omega);
+    rotation->InsertNextValue(0.0);
+  }
+
+  double error = 0;
+
+  // Integrate until the maximum propagation length is reached,
+  // maximum number of steps is reached or until a boundary is encountered.
+  // Begin Integration
+  while ( propagation < self->MaximumPropagation )
+  {
+
+    if (numSteps > self->MaximumNumberOfSteps)
+    {
+      retVal = OUT_OF_STEPS;
+      break;
+    }
+
+    bool endIntegration = false;
+    for (std::size_t i = 0; i < self->CustomTerminationCallback.size(); ++i)
+    {
+      if(self->CustomTerminationCallback[i](self->CustomTerminationClientData[i],
+                                            outputPoints, outputVelocityVectors, direction))
+      {
+        retVal = self->CustomReasonForTermination[i];
+        endIntegration = true;
+        break;
+      }
+    }
+    if (endIntegration)
+    {
+      break;
+    }
+
+    if ( numSteps++ % 1000 == 1 )
+    {
+      if (this->ReportProgress)
+      {
+        double progress =
+          ( currentLine + propagation / self->MaximumPropagation ) / numLines;
+        self->UpdateProgress(progress);
+      }
+
+      if (self->GetAbortExecute())
+      {
+        shouldAbort = 1;
+        break;
+      }
+    }
+
+    // Never call conversion methods if speed == 0
+    if ( (speed == 0) || (speed <= self->TerminalSpeed) )
+    {
+      retVal = STAGNATION;
+      break;
+    }
+
+    // If, with the next step, propagation will be larger than
+    // max, reduce it so that it is (approximately) equal to max.
+    aStep.Interval = fabs( stepSize.Interval );
+
+    if ( ( propagation + aStep.Interval ) > self->MaximumPropagation )
+    {
+      aStep.Interval = self->MaximumPropagation - propagation;
+      if ( stepSize.Interval >= 0 )
+      {
+        stepSize.Interval = self->ConvertToLength( aStep, cellLength );
+      }
+      else
+      {
+        stepSize.Interval = self->ConvertToLength( aStep, cellLength ) * ( -1.0 );
+      }
+      maxStep = stepSize.Interval;
+    }
+    this->LastUsedStepSize = stepSize.Interval;
+    this->HasLastUsedStepSize = true;
+
+    // Calculate the next step using the integrator provided
+    // Break if the next point is out of bounds.
+    func->SetNormalizeVector( true );
+    tmp = this->Integrator->ComputeNextStep( point1, point2, 0, stepSize.Interval,
+                                             stepTaken, minStep, maxStep,
+                                             self->MaximumError, error );
+    func->SetNormalizeVector( false );
+    if ( tmp != 0 )
+    {
+      retVal = tmp;
+      memcpy(lastPoint, point2, 3*sizeof(double));
+      this->HasLastPoint = true;
+      break;
+    }
+
+    // This is the next starting point
+    if (self->SurfaceStreamlines && this->SurfaceFunc != nullptr)
+    {
+      if (this->SurfaceFunc->SnapPointOnCell(point2, point1) != 1)
+      {
+        retVal = OUT_OF_DOMAIN;
+        memcpy(lastPoint, point2, 3 * sizeof(double));
+        this->HasLastPoint = true;
+        break;
+      }
+    }
+    else
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        point1[i] = point2[i];
+      }
+    }
+
+    // Interpolate the velocity at the next point
+    if ( !func->FunctionValues(point2, velocity) )
+    {
+      retVal = OUT_OF_DOMAIN;
+      memcpy(lastPoint, point2, 3*sizeof(double));
+      this->HasLastPoint = true;
+      break;
+    }
+
+    // It is not enough to use the starting point for stagnation calculation
+    // Use average speed to check if it is below stagnation threshold
+    double speed2 = vtkMath::Norm(velocity);
+    if ( (speed+speed2)/2 <= self->TerminalSpeed )
+    {
+      retVal = STAGNATION;
+      break;
+    }
+
+    integrationTime += stepTaken / speed;
+    // Calculate propagation (using the same units as MaximumPropagation
+    propagation += fabs( stepSize.Interval );
+
+    // Make sure we use the dataset found by the vtkAbstractInterpolatedVelocityField
+    input = func->GetLastDataSet();
+    inputPD = input->GetPointData();
+    inVectors = input->GetAttributesAsFieldData(vecType)->GetArray(vecName);
+
+    // Calculate cell length and speed to be used in unit conversions
+    input->GetCell(func->GetLastCellId(), cell);
+    cellLength = sqrt(static_cast<double>(cell->GetLength2()));
+    speed = speed2;
+
+    // Check if conversion to float will produce a point in same place
+    float convertedPoint[3];
+    for (int i = 0; i < 3; i++)
+    {
+      convertedPoint[i] = point1[i];
+    }
+    if (lastInsertedPoint[0] != convertedPoint[0] ||
+        lastInsertedPoint[1] != convertedPoint[1] ||
+        lastInsertedPoint[2] != convertedPoint[2])
+    {
+      // Point is valid. Insert it.
+      numPts++;
+      nextPoint = outputPoints->InsertNextPoint(point1);
+      outputPoints->GetPoint(nextPoint, lastInsertedPoint);
+      time->InsertNextValue(integrationTime);
+
+      // Interpolate all point attributes on current point
+      func->GetLastWeights(this->Weights);
+      InterpolatePoint(this->PointData, inputPD, nextPoint, cell->PointIds,
+                       this->Weights, self->HasMatchingPointAttributes);
+
+      if(vecType != vtkDataObject::POINT)
+      {
+        this->VelocityVectors->InsertNextTuple(velocity);
+      }
+      // Compute vorticity if required
+      // This can be used later for streamribbon generation.
+      if (self->ComputeVorticity)
+      {
+        if(vecType == vtkDataObject::POINT)
+        {
+          inVectors->GetTuples(cell->PointIds, this->CellVectors);
+          func->GetLastLocalCoordinates(pcoords);
+          self->CalculateVorticity(cell, pcoords, this->CellVectors, vort);
+        }
+        else
+        {
+          vort[0] = 0;
+          vort[1] = 0;
+          vort[2] = 0;
+        }
+        vorticity->InsertNextTuple(vort);
+        // rotation
+        // angular velocity = vorticity . unit tangent ( i.e. velocity/speed )
+        // rotation = sum ( angular velocity * stepSize )
+        omega = vtkMath::Dot(vort, velocity);
+        omega /= speed;
+        omega *= self->RotationScale;
+        index = angularVel->InsertNextValue(omega);
+        rotation->InsertNextValue(rotation->GetValue(index-1) +
+                                  (angularVel->GetValue(index-1) + omega)/2 *
+                                  (integrationTime - time->GetValue(index-1)));
+      }
+    }
+
+    // Never call conversion methods if speed == 0
+    if ( (speed == 0) || (speed <= self->TerminalSpeed) )
+    {
+      retVal = STAGNATION;
+      break;
+    }
+
+    // Convert all intervals to arc length
+    self->ConvertIntervals( step, minStep, maxStep, direction, cellLength );
+
+
+    // If the solver is adaptive and the next step size (stepSize.Interval)
+    // that the solver wants to use is smaller than minStep or larger
+    // than maxStep, re-adjust it. This has to be done every step
+    // because minStep and maxStep can change depending on the cell
+    // size (unless it is specified in arc-length unit)
+    if (this->Integrator->IsAdaptive())
+    {
+      if (fabs(stepSize.Interval) < fabs(minStep))
+      {
+        stepSize.Interval = fabs( minStep ) *
+                              stepSize.Interval / fabs( stepSize.Interval );
+      }
+      else if (fabs(stepSize.Interval) > fabs(maxStep))
+      {
+        stepSize.Interval = fabs( maxStep ) *
+                              stepSize.Interval / fabs( stepSize.Interval );
+      }
+    }
+    else
+    {
+      stepSize.Interval = step;
+    }
+  }
+
+  return numPts;
+}
+
+// Integrate the streamlines of the seeds in parallel. Each thread has its own
+// copy of the velocity field and of the integrator, and appends the
+// streamlines of its seeds to its own points and arrays. What the integration
+// of each seed produced is recorded, so that the streamlines can then be
+// concatenated in the order of the seeds.
+struct vtkStreamTracer::SMPSeedIntegrator
+{
+  struct LocalData
+  {
+    vtkSmartPointer<vtkAbstractInterpolatedVelocityField> Func;
+    vtkSmartPointer<vtkInitialValueProblemSolver> Integrator;
+    vtkSmartPointer<vtkGenericCell> Cell;
+    vtkSmartPointer<vtkDoubleArray> CellVectors;
+    std::vector<double> Weights;
+    vtkSmartPointer<vtkPoints> Points;
+    vtkSmartPointer<vtkPointData> PointData;
+    vtkSmartPointer<vtkDoubleArray> Time;
+    vtkSmartPointer<vtkDoubleArray> VelocityVectors;
+    vtkSmartPointer<vtkDoubleArray> Vorticity;
+    vtkSmartPointer<vtkDoubleArray> Rotation;
+    vtkSmartPointer<vtkDoubleArray> AngularVel;
+    StreamlineIntegrator Streamline;
+  };
+
+  struct SeedResult
+  {
+    // The thread data holding the streamline, null if the seed was skipped.
+    LocalData* Data;
+    vtkIdType FirstPoint;
+    vtkIdType NumberOfPoints;
+    int RetVal;
+    double Propagation;
+    vtkIdType NumSteps;
+    double IntegrationTime;
+    bool HasLastPoint;
+    double LastPoint[3];
+    bool HasLastUsedStepSize;
+    double LastUsedStepSize;
+  };
+
+  vtkStreamTracer* Self;
+  vtkAbstractInterpolatedVelocityField* Func;
+  vtkPointData* Input0Data;
+  vtkDataArray* SeedSource;
+  vtkIdList* SeedIds;
+  vtkIntArray* IntegrationDirections;
+  int MaxCellSize;
+  int VecType;
+  const char* VecName;
+  vtkSMPThreadLocal<LocalData> Local;
+  std::vector<SeedResult> Results;
+  std::atomic<bool> Aborted;
+
+  SMPSeedIntegrator(vtkStreamTracer* self,
+                    vtkAbstractInterpolatedVelocityField* func,
+                    vtkPointData* input0Data, vtkDataArray* seedSource,
+                    vtkIdList* seedIds, vtkIntArray* integrationDirections,
+                    int maxCellSize, int vecType, const char* vecName)
+    : Self(self), Func(func), Input0Data(input0Data), SeedSource(seedSource),
+      SeedIds(seedIds), IntegrationDirections(integrationDirections),
+      MaxCellSize(maxCellSize), VecType(vecType), VecName(vecName),
+      Results(seedIds->GetNumberOfIds()), Aborted(false)
+  {
+    for (vtkIdType i = 0; i < seedIds->GetNumberOfIds(); ++i)
+    {
+      this->Results[i].Data = nullptr;
+    }
+  }
+
+  // Build the structures the datasets create on demand to find and get
+  // cells, which cannot be built concurrently by the threads.
+  static void PrepareDataSet(vtkDataSet* ds)
+  {
+    double bounds[6];
+    ds->GetBounds(bounds);
+    vtkPointSet* ps = vtkPointSet::SafeDownCast(ds);
+    if (!ps || ps->GetNumberOfCells() < 1 || ps->GetNumberOfPoints() < 1)
+    {
+      return;
+    }
+    vtkNew<vtkGenericCell> cell;
+    vtkNew<vtkIdList> cellIds;
+    ps->GetCell(0, cell);
+    ps->GetPointCells(0, cellIds);
+    // Builds the point locator.
+    double x[3], pcoords[3];
+    int subId;
+    std::vector<double> weights(ps->GetMaxCellSize() + 1);
+    ps->GetPoint(0, x);
+    ps->FindCell(x, nullptr, cell, -1, 0.0, subId, pcoords, weights.data());
+  }
+
+  void Initialize()
+  {
+    vtkStreamTracer* self = this->Self;
+    LocalData& data = this->Local.Local();
+
+    data.Func.TakeReference(this->Func->NewInstance());
+    data.Func->CopyParameters(this->Func);
+    vtkCompositeInterpolatedVelocityField* composite =
+      vtkCompositeInterpolatedVelocityField::SafeDownCast(data.Func);
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(self->InputData->NewIterator());
+    for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
+    {
+      vtkDataSet* inp = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (inp)
+      {
+        composite->AddDataSet(inp);
+      }
+    }
+    data.Func->SelectVectors(this->VecType, this->VecName);
+
+    vtkInterpolatedVelocityField* surfaceFunc = nullptr;
+    if (self->SurfaceStreamlines)
+    {
+      surfaceFunc = vtkInterpolatedVelocityField::SafeDownCast(data.Func);
+      surfaceFunc->SetForceSurfaceTangentVector(true);
+      surfaceFunc->SetSurfaceDataset(true);
+    }
+
+    data.Integrator.TakeReference(self->GetIntegrator()->NewInstance());
+    data.Integrator->SetFunctionSet(data.Func);
+    data.Cell = vtkSmartPointer<vtkGenericCell>::New();
+    data.Weights.resize(this->MaxCellSize);
+
+    data.Points = vtkSmartPointer<vtkPoints>::New();
+    data.PointData = vtkSmartPointer<vtkPointData>::New();
+    data.PointData->InterpolateAllocate(this->Input0Data,
+                                        self->MaximumNumberOfSteps);
+    data.Time = vtkSmartPointer<vtkDoubleArray>::New();
+    if (this->VecType != vtkDataObject::POINT)
+    {
+      data.VelocityVectors = vtkSmartPointer<vtkDoubleArray>::New();
+      data.VelocityVectors->SetNumberOfComponents(3);
+    }
+    if (self->ComputeVorticity)
+    {
+      data.CellVectors = vtkSmartPointer<vtkDoubleArray>::New();
+      data.CellVectors->SetNumberOfComponents(3);
+      data.CellVectors->Allocate(3*VTK_CELL_SIZE);
+      data.Vorticity = vtkSmartPointer<vtkDoubleArray>::New();
+      data.Vorticity->SetNumberOfComponents(3);
+      data.Rotation = vtkSmartPointer<vtkDoubleArray>::New();
+      data.AngularVel = vtkSmartPointer<vtkDoubleArray>::New();
+    }
+
+    StreamlineIntegrator& streamline = data.Streamline;
+    streamline.Self = self;
+    streamline.Func = data.Func;
+    streamline.SurfaceFunc = surfaceFunc;
+    streamline.Integrator = data.Integrator;
+    streamline.Cell = data.Cell;
+    streamline.CellVectors = data.CellVectors;
+    streamline.Weights = data.Weights.empty() ? nullptr : &data.Weights[0];
+    streamline.VecType = this->VecType;
+    streamline.VecName = this->VecName;
+    streamline.ReportProgress = false;
+    streamline.Points = data.Points;
+    streamline.PointData = data.PointData;
+    streamline.Time = data.Time;
+    streamline.VelocityVectors = data.VelocityVectors;
+    streamline.Vorticity = data.Vorticity;
+    streamline.Rotation = data.Rotation;
+    streamline.AngularVel = data.AngularVel;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    LocalData& data = this->Local.Local();
+    vtkIdType numLines = this->SeedIds->GetNumberOfIds();
+    for (vtkIdType line = begin; line < end && !this->Aborted; ++line)
+    {
+      SeedResult& result = this->Results[line];
+      double seed[3];
+      this->SeedSource->GetTuple(this->SeedIds->GetId(line), seed);
+      int direction =
+        this->IntegrationDirections->GetValue(line) == BACKWARD ? -1 : 1;
+
+      result.FirstPoint = data.Points->GetNumberOfPoints();
+      result.RetVal = OUT_OF_LENGTH;
+      result.Propagation = 0.0;
+      result.NumSteps = 0;
+      result.IntegrationTime = 0.0;
+      int shouldAbort = 0;
+      result.NumberOfPoints = data.Streamline.Integrate(
+        seed, direction, static_cast<int>(line), numLines, result.Propagation,
+        result.NumSteps, result.IntegrationTime, result.LastPoint,
+        result.RetVal, shouldAbort);
+      result.HasLastPoint = data.Streamline.HasLastPoint;
+      result.HasLastUsedStepSize = data.Streamline.HasLastUsedStepSize;
+      result.LastUsedStepSize = data.Streamline.LastUsedStepSize;
+      if (result.NumberOfPoints > 0)
+      {
+        result.Data = &data;
+      }
+      if (shouldAbort)
+      {
+        this->Aborted = true;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+bool vtkStreamTracer::CanIntegrateInParallel(
+  vtkAbstractInterpolatedVelocityField* func, vtkIdType numLines,
+  vtkDataSetAttributes* outputPD, double propagation, vtkIdType numSteps,
+  double integrationTime)
+{
+  // The streamlines are concatenated by copying the thread arrays into the
+  // output arrays of the same index, and only the first streamline starts
+  // with the given propagation, number of steps and integration time.
+  return numLines > 1 && this->HasMatchingPointAttributes &&
+    this->CustomTerminationCallback.empty() &&
+    vtkCompositeInterpolatedVelocityField::SafeDownCast(func) &&
+    !vtkAMRInterpolatedVelocityField::SafeDownCast(func) &&
+    outputPD->GetNumberOfArrays() == 0 &&
+    propagation == 0.0 && numSteps == 0 && integrationTime == 0.0;
+}
+
 void vtkStreamTracer::Integrate(vtkPointData *input0Data,
                                 vtkPolyData* output,
                                 vtkDataArray* seedSource,
@@ -674,9 +1305,6 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   // Useful pointers
   vtkDataSetAttributes* outputPD = output->GetPointData();
   vtkDataSetAttributes* outputCD = output->GetCellData();
-  vtkPointData* inputPD;
-  vtkDataSet* input;
-  vtkDataArray* inVectors;
 
   int direction=1;
 
@@ -686,6 +1314,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
     return;
   }
 
+  bool parallel = this->CanIntegrateInParallel(func, numLines, outputPD,
+                                               propagation, numSteps,
+                                               integrationTime);
+
   double* weights = nullptr;
   if ( maxCellSize > 0 )
   {
@@ -785,376 +1417,175 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
                                  this->MaximumNumberOfSteps );
 
   vtkIdType numPtsTotal=0;
-  double velocity[3];
 
   int shouldAbort = 0;
 
-  for(int currentLine = 0; currentLine < numLines; currentLine++)
+  if (parallel)
   {
-
-    double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
-
-    switch (integrationDirections->GetValue(currentLine))
-    {
-      case FORWARD:
-        direction = 1;
-        break;
-      case BACKWARD:
-        direction = -1;
-        break;
-    }
-
-    // temporary variables used in the integration
-    double point1[3], point2[3], pcoords[3], vort[3], omega;
-    vtkIdType index, numPts=0;
-
-    // Clear the last cell to avoid starting a search from
-    // the last point in the streamline
-    func->ClearLastCellId();
-
-    // Initial point
-    seedSource->GetTuple(seedIds->GetId(currentLine), point1);
-    memcpy(point2, point1, 3*sizeof(double));
-    if (!func->FunctionValues(point1, velocity))
-    {
-      continue;
-    }
-
-    if ( propagation >= this->MaximumPropagation ||
-         numSteps    >  this->MaximumNumberOfSteps)
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(this->InputData->NewIterator());
+    for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal();
+         iter->GoToNextItem())
     {
-      continue;
-    }
-
-    numPts++;
-    numPtsTotal++;
-    vtkIdType nextPoint = outputPoints->InsertNextPoint(point1);
-    double lastInsertedPoint[3];
-    outputPoints->GetPoint(nextPoint, lastInsertedPoint);
-    time->InsertNextValue(integrationTime);
-
-    // We will always pass an arc-length step size to the integrator.
-    // If the user specifies a step size in cell length unit, we will
-    // have to convert it to arc length.
-    IntervalInformation stepSize;  // either positive or negative
-    stepSize.Unit  = LENGTH_UNIT;
-    stepSize.Interval = 0;
-    IntervalInformation aStep; // always positive
-    aStep.Unit = LENGTH_UNIT;
-    double step, minStep=0, maxStep=0;
-    double stepTaken;
-    double speed;
-    double cellLength;
-    int retVal=OUT_OF_LENGTH, tmp;
-
-    // Make sure we use the dataset found by the vtkAbstractInterpolatedVelocityField
-    input = func->GetLastDataSet();
-    inputPD = input->GetPointData();
-    inVectors = input->GetAttributesAsFieldData(vecType)->GetArray(vecName);
-    // Convert intervals to arc-length unit
-    input->GetCell(func->GetLastCellId(), cell);
-    cellLength = sqrt(static_cast<double>(cell->GetLength2()));
-    speed = vtkMath::Norm(velocity);
-    // Never call conversion methods if speed == 0
-    if ( speed != 0.0 )
-    {
-      this->ConvertIntervals( stepSize.Interval, minStep, maxStep,
-                              direction, cellLength );
+      vtkDataSet* inp = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+      if (inp)
+      {
+        SMPSeedIntegrator::PrepareDataSet(inp);
+      }
     }
 
-    // Interpolate all point attributes on first point
-    func->GetLastWeights(weights);
-    InterpolatePoint(outputPD, inputPD, nextPoint, cell->PointIds, weights, this->HasMatchingPointAttributes);
-    // handle both point and cell velocity attributes.
-    vtkDataArray* outputVelocityVectors = outputPD->GetArray(vecName);
-    if(vecType != vtkDataObject::POINT)
-    {
-      velocityVectors->InsertNextTuple(velocity);
-      outputVelocityVectors = velocityVectors;
-    }
+    this->UpdateProgress(0.0);
+    SMPSeedIntegrator seedIntegrator(this, func, input0Data, seedSource,
+                                     seedIds, integrationDirections,
+                                     maxCellSize, vecType, vecName);
+    vtkSMPTools::For(0, numLines, 1, seedIntegrator);
+    shouldAbort = seedIntegrator.Aborted;
 
-    // Compute vorticity if required
-    // This can be used later for streamribbon generation.
-    if (this->ComputeVorticity)
+    // Concatenate the streamlines in the order of the seeds.
+    for (vtkIdType currentLine = 0; currentLine < numLines && !shouldAbort;
+         currentLine++)
     {
-      if(vecType == vtkDataObject::POINT)
+      const SMPSeedIntegrator::SeedResult& result =
+        seedIntegrator.Results[currentLine];
+      if (result.HasLastPoint)
       {
-        inVectors->GetTuples(cell->PointIds, cellVectors);
-        func->GetLastLocalCoordinates(pcoords);
-        vtkStreamTracer::CalculateVorticity(cell, pcoords, cellVectors, vort);
+        memcpy(lastPoint, result.LastPoint, 3*sizeof(double));
       }
-      else
+      if (result.HasLastUsedStepSize)
       {
-        vort[0] = 0;
-        vort[1] = 0;
-        vort[2] = 0;
-      }
-      vorticity->InsertNextTuple(vort);
-      // rotation
-      // local rotation = vorticity . unit tangent ( i.e. velocity/speed )
-      if (speed != 0.0)
-      {
-        omega = vtkMath::Dot(vort, velocity);
-        omega /= speed;
-        omega *= this->RotationScale;
+        this->LastUsedStepSize = result.LastUsedStepSize;
       }
-      else
+      if (!result.Data)
       {
-        omega = 0.0;
+        continue;
       }
-      angularVel->InsertNextValue(omega);
-      rotation->InsertNextValue(0.0);
-    }
-
-    double error = 0;
-
-    // Integrate until the maximum propagation length is reached,
-    // maximum number of steps is reached or until a boundary is encountered.
-    // Begin Integration
-    while ( propagation < this->MaximumPropagation )
-    {
 
-      if (numSteps > this->MaximumNumberOfSteps)
+      SMPSeedIntegrator::LocalData* data = result.Data;
+      vtkIdType numPts = result.NumberOfPoints;
+      outputPoints->GetData()->InsertTuples(
+        numPtsTotal, numPts, result.FirstPoint, data->Points->GetData());
+      time->InsertTuples(numPtsTotal, numPts, result.FirstPoint, data->Time);
+      for (int i = 0; i < outputPD->GetNumberOfArrays(); ++i)
       {
-        retVal = OUT_OF_STEPS;
-        break;
+        outputPD->GetAbstractArray(i)->InsertTuples(
+          numPtsTotal, numPts, result.FirstPoint,
+          data->PointData->GetAbstractArray(i));
       }
-
-      bool endIntegration = false;
-      for (std::size_t i = 0; i < this->CustomTerminationCallback.size(); ++i)
+      if(vecType != vtkDataObject::POINT)
       {
-        if(this->CustomTerminationCallback[i](this->CustomTerminationClientData[i],
-                                              outputPoints, outputVelocityVectors, direction))
-        {
-          retVal = this->CustomReasonForTermination[i];
-          endIntegration = true;
-          break;
-        }
+        velocityVectors->InsertTuples(numPtsTotal, numPts, result.FirstPoint,
+                                      data->VelocityVectors);
       }
-      if (endIntegration)
+      if (vorticity)
       {
-        break;
+        vorticity->InsertTuples(numPtsTotal, numPts, result.FirstPoint,
+                                data->Vorticity);
+        rotation->InsertTuples(numPtsTotal, numPts, result.FirstPoint,
+                               data->Rotation);
+        angularVel->InsertTuples(numPtsTotal, numPts, result.FirstPoint,
+                                 data->AngularVel);
       }
+      numPtsTotal += numPts;
 
-      if ( numSteps++ % 1000 == 1 )
+      if (numPts > 1)
       {
-        progress =
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
-
-        if (this->GetAbortExecute())
+        outputLines->InsertNextCell(numPts);
+        for (vtkIdType i=numPtsTotal-numPts; i<numPtsTotal; i++)
         {
-          shouldAbort = 1;
-          break;
+          outputLines->InsertCellPoint(i);
         }
+        retVals->InsertNextValue(result.RetVal);
+        sids->InsertNextValue(seedIds->GetId(currentLine));
       }
 
-      // Never call conversion methods if speed == 0
-      if ( (speed == 0) || (speed <= this->TerminalSpeed) )
-      {
-        retVal = STAGNATION;
-        break;
-      }
+      inPropagation = result.Propagation;
+      inNumSteps = result.NumSteps;
+      inIntegrationTime = result.IntegrationTime;
+    }
+    this->UpdateProgress(1.0);
+  }
+  else
+  {
+    StreamlineIntegrator streamline;
+    streamline.Self = this;
+    streamline.Func = func;
+    streamline.SurfaceFunc = surfaceFunc;
+    streamline.Integrator = integrator;
+    streamline.Cell = cell;
+    streamline.CellVectors = cellVectors;
+    streamline.Weights = weights;
+    streamline.VecType = vecType;
+    streamline.VecName = vecName;
+    streamline.ReportProgress = true;
+    streamline.Points = outputPoints;
+    streamline.PointData = outputPD;
+    streamline.Time = time;
+    streamline.VelocityVectors = velocityVectors;
+    streamline.Vorticity = vorticity;
+    streamline.Rotation = rotation;
+    streamline.AngularVel = angularVel;
+
+    for(int currentLine = 0; currentLine < numLines; currentLine++)
+    {
 
-      // If, with the next step, propagation will be larger than
-      // max, reduce it so that it is (approximately) equal to max.
-      aStep.Interval = fabs( stepSize.Interval );
+      double progress = static_cast<double>(currentLine)/numLines;
+      this->UpdateProgress(progress);
 
-      if ( ( propagation + aStep.Interval ) > this->MaximumPropagation )
+      switch (integrationDirections->GetValue(currentLine))
       {
-        aStep.Interval = this->MaximumPropagation - propagation;
-        if ( stepSize.Interval >= 0 )
-        {
-          stepSize.Interval = this->ConvertToLength( aStep, cellLength );
-        }
-        else
-        {
-          stepSize.Interval = this->ConvertToLength( aStep, cellLength ) * ( -1.0 );
-        }
-        maxStep = stepSize.Interval;
-      }
-      this->LastUsedStepSize = stepSize.Interval;
-
-      // Calculate the next step using the integrator provided
-      // Break if the next point is out of bounds.
-      func->SetNormalizeVector( true );
-      tmp = integrator->ComputeNextStep( point1, point2, 0, stepSize.Interval,
-                                         stepTaken, minStep, maxStep,
-                                         this->MaximumError, error );
-      func->SetNormalizeVector( false );
-      if ( tmp != 0 )
-      {
-        retVal = tmp;
-        memcpy(lastPoint, point2, 3*sizeof(double));
-        break;
-      }
-
-      // This is the next starting point
-      if (this->SurfaceStreamlines && surfaceFunc != nullptr)
-      {
-        if (surfaceFunc->SnapPointOnCell(point2, point1) != 1)
-        {
-          retVal = OUT_OF_DOMAIN;
-          memcpy(lastPoint, point2, 3 * sizeof(double));
+        case FORWARD:
+          direction = 1;
+          break;
+        case BACKWARD:
+          direction = -1;
           break;
-        }
-      }
-      else
-      {
-        for (int i = 0; i < 3; i++)
-        {
-          point1[i] = point2[i];
-        }
       }
 
-      // Interpolate the velocity at the next point
-      if ( !func->FunctionValues(point2, velocity) )
+      double seed[3];
+      seedSource->GetTuple(seedIds->GetId(currentLine), seed);
+      int retVal = OUT_OF_LENGTH;
+      vtkIdType numPts = streamline.Integrate(seed, direction, currentLine,
+                                              numLines, propagation, numSteps,
+                                              integrationTime, lastPoint,
+                                              retVal, shouldAbort);
+      if (streamline.HasLastUsedStepSize)
       {
-        retVal = OUT_OF_DOMAIN;
-        memcpy(lastPoint, point2, 3*sizeof(double));
-        break;
+        this->LastUsedStepSize = streamline.LastUsedStepSize;
       }
 
-      // It is not enough to use the starting point for stagnation calculation
-      // Use average speed to check if it is below stagnation threshold
-      double speed2 = vtkMath::Norm(velocity);
-      if ( (speed+speed2)/2 <= this->TerminalSpeed )
+      if (shouldAbort)
       {
-        retVal = STAGNATION;
         break;
       }
 
-      integrationTime += stepTaken / speed;
-      // Calculate propagation (using the same units as MaximumPropagation
-      propagation += fabs( stepSize.Interval );
-
-      // Make sure we use the dataset found by the vtkAbstractInterpolatedVelocityField
-      input = func->GetLastDataSet();
-      inputPD = input->GetPointData();
-      inVectors = input->GetAttributesAsFieldData(vecType)->GetArray(vecName);
-
-      // Calculate cell length and speed to be used in unit conversions
-      input->GetCell(func->GetLastCellId(), cell);
-      cellLength = sqrt(static_cast<double>(cell->GetLength2()));
-      speed = speed2;
-
-      // Check if conversion to float will produce a point in same place
-      float convertedPoint[3];
-      for (int i = 0; i < 3; i++)
-      {
-        convertedPoint[i] = point1[i];
-      }
-      if (lastInsertedPoint[0] != convertedPoint[0] ||
-          lastInsertedPoint[1] != convertedPoint[1] ||
-          lastInsertedPoint[2] != convertedPoint[2])
+      if (numPts == 0)
       {
-        // Point is valid. Insert it.
-        numPts++;
-        numPtsTotal++;
-        nextPoint = outputPoints->InsertNextPoint(point1);
-        outputPoints->GetPoint(nextPoint, lastInsertedPoint);
-        time->InsertNextValue(integrationTime);
-
-        // Interpolate all point attributes on current point
-        func->GetLastWeights(weights);
-        InterpolatePoint(outputPD, inputPD, nextPoint, cell->PointIds, weights, this->HasMatchingPointAttributes);
-
-        if(vecType != vtkDataObject::POINT)
-        {
-          velocityVectors->InsertNextTuple(velocity);
-        }
-        // Compute vorticity if required
-        // This can be used later for streamribbon generation.
-        if (this->ComputeVorticity)
-        {
-          if(vecType == vtkDataObject::POINT)
-          {
-            inVectors->GetTuples(cell->PointIds, cellVectors);
-            func->GetLastLocalCoordinates(pcoords);
-            vtkStreamTracer::CalculateVorticity(cell, pcoords, cellVectors, vort);
-          }
-          else
-          {
-            vort[0] = 0;
-            vort[1] = 0;
-            vort[2] = 0;
-          }
-          vorticity->InsertNextTuple(vort);
-          // rotation
-          // angular velocity = vorticity . unit tangent ( i.e. velocity/speed )
-          // rotation = sum ( angular velocity * stepSize )
-          omega = vtkMath::Dot(vort, velocity);
-          omega /= speed;
-          omega *= this->RotationScale;
-          index = angularVel->InsertNextValue(omega);
-          rotation->InsertNextValue(rotation->GetValue(index-1) +
-                                    (angularVel->GetValue(index-1) + omega)/2 *
-                                    (integrationTime - time->GetValue(index-1)));
-        }
+        continue;
       }
+      numPtsTotal += numPts;
 
-      // Never call conversion methods if speed == 0
-      if ( (speed == 0) || (speed <= this->TerminalSpeed) )
+      if (numPts > 1)
       {
-        retVal = STAGNATION;
-        break;
-      }
-
-      // Convert all intervals to arc length
-      this->ConvertIntervals( step, minStep, maxStep, direction, cellLength );
-
-
-      // If the solver is adaptive and the next step size (stepSize.Interval)
-      // that the solver wants to use is smaller than minStep or larger
-      // than maxStep, re-adjust it. This has to be done every step
-      // because minStep and maxStep can change depending on the cell
-      // size (unless it is specified in arc-length unit)
-      if (integrator->IsAdaptive())
-      {
-        if (fabs(stepSize.Interval) < fabs(minStep))
+        outputLines->InsertNextCell(numPts);
+        for (int i=numPtsTotal-numPts; i<numPtsTotal; i++)
         {
-          stepSize.Interval = fabs( minStep ) *
-                                stepSize.Interval / fabs( stepSize.Interval );
+          outputLines->InsertCellPoint(i);
         }
-        else if (fabs(stepSize.Interval) > fabs(maxStep))
-        {
-          stepSize.Interval = fabs( maxStep ) *
-                                stepSize.Interval / fabs( stepSize.Interval );
-        }
-      }
-      else
-      {
-        stepSize.Interval = step;
+        retVals->InsertNextValue(retVal);
+        sids->InsertNextValue(seedIds->GetId(currentLine));
       }
-    }
 
-    if (shouldAbort)
-    {
-      break;
-    }
+      // Initialize these to 0 before starting the next line.
+      // The values passed in the function call are only used
+      // for the first line.
+      inPropagation = propagation;
+      inNumSteps = numSteps;
+      inIntegrationTime = integrationTime;
 
-    if (numPts > 1)
-    {
-      outputLines->InsertNextCell(numPts);
-      for (int i=numPtsTotal-numPts; i<numPtsTotal; i++)
-      {
-        outputLines->InsertCellPoint(i);
-      }
-      retVals->InsertNextValue(retVal);
-      sids->InsertNextValue(seedIds->GetId(currentLine));
+      propagation = 0;
+      numSteps = 0;
+      integrationTime = 0;
     }
-
-    // Initialize these to 0 before starting the next line.
-    // The values passed in the function call are only used
-    // for the first line.
-    inPropagation = propagation;
-    inNumSteps = numSteps;
-    inIntegrationTime = integrationTime;
-
-    propagation = 0;
-    numSteps = 0;
-    integrationTime = 0;
   }
 
   if (!shouldAbort)
@@ -69,6 +69,13 @@
  * a source object, traces will be generated from each point in the source
  * that is inside the dataset.
  *
+ * When there are several seeds, their streamlines are integrated in parallel
+ * with vtkSMPTools, each thread using its own copy of the interpolated
+ * velocity field and of the integrator. The streamlines are output in the
+ * order of the seeds, as with a serial integration. The integration is
+ * serial with AMR inputs, custom termination callbacks, or blocks whose
+ * point data arrays do not match.
+ *
  * @sa
  * vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
  * vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkTemporalStreamTracer
@@ -420,6 +427,18 @@ protected:
                   int* maxCellSize);
   void GenerateNormals(vtkPolyData* output, double* firstNormal, const char *vecName);
 
+  // Integration of the streamline of one seed, shared by the serial and the
+  // threaded integrations, see vtkStreamTracer.cxx.
+  struct StreamlineIntegrator;
+  // Threaded integration of the seeds, see vtkStreamTracer.cxx.
+  struct SMPSeedIntegrator;
+  bool CanIntegrateInParallel(vtkAbstractInterpolatedVelocityField* func,
+                              vtkIdType numLines,
+                              vtkDataSetAttributes* outputPD,
+                              double propagation,
+                              vtkIdType numSteps,
+                              double integrationTime);
+
   bool GenerateNormalsInIntegrate;
 
   // starting from global x-y-z position
@@ -0,0 +1,433 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGradientFilterUnstructured.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compute the gradients, vorticity, divergence and Q-criterion of linear
+// fields on a distorted mesh of hexahedra, tetrahedra and wedges, which are
+// exact, with all the options selecting the contributing cells, on a
+// polydata surface, and of a field of 9 components on polyhedra.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGradientFilter.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace
+{
+
+const int Dim = 16;
+
+// The gradient of the scalars and of the vectors, for which the vorticity
+// is (2, 0, 1), the divergence 5 and the Q-criterion -(1 + 16) / 2 - 5.
+const double ScalarGradient[3] = { 2.0, -3.0, 0.5 };
+const double VectorGradient[9] = { 1.0, 2.0, 0.0, 3.0, 0.0, -1.0,
+                                   0.0, 1.0, 4.0 };
+const double Vorticity[3] = { 2.0, 0.0, 1.0 };
+const double Divergence = 5.0;
+const double QCriterion = -13.5;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Dim * (j + Dim * k);
+}
+
+void AddFields(vtkDataSet *ds)
+{
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  scalars->SetNumberOfTuples(ds->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(ds->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < ds->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    ds->GetPoint(i, x);
+    scalars->SetValue(i, 1.0 + vtkMath::Dot(ScalarGradient, x));
+    double v[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      v[c] = vtkMath::Dot(VectorGradient + 3 * c, x);
+    }
+    vectors->SetTypedTuple(i, v);
+  }
+  ds->GetPointData()->AddArray(scalars);
+  ds->GetPointData()->AddArray(vectors);
+}
+
+// Hexahedra, with some cubes split into tetrahedra or wedges, on distorted
+// points. A line joins the last two points, which are not used by the 3D
+// cells, and another line an edge of the first hexahedron.
+void MakeGrid(vtkUnstructuredGrid *ugrid)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < Dim; ++k)
+  {
+    for (int j = 0; j < Dim; ++j)
+    {
+      for (int i = 0; i < Dim; ++i)
+      {
+        points->InsertNextPoint(i + 0.2 * std::sin(j + 2.0 * k),
+                                j + 0.2 * std::cos(i * k + 1.0),
+                                k + 0.2 * std::sin(1.0 * i * j));
+      }
+    }
+  }
+  vtkIdType lone = points->InsertNextPoint(-2.0, 0.0, 0.0);
+  points->InsertNextPoint(-1.0, 0.0, 0.0);
+  ugrid->SetPoints(points);
+
+  ugrid->Allocate((Dim - 1) * (Dim - 1) * (Dim - 1) * 5);
+  for (int k = 0; k < Dim - 1; ++k)
+  {
+    for (int j = 0; j < Dim - 1; ++j)
+    {
+      for (int i = 0; i < Dim - 1; ++i)
+      {
+        vtkIdType p[8] = {
+          PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        int kind = (i + 2 * j + 3 * k) % 5;
+        if (kind == 1)
+        {
+          vtkIdType tetras[5][4] = { { p[0], p[1], p[3], p[4] },
+                                     { p[1], p[2], p[3], p[6] },
+                                     { p[1], p[4], p[5], p[6] },
+                                     { p[3], p[4], p[6], p[7] },
+                                     { p[1], p[3], p[4], p[6] } };
+          for (int t = 0; t < 5; ++t)
+          {
+            ugrid->InsertNextCell(VTK_TETRA, 4, tetras[t]);
+          }
+        }
+        else if (kind == 3)
+        {
+          vtkIdType wedges[2][6] = { { p[0], p[1], p[3], p[4], p[5], p[7] },
+                                     { p[1], p[2], p[3], p[5], p[6], p[7] } };
+          ugrid->InsertNextCell(VTK_WEDGE, 6, wedges[0]);
+          ugrid->InsertNextCell(VTK_WEDGE, 6, wedges[1]);
+        }
+        else
+        {
+          ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, p);
+        }
+      }
+    }
+  }
+  vtkIdType lines[2][2] = { { lone, lone + 1 },
+                            { PointId(0, 0, 0), PointId(1, 0, 0) } };
+  ugrid->InsertNextCell(VTK_LINE, 2, lines[0]);
+  ugrid->InsertNextCell(VTK_LINE, 2, lines[1]);
+  AddFields(ugrid);
+}
+
+// Triangles and quads on the plane z = 0.
+void MakeSurface(vtkPolyData *pdata)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int j = 0; j < Dim; ++j)
+  {
+    for (int i = 0; i < Dim; ++i)
+    {
+      points->InsertNextPoint(i + 0.3 * std::sin(1.0 * j), j, 0.0);
+    }
+  }
+  pdata->SetPoints(points);
+  vtkNew<vtkCellArray> polys;
+  for (int j = 0; j < Dim - 1; ++j)
+  {
+    for (int i = 0; i < Dim - 1; ++i)
+    {
+      vtkIdType p[4] = { PointId(i, j, 0), PointId(i + 1, j, 0),
+                         PointId(i + 1, j + 1, 0), PointId(i, j + 1, 0) };
+      if ((i + j) % 3 == 0)
+      {
+        vtkIdType triangles[2][3] = { { p[0], p[1], p[2] },
+                                      { p[0], p[2], p[3] } };
+        polys->InsertNextCell(3, triangles[0]);
+        polys->InsertNextCell(3, triangles[1]);
+      }
+      else
+      {
+        polys->InsertNextCell(4, p);
+      }
+    }
+  }
+  pdata->SetPolys(polys);
+  AddFields(pdata);
+}
+
+// Cubes given as polyhedra, with a field of 9 components and a scalar
+// array for each of its components.
+void MakePolyhedra(vtkUnstructuredGrid *ugrid)
+{
+  const int dim = 4;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int k = 0; k < dim; ++k)
+  {
+    for (int j = 0; j < dim; ++j)
+    {
+      for (int i = 0; i < dim; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+      }
+    }
+  }
+  ugrid->SetPoints(points);
+
+  ugrid->Allocate((dim - 1) * (dim - 1) * (dim - 1));
+  for (int k = 0; k < dim - 1; ++k)
+  {
+    for (int j = 0; j < dim - 1; ++j)
+    {
+      for (int i = 0; i < dim - 1; ++i)
+      {
+        vtkIdType p[8];
+        for (int c = 0; c < 8; ++c)
+        {
+          int di = ((c + 1) / 2) % 2, dj = (c / 2) % 2, dk = c / 4;
+          p[c] = i + di + dim * (j + dj + dim * (k + dk));
+        }
+        vtkIdType faces[30] = { 4, p[0], p[3], p[2], p[1],
+                                4, p[4], p[5], p[6], p[7],
+                                4, p[0], p[1], p[5], p[4],
+                                4, p[1], p[2], p[6], p[5],
+                                4, p[2], p[3], p[7], p[6],
+                                4, p[3], p[0], p[4], p[7] };
+        ugrid->InsertNextCell(VTK_POLYHEDRON, 8, p, 6, faces);
+      }
+    }
+  }
+
+  vtkNew<vtkDoubleArray> field;
+  field->SetName("Field");
+  field->SetNumberOfComponents(9);
+  field->SetNumberOfTuples(ugrid->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < ugrid->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    ugrid->GetPoint(i, x);
+    for (int c = 0; c < 9; ++c)
+    {
+      field->SetComponent(i, c, (c + 1.0) * x[0] - c * x[1] * x[1] +
+                          0.5 * x[2] * x[0]);
+    }
+  }
+  ugrid->GetPointData()->AddArray(field);
+  for (int c = 0; c < 9; ++c)
+  {
+    vtkNew<vtkDoubleArray> component;
+    std::string name = "Component" + std::to_string(c);
+    component->SetName(name.c_str());
+    component->SetNumberOfTuples(ugrid->GetNumberOfPoints());
+    component->CopyComponent(0, field, c);
+    ugrid->GetPointData()->AddArray(component);
+  }
+}
+
+bool Near(double a, double b)
+{
+  return std::abs(a - b) <= 1e-8 * (1.0 + std::abs(b));
+}
+
+// Check the first tuples of an array against the expected values.
+int CheckArray(vtkFieldData *fd, const char *name, const double *expected,
+               int numComps, vtkIdType numTuples, const char *label)
+{
+  vtkDataArray *array = fd->GetArray(name);
+  if (!array || array->GetNumberOfComponents() != numComps)
+  {
+    cerr << label << ": no " << name << " array" << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < numTuples; ++i)
+  {
+    for (int c = 0; c < numComps; ++c)
+    {
+      if (!Near(array->GetComponent(i, c), expected[c]))
+      {
+        cerr << label << ": wrong " << name << " at " << i << ", got "
+             << array->GetComponent(i, c) << " instead of " << expected[c]
+             << endl;
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+// Compute the gradients of a point array of the grid, and the derived
+// quantities of the vectors.
+vtkPointData *ComputeGradients(vtkGradientFilter *filter,
+                               vtkUnstructuredGrid *ugrid, const char *name,
+                               int option)
+{
+  filter->SetInputData(ugrid);
+  filter->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS, name);
+  filter->SetContributingCellOption(option);
+  filter->SetReplacementValueOption(vtkGradientFilter::DataTypeMax);
+  bool vectors =
+    ugrid->GetPointData()->GetArray(name)->GetNumberOfComponents() == 3;
+  filter->SetComputeDivergence(vectors);
+  filter->SetComputeVorticity(vectors);
+  filter->SetComputeQCriterion(vectors);
+  filter->Update();
+  return filter->GetOutput()->GetPointData();
+}
+
+int TestGrid()
+{
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakeGrid(ugrid);
+  vtkIdType lone = ugrid->GetNumberOfPoints() - 2;
+
+  // With all the cells, the gradients at the corner of the first hexahedron
+  // are averaged with the derivative along the line.
+  vtkNew<vtkGradientFilter> all;
+  vtkPointData *pd =
+    ComputeGradients(all, ugrid, "Vectors", vtkGradientFilter::All);
+  if (Near(pd->GetArray("Gradients")->GetComponent(0, 1), VectorGradient[1]))
+  {
+    cerr << "all: the line does not contribute" << endl;
+    return 1;
+  }
+
+  // The lines do not contribute with Patch and DataSetMax, except at the
+  // points of the lone line with Patch. With DataSetMax, these get the
+  // replacement value.
+  int rval = 0;
+  int options[2] = { vtkGradientFilter::Patch, vtkGradientFilter::DataSetMax };
+  for (int option : options)
+  {
+    vtkNew<vtkGradientFilter> filter;
+    const char *label =
+      option == vtkGradientFilter::Patch ? "patch" : "data set max";
+    pd = ComputeGradients(filter, ugrid, "Vectors", option);
+    rval |= CheckArray(pd, "Gradients", VectorGradient, 9, lone, label);
+    rval |= CheckArray(pd, "Vorticity", Vorticity, 3, lone, label);
+    rval |= CheckArray(pd, "Divergence", &Divergence, 1, lone, label);
+    rval |= CheckArray(pd, "Q-criterion", &QCriterion, 1, lone, label);
+
+    double du = pd->GetArray("Gradients")->GetComponent(lone, 0);
+    if (option == vtkGradientFilter::Patch && !Near(du, VectorGradient[0]))
+    {
+      cerr << label << ": wrong derivative along the line " << du << endl;
+      rval = 1;
+    }
+    if (option == vtkGradientFilter::DataSetMax && du != std::numeric_limits<double>::max())
+    {
+      cerr << label << ": expected the replacement value, got " << du
+           << endl;
+      rval = 1;
+    }
+
+    vtkNew<vtkGradientFilter> scalarFilter;
+    pd = ComputeGradients(scalarFilter, ugrid, "Scalars", option);
+    rval |= CheckArray(pd, "Gradients", ScalarGradient, 3, lone, label);
+  }
+  return rval;
+}
+
+// The point gradients, and the cell gradients averaged at the points with
+// the faster approximation.
+int TestSurface()
+{
+  vtkNew<vtkPolyData> pdata;
+  MakeSurface(pdata);
+  double expected[3] = { ScalarGradient[0], ScalarGradient[1], 0.0 };
+  int rval = 0;
+  for (int faster = 0; faster < 2; ++faster)
+  {
+    vtkNew<vtkGradientFilter> filter;
+    filter->SetInputData(pdata);
+    filter->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                            "Scalars");
+    filter->SetFasterApproximation(faster);
+    filter->Update();
+    rval |= CheckArray(filter->GetOutput()->GetPointData(), "Gradients",
+                       expected, 3, pdata->GetNumberOfPoints(),
+                       faster ? "faster surface" : "surface");
+  }
+  return rval;
+}
+
+// The derivatives of the polyhedra are computed for the 9 components at
+// once, which must give the gradients of each component.
+int TestPolyhedra()
+{
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  MakePolyhedra(ugrid);
+  vtkNew<vtkGradientFilter> filter;
+  filter->SetInputData(ugrid);
+  filter->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS, "Field");
+  filter->Update();
+  vtkDataArray *gradients =
+    filter->GetOutput()->GetPointData()->GetArray("Gradients");
+  if (!gradients || gradients->GetNumberOfComponents() != 27)
+  {
+    cerr << "polyhedra: no gradients of the 9 components" << endl;
+    return 1;
+  }
+
+  for (int c = 0; c < 9; ++c)
+  {
+    std::string name = "Component" + std::to_string(c);
+    vtkNew<vtkGradientFilter> componentFilter;
+    componentFilter->SetInputData(ugrid);
+    componentFilter->SetInputScalars(vtkDataObject::FIELD_ASSOCIATION_POINTS,
+                                     name.c_str());
+    componentFilter->Update();
+    vtkDataArray *expected = componentFilter->GetOutput()->GetPointData()
+      ->GetArray("Gradients");
+    for (vtkIdType i = 0; i < ugrid->GetNumberOfPoints(); ++i)
+    {
+      for (int d = 0; d < 3; ++d)
+      {
+        double value = gradients->GetComponent(i, 3 * c + d);
+        if (!Near(value, expected->GetComponent(i, d)))
+        {
+          cerr << "polyhedra: wrong gradient of component " << c << " at "
+               << i << ", got " << value << " instead of "
+               << expected->GetComponent(i, d) << endl;
+          return 1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+}
+
+int TestGradientFilterUnstructured(int, char *[])
+{
+  int rval = TestGrid();
+  rval |= TestSurface();
+  rval |= TestPolyhedra();
+  return rval;
+}
@@ -0,0 +1,204 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSetPieces.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Clip a dataset in several pieces, and check that the points along the
+// piece boundaries are merged, that the output matches the one of a single
+// piece, and that image, structured and unstructured inputs describing the
+// same hexahedra give the same output.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <array>
+#include <cmath>
+#include <set>
+
+namespace
+{
+
+int CheckUniquePoints(vtkUnstructuredGrid *output, const char *label)
+{
+  std::set< std::array<double, 3> > points;
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    std::array<double, 3> x;
+    output->GetPoint(i, x.data());
+    if (!points.insert(x).second)
+    {
+      cerr << label << ": point " << i << " is duplicated" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int CompareOutputs(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b,
+                   const char *label)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    cerr << label << ": expected " << a->GetNumberOfCells() << " cells and "
+         << a->GetNumberOfPoints() << " points, got " << b->GetNumberOfCells()
+         << " and " << b->GetNumberOfPoints() << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      cerr << label << ": point " << i << " differs" << endl;
+      return 1;
+    }
+  }
+  vtkDataArray *aIds = a->GetCellData()->GetArray("CellIds");
+  vtkDataArray *bIds = b->GetCellData()->GetArray("CellIds");
+  vtkNew<vtkIdList> aPts;
+  vtkNew<vtkIdList> bPts;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, aPts);
+    b->GetCellPoints(i, bPts);
+    bool same = a->GetCellType(i) == b->GetCellType(i) &&
+      aPts->GetNumberOfIds() == bPts->GetNumberOfIds() &&
+      aIds->GetComponent(i, 0) == bIds->GetComponent(i, 0);
+    for (vtkIdType j = 0; same && j < aPts->GetNumberOfIds(); ++j)
+    {
+      same = aPts->GetId(j) == bPts->GetId(j);
+    }
+    if (!same)
+    {
+      cerr << label << ": cell " << i << " differs" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// Clip the input in a single piece and in the given number of pieces, and
+// check that both give the same output.
+vtkSmartPointer<vtkUnstructuredGrid> Clip(vtkDataSet *input, int insideOut,
+                                          int numPieces, const char *label,
+                                          int &rval)
+{
+  vtkNew<vtkTableBasedClipDataSet> serial;
+  serial->SetInputData(input);
+  serial->SetValue(20.25);
+  serial->SetInsideOut(insideOut);
+  serial->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  serial->SetNumberOfPieces(1);
+  serial->Update();
+
+  vtkNew<vtkTableBasedClipDataSet> pieces;
+  pieces->SetInputData(input);
+  pieces->SetValue(20.25);
+  pieces->SetInsideOut(insideOut);
+  pieces->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  pieces->SetNumberOfPieces(numPieces);
+  pieces->Update();
+
+  rval |= CheckUniquePoints(pieces->GetOutput(), label);
+  rval |= CompareOutputs(serial->GetOutput(), pieces->GetOutput(), label);
+  return pieces->GetOutput();
+}
+
+}
+
+int TestTableBasedClipDataSetPieces(int, char *[])
+{
+  // A 64^3 cells image with a spherical scalar field.
+  const int dim = 65;
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dim, dim, dim);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Distance");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    scalars->SetValue(i, std::sqrt((x[0] - 30.5) * (x[0] - 30.5) +
+                                   (x[1] - 33.0) * (x[1] - 33.0) +
+                                   (x[2] - 31.5) * (x[2] - 31.5)));
+  }
+  image->GetPointData()->SetScalars(scalars);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  cellIds->SetNumberOfValues(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  image->GetCellData()->AddArray(cellIds);
+
+  // The same hexahedra as a structured grid and as an unstructured grid.
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    points->SetPoint(i, image->GetPoint(i));
+  }
+
+  vtkNew<vtkStructuredGrid> sgrid;
+  sgrid->SetDimensions(dim, dim, dim);
+  sgrid->SetPoints(points);
+  sgrid->GetPointData()->ShallowCopy(image->GetPointData());
+  sgrid->GetCellData()->ShallowCopy(image->GetCellData());
+
+  vtkNew<vtkUnstructuredGrid> ugrid;
+  ugrid->SetPoints(points);
+  ugrid->Allocate(image->GetNumberOfCells());
+  vtkNew<vtkIdList> voxel;
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    image->GetCellPoints(i, voxel);
+    vtkIdType hex[8] = { voxel->GetId(0), voxel->GetId(1), voxel->GetId(3),
+                         voxel->GetId(2), voxel->GetId(4), voxel->GetId(5),
+                         voxel->GetId(7), voxel->GetId(6) };
+    ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+  }
+  ugrid->GetPointData()->ShallowCopy(image->GetPointData());
+  ugrid->GetCellData()->ShallowCopy(image->GetCellData());
+
+  int rval = 0;
+  for (int insideOut = 0; insideOut < 2; ++insideOut)
+  {
+    vtkSmartPointer<vtkUnstructuredGrid> imageClip =
+      Clip(image, insideOut, 7, "image", rval);
+    vtkSmartPointer<vtkUnstructuredGrid> sgridClip =
+      Clip(sgrid, insideOut, 5, "structured", rval);
+    vtkSmartPointer<vtkUnstructuredGrid> ugridClip =
+      Clip(ugrid, insideOut, 11, "unstructured", rval);
+
+    rval |= CompareOutputs(imageClip, sgridClip, "structured");
+    rval |= CompareOutputs(imageClip, ugridClip, "unstructured");
+  }
+
+  return rval;
+}
@@ -23,8 +23,11 @@
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCellDataToPointData.h"
+#include "vtkCellTypes.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
+#include "vtkHexahedron.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -35,11 +38,17 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinks.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
+#include "vtkTetra.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -83,15 +92,21 @@ namespace
   }
 
   // Functions for unstructured grids and polydatas
+  int ComputeCellDimensions(vtkDataSet *structure,
+                            std::vector<unsigned char> &cellDimensions);
+
   template<class data_type>
   void ComputePointGradientsUG(
     vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence, int highestCellDimension, int contributingCellOption);
+    data_type* divergence, const unsigned char *cellDimensions,
+    int highestCellDimension, int contributingCellOption);
 
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
-    double parametricCoord[3]);
+    double parametricCoord[3], double *weights);
+
+  int GetCellPointIndex(vtkIdType pointId, vtkIdList *pointIds);
 
   template<class data_type>
   void ComputeCellGradientsUG(
@@ -448,28 +463,21 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
     }
   }
 
-  int highestCellDimension = 0;
-  if (this->ContributingCellOption == vtkGradientFilter::DataSetMax)
+  if (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
   {
-    int maxDimension = input->IsA("vtkPolyData") == 1 ? 2 : 3;
-    for (vtkIdType i=0;i<input->GetNumberOfCells();i++)
+    if (!this->FasterApproximation)
     {
-      int dim = input->GetCell(i)->GetCellDimension();
-      if (dim > highestCellDimension)
+      // Unless all the cells contribute, the dimension of each cell is needed.
+      std::vector<unsigned char> cellDimensions;
+      int highestCellDimension = 0;
+      if (this->ContributingCellOption != vtkGradientFilter::All)
       {
-        highestCellDimension = dim;
-        if (highestCellDimension == maxDimension)
+        int maxDimension = ComputeCellDimensions(input, cellDimensions);
+        if (this->ContributingCellOption == vtkGradientFilter::DataSetMax)
         {
-          break;
+          highestCellDimension = maxDimension;
         }
       }
-    }
-  }
-
-  if (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
-  {
-    if (!this->FasterApproximation)
-    {
       switch (arrayType)
       { // ok to use template macro here since we made the output arrays ourselves
         vtkFloatingPointTemplateMacro(ComputePointGradientsUG(
@@ -483,6 +491,8 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
                             static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                            (divergence == nullptr ? nullptr :
                             static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
+                           (cellDimensions.empty() ? nullptr :
+                            cellDimensions.data()),
                            highestCellDimension, this->ContributingCellOption));
       }
       if(gradients)
@@ -836,212 +846,551 @@ int vtkGradientFilter::GetOutputArrayType(vtkDataArray* array)
 
 namespace {
 //-----------------------------------------------------------------------------
-  template<class data_type>
-  void ComputePointGradientsUG(
-    vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
-    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence, int highestCellDimension, int contributingCellOption)
+  // The cells of unstructured grids and of polydatas, once their cells are
+  // built, can be accessed concurrently with a vtkGenericCell per thread.
+  // The other datasets are processed in serial.
+  template<class Functor>
+  void ForEachItem(vtkDataSet *structure, vtkIdType numberOfItems,
+                   Functor &functor)
   {
-    vtkNew<vtkIdList> currentPoint;
-    currentPoint->SetNumberOfIds(1);
-    vtkNew<vtkIdList> cellsOnPoint;
+    vtkPolyData *polyData = vtkPolyData::SafeDownCast(structure);
+    if (polyData && polyData->NeedToBuildCells())
+    {
+      polyData->BuildCells();
+    }
+    if (polyData || structure->IsA("vtkUnstructuredGrid"))
+    {
+      vtkSMPTools::For(0, numberOfItems, functor);
+    }
+    else
+    {
+      functor.Initialize();
+      functor(0, numberOfItems);
+      functor.Reduce();
+    }
+  }
 
-    vtkIdType numpts = structure->GetNumberOfPoints();
+//-----------------------------------------------------------------------------
+  // Compute the dimension of each cell from the dimension of its type, which
+  // is cheaper than getting the cells, and return the highest one.
+  struct CellDimensionsFromTypes
+  {
+    vtkDataSet *Structure;
+    const int *TypeDimensions;
+    unsigned char *CellDimensions;
 
-    int numberOfOutputComponents = 3*numberOfInputComponents;
-    std::vector<data_type> g(numberOfOutputComponents);
+    void operator()(vtkIdType cellId, vtkIdType endCellId)
+    {
+      for (; cellId < endCellId; ++cellId)
+      {
+        this->CellDimensions[cellId] = static_cast<unsigned char>(
+          this->TypeDimensions[this->Structure->GetCellType(cellId)]);
+      }
+    }
+  };
 
-    // if we are doing patches for contributing cell dimensions we want to keep track of
-    // the maximum expected dimension so we can exit out of the check loop quicker
-    const int maxCellDimension = structure->IsA("vtkPolyData") ? 2 : 3;
+  int ComputeCellDimensions(vtkDataSet *structure,
+                            std::vector<unsigned char> &cellDimensions)
+  {
+    int typeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+    int highestCellDimension = 0;
+    vtkNew<vtkCellTypes> types;
+    structure->GetCellTypes(types);
+    vtkNew<vtkGenericCell> cell;
+    for (vtkIdType i = 0; i < types->GetNumberOfTypes(); i++)
+    {
+      unsigned char type = types->GetCellType(i);
+      cell->SetCellType(type);
+      typeDimensions[type] = cell->GetCellDimension();
+      highestCellDimension = std::max(highestCellDimension,
+                                      typeDimensions[type]);
+    }
 
-    for (vtkIdType point = 0; point < numpts; point++)
+    cellDimensions.resize(structure->GetNumberOfCells());
+    CellDimensionsFromTypes computeDimensions =
+      { structure, typeDimensions, cellDimensions.data() };
+    if (structure->IsA("vtkUnstructuredGrid") || structure->IsA("vtkPolyData"))
+    {
+      vtkSMPTools::For(0, structure->GetNumberOfCells(), computeDimensions);
+    }
+    else
+    {
+      computeDimensions(0, structure->GetNumberOfCells());
+    }
+    return highestCellDimension;
+  }
+
+//-----------------------------------------------------------------------------
+  // Compute the derivatives of the values at the points of a linear
+  // tetrahedron or hexahedron from the coordinates of its points and the
+  // derivatives of its interpolation functions, with the same operations as
+  // vtkTetra::Derivatives() and vtkHexahedron::Derivatives(). The number of
+  // points is known at compile time so that the loops are unrolled. Returns
+  // false if the Jacobian is singular.
+  template<int NumberOfCellPoints>
+  bool ComputeLinearCellDerivatives(const double *functionDerivs,
+                                    const double *cellPoints,
+                                    const double *values, int dim,
+                                    double *derivs)
+  {
+    double m0[3] = { 0.0, 0.0, 0.0 };
+    double m1[3] = { 0.0, 0.0, 0.0 };
+    double m2[3] = { 0.0, 0.0, 0.0 };
+    for (int j = 0; j < NumberOfCellPoints; j++)
     {
-      currentPoint->SetId(0, point);
-      double pointcoords[3];
-      structure->GetPoint(point, pointcoords);
-      // Get all cells touching this point.
-      structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
-      vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
-
-      for(int i=0;i<numberOfOutputComponents;i++)
+      for (int i = 0; i < 3; i++)
       {
-        g[i] = 0;
+        m0[i] += cellPoints[3*j + i] * functionDerivs[j];
+        m1[i] += cellPoints[3*j + i] * functionDerivs[NumberOfCellPoints + j];
+        m2[i] += cellPoints[3*j + i] * functionDerivs[2*NumberOfCellPoints + j];
       }
+    }
+    double *m[3] = { m0, m1, m2 };
+    double j0[3], j1[3], j2[3];
+    double *jI[3] = { j0, j1, j2 };
+    if (vtkMath::InvertMatrix(m, jI, 3) == 0)
+    {
+      return false;
+    }
 
-      if (contributingCellOption == vtkGradientFilter::Patch)
+    for (int k = 0; k < dim; k++)
+    {
+      double sum[3] = { 0.0, 0.0, 0.0 };
+      for (int i = 0; i < NumberOfCellPoints; i++)
       {
-        highestCellDimension = 0;
-        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+        double value = values[dim*i + k];
+        sum[0] += functionDerivs[i] * value;
+        sum[1] += functionDerivs[NumberOfCellPoints + i] * value;
+        sum[2] += functionDerivs[2*NumberOfCellPoints + i] * value;
+      }
+      for (int j = 0; j < 3; j++)
+      {
+        derivs[3*k + j] = sum[0]*jI[j][0] + sum[1]*jI[j][1] + sum[2]*jI[j][2];
+      }
+    }
+    return true;
+  }
+
+  // Fast path for the linear tetrahedra and hexahedra of the unstructured
+  // datasets: their derivatives are computed from the coordinates of their
+  // points and from interpolation function derivatives tabulated once, at the
+  // vertices and at the center of the hexahedron (they are constant for the
+  // tetrahedron), without getting a vtkGenericCell.
+  struct LinearCellDerivatives
+  {
+    vtkDataSet *Structure;
+    vtkDataArray *Array;
+    int NumberOfInputComponents;
+    double TetraDerivs[12];
+    double HexahedronDerivs[9][24];
+
+    LinearCellDerivatives() :
+      Structure(nullptr), Array(nullptr), NumberOfInputComponents(0)
+    {
+      double pcoords[3] = { 0.0, 0.0, 0.0 };
+      vtkTetra::InterpolationDerivs(pcoords, this->TetraDerivs);
+      vtkNew<vtkHexahedron> hexahedron;
+      const double *vertexCoords = hexahedron->GetParametricCoords();
+      for (int i = 0; i < 8; i++)
+      {
+        std::copy(vertexCoords + 3*i, vertexCoords + 3*i + 3, pcoords);
+        vtkHexahedron::InterpolationDerivs(pcoords, this->HexahedronDerivs[i]);
+      }
+      hexahedron->GetParametricCenter(pcoords);
+      vtkHexahedron::InterpolationDerivs(pcoords, this->HexahedronDerivs[8]);
+    }
+
+    static bool IsLinearCell(int cellType)
+    {
+      return cellType == VTK_TETRA || cellType == VTK_HEXAHEDRON;
+    }
+
+    // Compute the derivatives of the cell of type cellType with points
+    // pointIds at its point of index pointIndex, or at its center if
+    // pointIndex is negative. The derivatives of a cell with a singular
+    // Jacobian are zero.
+    void Derivatives(int cellType, vtkIdList *pointIds, int pointIndex,
+                     std::vector<double> &values, double *derivs) const
+    {
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      int numberOfCellPoints = (cellType == VTK_TETRA ? 4 : 8);
+      double cellPoints[24];
+      values.resize(numberOfCellPoints*numberOfInputComponents);
+      for (int i = 0; i < numberOfCellPoints; i++)
+      {
+        vtkIdType pointId = pointIds->GetId(i);
+        this->Structure->GetPoint(pointId, cellPoints + 3*i);
+        for (int inputComponent = 0; inputComponent < numberOfInputComponents;
+             inputComponent++)
         {
-          int cellDimension = structure->GetCell(cellsOnPoint->GetId(neighbor))->GetCellDimension();
-          if (cellDimension > highestCellDimension)
-          {
-            highestCellDimension = cellDimension;
-            if (highestCellDimension == maxCellDimension)
-            {
-              break;
-            }
-          }
+          values[i*numberOfInputComponents+inputComponent] =
+            this->Array->GetComponent(pointId, inputComponent);
         }
       }
-      vtkIdType numValidCellNeighbors = 0;
 
-      // Iterate on all cells and find all points connected to current point
-      // by an edge.
-      for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+      bool computed = (cellType == VTK_TETRA ?
+        ComputeLinearCellDerivatives<4>(this->TetraDerivs, cellPoints,
+          &values[0], numberOfInputComponents, derivs) :
+        ComputeLinearCellDerivatives<8>(
+          this->HexahedronDerivs[pointIndex < 0 ? 8 : pointIndex], cellPoints,
+          &values[0], numberOfInputComponents, derivs));
+      if (!computed)
       {
-        vtkCell *cell = structure->GetCell(cellsOnPoint->GetId(neighbor));
-        if (cell->GetCellDimension() >= highestCellDimension)
+        std::fill(derivs, derivs + 3*numberOfInputComponents, 0.0);
+      }
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  // Average the gradients, at a range of points, of the contributing cells
+  // using each point. The cells of the points are gathered from static links
+  // so that they are in the same order as with GetCellNeighbors(), and the
+  // derivatives of all the components are computed at once.
+  template<class data_type>
+  struct PointGradientsUG
+  {
+    vtkDataSet *Structure;
+    vtkDataArray *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    vtkStaticCellLinks *Links;
+    const unsigned char *CellDimensions;
+    int HighestCellDimension;
+    bool Patch;
+    LinearCellDerivatives Linear;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+    vtkSMPThreadLocal<std::vector<double> > Weights;
+
+    void Initialize()
+    {
+    }
+
+    void operator()(vtkIdType point, vtkIdType endPoint)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      vtkIdList *pointIds = this->PointIds.Local();
+      std::vector<double> &values = this->Values.Local();
+      std::vector<double> &weights = this->Weights.Local();
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      int numberOfOutputComponents = 3*numberOfInputComponents;
+      std::vector<double> derivatives(numberOfOutputComponents);
+      std::vector<data_type> g(numberOfOutputComponents);
+
+      for (; point < endPoint; point++)
+      {
+        double pointcoords[3];
+        this->Structure->GetPoint(point, pointcoords);
+        // Get all cells touching this point.
+        vtkIdType numCellNeighbors = this->Links->GetNumberOfCells(point);
+        const vtkIdType *cellsOnPoint = this->Links->GetCells(point);
+
+        std::fill(g.begin(), g.end(), 0);
+
+        int highestCellDimension = this->HighestCellDimension;
+        if (this->Patch)
         {
-          int subId;
-          double parametricCoord[3];
-          if(GetCellParametricData(point, pointcoords, cell,
-                                   subId, parametricCoord))
+          for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+          {
+            highestCellDimension = std::max(highestCellDimension,
+              static_cast<int>(this->CellDimensions[cellsOnPoint[neighbor]]));
+          }
+        }
+        vtkIdType numValidCellNeighbors = 0;
+
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+        {
+          vtkIdType cellId = cellsOnPoint[neighbor];
+          if (this->CellDimensions &&
+              this->CellDimensions[cellId] < highestCellDimension)
+          {
+            continue;
+          }
+          int cellType = this->Structure->GetCellType(cellId);
+          if (LinearCellDerivatives::IsLinearCell(cellType))
+          {
+            this->Structure->GetCellPoints(cellId, pointIds);
+            int pointIndex = GetCellPointIndex(point, pointIds);
+            if (pointIndex < 0)
+            {
+              continue;
+            }
+            numValidCellNeighbors++;
+            this->Linear.Derivatives(cellType, pointIds, pointIndex, values,
+                                     &derivatives[0]);
+          }
+          else
           {
+            this->Structure->GetCell(cellId, cell);
+            int numberOfCellPoints = cell->GetNumberOfPoints();
+            if (static_cast<size_t>(numberOfCellPoints) > weights.size())
+            {
+              weights.resize(numberOfCellPoints);
+            }
+            int subId;
+            double parametricCoord[3];
+            if(!GetCellParametricData(point, pointcoords, cell,
+                                      subId, parametricCoord, &weights[0]))
+            {
+              continue;
+            }
             numValidCellNeighbors++;
-            for(int inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
+
+            // Get values of Array at cell points.
+            values.resize(numberOfCellPoints*numberOfInputComponents);
+            for (int i = 0; i < numberOfCellPoints; i++)
             {
-              int numberOfCellPoints = cell->GetNumberOfPoints();
-              std::vector<double> values(numberOfCellPoints);
-              // Get values of Array at cell points.
-              for (int i = 0; i < numberOfCellPoints; i++)
+              vtkIdType pointId = cell->GetPointId(i);
+              for(int inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
               {
-                values[i] = array->GetComponent(cell->GetPointId(i), inputComponent);
+                values[i*numberOfInputComponents+inputComponent] =
+                  this->Array->GetComponent(pointId, inputComponent);
               }
+            }
 
-              double derivative[3];
-              // Get derivative of cell at point.
-              cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
-
-              g[inputComponent*3] += static_cast<data_type>(derivative[0]);
-              g[inputComponent*3+1] += static_cast<data_type>(derivative[1]);
-              g[inputComponent*3+2] += static_cast<data_type>(derivative[2]);
-            } // iterating over Components
-          } // if(GetCellParametricData())
-        } // if(cell->GetCellDimension () >= highestCellDimension
-      } // iterating over neighbors
-
-      if (numValidCellNeighbors > 0)
-      {
-        for(int i=0;i<3*numberOfInputComponents;i++)
-        {
-          g[i] /= numValidCellNeighbors;
-        }
+            // Get derivative of cell at point.
+            std::fill(derivatives.begin(), derivatives.end(), 0.0);
+            cell->Derivatives(subId, parametricCoord, &values[0],
+                              numberOfInputComponents, &derivatives[0]);
+          }
+          for(int i=0;i<numberOfOutputComponents;i++)
+          {
+            g[i] += static_cast<data_type>(derivatives[i]);
+          }
+        } // iterating over neighbors
 
-        if(vorticity)
-        {
-          ComputeVorticityFromGradient(&g[0], vorticity+3*point);
-        }
-        if(qCriterion)
-        {
-          ComputeQCriterionFromGradient(&g[0], qCriterion+point);
-        }
-        if(divergence)
-        {
-          ComputeDivergenceFromGradient(&g[0], divergence+point);
-        }
-        if(gradients)
+        if (numValidCellNeighbors > 0)
         {
           for(int i=0;i<numberOfOutputComponents;i++)
           {
-            gradients[point*numberOfOutputComponents+i] = g[i];
+            g[i] /= numValidCellNeighbors;
+          }
+
+          if(this->Vorticity)
+          {
+            ComputeVorticityFromGradient(&g[0], this->Vorticity+3*point);
+          }
+          if(this->QCriterion)
+          {
+            ComputeQCriterionFromGradient(&g[0], this->QCriterion+point);
+          }
+          if(this->Divergence)
+          {
+            ComputeDivergenceFromGradient(&g[0], this->Divergence+point);
+          }
+          if(this->Gradients)
+          {
+            for(int i=0;i<numberOfOutputComponents;i++)
+            {
+              this->Gradients[point*numberOfOutputComponents+i] = g[i];
+            }
           }
         }
-      }
-    }  // iterating over points in grid
+      }  // iterating over points in grid
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
+  template<class data_type>
+  void ComputePointGradientsUG(
+    vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence, const unsigned char *cellDimensions,
+    int highestCellDimension, int contributingCellOption)
+  {
+    vtkNew<vtkStaticCellLinks> links;
+    links->BuildLinks(structure);
+
+    PointGradientsUG<data_type> pointGradients;
+    pointGradients.Structure = structure;
+    pointGradients.Array = array;
+    pointGradients.Gradients = gradients;
+    pointGradients.NumberOfInputComponents = numberOfInputComponents;
+    pointGradients.Vorticity = vorticity;
+    pointGradients.QCriterion = qCriterion;
+    pointGradients.Divergence = divergence;
+    pointGradients.Links = links;
+    pointGradients.CellDimensions = cellDimensions;
+    pointGradients.HighestCellDimension = highestCellDimension;
+    pointGradients.Patch = (contributingCellOption == vtkGradientFilter::Patch);
+    pointGradients.Linear.Structure = structure;
+    pointGradients.Linear.Array = array;
+    pointGradients.Linear.NumberOfInputComponents = numberOfInputComponents;
+    ForEachItem(structure, structure->GetNumberOfPoints(), pointGradients);
   }
 
 //-----------------------------------------------------------------------------
   int GetCellParametricData(vtkIdType pointId, double pointCoord[3],
-                            vtkCell *cell, int &subId, double parametricCoord[3])
+                            vtkCell *cell, int &subId, double parametricCoord[3],
+                            double *weights)
   {
     // Watch out for degenerate cells.  They make the derivative calculation
     // fail.
-    vtkIdList *pointIds = cell->GetPointIds();
-    int timesPointRegistered = 0;
-    for (int i = 0; i < pointIds->GetNumberOfIds(); i++)
+    int pointIndex = GetCellPointIndex(pointId, cell->GetPointIds());
+    if (pointIndex < 0)
     {
-      if (pointId == pointIds->GetId(i))
-      {
-        timesPointRegistered++;
-      }
+      return 0;
     }
-    if (timesPointRegistered != 1)
+
+    // The parametric coordinates of the vertices of voxels are known, which
+    // saves the inversion of the mapping. (Linear tetrahedra and hexahedra
+    // do not get here, see LinearCellDerivatives.)
+    if (cell->GetCellType() == VTK_VOXEL)
     {
-      // The cell should have the point exactly once.  Not good.
-      return 0;
+      const double *vertexCoord = cell->GetParametricCoords() + 3*pointIndex;
+      std::copy(vertexCoord, vertexCoord + 3, parametricCoord);
+      subId = 0;
+      return 1;
     }
 
     double dummy;
-    int numpoints = cell->GetNumberOfPoints();
-    std::vector<double> values(numpoints);
     // Get parametric position of point.
     cell->EvaluatePosition(pointCoord, nullptr, subId, parametricCoord,
-                           dummy, &values[0]/*Really another dummy.*/);
+                           dummy, weights/*Really another dummy.*/);
 
     return 1;
   }
 
 //-----------------------------------------------------------------------------
-  template<class data_type>
-    void ComputeCellGradientsUG(
-      vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
-      int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-      data_type* divergence)
+  // Return the index of the point in the point ids of a cell, or -1 if the
+  // cell does not have the point exactly once (i.e. if it is degenerate).
+  int GetCellPointIndex(vtkIdType pointId, vtkIdList *pointIds)
   {
-    vtkIdType numcells = structure->GetNumberOfCells();
-    std::vector<double> values(8);
-    std::vector<data_type> cellGradients(3*numberOfInputComponents);
-    for (vtkIdType cellid = 0; cellid < numcells; cellid++)
+    int timesPointRegistered = 0;
+    int pointIndex = -1;
+    for (int i = 0; i < pointIds->GetNumberOfIds(); i++)
     {
-      vtkCell *cell = structure->GetCell(cellid);
-      int subId;
-      double cellCenter[3];
-      subId = cell->GetParametricCenter(cellCenter);
-
-      int numpoints = cell->GetNumberOfPoints();
-      if(static_cast<size_t>(numpoints) > values.size())
+      if (pointId == pointIds->GetId(i))
       {
-        values.resize(numpoints);
+        timesPointRegistered++;
+        pointIndex = i;
       }
-      double derivative[3];
-      for(int inputComponent=0;inputComponent<numberOfInputComponents;
-          inputComponent++)
+    }
+    return (timesPointRegistered == 1 ? pointIndex : -1);
+  }
+
+//-----------------------------------------------------------------------------
+  // Compute the gradients of a range of cells at their parametric center.
+  template<class data_type>
+  struct CellGradientsUG
+  {
+    vtkDataSet *Structure;
+    vtkDataArray *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    LinearCellDerivatives Linear;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocalObject<vtkIdList> PointIds;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+
+    void Initialize()
+    {
+    }
+
+    void operator()(vtkIdType cellid, vtkIdType endCellId)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      vtkIdList *pointIds = this->PointIds.Local();
+      std::vector<double> &values = this->Values.Local();
+      int numberOfInputComponents = this->NumberOfInputComponents;
+      std::vector<double> derivatives(3*numberOfInputComponents);
+      std::vector<data_type> cellGradients(3*numberOfInputComponents);
+      for (; cellid < endCellId; cellid++)
       {
-        for (int i = 0; i < numpoints; i++)
+        int cellType = this->Structure->GetCellType(cellid);
+        if (LinearCellDerivatives::IsLinearCell(cellType))
         {
-          values[i] = array->GetComponent(cell->GetPointId(i), inputComponent);
+          this->Structure->GetCellPoints(cellid, pointIds);
+          this->Linear.Derivatives(cellType, pointIds, -1, values,
+                                   &derivatives[0]);
         }
+        else
+        {
+          this->Structure->GetCell(cellid, cell);
+          int subId;
+          double cellCenter[3];
+          subId = cell->GetParametricCenter(cellCenter);
 
-        cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
-        cellGradients[inputComponent*3] =
-          static_cast<data_type>(derivative[0]);
-        cellGradients[inputComponent*3+1] =
-          static_cast<data_type>(derivative[1]);
-        cellGradients[inputComponent*3+2] =
-          static_cast<data_type>(derivative[2]);
-      }
-      if(gradients)
-      {
+          int numpoints = cell->GetNumberOfPoints();
+          values.resize(numpoints*numberOfInputComponents);
+          for (int i = 0; i < numpoints; i++)
+          {
+            vtkIdType pointId = cell->GetPointId(i);
+            for(int inputComponent=0;inputComponent<numberOfInputComponents;
+                inputComponent++)
+            {
+              values[i*numberOfInputComponents+inputComponent] =
+                this->Array->GetComponent(pointId, inputComponent);
+            }
+          }
+
+          std::fill(derivatives.begin(), derivatives.end(), 0.0);
+          cell->Derivatives(subId, cellCenter, &values[0],
+                            numberOfInputComponents, &derivatives[0]);
+        }
         for(int i=0;i<3*numberOfInputComponents;i++)
         {
-          gradients[cellid*3*numberOfInputComponents+i] = cellGradients[i];
+          cellGradients[i] = static_cast<data_type>(derivatives[i]);
+        }
+        if(this->Gradients)
+        {
+          for(int i=0;i<3*numberOfInputComponents;i++)
+          {
+            this->Gradients[cellid*3*numberOfInputComponents+i] =
+              cellGradients[i];
+          }
+        }
+        if(this->Vorticity)
+        {
+          ComputeVorticityFromGradient(&cellGradients[0],
+                                       this->Vorticity+3*cellid);
+        }
+        if(this->QCriterion)
+        {
+          ComputeQCriterionFromGradient(&cellGradients[0],
+                                        this->QCriterion+cellid);
+        }
+        if(this->Divergence)
+        {
+          ComputeDivergenceFromGradient(&cellGradients[0],
+                                        this->Divergence+cellid);
         }
-      }
-      if(vorticity)
-      {
-        ComputeVorticityFromGradient(&cellGradients[0], vorticity+3*cellid);
-      }
-      if(qCriterion)
-      {
-        ComputeQCriterionFromGradient(&cellGradients[0], qCriterion+cellid);
-      }
-      if(divergence)
-      {
-        ComputeDivergenceFromGradient(&cellGradients[0], divergence+cellid);
       }
     }
+
+    void Reduce()
+    {
+    }
+  };
+
+  template<class data_type>
+    void ComputeCellGradientsUG(
+      vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
+      int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+      data_type* divergence)
+  {
+    CellGradientsUG<data_type> cellGradients;
+    cellGradients.Structure = structure;
+    cellGradients.Array = array;
+    cellGradients.Gradients = gradients;
+    cellGradients.NumberOfInputComponents = numberOfInputComponents;
+    cellGradients.Vorticity = vorticity;
+    cellGradients.QCriterion = qCriterion;
+    cellGradients.Divergence = divergence;
+    cellGradients.Linear.Structure = structure;
+    cellGradients.Linear.Array = array;
+    cellGradients.Linear.NumberOfInputComponents = numberOfInputComponents;
+    ForEachItem(structure, structure->GetNumberOfCells(), cellGradients);
   }
 
 //-----------------------------------------------------------------------------
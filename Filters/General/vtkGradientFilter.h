@@ -39,6 +39,12 @@
  * the entire data set. For Patch or DataSetMax it is possible that some values
  * will not be computed. The ReplacementValueOption specifies what to use
  * for these values.
+ *
+ * The gradients of unstructured grids and polydata are computed in parallel
+ * with vtkSMPTools, the derivatives of all the components of a cell being
+ * computed at once. At the vertices of linear tetrahedra and hexahedra, the
+ * parametric coordinates are known and the inversion of the cell mapping is
+ * skipped.
 */
 
 #ifndef vtkGradientFilter_h
@@ -57,6 +57,13 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "vtkTableBasedClipCases.h"
 
@@ -648,9 +655,12 @@ class  vtkTableBasedClipperVolumeFromVolume :
     const int    nshapes;
     int OutputPointsPrecision;
 
+    vtkPoints  * NewOutputPoints( vtkDataSet * );
     void         ConstructDataSet
                  ( vtkDataSet *, vtkUnstructuredGrid *,
                    TableBasedClipperCommonPointsStructure & );
+
+    friend class vtkTableBasedClipperVolumeFromVolumePieces;
 };
 
 
@@ -1199,6 +1209,36 @@ void vtkTableBasedClipperVertexList::AddVertex( int cellId, int v1 )
   currentShape ++;
 }
 
+vtkPoints * vtkTableBasedClipperVolumeFromVolume::
+            NewOutputPoints( vtkDataSet * input )
+{
+  vtkPoints * outPts = vtkPoints::New();
+
+  // set precision for the points in the output
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
+    if(inputPointSet)
+    {
+      outPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
+    }
+    else
+    {
+      outPts->SetDataType(VTK_FLOAT);
+    }
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    outPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    outPts->SetDataType(VTK_DOUBLE);
+  }
+
+  return outPts;
+}
+
 void vtkTableBasedClipperVolumeFromVolume::
      ConstructDataSet( vtkDataSet * input,
                        vtkUnstructuredGrid * output, double * pts_ptr )
@@ -1285,29 +1325,7 @@ void vtkTableBasedClipperVolumeFromVolume::
   //
   // Set up the output points and its point data.
   //
-  vtkPoints * outPts = vtkPoints::New();
-
-  // set precision for the points in the output
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
-    if(inputPointSet)
-    {
-      outPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      outPts->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    outPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    outPts->SetDataType(VTK_DOUBLE);
-  }
+  vtkPoints * outPts = this->NewOutputPoints( input );
 
   int centroidStart  = numUsed + pt_list.GetTotalNumberOfPoints();
   int nOutPts        = centroidStart + centroid_list.GetTotalNumberOfPoints();
@@ -1596,1451 +1614,1753 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // ============================================================================
 
 
-//-----------------------------------------------------------------------------
-// Construct with user-specified implicit function; InsideOut turned off; value
-// set to 0.0; and generate clip scalars turned off.
-vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
+// ============================================================================
+// ============== vtkTableBasedClipperVolumeFromVolumePieces (begin) ==========
+// ============================================================================
+
+
+typedef const int vtkTableBasedClipperEdgeVertices[2];
+
+// Clip one cell through its clip case (nOutputs shapes starting at thisCase),
+// adding the resulting shapes and points to visItVFV. pntIndxs are the ids of
+// the cell points, grdDiffs their clip values relative to the iso-value, and
+// edgeVtxs the cell vertices of each edge.
+static void vtkTableBasedClipperClipCell( vtkObject * self,
+  vtkTableBasedClipperVolumeFromVolume * visItVFV, int cellId, int insideOut,
+  const vtkIdType * pntIndxs, const double * grdDiffs,
+  const unsigned char * thisCase, int nOutputs,
+  vtkTableBasedClipperEdgeVertices * edgeVtxs )
 {
-  this->Locator      = nullptr;
-  this->ClipFunction = cf;
+  int   intrpIds[4];
+  for ( int j = 0; j < nOutputs; j ++ )
+  {
+    int      nCellPts = 0;
+    int      theColor = -1;
+    int      intrpIdx = -1;
+    unsigned char theShape = *thisCase ++;
 
-  // setup a callback to report progress
-  this->InternalProgressObserver = vtkCallbackCommand::New();
-  this->InternalProgressObserver->SetCallback
-        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
-  this->InternalProgressObserver->SetClientData( this );
+    // number of points and color
+    switch ( theShape )
+    {
+      case ST_HEX:
+        nCellPts = 8;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_WDG:
+        nCellPts = 6;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_PYR:
+        nCellPts = 5;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_TET:
+        nCellPts = 4;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_QUA:
+        nCellPts = 4;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_TRI:
+        nCellPts = 3;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_LIN:
+        nCellPts = 2;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_VTX:
+        nCellPts = 1;
+        theColor = *thisCase ++;
+        break;
+
+      case ST_PNT:
+        intrpIdx = *thisCase ++;
+        theColor = *thisCase ++;
+        nCellPts = *thisCase ++;
+        break;
 
-  this->Value     = 0.0;
-  this->InsideOut = 0;
-  this->MergeTolerance        = 0.01;
-  this->UseValueAsOffset      = true;
-  this->GenerateClipScalars   = 0;
-  this->GenerateClippedOutput = 0;
+      default:
+        vtkErrorWithObjectMacro( self, << "An invalid output shape was found "
+                                       << "in the ClipCases." << endl );
+    }
 
-  this->OutputPointsPrecision = DEFAULT_PRECISION;
+    if ( ( !insideOut && theColor == COLOR0 ) ||
+         (  insideOut && theColor == COLOR1 )
+       )
+    {
+      // We don't want this one; it's the wrong side.
+      thisCase += nCellPts;
+      continue;
+    }
 
-  this->SetNumberOfOutputPorts( 2 );
-  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
-  this->GetExecutive()->SetOutputData( 1, output2 );
-  output2->Delete();
-  output2 = nullptr;
+    int   shapeIds[8];
+    for ( int p = 0; p < nCellPts; p ++ )
+    {
+      unsigned char pntIndex = *thisCase ++;
 
-  // process active point scalars by default
-  this->SetInputArrayToProcess
-        ( 0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
-          vtkDataSetAttributes::SCALARS );
+      if ( pntIndex <= P7 )
+      {
+        shapeIds[p] = pntIndxs[ pntIndex ];
+      }
+      else
+      if ( pntIndex >= EA && pntIndex <= EL )
+      {
+        int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
+        int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
+        if ( pt2Index < pt1Index )
+        {
+          int temp = pt2Index;
+          pt2Index = pt1Index;
+          pt1Index = temp;
+        }
+        double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
+        double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
+        double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+
+        int    pntIndx1 = pntIndxs[ pt1Index ];
+        int    pntIndx2 = pntIndxs[ pt2Index ];
+
+        shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
+      }
+      else
+      if ( pntIndex >= N0 && pntIndex <= N3 )
+      {
+        shapeIds[p] = intrpIds[ pntIndex - N0 ];
+      }
+      else
+      {
+        vtkErrorWithObjectMacro( self, << "An invalid output point value "
+                                       << "was found in the ClipCases." << endl );
+      }
+    }
+
+    switch ( theShape )
+    {
+      case ST_HEX:
+        visItVFV->AddHex( cellId, shapeIds[0], shapeIds[1],
+                                  shapeIds[2], shapeIds[3], shapeIds[4],
+                                  shapeIds[5], shapeIds[6], shapeIds[7] );
+        break;
+
+      case ST_WDG:
+        visItVFV->AddWedge( cellId, shapeIds[0], shapeIds[1], shapeIds[2],
+                                    shapeIds[3], shapeIds[4], shapeIds[5] );
+        break;
+
+      case ST_PYR:
+        visItVFV->AddPyramid( cellId, shapeIds[0], shapeIds[1],
+                                      shapeIds[2], shapeIds[3], shapeIds[4] );
+        break;
+
+      case ST_TET:
+        visItVFV->AddTet( cellId, shapeIds[0], shapeIds[1],
+                                  shapeIds[2], shapeIds[3] );
+        break;
+
+      case ST_QUA:
+        visItVFV->AddQuad( cellId, shapeIds[0], shapeIds[1],
+                                   shapeIds[2], shapeIds[3] );
+        break;
+
+      case ST_TRI:
+        visItVFV->AddTri( cellId, shapeIds[0], shapeIds[1], shapeIds[2] );
+        break;
+
+      case ST_LIN:
+        visItVFV->AddLine( cellId, shapeIds[0], shapeIds[1] );
+        break;
+
+      case ST_VTX:
+        visItVFV->AddVertex( cellId, shapeIds[0] );
+        break;
+
+      case ST_PNT:
+        intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
+                                         ( nCellPts, shapeIds );
+        break;
+    }
+  }
 }
 
-//-----------------------------------------------------------------------------
-vtkTableBasedClipDataSet::~vtkTableBasedClipDataSet()
+
+// ---- vtkTableBasedClipperUnstructuredCells (begin)
+// Clip case lookup for the cells of a vtkUnstructuredGrid.
+class vtkTableBasedClipperUnstructuredCells
 {
-  if ( this->Locator )
+  public:
+    vtkTableBasedClipperUnstructuredCells( vtkUnstructuredGrid * grid,
+                                           vtkDataArray * clipAray,
+                                           double isoValue )
+      : Grid( grid ), ClipAray( clipAray ), IsoValue( isoValue ) { }
+
+    static bool CanClip( int cellType );
+    bool CanClipAllCells();
+
+    // Returns false, without clipping it, if the cell type is not supported.
+    bool ClipCell( vtkObject * self, vtkTableBasedClipperVolumeFromVolume *,
+                   int insideOut, vtkIdType cellId );
+
+  protected:
+    vtkUnstructuredGrid * Grid;
+    vtkDataArray        * ClipAray;
+    double                IsoValue;
+};
+// ---- vtkTableBasedClipperUnstructuredCells (end)
+
+
+// ---- vtkTableBasedClipperStructuredCells (begin)
+// Clip case lookup for the cells of a vtkStructuredGrid or a
+// vtkRectilinearGrid of the given point dimensions.
+class vtkTableBasedClipperStructuredCells
+{
+  public:
+    vtkTableBasedClipperStructuredCells( const int dims[3],
+                                         vtkDataArray * clipAray,
+                                         double isoValue );
+
+    void ClipCell( vtkObject * self, vtkTableBasedClipperVolumeFromVolume *,
+                   int insideOut, vtkIdType cellId );
+
+  protected:
+    vtkDataArray * ClipAray;
+    double         IsoValue;
+    int            IsTwoDim;
+    int            ShiftLUT[3][8];
+    int            CellDims[3];
+    int            CyStride;
+    int            CzStride;
+    int            PyStride;
+    int            PzStride;
+};
+// ---- vtkTableBasedClipperStructuredCells (end)
+
+
+// ---- vtkTableBasedClipperVolumeFromVolumePieces (begin)
+// The cells split in contiguous pieces that are clipped concurrently, each
+// into its own vtkTableBasedClipperVolumeFromVolume, and merged afterwards.
+// Points along edges shared by several pieces are merged through a sorted
+// list of the edges of all the pieces. The output points and cells are
+// numbered as a single vtkTableBasedClipperVolumeFromVolume would number
+// them, so the output does not depend on the number of pieces.
+class vtkTableBasedClipperVolumeFromVolumePieces
+{
+  public:
+    vtkTableBasedClipperVolumeFromVolumePieces( int precision, int nPts,
+                                                int nCells, int nPieces );
+    ~vtkTableBasedClipperVolumeFromVolumePieces();
+
+    // Number of pieces worth using for a dataset: the requested number, or
+    // if 0, a single one unless several threads are available and the
+    // dataset is large enough. Always a single one unless the attributes can
+    // be filled concurrently.
+    static int GetNumberOfPieces( vtkDataSet * input, vtkIdType nCells,
+                                  int requested );
+
+    int       GetNumberOfPieces() const
+              { return static_cast<int>( pieces.size() ); }
+    vtkTableBasedClipperVolumeFromVolume * GetPiece( int i )
+              { return pieces[i]; }
+    void      GetPieceCells( vtkIdType piece,
+                             vtkIdType & first, vtkIdType & last ) const
+    {
+      first = piece * pieceSize;
+      last  = std::min( first + pieceSize, numCells );
+    }
+
+    template <typename CellsType>
+    void      Clip( vtkObject * self, CellsType & cells, int insideOut );
+
+    void      ConstructDataSet( vtkDataSet *,
+                                vtkUnstructuredGrid *, double * );
+    void      ConstructDataSet( vtkDataSet *,
+                                vtkUnstructuredGrid *, int *, double *,
+                                double *, double * );
+
+  protected:
+    std::vector< vtkTableBasedClipperVolumeFromVolume * > pieces;
+    vtkIdType numCells;
+    vtkIdType pieceSize;
+
+    struct Merger;
+    void      ConstructDataSet( vtkDataSet *, vtkUnstructuredGrid *,
+                                TableBasedClipperCommonPointsStructure & );
+
+  private:
+    vtkTableBasedClipperVolumeFromVolumePieces
+      ( const vtkTableBasedClipperVolumeFromVolumePieces & ) = delete;
+    void operator =
+      ( const vtkTableBasedClipperVolumeFromVolumePieces & ) = delete;
+};
+// ---- vtkTableBasedClipperVolumeFromVolumePieces (end)
+
+bool vtkTableBasedClipperUnstructuredCells::CanClip( int cellType )
+{
+  switch ( cellType )
   {
-    this->Locator->UnRegister( this );
-    this->Locator = nullptr;
+    case VTK_TETRA:
+    case VTK_PYRAMID:
+    case VTK_WEDGE:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+    case VTK_PIXEL:
+    case VTK_LINE:
+    case VTK_VERTEX:
+         return true;
+
+    default:
+         return false;
   }
-  this->SetClipFunction( nullptr );
-  this->InternalProgressObserver->Delete();
-  this->InternalProgressObserver = nullptr;
 }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::InternalProgressCallbackFunction
-   ( vtkObject * arg, unsigned long, void * clientdata, void * )
+bool vtkTableBasedClipperUnstructuredCells::CanClipAllCells()
 {
-  reinterpret_cast < vtkTableBasedClipDataSet * > ( clientdata )
-    ->InternalProgressCallback(  static_cast < vtkAlgorithm * > ( arg )  );
+  vtkUnsignedCharArray * cellTypes = this->Grid->GetCellTypesArray();
+  vtkIdType numCells = this->Grid->GetNumberOfCells();
+  for ( vtkIdType i = 0; i < numCells; i ++ )
+  {
+    if ( !CanClip( cellTypes->GetValue( i ) ) )
+    {
+      return false;
+    }
+  }
+  return true;
 }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::InternalProgressCallback
-   ( vtkAlgorithm * algorithm )
+bool vtkTableBasedClipperUnstructuredCells::ClipCell( vtkObject * self,
+     vtkTableBasedClipperVolumeFromVolume * visItVFV, int insideOut,
+     vtkIdType cellId )
 {
-  double progress = algorithm->GetProgress();
-  this->UpdateProgress( progress );
-
-  if ( this->AbortExecute )
+  int         cellType = this->Grid->GetCellType( cellId );
+  if ( !CanClip( cellType ) )
   {
-    algorithm->SetAbortExecute( 1 );
+    return false;
   }
-}
 
-//-----------------------------------------------------------------------------
-vtkMTimeType vtkTableBasedClipDataSet::GetMTime()
-{
-  vtkMTimeType time;
-  vtkMTimeType mTime = this->Superclass::GetMTime();
+  vtkIdType   numbPnts = 0;
+  vtkIdType * pntIndxs = nullptr;
+  this->Grid->GetCellPoints( cellId, numbPnts, pntIndxs );
 
-  if ( this->ClipFunction != nullptr )
+  int    caseIndx = 0;
+  double grdDiffs[8];
+
+  for ( vtkIdType j = numbPnts-1; j >= 0; j -- )
   {
-    time  = this->ClipFunction->GetMTime();
-    mTime = ( time > mTime ? time : mTime );
+    grdDiffs[j] = this->ClipAray->GetComponent( pntIndxs[j], 0 ) -
+                  this->IsoValue;
+    caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+    caseIndx  <<= (  1 - ( !j )  );
   }
 
-  if ( this->Locator != nullptr )
+  int                startIdx = 0;
+  int                nOutputs = 0;
+  vtkTableBasedClipperEdgeVertices * edgeVtxs = nullptr;
+  unsigned char    * thisCase = nullptr;
+
+  // start index, split case, number of output, and vertices from edges
+  switch ( cellType )
   {
-    time  = this->Locator->GetMTime();
-    mTime = ( time > mTime ? time : mTime );
+    case VTK_TETRA:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
+      break;
+
+    case VTK_PYRAMID:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
+      break;
+
+    case VTK_WEDGE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
+      break;
+
+    case VTK_HEXAHEDRON:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
+      break;
+
+    case VTK_VOXEL:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+      break;
+
+    case VTK_TRIANGLE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
+      break;
+
+    case VTK_QUAD:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
+      break;
+
+    case VTK_PIXEL:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+      break;
+
+    case VTK_LINE:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
+      edgeVtxs = vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+      break;
+
+    case VTK_VERTEX:
+      startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
+      thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
+      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
+      edgeVtxs = nullptr;
+      break;
   }
 
-  return mTime;
+  vtkTableBasedClipperClipCell( self, visItVFV, cellId, insideOut,
+                                pntIndxs, grdDiffs, thisCase, nOutputs,
+                                edgeVtxs );
+  return true;
 }
 
-vtkUnstructuredGrid *vtkTableBasedClipDataSet::GetClippedOutput()
+vtkTableBasedClipperStructuredCells::vtkTableBasedClipperStructuredCells
+  ( const int dims[3], vtkDataArray * clipAray, double isoValue )
+  : ClipAray( clipAray ), IsoValue( isoValue )
 {
-  if ( !this->GenerateClippedOutput )
+  enum TwoDimType { XY, YZ, XZ };
+  TwoDimType twoDimType;
+  this->IsTwoDim = int( dims[0] <= 1 || dims[1] <= 1 || dims[2] <= 1 );
+  if (dims[0] <= 1) twoDimType = YZ;
+  else if (dims[1] <= 1) twoDimType = XZ;
+  else twoDimType = XY;
+
+  static const int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
+  static const int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+  static const int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+
+  const int * shiftLUT[3];
+  if (this->IsTwoDim && twoDimType == XZ)
   {
-    return nullptr;
+    shiftLUT[0] = shiftLUTx;
+    shiftLUT[1] = shiftLUTz;
+    shiftLUT[2] = shiftLUTy;
+  }
+  else if (this->IsTwoDim && twoDimType == YZ)
+  {
+    shiftLUT[0] = shiftLUTy;
+    shiftLUT[1] = shiftLUTz;
+    shiftLUT[2] = shiftLUTx;
+  }
+  else
+  {
+    shiftLUT[0] = shiftLUTx;
+    shiftLUT[1] = shiftLUTy;
+    shiftLUT[2] = shiftLUTz;
+  }
+  for ( int i = 0; i < 3; i ++ )
+  {
+    std::copy( shiftLUT[i], shiftLUT[i] + 8, this->ShiftLUT[i] );
+    this->CellDims[i] = dims[i] - 1;
   }
 
-  return vtkUnstructuredGrid::SafeDownCast
-        (  this->GetExecutive()->GetOutputData( 1 )  );
+  this->CyStride = (this->CellDims[0] ? this->CellDims[0] : 1);
+  this->CzStride = (this->CellDims[0] ? this->CellDims[0] : 1) *
+                   (this->CellDims[1] ? this->CellDims[1] : 1);
+  this->PyStride = dims[0];
+  this->PzStride = dims[0] * dims[1];
 }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::SetLocator
-   ( vtkIncrementalPointLocator * locator )
+void vtkTableBasedClipperStructuredCells::ClipCell( vtkObject * self,
+     vtkTableBasedClipperVolumeFromVolume * visItVFV, int insideOut,
+     vtkIdType cellId )
 {
-  if ( this->Locator == locator)
+  int    caseIndx = 0;
+  int    nCellPts = this->IsTwoDim ? 4 : 8;
+  int    i = static_cast<int>( cellId );
+  int    theCellI = (this->CellDims[0] > 0 ? i % this->CellDims[0] : 0);
+  int    theCellJ = (this->CellDims[1] > 0 ?
+                     ( i / this->CyStride ) % this->CellDims[1] : 0);
+  int    theCellK = (this->CellDims[2] > 0 ? ( i / this->CzStride ) : 0);
+  double grdDiffs[8];
+  vtkIdType pntIndxs[8];
+
+  for ( int j = 0; j < 8; j ++ )
   {
-    return;
+    pntIndxs[j] = ( theCellI + this->ShiftLUT[0][j] ) +
+                  ( theCellJ + this->ShiftLUT[1][j] ) * this->PyStride +
+                  ( theCellK + this->ShiftLUT[2][j] ) * this->PzStride;
   }
 
-  if ( this->Locator )
+  for ( int j = nCellPts - 1; j >= 0; j -- )
   {
-    this->Locator->UnRegister( this );
-    this->Locator = nullptr;
+    grdDiffs[j] = this->ClipAray->GetComponent( pntIndxs[j], 0 ) -
+                  this->IsoValue;
+    caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
+    caseIndx  <<= (  1 - ( !j )  );
   }
 
-  if ( locator )
+  int             nOutputs;
+  unsigned char * thisCase = nullptr;
+
+  if ( this->IsTwoDim )
   {
-    locator->Register( this );
+    thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
+             [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
+    nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+  }
+  else
+  {
+    thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
+             [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
+    nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
   }
 
-  this->Locator = locator;
-  this->Modified();
+  // Both the quad and the hex cases use the hex edges (the first four hex
+  // edges being those of the quad).
+  vtkTableBasedClipperClipCell( self, visItVFV, i, insideOut,
+    pntIndxs, grdDiffs, thisCase, nOutputs,
+    vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges );
 }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::CreateDefaultLocator()
+// Clip the cells of a range of pieces.
+template <typename CellsType>
+struct vtkTableBasedClipperClipPieces
 {
-  if ( this->Locator == nullptr )
+  vtkObject * Self;
+  CellsType * Cells;
+  int         InsideOut;
+  vtkTableBasedClipperVolumeFromVolumePieces * Pieces;
+
+  void operator()( vtkIdType piece, vtkIdType endPiece )
   {
-    this->Locator = vtkMergePoints::New();
-    this->Locator->Register( this );
-    this->Locator->Delete();
+    for ( ; piece < endPiece; piece ++ )
+    {
+      vtkTableBasedClipperVolumeFromVolume * visItVFV =
+        this->Pieces->GetPiece( static_cast<int>( piece ) );
+      vtkIdType cellId, endCellId;
+      this->Pieces->GetPieceCells( piece, cellId, endCellId );
+      for ( ; cellId < endCellId; cellId ++ )
+      {
+        this->Cells->ClipCell( this->Self, visItVFV, this->InsideOut, cellId );
+      }
+    }
   }
-}
+};
 
-//-----------------------------------------------------------------------------
-int vtkTableBasedClipDataSet::FillInputPortInformation
-  ( int, vtkInformation * info )
+vtkTableBasedClipperVolumeFromVolumePieces::
+vtkTableBasedClipperVolumeFromVolumePieces( int precision, int nPts,
+                                            int nCells, int nPieces )
+  : numCells( nCells )
 {
-  info->Set( vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet" );
-  return 1;
+  nPieces   = std::max( nPieces, 1 );
+  pieceSize = ( numCells + nPieces - 1 ) / nPieces;
+  if ( pieceSize == 0 )
+  {
+    pieceSize = 1;
+  }
+
+  double pieceCells = static_cast<double>( pieceSize );
+  pieces.resize( nPieces );
+  for ( int i = 0; i < nPieces; i ++ )
+  {
+    pieces[i] = new vtkTableBasedClipperVolumeFromVolume( precision, nPts,
+      int(   pow(  pieceCells, double( 0.6667f )  )   ) * 5 + 100    );
+  }
 }
 
-//-----------------------------------------------------------------------------
-int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request ),
-    vtkInformationVector ** inputVector, vtkInformationVector * outputVector )
+vtkTableBasedClipperVolumeFromVolumePieces::
+~vtkTableBasedClipperVolumeFromVolumePieces()
 {
-  // input and output information objects
-  vtkInformation * inputInf = inputVector[0]->GetInformationObject( 0 );
-  vtkInformation * outInfor = outputVector->GetInformationObject( 0 );
-
-  // Get the input of which we have to create a copy since the clipper requires
-  // that InterpolateAllocate() be invoked for the output based on its input in
-  // terms of the point data. If the input and output arrays are different,
-  // vtkCell3D's Clip will fail. The last argument of InterpolateAllocate makes
-  // sure that arrays are shallow-copied from theInput to cpyInput.
-  vtkDataSet * theInput = vtkDataSet::SafeDownCast
-                          (  inputInf->Get( vtkDataObject::DATA_OBJECT() )  );
-  vtkSmartPointer< vtkDataSet > cpyInput;
-  cpyInput.TakeReference( theInput->NewInstance() );
-  cpyInput->CopyStructure( theInput  );
-  cpyInput->GetCellData()->PassData( theInput->GetCellData() );
-  cpyInput->GetPointData()
-          ->InterpolateAllocate( theInput->GetPointData(), 0, 0, 1 );
-
-  // get the output (the remaining and the clipped parts)
-  vtkUnstructuredGrid * outputUG = vtkUnstructuredGrid::SafeDownCast
-                        (  outInfor->Get( vtkDataObject::DATA_OBJECT() )  );
-  vtkUnstructuredGrid * clippedOutputUG = this->GetClippedOutput();
+  for ( size_t i = 0; i < pieces.size(); i ++ )
+  {
+    delete pieces[i];
+  }
+}
 
-  inputInf = nullptr;
-  outInfor = nullptr;
-  theInput = nullptr;
-  vtkDebugMacro( << "Clipping dataset" << endl );
+int vtkTableBasedClipperVolumeFromVolumePieces::GetNumberOfPieces
+  ( vtkDataSet * input, vtkIdType nCells, int requested )
+{
+  // Below this many cells per piece, merging the pieces does not pay off.
+  const vtkIdType minPieceSize = 16384;
 
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  if ( requested == 1 ||
+       ( requested == 0 && ( numThreads <= 1 || nCells < 2 * minPieceSize ) ) )
+  {
+    return 1;
+  }
 
-  int  i;
-  vtkIdType  numbPnts = cpyInput->GetNumberOfPoints();
+  // The attributes are interpolated into presized arrays, which string and
+  // bit arrays do not support concurrently.
+  vtkDataSetAttributes * attributes[2] =
+    { input->GetPointData(), input->GetCellData() };
+  for ( int a = 0; a < 2; a ++ )
+  {
+    for ( int i = 0; i < attributes[a]->GetNumberOfArrays(); i ++ )
+    {
+      vtkDataArray * array = vtkArrayDownCast< vtkDataArray >
+                             (  attributes[a]->GetAbstractArray( i )  );
+      if ( !array || array->GetDataType() == VTK_BIT )
+      {
+        return 1;
+      }
+    }
+  }
 
-  // handling exceptions
-  if ( numbPnts < 1 )
+  if ( requested > 0 )
   {
-    vtkDebugMacro( << "No data to clip" << endl );
-    outputUG = nullptr;
-    return 1;
+    return static_cast<int>
+           ( std::min< vtkIdType >( requested, std::max< vtkIdType >( nCells, 1 ) ) );
   }
+  return static_cast<int>( std::min< vtkIdType >
+           ( nCells / minPieceSize, 4 * numThreads ) );
+}
 
-  if ( !this->ClipFunction && this->GenerateClipScalars )
+template <typename CellsType>
+void vtkTableBasedClipperVolumeFromVolumePieces::Clip
+  ( vtkObject * self, CellsType & cells, int insideOut )
+{
+  vtkTableBasedClipperClipPieces< CellsType > clipPieces =
+    { self, &cells, insideOut, this };
+  if ( pieces.size() == 1 )
   {
-    vtkErrorMacro( << "Cannot generate clip scalars "
-                   << "if no clip function defined" << endl );
-    outputUG = nullptr;
-    return 1;
+    clipPieces( 0, 1 );
   }
+  else
+  {
+    vtkSMPTools::For( 0, static_cast<vtkIdType>( pieces.size() ), 1,
+                      clipPieces );
+  }
+}
 
+void vtkTableBasedClipperVolumeFromVolumePieces::
+     ConstructDataSet( vtkDataSet * input,
+                       vtkUnstructuredGrid * output, double * pts_ptr )
+{
+  TableBasedClipperCommonPointsStructure cps;
+  cps.hasPtsList = true;
+  cps.pts_ptr    = pts_ptr;
+  ConstructDataSet( input, output, cps );
+}
 
-  vtkDataArray   * clipAray = nullptr;
-  vtkDoubleArray * pScalars = nullptr;
+void vtkTableBasedClipperVolumeFromVolumePieces::
+     ConstructDataSet( vtkDataSet * input,
+                       vtkUnstructuredGrid * output,
+                       int * dims, double * X, double * Y, double * Z )
+{
+  TableBasedClipperCommonPointsStructure cps;
+  cps.hasPtsList = false;
+  cps.dims       = dims;
+  cps.X          = X;
+  cps.Y          = Y;
+  cps.Z          = Z;
+  ConstructDataSet( input, output, cps );
+}
 
-  // check whether the cells are clipped with input scalars or a clip function
-  if ( this->ClipFunction )
+// Merge of the pieces into the output. Output points are numbered as in
+// vtkTableBasedClipperVolumeFromVolume::ConstructDataSet: first the input
+// points in order of first use by the shapes (all the shapes of a type
+// before those of the next type), then the edge points in order of
+// creation, then the centroid points. Output cells are sorted by type.
+// Each step is done concurrently over the pieces, or over the (shape type,
+// piece) pairs, with prefix sums giving where each piece starts.
+struct vtkTableBasedClipperVolumeFromVolumePieces::Merger
+{
+  // An edge point of a piece, identified by the ids of the edge points
+  // (id1 < id2) and by its rank among the edge points of all the pieces.
+  struct EdgeEntry
   {
-    pScalars = vtkDoubleArray::New();
-    pScalars->SetNumberOfTuples( numbPnts );
-    pScalars->SetName( "ClipDataSetScalars" );
+    int       id1, id2;
+    vtkIdType rank;
 
-    // enable clipDataSetScalars to be passed to the output
-    if ( this->GenerateClipScalars )
+    bool operator < ( const EdgeEntry & other ) const
     {
-      cpyInput->GetPointData()->SetScalars( pScalars );
+      return id1 < other.id1 ||
+             ( id1 == other.id1 && ( id2 < other.id2 ||
+             ( id2 == other.id2 && rank < other.rank ) ) );
     }
-
-    for ( i = 0; i < numbPnts; i ++ )
+    bool IsSameEdge( const EdgeEntry & other ) const
     {
-      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
-      pScalars->SetTuple1( i, s );
+      return id1 == other.id1 && id2 == other.id2;
     }
-
-    clipAray = pScalars;
-  }
-  else //using input scalars
-  {
-    clipAray = this->GetInputArrayToProcess( 0, inputVector );
-    if ( !clipAray )
+  };
+
+  std::vector< vtkTableBasedClipperVolumeFromVolume * > & Pieces;
+  vtkIdType NumPieces;
+  vtkIdType NumUnits; // (shape type, piece) pairs
+  int       NumPrevPts;
+  TableBasedClipperCommonPointsStructure & Cps;
+
+  vtkPointData * InPD;
+  vtkCellData  * InCD;
+  vtkPointData * OutPD;
+  vtkCellData  * OutCD;
+  vtkPoints    * OutPts;
+  vtkIntArray  * OrigNodes;
+  vtkIntArray  * NewOrigNodes;
+
+  // Edge points: the sorted entries, the first entry of the run of equal
+  // edges of each entry (by rank), which is the one of the first piece
+  // creating the edge point, and the output index of each entry.
+  std::vector< vtkIdType > PieceEdges;
+  std::vector< EdgeEntry > SortedEdges;
+  std::vector< vtkIdType > EdgeOwner;
+  std::vector< vtkIdType > OwnerIndex;
+  std::vector< int >       EdgeIndex;
+  std::vector< vtkIdType > PieceOwnedEdges;
+
+  // Input points: the first unit using each point, and the point map.
+  std::unique_ptr< std::atomic<vtkIdType>[] > PointUnit;
+  std::vector< int >       PtLookup;
+  std::vector< vtkIdType > UnitPoints;
+
+  std::vector< vtkIdType > PieceCentroids;
+  std::vector< vtkIdType > UnitCells;
+  std::vector< vtkIdType > UnitConnectivity;
+
+  int NumUsed;
+  int CentroidStart;
+
+  vtkSMPThreadLocalObject< vtkIdList > IdList;
+
+  vtkIdType * Connectivity;
+  vtkIdType * Locations;
+  unsigned char * Types;
+
+  Merger( std::vector< vtkTableBasedClipperVolumeFromVolume * > & pieces,
+          vtkDataSet * input, vtkUnstructuredGrid * output,
+          TableBasedClipperCommonPointsStructure & cps )
+    : Pieces( pieces ), Cps( cps ), NewOrigNodes( nullptr ), NumUsed( 0 ),
+      CentroidStart( 0 ), Connectivity( nullptr ), Locations( nullptr ),
+      Types( nullptr )
+  {
+    this->NumPieces  = static_cast<vtkIdType>( pieces.size() );
+    this->NumUnits   = pieces[0]->nshapes * this->NumPieces;
+    this->NumPrevPts = pieces[0]->numPrevPts;
+    this->InPD  = input->GetPointData();
+    this->InCD  = input->GetCellData();
+    this->OutPD = output->GetPointData();
+    this->OutCD = output->GetCellData();
+    this->OutPts = nullptr;
+    this->OrigNodes = vtkArrayDownCast<vtkIntArray>
+                      (  this->InPD->GetArray( "avtOriginalNodeNumbers" )  );
+  }
+
+  vtkTableBasedClipperShapeList * GetShapes( vtkIdType unit )
+  {
+    int shape = static_cast<int>( unit / this->NumPieces );
+    return this->Pieces[ unit % this->NumPieces ]->shapes[ shape ];
+  }
+
+  // Output id of the point id of a shape or centroid of a piece.
+  int MapId( vtkIdType piece, int id ) const
+  {
+    if ( id < 0 )
     {
-      vtkErrorMacro( << "no input scalars." << endl );
-      return 1;
+      return this->CentroidStart +
+             static_cast<int>( this->PieceCentroids[ piece ] ) - 1 - id;
     }
+    if ( id >= this->NumPrevPts )
+    {
+      return this->NumUsed + this->EdgeIndex
+             [ this->PieceEdges[ piece ] + id - this->NumPrevPts ];
+    }
+    return this->PtLookup[ id ];
   }
 
-  int    gridType = cpyInput->GetDataObjectType();
-  double isoValue = ( !this->ClipFunction || this->UseValueAsOffset )
-                    ?  this->Value  :  0.0;
-  if ( gridType == VTK_IMAGE_DATA || gridType == VTK_STRUCTURED_POINTS )
+  void GetInputPoint( int id, double pt[3] ) const
   {
-    this->ClipImageData( cpyInput, clipAray, isoValue, outputUG );
-    if (clippedOutputUG)
+    if ( this->Cps.hasPtsList )
     {
-      this->InsideOut = !(this->InsideOut);
-      this->ClipImageData( cpyInput, clipAray, isoValue,
-                         clippedOutputUG );
-      this->InsideOut = !(this->InsideOut);
+      const double * p = this->Cps.pts_ptr + 3 * id;
+      pt[0] = p[0];
+      pt[1] = p[1];
+      pt[2] = p[2];
     }
-  }
-  else if ( gridType == VTK_POLY_DATA )
-  {
-    this->ClipPolyData( cpyInput, clipAray, isoValue, outputUG );
-    if (clippedOutputUG)
+    else
     {
-      this->InsideOut = !(this->InsideOut);
-      this->ClipPolyData( cpyInput, clipAray, isoValue,
-                          clippedOutputUG );
-      this->InsideOut = !(this->InsideOut);
+      GetPoint( pt, this->Cps.X, this->Cps.Y, this->Cps.Z,
+                this->Cps.dims, id );
     }
   }
-  else if ( gridType == VTK_RECTILINEAR_GRID )
+
+  static vtkIdType PrefixSum( std::vector< vtkIdType > & counts )
   {
-    this->ClipRectilinearGridData( cpyInput, clipAray,
-                                   isoValue, outputUG );
-    if (clippedOutputUG)
+    vtkIdType total = 0;
+    for ( size_t i = 0; i < counts.size(); i ++ )
     {
-      this->InsideOut = !(this->InsideOut);
-      this->ClipRectilinearGridData( cpyInput, clipAray, isoValue,
-                                     clippedOutputUG );
-      this->InsideOut = !(this->InsideOut);
+      vtkIdType count = counts[i];
+      counts[i] = total;
+      total += count;
     }
+    return total;
   }
-  else if ( gridType == VTK_STRUCTURED_GRID )
+
+  // Gather the edge points of the pieces.
+  struct GatherEdges
   {
-    this->ClipStructuredGridData( cpyInput, clipAray,
-                                  isoValue, outputUG );
-    if (clippedOutputUG)
+    Merger * Self;
+    void operator()( vtkIdType piece, vtkIdType endPiece )
     {
-      this->InsideOut = !(this->InsideOut);
-      this->ClipStructuredGridData( cpyInput, clipAray, isoValue,
-                                    clippedOutputUG );
-      this->InsideOut = !(this->InsideOut);
+      for ( ; piece < endPiece; piece ++ )
+      {
+        vtkTableBasedClipperPointList & ptList =
+          this->Self->Pieces[ piece ]->pt_list;
+        vtkIdType rank = this->Self->PieceEdges[ piece ];
+        int nLists = ptList.GetNumberOfLists();
+        for ( int i = 0; i < nLists; i ++ )
+        {
+          const TableBasedClipperPointEntry * pe_list = nullptr;
+          int nPts = ptList.GetList( i, pe_list );
+          for ( int j = 0; j < nPts; j ++, rank ++ )
+          {
+            EdgeEntry & entry = this->Self->SortedEdges[ rank ];
+            entry.id1  = pe_list[j].ptIds[0];
+            entry.id2  = pe_list[j].ptIds[1];
+            entry.rank = rank;
+          }
+        }
+      }
     }
-  }
-  else if ( gridType == VTK_UNSTRUCTURED_GRID )
+  };
+
+  // Find the first entry of each run of equal edges.
+  struct LinkEdges
   {
-    this->ClipUnstructuredGridData( cpyInput, clipAray,
-                                    isoValue, outputUG );
-    if (clippedOutputUG)
+    Merger * Self;
+    void operator()( vtkIdType idx, vtkIdType endIdx )
     {
-      this->InsideOut = !(this->InsideOut);
-      this->ClipUnstructuredGridData( cpyInput, clipAray, isoValue,
-                                      clippedOutputUG );
-      this->InsideOut = !(this->InsideOut);
+      const std::vector< EdgeEntry > & edges = this->Self->SortedEdges;
+      const vtkIdType nEdges = static_cast<vtkIdType>( edges.size() );
+      for ( ; idx < endIdx; idx ++ )
+      {
+        if ( idx > 0 && edges[ idx ].IsSameEdge( edges[ idx - 1 ] ) )
+        {
+          continue;
+        }
+        for ( vtkIdType k = idx;
+              k < nEdges && edges[ k ].IsSameEdge( edges[ idx ] ); k ++ )
+        {
+          this->Self->EdgeOwner[ edges[ k ].rank ] = edges[ idx ].rank;
+        }
+      }
     }
-  }
-  else
+  };
+
+  // Count, then number, the edge points first created by each piece.
+  struct CountEdges
   {
-    this->ClipDataSet( cpyInput, clipAray, outputUG );
-    if (clippedOutputUG)
+    Merger * Self;
+    void operator()( vtkIdType piece, vtkIdType endPiece )
     {
-      this->InsideOut = !(this->InsideOut);
-      this->ClipDataSet( cpyInput, clipAray, clippedOutputUG );
-      this->InsideOut = !(this->InsideOut);
+      for ( ; piece < endPiece; piece ++ )
+      {
+        vtkIdType count = 0;
+        for ( vtkIdType rank = this->Self->PieceEdges[ piece ];
+              rank < this->Self->PieceEdges[ piece + 1 ]; rank ++ )
+        {
+          count += ( this->Self->EdgeOwner[ rank ] == rank ? 1 : 0 );
+        }
+        this->Self->PieceOwnedEdges[ piece ] = count;
+      }
     }
-  }
+  };
 
-  outputUG->Squeeze();
+  struct NumberEdges
+  {
+    Merger * Self;
+    void operator()( vtkIdType piece, vtkIdType endPiece )
+    {
+      for ( ; piece < endPiece; piece ++ )
+      {
+        vtkIdType index = this->Self->PieceOwnedEdges[ piece ];
+        for ( vtkIdType rank = this->Self->PieceEdges[ piece ];
+              rank < this->Self->PieceEdges[ piece + 1 ]; rank ++ )
+        {
+          if ( this->Self->EdgeOwner[ rank ] == rank )
+          {
+            this->Self->OwnerIndex[ rank ] = index ++;
+          }
+        }
+      }
+    }
+  };
 
-  if (clippedOutputUG)
+  struct MapEdges
   {
-    clippedOutputUG->Squeeze();
-  }
+    Merger * Self;
+    void operator()( vtkIdType rank, vtkIdType endRank )
+    {
+      for ( ; rank < endRank; rank ++ )
+      {
+        this->Self->EdgeIndex[ rank ] = static_cast<int>
+          ( this->Self->OwnerIndex[ this->Self->EdgeOwner[ rank ] ] );
+      }
+    }
+  };
 
-  if ( pScalars )
+  // Record the first unit using each input point.
+  struct FindPointUnits
   {
-    pScalars->Delete();
-  }
-  pScalars = nullptr;
-  outputUG = nullptr;
-  clippedOutputUG = nullptr;
-  clipAray = nullptr;
+    Merger * Self;
+    void operator()( vtkIdType unit, vtkIdType endUnit )
+    {
+      for ( ; unit < endUnit; unit ++ )
+      {
+        vtkTableBasedClipperShapeList * shapes = this->Self->GetShapes( unit );
+        int nlists = shapes->GetNumberOfLists();
+        int npts_per_shape = shapes->GetShapeSize();
+        for ( int j = 0; j < nlists; j ++ )
+        {
+          const int * list;
+          int listSize = shapes->GetList( j, list );
+          for ( int k = 0; k < listSize; k ++ )
+          {
+            list ++; // skip the cell id entry
+            for ( int l = 0; l < npts_per_shape; l ++, list ++ )
+            {
+              int pt = *list;
+              if ( pt < 0 || pt >= this->Self->NumPrevPts )
+              {
+                continue;
+              }
+              std::atomic<vtkIdType> & owner = this->Self->PointUnit[ pt ];
+              vtkIdType current = owner.load( std::memory_order_relaxed );
+              while ( unit < current &&
+                      !owner.compare_exchange_weak
+                        ( current, unit, std::memory_order_relaxed ) )
+              {
+              }
+            }
+          }
+        }
+      }
+    }
+  };
 
-  return 1;
-}
+  // Number the input points in order of first use within their unit.
+  struct CountPoints
+  {
+    Merger * Self;
+    void operator()( vtkIdType unit, vtkIdType endUnit )
+    {
+      for ( ; unit < endUnit; unit ++ )
+      {
+        vtkTableBasedClipperShapeList * shapes = this->Self->GetShapes( unit );
+        int nlists = shapes->GetNumberOfLists();
+        int npts_per_shape = shapes->GetShapeSize();
+        int numUsed = 0;
+        for ( int j = 0; j < nlists; j ++ )
+        {
+          const int * list;
+          int listSize = shapes->GetList( j, list );
+          for ( int k = 0; k < listSize; k ++ )
+          {
+            list ++; // skip the cell id entry
+            for ( int l = 0; l < npts_per_shape; l ++, list ++ )
+            {
+              int pt = *list;
+              if ( pt >= 0 && pt < this->Self->NumPrevPts &&
+                   this->Self->PtLookup[ pt ] == -1 &&
+                   this->Self->PointUnit[ pt ].load
+                     ( std::memory_order_relaxed ) == unit )
+              {
+                this->Self->PtLookup[ pt ] = numUsed ++;
+              }
+            }
+          }
+        }
+        this->Self->UnitPoints[ unit ] = numUsed;
+      }
+    }
+  };
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipDataSet( vtkDataSet * pDataSet,
-     vtkDataArray * clipAray, vtkUnstructuredGrid * unstruct )
-{
-  vtkClipDataSet * clipData = vtkClipDataSet::New();
-  clipData->SetInputData( pDataSet );
-  clipData->SetValue( this->Value );
-  clipData->SetInsideOut( this->InsideOut );
-  clipData->SetClipFunction( this->ClipFunction );
-  clipData->SetUseValueAsOffset( this->UseValueAsOffset );
-  clipData->SetGenerateClipScalars( this->GenerateClipScalars );
-
-  if ( !this->ClipFunction )
-  {
-    pDataSet->GetPointData()->SetScalars( clipAray );
-  }
-
-  clipData->Update();
-  unstruct->ShallowCopy( clipData->GetOutput() );
-
-  clipData->Delete();
-  clipData = nullptr;
-}
-
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipImageData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
-{
-  int                  i, j;
-  int                  dataDims[3];
-  double               spacings[3];
-  double               tmpValue = 0.0;
-  vtkRectilinearGrid * rectGrid = nullptr;
-  vtkImageData       * volImage = vtkImageData::SafeDownCast( inputGrd );
-  volImage->GetDimensions( dataDims );
-  volImage->GetSpacing( spacings );
-  const double       * dataBBox = volImage->GetBounds();
-
-  vtkDoubleArray     * pxCoords = vtkDoubleArray::New();
-  vtkDoubleArray     * pyCoords = vtkDoubleArray::New();
-  vtkDoubleArray     * pzCoords = vtkDoubleArray::New();
-  vtkDoubleArray * tmpArays[3] = { pxCoords, pyCoords, pzCoords };
-  for ( j = 0; j < 3; j ++ )
-  {
-    tmpArays[j]->SetNumberOfComponents( 1 );
-    tmpArays[j]->SetNumberOfTuples( dataDims[j] );
-    for ( tmpValue  = dataBBox[ j << 1 ], i = 0; i < dataDims[j]; i ++,
-          tmpValue += spacings[j] )
-    {
-      tmpArays[j]->SetComponent( i, 0, tmpValue );
-    }
-    tmpArays[j] = nullptr;
-  }
-
-  rectGrid = vtkRectilinearGrid::New();
-  rectGrid->SetDimensions( dataDims );
-  rectGrid->SetXCoordinates( pxCoords );
-  rectGrid->SetYCoordinates( pyCoords );
-  rectGrid->SetZCoordinates( pzCoords );
-  rectGrid->GetPointData()->ShallowCopy( volImage->GetPointData() );
-  rectGrid->GetCellData()->ShallowCopy( volImage->GetCellData() );
-
-  this->ClipRectilinearGridData( rectGrid, clipAray, isoValue, outputUG );
-
-  pxCoords->Delete();
-  pyCoords->Delete();
-  pzCoords->Delete();
-  rectGrid->Delete();
-  pxCoords = nullptr;
-  pyCoords = nullptr;
-  pzCoords = nullptr;
-  rectGrid = nullptr;
-  volImage = nullptr;
-  dataBBox = nullptr;
-}
-
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
-{
-  vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
-  int           numCells = polyData->GetNumberOfCells();
-
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-     this->OutputPointsPrecision, polyData->GetNumberOfPoints(),
-     int(   pow(  double( numCells ),  double( 0.6667f )  )   ) * 5 + 100    );
-
-  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
-  specials->SetPoints( polyData->GetPoints() );
-  specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
-  specials->Allocate( numCells );
-
-  vtkIdType   i, j;
-  vtkIdType   numbPnts = 0;
-  int         numCants = 0;  // number of cells not clipped by this filter
-
-  for ( i = 0; i < numCells; i ++ )
+  // Copy the input points used by the output.
+  struct CopyPoints
   {
-    int         cellType = polyData->GetCellType( i );
-    bool        bCanClip = false;
-    vtkIdType * pntIndxs = nullptr;
-    polyData->GetCellPoints( i, numbPnts, pntIndxs );
-
-    switch ( cellType )
+    Merger * Self;
+    void operator()( vtkIdType i, vtkIdType endI )
     {
-      case VTK_TETRA:
-      case VTK_PYRAMID:
-      case VTK_WEDGE:
-      case VTK_HEXAHEDRON:
-      case VTK_TRIANGLE:
-      case VTK_QUAD:
-      case VTK_LINE:
-      case VTK_VERTEX:
-           bCanClip = true;
-           break;
-
-      default:
-           bCanClip = false;
-           break;
-    }
-
-    if ( bCanClip )
-    {
-      double    grdDiffs[8];
-      int       caseIndx = 0;
-
-      for ( j = numbPnts - 1; j >= 0; j -- )
-      {
-        grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
-        caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-        caseIndx  <<= (  1 - ( !j )  );
-      }
-
-      int              startIdx = 0;
-      int              nOutputs = 0;
-      typedef int      EDGEIDXS[2];
-      const EDGEIDXS * edgeVtxs = nullptr;
-      unsigned char *  thisCase = nullptr;
-
-      switch ( cellType )
-      {
-        case VTK_TETRA:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
-          break;
-
-        case VTK_PYRAMID:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
-          break;
-
-        case VTK_WEDGE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
-          break;
-
-        case VTK_HEXAHEDRON:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
-          break;
-
-        case VTK_TRIANGLE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
-          break;
-
-        case VTK_QUAD:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
-          break;
-
-        case VTK_LINE:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
-          edgeVtxs = vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
-          break;
-
-        case VTK_VERTEX:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVtx[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVtx[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVtx[ caseIndx ];
-          edgeVtxs = nullptr;
-          break;
-      }
-
-      int  intrpIds[4];
-      for ( j = 0; j < nOutputs; j ++ )
+      Merger * self = this->Self;
+      double pt[3];
+      for ( ; i < endI; i ++ )
       {
-        int      nCellPts = 0;
-        int      intrpIdx = -1;
-        int      theColor = -1;
-        unsigned char theShape = *thisCase ++;
-
-        switch ( theShape )
+        vtkIdType unit = self->PointUnit[i].load( std::memory_order_relaxed );
+        if ( unit >= self->NumUnits )
         {
-          case ST_HEX:
-            nCellPts = 8;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_WDG:
-            nCellPts = 6;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PYR:
-            nCellPts = 5;
-            theColor = *thisCase ++;
-            break;
-          case ST_TET:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_QUA:
-            nCellPts = 4;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_TRI:
-            nCellPts = 3;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_LIN:
-            nCellPts = 2;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_VTX:
-            nCellPts = 1;
-            theColor = *thisCase ++;
-            break;
-
-          case ST_PNT:
-            intrpIdx = *thisCase ++;
-            theColor = *thisCase ++;
-            nCellPts = *thisCase ++;
-            break;
-
-          default:
-            vtkErrorMacro( << "An invalid output shape was found in "
-                           << "the ClipCases." << endl );
+          continue;
         }
-
-        if ( (!this->InsideOut && theColor == COLOR0 ) ||
-             ( this->InsideOut && theColor == COLOR1 )
-           )
+        int id = self->PtLookup[i] +
+                 static_cast<int>( self->UnitPoints[ unit ] );
+        self->PtLookup[i] = id;
+
+        self->GetInputPoint( static_cast<int>( i ), pt );
+        self->OutPts->SetPoint( id, pt );
+        self->OutPD->CopyData( self->InPD, i, id );
+        if ( self->NewOrigNodes )
         {
-          // We don't want this one; it's the wrong side.
-          thisCase += nCellPts;
-          continue;
+          self->NewOrigNodes->SetTuple( id, i, self->OrigNodes );
         }
+      }
+    }
+  };
 
-        int   shapeIds[8];
-        for ( int p = 0; p < nCellPts; p ++ )
+  // Interpolate the edge points first created by each piece.
+  struct InterpolateEdges
+  {
+    Merger * Self;
+    void operator()( vtkIdType piece, vtkIdType endPiece )
+    {
+      Merger * self = this->Self;
+      for ( ; piece < endPiece; piece ++ )
+      {
+        vtkTableBasedClipperPointList & ptList = self->Pieces[ piece ]->pt_list;
+        vtkIdType rank = self->PieceEdges[ piece ];
+        int nLists = ptList.GetNumberOfLists();
+        for ( int i = 0; i < nLists; i ++ )
         {
-          unsigned char pntIndex = *thisCase ++;
-
-          if ( pntIndex <= P7 )
+          const TableBasedClipperPointEntry * pe_list = nullptr;
+          int nPts = ptList.GetList( i, pe_list );
+          for ( int j = 0; j < nPts; j ++, rank ++ )
           {
-            shapeIds[p] = pntIndxs[ pntIndex ];
-          }
-          else
-          if ( pntIndex >= EA && pntIndex <= EL )
-          {
-            int pt1Index = edgeVtxs[ pntIndex - EA ][0];
-            int pt2Index = edgeVtxs[ pntIndex - EA ][1];
-            if ( pt2Index < pt1Index )
+            if ( self->EdgeOwner[ rank ] != rank )
             {
-              int temp = pt2Index;
-              pt2Index = pt1Index;
-              pt1Index = temp;
+              continue;
             }
-            double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-            double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-            double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-            int    pntIndx1 = pntIndxs[ pt1Index ];
-            int    pntIndx2 = pntIndxs[ pt2Index ];
 
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-          }
-          else
-          if ( pntIndex >= N0 && pntIndex <= N3 )
-          {
-            shapeIds[p] = intrpIds[ pntIndex - N0 ];
-          }
-          else
-          {
-            vtkErrorMacro( << "An invalid output point value "
-                           << "was found in the ClipCases." << endl );
+            const TableBasedClipperPointEntry & pe = pe_list[j];
+            double pt1[3], pt2[3], pt[3];
+            self->GetInputPoint( pe.ptIds[0], pt1 );
+            self->GetInputPoint( pe.ptIds[1], pt2 );
+
+            double p  = pe.percent;
+            double bp = 1.0 - p;
+            pt[0] = pt1[0] * p + pt2[0] * bp;
+            pt[1] = pt1[1] * p + pt2[1] * bp;
+            pt[2] = pt1[2] * p + pt2[2] * bp;
+
+            int ptIdx = self->NumUsed + self->EdgeIndex[ rank ];
+            self->OutPts->SetPoint( ptIdx, pt );
+            self->OutPD->InterpolateEdge( self->InPD, ptIdx,
+                                          pe.ptIds[0], pe.ptIds[1], bp );
+            if ( self->NewOrigNodes )
+            {
+              int id = ( bp <= 0.5 ? pe.ptIds[0] : pe.ptIds[1] );
+              self->NewOrigNodes->SetTuple( ptIdx, id, self->OrigNodes );
+            }
           }
         }
+      }
+    }
+  };
 
-        switch ( theShape )
+  // Compute the centroid points; they only depend on points of the same
+  // piece created before them.
+  struct InterpolateCentroids
+  {
+    Merger * Self;
+    void operator()( vtkIdType piece, vtkIdType endPiece )
+    {
+      Merger * self = this->Self;
+      vtkIdList * idList = self->IdList.Local();
+      for ( ; piece < endPiece; piece ++ )
+      {
+        vtkTableBasedClipperCentroidPointList & centroids =
+          self->Pieces[ piece ]->centroid_list;
+        int ptIdx = self->CentroidStart +
+                    static_cast<int>( self->PieceCentroids[ piece ] );
+        int nLists = centroids.GetNumberOfLists();
+        for ( int i = 0; i < nLists; i ++ )
         {
-          case ST_HEX:
-            visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3], shapeIds[4],
-                                 shapeIds[5], shapeIds[6], shapeIds[7] );
-            break;
-
-          case ST_WDG:
-            visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                   shapeIds[3], shapeIds[4], shapeIds[5] );
-            break;
-
-          case ST_PYR:
-            visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                     shapeIds[2], shapeIds[3], shapeIds[4] );
-            break;
-
-          case ST_TET:
-            visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                                 shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_QUA:
-            visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                  shapeIds[2], shapeIds[3] );
-            break;
-
-          case ST_TRI:
-            visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-            break;
-
-          case ST_LIN:
-            visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-            break;
-
-          case ST_VTX:
-            visItVFV->AddVertex( i, shapeIds[0] );
-            break;
+          const TableBasedClipperCentroidPointEntry * ce_list = nullptr;
+          int nPts = centroids.GetList( i, ce_list );
+          for ( int j = 0; j < nPts; j ++, ptIdx ++ )
+          {
+            const TableBasedClipperCentroidPointEntry & ce = ce_list[j];
+            idList->SetNumberOfIds( ce.nPts );
+            double pts[8][3];
+            double weights[8];
+            double pt[3] = { 0.0, 0.0, 0.0 };
+            double weight_factor = 1.0 / ce.nPts;
+            for ( int k = 0; k < ce.nPts; k ++ )
+            {
+              weights[k] = 1.0 * weight_factor;
+              int id = self->MapId( piece, ce.ptIds[k] );
+              idList->SetId( k, id );
+              self->OutPts->GetPoint( id, pts[k] );
+              pt[0] += pts[k][0];
+              pt[1] += pts[k][1];
+              pt[2] += pts[k][2];
+            }
+            pt[0] *= weight_factor;
+            pt[1] *= weight_factor;
+            pt[2] *= weight_factor;
 
-          case ST_PNT:
-            intrpIds[intrpIdx] = visItVFV->AddCentroidPoint( nCellPts, shapeIds );
-            break;
+            self->OutPts->SetPoint( ptIdx, pt );
+            self->OutPD->InterpolatePoint( self->OutPD, ptIdx, idList, weights );
+            if ( self->NewOrigNodes )
+            {
+              // these 'created' nodes have no original designation
+              for ( int z = 0; z < self->NewOrigNodes->GetNumberOfComponents();
+                    z ++ )
+              {
+                self->NewOrigNodes->SetComponent( ptIdx, z, -1 );
+              }
+            }
+          }
         }
       }
-
-      edgeVtxs = nullptr;
-      thisCase = nullptr;
     }
-    else
+  };
+
+  // Generate the cells of each unit and copy their data.
+  struct CopyCells
+  {
+    Merger * Self;
+    void operator()( vtkIdType unit, vtkIdType endUnit )
     {
-      if ( numCants == 0 )
+      Merger * self = this->Self;
+      for ( ; unit < endUnit; unit ++ )
       {
-        specials->GetCellData()
-                ->CopyAllocate( polyData->GetCellData(), numCells );
+        vtkTableBasedClipperShapeList * shapes = self->GetShapes( unit );
+        vtkIdType piece = unit % self->NumPieces;
+        int nlists = shapes->GetNumberOfLists();
+        int shapesize = shapes->GetShapeSize();
+        unsigned char vtk_type = static_cast<unsigned char>
+                                 ( shapes->GetVTKType() );
+        vtkIdType cellId = self->UnitCells[ unit ];
+        vtkIdType current_index = self->UnitConnectivity[ unit ];
+        vtkIdType * nl = self->Connectivity + current_index;
+        for ( int j = 0; j < nlists; j ++ )
+        {
+          const int * list;
+          int listSize = shapes->GetList( j, list );
+          for ( int k = 0; k < listSize; k ++ )
+          {
+            self->OutCD->CopyData( self->InCD, list[0], cellId );
+            self->Locations[ cellId ] = current_index;
+            self->Types[ cellId ] = vtk_type;
+            *nl ++ = shapesize;
+            for ( int l = 0; l < shapesize; l ++ )
+            {
+              *nl ++ = self->MapId( piece, list[ l + 1 ] );
+            }
+            list += shapesize + 1;
+            current_index += shapesize + 1;
+            cellId ++;
+          }
+        }
       }
-
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
-      specials->GetCellData()
-              ->CopyData( polyData->GetCellData(), i, numCants );
-      numCants ++;
     }
+  };
 
-    pntIndxs = nullptr;
-  }
-
-
-  int         toDelete = 0;
-  double    * theCords = nullptr;
-  vtkPoints * inputPts = polyData->GetPoints();
-  if ( inputPts->GetDataType() == VTK_DOUBLE )
-  {
-    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
-  }
-  else
+  void Execute( vtkDataSet * input, vtkUnstructuredGrid * output )
   {
-    toDelete = 1;
-    numbPnts = inputPts->GetNumberOfPoints();
-    theCords = new double [ numbPnts * 3 ];
-    for ( i = 0; i < numbPnts; i ++ )
+    vtkIdType i;
+
+    // Merge the edge points shared by several pieces.
+    this->PieceEdges.resize( this->NumPieces + 1 );
+    this->PieceCentroids.resize( this->NumPieces );
+    for ( i = 0; i < this->NumPieces; i ++ )
     {
-      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+      this->PieceEdges[i] = this->Pieces[i]->pt_list.GetTotalNumberOfPoints();
+      this->PieceCentroids[i] =
+        this->Pieces[i]->centroid_list.GetTotalNumberOfPoints();
     }
-  }
-  inputPts = nullptr;
-
+    this->PieceEdges[ this->NumPieces ] = 0;
+    vtkIdType numEdgeEntries = PrefixSum( this->PieceEdges );
+    vtkIdType numCentroids   = PrefixSum( this->PieceCentroids );
+
+    this->SortedEdges.resize( numEdgeEntries );
+    this->EdgeOwner.resize( numEdgeEntries );
+    this->OwnerIndex.resize( numEdgeEntries );
+    this->EdgeIndex.resize( numEdgeEntries );
+    this->PieceOwnedEdges.resize( this->NumPieces );
+
+    GatherEdges gatherEdges = { this };
+    vtkSMPTools::For( 0, this->NumPieces, 1, gatherEdges );
+    vtkSMPTools::Sort( this->SortedEdges.begin(), this->SortedEdges.end() );
+    LinkEdges linkEdges = { this };
+    vtkSMPTools::For( 0, numEdgeEntries, linkEdges );
+    CountEdges countEdges = { this };
+    vtkSMPTools::For( 0, this->NumPieces, 1, countEdges );
+    vtkIdType numEdges = PrefixSum( this->PieceOwnedEdges );
+    NumberEdges numberEdges = { this };
+    vtkSMPTools::For( 0, this->NumPieces, 1, numberEdges );
+    MapEdges mapEdges = { this };
+    vtkSMPTools::For( 0, numEdgeEntries, mapEdges );
+
+    // Select and number the input points used by the output.
+    this->PointUnit.reset( new std::atomic<vtkIdType>[ this->NumPrevPts ] );
+    for ( i = 0; i < this->NumPrevPts; i ++ )
+    {
+      this->PointUnit[i].store( this->NumUnits, std::memory_order_relaxed );
+    }
+    this->PtLookup.assign( this->NumPrevPts, -1 );
+    this->UnitPoints.resize( this->NumUnits );
 
-  if ( numCants > 0 )
-  {
-    vtkUnstructuredGrid * vtkUGrid  = vtkUnstructuredGrid::New();
-    this->ClipDataSet( specials, clipAray, vtkUGrid );
+    FindPointUnits findPointUnits = { this };
+    vtkSMPTools::For( 0, this->NumUnits, 1, findPointUnits );
+    CountPoints countPoints = { this };
+    vtkSMPTools::For( 0, this->NumUnits, 1, countPoints );
+    this->NumUsed = static_cast<int>( PrefixSum( this->UnitPoints ) );
 
-    vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
-    visItVFV->ConstructDataSet( polyData, visItGrd, theCords );
+    this->CentroidStart = this->NumUsed + static_cast<int>( numEdges );
+    int nOutPts = this->CentroidStart + static_cast<int>( numCentroids );
 
-    vtkAppendFilter * appender = vtkAppendFilter::New();
-    appender->AddInputData( vtkUGrid );
-    appender->AddInputData( visItGrd );
-    appender->Update();
+    // Set up the output points and point data, then fill them.
+    this->OutPts = this->Pieces[0]->NewOutputPoints( input );
+    this->OutPts->SetNumberOfPoints( nOutPts );
+    this->OutPD->CopyAllocate( this->InPD, nOutPts );
+    this->OutPD->SetNumberOfTuples( nOutPts );
 
-    outputUG->ShallowCopy( appender->GetOutput() );
+    if ( this->OrigNodes != nullptr )
+    {
+      this->NewOrigNodes = vtkIntArray::New();
+      this->NewOrigNodes->SetNumberOfComponents
+                          ( this->OrigNodes->GetNumberOfComponents() );
+      this->NewOrigNodes->SetNumberOfTuples( nOutPts );
+      this->NewOrigNodes->SetName( this->OrigNodes->GetName() );
+    }
 
-    appender->Delete();
-    vtkUGrid->Delete();
-    visItGrd->Delete();
-    appender = nullptr;
-    vtkUGrid = nullptr;
-    visItGrd = nullptr;
-  }
-  else
-  {
-    visItVFV->ConstructDataSet( polyData, outputUG, theCords );
-  }
+    CopyPoints copyPoints = { this };
+    vtkSMPTools::For( 0, this->NumPrevPts, copyPoints );
+    InterpolateEdges interpolateEdges = { this };
+    vtkSMPTools::For( 0, this->NumPieces, 1, interpolateEdges );
+    InterpolateCentroids interpolateCentroids = { this };
+    vtkSMPTools::For( 0, this->NumPieces, 1, interpolateCentroids );
 
+    output->SetPoints( this->OutPts );
+    this->OutPts->Delete();
 
-  specials->Delete();
-  delete visItVFV;
-  if ( toDelete )
-  {
-    delete [] theCords;
-  }
-  specials = nullptr;
-  visItVFV = nullptr;
-  theCords = nullptr;
-  polyData = nullptr;
-}
+    if ( this->NewOrigNodes )
+    {
+      // AddArray will overwrite an already existing array with
+      // the same name, exactly what we want here.
+      this->OutPD->AddArray( this->NewOrigNodes );
+      this->NewOrigNodes->Delete();
+    }
 
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
-{
-  vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
+    // Now set up the shapes and the cell data.
+    this->UnitCells.resize( this->NumUnits );
+    this->UnitConnectivity.resize( this->NumUnits );
+    for ( i = 0; i < this->NumUnits; i ++ )
+    {
+      vtkTableBasedClipperShapeList * shapes = this->GetShapes( i );
+      this->UnitCells[i] = shapes->GetTotalNumberOfShapes();
+      this->UnitConnectivity[i] =
+        ( shapes->GetShapeSize() + 1 ) * this->UnitCells[i];
+    }
+    vtkIdType ncells    = PrefixSum( this->UnitCells );
+    vtkIdType conn_size = PrefixSum( this->UnitConnectivity );
 
-  int   i, j;
-  int   numCells = 0;
-  int   isTwoDim = 0;
-  enum TwoDimType { XY, YZ, XZ };
-  TwoDimType twoDimType;
-  int   rectDims[3];
-  rectGrid->GetDimensions( rectDims );
-  isTwoDim = int( rectDims[0] <= 1 || rectDims[1] <= 1 || rectDims[2] <= 1 );
-  if (rectDims[0] <= 1) twoDimType = YZ;
-  else if (rectDims[1] <= 1) twoDimType = XZ;
-  else twoDimType = XY;
-  numCells = rectGrid->GetNumberOfCells();
+    this->OutCD->CopyAllocate( this->InCD, ncells );
+    this->OutCD->SetNumberOfTuples( ncells );
 
-  vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, rectGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+    vtkIdTypeArray * nlist = vtkIdTypeArray::New();
+    nlist->SetNumberOfValues( conn_size );
+    this->Connectivity = nlist->GetPointer( 0 );
 
-  int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
-  int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
-  int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+    vtkUnsignedCharArray * cellTypes = vtkUnsignedCharArray::New();
+    cellTypes->SetNumberOfValues( ncells );
+    this->Types = cellTypes->GetPointer( 0 );
 
-  int* shiftLUT[3];
-  if (isTwoDim && twoDimType == XZ)
-  {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTy;
-  }
-  else if (isTwoDim && twoDimType == YZ)
-  {
-    shiftLUT[0] = shiftLUTy;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTx;
-  }
-  else
-  {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTy;
-    shiftLUT[2] = shiftLUTz;
-  }
+    vtkIdTypeArray * cellLocations = vtkIdTypeArray::New();
+    cellLocations->SetNumberOfValues( ncells );
+    this->Locations = cellLocations->GetPointer( 0 );
 
-  int   cellDims[3] = { rectDims[0] - 1, rectDims[1] - 1, rectDims[2] - 1 };
-  int   cyStride    = (cellDims[0] ? cellDims[0] : 1);
-  int   czStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
-  int   pyStride    = rectDims[0];
-  int   pzStride    = rectDims[0] * rectDims[1];
+    CopyCells copyCells = { this };
+    vtkSMPTools::For( 0, this->NumUnits, 1, copyCells );
 
-  for ( i = 0; i < numCells; i ++ )
-  {
-    int    caseIndx = 0;
-    int    nCellPts = isTwoDim ? 4 : 8;
-    int    theCellI = (cellDims[0] > 0 ? i % cellDims[0] : 0);
-    int    theCellJ = (cellDims[1] > 0 ? ( i / cyStride ) % cellDims[1] : 0);
-    int    theCellK = (cellDims[2] > 0 ? ( i / czStride ) : 0);
-    double grdDiffs[8];
+    vtkCellArray * cells = vtkCellArray::New();
+    cells->SetCells( ncells, nlist );
+    nlist->Delete();
 
-    for ( j = nCellPts - 1; j >= 0; j -- )
-    {
-      grdDiffs[j] = clipAray->GetComponent
-                              (  ( theCellK + shiftLUT[2][j] ) * pzStride +
-                                 ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                                 ( theCellI + shiftLUT[0][j] ),  0
-                              ) - isoValue;
-      caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx  <<= (  1 - ( !j )  );
-    }
+    output->SetCells( cellTypes, cellLocations, cells );
+    cellTypes->Delete();
+    cellLocations->Delete();
+    cells->Delete();
+  }
+};
 
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = nullptr;
+void vtkTableBasedClipperVolumeFromVolumePieces::
+     ConstructDataSet( vtkDataSet * input,
+                       vtkUnstructuredGrid * output,
+                       TableBasedClipperCommonPointsStructure & cps )
+{
+  if ( pieces.size() == 1 )
+  {
+    pieces[0]->ConstructDataSet( input, output, cps );
+    return;
+  }
 
-    if ( isTwoDim )
-    {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-    }
-    else
-    {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-    }
+  Merger merger( pieces, input, output, cps );
+  merger.Execute( input, output );
+}
+// ============================================================================
+// =============== vtkTableBasedClipperVolumeFromVolumePieces ( end ) =========
+// ============================================================================
 
-    for ( j = 0; j < nOutputs; j++ )
-    {
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
 
-      nCellPts = 0;
-      switch ( theShape )
-      {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
+//-----------------------------------------------------------------------------
+// Construct with user-specified implicit function; InsideOut turned off; value
+// set to 0.0; and generate clip scalars turned off.
+vtkTableBasedClipDataSet::vtkTableBasedClipDataSet( vtkImplicitFunction * cf )
+{
+  this->Locator      = nullptr;
+  this->ClipFunction = cf;
 
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
+  // setup a callback to report progress
+  this->InternalProgressObserver = vtkCallbackCommand::New();
+  this->InternalProgressObserver->SetCallback
+        ( &vtkTableBasedClipDataSet::InternalProgressCallbackFunction );
+  this->InternalProgressObserver->SetClientData( this );
 
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
+  this->Value     = 0.0;
+  this->InsideOut = 0;
+  this->MergeTolerance        = 0.01;
+  this->UseValueAsOffset      = true;
+  this->GenerateClipScalars   = 0;
+  this->GenerateClippedOutput = 0;
 
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
+  this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->NumberOfPieces = 0;
 
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
+  this->SetNumberOfOutputPorts( 2 );
+  vtkUnstructuredGrid * output2 = vtkUnstructuredGrid::New();
+  this->GetExecutive()->SetOutputData( 1, output2 );
+  output2->Delete();
+  output2 = nullptr;
 
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
+  // process active point scalars by default
+  this->SetInputArrayToProcess
+        ( 0, 0, 0, vtkDataObject::FIELD_ASSOCIATION_POINTS,
+          vtkDataSetAttributes::SCALARS );
+}
 
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
+//-----------------------------------------------------------------------------
+vtkTableBasedClipDataSet::~vtkTableBasedClipDataSet()
+{
+  if ( this->Locator )
+  {
+    this->Locator->UnRegister( this );
+    this->Locator = nullptr;
+  }
+  this->SetClipFunction( nullptr );
+  this->InternalProgressObserver->Delete();
+  this->InternalProgressObserver = nullptr;
+}
 
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::InternalProgressCallbackFunction
+   ( vtkObject * arg, unsigned long, void * clientdata, void * )
+{
+  reinterpret_cast < vtkTableBasedClipDataSet * > ( clientdata )
+    ->InternalProgressCallback(  static_cast < vtkAlgorithm * > ( arg )  );
+}
 
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::InternalProgressCallback
+   ( vtkAlgorithm * algorithm )
+{
+  double progress = algorithm->GetProgress();
+  this->UpdateProgress( progress );
 
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-      }
+  if ( this->AbortExecute )
+  {
+    algorithm->SetAbortExecute( 1 );
+  }
+}
 
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-      {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-      }
+//-----------------------------------------------------------------------------
+vtkMTimeType vtkTableBasedClipDataSet::GetMTime()
+{
+  vtkMTimeType time;
+  vtkMTimeType mTime = this->Superclass::GetMTime();
 
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-      {
-        unsigned char pntIndex = *thisCase ++;
+  if ( this->ClipFunction != nullptr )
+  {
+    time  = this->ClipFunction->GetMTime();
+    mTime = ( time > mTime ? time : mTime );
+  }
 
-        if ( pntIndex <= P7 )
-        {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-        }
-        else if ( pntIndex >= EA && pntIndex <= EL )
-        {
-          int pt1Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][0];
-          int pt2Index = vtkTableBasedClipperTriangulationTables::
-                         HexVerticesFromEdges[ pntIndex - EA ][1];
+  if ( this->Locator != nullptr )
+  {
+    time  = this->Locator->GetMTime();
+    mTime = ( time > mTime ? time : mTime );
+  }
 
-          if ( pt2Index < pt1Index )
-          {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-          }
+  return mTime;
+}
 
-          double pt1ToPt2 = grdDiffs[ pt2Index ] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          /* We may have physically (though not logically) degenerate cells
-          // if p1Weight == 0 or p1Weight == 1. We could pretty easily and
-          // mostly safely clamp percent to the range [1e-4, 1 - 1e-4].
-          if( p1Weight == 1.0)
-            {
-            shapeIds[p] = pntIndx1;
-            }
-          else
-          if( p1Weight == 0.0 )
-            {
-            shapeIds[p] = pntIndx2;
-            }
-          else
+vtkUnstructuredGrid *vtkTableBasedClipDataSet::GetClippedOutput()
+{
+  if ( !this->GenerateClippedOutput )
+  {
+    return nullptr;
+  }
 
-            {
-            shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-            }
-          */
-
-          // Turning on the above code segment, the alternative, would cause
-          // a bug with a synthetic Wavelet dataset (vtkImageData) when the
-          // the clipping plane (x/y/z axis) is positioned exactly at (0,0,0).
-          // The problem occurs in the form of an open 'box', as opposed to an
-          // expected closed one. This is due to the use of hash instead of a
-          // point-locator based detection of duplicate points.
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-        }
-        else if ( pntIndex >= N0 && pntIndex <= N3 )
-        {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-        }
-        else
-        {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-        }
-      }
+  return vtkUnstructuredGrid::SafeDownCast
+        (  this->GetExecutive()->GetOutputData( 1 )  );
+}
 
-      switch ( theShape )
-      {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::SetLocator
+   ( vtkIncrementalPointLocator * locator )
+{
+  if ( this->Locator == locator)
+  {
+    return;
+  }
 
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
+  if ( this->Locator )
+  {
+    this->Locator->UnRegister( this );
+    this->Locator = nullptr;
+  }
 
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
+  if ( locator )
+  {
+    locator->Register( this );
+  }
 
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
+  this->Locator = locator;
+  this->Modified();
+}
 
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::CreateDefaultLocator()
+{
+  if ( this->Locator == nullptr )
+  {
+    this->Locator = vtkMergePoints::New();
+    this->Locator->Register( this );
+    this->Locator->Delete();
+  }
+}
 
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
+//-----------------------------------------------------------------------------
+int vtkTableBasedClipDataSet::FillInputPortInformation
+  ( int, vtkInformation * info )
+{
+  info->Set( vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet" );
+  return 1;
+}
 
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
+//-----------------------------------------------------------------------------
+int vtkTableBasedClipDataSet::RequestData( vtkInformation * vtkNotUsed( request ),
+    vtkInformationVector ** inputVector, vtkInformationVector * outputVector )
+{
+  // input and output information objects
+  vtkInformation * inputInf = inputVector[0]->GetInformationObject( 0 );
+  vtkInformation * outInfor = outputVector->GetInformationObject( 0 );
 
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
+  // Get the input of which we have to create a copy since the clipper requires
+  // that InterpolateAllocate() be invoked for the output based on its input in
+  // terms of the point data. If the input and output arrays are different,
+  // vtkCell3D's Clip will fail. The last argument of InterpolateAllocate makes
+  // sure that arrays are shallow-copied from theInput to cpyInput.
+  vtkDataSet * theInput = vtkDataSet::SafeDownCast
+                          (  inputInf->Get( vtkDataObject::DATA_OBJECT() )  );
+  vtkSmartPointer< vtkDataSet > cpyInput;
+  cpyInput.TakeReference( theInput->NewInstance() );
+  cpyInput->CopyStructure( theInput  );
+  cpyInput->GetCellData()->PassData( theInput->GetCellData() );
+  cpyInput->GetPointData()
+          ->InterpolateAllocate( theInput->GetPointData(), 0, 0, 1 );
 
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-      }
-    }
+  // get the output (the remaining and the clipped parts)
+  vtkUnstructuredGrid * outputUG = vtkUnstructuredGrid::SafeDownCast
+                        (  outInfor->Get( vtkDataObject::DATA_OBJECT() )  );
+  vtkUnstructuredGrid * clippedOutputUG = this->GetClippedOutput();
 
-    thisCase = nullptr;
-  }
+  inputInf = nullptr;
+  outInfor = nullptr;
+  theInput = nullptr;
+  vtkDebugMacro( << "Clipping dataset" << endl );
 
 
-  int            toDelete    = 0;
-  double       * theCords[3] = { nullptr, nullptr, nullptr };
-  vtkDataArray * theArays[3] = { nullptr, nullptr, nullptr };
+  int  i;
+  vtkIdType  numbPnts = cpyInput->GetNumberOfPoints();
 
-  if ( rectGrid->GetXCoordinates()->GetDataType() == VTK_DOUBLE &&
-       rectGrid->GetYCoordinates()->GetDataType() == VTK_DOUBLE &&
-       rectGrid->GetZCoordinates()->GetDataType() == VTK_DOUBLE
-     )
+  // handling exceptions
+  if ( numbPnts < 1 )
   {
-    theCords[0] = static_cast < double * >
-                  (  rectGrid->GetXCoordinates()->GetVoidPointer( 0 )  );
-    theCords[1] = static_cast < double * >
-                  (  rectGrid->GetYCoordinates()->GetVoidPointer( 0 )  );
-    theCords[2] = static_cast < double * >
-                  (  rectGrid->GetZCoordinates()->GetVoidPointer( 0 )  );
+    vtkDebugMacro( << "No data to clip" << endl );
+    outputUG = nullptr;
+    return 1;
   }
-  else
+
+  if ( !this->ClipFunction && this->GenerateClipScalars )
   {
-    toDelete    = 1;
-    theArays[0] = rectGrid->GetXCoordinates();
-    theArays[1] = rectGrid->GetYCoordinates();
-    theArays[2] = rectGrid->GetZCoordinates();
-    for ( j = 0; j < 3; j ++ )
-    {
-      theCords[j] = new double [ rectDims[j] ];
-      for ( i = 0; i < rectDims[j]; i ++ )
-      {
-        theCords[j][i] = theArays[j]->GetComponent( i, 0 );
-      }
-      theArays[j] = nullptr;
-    }
+    vtkErrorMacro( << "Cannot generate clip scalars "
+                   << "if no clip function defined" << endl );
+    outputUG = nullptr;
+    return 1;
   }
 
-  visItVFV->ConstructDataSet
-            ( rectGrid,
-              outputUG, rectDims, theCords[0], theCords[1], theCords[2] );
 
-  delete visItVFV;
-  visItVFV = nullptr;
-  rectGrid = nullptr;
+  vtkDataArray   * clipAray = nullptr;
+  vtkDoubleArray * pScalars = nullptr;
 
-  for ( i = 0; i < 3; i ++ )
+  // check whether the cells are clipped with input scalars or a clip function
+  if ( this->ClipFunction )
   {
-    if ( toDelete )
+    pScalars = vtkDoubleArray::New();
+    pScalars->SetNumberOfTuples( numbPnts );
+    pScalars->SetName( "ClipDataSetScalars" );
+
+    // enable clipDataSetScalars to be passed to the output
+    if ( this->GenerateClipScalars )
     {
-      delete [] theCords[i];
+      cpyInput->GetPointData()->SetScalars( pScalars );
     }
-    theCords[i] = nullptr;
-  }
-}
-
-//-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
-     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
-{
-  vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
-
-  int   i, j;
-  int   isTwoDim    = 0;
-  enum TwoDimType { XY, YZ, XZ };
-  TwoDimType twoDimType;
-  int   numCells    = 0;
-  int   gridDims[3] = { 0, 0, 0 };
-  strcGrid->GetDimensions( gridDims );
-  isTwoDim = int( gridDims[0] <= 1 || gridDims[1] <= 1 || gridDims[2] <= 1 );
-  if (gridDims[0] <= 1) twoDimType = YZ;
-  else if (gridDims[1] <= 1) twoDimType = XZ;
-  else twoDimType = XY;
-  numCells = strcGrid->GetNumberOfCells();
 
-  vtkTableBasedClipperVolumeFromVolume  *  visItVFV = new
-  vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, strcGrid->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+    for ( i = 0; i < numbPnts; i ++ )
+    {
+      double s = this->ClipFunction->FunctionValue(  cpyInput->GetPoint( i )  );
+      pScalars->SetTuple1( i, s );
+    }
 
-  int shiftLUTx[8] = { 0, 1, 1, 0, 0, 1, 1, 0 };
-  int shiftLUTy[8] = { 0, 0, 1, 1, 0, 0, 1, 1 };
-  int shiftLUTz[8] = { 0, 0, 0, 0, 1, 1, 1, 1 };
+    clipAray = pScalars;
+  }
+  else //using input scalars
+  {
+    clipAray = this->GetInputArrayToProcess( 0, inputVector );
+    if ( !clipAray )
+    {
+      vtkErrorMacro( << "no input scalars." << endl );
+      return 1;
+    }
+  }
 
-  int* shiftLUT[3];
-  if (isTwoDim && twoDimType == XZ)
+  int    gridType = cpyInput->GetDataObjectType();
+  double isoValue = ( !this->ClipFunction || this->UseValueAsOffset )
+                    ?  this->Value  :  0.0;
+  if ( gridType == VTK_IMAGE_DATA || gridType == VTK_STRUCTURED_POINTS )
   {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTy;
+    this->ClipImageData( cpyInput, clipAray, isoValue, outputUG );
+    if (clippedOutputUG)
+    {
+      this->InsideOut = !(this->InsideOut);
+      this->ClipImageData( cpyInput, clipAray, isoValue,
+                         clippedOutputUG );
+      this->InsideOut = !(this->InsideOut);
+    }
   }
-  else if (isTwoDim && twoDimType == YZ)
+  else if ( gridType == VTK_POLY_DATA )
   {
-    shiftLUT[0] = shiftLUTy;
-    shiftLUT[1] = shiftLUTz;
-    shiftLUT[2] = shiftLUTx;
+    this->ClipPolyData( cpyInput, clipAray, isoValue, outputUG );
+    if (clippedOutputUG)
+    {
+      this->InsideOut = !(this->InsideOut);
+      this->ClipPolyData( cpyInput, clipAray, isoValue,
+                          clippedOutputUG );
+      this->InsideOut = !(this->InsideOut);
+    }
   }
-  else
+  else if ( gridType == VTK_RECTILINEAR_GRID )
   {
-    shiftLUT[0] = shiftLUTx;
-    shiftLUT[1] = shiftLUTy;
-    shiftLUT[2] = shiftLUTz;
+    this->ClipRectilinearGridData( cpyInput, clipAray,
+                                   isoValue, outputUG );
+    if (clippedOutputUG)
+    {
+      this->InsideOut = !(this->InsideOut);
+      this->ClipRectilinearGridData( cpyInput, clipAray, isoValue,
+                                     clippedOutputUG );
+      this->InsideOut = !(this->InsideOut);
+    }
   }
-
-  int   numbPnts    = 0;
-  int   cellDims[3] = { gridDims[0] - 1, gridDims[1] - 1, gridDims[2] - 1 };
-  int   cyStride    = (cellDims[0] ? cellDims[0] : 1);
-  int   czStride    = (cellDims[0] ? cellDims[0] : 1) * (cellDims[1] ? cellDims[1] : 1);
-  int   pyStride    = gridDims[0];
-  int   pzStride    = gridDims[0] * gridDims[1];
-
-  for ( i = 0; i < numCells; i ++ )
+  else if ( gridType == VTK_STRUCTURED_GRID )
   {
-    int    caseIndx = 0;
-    int    theCellI = (cellDims[0] > 0 ? i % cellDims[0] : 0);
-    int    theCellJ = (cellDims[1] > 0 ? ( i / cyStride ) % cellDims[1] : 0);
-    int    theCellK = (cellDims[2] > 0 ? ( i / czStride ) : 0);
-    double grdDiffs[8];
-
-    numbPnts = isTwoDim ? 4 : 8;
-
-    for ( j = numbPnts - 1; j >= 0; j -- )
+    this->ClipStructuredGridData( cpyInput, clipAray,
+                                  isoValue, outputUG );
+    if (clippedOutputUG)
     {
-      int pntIndex = ( theCellI + shiftLUT[0][j] ) +
-                     ( theCellJ + shiftLUT[1][j] ) * pyStride +
-                     ( theCellK + shiftLUT[2][j] ) * pzStride;
-
-      grdDiffs[j]  = clipAray->GetComponent( pntIndex, 0 ) - isoValue;
-      caseIndx    += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
-      caseIndx   <<= (  1 - ( !j )  );
+      this->InsideOut = !(this->InsideOut);
+      this->ClipStructuredGridData( cpyInput, clipAray, isoValue,
+                                    clippedOutputUG );
+      this->InsideOut = !(this->InsideOut);
     }
-
-    int             nOutputs;
-    int             intrpIds[4];
-    unsigned char * thisCase = nullptr;
-
-    if ( isTwoDim )
+  }
+  else if ( gridType == VTK_UNSTRUCTURED_GRID )
+  {
+    this->ClipUnstructuredGridData( cpyInput, clipAray,
+                                    isoValue, outputUG );
+    if (clippedOutputUG)
     {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesQua
-               [  vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
+      this->InsideOut = !(this->InsideOut);
+      this->ClipUnstructuredGridData( cpyInput, clipAray, isoValue,
+                                      clippedOutputUG );
+      this->InsideOut = !(this->InsideOut);
     }
-    else
+  }
+  else
+  {
+    this->ClipDataSet( cpyInput, clipAray, outputUG );
+    if (clippedOutputUG)
     {
-      thisCase = &vtkTableBasedClipperClipTables::ClipShapesHex
-               [  vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ]  ];
-      nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
+      this->InsideOut = !(this->InsideOut);
+      this->ClipDataSet( cpyInput, clipAray, clippedOutputUG );
+      this->InsideOut = !(this->InsideOut);
     }
+  }
 
-    for ( j = 0; j < nOutputs; j ++ )
-    {
-      int      nCellPts = 0;
-      int      intrpIdx = -1;
-      int      theColor = -1;
-      unsigned char theShape = *thisCase ++;
-
-      switch ( theShape )
-      {
-        case ST_HEX:
-          nCellPts = 8;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_WDG:
-          nCellPts = 6;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PYR:
-          nCellPts = 5;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TET:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_QUA:
-          nCellPts = 4;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_TRI:
-          nCellPts = 3;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_LIN:
-          nCellPts = 2;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_VTX:
-          nCellPts = 1;
-          theColor = *thisCase ++;
-          break;
-
-        case ST_PNT:
-          intrpIdx = *thisCase ++;
-          theColor = *thisCase ++;
-          nCellPts = *thisCase ++;
-          break;
-
-        default:
-          vtkErrorMacro( << "An invalid output shape was found in "
-                         << "the ClipCases." << endl );
-      }
-
-      if ( (!this->InsideOut && theColor == COLOR0 ) ||
-           ( this->InsideOut && theColor == COLOR1 )
-         )
-      {
-        // We don't want this one; it's the wrong side.
-        thisCase += nCellPts;
-        continue;
-      }
-
-      int   shapeIds[8];
-      for ( int p = 0; p < nCellPts; p ++ )
-      {
-        unsigned char pntIndex = *thisCase ++;
-
-        if ( pntIndex <= P7 )
-        {
-          // We know pt P0 must be >P0 since we already
-          // assume P0 == 0.  This is why we do not
-          // bother subtracting P0 from pt here.
-          shapeIds[p] =
-                      (   (  theCellI + shiftLUT[0][ pntIndex ]  ) +
-                          (  theCellJ + shiftLUT[1][ pntIndex ]  ) * pyStride +
-                          (  theCellK + shiftLUT[2][ pntIndex ]  ) * pzStride
-                      );
-        }
-        else if ( pntIndex >= EA && pntIndex <= EL )
-        {
-          int  pt1Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][0];
-          int  pt2Index = vtkTableBasedClipperTriangulationTables::
-                          HexVerticesFromEdges[ pntIndex - EA ][1];
-
-          if ( pt2Index < pt1Index )
-          {
-            int temp = pt2Index;
-            pt2Index = pt1Index;
-            pt1Index = temp;
-          }
-
-          double pt1ToPt2 = grdDiffs[ pt2Index] - grdDiffs[ pt1Index ];
-          double pt1ToIso = 0.0 - grdDiffs[ pt1Index ];
-          double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
-
-          int    pntIndx1 =
-                 (   (  theCellI + shiftLUT[0][ pt1Index ] ) +
-                     (  theCellJ + shiftLUT[1][ pt1Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt1Index ]  ) * pzStride
-                 );
-          int    pntIndx2 =
-                 (   (  theCellI + shiftLUT[0][ pt2Index ]  ) +
-                     (  theCellJ + shiftLUT[1][ pt2Index ]  ) * pyStride +
-                     (  theCellK + shiftLUT[2][ pt2Index ]  ) * pzStride
-                 );
-
-          shapeIds[p] = visItVFV->AddPoint( pntIndx1, pntIndx2, p1Weight );
-        }
-        else if ( pntIndex >= N0 && pntIndex <= N3 )
-        {
-          shapeIds[p] = intrpIds[ pntIndex - N0 ];
-        }
-        else
-        {
-          vtkErrorMacro( << "An invalid output point value "
-                         << "was found in the ClipCases." << endl );
-        }
-      }
-
-      switch ( theShape )
-      {
-        case ST_HEX:
-          visItVFV->AddHex( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3], shapeIds[4],
-                               shapeIds[5], shapeIds[6], shapeIds[7] );
-          break;
-
-        case ST_WDG:
-          visItVFV->AddWedge( i, shapeIds[0], shapeIds[1], shapeIds[2],
-                                 shapeIds[3], shapeIds[4], shapeIds[5] );
-          break;
+  outputUG->Squeeze();
 
-        case ST_PYR:
-          visItVFV->AddPyramid( i, shapeIds[0], shapeIds[1],
-                                   shapeIds[2], shapeIds[3], shapeIds[4] );
-          break;
+  if (clippedOutputUG)
+  {
+    clippedOutputUG->Squeeze();
+  }
 
-        case ST_TET:
-          visItVFV->AddTet( i, shapeIds[0], shapeIds[1],
-                               shapeIds[2], shapeIds[3] );
-          break;
+  if ( pScalars )
+  {
+    pScalars->Delete();
+  }
+  pScalars = nullptr;
+  outputUG = nullptr;
+  clippedOutputUG = nullptr;
+  clipAray = nullptr;
 
-        case ST_QUA:
-          visItVFV->AddQuad( i, shapeIds[0], shapeIds[1],
-                                shapeIds[2], shapeIds[3] );
-          break;
+  return 1;
+}
 
-        case ST_TRI:
-          visItVFV->AddTri( i, shapeIds[0], shapeIds[1], shapeIds[2] );
-          break;
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipDataSet( vtkDataSet * pDataSet,
+     vtkDataArray * clipAray, vtkUnstructuredGrid * unstruct )
+{
+  vtkClipDataSet * clipData = vtkClipDataSet::New();
+  clipData->SetInputData( pDataSet );
+  clipData->SetValue( this->Value );
+  clipData->SetInsideOut( this->InsideOut );
+  clipData->SetClipFunction( this->ClipFunction );
+  clipData->SetUseValueAsOffset( this->UseValueAsOffset );
+  clipData->SetGenerateClipScalars( this->GenerateClipScalars );
 
-        case ST_LIN:
-          visItVFV->AddLine( i, shapeIds[0], shapeIds[1] );
-          break;
+  if ( !this->ClipFunction )
+  {
+    pDataSet->GetPointData()->SetScalars( clipAray );
+  }
 
-        case ST_VTX:
-          visItVFV->AddVertex( i, shapeIds[0] );
-          break;
+  clipData->Update();
+  unstruct->ShallowCopy( clipData->GetOutput() );
 
-        case ST_PNT:
-          intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                           ( nCellPts, shapeIds );
-          break;
-      }
-    }
+  clipData->Delete();
+  clipData = nullptr;
+}
 
-    thisCase = nullptr;
-  }
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipImageData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  int                  i, j;
+  int                  dataDims[3];
+  double               spacings[3];
+  double               tmpValue = 0.0;
+  vtkRectilinearGrid * rectGrid = nullptr;
+  vtkImageData       * volImage = vtkImageData::SafeDownCast( inputGrd );
+  volImage->GetDimensions( dataDims );
+  volImage->GetSpacing( spacings );
+  const double       * dataBBox = volImage->GetBounds();
 
-  int         toDelete = 0;
-  double    * theCords = nullptr;
-  vtkPoints * inputPts = strcGrid->GetPoints();
-  if ( inputPts->GetDataType() == VTK_DOUBLE )
-  {
-    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
-  }
-  else
+  vtkDoubleArray     * pxCoords = vtkDoubleArray::New();
+  vtkDoubleArray     * pyCoords = vtkDoubleArray::New();
+  vtkDoubleArray     * pzCoords = vtkDoubleArray::New();
+  vtkDoubleArray * tmpArays[3] = { pxCoords, pyCoords, pzCoords };
+  for ( j = 0; j < 3; j ++ )
   {
-    toDelete = 1;
-    numbPnts = inputPts->GetNumberOfPoints();
-    theCords = new double [ numbPnts * 3 ];
-    for ( i = 0; i < numbPnts; i ++ )
+    tmpArays[j]->SetNumberOfComponents( 1 );
+    tmpArays[j]->SetNumberOfTuples( dataDims[j] );
+    for ( tmpValue  = dataBBox[ j << 1 ], i = 0; i < dataDims[j]; i ++,
+          tmpValue += spacings[j] )
     {
-      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+      tmpArays[j]->SetComponent( i, 0, tmpValue );
     }
+    tmpArays[j] = nullptr;
   }
-  inputPts = nullptr;
 
-  visItVFV->ConstructDataSet( strcGrid, outputUG, theCords );
+  rectGrid = vtkRectilinearGrid::New();
+  rectGrid->SetDimensions( dataDims );
+  rectGrid->SetXCoordinates( pxCoords );
+  rectGrid->SetYCoordinates( pyCoords );
+  rectGrid->SetZCoordinates( pzCoords );
+  rectGrid->GetPointData()->ShallowCopy( volImage->GetPointData() );
+  rectGrid->GetCellData()->ShallowCopy( volImage->GetCellData() );
 
+  this->ClipRectilinearGridData( rectGrid, clipAray, isoValue, outputUG );
 
-  delete visItVFV;
-  if ( toDelete )
-  {
-    delete [] theCords;
-  }
-  visItVFV = nullptr;
-  theCords = nullptr;
-  strcGrid = nullptr;
+  pxCoords->Delete();
+  pyCoords->Delete();
+  pzCoords->Delete();
+  rectGrid->Delete();
+  pxCoords = nullptr;
+  pyCoords = nullptr;
+  pzCoords = nullptr;
+  rectGrid = nullptr;
+  volImage = nullptr;
+  dataBBox = nullptr;
 }
 
 //-----------------------------------------------------------------------------
-void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
+void vtkTableBasedClipDataSet::ClipPolyData( vtkDataSet * inputGrd,
      vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
 {
-  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
-
-  vtkIdType   i, j;
-  vtkIdType   numbPnts = 0;
-  int         numCants = 0; // number of cells not clipped by this filter
-  int         numCells = unstruct->GetNumberOfCells();
+  vtkPolyData * polyData = vtkPolyData::SafeDownCast( inputGrd );
+  int           numCells = polyData->GetNumberOfCells();
 
-  // volume from volume
   vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
   vtkTableBasedClipperVolumeFromVolume(
-      this->OutputPointsPrecision, unstruct->GetNumberOfPoints(),
-      int(   pow(  double( numCells ), double( 0.6667f )  )   ) * 5 + 100    );
+     this->OutputPointsPrecision, polyData->GetNumberOfPoints(),
+     int(   pow(  double( numCells ),  double( 0.6667f )  )   ) * 5 + 100    );
 
-  // the stuffs that can not be clipped by this filter
-  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
-  specials->SetPoints( unstruct->GetPoints() );
-  specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
+  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
+  specials->SetPoints( polyData->GetPoints() );
+  specials->GetPointData()->ShallowCopy( polyData->GetPointData() );
   specials->Allocate( numCells );
 
+  vtkIdType   i, j;
+  vtkIdType   numbPnts = 0;
+  int         numCants = 0;  // number of cells not clipped by this filter
+
   for ( i = 0; i < numCells; i ++ )
   {
-    int         cellType = unstruct->GetCellType( i );
+    int         cellType = polyData->GetCellType( i );
+    bool        bCanClip = false;
     vtkIdType * pntIndxs = nullptr;
-    unstruct->GetCellPoints( i, numbPnts, pntIndxs );
+    polyData->GetCellPoints( i, numbPnts, pntIndxs );
 
-    bool     bCanClip = false;
     switch ( cellType )
     {
       case VTK_TETRA:
       case VTK_PYRAMID:
       case VTK_WEDGE:
       case VTK_HEXAHEDRON:
-      case VTK_VOXEL:
       case VTK_TRIANGLE:
       case VTK_QUAD:
-      case VTK_PIXEL:
       case VTK_LINE:
       case VTK_VERTEX:
            bCanClip = true;
@@ -3053,95 +3373,71 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
 
     if ( bCanClip )
     {
-      int    caseIndx = 0;
-      double grdDiffs[8];
+      double    grdDiffs[8];
+      int       caseIndx = 0;
 
-      for ( j = numbPnts-1; j >= 0; j -- )
+      for ( j = numbPnts - 1; j >= 0; j -- )
       {
         grdDiffs[j] = clipAray->GetComponent( pntIndxs[j], 0 ) - isoValue;
         caseIndx   += (  ( grdDiffs[j] >= 0.0 ) ? 1 : 0  );
         caseIndx  <<= (  1 - ( !j )  );
       }
 
-      int               startIdx = 0;
-      int               nOutputs = 0;
-      typedef const int EDGEIDXS[2];
-      EDGEIDXS        * edgeVtxs = nullptr;
-      unsigned char   * thisCase = nullptr;
+      int              startIdx = 0;
+      int              nOutputs = 0;
+      typedef int      EDGEIDXS[2];
+      const EDGEIDXS * edgeVtxs = nullptr;
+      unsigned char *  thisCase = nullptr;
 
-      // start index, split case, number of output, and vertices from edges
       switch ( cellType )
       {
         case VTK_TETRA:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesTet[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesTet[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTet[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::TetVerticesFromEdges;
           break;
 
         case VTK_PYRAMID:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesPyr[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesPyr[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPyr[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::PyramidVerticesFromEdges;
           break;
 
         case VTK_WEDGE:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesWdg[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesWdg[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesWdg[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::WedgeVerticesFromEdges;
           break;
 
         case VTK_HEXAHEDRON:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesHex[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesHex[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesHex[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
-          break;
-
-        case VTK_VOXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesVox[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesVox[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesVox[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::VoxVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
           break;
 
         case VTK_TRIANGLE:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesTri[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesTri[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesTri[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::TriVerticesFromEdges;
           break;
 
         case VTK_QUAD:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesQua[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesQua[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesQua[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
-          break;
-
-        case VTK_PIXEL:
-          startIdx = vtkTableBasedClipperClipTables::StartClipShapesPix[ caseIndx ];
-          thisCase =&vtkTableBasedClipperClipTables::ClipShapesPix[ startIdx ];
-          nOutputs = vtkTableBasedClipperClipTables::NumClipShapesPix[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::PixelVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::QuadVerticesFromEdges;
           break;
 
         case VTK_LINE:
           startIdx = vtkTableBasedClipperClipTables::StartClipShapesLin[ caseIndx ];
           thisCase =&vtkTableBasedClipperClipTables::ClipShapesLin[ startIdx ];
           nOutputs = vtkTableBasedClipperClipTables::NumClipShapesLin[ caseIndx ];
-          edgeVtxs = ( EDGEIDXS * )
-                     vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
+          edgeVtxs = vtkTableBasedClipperTriangulationTables::LineVerticesFromEdges;
           break;
 
         case VTK_VERTEX:
@@ -3152,15 +3448,14 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
           break;
       }
 
-      int   intrpIds[4];
+      int  intrpIds[4];
       for ( j = 0; j < nOutputs; j ++ )
       {
         int      nCellPts = 0;
-        int      theColor = -1;
         int      intrpIdx = -1;
+        int      theColor = -1;
         unsigned char theShape = *thisCase ++;
 
-        // number of points and color
         switch ( theShape )
         {
           case ST_HEX:
@@ -3177,7 +3472,6 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             nCellPts = 5;
             theColor = *thisCase ++;
             break;
-
           case ST_TET:
             nCellPts = 4;
             theColor = *thisCase ++;
@@ -3210,8 +3504,8 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             break;
 
           default:
-            vtkErrorMacro( << "An invalid output shape was found "
-                           << "in the ClipCases." << endl );
+            vtkErrorMacro( << "An invalid output shape was found in "
+                           << "the ClipCases." << endl );
         }
 
         if ( (!this->InsideOut && theColor == COLOR0 ) ||
@@ -3230,16 +3524,13 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
 
           if ( pntIndex <= P7 )
           {
-            // We know pt P0 must be >P0 since we already
-            // assume P0 == 0.  This is why we do not
-            // bother subtracting P0 from pt here.
             shapeIds[p] = pntIndxs[ pntIndex ];
           }
           else
           if ( pntIndex >= EA && pntIndex <= EL )
           {
-            int  pt1Index = edgeVtxs[ pntIndex-EA ][0];
-            int  pt2Index = edgeVtxs[ pntIndex-EA ][1];
+            int pt1Index = edgeVtxs[ pntIndex - EA ][0];
+            int pt2Index = edgeVtxs[ pntIndex - EA ][1];
             if ( pt2Index < pt1Index )
             {
               int temp = pt2Index;
@@ -3262,8 +3553,8 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
           }
           else
           {
-            vtkErrorMacro( << "An invalid output point value was found "
-                           << "in the ClipCases." << endl );
+            vtkErrorMacro( << "An invalid output point value "
+                           << "was found in the ClipCases." << endl );
           }
         }
 
@@ -3308,8 +3599,7 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
             break;
 
           case ST_PNT:
-            intrpIds[ intrpIdx ] = visItVFV->AddCentroidPoint
-                                             ( nCellPts, shapeIds );
+            intrpIds[intrpIdx] = visItVFV->AddCentroidPoint( nCellPts, shapeIds );
             break;
         }
       }
@@ -3317,34 +3607,269 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
       edgeVtxs = nullptr;
       thisCase = nullptr;
     }
-    else if (cellType == VTK_POLYHEDRON)
+    else
     {
       if ( numCants == 0 )
       {
-          specials->GetCellData()
-                  ->CopyAllocate( unstruct->GetCellData(), numCells );
+        specials->GetCellData()
+                ->CopyAllocate( polyData->GetCellData(), numCells );
       }
-      vtkIdType nfaces, *facePtIds;
-      unstruct->GetFaceStream(i, nfaces, facePtIds);
-      specials->InsertNextCell(cellType, nfaces, facePtIds);
+
+      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
       specials->GetCellData()
-              ->CopyData( unstruct->GetCellData(), i, numCants );
+              ->CopyData( polyData->GetCellData(), i, numCants );
       numCants ++;
     }
-    else
+
+    pntIndxs = nullptr;
+  }
+
+
+  int         toDelete = 0;
+  double    * theCords = nullptr;
+  vtkPoints * inputPts = polyData->GetPoints();
+  if ( inputPts->GetDataType() == VTK_DOUBLE )
+  {
+    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
+  }
+  else
+  {
+    toDelete = 1;
+    numbPnts = inputPts->GetNumberOfPoints();
+    theCords = new double [ numbPnts * 3 ];
+    for ( i = 0; i < numbPnts; i ++ )
+    {
+      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+    }
+  }
+  inputPts = nullptr;
+
+
+  if ( numCants > 0 )
+  {
+    vtkUnstructuredGrid * vtkUGrid  = vtkUnstructuredGrid::New();
+    this->ClipDataSet( specials, clipAray, vtkUGrid );
+
+    vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
+    visItVFV->ConstructDataSet( polyData, visItGrd, theCords );
+
+    vtkAppendFilter * appender = vtkAppendFilter::New();
+    appender->AddInputData( vtkUGrid );
+    appender->AddInputData( visItGrd );
+    appender->Update();
+
+    outputUG->ShallowCopy( appender->GetOutput() );
+
+    appender->Delete();
+    vtkUGrid->Delete();
+    visItGrd->Delete();
+    appender = nullptr;
+    vtkUGrid = nullptr;
+    visItGrd = nullptr;
+  }
+  else
+  {
+    visItVFV->ConstructDataSet( polyData, outputUG, theCords );
+  }
+
+
+  specials->Delete();
+  if ( toDelete )
+  {
+    delete [] theCords;
+  }
+  specials = nullptr;
+  theCords = nullptr;
+  polyData = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkRectilinearGrid * rectGrid = vtkRectilinearGrid::SafeDownCast( inputGrd );
+
+  int   i, j;
+  int   numCells = 0;
+  int   rectDims[3];
+  rectGrid->GetDimensions( rectDims );
+  numCells = rectGrid->GetNumberOfCells();
+
+  vtkTableBasedClipperVolumeFromVolumePieces visItVFV(
+      this->OutputPointsPrecision, rectGrid->GetNumberOfPoints(), numCells,
+      vtkTableBasedClipperVolumeFromVolumePieces::GetNumberOfPieces
+                            ( rectGrid, numCells, this->NumberOfPieces ) );
+
+  vtkTableBasedClipperStructuredCells cells( rectDims, clipAray, isoValue );
+  visItVFV.Clip( this, cells, this->InsideOut );
+
+
+  int            toDelete    = 0;
+  double       * theCords[3] = { nullptr, nullptr, nullptr };
+  vtkDataArray * theArays[3] = { nullptr, nullptr, nullptr };
+
+  if ( rectGrid->GetXCoordinates()->GetDataType() == VTK_DOUBLE &&
+       rectGrid->GetYCoordinates()->GetDataType() == VTK_DOUBLE &&
+       rectGrid->GetZCoordinates()->GetDataType() == VTK_DOUBLE
+     )
+  {
+    theCords[0] = static_cast < double * >
+                  (  rectGrid->GetXCoordinates()->GetVoidPointer( 0 )  );
+    theCords[1] = static_cast < double * >
+                  (  rectGrid->GetYCoordinates()->GetVoidPointer( 0 )  );
+    theCords[2] = static_cast < double * >
+                  (  rectGrid->GetZCoordinates()->GetVoidPointer( 0 )  );
+  }
+  else
+  {
+    toDelete    = 1;
+    theArays[0] = rectGrid->GetXCoordinates();
+    theArays[1] = rectGrid->GetYCoordinates();
+    theArays[2] = rectGrid->GetZCoordinates();
+    for ( j = 0; j < 3; j ++ )
+    {
+      theCords[j] = new double [ rectDims[j] ];
+      for ( i = 0; i < rectDims[j]; i ++ )
+      {
+        theCords[j][i] = theArays[j]->GetComponent( i, 0 );
+      }
+      theArays[j] = nullptr;
+    }
+  }
+
+  visItVFV.ConstructDataSet
+            ( rectGrid,
+              outputUG, rectDims, theCords[0], theCords[1], theCords[2] );
+
+  rectGrid = nullptr;
+
+  for ( i = 0; i < 3; i ++ )
+  {
+    if ( toDelete )
+    {
+      delete [] theCords[i];
+    }
+    theCords[i] = nullptr;
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkStructuredGrid * strcGrid = vtkStructuredGrid::SafeDownCast( inputGrd );
+
+  int   i;
+  int   numCells    = 0;
+  int   numbPnts    = 0;
+  int   gridDims[3] = { 0, 0, 0 };
+  strcGrid->GetDimensions( gridDims );
+  numCells = strcGrid->GetNumberOfCells();
+
+  vtkTableBasedClipperVolumeFromVolumePieces visItVFV(
+      this->OutputPointsPrecision, strcGrid->GetNumberOfPoints(), numCells,
+      vtkTableBasedClipperVolumeFromVolumePieces::GetNumberOfPieces
+                            ( strcGrid, numCells, this->NumberOfPieces ) );
+
+  vtkTableBasedClipperStructuredCells cells( gridDims, clipAray, isoValue );
+  visItVFV.Clip( this, cells, this->InsideOut );
+
+  int         toDelete = 0;
+  double    * theCords = nullptr;
+  vtkPoints * inputPts = strcGrid->GetPoints();
+  if ( inputPts->GetDataType() == VTK_DOUBLE )
+  {
+    theCords = static_cast < double * > (  inputPts->GetVoidPointer( 0 )  );
+  }
+  else
+  {
+    toDelete = 1;
+    numbPnts = inputPts->GetNumberOfPoints();
+    theCords = new double [ numbPnts * 3 ];
+    for ( i = 0; i < numbPnts; i ++ )
+    {
+      inputPts->GetPoint( i, theCords + ( i << 1 ) + i );
+    }
+  }
+  inputPts = nullptr;
+
+  visItVFV.ConstructDataSet( strcGrid, outputUG, theCords );
+
+  if ( toDelete )
+  {
+    delete [] theCords;
+  }
+  theCords = nullptr;
+  strcGrid = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
+     vtkDataArray * clipAray, double isoValue, vtkUnstructuredGrid * outputUG )
+{
+  vtkUnstructuredGrid * unstruct = vtkUnstructuredGrid::SafeDownCast( inputGrd );
+
+  vtkIdType   i;
+  vtkIdType   numbPnts = 0;
+  int         numCants = 0; // number of cells not clipped by this filter
+  int         numCells = unstruct->GetNumberOfCells();
+
+  // The cells that can not be clipped by this filter are handed over, in
+  // order, to vtkClipDataSet, hence a single piece in that case.
+  vtkTableBasedClipperUnstructuredCells cells( unstruct, clipAray, isoValue );
+  int numPieces = 1;
+  if ( cells.CanClipAllCells() )
+  {
+    numPieces = vtkTableBasedClipperVolumeFromVolumePieces::GetNumberOfPieces
+                            ( unstruct, numCells, this->NumberOfPieces );
+  }
+
+  // volume from volume
+  vtkTableBasedClipperVolumeFromVolumePieces visItVFV(
+      this->OutputPointsPrecision, unstruct->GetNumberOfPoints(), numCells,
+      numPieces );
+
+  // the stuffs that can not be clipped by this filter
+  vtkUnstructuredGrid * specials = vtkUnstructuredGrid::New();
+  specials->SetPoints( unstruct->GetPoints() );
+  specials->GetPointData()->ShallowCopy( unstruct->GetPointData() );
+  specials->Allocate( numCells );
+
+  if ( numPieces > 1 )
+  {
+    visItVFV.Clip( this, cells, this->InsideOut );
+  }
+  else
+  {
+    for ( i = 0; i < numCells; i ++ )
     {
+      if ( cells.ClipCell( this, visItVFV.GetPiece( 0 ), this->InsideOut, i ) )
+      {
+        continue;
+      }
+
+      int  cellType = unstruct->GetCellType( i );
       if ( numCants == 0 )
       {
           specials->GetCellData()
                   ->CopyAllocate( unstruct->GetCellData(), numCells );
       }
-      specials->InsertNextCell( cellType, numbPnts, pntIndxs );
+      if ( cellType == VTK_POLYHEDRON )
+      {
+        vtkIdType nfaces, *facePtIds;
+        unstruct->GetFaceStream(i, nfaces, facePtIds);
+        specials->InsertNextCell(cellType, nfaces, facePtIds);
+      }
+      else
+      {
+        vtkIdType * pntIndxs = nullptr;
+        unstruct->GetCellPoints( i, numbPnts, pntIndxs );
+        specials->InsertNextCell( cellType, numbPnts, pntIndxs );
+      }
       specials->GetCellData()
               ->CopyData( unstruct->GetCellData(), i, numCants );
       numCants ++;
     }
-
-    pntIndxs = nullptr;
   }
 
   int         toDelete = 0;
@@ -3374,7 +3899,7 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
     this->ClipDataSet( specials, clipAray, vtkUGrid );
 
     vtkUnstructuredGrid * visItGrd = vtkUnstructuredGrid::New();
-    visItVFV->ConstructDataSet( unstruct, visItGrd, theCords );
+    visItVFV.ConstructDataSet( unstruct, visItGrd, theCords );
 
     vtkAppendFilter * appender = vtkAppendFilter::New();
     appender->AddInputData( vtkUGrid );
@@ -3392,17 +3917,15 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   }
   else
   {
-    visItVFV->ConstructDataSet( unstruct, outputUG, theCords );
+    visItVFV.ConstructDataSet( unstruct, outputUG, theCords );
   }
 
   specials->Delete();
-  delete visItVFV;
   if ( toDelete )
   {
     delete [] theCords;
   }
   specials = nullptr;
-  visItVFV = nullptr;
   theCords = nullptr;
   unstruct = nullptr;
 }
@@ -3443,4 +3966,6 @@ void vtkTableBasedClipDataSet::PrintSelf( ostream & os, vtkIndent indent )
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Number Of Pieces: " << this->NumberOfPieces << "\n";
 }
@@ -228,6 +228,19 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get the number of pieces that the cells of unstructured, structured
+   * and image inputs are clipped in concurrently before the pieces are
+   * merged. The default, 0, selects a number from the number of cells and of
+   * threads, and clips in a single piece with one thread. Inputs with bit or
+   * string attributes are always clipped in a single piece. The output does
+   * not depend on this setting.
+   */
+  vtkSetClampMacro(NumberOfPieces, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPieces, int);
+  //@}
+
 protected:
   vtkTableBasedClipDataSet( vtkImplicitFunction * cf = nullptr );
   ~vtkTableBasedClipDataSet() override;
@@ -311,6 +324,7 @@ protected:
   vtkIncrementalPointLocator * Locator;
 
   int OutputPointsPrecision;
+  int NumberOfPieces;
 
 private:
   vtkTableBasedClipDataSet( const vtkTableBasedClipDataSet &) = delete;
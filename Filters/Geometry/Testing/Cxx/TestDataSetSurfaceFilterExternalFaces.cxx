@@ -0,0 +1,231 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSetSurfaceFilterExternalFaces.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extract the surface of unstructured grids large enough for their external
+// faces to be found with vtkSMPTools, check the faces and the original cell
+// and point ids, and compare them with the serial quad hash.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataSetSurfaceFilter.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+// Subclasses of vtkDataSetSurfaceFilter keep the serial quad hash.
+class vtkSerialSurfaceFilter : public vtkDataSetSurfaceFilter
+{
+public:
+  static vtkSerialSurfaceFilter *New();
+  vtkTypeMacro(vtkSerialSurfaceFilter, vtkDataSetSurfaceFilter);
+};
+vtkStandardNewMacro(vtkSerialSurfaceFilter);
+
+namespace
+{
+
+const int Dim = 21;
+
+// A block of (Dim - 1)^3 cubes, each one being a hexahedron or two wedges.
+void MakeGrid(vtkUnstructuredGrid *ugrid, bool wedges)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(Dim, Dim, Dim);
+
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    points->SetPoint(i, image->GetPoint(i));
+  }
+  ugrid->SetPoints(points);
+
+  ugrid->Allocate(2 * image->GetNumberOfCells());
+  vtkNew<vtkIdList> voxel;
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    image->GetCellPoints(i, voxel);
+    vtkIdType *v = voxel->GetPointer(0);
+    if (wedges)
+    {
+      vtkIdType wedge0[6] = { v[0], v[1], v[2], v[4], v[5], v[6] };
+      vtkIdType wedge1[6] = { v[1], v[3], v[2], v[5], v[7], v[6] };
+      ugrid->InsertNextCell(VTK_WEDGE, 6, wedge0);
+      ugrid->InsertNextCell(VTK_WEDGE, 6, wedge1);
+    }
+    else
+    {
+      vtkIdType hex[8] = { v[0], v[1], v[3], v[2], v[4], v[5], v[7], v[6] };
+      ugrid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+    }
+  }
+}
+
+bool OnBoundary(const double x[3])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    if (x[i] == 0.0 || x[i] == Dim - 1)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+int CheckSurface(vtkUnstructuredGrid *ugrid, vtkIdType expectedPolys,
+                 const char *label)
+{
+  vtkNew<vtkDataSetSurfaceFilter> surface;
+  surface->SetInputData(ugrid);
+  surface->PassThroughCellIdsOn();
+  surface->PassThroughPointIdsOn();
+  surface->Update();
+  vtkPolyData *output = surface->GetOutput();
+
+  if (output->GetNumberOfPolys() != expectedPolys)
+  {
+    cerr << label << ": expected " << expectedPolys << " faces, got "
+         << output->GetNumberOfPolys() << endl;
+    return 1;
+  }
+
+  vtkIdTypeArray *cellIds = vtkIdTypeArray::SafeDownCast(
+    output->GetCellData()->GetArray(surface->GetOriginalCellIdsName()));
+  vtkIdTypeArray *pointIds = vtkIdTypeArray::SafeDownCast(
+    output->GetPointData()->GetArray(surface->GetOriginalPointIdsName()));
+  if (!cellIds || !pointIds)
+  {
+    cerr << label << ": missing original ids" << endl;
+    return 1;
+  }
+
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    output->GetPoint(i, x);
+    ugrid->GetPoint(pointIds->GetValue(i), y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2] || !OnBoundary(x))
+    {
+      cerr << label << ": wrong point " << i << endl;
+      return 1;
+    }
+  }
+
+  // Each face must be on the boundary and made of points of its cell.
+  vtkNew<vtkIdList> facePts;
+  vtkNew<vtkIdList> cellPts;
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+  {
+    output->GetCellPoints(i, facePts);
+    ugrid->GetCellPoints(cellIds->GetValue(i), cellPts);
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType j = 0; j < facePts->GetNumberOfIds(); ++j)
+    {
+      vtkIdType ptId = pointIds->GetValue(facePts->GetId(j));
+      if (cellPts->IsId(ptId) < 0)
+      {
+        cerr << label << ": face " << i << " is not a face of cell "
+             << cellIds->GetValue(i) << endl;
+        return 1;
+      }
+      double x[3];
+      ugrid->GetPoint(ptId, x);
+      for (int k = 0; k < 3; ++k)
+      {
+        center[k] += x[k] / facePts->GetNumberOfIds();
+      }
+    }
+    if (!OnBoundary(center))
+    {
+      cerr << label << ": face " << i << " is not external" << endl;
+      return 1;
+    }
+  }
+
+  // The faces, their points and their numbering must match the serial hash.
+  vtkNew<vtkSerialSurfaceFilter> serial;
+  serial->SetInputData(ugrid);
+  serial->PassThroughCellIdsOn();
+  serial->PassThroughPointIdsOn();
+  serial->Update();
+  vtkPolyData *serialOutput = serial->GetOutput();
+  vtkIdTypeArray *serialCellIds = vtkIdTypeArray::SafeDownCast(
+    serialOutput->GetCellData()->GetArray(serial->GetOriginalCellIdsName()));
+  vtkIdTypeArray *serialPointIds = vtkIdTypeArray::SafeDownCast(
+    serialOutput->GetPointData()->GetArray(serial->GetOriginalPointIdsName()));
+  if (serialOutput->GetNumberOfCells() != output->GetNumberOfCells() ||
+      serialOutput->GetNumberOfPoints() != output->GetNumberOfPoints())
+  {
+    cerr << label << ": " << output->GetNumberOfCells() << " faces and "
+         << output->GetNumberOfPoints() << " points, the serial hash gives "
+         << serialOutput->GetNumberOfCells() << " and "
+         << serialOutput->GetNumberOfPoints() << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    if (pointIds->GetValue(i) != serialPointIds->GetValue(i))
+    {
+      cerr << label << ": point " << i << " differs from the serial hash"
+           << endl;
+      return 1;
+    }
+  }
+  vtkNew<vtkIdList> serialPts;
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+  {
+    output->GetCellPoints(i, facePts);
+    serialOutput->GetCellPoints(i, serialPts);
+    bool same = cellIds->GetValue(i) == serialCellIds->GetValue(i) &&
+      facePts->GetNumberOfIds() == serialPts->GetNumberOfIds();
+    for (vtkIdType j = 0; same && j < facePts->GetNumberOfIds(); ++j)
+    {
+      same = facePts->GetId(j) == serialPts->GetId(j);
+    }
+    if (!same)
+    {
+      cerr << label << ": face " << i << " differs from the serial hash"
+           << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+}
+
+int TestDataSetSurfaceFilterExternalFaces(int, char *[])
+{
+  const vtkIdType n = Dim - 1;
+  int rval = 0;
+
+  vtkNew<vtkUnstructuredGrid> hexahedra;
+  MakeGrid(hexahedra, false);
+  rval |= CheckSurface(hexahedra, 6 * n * n, "hexahedra");
+
+  // Quads on the sides, two triangles per cube on the top and bottom.
+  vtkNew<vtkUnstructuredGrid> wedges;
+  MakeGrid(wedges, true);
+  rval |= CheckSurface(wedges, 8 * n * n, "wedges");
+
+  return rval;
+}
@@ -32,6 +32,8 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -49,8 +51,12 @@
 #include "vtkStructuredData.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 static inline int sizeofFastQuad(int numPts)
 {
@@ -101,6 +107,466 @@ protected:
   MapType Map;
 };
 
+namespace
+{
+
+// Faces of the 3D cell types handled by vtkExternalFaceExtractor, listed
+// in the order, and with the point order, UnstructuredGridExecute inserts
+// them in the quad hash. Wedges and pyramids use the faces of vtkWedge and
+// vtkPyramid, as the generic cell path does.
+const int HexahedronFaces[6][4] = { {0, 1, 5, 4}, {0, 3, 2, 1}, {0, 4, 7, 3},
+                                    {1, 2, 6, 5}, {2, 3, 7, 6}, {4, 5, 6, 7} };
+const int VoxelFaces[6][4] = { {0, 1, 5, 4}, {0, 2, 3, 1}, {0, 4, 6, 2},
+                               {1, 3, 7, 5}, {2, 6, 7, 3}, {4, 5, 7, 6} };
+const int TetraFaces[4][3] = { {0, 1, 3}, {0, 2, 1}, {0, 3, 2}, {1, 2, 3} };
+
+//----------------------------------------------------------------------------
+// Threaded equivalent of the quad hash for the external faces of the 3D
+// cells of an unstructured grid. The faces are bucketed by their first point
+// once reordered as the hash reorders them (the smallest id first), the
+// buckets are then sorted by cell and face and resolved independently, which
+// visits the faces in the same order as the serial hash traversal.
+class vtkExternalFaceExtractor
+{
+public:
+  // Whether the faces of cells of this type are extracted here.
+  static bool HandlesCellType(int cellType)
+  {
+    return GetNumberOfFaces(cellType) > 0;
+  }
+
+  // Whether all the cells of the grid are either handled here or by the
+  // serial passes that do not go through the generic cell API.
+  static bool CanExtract(vtkUnstructuredGrid *input)
+  {
+    vtkUnsignedCharArray *types = input->GetCellTypesArray();
+    vtkIdType numCells = input->GetNumberOfCells();
+    if (!types || input->GetFaces())
+    {
+      return false;
+    }
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      switch (types->GetValue(cellId))
+      {
+        case VTK_EMPTY_CELL:
+        case VTK_VERTEX:
+        case VTK_POLY_VERTEX:
+        case VTK_LINE:
+        case VTK_POLY_LINE:
+        case VTK_PIXEL:
+        case VTK_QUAD:
+        case VTK_TRIANGLE:
+        case VTK_POLYGON:
+        case VTK_TRIANGLE_STRIP:
+        case VTK_HEXAHEDRON:
+        case VTK_VOXEL:
+        case VTK_TETRA:
+        case VTK_WEDGE:
+        case VTK_PYRAMID:
+        case VTK_PENTAGONAL_PRISM:
+        case VTK_HEXAGONAL_PRISM:
+          break;
+        default:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  vtkExternalFaceExtractor(vtkUnstructuredGrid *input)
+    : Input(input), Traversal(0)
+  {
+    this->Quad.Next = nullptr;
+    this->Quad.ptArray = this->QuadPoints;
+  }
+
+  void Extract();
+
+  // Same as vtkDataSetSurfaceFilter::GetNextVisibleQuadFromHash(). The
+  // returned face is only valid until the next call.
+  vtkFastGeomQuad *GetNextVisibleFace()
+  {
+    vtkIdType numFaces = static_cast<vtkIdType>(this->Faces.size());
+    for (; this->Traversal < numFaces; ++this->Traversal)
+    {
+      const FaceEntry &entry = this->Faces[this->Traversal];
+      if (entry.Face >= 0)
+      {
+        this->Quad.SourceId = entry.CellId;
+        this->Quad.numPts = this->GetFace(entry, this->QuadPoints);
+        ++this->Traversal;
+        return &this->Quad;
+      }
+    }
+    return nullptr;
+  }
+
+protected:
+  // A face of a cell; a negative face index marks a face shared by several
+  // cells, or a duplicate.
+  struct FaceEntry
+  {
+    vtkIdType CellId;
+    int Face;
+
+    bool operator<(const FaceEntry &other) const
+    {
+      return this->CellId < other.CellId ||
+        (this->CellId == other.CellId && this->Face < other.Face);
+    }
+  };
+
+  static int GetNumberOfFaces(int cellType)
+  {
+    switch (cellType)
+    {
+      case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
+        return 6;
+      case VTK_TETRA:
+        return 4;
+      case VTK_WEDGE:
+      case VTK_PYRAMID:
+        return 5;
+      case VTK_PENTAGONAL_PRISM:
+        return 7;
+      case VTK_HEXAGONAL_PRISM:
+        return 8;
+      default:
+        return 0;
+    }
+  }
+
+  // Point ids of a face, reordered as the Insert*InHash methods reorder them.
+  int GetFace(vtkIdType cellId, int face, vtkIdType facePts[6]) const;
+  int GetFace(const FaceEntry &entry, vtkIdType facePts[6]) const
+  {
+    return this->GetFace(entry.CellId, entry.Face, facePts);
+  }
+
+  // Whether a face matches an already hashed one, as in the Insert*InHash
+  // methods.
+  static bool SameFace(int numPts, const vtkIdType *pts,
+                       int hashedNumPts, const vtkIdType *hashed);
+
+  struct CountFaces;
+  struct FillFaces;
+  struct ResolveBuckets;
+
+  vtkUnstructuredGrid *Input;
+  std::unique_ptr<std::atomic<vtkIdType>[]> BucketSizes;
+  std::vector<vtkIdType> BucketOffsets;
+  std::vector<FaceEntry> Faces;
+  vtkIdType Traversal;
+  vtkFastGeomQuad Quad;
+  vtkIdType QuadPoints[6];
+};
+
+//----------------------------------------------------------------------------
+int vtkExternalFaceExtractor::GetFace(vtkIdType cellId, int face,
+                                      vtkIdType facePts[6]) const
+{
+  vtkIdType npts;
+  vtkIdType *ids;
+  this->Input->GetCellPoints(cellId, npts, ids);
+
+  int numPts = 0;
+  switch (this->Input->GetCellType(cellId))
+  {
+    case VTK_HEXAHEDRON:
+      for (; numPts < 4; ++numPts)
+      {
+        facePts[numPts] = ids[HexahedronFaces[face][numPts]];
+      }
+      break;
+    case VTK_VOXEL:
+      for (; numPts < 4; ++numPts)
+      {
+        facePts[numPts] = ids[VoxelFaces[face][numPts]];
+      }
+      break;
+    case VTK_TETRA:
+      for (; numPts < 3; ++numPts)
+      {
+        facePts[numPts] = ids[TetraFaces[face][numPts]];
+      }
+      break;
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    {
+      const int *verts = this->Input->GetCellType(cellId) == VTK_WEDGE ?
+        vtkWedge::GetFaceArray(face) : vtkPyramid::GetFaceArray(face);
+      for (; numPts < 4 && verts[numPts] >= 0; ++numPts)
+      {
+        facePts[numPts] = ids[verts[numPts]];
+      }
+      break;
+    }
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+    {
+      // Side quads first, then the two polygons.
+      int n = static_cast<int>(npts / 2);
+      if (face < n)
+      {
+        int next = (face + 1) % n;
+        facePts[0] = ids[face];
+        facePts[1] = ids[next];
+        facePts[2] = ids[next + n];
+        facePts[3] = ids[face + n];
+        numPts = 4;
+      }
+      else
+      {
+        const vtkIdType *polygon = face == n ? ids : ids + n;
+        for (; numPts < n; ++numPts)
+        {
+          facePts[numPts] = polygon[numPts];
+        }
+      }
+      break;
+    }
+  }
+
+  vtkIdType tmp[6];
+  std::copy(facePts, facePts + numPts, tmp);
+  if (numPts == 4)
+  {
+    vtkIdType a = tmp[0], b = tmp[1], c = tmp[2], d = tmp[3];
+    int offset = 0;
+    if (b < a && b < c && b < d)
+    {
+      offset = 1;
+    }
+    else if (c < a && c < b && c < d)
+    {
+      offset = 2;
+    }
+    else if (d < a && d < b && d < c)
+    {
+      offset = 3;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+      facePts[i] = tmp[(offset + i) % 4];
+    }
+  }
+  else if (numPts == 3)
+  {
+    vtkIdType a = tmp[0], b = tmp[1], c = tmp[2];
+    int offset = 0;
+    if (b < a && b < c)
+    {
+      offset = 1;
+    }
+    else if (c < a && c < b)
+    {
+      offset = 2;
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      facePts[i] = tmp[(offset + i) % 3];
+    }
+  }
+  else
+  {
+    int offset = 0;
+    for (int i = 0; i < numPts; ++i)
+    {
+      if (tmp[i] < tmp[offset])
+      {
+        offset = i;
+      }
+    }
+    for (int i = 0; i < numPts; ++i)
+    {
+      facePts[i] = tmp[(offset + i) % numPts];
+    }
+  }
+  return numPts;
+}
+
+//----------------------------------------------------------------------------
+bool vtkExternalFaceExtractor::SameFace(int numPts, const vtkIdType *pts,
+                                        int hashedNumPts,
+                                        const vtkIdType *hashed)
+{
+  if (numPts != hashedNumPts || pts[0] != hashed[0])
+  {
+    return false;
+  }
+  if (numPts == 4)
+  {
+    return pts[2] == hashed[2] &&
+      ((pts[1] == hashed[1] && pts[3] == hashed[3]) ||
+       (pts[1] == hashed[3] && pts[3] == hashed[1]));
+  }
+  if (numPts == 3)
+  {
+    return (pts[1] == hashed[1] && pts[2] == hashed[2]) ||
+      (pts[1] == hashed[2] && pts[2] == hashed[1]);
+  }
+  if (pts[1] == hashed[1])
+  {
+    for (int i = 2; i < numPts; ++i)
+    {
+      if (pts[i] != hashed[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (int i = 1; i < numPts; ++i)
+  {
+    if (pts[numPts - i] != hashed[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Count the faces of each bucket.
+struct vtkExternalFaceExtractor::CountFaces
+{
+  vtkExternalFaceExtractor *Self;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType facePts[6];
+    for (; cellId < endCellId; ++cellId)
+    {
+      int numFaces = GetNumberOfFaces(this->Self->Input->GetCellType(cellId));
+      for (int face = 0; face < numFaces; ++face)
+      {
+        this->Self->GetFace(cellId, face, facePts);
+        this->Self->BucketSizes[facePts[0]].fetch_add(
+          1, std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Put the faces in their bucket, in any order.
+struct vtkExternalFaceExtractor::FillFaces
+{
+  vtkExternalFaceExtractor *Self;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdType facePts[6];
+    for (; cellId < endCellId; ++cellId)
+    {
+      int numFaces = GetNumberOfFaces(this->Self->Input->GetCellType(cellId));
+      for (int face = 0; face < numFaces; ++face)
+      {
+        this->Self->GetFace(cellId, face, facePts);
+        vtkIdType slot = this->Self->BucketOffsets[facePts[0]] +
+          this->Self->BucketSizes[facePts[0]].fetch_add(
+            1, std::memory_order_relaxed);
+        this->Self->Faces[slot].CellId = cellId;
+        this->Self->Faces[slot].Face = face;
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Sort each bucket in insertion order and replay the hash insertions: a face
+// matching a hashed face hides it and is dropped, any other face is hashed.
+struct vtkExternalFaceExtractor::ResolveBuckets
+{
+  vtkExternalFaceExtractor *Self;
+
+  struct HashedFace
+  {
+    FaceEntry *Entry;
+    int NumPts;
+    vtkIdType Pts[6];
+  };
+  vtkSMPThreadLocal<std::vector<HashedFace> > Hashed;
+
+  void operator()(vtkIdType bucket, vtkIdType endBucket)
+  {
+    std::vector<HashedFace> &hashed = this->Hashed.Local();
+    for (; bucket < endBucket; ++bucket)
+    {
+      FaceEntry *begin = this->Self->Faces.data() +
+        this->Self->BucketOffsets[bucket];
+      FaceEntry *end = this->Self->Faces.data() +
+        this->Self->BucketOffsets[bucket + 1];
+      std::sort(begin, end);
+
+      hashed.clear();
+      for (FaceEntry *entry = begin; entry != end; ++entry)
+      {
+        HashedFace face;
+        face.Entry = entry;
+        face.NumPts = this->Self->GetFace(*entry, face.Pts);
+
+        std::vector<HashedFace>::iterator match = hashed.begin();
+        for (; match != hashed.end(); ++match)
+        {
+          if (SameFace(face.NumPts, face.Pts, match->NumPts, match->Pts))
+          {
+            break;
+          }
+        }
+        if (match != hashed.end())
+        {
+          match->Entry->Face = -1;
+          entry->Face = -1;
+        }
+        else
+        {
+          hashed.push_back(face);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+void vtkExternalFaceExtractor::Extract()
+{
+  vtkIdType numPts = this->Input->GetNumberOfPoints();
+  vtkIdType numCells = this->Input->GetNumberOfCells();
+
+  this->BucketSizes.reset(new std::atomic<vtkIdType>[numPts]);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    this->BucketSizes[i].store(0, std::memory_order_relaxed);
+  }
+  CountFaces countFaces = { this };
+  vtkSMPTools::For(0, numCells, countFaces);
+
+  this->BucketOffsets.resize(numPts + 1);
+  vtkIdType numFaces = 0;
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    this->BucketOffsets[i] = numFaces;
+    numFaces += this->BucketSizes[i].load(std::memory_order_relaxed);
+    this->BucketSizes[i].store(0, std::memory_order_relaxed);
+  }
+  this->BucketOffsets[numPts] = numFaces;
+
+  this->Faces.resize(numFaces);
+  FillFaces fillFaces = { this };
+  vtkSMPTools::For(0, numCells, fillFaces);
+  this->BucketSizes.reset();
+
+  ResolveBuckets resolveBuckets;
+  resolveBuckets.Self = this;
+  vtkSMPTools::For(0, numPts, resolveBuckets);
+  this->Traversal = 0;
+}
+
+}
+
 vtkObjectFactoryNewMacro(vtkDataSetSurfaceFilter);
 
 //----------------------------------------------------------------------------
@@ -1593,6 +2059,19 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   this->NumberOfNewCells = 0;
   this->InitializeQuadHash(numPts);
 
+  // The external faces of the linear 3D cells of large unstructured grids
+  // are found with vtkSMPTools. Subclasses may override the quad hash, so
+  // they keep the serial path.
+  std::unique_ptr<vtkExternalFaceExtractor> externalFaces;
+  vtkUnstructuredGrid *ugrid = vtkUnstructuredGrid::SafeDownCast(input);
+  if (ugrid && numCells >= 1000 &&
+      strcmp(this->GetClassName(), "vtkDataSetSurfaceFilter") == 0 &&
+      vtkExternalFaceExtractor::CanExtract(ugrid))
+  {
+    externalFaces.reset(new vtkExternalFaceExtractor(ugrid));
+    externalFaces->Extract();
+  }
+
   // Allocate
   //
   newPts = vtkPoints::New();
@@ -1677,6 +2156,12 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
     progressCount++;
 
     cellType = cellIter->GetCellType();
+    if (externalFaces &&
+        vtkExternalFaceExtractor::HandlesCellType(cellType))
+    {
+      // The faces of this cell have already been extracted.
+      continue;
+    }
     switch (cellType)
     {
       case VTK_VERTEX:
@@ -2126,7 +2611,8 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
 
   // Now transfer geometry from hash to output (only triangles and quads).
   this->InitQuadHashTraversal();
-  while ( (q = this->GetNextVisibleQuadFromHash()) )
+  while ( (q = externalFaces ? externalFaces->GetNextVisibleFace() :
+           this->GetNextVisibleQuadFromHash()) )
   {
     // If all of the cell points are duplicate (boundary), do not
     // extract as a surface cell.
@@ -9,7 +9,6 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtkStructuredGrid.h"
 #include "vtkPolyData.h"
-#include "vtkCellLinks.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkCompositeDataSet.h"
@@ -146,16 +145,6 @@ int vtkCellDistanceSelector::RequestData( vtkInformation* vtkNotUsed( request ),
         vtkStructuredGrid* sg_input = vtkStructuredGrid::SafeDownCast( input );
         vtkPolyData* pd_input = vtkPolyData::SafeDownCast( input);
 
-        vtkCellLinks * links = nullptr;
-        if ( ug_input )
-        {
-          if ( ! ug_input->GetCellLinks() )
-          {
-            ug_input->BuildLinks();
-          }
-          links = ug_input->GetCellLinks();
-        }
-
         std::vector<int> flags( numCells, 0 );
 
         vtkSmartPointer<vtkIdTypeArray> outIndices = vtkSmartPointer<vtkIdTypeArray>::New();
@@ -198,9 +187,10 @@ int vtkCellDistanceSelector::RequestData( vtkInformation* vtkNotUsed( request ),
               for ( int k = 0; k < n; ++ k )
               {
                 vtkIdType pid = points[k];
-                int np = links->GetNcells( pid );
-                vtkIdType* cells = links->GetCells( pid );
-                for ( int j = 0; j < np; ++ j )
+                vtkIdType np;
+                vtkIdType* cells;
+                ug_input->GetPointCells( pid, np, cells );
+                for ( vtkIdType j = 0; j < np; ++ j )
                 {
                   vtkIdType cid = cells[j];
                   if( cid >= 0 && cid < numCells )
@@ -7340,12 +7340,6 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
   // do a tedious task
   vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(mesh);
   vtkPolyData *pd = vtkPolyData::SafeDownCast(mesh);
-  vtkCellLinks *cl = nullptr;
-  if (ug)
-  {
-    cl = ug->GetCellLinks();
-  }
-
   const int nComponents = iData->GetNumberOfComponents();
 
   if (nComponents == 1)
@@ -7358,11 +7352,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
       unsigned short nCells;
       vtkIdType *cells;
-      if (cl)
+      if (ug)
       {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
+        vtkIdType nUgCells;
+        ug->GetPointCells(pI, nUgCells, cells);
+        nCells = static_cast<unsigned short>(nUgCells);
       }
       else
       {
@@ -7389,11 +7383,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
       unsigned short nCells;
       vtkIdType *cells;
-      if (cl)
+      if (ug)
       {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
+        vtkIdType nUgCells;
+        ug->GetPointCells(pI, nUgCells, cells);
+        nCells = static_cast<unsigned short>(nUgCells);
       }
       else
       {
@@ -7427,11 +7421,11 @@ void vtkOpenFOAMReaderPrivate::InterpolateCellToPoint(vtkFloatArray *pData,
           ? GetLabelValue(pointList, pointI, use64BitLabels) : pointI;
       unsigned short nCells;
       vtkIdType *cells;
-      if (cl)
+      if (ug)
       {
-        const vtkCellLinks::Link &l = cl->GetLink(pI);
-        nCells = l.ncells;
-        cells = l.cells;
+        vtkIdType nUgCells;
+        ug->GetPointCells(pI, nUgCells, cells);
+        nCells = static_cast<unsigned short>(nUgCells);
       }
       else
       {